@@ -66,8 +66,8 @@ typedef struct ILimage
 	ILubyte         Bpc;         //!< bytes per channel
 	ILuint          Bps;         //!< bytes per scanline (components for IL)
 	ILubyte*        Data;        //!< the image data
-	ILuint          SizeOfData;  //!< the total size of the data (in bytes)
-	ILuint          SizeOfPlane; //!< SizeOfData in a 2d image, size of each plane slice in a 3d image (in bytes)
+	ILsizei         SizeOfData;  //!< the total size of the data (in bytes)
+	ILsizei         SizeOfPlane; //!< SizeOfData in a 2d image, size of each plane slice in a 3d image (in bytes)
 	ILenum          Format;      //!< image format (in IL enum style)
 	ILenum          Type;        //!< image type (in IL enum style)
 	ILenum          Origin;      //!< origin of the image
@@ -92,10 +92,10 @@ typedef struct ILimage
 
 // Memory functions
 ILAPI void* ILAPIENTRY ialloc(ILcontext* context, const ILsizei Size);
-ILAPI void  ILAPIENTRY ifree(const void *Ptr);
+ILAPI void  ILAPIENTRY ifree(ILcontext* context, const void *Ptr);
 ILAPI void* ILAPIENTRY icalloc(ILcontext* context, const ILsizei Size, const ILsizei Num);
 #ifdef ALTIVEC_GCC
-ILAPI void* ILAPIENTRY ivec_align_buffer(void *buffer, const ILuint size);
+ILAPI void* ILAPIENTRY ivec_align_buffer(ILcontext* context, void *buffer, const ILuint size);
 #endif
 
 // Internal library functions in IL
@@ -115,7 +115,7 @@ ILAPI ILubyte ILAPIENTRY ilGetBppPal(ILenum PalType);
 ILAPI ILenum  ILAPIENTRY ilGetPalBaseType(ILenum PalType);
 ILAPI ILuint  ILAPIENTRY ilNextPower2(ILuint Num);
 ILAPI ILenum  ILAPIENTRY ilTypeFromExt(ILcontext* context, ILconst_string FileName);
-ILAPI void    ILAPIENTRY ilReplaceCurImage(ILimage *Image);
+ILAPI void    ILAPIENTRY ilReplaceCurImage(ILcontext* context, ILimage *Image);
 ILAPI void    ILAPIENTRY iMemSwap(ILcontext* context, ILubyte *, ILubyte *, const ILuint);
 
 //
@@ -123,8 +123,8 @@ ILAPI void    ILAPIENTRY iMemSwap(ILcontext* context, ILubyte *, ILubyte *, cons
 //
 ILAPI void	    ILAPIENTRY iBindImageTemp	(ILcontext* context);
 ILAPI ILboolean ILAPIENTRY ilClearImage_   	(ILcontext* context, ILimage *Image);
-ILAPI void      ILAPIENTRY ilCloseImage    	(ILimage *Image);
-ILAPI void      ILAPIENTRY ilClosePal      	(ILpal *Palette);
+ILAPI void      ILAPIENTRY ilCloseImage    	(ILcontext* context, ILimage *Image);
+ILAPI void      ILAPIENTRY ilClosePal      	(ILcontext* context, ILpal *Palette);
 ILAPI ILpal*    ILAPIENTRY iCopyPal        	(void);
 ILAPI ILboolean ILAPIENTRY ilCopyImageAttr 	(ILcontext* context, ILimage *Dest, ILimage *Src);
 ILAPI ILimage*  ILAPIENTRY ilCopyImage_    	(ILcontext* context, ILimage *Src);
@@ -138,7 +138,7 @@ ILAPI ILboolean ILAPIENTRY ilResizeImage   	(ILcontext* context, ILimage *Image,
 ILAPI ILboolean ILAPIENTRY ilTexImage_     	(ILcontext* context, ILimage *Image, ILuint Width, ILuint Height, ILuint Depth, ILubyte Bpp, ILenum Format, ILenum Type, void *Data);
 ILAPI ILboolean ILAPIENTRY ilTexImageSurface_(ILcontext* context, ILimage *Image, ILuint Width, ILuint Height, ILuint Depth, ILubyte Bpp, ILenum Format, ILenum Type, void *Data);
 ILAPI ILboolean ILAPIENTRY ilTexSubImage_  	(ILcontext* context, ILimage *Image, void *Data);
-ILAPI void*     ILAPIENTRY ilConvertBuffer 	(ILcontext* context, ILuint SizeOfData, ILenum SrcFormat, ILenum DestFormat, ILenum SrcType, ILenum DestType, ILpal *SrcPal, void *Buffer);
+ILAPI void*     ILAPIENTRY ilConvertBuffer 	(ILcontext* context, ILsizei SizeOfData, ILenum SrcFormat, ILenum DestFormat, ILenum SrcType, ILenum DestType, ILpal *SrcPal, void *Buffer);
 ILAPI ILimage*  ILAPIENTRY iConvertImage   	(ILcontext* context, ILimage *Image, ILenum DestFormat, ILenum DestType);
 ILAPI ILpal*    ILAPIENTRY iConvertPal     	(ILcontext* context, ILpal *Pal, ILenum DestFormat);
 ILAPI ILubyte*  ILAPIENTRY iGetFlipped     	(ILcontext* context, ILimage *Image);
@@ -299,6 +299,7 @@ typedef long long unsigned int ILuint64;
 // File definitions
 #define IL_FILE_OVERWRITE	0x0620
 #define IL_FILE_MODE		0x0621
+#define IL_FILE_MAPPING		0x0622
 
 
 // Palette definitions
@@ -381,6 +382,23 @@ typedef long long unsigned int ILuint64;
 #define IL_PNG_ALPHA_INDEX 0x0724 // currently has no effect!
 #define IL_JPG_PROGRESSIVE         0x0725
 #define IL_VTF_COMP                0x0726
+#define IL_JPG_DECODE_SCALE        0x0734  // Loads JPEGs at 1/1 (the default), 1/2, 1/4 or 1/8 of their size.
+#define IL_JPG_DECODE_SIZE         0x0735  // If not 0, JPEGs load at the smallest of those sizes whose longer side is still this long.
+#define IL_PNG_COMPRESSION         0x0736  // zlib level PNGs are saved with, from 0 (stored) to 9 (smallest).  The default is 6.
+#define IL_PNG_FILTER              0x0737  // Filter applied to each row of a saved PNG:
+#define IL_PNG_FILTER_NONE         0x0738  //  none,
+#define IL_PNG_FILTER_SUB          0x0739  //  difference to the pixel on the left,
+#define IL_PNG_FILTER_UP           0x073A  //  difference to the pixel above,
+#define IL_PNG_FILTER_AVG          0x073B  //  difference to the average of those,
+#define IL_PNG_FILTER_PAETH        0x073C  //  Paeth predictor,
+#define IL_PNG_FILTER_ADAPTIVE     0x073D  //  whichever suits each row (the default; none for paletted images).
+#define IL_PNG_STRATEGY            0x073E  // zlib strategy for saved PNGs:
+#define IL_PNG_STRATEGY_DEFAULT    0x073F  //  filtered if rows are filtered, plain otherwise (the default),
+#define IL_PNG_STRATEGY_FILTERED   0x0740  //  Z_FILTERED,
+#define IL_PNG_STRATEGY_HUFFMAN    0x0741  //  Z_HUFFMAN_ONLY,
+#define IL_PNG_STRATEGY_RLE        0x0742  //  Z_RLE.
+#define IL_PNG_FAST                0x0743  // ilEnable to save PNGs at level 1 with the "up" filter, ignoring the three above.
+#define IL_EXR_THREADS             0x0744  // Threads OpenEXR decompresses with: 1 for the calling thread only, 0 (the default) for one per processor.  OpenEXR's thread pool is process-wide and grows to the largest count asked for.
 
 
 // DXTC definitions
@@ -397,6 +415,19 @@ typedef long long unsigned int ILuint64;
 #define IL_RXGB             0x070F
 #define IL_ATI1N            0x0710
 #define IL_DXT1A            0x0711  // Normally the same as IL_DXT1, except for nVidia Texture Tools.
+#define IL_DXTC_QUALITY     0x0727  // How DevIL's own encoder chooses block endpoints:
+#define IL_DXTC_MINMAX      0x0728  //  smallest and largest colour (fastest, the default),
+#define IL_DXTC_RANGE_FIT   0x0729  //  extremes along the principal axis of the block's colours,
+#define IL_DXTC_CLUSTER_FIT 0x072A  //  best split along that axis (slowest, best quality).
+#define IL_BC7              0x072B  // BPTC, for 8-bit RGBA.  Saved as DDS with a DX10 header.
+#define IL_BC6H             0x072C  // BPTC, for unsigned half floats (negative values become 0).
+#define IL_BC6H_SF          0x072D  // BPTC, for signed half floats.
+#define IL_BPTC_EFFORT      0x072E  // Partitions the BC6H/BC7 encoder tries per mode, from 0 (none) to 64.
+#define IL_KTX_COMP         0x072F  // Format the KTX saver compresses to, IL_DXT_NO_COMP (the default) or one of:
+#define IL_ETC1             0x0730  //  ETC1 RGB,
+#define IL_ETC2_RGB         0x0731  //  ETC2 RGB,
+#define IL_ETC2_RGBA        0x0732  //  ETC2 RGB with EAC alpha.
+#define IL_ETC_QUALITY      0x0733  // Effort of the ETC1/ETC2/EAC encoder, from 0 (fastest) to 2 (best).  The default is 1.
 
 // Environment map definitions
 #define IL_CUBEMAP_POSITIVEX 0x00000400
@@ -443,6 +474,10 @@ typedef long long unsigned int ILuint64;
 #define IL_IMAGE_ORIGIN          0x0DFE
 #define IL_IMAGE_CHANNELS        0x0DFF
 
+// Progress of ilPushData
+#define IL_PUSH_PASSES           0x0E01  // Passes finished: 0 or 1, or up to 7 for interlaced images
+#define IL_PUSH_ROWS             0x0E02  // Rows of the image reached in the pass under way
+
 # if defined __GNUC__ && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ > 0))
 // __attribute__((deprecated)) is supported by GCC 3.1 and later.
 #  define DEPRECATED(D) D __attribute__((deprecated))
@@ -510,15 +545,15 @@ typedef ILboolean (ILAPIENTRY *fEofProc)   (ILcontext*, ILHANDLE);
 typedef ILint     (ILAPIENTRY *fGetcProc)  (ILcontext*, ILHANDLE);
 typedef ILHANDLE  (ILAPIENTRY *fOpenRProc) (ILconst_string);
 typedef ILint     (ILAPIENTRY *fReadProc)  (void*, ILuint, ILuint, ILHANDLE);
-typedef ILint     (ILAPIENTRY *fSeekRProc) (ILHANDLE, ILint, ILint);
-typedef ILint     (ILAPIENTRY *fTellRProc) (ILHANDLE);
+typedef ILint     (ILAPIENTRY *fSeekRProc) (ILHANDLE, ILint64, ILint);
+typedef ILint64   (ILAPIENTRY *fTellRProc) (ILHANDLE);
 
 // Callback functions for file writing
 typedef void     (ILAPIENTRY *fCloseWProc)(ILHANDLE);
 typedef ILHANDLE (ILAPIENTRY *fOpenWProc) (ILconst_string);
 typedef ILint    (ILAPIENTRY *fPutcProc)  (ILubyte, ILHANDLE);
-typedef ILint    (ILAPIENTRY *fSeekWProc) (ILHANDLE, ILint, ILint);
-typedef ILint    (ILAPIENTRY *fTellWProc) (ILHANDLE);
+typedef ILint    (ILAPIENTRY *fSeekWProc) (ILHANDLE, ILint64, ILint);
+typedef ILint64  (ILAPIENTRY *fTellWProc) (ILHANDLE);
 typedef ILint    (ILAPIENTRY *fWriteProc) (const void*, ILuint, ILuint, ILHANDLE);
 
 // Callback functions for allocation and deallocation
@@ -529,6 +564,41 @@ typedef void  (ILAPIENTRY *mFree) (const void* CONST_RESTRICT);
 typedef ILenum (ILAPIENTRY *IL_LOADPROC)(ILconst_string);
 typedef ILenum (ILAPIENTRY *IL_SAVEPROC)(ILconst_string);
 
+// Fills NumRows rows of an image being saved by ilSaveRows, starting at row
+//  FirstRow counted from the top.  Return IL_FALSE to abandon the save.
+typedef ILboolean (ILAPIENTRY *IL_ROWPROC)(void *UserData, ILuint FirstRow, ILuint NumRows, void *Data);
+
+// Image properties read by ilGetImageInfo without decoding the pixels
+typedef struct ILimageinfo
+{
+	ILuint		Width;
+	ILuint		Height;
+	ILuint		Depth;
+	ILenum		Format;      // format the image would have after ilLoad
+	ILenum		Type;        // type the image would have after ilLoad
+	ILuint		NumMips;     // mipmaps after the base image, as IL_NUM_MIPMAPS
+	ILuint		NumFaces;    // cube map faces after the first, as IL_NUM_FACES
+	ILuint		NumImages;   // frames or subimages after the first, as IL_NUM_IMAGES
+	ILboolean	HasProfile;  // the file has an embedded colour profile
+} ILimageinfo;
+
+// Takes NumRows rows of an image being loaded by ilLoadRows, starting at row
+//  FirstRow counted from the top, in Info->Format and Info->Type.  Data is only
+//  valid during the call.  Return IL_FALSE to stop decoding.
+typedef ILboolean (ILAPIENTRY *IL_ROWSINKPROC)(void *UserData, const ILimageinfo *Info, ILuint FirstRow, ILuint NumRows, const void *Data);
+
+// One file or lump handled by ilLoadBatch or ilSaveBatch
+typedef struct ILbatchitem
+{
+	ILconst_string	FileName;  // file to load or save, or NULL to use Lump/Data
+	const void		*Lump;     // ilLoadBatch: image in memory, Size bytes long
+	void			*Data;     // ilSaveBatch: receives the saved image when FileName is NULL (free with ifree(context, ...))
+	ILsizei			Size;      // size of Lump, or of Data after saving
+	ILenum			Type;      // file type, or IL_TYPE_UNKNOWN to detect it when loading
+	ILuint			Image;     // ilLoadBatch: receives the image name; ilSaveBatch: image to save
+	ILenum			Error;     // IL_NO_ERROR, or the error that stopped this item
+} ILbatchitem;
+
 // ImageLib Functions
 ILAPI ILboolean ILAPIENTRY ilActiveFace(ILcontext* context, ILuint Number);
 ILAPI ILboolean ILAPIENTRY ilActiveImage(ILcontext* context, ILuint Number);
@@ -539,15 +609,15 @@ ILAPI ILboolean ILAPIENTRY ilApplyProfile(ILstring InProfile, ILstring OutProfil
 ILAPI void		ILAPIENTRY ilBindImage(ILcontext* context, ILuint Image);
 ILAPI ILboolean ILAPIENTRY ilBlit(ILcontext* context, ILuint Source, ILint DestX, ILint DestY, ILint DestZ, ILuint SrcX, ILuint SrcY, ILuint SrcZ, ILuint Width, ILuint Height, ILuint Depth);
 ILAPI ILboolean ILAPIENTRY ilClampNTSC(void);
-ILAPI void		ILAPIENTRY ilClearColour(ILclampf Red, ILclampf Green, ILclampf Blue, ILclampf Alpha);
+ILAPI void		ILAPIENTRY ilClearColour(ILcontext* context, ILclampf Red, ILclampf Green, ILclampf Blue, ILclampf Alpha);
 ILAPI ILboolean ILAPIENTRY ilClearImage(ILcontext* context);
 ILAPI ILuint    ILAPIENTRY ilCloneCurImage(void);
-ILAPI ILubyte*	ILAPIENTRY ilCompressDXT(ILubyte *Data, ILuint Width, ILuint Height, ILuint Depth, ILenum DXTCFormat, ILuint *DXTCSize);
+ILAPI ILubyte*	ILAPIENTRY ilCompressDXT(ILcontext* context, ILubyte *Data, ILuint Width, ILuint Height, ILuint Depth, ILenum DXTCFormat, ILuint *DXTCSize);
 ILAPI ILboolean ILAPIENTRY ilCompressFunc(ILenum Mode);
 ILAPI ILboolean ILAPIENTRY ilConvertImage(ILcontext* context, ILenum DestFormat, ILenum DestType);
 ILAPI ILboolean ILAPIENTRY ilConvertPal(ILcontext* context, ILenum DestFormat);
 ILAPI ILboolean ILAPIENTRY ilCopyImage(ILuint Src);
-ILAPI ILuint    ILAPIENTRY ilCopyPixels(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZOff, ILuint Width, ILuint Height, ILuint Depth, ILenum Format, ILenum Type, void *Data);
+ILAPI ILsizei   ILAPIENTRY ilCopyPixels(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZOff, ILuint Width, ILuint Height, ILuint Depth, ILenum Format, ILenum Type, void *Data);
 ILAPI ILuint    ILAPIENTRY ilCreateSubImage(ILcontext* context, ILenum Type, ILuint Num);
 ILAPI ILboolean ILAPIENTRY ilDefaultImage(ILcontext* context);
 ILAPI void		ILAPIENTRY ilDeleteImage(ILcontext* context, const ILuint Num);
@@ -555,10 +625,10 @@ ILAPI void      ILAPIENTRY ilDeleteImages(ILcontext* context, ILsizei Num, const
 ILAPI ILenum	ILAPIENTRY ilDetermineType(ILcontext* context, ILconst_string FileName);
 ILAPI ILenum	ILAPIENTRY ilDetermineTypeF(ILcontext* context, ILHANDLE File);
 ILAPI ILenum	ILAPIENTRY ilDetermineTypeL(ILcontext* context, const void *Lump, ILuint Size);
-ILAPI ILboolean ILAPIENTRY ilDisable(ILenum Mode);
+ILAPI ILboolean ILAPIENTRY ilDisable(ILcontext* context, ILenum Mode);
 //ILAPI ILboolean ILAPIENTRY ilDxtcDataToImage(void);
 //ILAPI ILboolean ILAPIENTRY ilDxtcDataToSurface(ILcontext* context);
-ILAPI ILboolean ILAPIENTRY ilEnable(ILenum Mode);
+ILAPI ILboolean ILAPIENTRY ilEnable(ILcontext* context, ILenum Mode);
 ILAPI void		ILAPIENTRY ilFlipSurfaceDxtcData(void);
 ILAPI ILboolean ILAPIENTRY ilFormatFunc(ILcontext* context, ILenum Mode);
 ILAPI void	    ILAPIENTRY ilGenImages(ILcontext* context, ILsizei Num, ILuint *Images);
@@ -569,56 +639,72 @@ ILAPI void      ILAPIENTRY ilGetBooleanv(ILcontext* context, ILenum Mode, ILbool
 ILAPI ILubyte*  ILAPIENTRY ilGetData(ILcontext* context);
 ILAPI ILuint    ILAPIENTRY ilGetDXTCData(ILcontext* context, void *Buffer, ILuint BufferSize, ILenum DXTCFormat);
 ILAPI ILenum    ILAPIENTRY ilGetError(ILcontext* context);
+ILAPI ILboolean ILAPIENTRY ilGetImageInfo(ILcontext* context, ILenum Type, ILconst_string FileName, ILimageinfo *Info);
+ILAPI ILboolean ILAPIENTRY ilGetImageInfoF(ILcontext* context, ILenum Type, ILHANDLE File, ILimageinfo *Info);
+ILAPI ILboolean ILAPIENTRY ilGetImageInfoL(ILcontext* context, ILenum Type, const void *Lump, ILuint Size, ILimageinfo *Info);
 ILAPI ILint     ILAPIENTRY ilGetInteger(ILcontext* context, ILenum Mode);
 ILAPI void      ILAPIENTRY ilGetIntegerv(ILcontext* context, ILenum Mode, ILint *Param);
-ILAPI ILuint    ILAPIENTRY ilGetLumpPos(void);
+ILAPI ILsizei   ILAPIENTRY ilGetLumpPos(ILcontext* context);
 ILAPI ILubyte*  ILAPIENTRY ilGetPalette(void);
 ILAPI ILconst_string  ILAPIENTRY ilGetString(ILcontext* context, ILenum StringName);
 ILAPI void      ILAPIENTRY ilHint(ILenum Target, ILenum Mode);
 ILAPI ILboolean	ILAPIENTRY ilInvertSurfaceDxtcDataAlpha(void);
 ILAPI ILcontext* ILAPIENTRY ilInit(void);
 ILAPI ILboolean ILAPIENTRY ilImageToDxtcData(ILenum Format);
-ILAPI ILboolean ILAPIENTRY ilIsDisabled(ILenum Mode);
+ILAPI ILboolean ILAPIENTRY ilIsDisabled(ILcontext* context, ILenum Mode);
 ILAPI ILboolean ILAPIENTRY ilIsEnabled(ILcontext* context, ILenum Mode);
 ILAPI ILboolean ILAPIENTRY ilIsImage(ILcontext* context, ILuint Image);
-ILAPI ILboolean ILAPIENTRY ilIsValid(ILenum Type, ILconst_string FileName);
-ILAPI ILboolean ILAPIENTRY ilIsValidF(ILenum Type, ILHANDLE File);
-ILAPI ILboolean ILAPIENTRY ilIsValidL(ILenum Type, void *Lump, ILuint Size);
+ILAPI ILboolean ILAPIENTRY ilIsValid(ILcontext* context, ILenum Type, ILconst_string FileName);
+ILAPI ILboolean ILAPIENTRY ilIsValidF(ILcontext* context, ILenum Type, ILHANDLE File);
+ILAPI ILboolean ILAPIENTRY ilIsValidL(ILcontext* context, ILenum Type, void *Lump, ILuint Size);
 ILAPI void      ILAPIENTRY ilKeyColour(ILclampf Red, ILclampf Green, ILclampf Blue, ILclampf Alpha);
 ILAPI ILboolean ILAPIENTRY ilLoad(ILcontext* context, ILenum Type, ILconst_string FileName);
-ILAPI ILboolean ILAPIENTRY ilLoadF(ILenum Type, ILHANDLE File);
+ILAPI ILuint    ILAPIENTRY ilLoadBatch(ILcontext* context, ILbatchitem *Items, ILuint Num, ILenum DestFormat, ILenum DestType, ILuint NumThreads);
+ILAPI ILboolean ILAPIENTRY ilLoadF(ILcontext* context, ILenum Type, ILHANDLE File);
 ILAPI ILboolean ILAPIENTRY ilLoadImage(ILcontext* context, ILconst_string FileName);
 ILAPI ILboolean ILAPIENTRY ilLoadL(ILcontext* context, ILenum Type, const void *Lump, ILuint Size);
 ILAPI ILboolean ILAPIENTRY ilLoadPal(ILcontext* context, ILconst_string FileName);
+ILAPI ILboolean ILAPIENTRY ilLoadRegion(ILcontext* context, ILenum Type, ILconst_string FileName, ILuint XOff, ILuint YOff, ILuint Width, ILuint Height);
+ILAPI ILboolean ILAPIENTRY ilLoadRegionL(ILcontext* context, ILenum Type, const void *Lump, ILuint Size, ILuint XOff, ILuint YOff, ILuint Width, ILuint Height);
+ILAPI ILboolean ILAPIENTRY ilLoadRows(ILcontext* context, ILenum Type, ILconst_string FileName, ILenum Format, ILenum DataType, IL_ROWSINKPROC Proc, void *UserData);
+ILAPI ILboolean ILAPIENTRY ilLoadRowsF(ILcontext* context, ILenum Type, ILHANDLE File, ILenum Format, ILenum DataType, IL_ROWSINKPROC Proc, void *UserData);
+ILAPI ILboolean ILAPIENTRY ilLoadRowsL(ILcontext* context, ILenum Type, const void *Lump, ILuint Size, ILenum Format, ILenum DataType, IL_ROWSINKPROC Proc, void *UserData);
 ILAPI void      ILAPIENTRY ilModAlpha(ILdouble AlphaValue);
 ILAPI ILboolean ILAPIENTRY ilOriginFunc(ILcontext* context, ILenum Mode);
 ILAPI ILboolean ILAPIENTRY ilOverlayImage(ILcontext* context, ILuint Source, ILint XCoord, ILint YCoord, ILint ZCoord);
 ILAPI void      ILAPIENTRY ilPopAttrib(void);
 ILAPI void      ILAPIENTRY ilPushAttrib(ILuint Bits);
+ILAPI ILboolean ILAPIENTRY ilPushBegin(ILcontext* context, ILenum Type);
+ILAPI ILboolean ILAPIENTRY ilPushData(ILcontext* context, const void *Data, ILuint Size);
+ILAPI ILboolean ILAPIENTRY ilPushEnd(ILcontext* context);
 ILAPI void      ILAPIENTRY ilRegisterFormat(ILenum Format);
-ILAPI ILboolean ILAPIENTRY ilRegisterLoad(ILconst_string Ext, IL_LOADPROC Load);
+ILAPI ILboolean ILAPIENTRY ilRegisterLoad(ILcontext* context, ILconst_string Ext, IL_LOADPROC Load);
 ILAPI ILboolean ILAPIENTRY ilRegisterMipNum(ILuint Num);
 ILAPI ILboolean ILAPIENTRY ilRegisterNumFaces(ILuint Num);
 ILAPI ILboolean ILAPIENTRY ilRegisterNumImages(ILuint Num);
 ILAPI void      ILAPIENTRY ilRegisterOrigin(ILenum Origin);
 ILAPI void      ILAPIENTRY ilRegisterPal(ILcontext* context, void *Pal, ILuint Size, ILenum Type);
-ILAPI ILboolean ILAPIENTRY ilRegisterSave(ILconst_string Ext, IL_SAVEPROC Save);
+ILAPI ILboolean ILAPIENTRY ilRegisterSave(ILcontext* context, ILconst_string Ext, IL_SAVEPROC Save);
 ILAPI void      ILAPIENTRY ilRegisterType(ILenum Type);
-ILAPI ILboolean ILAPIENTRY ilRemoveLoad(ILconst_string Ext);
-ILAPI ILboolean ILAPIENTRY ilRemoveSave(ILconst_string Ext);
-ILAPI void      ILAPIENTRY ilResetMemory(void); // Deprecated
+ILAPI ILboolean ILAPIENTRY ilRemoveLoad(ILcontext* context, ILconst_string Ext);
+ILAPI ILboolean ILAPIENTRY ilRemoveSave(ILcontext* context, ILconst_string Ext);
+ILAPI void      ILAPIENTRY ilResetMemory(ILcontext* context); // Deprecated
 ILAPI void      ILAPIENTRY ilResetRead(ILcontext* context);
 ILAPI void      ILAPIENTRY ilResetWrite(ILcontext* context);
 ILAPI ILboolean ILAPIENTRY ilSave(ILcontext* context, ILenum Type, ILconst_string FileName);
+ILAPI ILuint    ILAPIENTRY ilSaveBatch(ILcontext* context, ILbatchitem *Items, ILuint Num, ILuint NumThreads);
 ILAPI ILuint    ILAPIENTRY ilSaveF(ILcontext* context, ILenum Type, ILHANDLE File);
 ILAPI ILboolean ILAPIENTRY ilSaveImage(ILcontext* context, ILconst_string FileName);
 ILAPI ILuint    ILAPIENTRY ilSaveL(ILcontext* context, ILenum Type, void *Lump, ILuint Size);
+ILAPI ILboolean ILAPIENTRY ilSaveRows(ILcontext* context, ILenum Type, ILconst_string FileName, ILuint Width, ILuint Height, ILenum Format, ILenum DataType, IL_ROWPROC Proc, void *UserData);
+ILAPI ILuint    ILAPIENTRY ilSaveRowsF(ILcontext* context, ILenum Type, ILHANDLE File, ILuint Width, ILuint Height, ILenum Format, ILenum DataType, IL_ROWPROC Proc, void *UserData);
+ILAPI void*     ILAPIENTRY ilSaveToMemory(ILcontext* context, ILenum Type, ILsizei *Size);
 ILAPI ILboolean ILAPIENTRY ilSavePal(ILcontext* context, ILconst_string FileName);
 ILAPI ILboolean ILAPIENTRY ilSetAlpha(ILcontext* context, ILdouble AlphaValue);
 ILAPI ILboolean ILAPIENTRY ilSetData(ILcontext* context, void *Data);
 ILAPI ILboolean ILAPIENTRY ilSetDuration(ILcontext* context, ILuint Duration);
 ILAPI void      ILAPIENTRY ilSetInteger(ILcontext* context, ILenum Mode, ILint Param);
-ILAPI void      ILAPIENTRY ilSetMemory(mAlloc, mFree);
+ILAPI void      ILAPIENTRY ilSetMemory(ILcontext* context, mAlloc, mFree);
 ILAPI void      ILAPIENTRY ilSetPixels(ILcontext* context, ILint XOff, ILint YOff, ILint ZOff, ILuint Width, ILuint Height, ILuint Depth, ILenum Format, ILenum Type, void *Data);
 ILAPI void      ILAPIENTRY ilSetRead(ILcontext* context, fOpenRProc, fCloseRProc, fEofProc, fGetcProc, fReadProc, fSeekRProc, fTellRProc);
 ILAPI void      ILAPIENTRY ilSetString(ILcontext* context, ILenum Mode, const char *String);
@@ -633,6 +719,7 @@ ILAPI ILboolean ILAPIENTRY ilTypeFunc(ILcontext* context, ILenum Mode);
 ILAPI ILboolean ILAPIENTRY ilLoadData(ILcontext* context, ILconst_string FileName, ILuint Width, ILuint Height, ILuint Depth, ILubyte Bpp);
 ILAPI ILboolean ILAPIENTRY ilLoadDataF(ILcontext* context, ILHANDLE File, ILuint Width, ILuint Height, ILuint Depth, ILubyte Bpp);
 ILAPI ILboolean ILAPIENTRY ilLoadDataL(ILcontext* context, void *Lump, ILuint Size, ILuint Width, ILuint Height, ILuint Depth, ILubyte Bpp);
+ILAPI ILboolean ILAPIENTRY ilLoadDataRegion(ILcontext* context, ILconst_string FileName, ILuint Width, ILuint Height, ILubyte Bpp, ILuint XOff, ILuint YOff, ILuint RegionWidth, ILuint RegionHeight);
 ILAPI ILboolean ILAPIENTRY ilSaveData(ILconst_string FileName);
 
 // For all those weirdos that spell "colour" without the 'u'.
@@ -6,5 +6,17 @@ public:
     class Impl;
     Impl* impl;
 
+    // State kept by ILU and ILUT for this context.  Each library creates its
+    //  own on first use and sets the matching Free function, which the
+    //  destructor calls.
+    class IluImpl;
+    IluImpl* iluImpl;
+    void (*iluFree)(ILcontext* context);
+
+    class IlutImpl;
+    IlutImpl* ilutImpl;
+    void (*ilutFree)(ILcontext* context);
+
 	ILcontext();
-};
\ No newline at end of file
+	~ILcontext();
+};
@@ -152,7 +152,7 @@ ILAPI ILboolean      ILAPIENTRY iluEnlargeCanvas(ILuint Width, ILuint Height, IL
 ILAPI ILboolean      ILAPIENTRY iluEnlargeImage(ILfloat XDim, ILfloat YDim, ILfloat ZDim);
 ILAPI ILboolean      ILAPIENTRY iluEqualize(void);
 ILAPI ILboolean      ILAPIENTRY iluEqualize2(void);
-ILAPI ILconst_string 		 ILAPIENTRY iluErrorString(ILenum Error);
+ILAPI ILconst_string 		 ILAPIENTRY iluErrorString(ILcontext* context, ILenum Error);
 ILAPI ILboolean      ILAPIENTRY iluConvolution(ILint *matrix, ILint scale, ILint bias);
 ILAPI ILboolean      ILAPIENTRY iluFlipImage(void);
 ILAPI ILboolean      ILAPIENTRY iluGammaCorrect(ILfloat Gamma);
@@ -169,8 +169,8 @@ ILAPI ILboolean      ILAPIENTRY iluMirror(void);
 ILAPI ILboolean      ILAPIENTRY iluNegative(void);
 ILAPI ILboolean      ILAPIENTRY iluNoisify(ILclampf Tolerance);
 ILAPI ILboolean      ILAPIENTRY iluPixelize(ILuint PixSize);
-ILAPI void           ILAPIENTRY iluRegionfv(ILpointf *Points, ILuint n);
-ILAPI void           ILAPIENTRY iluRegioniv(ILpointi *Points, ILuint n);
+ILAPI void           ILAPIENTRY iluRegionfv(ILcontext* context, ILpointf *Points, ILuint n);
+ILAPI void           ILAPIENTRY iluRegioniv(ILcontext* context, ILpointi *Points, ILuint n);
 ILAPI ILboolean      ILAPIENTRY iluReplaceColour(ILubyte Red, ILubyte Green, ILubyte Blue, ILfloat Tolerance);
 ILAPI ILboolean      ILAPIENTRY iluRotate(ILfloat Angle);
 ILAPI ILboolean      ILAPIENTRY iluRotate3D(ILfloat x, ILfloat y, ILfloat z, ILfloat Angle);
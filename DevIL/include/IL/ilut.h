@@ -278,7 +278,7 @@ ILAPI ILboolean     ILAPIENTRY ilutRenderer(ILcontext* context, ILenum Renderer)
 
 // ImageLib Utility Toolkit's DirectX 8 Functions
 #ifdef ILUT_USE_DIRECTX8
-//	ILAPI void	ILAPIENTRY ilutD3D8MipFunc(ILuint NumLevels);
+//	ILAPI void	ILAPIENTRY ilutD3D8MipFunc(ILcontext* context, ILuint NumLevels);
 	ILAPI struct IDirect3DTexture8* ILAPIENTRY ilutD3D8Texture(struct IDirect3DDevice8 *Device);
 	ILAPI struct IDirect3DVolumeTexture8* ILAPIENTRY ilutD3D8VolumeTexture(struct IDirect3DDevice8 *Device);
 	ILAPI ILboolean	ILAPIENTRY ilutD3D8TexFromFile(struct IDirect3DDevice8 *Device, char *FileName, struct IDirect3DTexture8 **Texture);
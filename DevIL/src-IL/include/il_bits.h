@@ -28,7 +28,7 @@ typedef struct BITFILE
 
 // Functions for reading bits from a file
 //BITFILE*	bopen(const char *FileName, const char *Mode);
-ILint		bclose(BITFILE *BitFile);
+ILint		bclose(ILcontext* context, BITFILE *BitFile);
 BITFILE*	bfile(ILcontext* context, ILHANDLE File);
 ILint		btell(BITFILE *BitFile);
 ILint		bseek(BITFILE *BitFile, ILuint Offset, ILuint Mode);
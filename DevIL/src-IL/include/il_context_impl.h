@@ -9,12 +9,22 @@
 // Just a guess...seems large enough
 #define I_STACK_INCREMENT 1024
 
+// Size of the read-ahead window used when reading from files
+#define IL_READ_BUFF_SIZE 65536
+
+// Starting size of the buffer allocated by ilSaveToMemory
+#define IL_DYNAMIC_LUMP_SIZE 65536
+
 typedef struct iFree
 {
 	ILuint	Name;
 	void	*Next;
 } iFree;
 
+struct iFormatL;
+struct iFormatS;
+class PngHandler;
+
 class ILcontext::Impl
 {
 public:
@@ -42,21 +52,32 @@ public:
 
 	ILHANDLE	FileRead = NULL, FileWrite = NULL;
 
-	ILuint		ReadLumpPos = 0, ReadLumpSize = 0, ReadFileStart = 0, WriteFileStart = 0;
-	ILuint		WriteLumpPos = 0, WriteLumpSize = 0;
+	ILsizei		ReadLumpPos = 0, ReadLumpSize = 0;
+	ILsizei		WriteLumpPos = 0, WriteLumpSize = 0;
+	ILuint64	ReadFileStart = 0, WriteFileStart = 0;
+
+	ILuint64 CurPos;  // Fake "file" pointer.
+	ILuint64 MaxPos;
 
-	ILuint CurPos;  // Fake "file" pointer.
-	ILuint MaxPos;
+	// Read-ahead window over FileRead, so that small reads do not each need
+	//  a call to ReadProc.  Always empty when reading from a lump.
+	ILubyte		ReadBuff[IL_READ_BUFF_SIZE];
+	ILuint		ReadBuffPos = 0, ReadBuffLen = 0;
+	ILuint64	ReadBuffStart = 0;  // Position of ReadBuff[0] in FileRead
+
+	mAlloc		ialloc_ptr;  // Set by ilSetMemory, malloc and free by default
+	mFree		ifree_ptr;
 
 	ILboolean	UseCache = IL_FALSE;
 	ILubyte*	Cache = NULL;
-	ILuint		CacheSize, CachePos, CacheStartPos, CacheBytesRead;
+	ILuint		CacheSize, CachePos, CacheBytesRead;
+	ILuint64	CacheStartPos;
 
 	void		(ILAPIENTRY *iclosew)(ILHANDLE);
 	ILHANDLE	(ILAPIENTRY *iopenw)(ILconst_string);
 	ILint		(ILAPIENTRY *iputc)(ILcontext* context, ILubyte Char);
-	ILint		(ILAPIENTRY *iseekw)(ILcontext* context, ILint Offset, ILuint Mode);
-	ILuint		(ILAPIENTRY *itellw)(ILcontext* context);
+	ILint		(ILAPIENTRY *iseekw)(ILcontext* context, ILint64 Offset, ILuint Mode);
+	ILuint64	(ILAPIENTRY *itellw)(ILcontext* context);
 	ILint		(ILAPIENTRY *iwrite)(ILcontext* context, const void *Buffer, ILuint Size, ILuint Number);
 
 	ILboolean	(ILAPIENTRY *ieof)(ILcontext* context);
@@ -64,8 +85,8 @@ public:
 	void		(ILAPIENTRY *icloser)(ILHANDLE);
 	ILint		(ILAPIENTRY *igetc)(ILcontext* context);
 	ILuint		(ILAPIENTRY *iread)(ILcontext* context, void *Buffer, ILuint Size, ILuint Number);
-	ILint		(ILAPIENTRY *iseek)(ILcontext* context, ILint Offset, ILuint Mode);
-	ILuint		(ILAPIENTRY *itell)(ILcontext* context);
+	ILint		(ILAPIENTRY *iseek)(ILcontext* context, ILint64 Offset, ILuint Mode);
+	ILuint64	(ILAPIENTRY *itell)(ILcontext* context);
 
 	fEofProc	EofProc;
 	fGetcProc	GetcProc;
@@ -95,5 +116,59 @@ public:
 
 	ILimage*	iCurImage;
 
+	// Linked lists of formats registered with ilRegisterLoad/ilRegisterSave
+	iFormatL*	LoadProcs = NULL;
+	iFormatS*	SaveProcs = NULL;
+
+	// Colour used by ilClearImage
+	ILfloat		ClearRed = 1.0f, ClearGreen = 0.972549f, ClearBlue = 0.90588f;
+	ILfloat		ClearAlpha = 0.0f, ClearLum = 1.0f;
+
 	jmp_buf		jumpBuffer;
-};
\ No newline at end of file
+
+	// Decoder fed by ilPushData, and how far it has got
+	PngHandler*	PushPng = NULL;
+	ILuint		PushRows = 0, PushPasses = 0;
+
+	// Rectangle ilLoadRegion wants, and whether the loader has dealt with it
+	ILuint		RegionX = 0, RegionY = 0, RegionW = 0, RegionH = 0;
+	ILboolean	RegionDone = IL_FALSE;
+};
+
+// Inline versions of igetc and iread for use in decoder inner loops.  They are
+//  served straight from the read-ahead window when possible and fall back to
+//  the regular functions otherwise (lumps, precaching, or an empty window).
+inline ILint iGetcFast(ILcontext* context)
+{
+	ILcontext::Impl *impl = context->impl;
+	if (impl->ReadBuffPos < impl->ReadBuffLen && !impl->UseCache)
+		return impl->ReadBuff[impl->ReadBuffPos++];
+	return impl->igetc(context);
+}
+
+// Returns the next byte without consuming it, or IL_EOF.
+inline ILint iPeekc(ILcontext* context)
+{
+	ILcontext::Impl *impl = context->impl;
+	ILint Val;
+
+	if (impl->ReadBuffPos < impl->ReadBuffLen && !impl->UseCache)
+		return impl->ReadBuff[impl->ReadBuffPos];
+	Val = impl->igetc(context);
+	if (Val != IL_EOF)
+		impl->iseek(context, -1, IL_SEEK_CUR);
+	return Val;
+}
+
+inline ILuint iReadFast(ILcontext* context, void *Buffer, ILuint Size, ILuint Number)
+{
+	ILcontext::Impl *impl = context->impl;
+	ILuint Bytes = Size * Number;
+
+	if (!impl->UseCache && Bytes <= impl->ReadBuffLen - impl->ReadBuffPos) {
+		memcpy(Buffer, impl->ReadBuff + impl->ReadBuffPos, Bytes);
+		impl->ReadBuffPos += Bytes;
+		return Number;
+	}
+	return impl->iread(context, Buffer, Size, Number);
+}
@@ -321,6 +321,12 @@ extern "C" {
 ILboolean	DecompressDXT1(ILimage *lImage, ILubyte *lCompData);
 ILboolean	DecompressDXT3(ILimage *lImage, ILubyte *lCompData);
 ILboolean	DecompressDXT5(ILimage *lImage, ILubyte *lCompData);
+ILboolean	DecompressBC6H(ILimage *lImage, const ILubyte *lCompData, ILboolean Signed);
+ILboolean	DecompressBC7(ILimage *lImage, const ILubyte *lCompData);
+void		DecodeBC6HBlock(const ILubyte *Block, ILboolean Signed, ILushort *Out);
+void		DecodeBC7Block(const ILubyte *Block, ILubyte *Out);
+void		EncodeBC6HBlock(const ILfloat *Pixels, ILboolean Signed, ILuint Effort, ILubyte *Block);
+void		EncodeBC7Block(const ILubyte *Pixels, ILuint Effort, ILubyte *Block);
 void		DxtcReadColor(ILushort Data, Color8888* Out);
 void		DxtcReadColors(const ILubyte* Data, Color8888* Out);
 ILboolean	iConvFloat16ToFloat32(ILuint* dest, ILushort* src, ILuint size);
@@ -366,7 +372,7 @@ protected:
 	DDSHEAD		Head;				// Image header
 	DXT10HEAD	HeadDXT10;			// DirectX 10 extension header
 	ILubyte*	CompData = NULL;	// Compressed data
-	ILuint		CompSize;			// Compressed size
+	ILsizei		CompSize;			// Compressed size
 	//ILuint	CompFormat;			// Compressed format
 	ILimage*	Image;
 	ILint		Width, Height, Depth;
@@ -389,12 +395,15 @@ protected:
 	ILboolean	DdsDecompress(ILuint CompFormat, ILboolean IsDXT10);
 	ILubyte		iCompFormatToBpp(ILenum Format);
 	ILubyte		iCompFormatToBpc(ILenum Format);
+	ILboolean	GetImageFormat(ILuint CompFormat, ILboolean IsDXT10, ILubyte *Channels, ILenum *Format, ILenum *Type);
 	ILboolean	iGetDdsHead(DDSHEAD *Header);
 	ILboolean	iLoadCubemapInternal(ILuint CompFormat, ILboolean IsDXT10);
 	ILboolean	ReadData(ILuint CompFormat, ILboolean IsDXT10);
 	ILboolean	ReadMipmaps(ILuint CompFormat, ILboolean IsDXT10);
+	ILboolean	ReadMipmapsDX10(ILuint CompFormat);
 
 	ILboolean	isValidInternal();
+	ILboolean	getInfoInternal(ILimageinfo *Info);
 	ILboolean	loadInternal();
 	ILboolean	saveInternal();
 
@@ -405,6 +414,9 @@ public:
 	ILboolean	isValidF(ILHANDLE File);
 	ILboolean	isValidL(const void *Lump, ILuint Size);
 
+	ILboolean	getInfoF(ILHANDLE File, ILimageinfo *Info);
+	ILboolean	getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info);
+
 	ILboolean	load(ILconst_string FileName);
 	ILboolean	loadF(ILHANDLE File);
 	ILboolean	loadL(const void *Lump, ILuint Size);
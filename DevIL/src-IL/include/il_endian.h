@@ -86,6 +86,10 @@ ILuint   GetBigUInt(ILcontext* context);
 ILint    GetBigInt(ILcontext* context);
 ILfloat  GetBigFloat(ILcontext* context);
 ILdouble GetBigDouble(ILcontext* context);
+ILuint   GetLittleUShorts(ILcontext* context, ILushort *Buffer, ILuint Count);
+ILuint   GetLittleUInts(ILcontext* context, ILuint *Buffer, ILuint Count);
+ILuint   GetBigUShorts(ILcontext* context, ILushort *Buffer, ILuint Count);
+ILuint   GetBigUInts(ILcontext* context, ILuint *Buffer, ILuint Count);
 ILubyte SaveLittleUShort(ILcontext* context, ILushort s);
 ILubyte SaveLittleShort(ILcontext* context, ILshort s);
 ILubyte SaveLittleUInt(ILcontext* context, ILuint i);
@@ -30,19 +30,20 @@ __FILES_EXTERN ILHANDLE			ILAPIENTRY iDefaultOpen(ILconst_string FileName);
 __FILES_EXTERN void		        ILAPIENTRY iDefaultClose(ILHANDLE Handle);
 __FILES_EXTERN ILint			ILAPIENTRY iDefaultGetc(ILcontext* context, ILHANDLE Handle);
 __FILES_EXTERN ILint			ILAPIENTRY iDefaultRead(void *Buffer, ILuint Size, ILuint Number, ILHANDLE Handle);
-__FILES_EXTERN ILint			ILAPIENTRY iDefaultSeekR(ILHANDLE Handle, ILint Offset, ILint Mode);
-__FILES_EXTERN ILint			ILAPIENTRY iDefaultSeekW(ILHANDLE Handle, ILint Offset, ILint Mode);
-__FILES_EXTERN ILint			ILAPIENTRY iDefaultTellR(ILHANDLE Handle);
-__FILES_EXTERN ILint			ILAPIENTRY iDefaultTellW(ILHANDLE Handle);
+__FILES_EXTERN ILint			ILAPIENTRY iDefaultSeekR(ILHANDLE Handle, ILint64 Offset, ILint Mode);
+__FILES_EXTERN ILint			ILAPIENTRY iDefaultSeekW(ILHANDLE Handle, ILint64 Offset, ILint Mode);
+__FILES_EXTERN ILint64			ILAPIENTRY iDefaultTellR(ILHANDLE Handle);
+__FILES_EXTERN ILint64			ILAPIENTRY iDefaultTellW(ILHANDLE Handle);
 __FILES_EXTERN ILint			ILAPIENTRY iDefaultPutc(ILubyte Char, ILHANDLE Handle);
 __FILES_EXTERN ILint			ILAPIENTRY iDefaultWrite(const void *Buffer, ILuint Size, ILuint Number, ILHANDLE Handle);
 
 __FILES_EXTERN void				iSetInputFile(ILcontext* context, ILHANDLE File);
-__FILES_EXTERN void				iSetInputLump(ILcontext* context, const void *Lump, ILuint Size);
+__FILES_EXTERN void				iSetInputLump(ILcontext* context, const void *Lump, ILsizei Size);
 
 __FILES_EXTERN void				iSetOutputFile(ILcontext* context, ILHANDLE File);
-__FILES_EXTERN void				iSetOutputLump(ILcontext* context, void *Lump, ILuint Size);
+__FILES_EXTERN void				iSetOutputLump(ILcontext* context, void *Lump, ILsizei Size);
 __FILES_EXTERN void				iSetOutputFake(ILcontext* context);
+__FILES_EXTERN void				iSetOutputDynamic(ILcontext* context);
  
 __FILES_EXTERN ILHANDLE			ILAPIENTRY iGetFile(ILcontext* context);
 __FILES_EXTERN const ILubyte*	ILAPIENTRY iGetLump(ILcontext* context);
@@ -50,7 +51,13 @@ __FILES_EXTERN const ILubyte*	ILAPIENTRY iGetLump(ILcontext* context);
 __FILES_EXTERN ILuint			ILAPIENTRY ilprintf(ILcontext* context, const char *, ...);
 __FILES_EXTERN void				ipad(ILcontext* context, ILuint NumZeros);
 
+__FILES_EXTERN ILboolean		iReadLarge(ILcontext* context, void *Buffer, ILsizei Size);
+__FILES_EXTERN ILboolean		iWriteLarge(ILcontext* context, const void *Buffer, ILsizei Size);
+
 __FILES_EXTERN ILboolean		iPreCache(ILcontext* context, ILuint Size);
 __FILES_EXTERN void				iUnCache(ILcontext* context);
 
+__FILES_EXTERN const void*		iMapFile(ILcontext* context, ILconst_string FileName, ILuint *Size);
+__FILES_EXTERN void				iUnmapFile(const void *View, ILuint Size);
+
 #endif//FILES_H
@@ -64,21 +64,22 @@ protected:
 
 	ILenum		GifType;
 
-	ILboolean	success;
-
-	ILint		curr_size, clear, ending, newcodes, top_slot, slot, navail_bytes = 0, nbits_left = 0;
-	ILubyte		b1;
-	ILubyte		byte_buff[257];
-	ILubyte*	pbytes;
-	ILubyte*	stack;
-	ILubyte*	suffix;
-	ILshort*	prefix;
-
-	ILint		get_next_code();
+	// LZW decoding state
+	ILubyte		Block[256];		// Data sub-block being decoded, then the size of the next one
+	ILuint		BlockSize, BlockPos, NextSize;
+	ILboolean	DataEof;		// The file ended inside the frame's data
+	ILuint		BitBuf, BitCount;
+	ILuint*		CodeOffset;		// Where each code's string was first written in the frame
+	ILushort*	CodeLength;
+	ILubyte*	Frame;			// Frames that cannot be decoded in place go here first
+	ILuint		FrameSize;
+
+	ILboolean	NextBlock();
+	ILint		GetCode(ILuint Size);
 	void		cleanUpGifLoadState();
 
 	ILboolean	GetImages(ILpal *GlobalPal, GIFHEAD *GifHead);
-	ILboolean	GifGetData(ILimage *Image, ILubyte *Data, ILuint ImageSize, ILuint Width, ILuint Height, ILuint Stride, ILuint PalOffset, GFXCONTROL *Gfx);
+	ILboolean	GifGetData(ILimage *Image, IMAGEDESC *Desc, ILuint PalOffset, GFXCONTROL *Gfx);
 
 	ILboolean	isValidInternal();
 	ILboolean	loadInternal();
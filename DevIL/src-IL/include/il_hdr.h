@@ -38,6 +38,8 @@ protected:
 	ILboolean	isValidInternal();
 	ILboolean	loadInternal();
 	ILboolean	saveInternal();
+	ILboolean	loadRowsInternal(iRowSink *Sink);
+	ILboolean	saveRowsInternal(iRowSource *Src);
 
 	void		ReadScanline(ILubyte *scanline, ILuint w);
 
@@ -51,8 +53,11 @@ public:
 	ILboolean	load(ILconst_string FileName);
 	ILboolean	loadF(ILHANDLE File);
 	ILboolean	loadL(const void *Lump, ILuint Size);
+	ILboolean	loadRowsF(ILHANDLE File, iRowSink *Sink);
+	ILboolean	loadRowsL(const void *Lump, ILuint Size, iRowSink *Sink);
 
 	ILboolean	save(ILconst_string FileName);
 	ILuint		saveF(ILHANDLE File);
 	ILuint		saveL(void *Lump, ILuint Size);
+	ILuint		saveRowsF(ILHANDLE File, iRowSource *Src);
 };
\ No newline at end of file
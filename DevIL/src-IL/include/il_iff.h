@@ -2,11 +2,27 @@
 
 #include "il_internal.h"
 
+// Chunk type and data:
+typedef struct _iff_chunk {
+	ILuint	tag;
+	ILuint	start;
+	ILuint	size;
+	ILuint	chunkType;
+} iff_chunk;
+
+#define CHUNK_STACK_SIZE (32)
+
 class IffHandler
 {
 protected:
 	ILcontext * context;
 
+	iff_chunk	chunkStack[CHUNK_STACK_SIZE];
+	int			chunkDepth = -1;
+
+	iff_chunk	iff_begin_read_chunk();
+	void		iff_end_read_chunk();
+
 	ILboolean	loadInternal();
 
 public:
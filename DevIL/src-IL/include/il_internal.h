@@ -181,7 +181,47 @@ ILuint		ilCharStrLen(const char *Str);
 void					ilDefaultStates(ILcontext* context);
 ILenum					iGetHint(ILcontext* context, ILenum Target);
 ILint					iGetInt(ILcontext* context, ILenum Mode);
-void					ilRemoveRegistered(void);
+void					ilRemoveRegistered(ILcontext* context);
+void					iPushCleanup(ILcontext* context);
+// Region-of-interest loading (il_region.cpp)
+ILboolean				iRegionActive(ILcontext* context);
+ILboolean				iRegionClaim(ILcontext* context, ILuint Width, ILuint Height);
+ILuint					iRegionFirstRow(ILcontext* context, ILuint Height, ILboolean BottomUp);
+ILboolean				iRegionReadRows(ILcontext* context, ILimage *Image, ILuint FileBps, ILuint FirstCol, ILuint FirstRow);
+// Streaming saves (il_saverows.cpp).  The saver says what it wants with
+//  iRowsBegin, then takes the rows top-down from iRowsNext.
+typedef struct iRowSource
+{
+	ILuint		Width, Height;
+	ILenum		Format, Type;		// What Proc gives
+	IL_ROWPROC	Proc;
+	void		*UserData;
+	ILenum		DestFormat, DestType;	// What the saver wants
+	ILuint		Bps, DestBps;
+	ILubyte		*Band, *DestBand;	// DestBand is Band when no conversion is needed
+	ILuint		BandRows, BandFirst, BandCount, NextRow;
+} iRowSource;
+ILboolean				iRowsBegin(ILcontext* context, iRowSource *Src, ILenum DestFormat, ILenum DestType);
+ILubyte*				iRowsNext(ILcontext* context, iRowSource *Src);
+void					iRowsEnd(ILcontext* context, iRowSource *Src);
+// Streaming loads (il_loadrows.cpp).  The decoder says what it gives with
+//  iSinkBegin, then fills the rows top-down where iSinkRows says.
+typedef struct iRowSink
+{
+	IL_ROWSINKPROC	Proc;
+	void			*UserData;
+	ILenum			DestFormat, DestType;	// What Proc wants
+	ILimageinfo		Info;					// What Proc is told
+	ILenum			Format, Type;			// What the decoder gives
+	ILuint			Bps;
+	ILubyte			*Band;
+	ILuint			BandRows, BandFirst, BandCount;
+	ILboolean		Whole;					// Set by a decoder that cannot stream the file
+} iRowSink;
+ILboolean				iSinkBegin(ILcontext* context, iRowSink *Sink, ILuint Width, ILuint Height, ILenum Format, ILenum Type);
+ILubyte*				iSinkRows(ILcontext* context, iRowSink *Sink, ILuint NumRows);
+ILboolean				iSinkFlush(ILcontext* context, iRowSink *Sink);
+void					iSinkEnd(ILcontext* context, iRowSink *Sink);
 ILAPI void ILAPIENTRY	ilSetCurImage(ILcontext* context, ILimage *Image);
 ILuint					ilDetermineSize(ILcontext* context, ILenum Type);
 //
@@ -194,6 +234,7 @@ ILuint					ilDetermineSize(ILcontext* context, ILenum Type);
 ILboolean	ilRleCompressLine(ILcontext* context, ILubyte *ScanLine, ILuint Width, ILubyte Bpp, ILubyte *Dest, ILuint *DestWidth, ILenum CompressMode);
 ILuint		ilRleCompress(ILcontext* context, ILubyte *Data, ILuint Width, ILuint Height, ILuint Depth, ILubyte Bpp, ILubyte *Dest, ILenum CompressMode, ILuint *ScanTable);
 void		iSetImage0(ILcontext* context);
+void		iFreeImageStack(ILcontext* context);
 // DXTC compression
 ILuint			ilNVidiaCompressDXTFile(ILubyte *Data, ILuint Width, ILuint Height, ILuint Depth, ILenum DxtType);
 ILAPI ILubyte*	ILAPIENTRY ilNVidiaCompressDXT(ILubyte *Data, ILuint Width, ILuint Height, ILuint Depth, ILenum DxtFormat, ILuint *DxtSize);
@@ -203,6 +244,8 @@ ILAPI ILubyte*	ILAPIENTRY ilSquishCompressDXT(ILubyte *Data, ILuint Width, ILuin
 ILboolean	ilAddAlpha(ILcontext* context);
 ILboolean	ilAddAlphaKey(ILcontext* context, ILimage *Image);
 ILboolean	iFastConvert(ILcontext* context, ILenum DestFormat);
+ILboolean	iCanConvertPixels(ILenum SrcFormat, ILenum SrcType, ILenum DestFormat, ILenum DestType);
+void		iConvertPixels(const void *Src, ILenum SrcFormat, ILenum SrcType, void *Dest, ILenum DestFormat, ILenum DestType, ILsizei NumPix);
 ILboolean	ilFixCur(ILcontext* context);
 ILboolean	ilFixImage(ILcontext* context);
 ILboolean	ilRemoveAlpha(ILcontext* context);
@@ -37,6 +37,8 @@ protected:
 	static void iJpegErrorExit(j_common_ptr cinfo);
 	
 	void		devil_jpeg_read_init(j_decompress_ptr cinfo);
+	void		setDecodeScale(j_decompress_ptr cinfo);
+	void		setOutputSpace(j_decompress_ptr cinfo);
 #endif
 
 	ILboolean	loadFromJpegStruct(void *_JpegInfo);
@@ -44,9 +46,14 @@ protected:
 
 	ILboolean	check(ILubyte Header[2]);
 	ILboolean	isValidInternal();
+#ifndef IL_USE_IJL
+	ILboolean	getInfoInternal(ILimageinfo *Info);
+#endif
 
 #ifndef IL_USE_IJL
 	ILboolean	saveInternal();
+	ILboolean	loadRowsInternal(iRowSink *Sink);
+	ILboolean	saveRowsInternal(iRowSource *Src);
 #else
 	ILboolean	saveInternal(ILconst_string FileName, ILvoid *Lump, ILuint Size);
 #endif
@@ -65,13 +72,25 @@ public:
 	ILboolean	isValidF(ILHANDLE File);
 	ILboolean	isValidL(const void *Lump, ILuint Size);
 
+#ifndef IL_USE_IJL
+	ILboolean	getInfoF(ILHANDLE File, ILimageinfo *Info);
+	ILboolean	getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info);
+#endif
+
 	ILboolean	load(ILconst_string FileName);
 	ILboolean	loadF(ILHANDLE File);
 	ILboolean	loadL(const void *Lump, ILuint Size);
+#ifndef IL_USE_IJL
+	ILboolean	loadRowsF(ILHANDLE File, iRowSink *Sink);
+	ILboolean	loadRowsL(const void *Lump, ILuint Size, iRowSink *Sink);
+#endif
 
 	ILboolean	save(ILconst_string FileName);
 	ILuint		saveF(ILHANDLE File);
 	ILuint		saveL(void *Lump, ILuint Size);
+#ifndef IL_USE_IJL
+	ILuint		saveRowsF(ILHANDLE File, iRowSource *Src);
+#endif
 };
 
 #endif // IL_NO_JPG
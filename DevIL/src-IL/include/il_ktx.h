@@ -9,6 +9,7 @@ protected:
 
 	ILboolean	isValidInternal();
 	ILboolean	loadInternal();
+	ILboolean	saveInternal();
 
 public:
 	KtxHandler(ILcontext* context);
@@ -20,4 +21,15 @@ public:
 	ILboolean	load(ILconst_string FileName);
 	ILboolean	loadF(ILHANDLE File);
 	ILboolean	loadL(const void *Lump, ILuint Size);
-};
\ No newline at end of file
+
+	ILboolean	save(ILconst_string FileName);
+	ILuint		saveF(ILHANDLE File);
+	ILuint		saveL(void *Lump, ILuint Size);
+};
+
+// ETC1, ETC2 and EAC blocks (il_etc.cpp).  Pixels are 4x4 RGBA, row by row.
+void		DecodeEtc2Block(const ILubyte *Block, ILboolean PunchThrough, ILubyte *Out);
+void		DecodeEacBlock(const ILubyte *Block, ILubyte *Out, ILuint Stride);
+void		EncodeEtc1Block(const ILubyte *Pixels, ILuint Quality, ILubyte *Block);
+void		EncodeEtc2Block(const ILubyte *Pixels, ILuint Quality, ILubyte *Block);
+void		EncodeEacBlock(const ILubyte *Values, ILuint Stride, ILuint Quality, ILubyte *Block);
@@ -15,14 +15,29 @@ protected:
     ILint		png_color_type;
 
 	ILint		readpng_init();
+	ILboolean	readpng_transform(png_uint_32 *Width, png_uint_32 *Height, ILenum *Format, ILenum *Type, ILboolean ExpandPalette);
+	ILboolean	readpng_setup();
 	ILboolean	readpng_get_image(ILdouble display_exponent);
 	void		readpng_cleanup(void);
+	ILboolean	readRegion = IL_FALSE;  // Only the ilLoadRegion rectangle is made
+
+	// Push decoding
+	ILimage*	pushImage = NULL;  // Where the rows go
+	ILboolean	pushDone = IL_FALSE;
+
+	static void	push_info(png_structp png_ptr, png_infop info_ptr);
+	static void	push_row(png_structp png_ptr, png_bytep new_row, png_uint_32 row_num, int pass);
+	static void	push_end(png_structp png_ptr, png_infop info_ptr);
 
     ILboolean	isValidInternal();
+    ILboolean	getInfoInternal(ILimageinfo *Info);
 	ILboolean	saveInternal();
+	ILboolean	loadRowsInternal(iRowSink *Sink);
+	ILboolean	saveRowsInternal(iRowSource *Src);
 
 public:
     PngHandler(ILcontext* context);
+    ~PngHandler();
 
 	// This is so bad and should be fixed
 	ILboolean	loadInternal();
@@ -30,14 +45,25 @@ public:
     ILboolean	isValid(ILconst_string FileName);
     ILboolean	isValidF(ILHANDLE File);
     ILboolean	isValidL(const void *Lump, ILuint Size);
+
+    ILboolean	getInfoF(ILHANDLE File, ILimageinfo *Info);
+    ILboolean	getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info);
     
 	ILboolean	load(ILconst_string FileName);
     ILboolean	loadF(ILHANDLE File);
     ILboolean	loadL(const void *Lump, ILuint Size);
+    ILboolean	loadRowsF(ILHANDLE File, iRowSink *Sink);
+    ILboolean	loadRowsL(const void *Lump, ILuint Size, iRowSink *Sink);
     
 	ILboolean	save(ILconst_string FileName);
     ILuint		saveF(ILHANDLE File);
     ILuint		saveL(void *Lump, ILuint Size);
+    ILuint		saveRowsF(ILHANDLE File, iRowSource *Src);
+
+	// Incremental loading from data as it arrives (ilPushBegin and friends)
+	ILboolean	pushBegin();
+	ILboolean	pushData(const void *Data, ILuint Size);
+	ILboolean	pushEnd();
 };
 
 #endif // IL_NO_PNG
\ No newline at end of file
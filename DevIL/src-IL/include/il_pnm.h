@@ -16,14 +16,22 @@
 
 #include "il_internal.h"
 
+// According to the ppm specs, it's 70, but PSP
+//  likes to output longer lines.
+#define MAX_BUFFER 180
+
 class PnmHandler
 {
 protected:
 	ILcontext* context;
 
+	ILbyte SmallBuff[MAX_BUFFER];  // Current word of the header
+	ILstring FName = NULL;
+
 	ILboolean	isValidInternal();
 	ILboolean	loadInternal();
 	ILboolean	saveInternal();
+	ILboolean	saveRowsInternal(iRowSource *Src);
 
 public:
 	PnmHandler(ILcontext* context);
@@ -39,4 +47,5 @@ public:
 	ILboolean	save(ILconst_string FileName);
 	ILuint		saveF(ILHANDLE File);
 	ILuint		saveL(void *Lump, ILuint Size);
+	ILuint		saveRowsF(ILHANDLE File, iRowSource *Src);
 };
\ No newline at end of file
@@ -52,6 +52,7 @@ protected:
 	ILboolean	check(PSDHEAD *Header);
 
 	ILboolean	isValidInternal();
+	ILboolean	getInfoInternal(ILimageinfo *Info);
 	ILboolean	loadInternal();
 	ILboolean	saveInternal();
 
@@ -62,6 +63,9 @@ public:
 	ILboolean	isValidF(ILHANDLE File);
 	ILboolean	isValidL(const void *Lump, ILuint Size);
 
+	ILboolean	getInfoF(ILHANDLE File, ILimageinfo *Info);
+	ILboolean	getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info);
+
 	ILboolean	load(ILconst_string FileName);
 	ILboolean	loadF(ILHANDLE File);
 	ILboolean	loadL(const void *Lump, ILuint Size);
@@ -14,11 +14,128 @@
 
 #include "il_internal.h"
 
+#ifdef _MSC_VER
+#pragma pack(push, packed_struct, 1)
+#endif
+
+typedef struct PSPRECT
+{
+	ILuint x1,y1,x2,y2;
+} IL_PACKSTRUCT PSPRECT;
+
+typedef struct PSPHEAD
+{
+	char		FileSig[32];
+	ILushort	MajorVersion;
+	ILushort	MinorVersion;
+} IL_PACKSTRUCT PSPHEAD;
+
+typedef struct BLOCKHEAD
+{
+	ILubyte		HeadID[4];
+	ILushort	BlockID;
+	ILuint		BlockLen;
+} IL_PACKSTRUCT BLOCKHEAD;
+
+typedef struct GENATT_CHUNK
+{
+	ILint		Width;
+	ILint		Height;
+	ILdouble	Resolution;
+	ILubyte		ResMetric;
+	ILushort	Compression;
+	ILushort	BitDepth;
+	ILushort	PlaneCount;
+	ILuint		ColourCount;
+	ILubyte		GreyscaleFlag;
+	ILuint		SizeOfImage;
+	ILint		ActiveLayer;
+	ILushort	LayerCount;
+	ILuint		GraphicContents;
+} IL_PACKSTRUCT GENATT_CHUNK;
+
+typedef struct LAYERINFO_CHUNK
+{
+	ILubyte		LayerType;
+	PSPRECT		ImageRect;
+	PSPRECT		SavedImageRect;
+	ILubyte		Opacity;
+	ILubyte		BlendingMode;
+	ILubyte		LayerFlags;
+	ILubyte		TransProtFlag;
+	ILubyte		LinkID;
+	PSPRECT		MaskRect;
+	PSPRECT		SavedMaskRect;
+	ILubyte		MaskLinked;
+	ILubyte		MaskDisabled;
+	ILubyte		InvertMaskBlend;
+	ILushort	BlendRange;
+	ILubyte		SourceBlend1[4];
+	ILubyte		DestBlend1[4];
+	ILubyte		SourceBlend2[4];
+	ILubyte		DestBlend2[4];
+	ILubyte		SourceBlend3[4];
+	ILubyte		DestBlend3[4];
+	ILubyte		SourceBlend4[4];
+	ILubyte		DestBlend4[4];
+	ILubyte		SourceBlend5[4];
+	ILubyte		DestBlend5[4];
+} IL_PACKSTRUCT LAYERINFO_CHUNK;
+
+typedef struct LAYERBITMAP_CHUNK
+{
+	ILushort	NumBitmaps;
+	ILushort	NumChannels;
+} IL_PACKSTRUCT LAYERBITMAP_CHUNK;
+
+typedef struct CHANNEL_CHUNK
+{
+	ILuint		CompLen;
+	ILuint		Length;
+	ILushort	BitmapType;
+	ILushort	ChanType;
+} IL_PACKSTRUCT CHANNEL_CHUNK;
+
+typedef struct ALPHAINFO_CHUNK
+{
+	PSPRECT		AlphaRect;
+	PSPRECT		AlphaSavedRect;
+} IL_PACKSTRUCT ALPHAINFO_CHUNK;
+
+typedef struct ALPHA_CHUNK
+{
+	ILushort	BitmapCount;
+	ILushort	ChannelCount;
+} IL_PACKSTRUCT ALPHA_CHUNK;
+
+#ifdef _MSC_VER
+#pragma pack(pop,  packed_struct)
+#endif
+
 class PspHandler
 {
 protected:
 	ILcontext * context;
 
+	// These contain most of the image information.
+	GENATT_CHUNK	AttChunk;
+	PSPHEAD			Header;
+	ILuint			NumChannels = 0;
+	ILubyte			**Channels = NULL;
+	ILubyte			*Alpha = NULL;
+	ILpal			Pal;
+
+	ILboolean	iGetPspHead();
+	ILboolean	iCheckPsp();
+	ILboolean	ReadGenAttributes();
+	ILboolean	ParseChunks();
+	ILboolean	ReadLayerBlock(ILuint BlockLen);
+	ILboolean	ReadAlphaBlock(ILuint BlockLen);
+	ILubyte		*GetChannel();
+	ILboolean	ReadPalette(ILuint BlockLen);
+	ILboolean	AssembleImage();
+	ILboolean	Cleanup();
+
 	ILboolean	isValidInternal();
 	ILboolean	loadInternal();
 
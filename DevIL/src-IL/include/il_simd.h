@@ -0,0 +1,71 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/include/il_simd.h
+//
+// Description: Vectorised kernels for the byte conversions in ilConvertBuffer
+//				and for DXTC decoding
+//
+//-----------------------------------------------------------------------------
+
+#ifndef IL_SIMD_H
+#define IL_SIMD_H
+
+#include "il_internal.h"
+
+// Instruction sets the kernels can use, from slowest to fastest
+enum iSimdLevel
+{
+	IL_SIMD_NONE = 0,
+	IL_SIMD_SSE2,
+	IL_SIMD_SSSE3,
+	IL_SIMD_AVX2,
+	IL_SIMD_NEON
+};
+
+// Kernels for 8-bit pixels and for switching to and from 8-bit types.  All
+//  counts are in pixels (or in values for the type conversions).  The scalar
+//  versions are used for anything the CPU cannot do faster, and the results
+//  are the same whichever version runs.
+typedef struct iConvKernels
+{
+	ILenum	Level;  // One of iSimdLevel
+
+	// RGB <-> BGR and RGBA <-> BGRA.  Src and Dest may be the same buffer.
+	void (*SwapRB3)(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix);
+	void (*SwapRB4)(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix);
+
+	// RGB -> RGBA with an opaque alpha, swapping red and blue if SwapRB is set.
+	void (*Expand3To4)(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILboolean SwapRB);
+
+	// RGBA -> RGB, dropping alpha and swapping red and blue if SwapRB is set.
+	//  Src and Dest may be the same buffer.
+	void (*Shrink4To3)(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILboolean SwapRB);
+
+	// Weighted sum of the first three channels of 3- or 4-byte pixels.  The
+	//  sum is formed in single precision in channel order and truncated.  Src
+	//  and Dest may be the same buffer.
+	void (*Luminance)(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILuint Bpp, const ILfloat *Factors);
+
+	// The unsigned byte cases of iSwitchTypes
+	void (*ByteToShort)(const ILubyte *Src, ILushort *Dest, ILsizei Num);
+	void (*ShortToByte)(const ILushort *Src, ILubyte *Dest, ILsizei Num);
+	void (*ByteToFloat)(const ILubyte *Src, ILfloat *Dest, ILsizei Num);
+	void (*FloatToByte)(const ILfloat *Src, ILubyte *Dest, ILsizei Num);  // Clamps to [0, 1] first
+
+	// DXT1, DXT3 and DXT5 blocks to RGBA.  NumBlocks blocks that follow each
+	//  other in Src (part of a row of blocks) become 4 rows of 4 * NumBlocks
+	//  pixels, the first at Dest and the others Stride bytes apart.
+	void (*DecodeDxt1)(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride);
+	void (*DecodeDxt3)(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride);
+	void (*DecodeDxt5)(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride);
+} iConvKernels;
+
+// Returns the kernels for the CPU the library is running on.  They are chosen
+//  on the first call and do not change afterwards.
+const iConvKernels* iGetConvKernels(void);
+
+#endif//IL_SIMD_H
@@ -38,6 +38,7 @@ typedef struct IL_STATES
 	ILenum		ilTypeMode;
 	// File mode states
 	ILboolean	ilOverWriteFiles;
+	ILboolean	ilMapFiles;
 	// Palette states
 	ILboolean	ilAutoConvPal;
 	// Load fail states
@@ -72,12 +73,23 @@ typedef struct IL_STATES
 	ILboolean	ilSgiRle;
 	ILenum		ilJpgFormat;
 	ILboolean	ilJpgProgressive;
+	ILuint		ilJpgDecodeScale;
+	ILuint		ilJpgDecodeSize;
+	ILuint		ilPngCompression;
+	ILenum		ilPngFilter;
+	ILenum		ilPngStrategy;
+	ILboolean	ilPngFast;
+	ILuint		ilExrThreads;
 	ILenum		ilDxtcFormat;
+	ILenum		ilDxtcQuality;
+	ILuint		ilBptcEffort;
 	ILenum		ilPcdPicNum;
 
 	ILint		ilPngAlphaIndex;	// this index should be treated as an alpha key (most formats use this rather than having alpha in the palette), -1 for none
 									// currently only used when writing out .png files and should obviously be set to -1 most of the time
 	ILenum		ilVtfCompression;
+	ILenum		ilKtxCompression;
+	ILuint		ilEtcQuality;
 
 
 	//
@@ -110,6 +122,9 @@ typedef struct IL_HINTS
 
 } IL_HINTS;
 
+void iCopyStateStrings(ILcontext* context, IL_STATES *States);
+void iFreeStateStrings(ILcontext* context);
+
 #ifndef IL_NO_BLP
 	#define IL_BLP_EXT "blp "
 #else
@@ -224,6 +239,12 @@ typedef struct IL_HINTS
 	#define IL_JPG_EXT ""
 #endif
 
+#ifndef IL_NO_KTX
+	#define IL_KTX_EXT "ktx "
+#else
+	#define IL_KTX_EXT ""
+#endif
+
 #ifndef IL_NO_LIF
 	#define IL_LIF_EXT "lif "
 #else
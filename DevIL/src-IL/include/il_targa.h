@@ -95,6 +95,8 @@ protected:
 	ILboolean	iReadColMapTga(TARGAHEAD *Header);
 	ILboolean	iReadUnmapTga(TARGAHEAD *Header);
 	ILboolean	iReadBwTga(TARGAHEAD *Header);
+	ILboolean	iNewTga(TARGAHEAD *Header, ILubyte Bpp, ILenum Format);
+	ILboolean	iReadTgaData(TARGAHEAD *Header);
 	ILboolean	iUncompressTgaData(ILimage *Image);
 	ILboolean	i16BitTarga(ILimage *Image);
 
@@ -103,6 +105,7 @@ protected:
 	ILboolean	isValidInternal();
 	ILboolean	loadInternal();
 	ILboolean	saveInternal();
+	ILboolean	saveRowsInternal(iRowSource *Src);
 
 public:
 	TargaHandler(ILcontext* context);
@@ -118,6 +121,5 @@ public:
 	ILboolean	save(ILconst_string FileName);
 	ILuint		saveF(ILHANDLE File);
 	ILuint		saveL(void *Lump, ILuint Size);
-
-	ILuint		size();
+	ILuint		saveRowsF(ILHANDLE File, iRowSource *Src);
 };
\ No newline at end of file
@@ -0,0 +1,61 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/include/il_threads.h
+//
+// Description: Splits independent work (block rows and the like) over threads
+//
+//-----------------------------------------------------------------------------
+
+#ifndef IL_THREADS_H
+#define IL_THREADS_H
+
+#include "il_internal.h"
+
+#include <thread>
+#include <vector>
+
+
+// Calls Work(First, Last) for consecutive ranges that together cover
+//  [0, Num), with at most one range per processor and at least MinPerThread
+//  items in each.  The calling thread does the last range itself.  Work must
+//  not touch library state that other ranges use (the error stack, the
+//  current image and so on), only its own part of the output.
+template <typename Func>
+void iParallelFor(ILuint Num, ILuint MinPerThread, Func Work)
+{
+	std::vector<std::thread>	Threads;
+	ILuint						NumThreads, PerThread, First, i;
+
+	NumThreads = std::thread::hardware_concurrency();
+	if (MinPerThread == 0)
+		MinPerThread = 1;
+	if (NumThreads > Num / MinPerThread)
+		NumThreads = Num / MinPerThread;
+	if (NumThreads <= 1) {
+		if (Num > 0)
+			Work(0, Num);
+		return;
+	}
+
+	PerThread = (Num + NumThreads - 1) / NumThreads;
+	for (First = 0; First + PerThread < Num; First += PerThread) {
+		try {
+			Threads.emplace_back(Work, First, First + PerThread);
+		}
+		catch (...) {
+			break;  // Whatever is left runs here.
+		}
+	}
+
+	Work(First, Num);
+	for (i = 0; i < Threads.size(); i++)
+		Threads[i].join();
+
+	return;
+}
+
+#endif//IL_THREADS_H
@@ -4,14 +4,20 @@
 
 #ifndef IL_NO_TIF
 
+struct tiff;  // TIFF in tiffio.h
+
 class TiffHandler
 {
 protected:
     ILcontext*  context;
 
     ILboolean	isValidInternal();
+    ILboolean	getInfoInternal(ILimageinfo *Info);
     ILboolean	loadInternal();
+	ILboolean	loadTiles(struct tiff *tif, ILimage *Image, ILuint Dir, ILuint XOff, ILuint YOff);
 	ILboolean	saveInternal();
+	ILboolean	loadRowsInternal(iRowSink *Sink);
+	ILboolean	saveRowsInternal(iRowSource *Src);
 
 public:
     TiffHandler(ILcontext* context);
@@ -19,14 +25,20 @@ public:
     ILboolean	isValid(ILconst_string FileName);
     ILboolean	isValidF(ILHANDLE File);
     ILboolean	isValidL(const void *Lump, ILuint Size);
+
+    ILboolean	getInfoF(ILHANDLE File, ILimageinfo *Info);
+    ILboolean	getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info);
     
 	ILboolean	load(ILconst_string FileName);
     ILboolean	loadF(ILHANDLE File);
     ILboolean	loadL(const void *Lump, ILuint Size);
+    ILboolean	loadRowsF(ILHANDLE File, iRowSink *Sink);
+    ILboolean	loadRowsL(const void *Lump, ILuint Size, iRowSink *Sink);
     
 	ILboolean	save(ILconst_string FileName);
     ILuint		saveF(ILHANDLE File);
     ILuint		saveL(void *Lump, ILuint Size);
+    ILuint		saveRowsF(ILHANDLE File, iRowSource *Src);
 };
 
 #endif // IL_NO_TIF
\ No newline at end of file
@@ -35,9 +35,6 @@
 static void ILAPIENTRY DefaultFreeFunc(const void * CONST_RESTRICT Ptr);
 static void* ILAPIENTRY DefaultAllocFunc(const ILsizei Size);
 
-static mAlloc ialloc_ptr = DefaultAllocFunc;
-static mFree  ifree_ptr = DefaultFreeFunc;
-
 /*** Vector Allocation/Deallocation Function ***/
 #ifdef VECTORMEM
 void *vec_malloc(const ILsizei size)
@@ -71,12 +68,12 @@ void *vec_malloc(const ILsizei size)
 #endif //MM_MALLOC
 }
 
-void *ivec_align_buffer(void *buffer, const ILsizei size)
+void *ivec_align_buffer(ILcontext* context, void *buffer, const ILsizei size)
 {
 	if( (ILsizei)buffer % 16 != 0 ) {
         void *aligned_buffer = vec_malloc( size );
         memcpy( aligned_buffer, buffer, size );
-        ifree( buffer );
+        ifree( context, buffer );
         return aligned_buffer;
     }
     return buffer;
@@ -87,17 +84,17 @@ void *ivec_align_buffer(void *buffer, const ILsizei size)
 /*** Allocation/Deallocation Function ***/
 void* ILAPIENTRY ialloc(ILcontext* context, const ILsizei Size)
 {
-	void *Ptr = ialloc_ptr(Size);
+	void *Ptr = context->impl->ialloc_ptr(Size);
 	if (Ptr == NULL)
 		ilSetError(context, IL_OUT_OF_MEMORY);
 	return Ptr;
 }
 
-void ILAPIENTRY ifree(const void * CONST_RESTRICT Ptr)
+void ILAPIENTRY ifree(ILcontext* context, const void * CONST_RESTRICT Ptr)
 {
 	if (Ptr == NULL)
 		return;
-	ifree_ptr(Ptr);
+	context->impl->ifree_ptr(Ptr);
 	return;
 }
 
@@ -137,16 +134,63 @@ static void ILAPIENTRY DefaultFreeFunc(const void * CONST_RESTRICT ptr)
 }
 
 /*** Manipulate Allocation/Deallocation Function ***/
-void ILAPIENTRY ilResetMemory()  // Deprecated
+// Returns IL_TRUE if context holds memory that the caller asked for: images it
+//  generated, formats it registered, strings it set or data it pushed.
+static ILboolean iHoldsAllocations(ILcontext* context)
+{
+	ILcontext::Impl *impl = context->impl;
+	IL_STATES *States;
+	ILuint i;
+
+	for (i = 2; i < impl->StackSize; i++) {  // 0 and 1 are the default and temporary images.
+		if (impl->ImageStack[i] != NULL)
+			return IL_TRUE;
+	}
+	if (impl->LoadProcs != NULL || impl->SaveProcs != NULL || impl->PushPng != NULL)
+		return IL_TRUE;
+
+	for (i = 0; i <= impl->ilCurrentPos; i++) {
+		States = &impl->ilStates[i];
+		if (States->ilTgaId || States->ilTgaAuthName || States->ilTgaAuthComment ||
+			States->ilPngAuthName || States->ilPngTitle || States->ilPngDescription ||
+			States->ilTifDescription || States->ilTifHostComputer || States->ilTifDocumentName ||
+			States->ilTifAuthName || States->ilCHeader)
+			return IL_TRUE;
+	}
+
+	return IL_FALSE;
+}
+
+
+// Each context has its own pair, so memory must be freed through the context
+//  that allocated it.  The pair can only be changed before the context holds
+//  anything of the caller's (see iHoldsAllocations); otherwise this fails with
+//  IL_ILLEGAL_OPERATION.  The default images are freed with the old pair and
+//  allocated again with the new one.
+void ILAPIENTRY ilSetMemory(ILcontext* context, mAlloc AllocFunc, mFree FreeFunc)
 {
-	ialloc_ptr = DefaultAllocFunc;
-	ifree_ptr = DefaultFreeFunc;
+	ILboolean Restart = context->impl->ImageStack != NULL;
+
+	if (iHoldsAllocations(context)) {
+		ilSetError(context, IL_ILLEGAL_OPERATION);
+		return;
+	}
+
+	if (Restart)
+		iFreeImageStack(context);
+
+	context->impl->ialloc_ptr = AllocFunc == NULL ? DefaultAllocFunc : AllocFunc;
+	context->impl->ifree_ptr = FreeFunc == NULL ? DefaultFreeFunc : FreeFunc;
+
+	if (Restart) {
+		iSetImage0(context);
+		iBindImageTemp(context);
+	}
 }
 
-void ILAPIENTRY ilSetMemory(mAlloc AllocFunc, mFree FreeFunc)
+void ILAPIENTRY ilResetMemory(ILcontext* context)  // Deprecated
 {
-	ialloc_ptr = AllocFunc == NULL ? DefaultAllocFunc : AllocFunc;
-	ifree_ptr = FreeFunc == NULL ? DefaultFreeFunc : FreeFunc;
+	ilSetMemory(context, NULL, NULL);
 }
 
 
@@ -0,0 +1,278 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/src/il_batch.cpp
+//
+// Description: Loads and saves lists of images on several threads
+//
+//-----------------------------------------------------------------------------
+
+#include "il_internal.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+// Creates the context that one worker thread decodes and encodes with.  It
+//  starts from the caller's current states, hints, file functions and
+//  allocator, so that the batch behaves like the same calls made one after
+//  another.  Returns NULL if the context could not be created.
+static ILcontext* iNewWorkerContext(ILcontext* context)
+{
+	ILcontext::Impl *Src = context->impl;
+	ILcontext *Worker = ilInit();
+
+	if (Worker == NULL)
+		return NULL;
+	ilSetMemory(Worker, Src->ialloc_ptr, Src->ifree_ptr);  // Saved items are freed by the caller.
+	if (Worker->impl->ImageStack == NULL) {  // The default images could not be allocated.
+		ilShutDown(Worker);
+		return NULL;
+	}
+	Worker->impl->ilHints = Src->ilHints;
+	Worker->impl->ilStates[0] = Src->ilStates[Src->ilCurrentPos];
+	iCopyStateStrings(Worker, &Worker->impl->ilStates[0]);  // The caller keeps its own.
+	ilSetRead(Worker, Src->iopenr, Src->icloser, Src->EofProc, Src->GetcProc,
+		Src->ReadProc, Src->SeekRProc, Src->TellRProc);
+	ilSetWrite(Worker, Src->iopenw, Src->iclosew, Src->PutcProc,
+		Src->SeekWProc, Src->TellWProc, Src->WriteProc);
+
+	return Worker;
+}
+
+
+// Returns the most recent error of a worker and empties its error stack, so
+//  that each item only reports its own failure.
+static ILenum iTakeError(ILcontext* Worker)
+{
+	ILenum Error = IL_UNKNOWN_ERROR;
+
+	if (Worker->impl->ilErrorPlace >= 0)
+		Error = Worker->impl->ilErrorNum[Worker->impl->ilErrorPlace];
+	Worker->impl->ilErrorPlace = -1;
+
+	return Error;
+}
+
+
+// Runs Work(Worker, Index) for every Index below Num.  Worker is NULL if the
+//  thread's context could not be created, and Work fails the item then.  The
+//  calling thread takes part, so NumThreads - 1 threads are started.  Items are handed out
+//  one at a time from a shared counter, which keeps every thread busy when
+//  the items take very different amounts of time.
+template <typename Func>
+static void iRunBatch(ILcontext* context, ILuint Num, ILuint NumThreads, Func Work)
+{
+	std::atomic<ILuint>			NextItem(0);
+	std::vector<std::thread>	Threads;
+	ILuint						i;
+
+	auto Run = [&]() {
+		ILcontext	*Worker = iNewWorkerContext(context);
+		ILuint		Item;
+
+		while ((Item = NextItem++) < Num)
+			Work(Worker, Item);
+		if (Worker != NULL)
+			ilShutDown(Worker);
+	};
+
+	if (NumThreads == 0)
+		NumThreads = std::thread::hardware_concurrency();
+	if (NumThreads > Num)
+		NumThreads = Num;
+
+	for (i = 1; i < NumThreads; i++) {
+		try {
+			Threads.emplace_back(Run);
+		}
+		catch (...) {
+			break;  // The threads already started (and this one) do the rest.
+		}
+	}
+
+	Run();
+	for (i = 0; i < Threads.size(); i++)
+		Threads[i].join();
+
+	return;
+}
+
+
+// Copies an image along with its mipmaps, faces, layers and following images.
+static ILimage* iCopyImageChain(ILcontext* context, ILimage *Src)
+{
+	ILimage *Dest = ilCopyImage_(context, Src);
+
+	if (Dest == NULL)
+		return NULL;
+
+	if ((Src->Mipmaps && (Dest->Mipmaps = iCopyImageChain(context, Src->Mipmaps)) == NULL) ||
+		(Src->Faces && (Dest->Faces = iCopyImageChain(context, Src->Faces)) == NULL) ||
+		(Src->Layers && (Dest->Layers = iCopyImageChain(context, Src->Layers)) == NULL) ||
+		(Src->Next && (Dest->Next = iCopyImageChain(context, Src->Next)) == NULL)) {
+		ilCloseImage(context, Dest);
+		return NULL;
+	}
+
+	return Dest;
+}
+
+
+//! Loads Num images from files or lumps, spreading the decoding over several threads.
+/*! Each thread works in a context of its own, created with the current states,
+	hints and file functions of context.  Formats registered with ilRegisterLoad
+	are not used.
+	\param Items The images to load.  For each item, FileName is loaded if it is not
+		NULL, otherwise the Size bytes at Lump.  Type may be IL_TYPE_UNKNOWN.  On
+		return, Image holds the name of the new image in context (or 0) and Error
+		holds IL_NO_ERROR or the reason the item failed.
+	\param DestFormat Format to convert the loaded images to, or 0 to keep the decoded one.
+	\param DestType Type to convert the loaded images to, or 0 to keep the decoded one.
+	\param NumThreads Number of threads to use, or 0 for one per processor.
+	\return The number of images that were loaded.  The currently bound image does not change.*/
+ILuint ILAPIENTRY ilLoadBatch(ILcontext* context, ILbatchitem *Items, ILuint Num, ILenum DestFormat, ILenum DestType, ILuint NumThreads)
+{
+	std::vector<ILimage*>	Loaded;
+	ILuint					i, NumLoaded = 0;
+
+	if (Items == NULL || Num == 0) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return 0;
+	}
+
+	Loaded.resize(Num, NULL);
+
+	iRunBatch(context, Num, NumThreads, [&](ILcontext *Worker, ILuint Index) {
+		ILbatchitem	*Item = &Items[Index];
+		ILuint		Name = 2;  // First name after the default and temporary images
+		ILboolean	Success;
+		ILimage		*Image;
+
+		if (Worker == NULL) {
+			Item->Error = IL_OUT_OF_MEMORY;
+			return;
+		}
+		if (Item->FileName == NULL && Item->Size > 0xFFFFFFFF) {  // More than ilLoadL can take
+			Item->Error = IL_INVALID_PARAM;
+			return;
+		}
+
+		ilBindImage(Worker, Name);
+		if (Item->FileName != NULL)
+			Success = ilLoad(Worker, Item->Type, Item->FileName);
+		else
+			Success = ilLoadL(Worker, Item->Type, Item->Lump, (ILuint)Item->Size);
+
+		Image = Worker->impl->ImageStack[Name];
+		if (Success && (DestFormat != 0 || DestType != 0)) {
+			Success = ilConvertImage(Worker, DestFormat != 0 ? DestFormat : Image->Format,
+				DestType != 0 ? DestType : Image->Type);
+			Image = Worker->impl->ImageStack[Name];
+		}
+
+		if (!Success) {
+			Item->Error = iTakeError(Worker);
+			return;
+		}
+
+		// Take the image out of the worker's stack; the next item gets a new one.
+		ilBindImage(Worker, 0);
+		Worker->impl->ImageStack[Name] = NULL;
+		Loaded[Index] = Image;
+		Item->Error = IL_NO_ERROR;
+	});
+
+	// Names are given out here, on the calling thread and in item order.
+	for (i = 0; i < Num; i++) {
+		Items[i].Image = 0;
+		if (Loaded[i] == NULL)
+			continue;
+
+		ilGenImages(context, 1, &Items[i].Image);
+		if (Items[i].Image == 0) {
+			ilCloseImage(context, Loaded[i]);
+			Items[i].Error = IL_OUT_OF_MEMORY;
+			continue;
+		}
+		ilCloseImage(context, context->impl->ImageStack[Items[i].Image]);
+		context->impl->ImageStack[Items[i].Image] = Loaded[i];
+		NumLoaded++;
+	}
+
+	return NumLoaded;
+}
+
+
+//! Saves Num images to files or memory, spreading the encoding over several threads.
+/*! Each thread encodes a copy of its image in a context of its own, created with the
+	current states, hints and file functions of context.  Formats registered with
+	ilRegisterSave are not used.
+	\param Items The images to save.  Image names the image in context and Type the
+		file type.  The image is saved to FileName if it is not NULL, otherwise to a
+		buffer returned in Data and Size, which comes from the allocator of context
+		(free it with ifree(context, ...)).  Error receives IL_NO_ERROR or the reason
+		the item failed.
+	\param NumThreads Number of threads to use, or 0 for one per processor.
+	\return The number of images that were saved.*/
+ILuint ILAPIENTRY ilSaveBatch(ILcontext* context, ILbatchitem *Items, ILuint Num, ILuint NumThreads)
+{
+	std::atomic<ILuint>	NumSaved(0);
+	ILuint				i;
+
+	if (Items == NULL || Num == 0) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return 0;
+	}
+
+	for (i = 0; i < Num; i++) {
+		if (Items[i].FileName == NULL) {
+			Items[i].Data = NULL;
+			Items[i].Size = 0;
+		}
+		Items[i].Error = ilIsImage(context, Items[i].Image) ? IL_NO_ERROR : IL_INVALID_VALUE;
+	}
+
+	iRunBatch(context, Num, NumThreads, [&](ILcontext *Worker, ILuint Index) {
+		ILbatchitem	*Item = &Items[Index];
+		ILuint		Name = 2;
+		ILboolean	Success;
+		ILimage		*Copy;
+
+		if (Item->Error != IL_NO_ERROR)
+			return;
+		if (Worker == NULL) {
+			Item->Error = IL_OUT_OF_MEMORY;
+			return;
+		}
+
+		// Savers may change the image while they work (DDS swaps in flipped data,
+		//  for instance), and an image can be listed more than once.
+		Copy = iCopyImageChain(Worker, context->impl->ImageStack[Item->Image]);
+		if (Copy == NULL) {
+			Item->Error = iTakeError(Worker);
+			return;
+		}
+		ilBindImage(Worker, Name);
+		ilReplaceCurImage(Worker, Copy);
+
+		if (Item->FileName != NULL)
+			Success = ilSave(Worker, Item->Type, Item->FileName);
+		else {
+			Item->Data = ilSaveToMemory(Worker, Item->Type, &Item->Size);
+			Success = Item->Data != NULL;
+		}
+
+		if (!Success) {
+			Item->Error = iTakeError(Worker);
+			return;
+		}
+		NumSaved++;
+	});
+
+	return NumSaved;
+}
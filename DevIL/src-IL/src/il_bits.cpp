@@ -55,7 +55,7 @@ BITFILE *bfile(ILcontext* context, ILHANDLE File)
 
 
 // Closes an open BITFILE and frees memory for it.
-ILint bclose(BITFILE *BitFile)
+ILint bclose(ILcontext* context, BITFILE *BitFile)
 {
 	if (BitFile == NULL || BitFile->File == NULL)
 		return IL_EOF;
@@ -63,7 +63,7 @@ ILint bclose(BITFILE *BitFile)
 	// Removed 01-26-2008.  The file will get closed later by
 	//  the calling function.
 	//context->impl->icloser(BitFile->File);
-	ifree(BitFile);
+	ifree(context, BitFile);
 
 	return 0;
 }
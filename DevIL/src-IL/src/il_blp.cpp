@@ -311,15 +311,15 @@ ILboolean BlpHandler::loadInternal()
 
 					// Read in the palette.
 					if (context->impl->iread(context, Palette, 1, 1024) != 1024) {
-						ifree(Palette);
+						ifree(context, Palette);
 						return IL_FALSE;
 					}
 
 					// We only allocate this once and reuse this buffer with every mipmap (since successive ones are smaller).
 					DataAndAlpha = (ILubyte*)ialloc(context, Image->Width * Image->Height);
 					if (DataAndAlpha == NULL) {
-						ifree(DataAndAlpha);
-						ifree(Palette);
+						ifree(context, DataAndAlpha);
+						ifree(context, Palette);
 						return IL_FALSE;
 					}
 				}
@@ -347,8 +347,8 @@ ILboolean BlpHandler::loadInternal()
 				// Seek to the data and read it.
 				context->impl->iseek(context, Header.MipOffsets[Mip], IL_SEEK_SET);
 				if (context->impl->iread(context, DataAndAlpha, Image->Width * Image->Height, 1) != 1) {
-					ifree(DataAndAlpha);
-					ifree(Palette);
+					ifree(context, DataAndAlpha);
+					ifree(context, Palette);
 					return IL_FALSE;
 				}
 
@@ -361,8 +361,8 @@ ILboolean BlpHandler::loadInternal()
 
 				// Read in the alpha list.
 				if (context->impl->iread(context, DataAndAlpha, AlphaSize, 1) != 1) {
-					ifree(DataAndAlpha);
-					ifree(Palette);
+					ifree(context, DataAndAlpha);
+					ifree(context, Palette);
 					return IL_FALSE;
 				}
 
@@ -392,8 +392,8 @@ ILboolean BlpHandler::loadInternal()
 		}
 
 		// Done, so we can finally free these two.
-		ifree(DataAndAlpha);
-		ifree(Palette);
+		ifree(context, DataAndAlpha);
+		ifree(context, Palette);
 
 		break;
 
@@ -435,7 +435,7 @@ ILboolean BlpHandler::loadInternal()
 			// Read in the compressed mipmap data.
 			context->impl->iseek(context, Header.MipOffsets[Mip], IL_SEEK_SET);
 			if (context->impl->iread(context, CompData, 1, Header.MipLengths[Mip]) != Header.MipLengths[Mip]) {
-				ifree(CompData);
+				ifree(context, CompData);
 				return IL_FALSE;
 			}
 
@@ -448,11 +448,11 @@ ILboolean BlpHandler::loadInternal()
 				CompSize = ((Image->Width + 3) / 4) * ((Image->Height + 3) / 4) * 8;
 				if (CompSize != Header.MipLengths[Mip]) {
 					ilSetError(context, IL_INVALID_FILE_HEADER);
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 				if (!DecompressDXT1(Image, CompData)) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 				break;
@@ -462,7 +462,7 @@ ILboolean BlpHandler::loadInternal()
 				//  DecompressDXT3/5 do not crash.
 				CompSize = ((Image->Width + 3) / 4) * ((Image->Height + 3) / 4) * 16;
 				if (CompSize != Header.MipLengths[Mip]) {
-					ifree(CompData);
+					ifree(context, CompData);
 					ilSetError(context, IL_INVALID_FILE_HEADER);
 					return IL_FALSE;
 				}
@@ -472,14 +472,14 @@ ILboolean BlpHandler::loadInternal()
 				case 1:  //  these refer to
 				case 8:  //  DXT3...
 					if (!DecompressDXT3(Image, CompData)) {
-						ifree(CompData);
+						ifree(context, CompData);
 						return IL_FALSE;
 					}
 					break;
 
 				case 7:  // DXT5 compression
 					if (!DecompressDXT5(Image, CompData)) {
-						ifree(CompData);
+						ifree(context, CompData);
 						return IL_FALSE;
 					}
 					break;
@@ -490,7 +490,7 @@ ILboolean BlpHandler::loadInternal()
 				//default:  // Should already be checked by iCheckBlp2.
 			}
 			//@TODO: Save DXTC data.
-			ifree(CompData);
+			ifree(context, CompData);
 		}
 		break;
 		//default:
@@ -579,7 +579,7 @@ ILboolean iLoadBlp1(ILcontext* context)
 				return IL_FALSE;
 			// Read the shared Jpeg header.
 			if (context->impl->iread(context, JpegHeader, 1, JpegHeaderSize) != JpegHeaderSize) {
-				ifree(JpegHeader);
+				ifree(context, JpegHeader);
 				return IL_FALSE;
 			}
 
@@ -588,7 +588,7 @@ ILboolean iLoadBlp1(ILcontext* context)
 			context->impl->iseek(context, Header.MipOffsets[i], IL_SEEK_SET);
 			JpegData = (ILubyte*)ialloc(context, JpegHeaderSize + Header.MipLengths[i]);
 			if (JpegData == NULL) {
-				ifree(JpegHeader);
+				ifree(context, JpegHeader);
 				return IL_FALSE;
 			}
 			memcpy(JpegData, JpegHeader, JpegHeaderSize);
@@ -607,9 +607,9 @@ ILboolean iLoadBlp1(ILcontext* context)
 			if (Image->Format == IL_RGB)
 				Image->Format = IL_BGR;
 
-			ifree(JpegData);
+			ifree(context, JpegData);
 			//}
-			ifree(JpegHeader);
+			ifree(context, JpegHeader);
 		}
 #endif//IL_NO_JPG
 		break;
@@ -678,21 +678,21 @@ ILboolean iLoadBlp1(ILcontext* context)
 			DataAndAlpha = (ILubyte*)ialloc(context, Header.Width * Header.Height);
 			Palette = (ILubyte*)ialloc(context, 256 * 4);
 			if (DataAndAlpha == NULL || Palette == NULL) {
-				ifree(DataAndAlpha);
-				ifree(Palette);
+				ifree(context, DataAndAlpha);
+				ifree(context, Palette);
 				return IL_FALSE;
 			}
 
 			// Read in the data and the palette.
 			if (context->impl->iread(context, Palette, 1, 1024) != 1024) {
-				ifree(Palette);
+				ifree(context, Palette);
 				return IL_FALSE;
 			}
 			// Seek to the data and read it.
 			context->impl->iseek(context, Header.MipOffsets[i], IL_SEEK_SET);
 			if (context->impl->iread(context, DataAndAlpha, Header.Width * Header.Height, 1) != 1) {
-				ifree(DataAndAlpha);
-				ifree(Palette);
+				ifree(context, DataAndAlpha);
+				ifree(context, Palette);
 				return IL_FALSE;
 			}
 
@@ -705,8 +705,8 @@ ILboolean iLoadBlp1(ILcontext* context)
 
 			// Read in the alpha list.
 			if (context->impl->iread(context, DataAndAlpha, Header.Width * Header.Height, 1) != 1) {
-				ifree(DataAndAlpha);
-				ifree(Palette);
+				ifree(context, DataAndAlpha);
+				ifree(context, Palette);
 				return IL_FALSE;
 			}
 			// Finally put the alpha data into the image data.
@@ -714,8 +714,8 @@ ILboolean iLoadBlp1(ILcontext* context)
 				Image->Data[i * 4 + 3] = DataAndAlpha[i];
 			}
 
-			ifree(DataAndAlpha);
-			ifree(Palette);
+			ifree(context, DataAndAlpha);
+			ifree(context, Palette);
 			break;
 		}
 		break;
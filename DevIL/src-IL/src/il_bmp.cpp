@@ -292,6 +292,106 @@ ILboolean BmpHandler::loadInternal()
 	return bBitmap;
 }
 
+//! Reads an already-opened .bmp file and gives its rows to Sink (ilLoadRows)
+ILboolean BmpHandler::loadRowsF(ILHANDLE File, iRowSink *Sink)
+{
+	ILuint		FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = loadRowsInternal(Sink);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+//! Reads a .bmp in a memory "lump" and gives its rows to Sink (ilLoadRows)
+ILboolean BmpHandler::loadRowsL(const void *Lump, ILuint Size, iRowSink *Sink)
+{
+	iSetInputLump(context, Lump, Size);
+	return loadRowsInternal(Sink);
+}
+
+// Uncompressed 8, 24 and 32-bit bitmaps are read a band at a time, as BGR
+//	like loadInternal makes them (8-bit ones through their palette).  The
+//	stored rows of a band are next to each other in either order, so a
+//	bottom-up file is read band by band from the top of the picture and each
+//	band is filled from its last row.  Other bitmaps are left to ilLoad.
+ILboolean BmpHandler::loadRowsInternal(iRowSink *Sink)
+{
+	BMPHEAD		Header;
+	ILubyte		Palette[256 * 4], *Line, *Rows, *Dest;
+	ILuint		Width, Height, FileBps, PalSize = 0, NumRows, y, i, x;
+	ILboolean	BottomUp;
+
+	iGetBmpHead(context, &Header);
+	if (!check(&Header) || Header.biPlanes != 1 || Header.biCompression != 0
+		|| (Header.biBitCount != 8 && Header.biBitCount != 24 && Header.biBitCount != 32)) {
+		Sink->Whole = IL_TRUE;
+		return IL_FALSE;
+	}
+
+	Width = Header.biWidth;
+	Height = abs(Header.biHeight);
+	BottomUp = Header.biHeight > 0;
+	FileBps = (Width * Header.biBitCount + 31) / 32 * 4;
+
+	if (Header.biBitCount == 8) {
+		PalSize = Header.biClrUsed ? Header.biClrUsed * 4 : 256 * 4;
+		if (PalSize > sizeof(Palette)) {
+			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
+			return IL_FALSE;
+		}
+		imemclear(Palette, sizeof(Palette));
+		context->impl->iseek(context, sizeof(BMPHEAD), IL_SEEK_SET);
+		if (context->impl->iread(context, Palette, 1, PalSize) != PalSize)
+			return IL_FALSE;
+	}
+
+	if (!iSinkBegin(context, Sink, Width, Height, IL_BGR, IL_UNSIGNED_BYTE))
+		return IL_FALSE;
+	Line = (ILubyte*)ialloc(context, FileBps);
+	if (Line == NULL)
+		return IL_FALSE;
+
+	for (y = 0; y < Height; y += NumRows) {
+		NumRows = IL_MIN(Sink->BandRows, Height - y);
+		Rows = iSinkRows(context, Sink, NumRows);
+		if (Rows == NULL) {
+			ifree(context, Line);
+			return IL_FALSE;
+		}
+
+		context->impl->iseek(context, Header.bfDataOff + (ILint64)(BottomUp ? Height - y - NumRows : y) * FileBps, IL_SEEK_SET);
+		for (i = 0; i < NumRows; i++) {
+			if (context->impl->iread(context, Line, 1, FileBps) != FileBps) {
+				ifree(context, Line);
+				return IL_FALSE;
+			}
+
+			Dest = Rows + (ILsizei)(BottomUp ? NumRows - 1 - i : i) * Sink->Bps;
+			switch (Header.biBitCount)
+			{
+				case 8:
+					for (x = 0; x < Width; x++)
+						memcpy(Dest + x * 3, Palette + Line[x] * 4, 3);
+					break;
+				case 24:
+					memcpy(Dest, Line, Sink->Bps);
+					break;
+				case 32:
+					for (x = 0; x < Width; x++)
+						memcpy(Dest + x * 3, Line + x * 4, 3);
+					break;
+			}
+		}
+	}
+
+	ifree(context, Line);
+	return IL_TRUE;
+}
+
 // Reads an uncompressed .bmp
 //	One of the absolute ugliest functions I've ever written!
 ILboolean ilReadUncompBmp(ILcontext* context, BMPHEAD * Header)
@@ -302,6 +402,9 @@ ILboolean ilReadUncompBmp(ILcontext* context, BMPHEAD * Header)
 	ILuint rShiftR, gShiftR, bShiftR; //required for bitfields packing
 	ILuint rShiftL, gShiftL, bShiftL; //required for bitfields packing
 	ILushort Read16; //used for 16bit bmp loading
+	ILuint Width = Header->biWidth, Height = abs(Header->biHeight);
+	ILuint FileBps = (Header->biWidth * Header->biBitCount + 31) / 32 * 4, FirstRow = 0;
+	ILboolean Region = IL_FALSE;
 
 	if (Header->biBitCount < 8)
 		Bpp = 1;  // We can't have an integral number less than one and greater than 0
@@ -311,8 +414,19 @@ ILboolean ilReadUncompBmp(ILcontext* context, BMPHEAD * Header)
 	if (Bpp == 2 || Bpp == 4)
 		Bpp = 3;
 
+	// Only the rows of an ilLoadRegion rectangle are read.  1 and 4-bit
+	//	images are cropped after loading instead.
+	if (Header->biBitCount >= 8 && Header->biHeight != 0 && iRegionActive(context)) {
+		if (!iRegionClaim(context, Width, Height))
+			return IL_FALSE;
+		FirstRow = iRegionFirstRow(context, Height, Header->biHeight > 0);
+		Width = context->impl->RegionW;
+		Height = context->impl->RegionH;
+		Region = IL_TRUE;
+	}
+
 	// Update the current image with the new dimensions
-	if (!ilTexImage(context, Header->biWidth, abs(Header->biHeight), 1, Bpp, 0, IL_UNSIGNED_BYTE, NULL)) {
+	if (!ilTexImage(context, Width, Height, 1, Bpp, 0, IL_UNSIGNED_BYTE, NULL)) {
 		return IL_FALSE;
 	}
 	context->impl->iCurImage->Origin = IL_ORIGIN_LOWER_LEFT;
@@ -362,7 +476,7 @@ ILboolean ilReadUncompBmp(ILcontext* context, BMPHEAD * Header)
 	if (Header->biHeight == 0) {
 		ilSetError(context, IL_ILLEGAL_FILE_VALUE);
 		if (context->impl->iCurImage->Pal.Palette)
-			ifree(context->impl->iCurImage->Pal.Palette);
+			ifree(context, context->impl->iCurImage->Pal.Palette);
 		return IL_FALSE;
 	}
 
@@ -472,7 +586,9 @@ ILboolean ilReadUncompBmp(ILcontext* context, BMPHEAD * Header)
 		k = 0;
 
 		//changed 2003-09-01
-		if (iGetHint(context, IL_MEM_SPEED_HINT) == IL_FASTEST)
+		if (Region)
+			context->impl->iseek(context, FirstRow * FileBps + context->impl->RegionX * 2, IL_SEEK_CUR);
+		else if (iGetHint(context, IL_MEM_SPEED_HINT) == IL_FASTEST)
 			iPreCache(context, context->impl->iCurImage->Width * context->impl->iCurImage->Height);
 
 		//@TODO: This may not be safe for Big Endian.
@@ -486,7 +602,10 @@ ILboolean ilReadUncompBmp(ILcontext* context, BMPHEAD * Header)
 				context->impl->iCurImage->Data[k + 1] = ((Read16 & gMask) >> gShiftR) << gShiftL;
 				context->impl->iCurImage->Data[k + 2] = ((Read16 & rMask) >> rShiftR) << rShiftL;
 			}
-			context->impl->iread(context, Padding, 1, PadSize);
+			if (Region)  // to the region in the next row
+				context->impl->iseek(context, FileBps - Width * 2, IL_SEEK_CUR);
+			else
+				context->impl->iread(context, Padding, 1, PadSize);
 		}
 
 		iUnCache(context);
@@ -494,6 +613,12 @@ ILboolean ilReadUncompBmp(ILcontext* context, BMPHEAD * Header)
 
 	case 8:
 	case 24:
+		if (Region) {
+			if (!iRegionReadRows(context, context->impl->iCurImage, FileBps, context->impl->RegionX, FirstRow))
+				return IL_FALSE;
+			break;
+		}
+
 		// For 8 and 24 bit, Bps is equal to the bmps bps
 		PadSize = (4 - (context->impl->iCurImage->Bps % 4)) % 4;
 		if (PadSize == 0) {
@@ -549,10 +674,14 @@ ILboolean ilReadUncompBmp(ILcontext* context, BMPHEAD * Header)
 		//load to rgba????
 
 		//changed 2003-09-01
-		if (iGetHint(context, IL_MEM_SPEED_HINT) == IL_FASTEST)
+		if (Region)
+			context->impl->iseek(context, FirstRow * FileBps + context->impl->RegionX * 4, IL_SEEK_CUR);
+		else if (iGetHint(context, IL_MEM_SPEED_HINT) == IL_FASTEST)
 			iPreCache(context, context->impl->iCurImage->Width * context->impl->iCurImage->Height);
 
 		for (i = 0; i < context->impl->iCurImage->SizeOfData; i += 3) {
+			if (Region && i > 0 && i % context->impl->iCurImage->Bps == 0)  // to the region in the next row
+				context->impl->iseek(context, FileBps - Width * 4, IL_SEEK_CUR);
 			if (context->impl->iread(context, &Read, 4, 1) != 1) {
 				iUnCache(context);
 				return IL_FALSE;
@@ -913,6 +1042,17 @@ ILuint BmpHandler::saveL(void *Lump, ILuint Size)
 	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
 }
 
+//! Writes an image given as rows (ilSaveRows) to an already-opened file
+ILuint BmpHandler::saveRowsF(ILHANDLE File, iRowSource *Src)
+{
+	ILuint Pos;
+	iSetOutputFile(context, File);
+	Pos = context->impl->itellw(context);
+	if (saveRowsInternal(Src) == IL_FALSE)
+		return 0;  // Error occurred
+	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+}
+
 // Internal function used to save the .bmp.
 ILboolean BmpHandler::saveInternal()
 {
@@ -942,7 +1082,7 @@ ILboolean BmpHandler::saveInternal()
 		TempPal = iConvertPal(context, &TempImage->Pal, IL_PAL_BGR32);
 		if (TempPal == NULL)
 		{
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	}
@@ -991,7 +1131,7 @@ ILboolean BmpHandler::saveInternal()
 	if (TempImage->Origin != IL_ORIGIN_LOWER_LEFT) {
 		TempData = iGetFlipped(context, TempImage);
 		if (TempData == NULL) {
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	}
@@ -1060,17 +1200,72 @@ ILboolean BmpHandler::saveInternal()
 	SaveLittleUInt(context, FileSize);
 
 	if (TempPal != &context->impl->iCurImage->Pal) {
-		ifree(TempPal->Palette);
-		ifree(TempPal);
+		ifree(context, TempPal->Palette);
+		ifree(context, TempPal);
 	}
 	if (TempData != TempImage->Data)
-		ifree(TempData);
+		ifree(context, TempData);
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	context->impl->iseekw(context, FileSize, IL_SEEK_SET);
 
 	return IL_TRUE;
 }
 
+// Writes the rows top-down, as they arrive, by giving a negative height.
+//	The file size is known up front, so nothing is patched afterwards.  Rows
+//	with alpha are written as 32-bit BGRA, the rest as 24-bit BGR.
+ILboolean BmpHandler::saveRowsInternal(iRowSource *Src)
+{
+	ILenum	Format;
+	ILuint	PadSize, Padding = 0, y;
+	ILubyte	*Row;
+
+	switch (Src->Format)
+	{
+		case IL_RGBA:
+		case IL_BGRA:
+		case IL_LUMINANCE_ALPHA:
+			Format = IL_BGRA;
+			break;
+		default:
+			Format = IL_BGR;
+			break;
+	}
+	if (!iRowsBegin(context, Src, Format, IL_UNSIGNED_BYTE))
+		return IL_FALSE;
+	PadSize = (4 - (Src->DestBps % 4)) % 4;
+
+	context->impl->iputc(context, 'B');
+	context->impl->iputc(context, 'M');
+	SaveLittleUInt(context, 54 + (Src->DestBps + PadSize) * Src->Height);  // File size
+	SaveLittleUInt(context, 0);  // Reserved
+	SaveLittleUInt(context, 54);  // Offset of the data
+
+	SaveLittleUInt(context, 0x28);  // Header size
+	SaveLittleUInt(context, Src->Width);
+	SaveLittleInt(context, -(ILint)Src->Height);
+	SaveLittleUShort(context, 1);  // Number of planes
+	SaveLittleUShort(context, (ILushort)(ilGetBppFormat(Format) << 3));  // Bpp
+	SaveLittleInt(context, 0);  // No compression
+	SaveLittleInt(context, 0);  // Size of image (Obsolete)
+	SaveLittleInt(context, 0);  // (Obsolete)
+	SaveLittleInt(context, 0);  // (Obsolete)
+	SaveLittleInt(context, 0);  // Num colours used
+	SaveLittleInt(context, 0);  // Important colour (none)
+
+	for (y = 0; y < Src->Height; y++) {
+		Row = iRowsNext(context, Src);
+		if (Row == NULL)
+			return IL_FALSE;
+		if (context->impl->iwrite(context, Row, 1, Src->DestBps) != (ILint)Src->DestBps)
+			return IL_FALSE;
+		if (PadSize)
+			context->impl->iwrite(context, &Padding, 1, PadSize);
+	}
+
+	return IL_TRUE;
+}
+
 #endif//IL_NO_BMP
\ No newline at end of file
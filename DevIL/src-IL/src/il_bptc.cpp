@@ -0,0 +1,1513 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/src/il_bptc.cpp
+//
+// Description: Decodes and encodes BC6H and BC7 (BPTC) compressed blocks
+//
+//-----------------------------------------------------------------------------
+
+//
+// Both formats are described in the Direct3D 11 functional specification
+//	and in the ARB_texture_compression_bptc extension.  A block is 16 bytes
+//	and holds 4x4 pixels.  The first few bits choose a mode, which says how
+//	the pixels are split into subsets, how many bits each endpoint and index
+//	has and in which order the bits are stored.
+//
+
+#include "il_internal.h"
+#include "il_dds.h"
+#include "il_threads.h"
+#include <limits.h>
+
+
+// The 128 bits of a block, read from the least significant end
+typedef struct iBptcBits
+{
+	ILuint64	Lo, Hi;
+	ILuint		Pos;
+} iBptcBits;
+
+static void iBptcInitBits(iBptcBits *Bits, const ILubyte *Block)
+{
+	ILuint i;
+
+	Bits->Lo = Bits->Hi = 0;
+	for (i = 0; i < 8; i++) {
+		Bits->Lo |= (ILuint64)Block[i] << (i * 8);
+		Bits->Hi |= (ILuint64)Block[i + 8] << (i * 8);
+	}
+	Bits->Pos = 0;
+}
+
+static inline ILuint iBptcRead(iBptcBits *Bits, ILuint Num)
+{
+	ILuint64 Value;
+
+	if (Num == 0)
+		return 0;
+	if (Bits->Pos >= 64)
+		Value = Bits->Hi >> (Bits->Pos - 64);
+	else if (Bits->Pos + Num <= 64)
+		Value = Bits->Lo >> Bits->Pos;
+	else
+		Value = (Bits->Lo >> Bits->Pos) | (Bits->Hi << (64 - Bits->Pos));
+	Bits->Pos += Num;
+
+	return (ILuint)(Value & ((1u << Num) - 1));
+}
+
+
+// Subset of each pixel for the 64 two-subset partitions, one bit per pixel
+static const ILushort BptcPartition2[64] = {
+	0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+	0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+	0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+	0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+	0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+	0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+	0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+	0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+};
+
+// Subset of each pixel for the 64 three-subset partitions (BC7 only)
+static const ILubyte BptcPartition3[64][16] = {
+	{0,0,1,1,0,0,1,1,0,2,2,1,2,2,2,2}, {0,0,0,1,0,0,1,1,2,2,1,1,2,2,2,1},
+	{0,0,0,0,2,0,0,1,2,2,1,1,2,2,1,1}, {0,2,2,2,0,0,2,2,0,0,1,1,0,1,1,1},
+	{0,0,0,0,0,0,0,0,1,1,2,2,1,1,2,2}, {0,0,1,1,0,0,1,1,0,0,2,2,0,0,2,2},
+	{0,0,2,2,0,0,2,2,1,1,1,1,1,1,1,1}, {0,0,1,1,0,0,1,1,2,2,1,1,2,2,1,1},
+	{0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2}, {0,0,0,0,1,1,1,1,1,1,1,1,2,2,2,2},
+	{0,0,0,0,1,1,1,1,2,2,2,2,2,2,2,2}, {0,0,1,2,0,0,1,2,0,0,1,2,0,0,1,2},
+	{0,1,1,2,0,1,1,2,0,1,1,2,0,1,1,2}, {0,1,2,2,0,1,2,2,0,1,2,2,0,1,2,2},
+	{0,0,1,1,0,1,1,2,1,1,2,2,1,2,2,2}, {0,0,1,1,2,0,0,1,2,2,0,0,2,2,2,0},
+	{0,0,0,1,0,0,1,1,0,1,1,2,1,1,2,2}, {0,1,1,1,0,0,1,1,2,0,0,1,2,2,0,0},
+	{0,0,0,0,1,1,2,2,1,1,2,2,1,1,2,2}, {0,0,2,2,0,0,2,2,0,0,2,2,1,1,1,1},
+	{0,1,1,1,0,1,1,1,0,2,2,2,0,2,2,2}, {0,0,0,1,0,0,0,1,2,2,2,1,2,2,2,1},
+	{0,0,0,0,0,0,1,1,0,1,2,2,0,1,2,2}, {0,0,0,0,1,1,0,0,2,2,1,0,2,2,1,0},
+	{0,1,2,2,0,1,2,2,0,0,1,1,0,0,0,0}, {0,0,1,2,0,0,1,2,1,1,2,2,2,2,2,2},
+	{0,1,1,0,1,2,2,1,1,2,2,1,0,1,1,0}, {0,0,0,0,0,1,1,0,1,2,2,1,1,2,2,1},
+	{0,0,2,2,1,1,0,2,1,1,0,2,0,0,2,2}, {0,1,1,0,0,1,1,0,2,0,0,2,2,2,2,2},
+	{0,0,1,1,0,1,2,2,0,1,2,2,0,0,1,1}, {0,0,0,0,2,0,0,0,2,2,1,1,2,2,2,1},
+	{0,0,0,0,0,0,0,2,1,1,2,2,1,2,2,2}, {0,2,2,2,0,0,2,2,0,0,1,2,0,0,1,1},
+	{0,0,1,1,0,0,1,2,0,0,2,2,0,2,2,2}, {0,1,2,0,0,1,2,0,0,1,2,0,0,1,2,0},
+	{0,0,0,0,1,1,1,1,2,2,2,2,0,0,0,0}, {0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0},
+	{0,1,2,0,2,0,1,2,1,2,0,1,0,1,2,0}, {0,0,1,1,2,2,0,0,1,1,2,2,0,0,1,1},
+	{0,0,1,1,1,1,2,2,2,2,0,0,0,0,1,1}, {0,1,0,1,0,1,0,1,2,2,2,2,2,2,2,2},
+	{0,0,0,0,0,0,0,0,2,1,2,1,2,1,2,1}, {0,0,2,2,1,1,2,2,0,0,2,2,1,1,2,2},
+	{0,0,2,2,0,0,1,1,0,0,2,2,0,0,1,1}, {0,2,2,0,1,2,2,1,0,2,2,0,1,2,2,1},
+	{0,1,0,1,2,2,2,2,2,2,2,2,0,1,0,1}, {0,0,0,0,2,1,2,1,2,1,2,1,2,1,2,1},
+	{0,1,0,1,0,1,0,1,0,1,0,1,2,2,2,2}, {0,2,2,2,0,1,1,1,0,2,2,2,0,1,1,1},
+	{0,0,0,2,1,1,1,2,0,0,0,2,1,1,1,2}, {0,0,0,0,2,1,1,2,2,1,1,2,2,1,1,2},
+	{0,2,2,2,0,1,1,1,0,1,1,1,0,2,2,2}, {0,0,0,2,1,1,1,2,1,1,1,2,0,0,0,2},
+	{0,1,1,0,0,1,1,0,0,1,1,0,2,2,2,2}, {0,0,0,0,0,0,0,0,2,1,1,2,2,1,1,2},
+	{0,1,1,0,0,1,1,0,2,2,2,2,2,2,2,2}, {0,0,2,2,0,0,1,1,0,0,1,1,0,0,2,2},
+	{0,0,2,2,1,1,2,2,1,1,2,2,0,0,2,2}, {0,0,0,0,0,0,0,0,0,0,0,0,2,1,1,2},
+	{0,0,0,2,0,0,0,1,0,0,0,2,0,0,0,1}, {0,2,2,2,1,2,2,2,0,2,2,2,1,2,2,2},
+	{0,1,0,1,2,2,2,2,2,2,2,2,2,2,2,2}, {0,1,1,1,2,0,1,1,2,2,0,1,2,2,2,0}
+};
+
+// Anchor (fix-up) pixel of the second subset of the two-subset partitions
+static const ILubyte BptcAnchor2[64] = {
+	15,15,15,15,15,15,15,15, 15,15,15,15,15,15,15,15,
+	15, 2, 8, 2, 2, 8, 8,15,  2, 8, 2, 2, 8, 8, 2, 2,
+	15,15, 6, 8, 2, 8,15,15,  2, 8, 2, 2, 2,15,15, 6,
+	 6, 2, 6, 8,15,15, 2, 2, 15,15,15,15,15, 2, 2,15
+};
+
+// Anchor pixels of the second and third subsets of the three-subset partitions
+static const ILubyte BptcAnchor3a[64] = {
+	 3, 3,15,15, 8, 3,15,15,  8, 8, 6, 6, 6, 5, 3, 3,
+	 3, 3, 8,15, 3, 3, 6,10,  5, 8, 8, 6, 8, 5,15,15,
+	 8,15, 3, 5, 6,10, 8,15, 15, 3,15, 5,15,15,15,15,
+	 3,15, 5, 5, 5, 8, 5,10,  5,10, 8,13,15,12, 3, 3
+};
+static const ILubyte BptcAnchor3b[64] = {
+	15, 8, 8, 3,15,15, 3, 8, 15,15,15,15,15,15,15, 8,
+	15, 8,15, 3,15, 8,15, 8,  3,15, 6,10,15,15,10, 8,
+	15, 3,15,10,10, 8, 9,10,  6,15, 8,15, 3, 6, 6, 8,
+	15, 3,15,15,15,15,15,15, 15,15,15,15, 3,15,15, 8
+};
+
+// Interpolation weights for 2-, 3- and 4-bit indices, out of 64
+static const ILubyte BptcWeights2[4] = { 0, 21, 43, 64 };
+static const ILubyte BptcWeights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const ILubyte BptcWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static const ILubyte *BptcWeights(ILuint IndexBits)
+{
+	return IndexBits == 2 ? BptcWeights2 : (IndexBits == 3 ? BptcWeights3 : BptcWeights4);
+}
+
+
+//
+// BC7
+//
+
+typedef struct iBc7Mode
+{
+	ILubyte	NumSubsets;
+	ILubyte	PartitionBits;
+	ILubyte	RotationBits;
+	ILubyte	IndexSelBits;
+	ILubyte	ColourBits;
+	ILubyte	AlphaBits;
+	ILubyte	EndpointPBits;   // One p-bit per endpoint
+	ILubyte	SharedPBits;     // One p-bit per subset
+	ILubyte	IndexBits;
+	ILubyte	IndexBits2;      // Second set of indices (modes 4 and 5)
+} iBc7Mode;
+
+static const iBc7Mode Bc7Modes[8] = {
+	{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+	{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+	{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+	{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+	{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+	{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+	{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+	{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+};
+
+//! Decodes one BC7 block to 16 RGBA pixels, row by row.
+void DecodeBC7Block(const ILubyte *Block, ILubyte *Out)
+{
+	const iBc7Mode	*Mode;
+	iBptcBits		Bits;
+	ILubyte			Endpoints[6][4], Subset[16], Index[16], Index2[16], Temp;
+	const ILubyte	*ColourWeights, *AlphaWeights, *ColourIndex, *AlphaIndex;
+	ILuint			ModeNum, Partition, Rotation, IndexSel, NumEndpoints;
+	ILuint			i, c, p, Bits_, Anchor1 = 0, Anchor2 = 0;
+
+	for (ModeNum = 0; ModeNum < 8; ModeNum++) {
+		if (Block[0] & (1 << ModeNum))
+			break;
+	}
+	if (ModeNum == 8) {  // Reserved: transparent black
+		memset(Out, 0, 64);
+		return;
+	}
+
+	Mode = &Bc7Modes[ModeNum];
+	iBptcInitBits(&Bits, Block);
+	Bits.Pos = ModeNum + 1;
+	Partition = iBptcRead(&Bits, Mode->PartitionBits);
+	Rotation = iBptcRead(&Bits, Mode->RotationBits);
+	IndexSel = iBptcRead(&Bits, Mode->IndexSelBits);
+
+	// All the red values come first, then green, blue and alpha.
+	NumEndpoints = Mode->NumSubsets * 2;
+	for (c = 0; c < 3; c++) {
+		for (i = 0; i < NumEndpoints; i++)
+			Endpoints[i][c] = iBptcRead(&Bits, Mode->ColourBits);
+	}
+	for (i = 0; i < NumEndpoints; i++)
+		Endpoints[i][3] = iBptcRead(&Bits, Mode->AlphaBits);
+
+	if (Mode->EndpointPBits) {
+		for (i = 0; i < NumEndpoints; i++) {
+			p = iBptcRead(&Bits, 1);
+			for (c = 0; c < 4; c++)
+				Endpoints[i][c] = (Endpoints[i][c] << 1) | p;
+		}
+	}
+	else if (Mode->SharedPBits) {
+		for (i = 0; i < NumEndpoints; i += 2) {
+			p = iBptcRead(&Bits, 1);
+			for (c = 0; c < 4; c++) {
+				Endpoints[i][c] = (Endpoints[i][c] << 1) | p;
+				Endpoints[i + 1][c] = (Endpoints[i + 1][c] << 1) | p;
+			}
+		}
+	}
+
+	// Expand to 8 bits by repeating the top bits.
+	for (c = 0; c < 4; c++) {
+		Bits_ = (c < 3 ? Mode->ColourBits : Mode->AlphaBits);
+		if (Bits_ == 0) {
+			for (i = 0; i < NumEndpoints; i++)
+				Endpoints[i][c] = 0xFF;
+			continue;
+		}
+		Bits_ += Mode->EndpointPBits | Mode->SharedPBits;
+		for (i = 0; i < NumEndpoints; i++) {
+			Endpoints[i][c] <<= 8 - Bits_;
+			Endpoints[i][c] |= Endpoints[i][c] >> Bits_;
+		}
+	}
+
+	if (Mode->NumSubsets == 2)
+		Anchor1 = BptcAnchor2[Partition];
+	else if (Mode->NumSubsets == 3) {
+		Anchor1 = BptcAnchor3a[Partition];
+		Anchor2 = BptcAnchor3b[Partition];
+	}
+	for (i = 0; i < 16; i++) {
+		if (Mode->NumSubsets == 1)
+			Subset[i] = 0;
+		else if (Mode->NumSubsets == 2)
+			Subset[i] = (BptcPartition2[Partition] >> i) & 1;
+		else
+			Subset[i] = BptcPartition3[Partition][i];
+	}
+
+	// Anchor pixels drop the top bit of their index, which is always 0.
+	for (i = 0; i < 16; i++) {
+		if (i == 0 || (Mode->NumSubsets > 1 && i == Anchor1) || (Mode->NumSubsets > 2 && i == Anchor2))
+			Index[i] = iBptcRead(&Bits, Mode->IndexBits - 1);
+		else
+			Index[i] = iBptcRead(&Bits, Mode->IndexBits);
+	}
+	if (Mode->IndexBits2) {
+		for (i = 0; i < 16; i++)
+			Index2[i] = iBptcRead(&Bits, Mode->IndexBits2 - (i == 0));
+	}
+
+	ColourIndex = AlphaIndex = Index;
+	ColourWeights = AlphaWeights = BptcWeights(Mode->IndexBits);
+	if (Mode->IndexBits2) {
+		if (IndexSel) {
+			ColourIndex = Index2;
+			ColourWeights = BptcWeights(Mode->IndexBits2);
+		}
+		else {
+			AlphaIndex = Index2;
+			AlphaWeights = BptcWeights(Mode->IndexBits2);
+		}
+	}
+
+	for (i = 0; i < 16; i++, Out += 4) {
+		const ILubyte *E0 = Endpoints[Subset[i] * 2], *E1 = Endpoints[Subset[i] * 2 + 1];
+		ILuint w = ColourWeights[ColourIndex[i]], wa = AlphaWeights[AlphaIndex[i]];
+
+		for (c = 0; c < 3; c++)
+			Out[c] = (ILubyte)(((64 - w) * E0[c] + w * E1[c] + 32) >> 6);
+		Out[3] = (ILubyte)(((64 - wa) * E0[3] + wa * E1[3] + 32) >> 6);
+
+		if (Rotation) {
+			Temp = Out[3];
+			Out[3] = Out[Rotation - 1];
+			Out[Rotation - 1] = Temp;
+		}
+	}
+
+	return;
+}
+
+
+//
+// BC6H
+//
+
+// Endpoint fields of the BC6H bit layouts: w and x are the endpoints of the
+//	first region, y and z of the second.
+enum { RW, RX, RY, RZ, GW, GX, GY, GZ, BW, BX, BY, BZ, PART, BC6_END };
+
+// A run of bits of one field, read from bit First to bit Last (which may be
+//	lower, for the runs the layout stores in reverse).
+typedef struct iBc6Run
+{
+	ILubyte	Field, First, Last;
+} iBc6Run;
+
+typedef struct iBc6Mode
+{
+	ILubyte		Code;           // Mode bits, 2 or 5 of them
+	ILubyte		NumRegions;
+	ILboolean	Transformed;    // Endpoints after the first are deltas
+	ILubyte		EndpointBits;
+	ILubyte		DeltaBits[3];
+	iBc6Run		Runs[28];
+} iBc6Mode;
+
+static const iBc6Mode Bc6Modes[14] = {
+	{ 0x00, 2, IL_TRUE, 10, { 5, 5, 5 }, {
+		{GY,4,4}, {BY,4,4}, {BZ,4,4}, {RW,0,9}, {GW,0,9}, {BW,0,9}, {RX,0,4}, {GZ,4,4},
+		{GY,0,3}, {GX,0,4}, {BZ,0,0}, {GZ,0,3}, {BX,0,4}, {BZ,1,1}, {BY,0,3}, {RY,0,4},
+		{BZ,2,2}, {RZ,0,4}, {BZ,3,3}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x01, 2, IL_TRUE, 7, { 6, 6, 6 }, {
+		{GY,5,5}, {GZ,4,5}, {RW,0,6}, {BZ,0,1}, {BY,4,4}, {GW,0,6}, {BY,5,5}, {BZ,2,2},
+		{GY,4,4}, {BW,0,6}, {BZ,3,3}, {BZ,5,5}, {BZ,4,4}, {RX,0,5}, {GY,0,3}, {GX,0,5},
+		{GZ,0,3}, {BX,0,5}, {BY,0,3}, {RY,0,5}, {RZ,0,5}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x02, 2, IL_TRUE, 11, { 5, 4, 4 }, {
+		{RW,0,9}, {GW,0,9}, {BW,0,9}, {RX,0,4}, {RW,10,10}, {GY,0,3}, {GX,0,3}, {GW,10,10},
+		{BZ,0,0}, {GZ,0,3}, {BX,0,3}, {BW,10,10}, {BZ,1,1}, {BY,0,3}, {RY,0,4}, {BZ,2,2},
+		{RZ,0,4}, {BZ,3,3}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x06, 2, IL_TRUE, 11, { 4, 5, 4 }, {
+		{RW,0,9}, {GW,0,9}, {BW,0,9}, {RX,0,3}, {RW,10,10}, {GZ,4,4}, {GY,0,3}, {GX,0,4},
+		{GW,10,10}, {GZ,0,3}, {BX,0,3}, {BW,10,10}, {BZ,1,1}, {BY,0,3}, {RY,0,3}, {BZ,0,0},
+		{BZ,2,2}, {RZ,0,3}, {GY,4,4}, {BZ,3,3}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x0A, 2, IL_TRUE, 11, { 4, 4, 5 }, {
+		{RW,0,9}, {GW,0,9}, {BW,0,9}, {RX,0,3}, {RW,10,10}, {BY,4,4}, {GY,0,3}, {GX,0,3},
+		{GW,10,10}, {BZ,0,0}, {GZ,0,3}, {BX,0,4}, {BW,10,10}, {BY,0,3}, {RY,0,3}, {BZ,1,2},
+		{RZ,0,3}, {BZ,4,4}, {BZ,3,3}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x0E, 2, IL_TRUE, 9, { 5, 5, 5 }, {
+		{RW,0,8}, {BY,4,4}, {GW,0,8}, {GY,4,4}, {BW,0,8}, {BZ,4,4}, {RX,0,4}, {GZ,4,4},
+		{GY,0,3}, {GX,0,4}, {BZ,0,0}, {GZ,0,3}, {BX,0,4}, {BZ,1,1}, {BY,0,3}, {RY,0,4},
+		{BZ,2,2}, {RZ,0,4}, {BZ,3,3}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x12, 2, IL_TRUE, 8, { 6, 5, 5 }, {
+		{RW,0,7}, {GZ,4,4}, {BY,4,4}, {GW,0,7}, {BZ,2,2}, {GY,4,4}, {BW,0,7}, {BZ,3,4},
+		{RX,0,5}, {GY,0,3}, {GX,0,4}, {BZ,0,0}, {GZ,0,3}, {BX,0,4}, {BZ,1,1}, {BY,0,3},
+		{RY,0,5}, {RZ,0,5}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x16, 2, IL_TRUE, 8, { 5, 6, 5 }, {
+		{RW,0,7}, {BZ,0,0}, {BY,4,4}, {GW,0,7}, {GY,5,5}, {GY,4,4}, {BW,0,7}, {GZ,5,5},
+		{BZ,4,4}, {RX,0,4}, {GZ,4,4}, {GY,0,3}, {GX,0,5}, {GZ,0,3}, {BX,0,4}, {BZ,1,1},
+		{BY,0,3}, {RY,0,4}, {BZ,2,2}, {RZ,0,4}, {BZ,3,3}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x1A, 2, IL_TRUE, 8, { 5, 5, 6 }, {
+		{RW,0,7}, {BZ,1,1}, {BY,4,4}, {GW,0,7}, {BY,5,5}, {GY,4,4}, {BW,0,7}, {BZ,5,5},
+		{BZ,4,4}, {RX,0,4}, {GZ,4,4}, {GY,0,3}, {GX,0,4}, {BZ,0,0}, {GZ,0,3}, {BX,0,5},
+		{BY,0,3}, {RY,0,4}, {BZ,2,2}, {RZ,0,4}, {BZ,3,3}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x1E, 2, IL_FALSE, 6, { 6, 6, 6 }, {
+		{RW,0,5}, {GZ,4,4}, {BZ,0,1}, {BY,4,4}, {GW,0,5}, {GY,5,5}, {BY,5,5}, {BZ,2,2},
+		{GY,4,4}, {BW,0,5}, {GZ,5,5}, {BZ,3,3}, {BZ,5,5}, {BZ,4,4}, {RX,0,5}, {GY,0,3},
+		{GX,0,5}, {GZ,0,3}, {BX,0,5}, {BY,0,3}, {RY,0,5}, {RZ,0,5}, {PART,0,4}, {BC6_END,0,0} } },
+	{ 0x03, 1, IL_FALSE, 10, { 10, 10, 10 }, {
+		{RW,0,9}, {GW,0,9}, {BW,0,9}, {RX,0,9}, {GX,0,9}, {BX,0,9}, {BC6_END,0,0} } },
+	{ 0x07, 1, IL_TRUE, 11, { 9, 9, 9 }, {
+		{RW,0,9}, {GW,0,9}, {BW,0,9}, {RX,0,8}, {RW,10,10}, {GX,0,8}, {GW,10,10}, {BX,0,8},
+		{BW,10,10}, {BC6_END,0,0} } },
+	{ 0x0B, 1, IL_TRUE, 12, { 8, 8, 8 }, {
+		{RW,0,9}, {GW,0,9}, {BW,0,9}, {RX,0,7}, {RW,11,10}, {GX,0,7}, {GW,11,10}, {BX,0,7},
+		{BW,11,10}, {BC6_END,0,0} } },
+	{ 0x0F, 1, IL_TRUE, 16, { 4, 4, 4 }, {
+		{RW,0,9}, {GW,0,9}, {BW,0,9}, {RX,0,3}, {RW,15,10}, {GX,0,3}, {GW,15,10}, {BX,0,3},
+		{BW,15,10}, {BC6_END,0,0} } }
+};
+
+static inline ILint iSignExtend(ILint Value, ILuint Bits)
+{
+	ILint Shift = 32 - Bits;
+	return (ILint)((ILuint)Value << Shift) >> Shift;
+}
+
+// Scales an endpoint up to 16 bits (15 and a sign for signed blocks).
+static ILint iBc6Unquantize(ILint Comp, ILuint Bits, ILboolean Signed)
+{
+	ILboolean Negative = IL_FALSE;
+	ILint Unq;
+
+	if (!Signed) {
+		if (Bits >= 15)
+			return Comp;
+		if (Comp == 0)
+			return 0;
+		if (Comp == (1 << Bits) - 1)
+			return 0xFFFF;
+		return ((Comp << 16) + 0x8000) >> Bits;
+	}
+
+	if (Bits >= 16)
+		return Comp;
+	if (Comp < 0) {
+		Negative = IL_TRUE;
+		Comp = -Comp;
+	}
+	if (Comp == 0)
+		Unq = 0;
+	else if (Comp >= (1 << (Bits - 1)) - 1)
+		Unq = 0x7FFF;
+	else
+		Unq = ((Comp << 15) + 0x4000) >> (Bits - 1);
+
+	return Negative ? -Unq : Unq;
+}
+
+// Turns an interpolated value into the bits of a half float.
+static inline ILushort iBc6ToHalf(ILint Value, ILboolean Signed)
+{
+	if (!Signed)
+		return (ILushort)((Value * 31) >> 6);
+	if (Value < 0)
+		return (ILushort)(0x8000 | ((-Value * 31) >> 5));
+	return (ILushort)((Value * 31) >> 5);
+}
+
+//! Decodes one BC6H block to 16 RGB half floats, row by row.
+void DecodeBC6HBlock(const ILubyte *Block, ILboolean Signed, ILushort *Out)
+{
+	const iBc6Mode	*Mode = NULL;
+	const iBc6Run	*Run;
+	iBptcBits		Bits;
+	ILint			Fields[BC6_END], Endpoints[4][3], Mask;
+	const ILubyte	*Weights;
+	ILuint			Code, i, b, c, e, Subset, Index, Anchor, IndexBits;
+
+	iBptcInitBits(&Bits, Block);
+	Code = iBptcRead(&Bits, 2);
+	if (Code > 1)
+		Code |= iBptcRead(&Bits, 3) << 2;
+	for (i = 0; i < 14; i++) {
+		if (Bc6Modes[i].Code == Code) {
+			Mode = &Bc6Modes[i];
+			break;
+		}
+	}
+	if (Mode == NULL) {  // Reserved: black
+		memset(Out, 0, 48 * sizeof(ILushort));
+		return;
+	}
+
+	memset(Fields, 0, sizeof(Fields));
+	for (Run = Mode->Runs; Run->Field != BC6_END; Run++) {
+		if (Run->First <= Run->Last) {
+			for (b = Run->First; b <= Run->Last; b++)
+				Fields[Run->Field] |= iBptcRead(&Bits, 1) << b;
+		}
+		else {
+			for (b = Run->First + 1; b-- > Run->Last; )
+				Fields[Run->Field] |= iBptcRead(&Bits, 1) << b;
+		}
+	}
+
+	// Endpoint e of channel c is field c * 4 + e.
+	Mask = (1 << Mode->EndpointBits) - 1;
+	for (c = 0; c < 3; c++) {
+		Endpoints[0][c] = Fields[c * 4];
+		if (Signed)
+			Endpoints[0][c] = iSignExtend(Endpoints[0][c], Mode->EndpointBits);
+		for (e = 1; e < Mode->NumRegions * 2u; e++) {
+			Endpoints[e][c] = Fields[c * 4 + e];
+			if (Mode->Transformed) {
+				Endpoints[e][c] = iSignExtend(Endpoints[e][c], Mode->DeltaBits[c]);
+				Endpoints[e][c] = (Fields[c * 4] + Endpoints[e][c]) & Mask;
+				if (Signed)
+					Endpoints[e][c] = iSignExtend(Endpoints[e][c], Mode->EndpointBits);
+			}
+			else if (Signed)
+				Endpoints[e][c] = iSignExtend(Endpoints[e][c], Mode->DeltaBits[c]);
+		}
+		for (e = 0; e < Mode->NumRegions * 2u; e++)
+			Endpoints[e][c] = iBc6Unquantize(Endpoints[e][c], Mode->EndpointBits, Signed);
+	}
+
+	// Indices follow at bit 82 (two regions) or 65 (one region).
+	IndexBits = Mode->NumRegions == 2 ? 3 : 4;
+	Weights = BptcWeights(IndexBits);
+	Anchor = Mode->NumRegions == 2 ? BptcAnchor2[Fields[PART]] : 0;
+	for (i = 0; i < 16; i++, Out += 3) {
+		Index = iBptcRead(&Bits, (i == 0 || (Mode->NumRegions == 2 && i == Anchor)) ? IndexBits - 1 : IndexBits);
+		Subset = Mode->NumRegions == 2 ? (BptcPartition2[Fields[PART]] >> i) & 1 : 0;
+		for (c = 0; c < 3; c++) {
+			ILint E0 = Endpoints[Subset * 2][c], E1 = Endpoints[Subset * 2 + 1][c];
+			Out[c] = iBc6ToHalf((E0 * (64 - Weights[Index]) + E1 * Weights[Index] + 32) >> 6, Signed);
+		}
+	}
+
+	return;
+}
+
+
+//
+// Encoding.  Each subset (or region) is first fitted with the extremes of
+//	its pixels along their principal axis; the endpoints are then quantized
+//	and refined by least squares from the indices they give, as long as that
+//	lowers the error.  Every mode is tried, but the multi-subset ones only
+//	with the Effort partitions that look best from a quick estimate.
+//
+
+static inline void iBptcWrite(iBptcBits *Bits, ILuint Value, ILuint Num)
+{
+	ILuint64 v;
+
+	if (Num == 0)
+		return;
+	v = Value & ((1u << Num) - 1);
+	if (Bits->Pos >= 64)
+		Bits->Hi |= v << (Bits->Pos - 64);
+	else {
+		Bits->Lo |= v << Bits->Pos;
+		if (Bits->Pos + Num > 64)
+			Bits->Hi |= v >> (64 - Bits->Pos);
+	}
+	Bits->Pos += Num;
+
+	return;
+}
+
+static void iBptcStoreBits(const iBptcBits *Bits, ILubyte *Block)
+{
+	ILuint i;
+
+	for (i = 0; i < 8; i++) {
+		Block[i] = (ILubyte)(Bits->Lo >> (i * 8));
+		Block[i + 8] = (ILubyte)(Bits->Hi >> (i * 8));
+	}
+
+	return;
+}
+
+// Subset of pixel i in a partition
+static inline ILuint iBptcSubset(ILuint NumSubsets, ILuint Partition, ILuint i)
+{
+	if (NumSubsets == 1)
+		return 0;
+	if (NumSubsets == 2)
+		return (BptcPartition2[Partition] >> i) & 1;
+	return BptcPartition3[Partition][i];
+}
+
+// Anchor pixel of subset s, whose index is stored without its top bit
+static inline ILuint iBptcAnchor(ILuint NumSubsets, ILuint Partition, ILuint s)
+{
+	if (s == 0)
+		return 0;
+	if (NumSubsets == 2)
+		return BptcAnchor2[Partition];
+	return s == 1 ? BptcAnchor3a[Partition] : BptcAnchor3b[Partition];
+}
+
+// Finds the mean and principal axis of Num points with NumChans channels
+//	each, taking Steps steps of power iteration.  Returns the squared distance
+//	of the points from that axis, which is the error a perfect fit along it
+//	would still have.
+static ILfloat iBptcAxis(ILfloat Points[16][4], ILuint Num, ILuint NumChans, ILuint Steps, ILfloat *Mean, ILfloat *Axis)
+{
+	ILfloat	Cov[4][4], Next[4], d[4], Max, Len, Total = 0, Along = 0;
+	ILuint	i, j, k, Iter, Start = 0;
+
+	memset(Cov, 0, sizeof(Cov));
+	for (j = 0; j < NumChans; j++) {
+		Mean[j] = 0;
+		for (i = 0; i < Num; i++)
+			Mean[j] += Points[i][j];
+		Mean[j] /= Num;
+	}
+	for (i = 0; i < Num; i++) {
+		for (j = 0; j < NumChans; j++)
+			d[j] = Points[i][j] - Mean[j];
+		for (j = 0; j < NumChans; j++) {
+			for (k = j; k < NumChans; k++)
+				Cov[j][k] += d[j] * d[k];
+		}
+	}
+	for (j = 0; j < NumChans; j++) {
+		for (k = 0; k < j; k++)
+			Cov[j][k] = Cov[k][j];
+		Total += Cov[j][j];
+		if (Cov[j][j] > Cov[Start][Start])
+			Start = j;
+	}
+
+	// Power iteration, starting from the column of the widest channel
+	for (j = 0; j < NumChans; j++)
+		Axis[j] = Cov[j][Start];
+	for (Iter = 0; Iter < Steps; Iter++) {
+		Max = 0;
+		for (j = 0; j < NumChans; j++) {
+			Next[j] = 0;
+			for (k = 0; k < NumChans; k++)
+				Next[j] += Cov[j][k] * Axis[k];
+			Max = IL_MAX(Max, fabsf(Next[j]));
+		}
+		if (Max == 0)
+			break;
+		for (j = 0; j < NumChans; j++)
+			Axis[j] = Next[j] / Max;
+	}
+
+	Len = 0;
+	for (j = 0; j < NumChans; j++)
+		Len += Axis[j] * Axis[j];
+	if (Len == 0) {  // All the points are the same.
+		for (j = 0; j < NumChans; j++)
+			Axis[j] = 1.0f;
+		Len = (ILfloat)NumChans;
+	}
+	Len = sqrtf(Len);
+	for (j = 0; j < NumChans; j++)
+		Axis[j] /= Len;
+
+	for (j = 0; j < NumChans; j++) {
+		for (k = 0; k < NumChans; k++)
+			Along += Axis[j] * Cov[j][k] * Axis[k];
+	}
+
+	return IL_MAX(Total - Along, 0.0f);
+}
+
+// Ends of the points along Axis, through Mean
+static void iBptcRange(ILfloat Points[16][4], ILuint Num, ILuint NumChans, const ILfloat *Mean, const ILfloat *Axis,
+						ILfloat End[2][4])
+{
+	ILfloat	Min = 0, Max = 0, t;
+	ILuint	i, j;
+
+	for (i = 0; i < Num; i++) {
+		t = 0;
+		for (j = 0; j < NumChans; j++)
+			t += (Points[i][j] - Mean[j]) * Axis[j];
+		Min = IL_MIN(Min, t);
+		Max = IL_MAX(Max, t);
+	}
+	for (j = 0; j < NumChans; j++) {
+		End[0][j] = Mean[j] + Axis[j] * Min;
+		End[1][j] = Mean[j] + Axis[j] * Max;
+	}
+
+	return;
+}
+
+// Least squares endpoints for the pixels of subset s, given the index of
+//	each.  Returns IL_FALSE if the indices do not pin them down.
+static ILboolean iBptcRefit(ILfloat Points[16][4], const ILubyte *Subsets, ILuint s, ILuint Chan0, ILuint NumChans,
+							const ILubyte *Index, ILuint IndexBits, ILfloat End[2][4])
+{
+	const ILubyte	*Weights = BptcWeights(IndexBits);
+	ILfloat			AA = 0, BB = 0, AB = 0, AX[4] = { 0, 0, 0, 0 }, BX[4] = { 0, 0, 0, 0 }, a, b, Det;
+	ILuint			i, j;
+
+	for (i = 0; i < 16; i++) {
+		if (Subsets[i] != s)
+			continue;
+		b = Weights[Index[i]] / 64.0f;
+		a = 1.0f - b;
+		AA += a * a;
+		BB += b * b;
+		AB += a * b;
+		for (j = 0; j < NumChans; j++) {
+			AX[j] += a * Points[i][Chan0 + j];
+			BX[j] += b * Points[i][Chan0 + j];
+		}
+	}
+
+	Det = AA * BB - AB * AB;
+	if (Det < 1e-4f)
+		return IL_FALSE;
+	for (j = 0; j < NumChans; j++) {
+		End[0][j] = (AX[j] * BB - BX[j] * AB) / Det;
+		End[1][j] = (BX[j] * AA - AX[j] * AB) / Det;
+	}
+
+	return IL_TRUE;
+}
+
+
+//
+// BC7 encoding
+//
+
+// Endpoints of one subset: as stored, their p-bits and expanded to 8 bits
+typedef struct iBc7Ends
+{
+	ILint	Quant[2][4];
+	ILint	P[2];
+	ILint	Value[2][4];
+} iBc7Ends;
+
+// A block in one mode, ready to be packed.  Modes 4 and 5 keep the colour
+//	endpoints in Ends[0] and the alpha endpoints in Ends[1].
+typedef struct iBc7Block
+{
+	ILuint		Mode, Partition, Rotation, IndexSel;
+	iBc7Ends	Ends[3];
+	ILubyte		Index[16], Index2[16];
+	ILuint		Error;
+} iBc7Block;
+
+// The stored value of Bits bits (PBit, if not -1, is appended) that
+//	expands closest to Value, and its expansion.
+static ILint iBc7Quantize(ILfloat Value, ILuint Bits, ILint PBit, ILint *Quant)
+{
+	ILuint	Total = Bits + (PBit >= 0);
+	ILint	Max = (1 << Bits) - 1, q, q0, x, v, Best = 0;
+	ILfloat	Diff, BestDiff = 1e30f;
+
+	q0 = (ILint)(IL_CLAMP(Value / 255.0f) * ((1 << Total) - 1) + 0.5f);
+	if (PBit >= 0)
+		q0 >>= 1;
+	for (q = q0 - 1; q <= q0 + 1; q++) {
+		if (q < 0 || q > Max)
+			continue;
+		x = PBit >= 0 ? (q << 1) | PBit : q;
+		x <<= 8 - Total;
+		v = x | (x >> Total);
+		Diff = fabsf(v - Value);
+		if (Diff < BestDiff) {
+			BestDiff = Diff;
+			Best = v;
+			*Quant = q;
+		}
+	}
+
+	return Best;
+}
+
+// Chooses the index of each pixel of subset s and returns their squared
+//	error.  The palette lies on a line, so only the entries next to where a
+//	pixel projects onto it are compared.
+static ILuint iBc7Indices(const ILint Pixels[16][4], const ILubyte *Subsets, ILuint s, ILuint Chan0, ILuint NumChans,
+							const ILint Value[2][4], ILuint IndexBits, ILubyte *Index)
+{
+	const ILubyte	*Weights = BptcWeights(IndexBits);
+	ILint			Palette[16][4], Dir[4], DirLen = 0, Dot, d, k, k0, Last = (1 << IndexBits) - 1;
+	ILuint			Error = 0, Best, Dist, i, j;
+
+	for (k = 0; k <= Last; k++) {
+		for (j = Chan0; j < Chan0 + NumChans; j++)
+			Palette[k][j] = ((64 - Weights[k]) * Value[0][j] + Weights[k] * Value[1][j] + 32) >> 6;
+	}
+	for (j = Chan0; j < Chan0 + NumChans; j++) {
+		Dir[j] = Value[1][j] - Value[0][j];
+		DirLen += Dir[j] * Dir[j];
+	}
+
+	for (i = 0; i < 16; i++) {
+		if (Subsets[i] != s)
+			continue;
+
+		k0 = 0;
+		if (DirLen > 0) {
+			Dot = 0;
+			for (j = Chan0; j < Chan0 + NumChans; j++)
+				Dot += (Pixels[i][j] - Value[0][j]) * Dir[j];
+			k0 = (ILint)((ILfloat)Dot * Last / DirLen + 0.5f);
+			k0 = IL_MAX(0, IL_MIN(Last, k0));
+		}
+
+		Best = UINT_MAX;
+		for (k = IL_MAX(0, k0 - 1); k <= IL_MIN(Last, k0 + 1); k++) {
+			Dist = 0;
+			for (j = Chan0; j < Chan0 + NumChans; j++) {
+				d = Palette[k][j] - Pixels[i][j];
+				Dist += d * d;
+			}
+			if (Dist < Best) {
+				Best = Dist;
+				Index[i] = (ILubyte)k;
+			}
+		}
+		Error += Best;
+	}
+
+	return Error;
+}
+
+// Quantizes End with each choice of p-bits (PBits is 0, 1 per subset or 2
+//	per endpoint) and keeps the best.  Returns its squared error.
+static ILuint iBc7QuantizeEnds(const ILint Pixels[16][4], const ILubyte *Subsets, ILuint s, ILuint Chan0, ILuint NumChans,
+								ILuint Bits, ILuint PBits, ILuint IndexBits, ILfloat End[2][4], iBc7Ends *Ends, ILubyte *Index)
+{
+	iBc7Ends	Trial;
+	ILubyte		TrialIndex[16];
+	ILuint		NumTries = PBits == 0 ? 1 : (PBits == 1 ? 2 : 4), Try, Error, Best = UINT_MAX, e, j, i;
+
+	for (Try = 0; Try < NumTries; Try++) {
+		Trial.P[0] = PBits == 0 ? -1 : (ILint)(Try & 1);
+		Trial.P[1] = PBits == 2 ? (ILint)(Try >> 1) : Trial.P[0];
+		for (e = 0; e < 2; e++) {
+			for (j = 0; j < NumChans; j++)
+				Trial.Value[e][Chan0 + j] = iBc7Quantize(End[e][j], Bits, Trial.P[e], &Trial.Quant[e][Chan0 + j]);
+		}
+
+		Error = iBc7Indices(Pixels, Subsets, s, Chan0, NumChans, Trial.Value, IndexBits, TrialIndex);
+		if (Error < Best) {
+			Best = Error;
+			*Ends = Trial;
+			for (i = 0; i < 16; i++) {
+				if (Subsets[i] == s)
+					Index[i] = TrialIndex[i];
+			}
+		}
+	}
+
+	return Best;
+}
+
+// Fits the channels Chan0 to Chan0 + NumChans - 1 of subset s and returns the squared error.
+static ILuint iBc7FitSubset(const ILint Pixels[16][4], const ILubyte *Subsets, ILuint s, ILuint Chan0, ILuint NumChans,
+							ILuint Bits, ILuint PBits, ILuint IndexBits, iBc7Ends *Ends, ILubyte *Index)
+{
+	ILfloat		Points[16][4], All[16][4], Mean[4], Axis[4], End[2][4];
+	iBc7Ends	Trial;
+	ILubyte		TrialIndex[16];
+	ILuint		Num = 0, Error, TrialError, Iter, i, j;
+
+	for (i = 0; i < 16; i++) {
+		for (j = 0; j < 4; j++)
+			All[i][j] = (ILfloat)Pixels[i][j];
+		if (Subsets[i] != s)
+			continue;
+		for (j = 0; j < NumChans; j++)
+			Points[Num][j] = All[i][Chan0 + j];
+		Num++;
+	}
+	if (Num == 0) {
+		memset(Ends, 0, sizeof(*Ends));
+		return 0;
+	}
+
+	iBptcAxis(Points, Num, NumChans, 8, Mean, Axis);
+	iBptcRange(Points, Num, NumChans, Mean, Axis, End);
+	Error = iBc7QuantizeEnds(Pixels, Subsets, s, Chan0, NumChans, Bits, PBits, IndexBits, End, Ends, Index);
+
+	for (Iter = 0; Iter < 2 && Error > 0; Iter++) {
+		if (!iBptcRefit(All, Subsets, s, Chan0, NumChans, Index, IndexBits, End))
+			break;
+		TrialError = iBc7QuantizeEnds(Pixels, Subsets, s, Chan0, NumChans, Bits, PBits, IndexBits, End, &Trial, TrialIndex);
+		if (TrialError >= Error)
+			break;
+		Error = TrialError;
+		*Ends = Trial;
+		for (i = 0; i < 16; i++) {
+			if (Subsets[i] == s)
+				Index[i] = TrialIndex[i];
+		}
+	}
+
+	return Error;
+}
+
+// Swaps the endpoints of subset s if its anchor index has the top bit set,
+//	which the block has no room for.
+static void iBc7FixAnchor(iBc7Ends *Ends, const ILubyte *Subsets, ILuint s, ILuint Anchor, ILuint IndexBits, ILubyte *Index)
+{
+	ILuint		i, j;
+	ILint		Temp;
+
+	if (!(Index[Anchor] >> (IndexBits - 1)))
+		return;
+
+	for (j = 0; j < 4; j++) {
+		Temp = Ends->Quant[0][j];  Ends->Quant[0][j] = Ends->Quant[1][j];  Ends->Quant[1][j] = Temp;
+		Temp = Ends->Value[0][j];  Ends->Value[0][j] = Ends->Value[1][j];  Ends->Value[1][j] = Temp;
+	}
+	Temp = Ends->P[0];  Ends->P[0] = Ends->P[1];  Ends->P[1] = Temp;
+	for (i = 0; i < 16; i++) {
+		if (Subsets[i] == s)
+			Index[i] = (ILubyte)((1 << IndexBits) - 1 - Index[i]);
+	}
+
+	return;
+}
+
+// Encodes Block (RGBA, with alpha swapped into place for Rotation) in one
+//	mode and partition.
+static void iBc7EncodeMode(const ILint Block[16][4], ILuint ModeNum, ILuint Partition, ILuint Rotation, ILuint IndexSel,
+							iBc7Block *Out)
+{
+	const iBc7Mode	*Mode = &Bc7Modes[ModeNum];
+	ILint			Pixels[16][4], Temp;
+	ILubyte			Subsets[16], *ColourIndex, *AlphaIndex;
+	ILuint			PBits, ColourBits, AlphaBits, s, i;
+
+	memcpy(Pixels, Block, sizeof(Pixels));
+	if (Rotation) {
+		for (i = 0; i < 16; i++) {
+			Temp = Pixels[i][3];
+			Pixels[i][3] = Pixels[i][Rotation - 1];
+			Pixels[i][Rotation - 1] = Temp;
+		}
+	}
+	for (i = 0; i < 16; i++)
+		Subsets[i] = (ILubyte)iBptcSubset(Mode->NumSubsets, Partition, i);
+
+	Out->Mode = ModeNum;
+	Out->Partition = Partition;
+	Out->Rotation = Rotation;
+	Out->IndexSel = IndexSel;
+	Out->Error = 0;
+
+	if (Mode->IndexBits2) {
+		ColourBits = IndexSel ? Mode->IndexBits2 : Mode->IndexBits;
+		AlphaBits = IndexSel ? Mode->IndexBits : Mode->IndexBits2;
+		ColourIndex = IndexSel ? Out->Index2 : Out->Index;
+		AlphaIndex = IndexSel ? Out->Index : Out->Index2;
+		Out->Error += iBc7FitSubset(Pixels, Subsets, 0, 0, 3, Mode->ColourBits, 0, ColourBits, &Out->Ends[0], ColourIndex);
+		Out->Error += iBc7FitSubset(Pixels, Subsets, 0, 3, 1, Mode->AlphaBits, 0, AlphaBits, &Out->Ends[1], AlphaIndex);
+		iBc7FixAnchor(&Out->Ends[0], Subsets, 0, 0, ColourBits, ColourIndex);
+		iBc7FixAnchor(&Out->Ends[1], Subsets, 0, 0, AlphaBits, AlphaIndex);
+		return;
+	}
+
+	PBits = Mode->EndpointPBits ? 2 : (Mode->SharedPBits ? 1 : 0);
+	for (s = 0; s < Mode->NumSubsets; s++) {
+		Out->Error += iBc7FitSubset(Pixels, Subsets, s, 0, Mode->AlphaBits ? 4 : 3, Mode->ColourBits, PBits,
+			Mode->IndexBits, &Out->Ends[s], Out->Index);
+		iBc7FixAnchor(&Out->Ends[s], Subsets, s, iBptcAnchor(Mode->NumSubsets, Partition, s), Mode->IndexBits, Out->Index);
+	}
+	if (!Mode->AlphaBits) {  // Alpha comes out as 255.
+		for (i = 0; i < 16; i++)
+			Out->Error += (255 - Pixels[i][3]) * (255 - Pixels[i][3]);
+	}
+
+	return;
+}
+
+static void iBc7Pack(const iBc7Block *In, ILubyte *Block)
+{
+	const iBc7Mode	*Mode = &Bc7Modes[In->Mode];
+	iBptcBits		Bits;
+	ILuint			NumEndpoints = Mode->NumSubsets * 2, Split = Mode->IndexBits2 != 0, e, c, i, s;
+	ILuint			Anchor1 = iBptcAnchor(Mode->NumSubsets, In->Partition, 1);
+	ILuint			Anchor2 = iBptcAnchor(Mode->NumSubsets, In->Partition, 2);
+
+	Bits.Lo = Bits.Hi = 0;
+	Bits.Pos = 0;
+	iBptcWrite(&Bits, 1 << In->Mode, In->Mode + 1);
+	iBptcWrite(&Bits, In->Partition, Mode->PartitionBits);
+	iBptcWrite(&Bits, In->Rotation, Mode->RotationBits);
+	iBptcWrite(&Bits, In->IndexSel, Mode->IndexSelBits);
+
+	for (c = 0; c < 3; c++) {
+		for (e = 0; e < NumEndpoints; e++)
+			iBptcWrite(&Bits, In->Ends[e / 2].Quant[e & 1][c], Mode->ColourBits);
+	}
+	for (e = 0; e < NumEndpoints && Mode->AlphaBits; e++)
+		iBptcWrite(&Bits, In->Ends[Split ? 1 : e / 2].Quant[e & 1][3], Mode->AlphaBits);
+
+	if (Mode->EndpointPBits) {
+		for (e = 0; e < NumEndpoints; e++)
+			iBptcWrite(&Bits, In->Ends[e / 2].P[e & 1], 1);
+	}
+	else if (Mode->SharedPBits) {
+		for (s = 0; s < Mode->NumSubsets; s++)
+			iBptcWrite(&Bits, In->Ends[s].P[0], 1);
+	}
+
+	for (i = 0; i < 16; i++) {
+		if (i == 0 || (Mode->NumSubsets > 1 && i == Anchor1) || (Mode->NumSubsets > 2 && i == Anchor2))
+			iBptcWrite(&Bits, In->Index[i], Mode->IndexBits - 1);
+		else
+			iBptcWrite(&Bits, In->Index[i], Mode->IndexBits);
+	}
+	if (Mode->IndexBits2) {
+		for (i = 0; i < 16; i++)
+			iBptcWrite(&Bits, In->Index2[i], Mode->IndexBits2 - (i == 0));
+	}
+
+	iBptcStoreBits(&Bits, Block);
+	return;
+}
+
+// Where iBptcRankPartitions keeps the sum of each channel and of the product
+//	of two channels.  Those without alpha come first.
+static const ILubyte BptcSumIndex[4] = { 0, 1, 2, 9 };
+static const ILubyte BptcProductIndex[4][4] = {
+	{ 3, 4, 5, 10 }, { 4, 6, 7, 11 }, { 5, 7, 8, 12 }, { 10, 11, 12, 13 }
+};
+
+// Puts the Num partitions of NumSubsets subsets whose pixels lie closest to
+//	a line in each subset into List, best first, and returns how many there
+//	are.  The sums the covariance of a subset needs are added up from sums
+//	formed once per pixel; the first subset gets what the others leave of
+//	the whole block.
+static ILuint iBptcRankPartitions(ILfloat Pixels[16][4], ILuint NumChans, ILuint NumSubsets, ILuint NumPartitions,
+									ILuint Num, ILubyte *List)
+{
+	ILfloat	Moments[16][14], BlockSums[14], Sums[3][14], Cov[4][4], Axis[4], Next[4], Score[64], Total, Along, Len, Inv;
+	ILuint	NumMoments = NumChans == 3 ? 9 : 14, Count[3], p, s, i, j, k, m, Step, Widest;
+	ILubyte	Temp;
+
+	memset(BlockSums, 0, sizeof(BlockSums));
+	for (i = 0; i < 16; i++) {
+		for (j = 0; j < 4; j++) {
+			Moments[i][BptcSumIndex[j]] = Pixels[i][j];
+			for (k = j; k < 4; k++)
+				Moments[i][BptcProductIndex[j][k]] = Pixels[i][j] * Pixels[i][k];
+		}
+		for (m = 0; m < NumMoments; m++)
+			BlockSums[m] += Moments[i][m];
+	}
+
+	for (p = 0; p < NumPartitions; p++) {
+		memset(Sums, 0, sizeof(Sums));
+		Count[1] = Count[2] = 0;
+		for (i = 0; i < 16; i++) {
+			s = iBptcSubset(NumSubsets, p, i);
+			if (s == 0)
+				continue;
+			Count[s]++;
+			for (m = 0; m < NumMoments; m++)
+				Sums[s][m] += Moments[i][m];
+		}
+		Count[0] = 16 - Count[1] - Count[2];
+		for (m = 0; m < NumMoments; m++)
+			Sums[0][m] = BlockSums[m] - Sums[1][m] - Sums[2][m];
+
+		Score[p] = 0;
+		for (s = 0; s < NumSubsets; s++) {
+			if (Count[s] == 0)
+				continue;
+			Total = 0;
+			Widest = 0;
+			Inv = 1.0f / Count[s];
+			for (j = 0; j < NumChans; j++) {
+				for (k = j; k < NumChans; k++) {
+					Cov[j][k] = Cov[k][j] = Sums[s][BptcProductIndex[j][k]]
+						- Sums[s][BptcSumIndex[j]] * Sums[s][BptcSumIndex[k]] * Inv;
+				}
+				Total += Cov[j][j];
+				if (Cov[j][j] > Cov[Widest][Widest])
+					Widest = j;
+			}
+
+			// Two steps of power iteration give an axis good enough to compare.
+			for (j = 0; j < NumChans; j++)
+				Axis[j] = Cov[j][Widest];
+			for (Step = 0; Step < 2; Step++) {
+				for (j = 0; j < NumChans; j++) {
+					Next[j] = 0;
+					for (k = 0; k < NumChans; k++)
+						Next[j] += Cov[j][k] * Axis[k];
+				}
+				memcpy(Axis, Next, sizeof(Axis));
+			}
+			Len = Along = 0;
+			for (j = 0; j < NumChans; j++) {
+				Len += Axis[j] * Axis[j];
+				for (k = 0; k < NumChans; k++)
+					Along += Axis[j] * Cov[j][k] * Axis[k];
+			}
+			if (Len > 0)
+				Total -= Along / Len;
+			Score[p] += IL_MAX(Total, 0.0f);
+		}
+		List[p] = (ILubyte)p;
+	}
+
+	// Partial selection sort; Num is small.
+	Num = IL_MIN(Num, NumPartitions);
+	for (i = 0; i < Num; i++) {
+		for (j = i + 1; j < NumPartitions; j++) {
+			if (Score[List[j]] < Score[List[i]]) {
+				Temp = List[i];
+				List[i] = List[j];
+				List[j] = Temp;
+			}
+		}
+	}
+
+	return Num;
+}
+
+static void iBc7Try(const ILint Pixels[16][4], ILuint Mode, ILuint Partition, ILuint Rotation, ILuint IndexSel, iBc7Block *Best)
+{
+	iBc7Block Trial;
+
+	if (Best->Error == 0)
+		return;
+	iBc7EncodeMode(Pixels, Mode, Partition, Rotation, IndexSel, &Trial);
+	if (Trial.Error < Best->Error)
+		*Best = Trial;
+
+	return;
+}
+
+//! Encodes 16 RGBA pixels, row by row, as one BC7 block.
+/*! Effort is the number of partitions each multi-subset mode tries (0 to 64).*/
+void EncodeBC7Block(const ILubyte *Pixels, ILuint Effort, ILubyte *Block)
+{
+	ILint		Px[16][4];
+	ILfloat		Fx[16][4];
+	ILubyte		List[64];
+	iBc7Block	Best;
+	ILboolean	Opaque = IL_TRUE;
+	ILuint		i, j, Num, Rot;
+
+	for (i = 0; i < 16; i++) {
+		for (j = 0; j < 4; j++) {
+			Px[i][j] = Pixels[i * 4 + j];
+			Fx[i][j] = Pixels[i * 4 + j];
+		}
+		if (Pixels[i * 4 + 3] != 255)
+			Opaque = IL_FALSE;
+	}
+
+	iBc7EncodeMode(Px, 6, 0, 0, 0, &Best);
+	if (!Opaque)
+		iBc7Try(Px, 5, 0, 0, 0, &Best);
+
+	if (Effort > 0 && Best.Error > 0) {
+		for (Rot = 0; Rot < 4; Rot++) {
+			if (Rot > 0 || Opaque)
+				iBc7Try(Px, 5, 0, Rot, 0, &Best);
+			iBc7Try(Px, 4, 0, Rot, 0, &Best);
+			iBc7Try(Px, 4, 0, Rot, 1, &Best);
+		}
+
+		Num = iBptcRankPartitions(Fx, Opaque ? 3 : 4, 2, 64, Effort, List);
+		for (i = 0; i < Num; i++) {
+			if (Opaque) {
+				iBc7Try(Px, 1, List[i], 0, 0, &Best);
+				iBc7Try(Px, 3, List[i], 0, 0, &Best);
+			}
+			else
+				iBc7Try(Px, 7, List[i], 0, 0, &Best);
+		}
+
+		// Modes with three subsets have no alpha.  Mode 0 has only the first
+		//	16 partitions.
+		if (Opaque) {
+			Num = iBptcRankPartitions(Fx, 3, 3, 64, 64, List);
+			for (i = 0, j = 0; i < Num && (i < Effort || j < Effort); i++) {
+				if (i < Effort)
+					iBc7Try(Px, 2, List[i], 0, 0, &Best);
+				if (List[i] < 16 && j < Effort) {
+					iBc7Try(Px, 0, List[i], 0, 0, &Best);
+					j++;
+				}
+			}
+		}
+	}
+
+	iBc7Pack(&Best, Block);
+	return;
+}
+
+
+//
+// BC6H encoding.  The error is measured in the space the decoder
+//	interpolates in, which is close to the bits of a half float and so
+//	roughly logarithmic in the value.
+//
+
+typedef struct iBc6Block
+{
+	ILuint	Mode, Partition;
+	ILint	Ends[4][3];
+	ILubyte	Index[16];
+	ILfloat	Error;
+} iBc6Block;
+
+// Where a float lands in the decoder's interpolation space
+static ILfloat iBc6Target(ILfloat Value, ILboolean Signed)
+{
+	ILuint		Bits;
+	ILushort	Half, Mag;
+
+	if (Value != Value)  // NaN
+		return 0;
+	memcpy(&Bits, &Value, sizeof(Bits));
+	Half = ilFloatToHalf(Bits);
+	Mag = IL_MIN(Half & 0x7FFF, 0x7BFF);  // Infinity becomes the largest finite value.
+
+	if (!Signed)
+		return (Half & 0x8000) ? 0.0f : Mag * 64.0f / 31.0f;
+	return (Half & 0x8000) ? -(Mag * 32.0f / 31.0f) : Mag * 32.0f / 31.0f;
+}
+
+// The endpoint of Bits bits that unquantizes closest to Value
+static ILint iBc6Quantize(ILfloat Value, ILuint Bits, ILboolean Signed)
+{
+	ILint	Max, Min, q, q0, Best = 0;
+	ILfloat	Diff, BestDiff = 1e30f;
+
+	if (Signed) {
+		Max = (1 << (Bits - 1)) - 1;
+		Min = -Max;
+		if (Bits >= 16)
+			return IL_MAX(Min, IL_MIN(Max, (ILint)floorf(Value + 0.5f)));
+		q0 = (ILint)floorf(Value * (1 << (Bits - 1)) / 32768.0f);
+	}
+	else {
+		Max = (1 << Bits) - 1;
+		Min = 0;
+		if (Bits >= 15)
+			return IL_MAX(Min, IL_MIN(Max, (ILint)floorf(Value + 0.5f)));
+		q0 = (ILint)floorf(Value * (1 << Bits) / 65536.0f);
+	}
+
+	for (q = q0 - 1; q <= q0 + 1; q++) {
+		if (q < Min || q > Max)
+			continue;
+		Diff = fabsf(iBc6Unquantize(q, Bits, Signed) - Value);
+		if (Diff < BestDiff) {
+			BestDiff = Diff;
+			Best = q;
+		}
+	}
+
+	return Best;
+}
+
+// Quantizes End (two float endpoints per region) to the mode, keeping the
+//	deltas in range, and chooses the indices.  Returns the squared error.
+static ILfloat iBc6EncodeEnds(ILfloat Targets[16][4], const ILubyte *Regions, const iBc6Mode *Mode, ILuint Partition,
+								ILboolean Signed, ILfloat End[4][4], iBc6Block *Out)
+{
+	const ILubyte	*Weights;
+	ILfloat			Error = 0, Best, Dist, d, t, Len;
+	ILint			Unq[2][3], Palette[16][3], Delta, Limit;
+	ILuint			IndexBits, NumIndices, Anchor, r, e, c, i, k, Top;
+
+	IndexBits = Mode->NumRegions == 2 ? 3 : 4;
+	NumIndices = 1 << IndexBits;
+	Weights = BptcWeights(IndexBits);
+
+	// Point the endpoints of each region so that its anchor pixel is nearer
+	//	the first one; its index is stored without the top bit.
+	for (r = 0; r < Mode->NumRegions; r++) {
+		Anchor = iBptcAnchor(Mode->NumRegions, Partition, r);
+		t = Len = 0;
+		for (c = 0; c < 3; c++) {
+			d = End[r * 2 + 1][c] - End[r * 2][c];
+			t += (Targets[Anchor][c] - End[r * 2][c]) * d;
+			Len += d * d;
+		}
+		if (t * 2 > Len) {
+			for (c = 0; c < 3; c++) {
+				d = End[r * 2][c];
+				End[r * 2][c] = End[r * 2 + 1][c];
+				End[r * 2 + 1][c] = d;
+			}
+		}
+	}
+
+	for (e = 0; e < Mode->NumRegions * 2u; e++) {
+		for (c = 0; c < 3; c++)
+			Out->Ends[e][c] = iBc6Quantize(End[e][c], Mode->EndpointBits, Signed);
+	}
+	if (Mode->Transformed) {
+		for (e = 1; e < Mode->NumRegions * 2u; e++) {
+			for (c = 0; c < 3; c++) {
+				Limit = 1 << (Mode->DeltaBits[c] - 1);
+				Delta = Out->Ends[e][c] - Out->Ends[0][c];
+				Delta = IL_MAX(-Limit, IL_MIN(Limit - 1, Delta));
+				Out->Ends[e][c] = Out->Ends[0][c] + Delta;
+			}
+		}
+	}
+
+	for (r = 0; r < Mode->NumRegions; r++) {
+		for (e = 0; e < 2; e++) {
+			for (c = 0; c < 3; c++)
+				Unq[e][c] = iBc6Unquantize(Out->Ends[r * 2 + e][c], Mode->EndpointBits, Signed);
+		}
+		for (k = 0; k < NumIndices; k++) {
+			for (c = 0; c < 3; c++)
+				Palette[k][c] = (Unq[0][c] * (64 - Weights[k]) + Unq[1][c] * Weights[k] + 32) >> 6;
+		}
+
+		Anchor = iBptcAnchor(Mode->NumRegions, Partition, r);
+		for (i = 0; i < 16; i++) {
+			if (Regions[i] != r)
+				continue;
+			Top = i == Anchor ? NumIndices / 2 : NumIndices;
+			Best = 1e30f;
+			for (k = 0; k < Top; k++) {
+				Dist = 0;
+				for (c = 0; c < 3; c++) {
+					d = Palette[k][c] - Targets[i][c];
+					Dist += d * d;
+				}
+				if (Dist < Best) {
+					Best = Dist;
+					Out->Index[i] = (ILubyte)k;
+				}
+			}
+			Error += Best;
+		}
+	}
+
+	return Error;
+}
+
+// Encodes the block in one mode and partition.
+static void iBc6EncodeMode(ILfloat Targets[16][4], ILuint ModeNum, ILuint Partition, ILboolean Signed, iBc6Block *Out)
+{
+	const iBc6Mode	*Mode = &Bc6Modes[ModeNum];
+	ILfloat			Points[16][4], Mean[4], Axis[4], End[4][4], Lo, Hi;
+	ILubyte			Regions[16];
+	iBc6Block		Trial;
+	ILuint			r, i, n, c, Iter, IndexBits = Mode->NumRegions == 2 ? 3 : 4;
+
+	for (i = 0; i < 16; i++)
+		Regions[i] = (ILubyte)iBptcSubset(Mode->NumRegions, Partition, i);
+
+	Lo = Signed ? -32767.0f : 0.0f;
+	Hi = Signed ? 32767.0f : 65535.0f;
+	for (r = 0; r < Mode->NumRegions; r++) {
+		for (i = 0, n = 0; i < 16; i++) {
+			if (Regions[i] == r)
+				memcpy(Points[n++], Targets[i], sizeof(Points[0]));
+		}
+		iBptcAxis(Points, n, 3, 8, Mean, Axis);
+		iBptcRange(Points, n, 3, Mean, Axis, &End[r * 2]);
+	}
+
+	Trial.Mode = ModeNum;
+	Trial.Partition = Partition;
+
+	for (Iter = 0; Iter < 3; Iter++) {
+		for (r = 0; r < Mode->NumRegions * 2u; r++) {
+			for (c = 0; c < 3; c++)
+				End[r][c] = IL_MAX(Lo, IL_MIN(Hi, End[r][c]));
+		}
+		Trial.Error = iBc6EncodeEnds(Targets, Regions, Mode, Partition, Signed, End, &Trial);
+		if (Iter > 0 && !(Trial.Error < Out->Error))  // The first try is always kept.
+			break;
+		*Out = Trial;
+		if (Out->Error == 0)
+			break;
+
+		for (r = 0; r < Mode->NumRegions; r++) {
+			if (!iBptcRefit(Targets, Regions, r, 0, 3, Out->Index, IndexBits, &End[r * 2]))
+				break;
+		}
+		if (r < Mode->NumRegions)
+			break;
+	}
+
+	return;
+}
+
+static void iBc6Pack(const iBc6Block *In, ILubyte *Block)
+{
+	const iBc6Mode	*Mode = &Bc6Modes[In->Mode];
+	const iBc6Run	*Run;
+	iBptcBits		Bits;
+	ILint			Fields[BC6_END], Value;
+	ILuint			IndexBits, Anchor, b, c, e, i;
+
+	memset(Fields, 0, sizeof(Fields));
+	for (c = 0; c < 3; c++) {
+		Fields[c * 4] = In->Ends[0][c] & ((1 << Mode->EndpointBits) - 1);
+		for (e = 1; e < Mode->NumRegions * 2u; e++) {
+			Value = Mode->Transformed ? In->Ends[e][c] - In->Ends[0][c] : In->Ends[e][c];
+			Fields[c * 4 + e] = Value & ((1 << Mode->DeltaBits[c]) - 1);
+		}
+	}
+	Fields[PART] = In->Partition;
+
+	Bits.Lo = Bits.Hi = 0;
+	Bits.Pos = 0;
+	iBptcWrite(&Bits, Mode->Code & 3, 2);
+	if (Mode->Code > 1)
+		iBptcWrite(&Bits, Mode->Code >> 2, 3);
+	for (Run = Mode->Runs; Run->Field != BC6_END; Run++) {
+		if (Run->First <= Run->Last) {
+			for (b = Run->First; b <= Run->Last; b++)
+				iBptcWrite(&Bits, Fields[Run->Field] >> b, 1);
+		}
+		else {
+			for (b = Run->First + 1; b-- > Run->Last; )
+				iBptcWrite(&Bits, Fields[Run->Field] >> b, 1);
+		}
+	}
+
+	IndexBits = Mode->NumRegions == 2 ? 3 : 4;
+	Anchor = Mode->NumRegions == 2 ? BptcAnchor2[In->Partition] : 0;
+	for (i = 0; i < 16; i++)
+		iBptcWrite(&Bits, In->Index[i], (i == 0 || (Mode->NumRegions == 2 && i == Anchor)) ? IndexBits - 1 : IndexBits);
+
+	iBptcStoreBits(&Bits, Block);
+	return;
+}
+
+//! Encodes 16 RGB floats, row by row, as one BC6H block.
+/*! Effort is the number of partitions the two-region modes try (0 to 64).*/
+void EncodeBC6HBlock(const ILfloat *Pixels, ILboolean Signed, ILuint Effort, ILubyte *Block)
+{
+	ILfloat		Targets[16][4];
+	ILubyte		List[64];
+	iBc6Block	Best, Trial;
+	ILuint		i, c, m, Num;
+
+	for (i = 0; i < 16; i++) {
+		for (c = 0; c < 3; c++)
+			Targets[i][c] = iBc6Target(Pixels[i * 3 + c], Signed);
+		Targets[i][3] = 0;
+	}
+
+	// Start from a real block, so that Best is whole even if every error is NaN.
+	iBc6EncodeMode(Targets, 10, 0, Signed, &Best);
+	for (m = 11; m < 14 && Best.Error > 0; m++) {
+		iBc6EncodeMode(Targets, m, 0, Signed, &Trial);
+		if (Trial.Error < Best.Error)
+			Best = Trial;
+	}
+
+	Num = Effort > 0 && Best.Error > 0 ? iBptcRankPartitions(Targets, 3, 2, 32, Effort, List) : 0;
+	for (i = 0; i < Num; i++) {
+		for (m = 0; m < 10 && Best.Error > 0; m++) {
+			iBc6EncodeMode(Targets, m, List[i], Signed, &Trial);
+			if (Trial.Error < Best.Error)
+				Best = Trial;
+		}
+	}
+
+	iBc6Pack(&Best, Block);
+	return;
+}
+
+
+#ifndef IL_NO_DDS
+
+//
+// Whole images.  Blocks are independent, so rows of blocks are spread over
+//	threads; each row writes only its own 4 lines of the image.
+//
+
+// Smallest number of block rows worth a thread of their own
+#define BPTC_MIN_ROWS 16
+
+//! Decodes BC7 data to the IL_RGBA, IL_UNSIGNED_BYTE image lImage.
+ILboolean DecompressBC7(ILimage *lImage, const ILubyte *lCompData)
+{
+	ILuint BlocksX, BlocksY;
+
+	if (!lCompData)
+		return IL_FALSE;
+
+	BlocksX = (lImage->Width + 3) / 4;
+	BlocksY = (lImage->Height + 3) / 4;
+
+	iParallelFor(BlocksY * lImage->Depth, BPTC_MIN_ROWS, [&](ILuint First, ILuint Last) {
+		ILubyte	Pixels[64];
+		ILuint	Row, bx, x, y, z, i;
+
+		for (Row = First; Row < Last; Row++) {
+			const ILubyte *Block = lCompData + (ILsizei)Row * BlocksX * 16;
+			z = Row / BlocksY;
+			y = (Row % BlocksY) * 4;
+			for (bx = 0; bx < BlocksX; bx++, Block += 16) {
+				DecodeBC7Block(Block, Pixels);
+				x = bx * 4;
+				for (i = 0; i < 4 && y + i < lImage->Height; i++) {
+					memcpy(lImage->Data + z * lImage->SizeOfPlane + (y + i) * lImage->Bps + x * 4,
+						Pixels + i * 16, IL_MIN(4, lImage->Width - x) * 4);
+				}
+			}
+		}
+	});
+
+	return IL_TRUE;
+}
+
+//! Decodes BC6H data to the IL_RGB, IL_FLOAT image lImage.
+ILboolean DecompressBC6H(ILimage *lImage, const ILubyte *lCompData, ILboolean Signed)
+{
+	ILuint BlocksX, BlocksY;
+
+	if (!lCompData)
+		return IL_FALSE;
+
+	BlocksX = (lImage->Width + 3) / 4;
+	BlocksY = (lImage->Height + 3) / 4;
+
+	iParallelFor(BlocksY * lImage->Depth, BPTC_MIN_ROWS, [&](ILuint First, ILuint Last) {
+		ILushort	Halves[48];
+		ILuint		Row, bx, x, y, z, i, j, *Dest;
+
+		for (Row = First; Row < Last; Row++) {
+			const ILubyte *Block = lCompData + (ILsizei)Row * BlocksX * 16;
+			z = Row / BlocksY;
+			y = (Row % BlocksY) * 4;
+			for (bx = 0; bx < BlocksX; bx++, Block += 16) {
+				DecodeBC6HBlock(Block, Signed, Halves);
+				x = bx * 4;
+				for (i = 0; i < 4 && y + i < lImage->Height; i++) {
+					Dest = (ILuint*)(lImage->Data + z * lImage->SizeOfPlane + (y + i) * lImage->Bps) + x * 3;
+					for (j = 0; j < IL_MIN(4, lImage->Width - x) * 3; j++)
+						Dest[j] = ilHalfToFloat(Halves[i * 12 + j]);
+				}
+			}
+		}
+	});
+
+	return IL_TRUE;
+}
+
+#endif//IL_NO_DDS
@@ -1,7 +1,21 @@
 #include "il_context_impl.h"
 
 ILcontext::ILcontext() :
-    impl(new Impl())
+    impl(new Impl()),
+    iluImpl(NULL),
+    iluFree(NULL),
+    ilutImpl(NULL),
+    ilutFree(NULL)
 {
     this->impl->iCurImage = NULL;
-}
\ No newline at end of file
+    ilResetMemory(this);
+}
+
+ILcontext::~ILcontext()
+{
+    if (iluFree != NULL)
+        iluFree(this);
+    if (ilutFree != NULL)
+        ilutFree(this);
+    delete impl;
+}
@@ -12,13 +12,31 @@
 
 
 #include "il_internal.h"
+#include "il_simd.h"
 #ifdef ALTIVEC_GCC
 #include "altivec_typeconversion.h"
 #endif
 #include <limits.h>
+#include <limits>
 
 
-void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcType, ILenum DestType, void *Buffer);
+// Converts a scaled value to D.  Luminance weights add up to about 1.0 and
+//  1.0f * UINT_MAX rounds up to 2^32, so white can come out just past the
+//  largest integer value, which would be undefined to cast; integer types are
+//  clamped to their range instead.
+template <typename D> static inline D iClampCast(ILdouble Val)
+{
+	if (std::numeric_limits<D>::is_integer) {
+		if (Val >= (ILdouble)std::numeric_limits<D>::max())
+			return std::numeric_limits<D>::max();
+		if (Val <= (ILdouble)std::numeric_limits<D>::min())
+			return std::numeric_limits<D>::min();
+	}
+	return (D)Val;
+}
+
+
+void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILsizei SizeOfData, ILenum SrcType, ILenum DestType, void *Buffer);
 
 //ILushort ILAPIENTRY ilFloatToHalf(ILuint i);
 //ILuint   ILAPIENTRY ilHalfToFloat (ILushort y);
@@ -28,21 +46,24 @@ ILimage *iConvertPalette(ILcontext* context, ILimage *Image, ILenum DestFormat);
 
 #define CHECK_ALLOC() 	if (NewData == NULL) { \
 							if (Data != Buffer) \
-								ifree(Data); \
+								ifree(context, Data); \
 							return IL_FALSE; \
 						}
 
-ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, ILenum SrcFormat, ILenum DestFormat, ILenum SrcType, ILenum DestType, ILpal *SrcPal, void *Buffer)
+ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILsizei SizeOfData, ILenum SrcFormat, ILenum DestFormat, ILenum SrcType, ILenum DestType, ILpal *SrcPal, void *Buffer)
 {
 	//static const	ILfloat LumFactor[3] = { 0.299f, 0.587f, 0.114f };  // Used for conversion to luminance
 	//static const	ILfloat LumFactor[3] = { 0.3086f, 0.6094f, 0.0820f };  // http://www.sgi.com/grafica/matrix/index.html
 	static const	ILfloat LumFactor[3] = { 0.212671f, 0.715160f, 0.072169f };  // http://www.inforamp.net/~poynton/ and libpng's libpng.txt
+	static const	ILfloat LumFactorBgr[3] = { LumFactor[2], LumFactor[1], LumFactor[0] };
+	const iConvKernels *Kernels = iGetConvKernels();  // 8-bit cases
 
 	ILubyte		*NewData = NULL;
-	ILuint		i, j, c, Size;
+	ILsizei		i, j, Size;
+	ILuint		c;
 	ILfloat		Resultf;
 	ILdouble	Resultd;
-	ILuint		NumPix;  // Really number of pixels * bpp.
+	ILsizei		NumPix;  // Really number of pixels * bpp.
 	ILuint		BpcDest;
 	void		*Data = NULL;
 	ILimage		*PalImage = NULL, *TempImage = NULL;
@@ -66,7 +87,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 		}
 		memcpy(NewData, Data, NumPix * BpcDest);
 		if (Data != Buffer)
-			ifree(Data);
+			ifree(context, Data);
 
 		return NewData;
 	}
@@ -96,7 +117,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 			// So that we do not delete the original palette or data.
 			PalImage->Pal.Palette = NULL;
 			PalImage->Data = NULL;
-			ilCloseImage(PalImage);
+			ilCloseImage(context, PalImage);
 			return NULL;
 		}
 
@@ -109,8 +130,8 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 		PalImage->Data = NULL;
 
 		// Clean up here.
-		ilCloseImage(PalImage);
-		ilCloseImage(TempImage);
+		ilCloseImage(context, PalImage);
+		ilCloseImage(context, TempImage);
 		return NewData;
 	}
 	
@@ -129,11 +150,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 						#ifdef ALTIVEC_GCC
 							abc2cba_byte((ILubyte*)Data,NumPix * BpcDest,NewData);
 						#else
-							for (i = 0; i < NumPix; i += 3) {
-								NewData[i] = ((ILubyte*)(Data))[i+2];
-								NewData[i+1] = ((ILubyte*)(Data))[i+1];
-								NewData[i+2] = ((ILubyte*)(Data))[i];
-							}
+							Kernels->SwapRB3((ILubyte*)Data, NewData, NumPix / 3);
 						#endif
 							break;
 						case IL_UNSIGNED_SHORT:
@@ -193,12 +210,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0, j = 0; i < NumPix; i += 3, j += 4) {
-								NewData[j] = ((ILubyte*)(Data))[i];
-								NewData[j+1] = ((ILubyte*)(Data))[i+1];
-								NewData[j+2] = ((ILubyte*)(Data))[i+2];
-								NewData[j+3] = UCHAR_MAX;
-							}
+							Kernels->Expand3To4((ILubyte*)Data, NewData, NumPix / 3, IL_FALSE);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -245,12 +257,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0, j = 0; i < NumPix; i += 3, j += 4) {
-								NewData[j] = ((ILubyte*)(Data))[i+2];
-								NewData[j+1] = ((ILubyte*)(Data))[i+1];
-								NewData[j+2] = ((ILubyte*)(Data))[i];
-								NewData[j+3] = UCHAR_MAX;
-							}
+							Kernels->Expand3To4((ILubyte*)Data, NewData, NumPix / 3, IL_TRUE);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -298,13 +305,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0; i < Size; i++) {
-								Resultf = 0;
-								for (c = 0; c < 3; c++) {
-									Resultf += ((ILubyte*)(Data))[i * 3 + c] * LumFactor[c];
-								}
-								NewData[i] = (ILubyte)Resultf;
-							}
+							Kernels->Luminance((ILubyte*)Data, NewData, Size, 3, LumFactor);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -324,7 +325,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 								for (c = 0; c < 3; c++) {
 									Resultf += ((ILuint*)(Data))[i * 3 + c] * LumFactor[c];
 								}
-								((ILuint*)(NewData))[i] = (ILuint)Resultf;
+								((ILuint*)(NewData))[i] = iClampCast<ILuint>(Resultf);
 							}
 							break;
 						case IL_FLOAT:
@@ -384,7 +385,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 								for (c = 0; c < 3; c++) {
 									Resultf += ((ILuint*)(Data))[i * 3 + c] * LumFactor[c];
 								}
-								((ILuint*)(NewData))[i*2] = (ILuint)Resultf;
+								((ILuint*)(NewData))[i*2] = iClampCast<ILuint>(Resultf);
 								((ILuint*)(NewData))[i*2+1] = UINT_MAX;
 							}
 							break;
@@ -420,7 +421,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 				default:
 					ilSetError(context, IL_INVALID_CONVERSION);
 					if (Data != Buffer)
-						ifree(Data);
+						ifree(context, Data);
 					return NULL;
 			}
 			break;
@@ -438,12 +439,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 						#ifdef ALTIVEC_GCC
 							abcd2cbad_byte(NewData,context->impl->iCurImage->SizeOfData,NewData);
 						#else
-							for (i = 0; i < NumPix; i += 4) {
-								NewData[i] = ((ILubyte*)(Data))[i+2];
-								NewData[i+1] = ((ILubyte*)(Data))[i+1];
-								NewData[i+2] = ((ILubyte*)(Data))[i];
-								NewData[i+3] = ((ILubyte*)(Data))[i+3];
-							}
+							Kernels->SwapRB4((ILubyte*)Data, NewData, NumPix / 4);
 						#endif
 							break;
 						case IL_UNSIGNED_SHORT:
@@ -507,11 +503,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0, j = 0; i < NumPix; i += 4, j += 3) {
-								NewData[j] = ((ILubyte*)(Data))[i];
-								NewData[j+1] = ((ILubyte*)(Data))[i+1];
-								NewData[j+2] = ((ILubyte*)(Data))[i+2];
-							}
+							Kernels->Shrink4To3((ILubyte*)Data, NewData, NumPix / 4, IL_FALSE);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -554,11 +546,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0, j = 0; i < NumPix; i += 4, j += 3) {
-								NewData[j] = ((ILubyte*)(Data))[i+2];
-								NewData[j+1] = ((ILubyte*)(Data))[i+1];
-								NewData[j+2] = ((ILubyte*)(Data))[i];
-							}
+							Kernels->Shrink4To3((ILubyte*)Data, NewData, NumPix / 4, IL_TRUE);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -602,13 +590,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0; i < Size; i++) {
-								Resultf = 0.0f;
-								for (c = 0; c < 3; c++) {
-									Resultf += ((ILubyte*)(Data))[i * 4 + c] * LumFactor[c];
-								}
-								NewData[i] = (ILubyte)Resultf;
-							}
+							Kernels->Luminance((ILubyte*)Data, NewData, Size, 4, LumFactor);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -628,7 +610,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 								for (c = 0; c < 3; c++) {
 									Resultd += ((ILuint*)(Data))[i * 4 + c] * LumFactor[c];
 								}
-								((ILuint*)(NewData))[i] = (ILuint)Resultd;
+								((ILuint*)(NewData))[i] = iClampCast<ILuint>(Resultd);
 							}
 							break;
 						case IL_FLOAT:
@@ -688,7 +670,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 								for (c = 0; c < 3; c++) {
 									Resultd += ((ILuint*)(Data))[i * 2 + c] * LumFactor[c];
 								}
-								((ILuint*)(NewData))[i] = (ILuint)Resultd;
+								((ILuint*)(NewData))[i] = iClampCast<ILuint>(Resultd);
 								((ILuint*)(NewData))[i+1] = ((ILuint*)(Data))[i * 2 + 3];
 							}
 							break;
@@ -756,7 +738,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 				default:
 					ilSetError(context, IL_INVALID_CONVERSION);
 					if (Data != Buffer)
-						ifree(Data);
+						ifree(context, Data);
 					return NULL;
 			}
 			break;
@@ -774,11 +756,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 						#ifdef ALTIVEC_GCC
 							abc2cba_byte(((ILubyte*)Data),NumPix * BpcDest,NewData);
 						#else
-							for (i = 0; i < NumPix; i += 3) {
-								NewData[i] = ((ILubyte*)(Data))[i+2];
-								NewData[i+1] = ((ILubyte*)(Data))[i+1];
-								NewData[i+2] = ((ILubyte*)(Data))[i];
-							}
+							Kernels->SwapRB3((ILubyte*)Data, NewData, NumPix / 3);
 						#endif
 							break;
 						case IL_UNSIGNED_SHORT:
@@ -838,12 +816,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0, j = 0; i < NumPix; i += 3, j += 4) {
-								NewData[j] = ((ILubyte*)(Data))[i];
-								NewData[j+1] = ((ILubyte*)(Data))[i+1];
-								NewData[j+2] = ((ILubyte*)(Data))[i+2];
-								NewData[j+3] = UCHAR_MAX;
-							}
+							Kernels->Expand3To4((ILubyte*)Data, NewData, NumPix / 3, IL_FALSE);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -890,12 +863,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0, j = 0; i < NumPix; i += 3, j += 4) {
-								NewData[j] = ((ILubyte*)(Data))[i+2];
-								NewData[j+1] = ((ILubyte*)(Data))[i+1];
-								NewData[j+2] = ((ILubyte*)(Data))[i];
-								NewData[j+3] = UCHAR_MAX;
-							}
+							Kernels->Expand3To4((ILubyte*)Data, NewData, NumPix / 3, IL_TRUE);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -943,13 +911,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0; i < Size; i++) {
-								Resultf = 0.0f;  j = 2;
-								for (c = 0; c < 3; c++, j--) {
-									Resultf += ((ILubyte*)(Data))[i * 3 + c] * LumFactor[j];
-								}
-								NewData[i] = (ILubyte)Resultf;
-							}
+							Kernels->Luminance((ILubyte*)Data, NewData, Size, 3, LumFactorBgr);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -969,7 +931,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 								for (c = 0; c < 3; c++, j--) {
 									Resultd += ((ILuint*)(Data))[i * 3 + c] * LumFactor[j];
 								}
-								((ILuint*)(NewData))[i] = (ILuint)Resultd;
+								((ILuint*)(NewData))[i] = iClampCast<ILuint>(Resultd);
 							}
 							break;
 						case IL_FLOAT:
@@ -1029,7 +991,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 								for (c = 0; c < 3; c++) {
 									Resultf += ((ILuint*)(Data))[i * 3 + c] * LumFactor[c];
 								}
-								((ILuint*)(NewData))[i*2] = (ILuint)Resultf;
+								((ILuint*)(NewData))[i*2] = iClampCast<ILuint>(Resultf);
 								((ILuint*)(NewData))[i*2+1] = UINT_MAX;
 							}
 							break;
@@ -1065,7 +1027,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 				default:
 					ilSetError(context, IL_INVALID_CONVERSION);
 					if (Data != Buffer)
-						ifree(Data);
+						ifree(context, Data);
 					return NULL;
 			}
 			break;
@@ -1083,12 +1045,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 						#ifdef ALTIVEC_GCC
 							abcd2cbad_byte(NewData,context->impl->iCurImage->SizeOfData,NewData);
 						#else
-							for (i = 0; i < NumPix; i += 4) {
-								NewData[i] = ((ILubyte*)(Data))[i+2];
-								NewData[i+1] = ((ILubyte*)(Data))[i+1];
-								NewData[i+2] = ((ILubyte*)(Data))[i];
-								NewData[i+3] = ((ILubyte*)(Data))[i+3];
-							}
+							Kernels->SwapRB4((ILubyte*)Data, NewData, NumPix / 4);
 						#endif
 							break;
 						case IL_UNSIGNED_SHORT:
@@ -1152,11 +1109,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0, j = 0; i < NumPix; i += 4, j += 3) {
-								NewData[j] = ((ILubyte*)(Data))[i];
-								NewData[j+1] = ((ILubyte*)(Data))[i+1];
-								NewData[j+2] = ((ILubyte*)(Data))[i+2];
-							}
+							Kernels->Shrink4To3((ILubyte*)Data, NewData, NumPix / 4, IL_FALSE);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -1199,11 +1152,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0, j = 0; i < NumPix; i += 4, j += 3) {
-								NewData[j] = ((ILubyte*)(Data))[i+2];
-								NewData[j+1] = ((ILubyte*)(Data))[i+1];
-								NewData[j+2] = ((ILubyte*)(Data))[i];
-							}
+							Kernels->Shrink4To3((ILubyte*)Data, NewData, NumPix / 4, IL_TRUE);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -1247,13 +1196,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					{
 						case IL_UNSIGNED_BYTE:
 						case IL_BYTE:
-							for (i = 0; i < Size; i++) {
-								Resultf = 0.0f;  j = 2;
-								for (c = 0; c < 3; c++, j--) {
-									Resultf += ((ILubyte*)(Data))[i * 4 + c] * LumFactor[j];
-								}
-								NewData[i] = (ILubyte)Resultf;
-							}
+							Kernels->Luminance((ILubyte*)Data, NewData, Size, 4, LumFactorBgr);
 							break;
 						case IL_UNSIGNED_SHORT:
 						case IL_SHORT:
@@ -1273,7 +1216,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 								for (c = 0; c < 3; c++, j--) {
 									Resultd += ((ILuint*)(Data))[i * 4 + c] * LumFactor[j];
 								}
-								((ILuint*)(NewData))[i] = (ILuint)Resultd;
+								((ILuint*)(NewData))[i] = iClampCast<ILuint>(Resultd);
 							}
 							break;
 						case IL_FLOAT:
@@ -1333,7 +1276,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 								for (c = 0; c < 3; c++) {
 									Resultd += ((ILuint*)(Data))[i * 2 + c] * LumFactor[c];
 								}
-								((ILuint*)(NewData))[i] = (ILuint)Resultd;
+								((ILuint*)(NewData))[i] = iClampCast<ILuint>(Resultd);
 								((ILuint*)(NewData))[i+1] = ((ILuint*)(Data))[i * 2 + 3];
 							}
 							break;
@@ -1401,7 +1344,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 				default:
 					ilSetError(context, IL_INVALID_CONVERSION);
 					if (Data != Buffer)
-						ifree(Data);
+						ifree(context, Data);
 					return NULL;
 			}
 			break;
@@ -1566,7 +1509,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					NewData = (ILubyte*)ialloc(context, context->impl->iCurImage->SizeOfData);
 					NewImage->Pal.Palette = (ILubyte*)ialloc(context, 768);
 					if (NewData == NULL || NewImage->Pal.Palette) {
-						ifree(NewImage);
+						ifree(context, NewImage);
 						return IL_FALSE;
 					}
 
@@ -1585,7 +1528,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 				default:
 					ilSetError(context, IL_INVALID_CONVERSION);
 					if (Data != Buffer)
-						ifree(Data);
+						ifree(context, Data);
 					return NULL;
 			}
 			break;
@@ -1777,7 +1720,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					NewData = (ILubyte*)ialloc(context, context->impl->iCurImage->SizeOfData);
 					NewImage->Pal.Palette = (ILubyte*)ialloc(context, 768);
 					if (NewData == NULL || NewImage->Pal.Palette) {
-						ifree(NewImage);
+						ifree(context, NewImage);
 						return IL_FALSE;
 					}
 
@@ -1796,7 +1739,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 				default:
 					ilSetError(context, IL_INVALID_CONVERSION);
 					if (Data != Buffer)
-						ifree(Data);
+						ifree(context, Data);
 					return NULL;
 			}
 			break;
@@ -1929,7 +1872,7 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 					NewData = (ILubyte*)ialloc(context, context->impl->iCurImage->SizeOfData);
 					NewImage->Pal.Palette = (ILubyte*)ialloc(context, 768);
 					if (NewData == NULL || NewImage->Pal.Palette) {
-						ifree(NewImage);
+						ifree(context, NewImage);
 						return IL_FALSE;
 					}
 
@@ -1948,14 +1891,14 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 				default:
 					ilSetError(context, IL_INVALID_CONVERSION);
 					if (Data != Buffer)
-						ifree(Data);
+						ifree(context, Data);
 					return NULL;
 			}
 			break;
 	}
 
 	if (Data != Buffer)
-		ifree(Data);
+		ifree(context, Data);
 
 	return NewData;
 }
@@ -1965,9 +1908,10 @@ ILAPI void* ILAPIENTRY ilConvertBuffer(ILcontext* context, ILuint SizeOfData, IL
 //  This now converts better from lower bpp to higher bpp.  For example, when
 //  converting from 8 bpp to 16 bpp, if the value is 0xEC, the new value is 0xECEC
 //  instead of 0xEC00.
-void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcType, ILenum DestType, void *Buffer)
+void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILsizei SizeOfData, ILenum SrcType, ILenum DestType, void *Buffer)
 {
-	ILuint		BpcSrc, BpcDest, Size, i;
+	ILuint		BpcSrc, BpcDest;
+	ILsizei		Size, i;
 	ILubyte		*NewData, *BytePtr;
 	ILushort	*ShortPtr;
 	ILuint		*IntPtr;
@@ -2004,9 +1948,7 @@ void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcT
 			{
 				case IL_UNSIGNED_SHORT:
 				case IL_SHORT:
-					for (i = 0; i < Size; i++) {
-						BytePtr[i] = ((ILushort*)Buffer)[i] >> 8;
-					}
+					iGetConvKernels()->ShortToByte((ILushort*)Buffer, BytePtr, Size);
 					break;
 				case IL_UNSIGNED_INT:
 				case IL_INT:
@@ -2015,14 +1957,13 @@ void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcT
 					}
 					break;
 				case IL_FLOAT:
-					for (i = 0; i < Size; i++) {
-						#if CLAMP_FLOATS
-							tempFloat = IL_CLAMP(((ILfloat*)Buffer)[i]);
-							BytePtr[i] = (ILubyte)(tempFloat * UCHAR_MAX);
-						#else
+					#if CLAMP_FLOATS
+						iGetConvKernels()->FloatToByte((ILfloat*)Buffer, BytePtr, Size);
+					#else
+						for (i = 0; i < Size; i++) {
 							BytePtr[i] = (ILubyte)(((ILfloat*)Buffer)[i] * UCHAR_MAX);
-						#endif
-					}
+						}
+					#endif
 					break;
 				case IL_HALF:
 					for (i = 0; i < Size; i++) {
@@ -2056,9 +1997,7 @@ void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcT
 			{
 				case IL_UNSIGNED_BYTE:
 				case IL_BYTE:
-					for (i = 0; i < Size; i++) {
-						ShortPtr[i] = (((ILubyte*)Buffer)[i] << 8) | ((ILubyte*)Buffer)[i];
-					}
+					iGetConvKernels()->ByteToShort((ILubyte*)Buffer, ShortPtr, Size);
 					break;
 				case IL_UNSIGNED_INT:
 				case IL_INT:
@@ -2123,9 +2062,9 @@ void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcT
 					for (i = 0; i < Size; i++) {
 						#if CLAMP_FLOATS
 							tempFloat = IL_CLAMP(((ILfloat*)Buffer)[i]);
-							IntPtr[i] = (ILuint)(tempFloat * UINT_MAX);
+							IntPtr[i] = iClampCast<ILuint>(tempFloat * UINT_MAX);
 						#else
-							IntPtr[i] = (ILuint)( ((ILfloat*)Buffer)[i] * UINT_MAX);
+							IntPtr[i] = iClampCast<ILuint>(((ILfloat*)Buffer)[i] * UINT_MAX);
 						#endif
 					}
 					break;
@@ -2134,10 +2073,10 @@ void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcT
 						#if CLAMP_FLOATS
 							*((ILuint*)&tempFloat) = ilHalfToFloat(((ILushort*)Buffer)[i]);
 							tempFloat = IL_CLAMP(tempFloat);
-							IntPtr[i] = (ILuint)(tempFloat * UINT_MAX);
+							IntPtr[i] = iClampCast<ILuint>(tempFloat * UINT_MAX);
 						#else
 						*((ILuint*)&tempFloat) = ilHalfToFloat(((ILushort*)Buffer)[i]);
-						IntPtr[i] = (ILuint)(tempFloat * UINT_MAX);
+						IntPtr[i] = iClampCast<ILuint>(tempFloat * UINT_MAX);
 						#endif
 					}
 					break;
@@ -2145,9 +2084,9 @@ void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcT
 					for (i = 0; i < Size; i++) {
 						#if CLAMP_DOUBLES
 							tempDouble = IL_CLAMP(((ILdouble*)Buffer)[i]);
-							IntPtr[i] = (ILuint)(tempDouble * UINT_MAX);
+							IntPtr[i] = iClampCast<ILuint>(tempDouble * UINT_MAX);
 						#else
-							IntPtr[i] = (ILuint)( ((ILdouble*)Buffer)[i] * UINT_MAX);
+							IntPtr[i] = iClampCast<ILuint>(((ILdouble*)Buffer)[i] * UINT_MAX);
 						#endif
 					}
 					break;
@@ -2160,9 +2099,7 @@ void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcT
 			switch (SrcType)
 			{
 				case IL_UNSIGNED_BYTE:
-					for (i = 0; i < Size; i++) {
-						FloatPtr[i] = ((ILubyte*)Buffer)[i] / (ILfloat)UCHAR_MAX;
-					}
+					iGetConvKernels()->ByteToFloat((ILubyte*)Buffer, FloatPtr, Size);
 					break;
 				case IL_BYTE:
 					for (i = 0; i < Size; i++) {
@@ -2313,3 +2250,465 @@ void* ILAPIENTRY iSwitchTypes(ILcontext* context, ILuint SizeOfData, ILenum SrcT
 
 
 
+
+//
+// Conversion of direct-colour pixels without heap buffers, used by
+//  ilConvertImage.  Values change type exactly as in iSwitchTypes, and
+//  luminance is formed in the destination type exactly as in ilConvertBuffer,
+//  so the results are the same as going through the two intermediate buffers.
+//
+
+// Storage for IL_HALF values, so that they can be told apart from IL_UNSIGNED_SHORT.
+struct iHalf { ILushort Bits; };
+
+// Integer destination types: the scale used for floating-point sources.
+template <typename D> struct iTypeMax;
+template <> struct iTypeMax<ILubyte>  { static const int Value = UCHAR_MAX; };
+template <> struct iTypeMax<ILushort> { static const int Value = USHRT_MAX; };
+template <> struct iTypeMax<ILuint>   { static const unsigned int Value = UINT_MAX; };
+
+static inline ILfloat iHalfValue(iHalf v)
+{
+	ILfloat	Value;
+	ILuint	Bits = ilHalfToFloat(v.Bits);
+
+	memcpy(&Value, &Bits, sizeof(Value));
+	return Value;
+}
+
+// Integer to integer keeps the most significant bits, or repeats the source
+//  bytes to fill the wider type.
+template <typename D> static inline D iConvValue(ILubyte v);
+template <> inline ILubyte  iConvValue<ILubyte>(ILubyte v)  { return v; }
+template <> inline ILushort iConvValue<ILushort>(ILubyte v) { return (v << 8) | v; }
+template <> inline ILuint   iConvValue<ILuint>(ILubyte v)   { return ((ILuint)v << 24) | (v << 16) | (v << 8) | v; }
+template <> inline ILfloat  iConvValue<ILfloat>(ILubyte v)  { return v / (ILfloat)UCHAR_MAX; }
+template <> inline ILdouble iConvValue<ILdouble>(ILubyte v) { return v / (ILdouble)UCHAR_MAX; }
+
+template <typename D> static inline D iConvValue(ILbyte v)  { return iConvValue<D>((ILubyte)v); }
+template <> inline ILfloat  iConvValue<ILfloat>(ILbyte v)   { return v / (ILfloat)UCHAR_MAX; }
+template <> inline ILdouble iConvValue<ILdouble>(ILbyte v)  { return v / (ILdouble)UCHAR_MAX; }
+
+template <typename D> static inline D iConvValue(ILushort v);
+template <> inline ILubyte  iConvValue<ILubyte>(ILushort v)  { return v >> 8; }
+template <> inline ILushort iConvValue<ILushort>(ILushort v) { return v; }
+template <> inline ILuint   iConvValue<ILuint>(ILushort v)   { return ((ILuint)v << 16) | v; }
+template <> inline ILfloat  iConvValue<ILfloat>(ILushort v)  { return v / (ILfloat)USHRT_MAX; }
+template <> inline ILdouble iConvValue<ILdouble>(ILushort v) { return v / (ILdouble)USHRT_MAX; }
+
+template <typename D> static inline D iConvValue(ILshort v)  { return iConvValue<D>((ILushort)v); }
+template <> inline ILfloat  iConvValue<ILfloat>(ILshort v)   { return v / (ILfloat)USHRT_MAX; }
+template <> inline ILdouble iConvValue<ILdouble>(ILshort v)  { return v / (ILdouble)USHRT_MAX; }
+
+template <typename D> static inline D iConvValue(ILuint v);
+template <> inline ILubyte  iConvValue<ILubyte>(ILuint v)  { return v >> 24; }
+template <> inline ILushort iConvValue<ILushort>(ILuint v) { return v >> 16; }
+template <> inline ILuint   iConvValue<ILuint>(ILuint v)   { return v; }
+template <> inline ILfloat  iConvValue<ILfloat>(ILuint v)  { return (ILfloat)v / (ILfloat)UINT_MAX; }
+template <> inline ILdouble iConvValue<ILdouble>(ILuint v) { return v / (ILdouble)UINT_MAX; }
+
+template <typename D> static inline D iConvValue(ILint v)  { return iConvValue<D>((ILuint)v); }
+template <> inline ILfloat  iConvValue<ILfloat>(ILint v)   { return (ILfloat)v / (ILfloat)UINT_MAX; }
+template <> inline ILdouble iConvValue<ILdouble>(ILint v)  { return v / (ILdouble)UINT_MAX; }
+
+// Floating point to integer clamps to [0, 1] first (CLAMP_FLOATS and friends).
+template <typename D> static inline D iConvValue(ILfloat v)
+{
+	ILfloat tempFloat = IL_CLAMP(v);
+	return iClampCast<D>(tempFloat * iTypeMax<D>::Value);
+}
+template <> inline ILfloat  iConvValue<ILfloat>(ILfloat v)  { return v; }
+template <> inline ILdouble iConvValue<ILdouble>(ILfloat v) { return v; }
+
+template <typename D> static inline D iConvValue(ILdouble v)
+{
+	ILdouble tempDouble = IL_CLAMP(v);
+	return iClampCast<D>(tempDouble * iTypeMax<D>::Value);
+}
+template <> inline ILfloat  iConvValue<ILfloat>(ILdouble v)  { return (ILfloat)v; }
+template <> inline ILdouble iConvValue<ILdouble>(ILdouble v) { return v; }
+
+template <typename D> static inline D iConvValue(iHalf v)   { return iConvValue<D>(iHalfValue(v)); }
+template <> inline ILfloat  iConvValue<ILfloat>(iHalf v)    { return iHalfValue(v); }
+template <> inline ILdouble iConvValue<ILdouble>(iHalf v)   { return iHalfValue(v); }
+
+
+// Where each destination channel comes from
+enum { I_FROM_LUM = -1, I_FROM_OPAQUE = -2 };
+
+typedef struct iPixelMap
+{
+	ILint	From[4];         // Source channel, I_FROM_LUM or I_FROM_OPAQUE
+	ILboolean LumDouble;
+} iPixelMap;
+
+// Pixels converted per pass through the scratch buffer of iConvertPixels
+#define IL_CONV_CHUNK 256
+
+
+template <typename S, typename D>
+static void iConvertValuesT(const void *Src, void *Dest, ILsizei Num)
+{
+	const S	*SrcPtr = (const S*)Src;
+	D		*DestPtr = (D*)Dest;
+	ILsizei	i;
+
+	for (i = 0; i < Num; i++)
+		DestPtr[i] = iConvValue<D>(SrcPtr[i]);
+}
+
+template <typename S>
+static void iConvertValuesFrom(const void *Src, void *Dest, ILenum DestType, ILsizei Num)
+{
+	switch (DestType)
+	{
+		case IL_UNSIGNED_BYTE:
+		case IL_BYTE:
+			iConvertValuesT<S, ILubyte>(Src, Dest, Num);
+			break;
+		case IL_UNSIGNED_SHORT:
+		case IL_SHORT:
+			iConvertValuesT<S, ILushort>(Src, Dest, Num);
+			break;
+		case IL_UNSIGNED_INT:
+		case IL_INT:
+			iConvertValuesT<S, ILuint>(Src, Dest, Num);
+			break;
+		case IL_FLOAT:
+			iConvertValuesT<S, ILfloat>(Src, Dest, Num);
+			break;
+		case IL_DOUBLE:
+			iConvertValuesT<S, ILdouble>(Src, Dest, Num);
+			break;
+	}
+}
+
+// Changes the type of Num values, using the same kernels as iSwitchTypes
+//  where it does.  Src and Dest must not overlap.
+static void iConvertValues(const void *Src, ILenum SrcType, void *Dest, ILenum DestType, ILsizei Num)
+{
+	const iConvKernels *Kernels = iGetConvKernels();
+	ILuint SrcBpc = ilGetBpcType(SrcType), DestBpc = ilGetBpcType(DestType);
+
+	if (SrcBpc == 1 && DestBpc == 2) {
+		Kernels->ByteToShort((const ILubyte*)Src, (ILushort*)Dest, Num);
+		return;
+	}
+	if (SrcBpc == 2 && DestBpc == 1 && SrcType != IL_HALF) {
+		Kernels->ShortToByte((const ILushort*)Src, (ILubyte*)Dest, Num);
+		return;
+	}
+	if (SrcType == IL_UNSIGNED_BYTE && DestType == IL_FLOAT) {
+		Kernels->ByteToFloat((const ILubyte*)Src, (ILfloat*)Dest, Num);
+		return;
+	}
+#if CLAMP_FLOATS
+	if (SrcType == IL_FLOAT && DestBpc == 1) {
+		Kernels->FloatToByte((const ILfloat*)Src, (ILubyte*)Dest, Num);
+		return;
+	}
+#endif
+
+	switch (SrcType)
+	{
+		case IL_UNSIGNED_BYTE:
+			iConvertValuesFrom<ILubyte>(Src, Dest, DestType, Num);
+			break;
+		case IL_BYTE:
+			iConvertValuesFrom<ILbyte>(Src, Dest, DestType, Num);
+			break;
+		case IL_UNSIGNED_SHORT:
+			iConvertValuesFrom<ILushort>(Src, Dest, DestType, Num);
+			break;
+		case IL_SHORT:
+			iConvertValuesFrom<ILshort>(Src, Dest, DestType, Num);
+			break;
+		case IL_UNSIGNED_INT:
+			iConvertValuesFrom<ILuint>(Src, Dest, DestType, Num);
+			break;
+		case IL_INT:
+			iConvertValuesFrom<ILint>(Src, Dest, DestType, Num);
+			break;
+		case IL_FLOAT:
+			iConvertValuesFrom<ILfloat>(Src, Dest, DestType, Num);
+			break;
+		case IL_DOUBLE:
+			iConvertValuesFrom<ILdouble>(Src, Dest, DestType, Num);
+			break;
+		case IL_HALF:
+			iConvertValuesFrom<iHalf>(Src, Dest, DestType, Num);
+			break;
+	}
+}
+
+
+// The weighted sum ilConvertBuffer uses, over the source channels in memory
+//  order.  The products are formed as there, summed in double precision
+//  where ilConvertBuffer does, and clamped the same way.
+template <typename D> static inline D iLumValue(const D *In, const ILfloat *Factors, ILboolean Double)
+{
+	ILfloat		Resultf = 0;
+	ILdouble	Resultd = 0;
+	ILuint		c;
+
+	if (Double) {
+		for (c = 0; c < 3; c++)
+			Resultd += In[c] * Factors[c];
+		return iClampCast<D>(Resultd);
+	}
+	for (c = 0; c < 3; c++)
+		Resultf += In[c] * Factors[c];
+	return iClampCast<D>(Resultf);
+}
+
+template <typename D> static inline D iOpaqueValue();
+template <> inline ILubyte  iOpaqueValue<ILubyte>()  { return UCHAR_MAX; }
+template <> inline ILushort iOpaqueValue<ILushort>() { return USHRT_MAX; }
+template <> inline ILuint   iOpaqueValue<ILuint>()   { return UINT_MAX; }
+template <> inline ILfloat  iOpaqueValue<ILfloat>()  { return 1.0f; }
+template <> inline ILdouble iOpaqueValue<ILdouble>() { return 1.0; }
+
+// Rearranges the channels of NumPix pixels of type D.  Every pixel is read
+//  completely before it is written, so Dest may be Src when DestBpp is not
+//  larger than SrcBpp.
+template <typename D, ILuint SrcBpp, ILuint DestBpp>
+static void iMapPixelsT(const void *Src, void *Dest, ILsizei NumPix, const iPixelMap *Map, const ILfloat *Factors)
+{
+	const D	*SrcPtr = (const D*)Src;
+	D		*DestPtr = (D*)Dest;
+	D		In[SrcBpp + 2];  // The source channels, then luminance and full opacity
+	ILuint	From[DestBpp], c;
+
+	for (c = 0; c < DestBpp; c++)
+		From[c] = Map->From[c] >= 0 ? Map->From[c] : (Map->From[c] == I_FROM_LUM ? SrcBpp : SrcBpp + 1);
+	In[SrcBpp] = 0;
+	In[SrcBpp + 1] = iOpaqueValue<D>();
+
+	for (; NumPix > 0; NumPix--, SrcPtr += SrcBpp, DestPtr += DestBpp) {
+		for (c = 0; c < SrcBpp; c++)
+			In[c] = SrcPtr[c];
+		if (SrcBpp >= 3 && DestBpp <= 2)
+			In[SrcBpp] = iLumValue<D>(In, Factors, Map->LumDouble);
+		for (c = 0; c < DestBpp; c++)
+			DestPtr[c] = In[From[c]];
+	}
+}
+
+#define IL_MAP_CASE(s, d) case s * 8 + d:  iMapPixelsT<D, s, d>(Src, Dest, NumPix, Map, Factors);  break;
+
+template <typename D>
+static void iMapPixels(const void *Src, ILuint SrcBpp, void *Dest, ILuint DestBpp, ILsizei NumPix, const iPixelMap *Map, const ILfloat *Factors)
+{
+	switch (SrcBpp * 8 + DestBpp)
+	{
+		IL_MAP_CASE(3, 3)  IL_MAP_CASE(3, 4)  IL_MAP_CASE(3, 1)
+		IL_MAP_CASE(4, 3)  IL_MAP_CASE(4, 4)  IL_MAP_CASE(4, 1)
+		IL_MAP_CASE(1, 3)  IL_MAP_CASE(1, 4)  IL_MAP_CASE(1, 2)
+		IL_MAP_CASE(2, 3)  IL_MAP_CASE(2, 4)  IL_MAP_CASE(2, 1)
+	}
+}
+
+#undef IL_MAP_CASE
+
+// Channel layout of the formats iConvertPixels handles: the positions of red,
+//  green, blue and alpha, or of luminance (in Red) and alpha.  -1 if absent.
+static ILboolean iChannelLayout(ILenum Format, ILint *Red, ILint *Green, ILint *Blue, ILint *Alpha)
+{
+	*Green = *Blue = *Alpha = -1;
+	switch (Format)
+	{
+		case IL_RGB:  *Red = 0; *Green = 1; *Blue = 2; break;
+		case IL_RGBA: *Red = 0; *Green = 1; *Blue = 2; *Alpha = 3; break;
+		case IL_BGR:  *Red = 2; *Green = 1; *Blue = 0; break;
+		case IL_BGRA: *Red = 2; *Green = 1; *Blue = 0; *Alpha = 3; break;
+		case IL_LUMINANCE:        *Red = 0; break;
+		case IL_LUMINANCE_ALPHA:  *Red = 0; *Alpha = 1; break;
+		default:
+			return IL_FALSE;
+	}
+	return IL_TRUE;
+}
+
+static ILboolean iTypeSupported(ILenum Type)
+{
+	switch (Type)
+	{
+		case IL_UNSIGNED_BYTE:
+		case IL_BYTE:
+		case IL_UNSIGNED_SHORT:
+		case IL_SHORT:
+		case IL_UNSIGNED_INT:
+		case IL_INT:
+		case IL_FLOAT:
+		case IL_DOUBLE:
+			return IL_TRUE;
+	}
+	return IL_FALSE;
+}
+
+//! Returns whether iConvertPixels can do this conversion.  Colour-indexed and
+//  alpha-only images, IL_HALF destinations and colour to luminance-alpha
+//  (whose loops in ilConvertBuffer differ from each other) are left to
+//  ilConvertBuffer.
+ILboolean iCanConvertPixels(ILenum SrcFormat, ILenum SrcType, ILenum DestFormat, ILenum DestType)
+{
+	ILint r, g, b, a;
+
+	if (!iChannelLayout(SrcFormat, &r, &g, &b, &a) || !iChannelLayout(DestFormat, &r, &g, &b, &a))
+		return IL_FALSE;
+	if (DestFormat == IL_LUMINANCE_ALPHA && SrcFormat != IL_LUMINANCE && SrcFormat != IL_LUMINANCE_ALPHA)
+		return IL_FALSE;
+	return (iTypeSupported(SrcType) || SrcType == IL_HALF) && iTypeSupported(DestType);
+}
+
+// 8-bit conversions with a vector kernel.  The ones used in place
+//  (iConvKernels documents which) never write ahead of what they have read.
+static ILboolean iConvertBytes(const ILubyte *Src, ILenum SrcFormat, ILubyte *Dest, ILenum DestFormat, ILsizei NumPix, const ILfloat *Factors)
+{
+	const iConvKernels *Kernels = iGetConvKernels();
+	ILboolean SrcBgr = SrcFormat == IL_BGR || SrcFormat == IL_BGRA;
+	ILboolean DestBgr = DestFormat == IL_BGR || DestFormat == IL_BGRA;
+	ILuint SrcBpp = ilGetBppFormat(SrcFormat), DestBpp = ilGetBppFormat(DestFormat);
+
+	if (SrcFormat == IL_LUMINANCE || SrcFormat == IL_LUMINANCE_ALPHA)
+		return IL_FALSE;
+
+	if (DestFormat == IL_LUMINANCE) {
+		Kernels->Luminance(Src, Dest, NumPix, SrcBpp, Factors);
+		return IL_TRUE;
+	}
+
+	if (SrcBpp == 3 && DestBpp == 3)
+		Kernels->SwapRB3(Src, Dest, NumPix);
+	else if (SrcBpp == 4 && DestBpp == 4)
+		Kernels->SwapRB4(Src, Dest, NumPix);
+	else if (SrcBpp == 3)
+		Kernels->Expand3To4(Src, Dest, NumPix, SrcBgr != DestBgr);
+	else
+		Kernels->Shrink4To3(Src, Dest, NumPix, SrcBgr != DestBgr);
+	return IL_TRUE;
+}
+
+// Changes the format of NumPix pixels that already have the destination type.
+static void iConvertFormat(const void *Src, ILenum SrcFormat, void *Dest, ILenum DestFormat, ILenum DestType,
+							ILsizei NumPix, const iPixelMap *Map, const ILfloat *Factors)
+{
+	ILuint SrcBpp = ilGetBppFormat(SrcFormat), DestBpp = ilGetBppFormat(DestFormat);
+
+	if (SrcFormat == DestFormat) {
+		if (Src != Dest)
+			memcpy(Dest, Src, NumPix * DestBpp * ilGetBpcType(DestType));
+		return;
+	}
+
+	switch (DestType)
+	{
+		case IL_UNSIGNED_BYTE:
+		case IL_BYTE:
+			if (!iConvertBytes((const ILubyte*)Src, SrcFormat, (ILubyte*)Dest, DestFormat, NumPix, Factors))
+				iMapPixels<ILubyte>(Src, SrcBpp, Dest, DestBpp, NumPix, Map, Factors);
+			break;
+		case IL_UNSIGNED_SHORT:
+		case IL_SHORT:
+			iMapPixels<ILushort>(Src, SrcBpp, Dest, DestBpp, NumPix, Map, Factors);
+			break;
+		case IL_UNSIGNED_INT:
+		case IL_INT:
+			iMapPixels<ILuint>(Src, SrcBpp, Dest, DestBpp, NumPix, Map, Factors);
+			break;
+		case IL_FLOAT:
+			iMapPixels<ILfloat>(Src, SrcBpp, Dest, DestBpp, NumPix, Map, Factors);
+			break;
+		case IL_DOUBLE:
+			iMapPixels<ILdouble>(Src, SrcBpp, Dest, DestBpp, NumPix, Map, Factors);
+			break;
+	}
+}
+
+//! Converts NumPix pixels without intermediate buffers.  Dest may be the same
+//  as Src if the destination pixels are not larger than the source pixels.
+//  The type is changed a few hundred pixels at a time in a buffer on the
+//  stack, and the format as those pixels are written out.  iCanConvertPixels
+//  must have accepted the conversion.
+void iConvertPixels(const void *Src, ILenum SrcFormat, ILenum SrcType, void *Dest, ILenum DestFormat, ILenum DestType, ILsizei NumPix)
+{
+	// Same as in ilConvertBuffer
+	static const ILfloat LumFactor[3] = { 0.212671f, 0.715160f, 0.072169f };
+	ILdouble	Scratch[IL_CONV_CHUNK * 4];  // Room for 4 doubles per pixel
+	iPixelMap	Map;
+	ILint		SrcRed, SrcGreen, SrcBlue, SrcAlpha;
+	ILint		DestRed, DestGreen, DestBlue, DestAlpha;
+	ILboolean	SrcColour, DestColour, MoveFirst;
+	ILfloat		Factors[3];
+	ILuint		SrcBpp, DestBpp, SrcPixSize, DestPixSize;
+	ILenum		MoveType;
+	ILsizei		Num;
+
+	iChannelLayout(SrcFormat, &SrcRed, &SrcGreen, &SrcBlue, &SrcAlpha);
+	iChannelLayout(DestFormat, &DestRed, &DestGreen, &DestBlue, &DestAlpha);
+	SrcColour = SrcGreen >= 0;
+	DestColour = DestGreen >= 0;
+	SrcBpp = ilGetBppFormat(SrcFormat);
+	DestBpp = ilGetBppFormat(DestFormat);
+
+	// ilConvertBuffer sums in single precision for these, double otherwise.
+	Map.LumDouble = !(DestType == IL_UNSIGNED_BYTE || DestType == IL_BYTE || DestType == IL_UNSIGNED_SHORT ||
+		DestType == IL_SHORT || (SrcFormat == IL_RGB && DestType != IL_DOUBLE));
+
+	// Luminance factors in source memory order
+	if (SrcColour && !DestColour) {
+		Factors[SrcRed] = LumFactor[0];
+		Factors[SrcGreen] = LumFactor[1];
+		Factors[SrcBlue] = LumFactor[2];
+	}
+
+	if (DestColour) {
+		Map.From[DestRed] = SrcRed;
+		Map.From[DestGreen] = SrcColour ? SrcGreen : SrcRed;
+		Map.From[DestBlue] = SrcColour ? SrcBlue : SrcRed;
+	}
+	else
+		Map.From[DestRed] = SrcColour ? I_FROM_LUM : SrcRed;
+	if (DestAlpha >= 0)
+		Map.From[DestAlpha] = SrcAlpha >= 0 ? SrcAlpha : I_FROM_OPAQUE;
+
+	// Same type: only the channels move.
+	if (SrcType == DestType) {
+		iConvertFormat(Src, SrcFormat, Dest, DestFormat, DestType, NumPix, &Map, &Factors[0]);
+		return;
+	}
+
+	// Channels that are only dropped or moved can be dealt with before a
+	//  widening type change, so that fewer and smaller values are handled.
+	//  Luminance has to be summed in the destination type, as ilConvertBuffer
+	//  does.
+	MoveFirst = DestBpp < SrcBpp && !(SrcColour && !DestColour) && ilGetBpcType(DestType) > ilGetBpcType(SrcType);
+	switch (ilGetBpcType(SrcType))
+	{
+		case 1:  MoveType = IL_UNSIGNED_BYTE;  break;
+		case 2:  MoveType = IL_UNSIGNED_SHORT;  break;
+		case 4:  MoveType = IL_UNSIGNED_INT;  break;
+		default: MoveType = IL_DOUBLE;  break;
+	}
+
+	// Each chunk of the source is read into Scratch before any of its
+	//  destination is written, and never lies behind its destination, so
+	//  converting in place does not overwrite pixels that are still needed.
+	SrcPixSize = SrcBpp * ilGetBpcType(SrcType);
+	DestPixSize = DestBpp * ilGetBpcType(DestType);
+	for (; NumPix > 0; NumPix -= Num) {
+		Num = NumPix < IL_CONV_CHUNK ? NumPix : IL_CONV_CHUNK;
+		if (MoveFirst) {
+			iConvertFormat(Src, SrcFormat, Scratch, DestFormat, MoveType, Num, &Map, &Factors[0]);
+			iConvertValues(Scratch, SrcType, Dest, DestType, Num * DestBpp);
+		}
+		else {
+			iConvertValues(Src, SrcType, Scratch, DestType, Num * SrcBpp);
+			iConvertFormat(Scratch, SrcFormat, Dest, DestFormat, DestType, Num, &Map, &Factors[0]);
+		}
+		Src = (const ILubyte*)Src + Num * SrcPixSize;
+		Dest = (ILubyte*)Dest + Num * DestPixSize;
+	}
+
+	return;
+}
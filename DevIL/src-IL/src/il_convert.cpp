@@ -33,14 +33,14 @@ ILimage *iConvertPalette(ILcontext* context, ILimage *Image, ILenum DestFormat)
 	ilCopyImageAttr(context, NewImage, Image);
 
 	if (!Image->Pal.Palette || !Image->Pal.PalSize || Image->Pal.PalType == IL_PAL_NONE || Image->Bpp != 1) {
-		ilCloseImage(NewImage);
+		ilCloseImage(context, NewImage);
 		ilSetError(context, IL_ILLEGAL_OPERATION);
 		return NULL;
 	}
 
 	if (DestFormat == IL_LUMINANCE || DestFormat == IL_LUMINANCE_ALPHA) {
 		if (NewImage->Pal.Palette)
-			ifree(NewImage->Pal.Palette);
+			ifree(context, NewImage->Pal.Palette);
 		if (DestFormat == IL_LUMINANCE_ALPHA)
 			LumBpp = 2;
 
@@ -118,13 +118,13 @@ ILimage *iConvertPalette(ILcontext* context, ILimage *Image, ILenum DestFormat)
 			}
 		}
 
-		ifree(Temp);
+		ifree(context, Temp);
 
 		return NewImage;
 	}
 	else if (DestFormat == IL_ALPHA) {
 		if (NewImage->Pal.Palette)
-			ifree(NewImage->Pal.Palette);
+			ifree(context, NewImage->Pal.Palette);
 
 		switch (context->impl->iCurImage->Pal.PalType)
 		{
@@ -174,7 +174,7 @@ ILimage *iConvertPalette(ILcontext* context, ILimage *Image, ILenum DestFormat)
 			}
 		}
 
-		ifree(Temp);
+		ifree(context, Temp);
 
 		return NewImage;
 	}
@@ -183,7 +183,7 @@ ILimage *iConvertPalette(ILcontext* context, ILimage *Image, ILenum DestFormat)
 	NewImage->Format = DestFormat;
 
 	if (ilGetBppFormat(NewImage->Format) == 0) {
-		ilCloseImage(NewImage);
+		ilCloseImage(context, NewImage);
 		ilSetError(context, IL_ILLEGAL_OPERATION);
 		return NULL;
 	}
@@ -225,7 +225,7 @@ ILimage *iConvertPalette(ILcontext* context, ILimage *Image, ILenum DestFormat)
 			return NewImage;
 
 		default:
-			ilCloseImage(NewImage);
+			ilCloseImage(context, NewImage);
 			ilSetError(context, IL_INVALID_CONVERSION);
 			return NULL;
 	}
@@ -236,7 +236,7 @@ ILimage *iConvertPalette(ILcontext* context, ILimage *Image, ILenum DestFormat)
 	// ilConvertPal already sets the error message - no need to confuse the user.
 	if (!Converted) {
 		ilSetCurImage(context, CurImage);
-		ilCloseImage(NewImage);
+		ilCloseImage(context, NewImage);
 		return NULL;
 	}
 
@@ -247,7 +247,7 @@ ILimage *iConvertPalette(ILcontext* context, ILimage *Image, ILenum DestFormat)
 		}
 	}
 
-	ifree(NewImage->Pal.Palette);
+	ifree(context, NewImage->Pal.Palette);
 
 	NewImage->Pal.Palette = NULL;
 	NewImage->Pal.PalSize = 0;
@@ -257,9 +257,9 @@ ILimage *iConvertPalette(ILcontext* context, ILimage *Image, ILenum DestFormat)
 	return NewImage;
 
 alloc_error:
-	ifree(Temp);
+	ifree(context, Temp);
 	if (NewImage)
-		ilCloseImage(NewImage);
+		ilCloseImage(context, NewImage);
 	if (CurImage != context->impl->iCurImage)
 		ilSetCurImage(context, CurImage);
 	return NULL;
@@ -302,10 +302,10 @@ ILAPI ILimage* ILAPIENTRY iConvertImage(ILcontext* context, ILimage *Image, ILen
 
 		NewData = (ILubyte*)ilConvertBuffer(context, NewImage->SizeOfData, NewImage->Format, DestFormat, NewImage->Type, DestType, NULL, NewImage->Data);
 		if (NewData == NULL) {
-			ifree(NewImage);  // ilCloseImage not needed.
+			ifree(context, NewImage);  // ilCloseImage not needed.
 			return NULL;
 		}
-		ifree(NewImage->Data);
+		ifree(context, NewImage->Data);
 		NewImage->Data = NewData;
 
 		ilCopyImageAttr(context, NewImage, Image);
@@ -331,7 +331,7 @@ ILAPI ILimage* ILAPIENTRY iConvertImage(ILcontext* context, ILimage *Image, ILen
 
 		if (ilGetBppFormat(DestFormat) == 0) {
 			ilSetError(context, IL_INVALID_PARAM);
-			ifree(NewImage);
+			ifree(context, NewImage);
 			return NULL;
 		}
 
@@ -355,7 +355,7 @@ ILAPI ILimage* ILAPIENTRY iConvertImage(ILcontext* context, ILimage *Image, ILen
 			}
 			NewImage->Data = (ILubyte*)ialloc(context, Image->SizeOfData);
 			if (NewImage->Data == NULL) {
-				ilCloseImage(NewImage);
+				ilCloseImage(context, NewImage);
 				return NULL;
 			}
 			memcpy(NewImage->Data, Image->Data, Image->SizeOfData);
@@ -363,7 +363,7 @@ ILAPI ILimage* ILAPIENTRY iConvertImage(ILcontext* context, ILimage *Image, ILen
 		else {
 			NewImage->Data = (ILubyte*)ilConvertBuffer(context, Image->SizeOfData, Image->Format, DestFormat, Image->Type, DestType, NULL, Image->Data);
 			if (NewImage->Data == NULL) {
-				ifree(NewImage);  // ilCloseImage not needed.
+				ifree(context, NewImage);  // ilCloseImage not needed.
 				return NULL;
 			}
 		}
@@ -373,6 +373,50 @@ ILAPI ILimage* ILAPIENTRY iConvertImage(ILcontext* context, ILimage *Image, ILen
 }
 
 
+// Converts a direct-colour image in a single pass, without the intermediate
+//  buffers of ilConvertBuffer.  Image->Data is converted in place when the
+//  new pixels are not larger than the old ones, so that no memory is needed.
+//  Returns IL_FALSE without changing Image if iConvertPixels cannot do it.
+static ILboolean iConvertImageDirect(ILcontext* context, ILimage *Image, ILenum DestFormat, ILenum DestType)
+{
+	ILuint	NumPix, SrcBpp, DestBpp;
+	ILubyte	*NewData;
+
+	if (!iCanConvertPixels(Image->Format, Image->Type, DestFormat, DestType))
+		return IL_FALSE;
+
+	SrcBpp = Image->Bpp * Image->Bpc;
+	DestBpp = ilGetBppFormat(DestFormat) * ilGetBpcType(DestType);
+	if (SrcBpp == 0)
+		return IL_FALSE;
+	NumPix = Image->SizeOfData / SrcBpp;
+
+	if (DestBpp <= SrcBpp)
+		NewData = Image->Data;
+	else {
+		NewData = (ILubyte*)ialloc(context, NumPix * DestBpp);
+		if (NewData == NULL)
+			return IL_FALSE;  // The old path reports the error.
+	}
+
+	iConvertPixels(Image->Data, Image->Format, Image->Type, NewData, DestFormat, DestType, NumPix);
+	if (NewData != Image->Data) {
+		ifree(context, Image->Data);
+		Image->Data = NewData;
+	}
+
+	Image->Format = DestFormat;
+	Image->Type = DestType;
+	Image->Bpc = ilGetBpcType(DestType);
+	Image->Bpp = ilGetBppFormat(DestFormat);
+	Image->Bps = Image->Width * Image->Bpc * Image->Bpp;
+	Image->SizeOfPlane = Image->Bps * Image->Height;
+	Image->SizeOfData = Image->Depth * Image->SizeOfPlane;
+
+	return IL_TRUE;
+}
+
+
 //! Converts the current image to the DestFormat format.
 /*! \param DestFormat An enum of the desired output format.  Any format values are accepted.
     \param DestType An enum of the desired output type.  Any type values are accepted.
@@ -406,6 +450,11 @@ ILboolean ILAPIENTRY ilConvertImage(ILcontext* context, ILenum DestFormat, ILenu
 	pCurImage = context->impl->iCurImage;
 	while (pCurImage != NULL)
 	{
+		if (iConvertImageDirect(context, pCurImage, DestFormat, DestType)) {
+			pCurImage = pCurImage->Next;
+			continue;
+		}
+
 		Image = iConvertImage(context, pCurImage, DestFormat, DestType);
 		if (Image == NULL)
 			return IL_FALSE;
@@ -422,15 +471,15 @@ ILboolean ILAPIENTRY ilConvertImage(ILcontext* context, ILenum DestFormat, ILenu
 		pCurImage->SizeOfPlane = pCurImage->Bps * pCurImage->Height;
 		pCurImage->SizeOfData = pCurImage->Depth * pCurImage->SizeOfPlane;
 		if (pCurImage->Pal.Palette && pCurImage->Pal.PalSize && pCurImage->Pal.PalType != IL_PAL_NONE)
-			ifree(pCurImage->Pal.Palette);
+			ifree(context, pCurImage->Pal.Palette);
 		pCurImage->Pal.Palette = Image->Pal.Palette;
 		pCurImage->Pal.PalSize = Image->Pal.PalSize;
 		pCurImage->Pal.PalType = Image->Pal.PalType;
 		Image->Pal.Palette = NULL;
-		ifree(pCurImage->Data);
+		ifree(context, pCurImage->Data);
 		pCurImage->Data = Image->Data;
 		Image->Data = NULL;
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 
 		pCurImage = pCurImage->Next;
 	}
@@ -634,7 +683,7 @@ ILboolean ilAddAlpha(ILcontext* context)
 			break;
 
 		default:
-			ifree(NewData);
+			ifree(context, NewData);
 			ilSetError(context, IL_INTERNAL_ERROR);
 			return IL_FALSE;
 	}
@@ -644,7 +693,7 @@ ILboolean ilAddAlpha(ILcontext* context)
 	context->impl->iCurImage->Bps = context->impl->iCurImage->Width * context->impl->iCurImage->Bpc * NewBpp;
 	context->impl->iCurImage->SizeOfPlane = context->impl->iCurImage->Bps * context->impl->iCurImage->Height;
 	context->impl->iCurImage->SizeOfData = context->impl->iCurImage->SizeOfPlane * context->impl->iCurImage->Depth;
-	ifree(context->impl->iCurImage->Data);
+	ifree(context, context->impl->iCurImage->Data);
 	context->impl->iCurImage->Data = NewData;
 
 	switch (context->impl->iCurImage->Format)
@@ -811,7 +860,7 @@ ILboolean ilAddAlphaKey(ILcontext* context, ILimage *Image)
 				break;
 
 			default:
-				ifree(NewData);
+				ifree(context, NewData);
 				ilSetError(context, IL_INTERNAL_ERROR);
 				return IL_FALSE;
 		}
@@ -821,7 +870,7 @@ ILboolean ilAddAlphaKey(ILcontext* context, ILimage *Image)
 		Image->Bps = Image->Width * Image->Bpc * NewBpp;
 		Image->SizeOfPlane = Image->Bps * Image->Height;
 		Image->SizeOfData = Image->SizeOfPlane * Image->Depth;
-		ifree(Image->Data);
+		ifree(context, Image->Data);
 		Image->Data = NewData;
 
 		switch (Image->Format)
@@ -956,7 +1005,7 @@ ILboolean ilRemoveAlpha(ILcontext* context)
 			break;
 
 		default:
-			ifree(NewData);
+			ifree(context, NewData);
 			ilSetError(context, IL_INTERNAL_ERROR);
 			return IL_FALSE;
 	}
@@ -966,7 +1015,7 @@ ILboolean ilRemoveAlpha(ILcontext* context)
 	context->impl->iCurImage->Bps = context->impl->iCurImage->Width * context->impl->iCurImage->Bpc * NewBpp;
 	context->impl->iCurImage->SizeOfPlane = context->impl->iCurImage->Bps * context->impl->iCurImage->Height;
 	context->impl->iCurImage->SizeOfData = context->impl->iCurImage->SizeOfPlane * context->impl->iCurImage->Depth;
-	ifree(context->impl->iCurImage->Data);
+	ifree(context, context->impl->iCurImage->Data);
 	context->impl->iCurImage->Data = NewData;
 
 	switch (context->impl->iCurImage->Format)
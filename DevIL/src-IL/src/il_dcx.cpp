@@ -235,7 +235,7 @@ ILboolean DcxHandler::loadInternal()
 			ilTexImage(context, Image->Width, Image->Height, 1, Image->Bpp, Image->Format, Image->Type, Image->Data);
 			Base = context->impl->iCurImage;
 			Base->Origin = IL_ORIGIN_UPPER_LEFT;
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 		}
 		else {
 			context->impl->iCurImage->Next = Image;
@@ -328,7 +328,7 @@ ILimage *iUncompressDcx(ILcontext* context, DCXHEAD *Header)
 			}
 		}
 
-		ifree(Compressed);
+		ifree(context, Compressed);
 		context->impl->iseek(context, StartPos + Read, IL_SEEK_SET);*/
 
 	//changed 2003-09-01
@@ -369,7 +369,7 @@ ILimage *iUncompressDcx(ILcontext* context, DCXHEAD *Header)
 	iUnCache(context);
 
 
-	ifree(ScanLine);
+	ifree(context, ScanLine);
 
 	// Read in the palette
 	if (Image->Bpp == 1) {
@@ -378,7 +378,7 @@ ILimage *iUncompressDcx(ILcontext* context, DCXHEAD *Header)
 		if (ByteHead != 12)
 			context->impl->iseek(context, -1, IL_SEEK_CUR);
 		if (context->impl->iread(context, Image->Pal.Palette, 1, Image->Pal.PalSize) != Image->Pal.PalSize) {
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 			return NULL;
 		}
 	}
@@ -386,8 +386,8 @@ ILimage *iUncompressDcx(ILcontext* context, DCXHEAD *Header)
 	return Image;
 
 dcx_error:
-	ifree(ScanLine);
-	ilCloseImage(Image);
+	ifree(context, ScanLine);
+	ilCloseImage(context, Image);
 	return NULL;
 }
 
@@ -416,7 +416,7 @@ ILimage *iUncompressDcxSmall(ILcontext* context, DCXHEAD *Header)
 			break;
 		default:
 			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 			return NULL;
 	}
 
@@ -458,8 +458,8 @@ ILimage *iUncompressDcxSmall(ILcontext* context, DCXHEAD *Header)
 		Image->Pal.PalType = IL_PAL_RGB24;
 		ScanLine = (ILubyte*)ialloc(context, Bps);
 		if (Image->Pal.Palette == NULL || ScanLine == NULL) {
-			ifree(ScanLine);
-			ilCloseImage(Image);
+			ifree(context, ScanLine);
+			ilCloseImage(context, Image);
 			return NULL;
 		}
 
@@ -498,14 +498,14 @@ ILimage *iUncompressDcxSmall(ILcontext* context, DCXHEAD *Header)
 				}
 			}
 		}
-		ifree(ScanLine);
+		ifree(context, ScanLine);
 	}
 
 	return Image;
 
 file_read_error:
-	ifree(ScanLine);
-	ilCloseImage(Image);
+	ifree(context, ScanLine);
+	ilCloseImage(context, Image);
 	return NULL;
 }
 
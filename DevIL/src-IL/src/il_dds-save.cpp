@@ -17,6 +17,7 @@
 #ifndef IL_NO_DDS
 
 #include "il_dds.h"
+#include "il_threads.h"
 
 void		ChooseAlphaEndpoints(ILubyte *Block, ILubyte *a0, ILubyte *a1);
 void		ChooseEndpoints(ILushort *Block, ILushort *ex0, ILushort *ex1);
@@ -29,6 +30,14 @@ ILuint		GenBitMask(ILushort ex0, ILushort ex1, ILuint NumCols, ILushort *In, ILu
 ILboolean	GetBlock(ILushort *Block, ILushort *Data, ILimage *Image, ILuint XPos, ILuint YPos);
 ILboolean	Get3DcBlock(ILubyte *Block, ILubyte *Data, ILimage *Image, ILuint XPos, ILuint YPos, int channel);
 ILboolean	WriteHeader(ILcontext* context, ILimage *Image, ILenum DXTCFormat, ILuint CubeFlags);
+static ILuint	iDxtcBlockSize(ILenum DXTCFormat);
+static ILboolean iExternalDxtc(ILcontext* context, ILimage *Image, ILenum DXTCFormat);
+static void	iPutColourBlock(ILubyte *Dest, ILushort ex0, ILushort ex1, ILuint BitMask);
+static ILboolean iCompressBlocks(ILcontext* context, ILimage *Image, ILenum DXTCFormat, ILubyte *Out);
+static void	GetRgbBlock(ILubyte *Block, ILubyte *Data, ILimage *Image, ILuint XPos, ILuint YPos);
+static void	GetPixelBlock(ILubyte *Block, ILubyte *Data, ILimage *Image, ILuint XPos, ILuint YPos, ILuint PixelSize);
+static void	FitColourBlock(ILubyte *Rgb, ILubyte *Alpha, ILboolean Cluster, ILubyte *Out);
+static void	FitAlphaBlock(ILubyte *Block, ILubyte *Out);
 
 //! Writes a Dds file
 ILboolean DdsHandler::save(const ILstring FileName)
@@ -181,7 +190,7 @@ ILboolean DdsHandler::saveInternal()
 				return IL_FALSE;
 
 			if (context->impl->iCurImage->Origin != IL_ORIGIN_UPPER_LEFT) {
-				ifree(context->impl->iCurImage->Data);
+				ifree(context, context->impl->iCurImage->Data);
 				context->impl->iCurImage->Data = CurData;
 			}
 		}
@@ -237,6 +246,12 @@ ILboolean WriteHeader(ILcontext* context, ILimage *Image, ILenum DXTCFormat, ILu
 		case IL_RXGB:
 			FourCC = IL_MAKEFOURCC('R','X','G','B');
 			break;
+		case IL_BC7:
+		case IL_BC6H:
+		case IL_BC6H_SF:
+			// Named by the DX10 header that follows.
+			FourCC = IL_MAKEFOURCC('D','X','1','0');
+			break;
 		default:
 			// Error!
 			ilSetError(context, IL_INTERNAL_ERROR);  // Should never happen, though.
@@ -310,6 +325,17 @@ ILboolean WriteHeader(ILcontext* context, ILimage *Image, ILenum DXTCFormat, ILu
 	SaveLittleUInt(context, 0);			// ddsCaps4
 	SaveLittleUInt(context, 0);			// TextureStage
 
+	if (FourCC == IL_MAKEFOURCC('D','X','1','0')) {
+		if (DXTCFormat == IL_BC7)
+			SaveLittleUInt(context, DXGI_FORMAT_BC7_UNORM);
+		else
+			SaveLittleUInt(context, DXTCFormat == IL_BC6H ? DXGI_FORMAT_BC6H_UF16 : DXGI_FORMAT_BC6H_SF16);
+		SaveLittleUInt(context, Image->Depth > 1 ? D3D10_RESOURCE_DIMENSION_TEXTURE3D : D3D10_RESOURCE_DIMENSION_TEXTURE2D);
+		SaveLittleUInt(context, CubeFlags != 0 ? 0x4 : 0);	// miscFlag: D3D10_RESOURCE_MISC_TEXTURECUBE
+		SaveLittleUInt(context, 1);			// arraySize
+		SaveLittleUInt(context, 0);			// miscFlags2
+	}
+
 	return IL_TRUE;
 }
 
@@ -318,29 +344,16 @@ ILboolean WriteHeader(ILcontext* context, ILimage *Image, ILenum DXTCFormat, ILu
 ILuint ILAPIENTRY ilGetDXTCData(ILcontext* context, void *Buffer, ILuint BufferSize, ILenum DXTCFormat)
 {
 	ILubyte	*CurData = NULL;
-	ILuint	retVal;
-	ILint	BlockNum;
+	ILuint	retVal, Size;
 
-	if (Buffer == NULL) {  // Return the number that will be written with a subsequent call.
-		BlockNum = ((context->impl->iCurImage->Width + 3)/4) * ((context->impl->iCurImage->Height + 3)/4)
-					* context->impl->iCurImage->Depth;
-
-		switch (DXTCFormat)
-		{
-			case IL_DXT1:
-			case IL_DXT1A:
-			case IL_ATI1N:
-				return BlockNum * 8;
-			case IL_DXT3:
-			case IL_DXT5:
-			case IL_3DC:
-			case IL_RXGB:
-				return BlockNum * 16;
-			default:
-				ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
-				return 0;
-		}
+	Size = ((context->impl->iCurImage->Width + 3)/4) * ((context->impl->iCurImage->Height + 3)/4)
+			* context->impl->iCurImage->Depth * iDxtcBlockSize(DXTCFormat);
+	if (Size == 0) {
+		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+		return 0;
 	}
+	if (Buffer == NULL)  // Return the number that will be written with a subsequent call.
+		return Size;
 
 	if (DXTCFormat == context->impl->iCurImage->DxtcFormat && context->impl->iCurImage->DxtcSize && context->impl->iCurImage->DxtcData) {
 		memcpy(Buffer, context->impl->iCurImage->DxtcData, IL_MIN(BufferSize, context->impl->iCurImage->DxtcSize));
@@ -356,12 +369,16 @@ ILuint ILAPIENTRY ilGetDXTCData(ILcontext* context, void *Buffer, ILuint BufferS
 		}
 	}
 
-	//@TODO: Is this the best way to do this?
-	iSetOutputLump(context, Buffer, BufferSize);
-	retVal = Compress(context, context->impl->iCurImage, DXTCFormat);
+	// With room for all of it, the blocks go straight into Buffer.
+	if (BufferSize >= Size && !iExternalDxtc(context, context->impl->iCurImage, DXTCFormat))
+		retVal = iCompressBlocks(context, context->impl->iCurImage, DXTCFormat, (ILubyte*)Buffer) ? Size : 0;
+	else {
+		iSetOutputLump(context, Buffer, BufferSize);
+		retVal = Compress(context, context->impl->iCurImage, DXTCFormat);
+	}
 
 	if (context->impl->iCurImage->Origin != IL_ORIGIN_UPPER_LEFT) {
-		ifree(context->impl->iCurImage->Data);
+		ifree(context, context->impl->iCurImage->Data);
 		context->impl->iCurImage->Data = CurData;
 	}
 
@@ -401,7 +418,7 @@ ILushort *CompressTo565(ILcontext* context, ILimage *Image)
 	Data = (ILushort*)ialloc(context, context->impl->iCurImage->Width * context->impl->iCurImage->Height * 2 * context->impl->iCurImage->Depth);
 	if (Data == NULL) {
 		if (TempImage != Image)
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 		return NULL;
 	}
 
@@ -470,7 +487,7 @@ ILushort *CompressTo565(ILcontext* context, ILimage *Image)
 	}
 
 	if (TempImage != Image)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return Data;
 }
@@ -493,7 +510,7 @@ ILubyte *CompressTo88(ILcontext* context, ILimage *Image)
 	Data = (ILubyte*)ialloc(context, context->impl->iCurImage->Width * context->impl->iCurImage->Height * 2 * context->impl->iCurImage->Depth);
 	if (Data == NULL) {
 		if (TempImage != Image)
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 		return NULL;
 	}
 
@@ -537,7 +554,7 @@ ILubyte *CompressTo88(ILcontext* context, ILimage *Image)
 	}
 
 	if (TempImage != Image)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return Data;
 }
@@ -565,7 +582,7 @@ void CompressToRXGB(ILcontext* context, ILimage *Image, ILushort** xgb, ILubyte*
 	*r = (ILubyte*)ialloc(context, context->impl->iCurImage->Width * context->impl->iCurImage->Height * context->impl->iCurImage->Depth);
 	if (*xgb == NULL || *r == NULL) {
 		if (TempImage != Image)
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 		return;
 	}
 
@@ -625,295 +642,388 @@ void CompressToRXGB(ILcontext* context, ILimage *Image, ILushort** xgb, ILubyte*
 	}
 
 	if (TempImage != Image)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 }
 
-ILuint Compress(ILcontext* context, ILimage *Image, ILenum DXTCFormat)
+// Packed RGB bytes of Image, for the fits that work on the full 8 bits.
+ILubyte *CompressTo888(ILcontext* context, ILimage *Image)
 {
-	ILushort	*Data, Block[16], ex0, ex1, *Runner16, t0, t1;
-	ILuint		x, y, z, i, BitMask, DXTCSize;//, Rms1, Rms2;
-	ILubyte		*Alpha, AlphaBlock[16], AlphaBitMask[6], /*AlphaOut[16],*/ a0, a1;
-	ILboolean	HasAlpha;
-	ILuint		Count = 0;
-	ILubyte		*Data3Dc, *Runner8, *ByteData, *BlockData;
-
-	if (DXTCFormat == IL_3DC) {
-		Data3Dc = CompressTo88(context, Image);
-		if (Data3Dc == NULL)
-			return 0;
+	ILimage	*TempImage;
+	ILubyte	*Data;
+	ILuint	Size = Image->Width * Image->Height * Image->Depth * 3;
 
-		Runner8 = Data3Dc;
-
-		for (z = 0; z < Image->Depth; z++) {
-			for (y = 0; y < Image->Height; y += 4) {
-				for (x = 0; x < Image->Width; x += 4) {
-					Get3DcBlock(AlphaBlock, Runner8, Image, x, y, 0);
-					ChooseAlphaEndpoints(AlphaBlock, &a0, &a1);
-					GenAlphaBitMask(a0, a1, AlphaBlock, AlphaBitMask, NULL);
-					context->impl->iputc(context, a0);
-					context->impl->iputc(context, a1);
-					context->impl->iwrite(context, AlphaBitMask, 1, 6);
-
-					Get3DcBlock(AlphaBlock, Runner8, Image, x, y, 1);
-					ChooseAlphaEndpoints(AlphaBlock, &a0, &a1);
-					GenAlphaBitMask(a0, a1, AlphaBlock, AlphaBitMask, NULL);
-					context->impl->iputc(context, a0);
-					context->impl->iputc(context, a1);
-					context->impl->iwrite(context, AlphaBitMask, 1, 6);
-
-					Count += 16;
-				}
-			}
-			Runner8 += Image->Width * Image->Height * 2;
+	Data = (ILubyte*)ialloc(context, Size);
+	if (Data == NULL)
+		return NULL;
+
+	if (Image->Format == IL_ALPHA) {
+		memset(Data, 0, Size);
+		return Data;
+	}
+
+	if (Image->Format != IL_RGB || Image->Type != IL_UNSIGNED_BYTE) {
+		TempImage = iConvertImage(context, Image, IL_RGB, IL_UNSIGNED_BYTE);
+		if (TempImage == NULL) {
+			ifree(context, Data);
+			return NULL;
 		}
-		ifree(Data3Dc);
+	}
+	else {
+		TempImage = Image;
 	}
 
-	else if (DXTCFormat == IL_ATI1N)
-	{
-		ILimage *TempImage;
+	memcpy(Data, TempImage->Data, Size);
 
-		if (Image->Bpp != 1) {
-			TempImage = iConvertImage(context, context->impl->iCurImage, IL_LUMINANCE, IL_UNSIGNED_BYTE);
-			if (TempImage == NULL)
-				return 0;
-		}
-		else {
-			TempImage = Image;
-		}
+	if (TempImage != Image)
+		ilCloseImage(context, TempImage);
 
-		Runner8 = TempImage->Data;
-
-		for (z = 0; z < Image->Depth; z++) {
-			for (y = 0; y < Image->Height; y += 4) {
-				for (x = 0; x < Image->Width; x += 4) {
-					GetAlphaBlock(AlphaBlock, Runner8, Image, x, y);
-					ChooseAlphaEndpoints(AlphaBlock, &a0, &a1);
-					GenAlphaBitMask(a0, a1, AlphaBlock, AlphaBitMask, NULL);
-					context->impl->iputc(context, a0);
-					context->impl->iputc(context, a1);
-					context->impl->iwrite(context, AlphaBitMask, 1, 6);
-					Count += 8;
-				}
-			}
-			Runner8 += Image->Width * Image->Height;
-		}
+	return Data;
+}
 
-		if (TempImage != Image)
-			ilCloseImage(TempImage);
-	}
-	else
-	{
-		// We want to try nVidia compression first, because it is the fastest.
+// Whether Compress hands DXTCFormat to nVidia Texture Tools or libsquish
+//  instead of the encoder below.
+static ILboolean iExternalDxtc(ILcontext* context, ILimage *Image, ILenum DXTCFormat)
+{
+	(void)context;  // Only used when one of the libraries is built in.
+	if (DXTCFormat != IL_DXT1 && DXTCFormat != IL_DXT1A && DXTCFormat != IL_DXT3 && DXTCFormat != IL_DXT5)
+		return IL_FALSE;
+	if (Image->Depth != 1)
+		return IL_FALSE;
 #ifdef IL_USE_DXTC_NVIDIA
-		if (ilIsEnabled(context, IL_NVIDIA_COMPRESS) && Image->Depth == 1) {  // See if we need to use the nVidia Texture Tools library.
-			if (DXTCFormat == IL_DXT1 || DXTCFormat == IL_DXT1A || DXTCFormat == IL_DXT3 || DXTCFormat == IL_DXT5) {
-				// NVTT needs data as BGRA 32-bit.
-				if (Image->Format != IL_BGRA || Image->Type != IL_UNSIGNED_BYTE) {  // No need to convert if already this format/type.
-					ByteData = ilConvertBuffer(context, Image->SizeOfData, Image->Format, IL_BGRA, Image->Type, IL_UNSIGNED_BYTE, NULL, Image->Data);
-					if (ByteData == NULL)
-						return 0;
-				}
-				else
-					ByteData = Image->Data;
+	if (ilIsEnabled(context, IL_NVIDIA_COMPRESS))
+		return IL_TRUE;
+#endif//IL_USE_DXTC_NVIDIA
+#ifdef IL_USE_DXTC_SQUISH
+	if (ilIsEnabled(context, IL_SQUISH_COMPRESS))
+		return IL_TRUE;
+#endif//IL_USE_DXTC_SQUISH
+	return IL_FALSE;
+}
 
-				// Here's where all the compression and writing goes on.
-				if (!ilNVidiaCompressDXTFile(ByteData, Image->Width, Image->Height, 1, DXTCFormat))
-					return 0;
+// Bytes in one 4x4 block of DXTCFormat, or 0 if it cannot be written
+static ILuint iDxtcBlockSize(ILenum DXTCFormat)
+{
+	switch (DXTCFormat)
+	{
+		case IL_DXT1:
+		case IL_DXT1A:
+		case IL_ATI1N:
+			return 8;
+		case IL_DXT3:
+		case IL_DXT5:
+		case IL_3DC:
+		case IL_RXGB:
+		case IL_BC7:
+		case IL_BC6H:
+		case IL_BC6H_SF:
+			return 16;
+	}
 
-				if (ByteData != Image->Data)
-					ifree(ByteData);
+	return 0;
+}
+
+ILuint Compress(ILcontext* context, ILimage *Image, ILenum DXTCFormat)
+{
+	ILubyte	*Buffer;
+	ILuint	Size;
+#if defined(IL_USE_DXTC_NVIDIA) || defined(IL_USE_DXTC_SQUISH)
+	ILubyte	*ByteData, *BlockData;
+	ILuint	DXTCSize;
+#endif
 
-				return Image->Width * Image->Height * 4;  // Either compresses all or none.
+	// We want to try nVidia compression first, because it is the fastest.
+#ifdef IL_USE_DXTC_NVIDIA
+	if (ilIsEnabled(context, IL_NVIDIA_COMPRESS) && Image->Depth == 1) {  // See if we need to use the nVidia Texture Tools library.
+		if (DXTCFormat == IL_DXT1 || DXTCFormat == IL_DXT1A || DXTCFormat == IL_DXT3 || DXTCFormat == IL_DXT5) {
+			// NVTT needs data as BGRA 32-bit.
+			if (Image->Format != IL_BGRA || Image->Type != IL_UNSIGNED_BYTE) {  // No need to convert if already this format/type.
+				ByteData = ilConvertBuffer(context, Image->SizeOfData, Image->Format, IL_BGRA, Image->Type, IL_UNSIGNED_BYTE, NULL, Image->Data);
+				if (ByteData == NULL)
+					return 0;
 			}
+			else
+				ByteData = Image->Data;
+
+			// Here's where all the compression and writing goes on.
+			if (!ilNVidiaCompressDXTFile(ByteData, Image->Width, Image->Height, 1, DXTCFormat))
+				return 0;
+
+			if (ByteData != Image->Data)
+				ifree(context, ByteData);
+
+			return Image->Width * Image->Height * 4;  // Either compresses all or none.
 		}
+	}
 #endif//IL_USE_DXTC_NVIDIA
 
-		// libsquish generates better quality output than DevIL does, so we try it next.
+	// libsquish generates better quality output than DevIL does, so we try it next.
 #ifdef IL_USE_DXTC_SQUISH
-		if (ilIsEnabled(context, IL_SQUISH_COMPRESS) && Image->Depth == 1) {  // See if we need to use the nVidia Texture Tools library.
-			if (DXTCFormat == IL_DXT1 || DXTCFormat == IL_DXT1A || DXTCFormat == IL_DXT3 || DXTCFormat == IL_DXT5) {
-				// libsquish needs data as RGBA 32-bit.
-				if (Image->Format != IL_RGBA || Image->Type != IL_UNSIGNED_BYTE) {  // No need to convert if already this format/type.
-					ByteData = (ILubyte*)ilConvertBuffer(context, Image->SizeOfData, Image->Format, IL_RGBA, Image->Type, IL_UNSIGNED_BYTE, NULL, Image->Data);
-					if (ByteData == NULL)
-						return 0;
-				}
-				else
-					ByteData = Image->Data;
-
-				// Get compressed data here.
-				BlockData = ilSquishCompressDXT(ByteData, Image->Width, Image->Height, 1, DXTCFormat, &DXTCSize);
-				if (BlockData == NULL)
+	if (ilIsEnabled(context, IL_SQUISH_COMPRESS) && Image->Depth == 1) {  // See if we need to use the nVidia Texture Tools library.
+		if (DXTCFormat == IL_DXT1 || DXTCFormat == IL_DXT1A || DXTCFormat == IL_DXT3 || DXTCFormat == IL_DXT5) {
+			// libsquish needs data as RGBA 32-bit.
+			if (Image->Format != IL_RGBA || Image->Type != IL_UNSIGNED_BYTE) {  // No need to convert if already this format/type.
+				ByteData = (ILubyte*)ilConvertBuffer(context, Image->SizeOfData, Image->Format, IL_RGBA, Image->Type, IL_UNSIGNED_BYTE, NULL, Image->Data);
+				if (ByteData == NULL)
 					return 0;
+			}
+			else
+				ByteData = Image->Data;
 
-				if (context->impl->iwrite((BlockData, 1, DXTCSize) != DXTCSize) {
-					if (ByteData != Image->Data)
-						ifree(ByteData);
-					ifree(BlockData);
-					return 0;
-				}
+			// Get compressed data here.
+			BlockData = ilSquishCompressDXT(ByteData, Image->Width, Image->Height, 1, DXTCFormat, &DXTCSize);
+			if (BlockData == NULL)
+				return 0;
 
+			if (context->impl->iwrite(context, BlockData, 1, DXTCSize) != DXTCSize) {
 				if (ByteData != Image->Data)
-					ifree(ByteData);
-				ifree(BlockData);
-
-				return Image->Width * Image->Height * 4;  // Either compresses all or none.
+					ifree(context, ByteData);
+				ifree(context, BlockData);
+				return 0;
 			}
+
+			if (ByteData != Image->Data)
+				ifree(context, ByteData);
+			ifree(context, BlockData);
+
+			return Image->Width * Image->Height * 4;  // Either compresses all or none.
 		}
+	}
 #endif//IL_USE_DXTC_SQUISH
 
-		if (DXTCFormat != IL_RXGB) {
-			Data = CompressTo565(context, Image);
-			if (Data == NULL)
-				return 0;
+	// The size is known up front, so all blocks are encoded into one buffer
+	//  and written in one go.
+	Size = ((Image->Width + 3) / 4) * ((Image->Height + 3) / 4) * Image->Depth * iDxtcBlockSize(DXTCFormat);
+	if (Size == 0)
+		return 0;
+	Buffer = (ILubyte*)ialloc(context, Size);
+	if (Buffer == NULL)
+		return 0;
 
-			Alpha = ilGetAlpha(context, IL_UNSIGNED_BYTE);
-			if (Alpha == NULL) {
-				ifree(Data);
-				return 0;
+	if (!iCompressBlocks(context, Image, DXTCFormat, Buffer)) {
+		ifree(context, Buffer);
+		return 0;
+	}
+	Size = context->impl->iwrite(context, Buffer, 1, Size);
+	ifree(context, Buffer);
+
+	return Size;  // Returns 0 if no compression was done.
+}
+
+// Smallest number of block rows worth a thread of their own
+#define DXTC_MIN_ROWS 8
+
+// Encodes every block of Image as DXTCFormat into Out, which has room for all
+//  of them.  Rows of blocks are independent, so they are spread over threads.
+static ILboolean iCompressBlocks(ILcontext* context, ILimage *Image, ILenum DXTCFormat, ILubyte *Out)
+{
+	ILushort	*Data = NULL;
+	ILubyte		*Alpha = NULL, *Rgb = NULL, *Bytes = NULL;
+	ILimage		*TempImage = NULL;
+	ILenum		Quality;
+	ILuint		BlockSize, BlocksX, BlocksY, Effort;
+
+	BlockSize = iDxtcBlockSize(DXTCFormat);
+	if (BlockSize == 0)
+		return IL_FALSE;
+	Quality = iGetInt(context, IL_DXTC_QUALITY);
+	Effort = iGetInt(context, IL_BPTC_EFFORT);
+	BlocksX = (Image->Width + 3) / 4;
+	BlocksY = (Image->Height + 3) / 4;
+
+	switch (DXTCFormat)
+	{
+		case IL_3DC:
+			Bytes = CompressTo88(context, Image);
+			if (Bytes == NULL)
+				return IL_FALSE;
+			break;
+
+		case IL_ATI1N:
+			if (Image->Bpp != 1 || Image->Type != IL_UNSIGNED_BYTE) {
+				TempImage = iConvertImage(context, Image, IL_LUMINANCE, IL_UNSIGNED_BYTE);
+				if (TempImage == NULL)
+					return IL_FALSE;
+				Bytes = TempImage->Data;
 			}
-		}
-		else {
-			CompressToRXGB(context, Image, &Data, &Alpha);
-			if (Data == NULL || Alpha == NULL) {
-				if (Data != NULL)
-					ifree(Data);
-				if (Alpha != NULL)
-					ifree(Alpha);
-				return 0;
+			else {
+				Bytes = Image->Data;
 			}
-		}
+			break;
 
-		Runner8 = Alpha;
-		Runner16 = Data;
+		case IL_BC7:
+		case IL_BC6H:
+		case IL_BC6H_SF:
+			// BC7 is encoded from 8-bit RGBA and BC6H from 32-bit float RGB.
+			if (DXTCFormat == IL_BC7 ? (Image->Format != IL_RGBA || Image->Type != IL_UNSIGNED_BYTE)
+				: (Image->Format != IL_RGB || Image->Type != IL_FLOAT)) {
+				TempImage = iConvertImage(context, Image, DXTCFormat == IL_BC7 ? IL_RGBA : IL_RGB,
+					DXTCFormat == IL_BC7 ? IL_UNSIGNED_BYTE : IL_FLOAT);
+				if (TempImage == NULL)
+					return IL_FALSE;
+				Bytes = TempImage->Data;
+			}
+			else {
+				Bytes = Image->Data;
+			}
+			break;
 
-		switch (DXTCFormat)
-		{
-			case IL_DXT1:
-			case IL_DXT1A:
-				for (z = 0; z < Image->Depth; z++) {
-					for (y = 0; y < Image->Height; y += 4) {
-						for (x = 0; x < Image->Width; x += 4) {
-							GetAlphaBlock(AlphaBlock, Runner8, Image, x, y);
-							HasAlpha = IL_FALSE;
-							for (i = 0 ; i < 16; i++) {
-								if (AlphaBlock[i] < 128) {
-									HasAlpha = IL_TRUE;
-									break;
-								}
-							}
+		case IL_RXGB:
+			// The colour of RXGB always uses the smallest and largest colour.
+			CompressToRXGB(context, Image, &Data, &Alpha);
+			if (Data == NULL || Alpha == NULL)
+				goto fail;
+			break;
 
-							GetBlock(Block, Runner16, Image, x, y);
-							ChooseEndpoints(Block, &ex0, &ex1);
-							CorrectEndDXT1(&ex0, &ex1, HasAlpha);
-							SaveLittleUShort(context, ex0);
-							SaveLittleUShort(context, ex1);
-							if (HasAlpha)
-								BitMask = GenBitMask(ex0, ex1, 3, Block, AlphaBlock, NULL);
-							else
-								BitMask = GenBitMask(ex0, ex1, 4, Block, NULL, NULL);
-							SaveLittleUInt(context, BitMask);
-							Count += 8;
-						}
-					}
+		default:
+			if (Quality == IL_DXTC_MINMAX)
+				Data = CompressTo565(context, Image);
+			else
+				Rgb = CompressTo888(context, Image);
+			if (Data == NULL && Rgb == NULL)
+				return IL_FALSE;
 
-					Runner16 += Image->Width * Image->Height;
-					Runner8 += Image->Width * Image->Height;
-				}
-				break;
+			Alpha = ilGetAlpha(context, IL_UNSIGNED_BYTE);
+			if (Alpha == NULL)
+				goto fail;
+			break;
+	}
 
-			/*case IL_DXT2:
-				for (y = 0; y < Image->Height; y += 4) {
-					for (x = 0; x < Image->Width; x += 4) {
-						GetAlphaBlock(AlphaBlock, Alpha, Image, x, y);
-						for (i = 0; i < 16; i += 2) {
-							context->impl->iputc(context, (ILubyte)(((AlphaBlock[i] >> 4) << 4) | (AlphaBlock[i+1] >> 4)));
+	iParallelFor(BlocksY * Image->Depth, DXTC_MIN_ROWS, [&](ILuint First, ILuint Last) {
+		ILushort	Block[16], ex0, ex1, t0, t1;
+		ILubyte		AlphaBlock[16], RgbBlock[48], RgbaBlock[64], *Dest;
+		ILfloat		FloatBlock[48];
+		ILuint		Row, x, y, i, Plane, BitMask;
+		ILboolean	HasAlpha;
+
+		for (Row = First; Row < Last; Row++) {
+			y = (Row % BlocksY) * 4;
+			Plane = (Row / BlocksY) * Image->Width * Image->Height;
+			Dest = Out + (ILsizei)Row * BlocksX * BlockSize;
+
+			for (x = 0; x < Image->Width; x += 4, Dest += BlockSize) {
+				switch (DXTCFormat)
+				{
+					case IL_3DC:
+						Get3DcBlock(AlphaBlock, Bytes + Plane * 2, Image, x, y, 0);
+						if (Quality == IL_DXTC_MINMAX) {
+							ChooseAlphaEndpoints(AlphaBlock, &Dest[0], &Dest[1]);
+							GenAlphaBitMask(Dest[0], Dest[1], AlphaBlock, Dest + 2, NULL);
 						}
+						else
+							FitAlphaBlock(AlphaBlock, Dest);
 
-						GetBlock(Block, Data, Image, x, y);
-						PreMult(Block, AlphaBlock);
-						ChooseEndpoints(Block, &ex0, &ex1);
-						SaveLittleUShort(context, ex0);
-						SaveLittleUShort(context, ex1);
-						BitMask = GenBitMask(ex0, ex1, 4, Block, NULL, NULL);
-						SaveLittleUInt(context, BitMask);
-					}		
-				}
-				break;*/
-
-			case IL_DXT3:
-				for (z = 0; z < Image->Depth; z++) {
-					for (y = 0; y < Image->Height; y += 4) {
-						for (x = 0; x < Image->Width; x += 4) {
-							GetAlphaBlock(AlphaBlock, Runner8, Image, x, y);
-							for (i = 0; i < 16; i += 2) {
-								context->impl->iputc(context, (ILubyte)(((AlphaBlock[i+1] >> 4) << 4) | (AlphaBlock[i] >> 4)));
+						Get3DcBlock(AlphaBlock, Bytes + Plane * 2, Image, x, y, 1);
+						if (Quality == IL_DXTC_MINMAX) {
+							ChooseAlphaEndpoints(AlphaBlock, &Dest[8], &Dest[9]);
+							GenAlphaBitMask(Dest[8], Dest[9], AlphaBlock, Dest + 10, NULL);
+						}
+						else
+							FitAlphaBlock(AlphaBlock, Dest + 8);
+						break;
+
+					case IL_BC7:
+						GetPixelBlock(RgbaBlock, Bytes + Plane * 4, Image, x, y, 4);
+						EncodeBC7Block(RgbaBlock, Effort, Dest);
+						break;
+
+					case IL_BC6H:
+					case IL_BC6H_SF:
+						GetPixelBlock((ILubyte*)FloatBlock, Bytes + Plane * 12, Image, x, y, 12);
+						EncodeBC6HBlock(FloatBlock, DXTCFormat == IL_BC6H_SF, Effort, Dest);
+						break;
+
+					case IL_ATI1N:
+						GetAlphaBlock(AlphaBlock, Bytes + Plane, Image, x, y);
+						if (Quality == IL_DXTC_MINMAX) {
+							ChooseAlphaEndpoints(AlphaBlock, &Dest[0], &Dest[1]);
+							GenAlphaBitMask(Dest[0], Dest[1], AlphaBlock, Dest + 2, NULL);
+						}
+						else
+							FitAlphaBlock(AlphaBlock, Dest);
+						break;
+
+					case IL_DXT1:
+					case IL_DXT1A:
+						GetAlphaBlock(AlphaBlock, Alpha + Plane, Image, x, y);
+						HasAlpha = IL_FALSE;
+						for (i = 0 ; i < 16; i++) {
+							if (AlphaBlock[i] < 128) {
+								HasAlpha = IL_TRUE;
+								break;
 							}
-
-							GetBlock(Block, Runner16, Image, x, y);
-							ChooseEndpoints(Block, &t0, &t1);
-							ex0 = IL_MAX(t0, t1);
-							ex1 = IL_MIN(t0, t1);
-							CorrectEndDXT1(&ex0, &ex1, 0);
-							SaveLittleUShort(context, ex0);
-							SaveLittleUShort(context, ex1);
-							BitMask = GenBitMask(ex0, ex1, 4, Block, NULL, NULL);
-							SaveLittleUInt(context, BitMask);
-							Count += 16;
 						}
-					}
 
-					Runner16 += Image->Width * Image->Height;
-					Runner8 += Image->Width * Image->Height;
-				}
-				break;
+						if (Rgb != NULL) {
+							GetRgbBlock(RgbBlock, Rgb + Plane * 3, Image, x, y);
+							FitColourBlock(RgbBlock, HasAlpha ? AlphaBlock : NULL, Quality == IL_DXTC_CLUSTER_FIT, Dest);
+							break;
+						}
 
-			case IL_RXGB:
-			case IL_DXT5:
-				for (z = 0; z < Image->Depth; z++) {
-					for (y = 0; y < Image->Height; y += 4) {
-						for (x = 0; x < Image->Width; x += 4) {
-							GetAlphaBlock(AlphaBlock, Runner8, Image, x, y);
-							ChooseAlphaEndpoints(AlphaBlock, &a0, &a1);
-							GenAlphaBitMask(a0, a1, AlphaBlock, AlphaBitMask, NULL/*AlphaOut*/);
-							/*Rms2 = RMSAlpha(AlphaBlock, AlphaOut);
-							GenAlphaBitMask(a0, a1, 8, AlphaBlock, AlphaBitMask, AlphaOut);
-							Rms1 = RMSAlpha(AlphaBlock, AlphaOut);
-							if (Rms2 <= Rms1) {  // Yeah, we have to regenerate...
-								GenAlphaBitMask(a0, a1, 6, AlphaBlock, AlphaBitMask, AlphaOut);
-								Rms2 = a1;  // Just reuse Rms2 as a temporary variable...
-								a1 = a0;
-								a0 = Rms2;
-							}*/
-							context->impl->iputc(context, a0);
-							context->impl->iputc(context, a1);
-							context->impl->iwrite(context, AlphaBitMask, 1, 6);
-
-							GetBlock(Block, Runner16, Image, x, y);
-							ChooseEndpoints(Block, &t0, &t1);
-							ex0 = IL_MAX(t0, t1);
-							ex1 = IL_MIN(t0, t1);
-							CorrectEndDXT1(&ex0, &ex1, 0);
-							SaveLittleUShort(context, ex0);
-							SaveLittleUShort(context, ex1);
+						GetBlock(Block, Data + Plane, Image, x, y);
+						ChooseEndpoints(Block, &ex0, &ex1);
+						CorrectEndDXT1(&ex0, &ex1, HasAlpha);
+						if (HasAlpha)
+							BitMask = GenBitMask(ex0, ex1, 3, Block, AlphaBlock, NULL);
+						else
 							BitMask = GenBitMask(ex0, ex1, 4, Block, NULL, NULL);
-							SaveLittleUInt(context, BitMask);
-							Count += 16;
+						iPutColourBlock(Dest, ex0, ex1, BitMask);
+						break;
+
+					case IL_DXT3:
+						GetAlphaBlock(AlphaBlock, Alpha + Plane, Image, x, y);
+						for (i = 0; i < 16; i += 2) {
+							if (Quality == IL_DXTC_MINMAX)
+								Dest[i / 2] = (ILubyte)(((AlphaBlock[i+1] >> 4) << 4) | (AlphaBlock[i] >> 4));
+							else  // Rounded to the nearest of the 16 levels
+								Dest[i / 2] = (ILubyte)((((AlphaBlock[i+1] * 15 + 127) / 255) << 4) | ((AlphaBlock[i] * 15 + 127) / 255));
+						}
+						// The colour block is the same as in DXT5.
+						// fall through
+					case IL_RXGB:
+					case IL_DXT5:
+						if (DXTCFormat != IL_DXT3) {
+							GetAlphaBlock(AlphaBlock, Alpha + Plane, Image, x, y);
+							if (Quality == IL_DXTC_MINMAX) {
+								ChooseAlphaEndpoints(AlphaBlock, &Dest[0], &Dest[1]);
+								GenAlphaBitMask(Dest[0], Dest[1], AlphaBlock, Dest + 2, NULL);
+							}
+							else
+								FitAlphaBlock(AlphaBlock, Dest);
+						}
+
+						if (Rgb != NULL) {
+							GetRgbBlock(RgbBlock, Rgb + Plane * 3, Image, x, y);
+							FitColourBlock(RgbBlock, NULL, Quality == IL_DXTC_CLUSTER_FIT, Dest + 8);
+							break;
 						}
-					}
 
-					Runner16 += Image->Width * Image->Height;
-					Runner8 += Image->Width * Image->Height;
+						GetBlock(Block, Data + Plane, Image, x, y);
+						ChooseEndpoints(Block, &t0, &t1);
+						ex0 = IL_MAX(t0, t1);
+						ex1 = IL_MIN(t0, t1);
+						CorrectEndDXT1(&ex0, &ex1, 0);
+						BitMask = GenBitMask(ex0, ex1, 4, Block, NULL, NULL);
+						iPutColourBlock(Dest + 8, ex0, ex1, BitMask);
+						break;
 				}
-				break;
+			}
 		}
+	});
+
+	if (TempImage != NULL)
+		ilCloseImage(context, TempImage);
+	if (DXTCFormat == IL_3DC)
+		ifree(context, Bytes);
+	ifree(context, Data);
+	ifree(context, Rgb);
+	ifree(context, Alpha);
+	return IL_TRUE;
 
-		ifree(Data);
-		ifree(Alpha);
-	} //else no 3DC
-
-	return Count;  // Returns 0 if no compression was done.
+fail:
+	ifree(context, Data);
+	ifree(context, Rgb);
+	ifree(context, Alpha);
+	return IL_FALSE;
 }
 
 // Assumed to be 16-bit (5:6:5).
@@ -965,12 +1075,14 @@ ILboolean Get3DcBlock(ILubyte *Block, ILubyte *Data, ILimage *Image, ILuint XPos
 
 	for (y = 0; y < 4; y++) {
 		for (x = 0; x < 4; x++) {
-			if (x < Image->Width && y < Image->Height)
+			if (XPos + x < Image->Width && YPos + y < Image->Height)
                 Block[i++] = Data[Offset + 2*x];
             else
                 Block[i++] = Data[Offset];
 		}
-        Offset += 2*Image->Width;
+		// Same as GetBlock: do not read past the end of the image.
+		if (YPos + y + 1 < Image->Height)
+			Offset += 2*Image->Width;
 	}
 
 	return IL_TRUE;
@@ -1231,23 +1343,349 @@ void PreMult(ILushort *Data, ILubyte *Alpha)
 	return;
 }
 
+// Stores the colour half of a block: the two endpoints and the index bits.
+static void iPutColourBlock(ILubyte *Dest, ILushort ex0, ILushort ex1, ILuint BitMask)
+{
+	Dest[0] = (ILubyte)ex0;
+	Dest[1] = (ILubyte)(ex0 >> 8);
+	Dest[2] = (ILubyte)ex1;
+	Dest[3] = (ILubyte)(ex1 >> 8);
+	Dest[4] = (ILubyte)BitMask;
+	Dest[5] = (ILubyte)(BitMask >> 8);
+	Dest[6] = (ILubyte)(BitMask >> 16);
+	Dest[7] = (ILubyte)(BitMask >> 24);
+}
+
+// Same as GetBlock, for packed RGB bytes.
+static void GetRgbBlock(ILubyte *Block, ILubyte *Data, ILimage *Image, ILuint XPos, ILuint YPos)
+{
+	ILuint x, y, Offset = (YPos * Image->Width + XPos) * 3;
+
+	for (y = 0; y < 4; y++) {
+		for (x = 0; x < 4; x++, Block += 3) {
+			if (XPos + x < Image->Width && YPos + y < Image->Height)
+				memcpy(Block, Data + Offset + x * 3, 3);
+			else
+				memcpy(Block, Data + Offset, 3);
+		}
+		if (YPos + y + 1 < Image->Height)
+			Offset += Image->Width * 3;
+	}
+}
+
+// Copies a 4x4 block of PixelSize-byte pixels, repeating the last column and
+//  row of the image past its edges.
+static void GetPixelBlock(ILubyte *Block, ILubyte *Data, ILimage *Image, ILuint XPos, ILuint YPos, ILuint PixelSize)
+{
+	ILuint x, y, Row;
+
+	for (y = 0; y < 4; y++) {
+		Row = IL_MIN(YPos + y, Image->Height - 1) * Image->Width;
+		for (x = 0; x < 4; x++, Block += PixelSize)
+			memcpy(Block, Data + (Row + IL_MIN(XPos + x, Image->Width - 1)) * PixelSize, PixelSize);
+	}
+}
+
+// Rounds a colour channel to the nearest level of Bits bits, expanded back to
+//  8 bits the way decoders do it.
+static inline ILfloat iSnapChannel(ILfloat Value, ILint Bits)
+{
+	ILint Max = (1 << Bits) - 1, q = (ILint)(Value * Max / 255.0f + 0.5f);
+
+	q = IL_MAX(0, IL_MIN(Max, q));
+	return (ILfloat)((q << (8 - Bits)) | (q >> (2 * Bits - 8)));
+}
+
+static ILushort iQuantize565(const ILfloat *Colour)
+{
+	ILint r = (ILint)(Colour[0] * 31 / 255.0f + 0.5f);
+	ILint g = (ILint)(Colour[1] * 63 / 255.0f + 0.5f);
+	ILint b = (ILint)(Colour[2] * 31 / 255.0f + 0.5f);
+
+	r = IL_MAX(0, IL_MIN(31, r));
+	g = IL_MAX(0, IL_MIN(63, g));
+	b = IL_MAX(0, IL_MIN(31, b));
+	return (ILushort)((r << 11) | (g << 5) | b);
+}
+
+// Chooses the index of every pixel for the endpoints ex0 and ex1 and returns
+//  the squared error.  The palette is built the way DecompressDXT1 builds it,
+//  so ex0 <= ex1 gives three colours and transparency.
+static ILuint iColourIndices(const ILubyte *Rgb, const ILubyte *Alpha, ILushort ex0, ILushort ex1, ILuint *BitMask)
+{
+	ILint	Pal[4][3], d[3];
+	ILuint	i, j, NumCols, Dist, Best, Index, Error = 0;
+
+	Pal[0][0] = ((ex0 >> 11) << 3) | (ex0 >> 13);
+	Pal[0][1] = (((ex0 >> 5) & 0x3F) << 2) | ((ex0 >> 9) & 0x3);
+	Pal[0][2] = ((ex0 & 0x1F) << 3) | ((ex0 >> 2) & 0x7);
+	Pal[1][0] = ((ex1 >> 11) << 3) | (ex1 >> 13);
+	Pal[1][1] = (((ex1 >> 5) & 0x3F) << 2) | ((ex1 >> 9) & 0x3);
+	Pal[1][2] = ((ex1 & 0x1F) << 3) | ((ex1 >> 2) & 0x7);
+	for (j = 0; j < 3; j++) {
+		if (ex0 > ex1) {
+			Pal[2][j] = (2 * Pal[0][j] + Pal[1][j] + 1) / 3;
+			Pal[3][j] = (Pal[0][j] + 2 * Pal[1][j] + 1) / 3;
+		}
+		else {
+			Pal[2][j] = (Pal[0][j] + Pal[1][j]) / 2;
+			Pal[3][j] = 0;
+		}
+	}
+	NumCols = ex0 > ex1 ? 4 : 3;
+
+	*BitMask = 0;
+	for (i = 0; i < 16; i++, Rgb += 3) {
+		if (Alpha && Alpha[i] < 128) {
+			*BitMask |= 3u << (i * 2);  // Transparent
+			continue;
+		}
+
+		Best = UINT_MAX;
+		Index = 0;
+		for (j = 0; j < NumCols; j++) {
+			d[0] = Rgb[0] - Pal[j][0];
+			d[1] = Rgb[1] - Pal[j][1];
+			d[2] = Rgb[2] - Pal[j][2];
+			Dist = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+			if (Dist < Best) {
+				Best = Dist;
+				Index = j;
+			}
+		}
+		*BitMask |= Index << (i * 2);
+		Error += Best;
+	}
+
+	return Error;
+}
+
+// Quantises the endpoints Start and End, orders them for a four-colour block
+//  (or a three-colour one if there is transparency) and chooses the indices.
+static ILuint iEncodeColours(const ILubyte *Rgb, const ILubyte *Alpha, const ILfloat *Start, const ILfloat *End,
+								ILushort *ex0, ILushort *ex1, ILuint *BitMask)
+{
+	ILushort Temp;
+
+	*ex0 = iQuantize565(Start);
+	*ex1 = iQuantize565(End);
+	if (Alpha ? *ex0 > *ex1 : *ex0 < *ex1) {
+		Temp = *ex0;
+		*ex0 = *ex1;
+		*ex1 = Temp;
+	}
+
+	return iColourIndices(Rgb, Alpha, *ex0, *ex1, BitMask);
+}
+
+// Cluster fit: tries every way of splitting the points, taken in order along
+//  the principal axis, into runs that share an index, and keeps the least
+//  squares endpoints of the split with the smallest error.  Weights holds the
+//  share of Start in each index (three of them with transparency, else four).
+static void iClusterFit(ILfloat Points[16][3], const ILuint *Order, ILuint NumPoints, ILboolean Three,
+							ILfloat *Start, ILfloat *End)
+{
+	static const ILfloat Weights3[4] = { 1.0f, 0.5f, 0.0f, 0.0f };
+	static const ILfloat Weights4[4] = { 1.0f, 2.0f / 3.0f, 1.0f / 3.0f, 0.0f };
+	const ILfloat	*Weights = Three ? Weights3 : Weights4;
+	ILfloat			Prefix[17][3], Sums[4][3], Counts[4], AA, BB, AB, AX, BX, Det, a, b, Error, BestError = 1e30f;
+	ILfloat			New[2][3];
+	ILuint			Bounds[5], i, j, k, c, n, Last;
+
+	Prefix[0][0] = Prefix[0][1] = Prefix[0][2] = 0;
+	for (i = 0; i < NumPoints; i++) {
+		for (c = 0; c < 3; c++)
+			Prefix[i + 1][c] = Prefix[i][c] + Points[Order[i]][c];
+	}
+
+	// Bounds[n] is the first point of run n; the last run is empty with three colours.
+	Bounds[0] = 0;
+	Bounds[4] = NumPoints;
+	for (i = 0; i <= NumPoints; i++) {
+		for (j = i; j <= NumPoints; j++) {
+			Last = Three ? j : NumPoints;
+			for (k = j; k <= Last; k++) {
+				Bounds[1] = i;
+				Bounds[2] = j;
+				Bounds[3] = Three ? NumPoints : k;
+
+				AA = BB = AB = 0;
+				for (n = 0; n < 4; n++) {
+					Counts[n] = (ILfloat)(Bounds[n + 1] - Bounds[n]);
+					for (c = 0; c < 3; c++)
+						Sums[n][c] = Prefix[Bounds[n + 1]][c] - Prefix[Bounds[n]][c];
+					AA += Counts[n] * Weights[n] * Weights[n];
+					BB += Counts[n] * (1 - Weights[n]) * (1 - Weights[n]);
+					AB += Counts[n] * Weights[n] * (1 - Weights[n]);
+				}
+				Det = AA * BB - AB * AB;
+				if (Det < 1e-6f)
+					continue;
+
+				Error = 0;
+				for (c = 0; c < 3; c++) {
+					AX = BX = 0;
+					for (n = 0; n < 4; n++) {
+						AX += Weights[n] * Sums[n][c];
+						BX += (1 - Weights[n]) * Sums[n][c];
+					}
+					a = iSnapChannel((AX * BB - BX * AB) / Det, c == 1 ? 6 : 5);
+					b = iSnapChannel((BX * AA - AX * AB) / Det, c == 1 ? 6 : 5);
+					New[0][c] = a;
+					New[1][c] = b;
+					Error += a * a * AA + b * b * BB + 2 * (a * b * AB - a * AX - b * BX);
+				}
+
+				if (Error < BestError) {
+					BestError = Error;
+					memcpy(Start, New[0], sizeof(New[0]));
+					memcpy(End, New[1], sizeof(New[1]));
+				}
+			}
+		}
+	}
+}
+
+// Finds endpoints for the colour half of a block from its 8-bit colours.  The
+//  range fit takes the extremes of the colours along their principal axis;
+//  the cluster fit also searches the splits along that axis and keeps
+//  whichever of the two is better.  With Alpha, pixels below 128 are left
+//  transparent.
+static void FitColourBlock(ILubyte *Rgb, ILubyte *Alpha, ILboolean Cluster, ILubyte *Out)
+{
+	ILfloat		Points[16][3], Dots[16], Mean[3] = { 0, 0, 0 }, Cov[6] = { 0, 0, 0, 0, 0, 0 };
+	ILfloat		Axis[3] = { 1, 1, 1 }, Next[3], Start[3], End[3], d[3], Min, Max, Len;
+	ILuint		Order[16], NumPoints = 0, i, j, c, Temp, Error, BestError, BitMask, BestMask;
+	ILushort	ex0, ex1, Best0, Best1;
+
+	for (i = 0; i < 16; i++) {
+		if (Alpha && Alpha[i] < 128)
+			continue;
+		for (c = 0; c < 3; c++) {
+			Points[NumPoints][c] = Rgb[i * 3 + c];
+			Mean[c] += Rgb[i * 3 + c];
+		}
+		NumPoints++;
+	}
+	if (NumPoints == 0) {  // Fully transparent
+		iPutColourBlock(Out, 0, 0, 0xFFFFFFFF);
+		return;
+	}
+
+	for (c = 0; c < 3; c++)
+		Mean[c] /= NumPoints;
+	for (i = 0; i < NumPoints; i++) {
+		for (c = 0; c < 3; c++)
+			d[c] = Points[i][c] - Mean[c];
+		Cov[0] += d[0] * d[0];
+		Cov[1] += d[0] * d[1];
+		Cov[2] += d[0] * d[2];
+		Cov[3] += d[1] * d[1];
+		Cov[4] += d[1] * d[2];
+		Cov[5] += d[2] * d[2];
+	}
+
+	// Principal axis by power iteration
+	for (j = 0; j < 8; j++) {
+		Next[0] = Cov[0] * Axis[0] + Cov[1] * Axis[1] + Cov[2] * Axis[2];
+		Next[1] = Cov[1] * Axis[0] + Cov[3] * Axis[1] + Cov[4] * Axis[2];
+		Next[2] = Cov[2] * Axis[0] + Cov[4] * Axis[1] + Cov[5] * Axis[2];
+		Max = IL_MAX(fabsf(Next[0]), IL_MAX(fabsf(Next[1]), fabsf(Next[2])));
+		if (Max == 0)
+			break;
+		for (c = 0; c < 3; c++)
+			Axis[c] = Next[c] / Max;
+	}
+	Len = sqrtf(Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2]);
+	for (c = 0; c < 3; c++)
+		Axis[c] /= Len;
+
+	Min = Max = 0;
+	for (i = 0; i < NumPoints; i++) {
+		Dots[i] = (Points[i][0] - Mean[0]) * Axis[0] + (Points[i][1] - Mean[1]) * Axis[1]
+			+ (Points[i][2] - Mean[2]) * Axis[2];
+		Min = IL_MIN(Min, Dots[i]);
+		Max = IL_MAX(Max, Dots[i]);
+	}
+	for (c = 0; c < 3; c++) {
+		Start[c] = IL_MAX(0, IL_MIN(255, Mean[c] + Axis[c] * Max));
+		End[c] = IL_MAX(0, IL_MIN(255, Mean[c] + Axis[c] * Min));
+	}
+	BestError = iEncodeColours(Rgb, Alpha, Start, End, &Best0, &Best1, &BestMask);
+
+	if (Cluster && NumPoints > 1 && BestError > 0) {
+		for (i = 0; i < NumPoints; i++)
+			Order[i] = i;
+		for (i = 1; i < NumPoints; i++) {  // Insertion sort by position along the axis
+			Temp = Order[i];
+			for (j = i; j > 0 && Dots[Order[j - 1]] < Dots[Temp]; j--)
+				Order[j] = Order[j - 1];
+			Order[j] = Temp;
+		}
+
+		iClusterFit(Points, Order, NumPoints, Alpha != NULL, Start, End);
+		Error = iEncodeColours(Rgb, Alpha, Start, End, &ex0, &ex1, &BitMask);
+		if (Error < BestError) {
+			Best0 = ex0;
+			Best1 = ex1;
+			BestMask = BitMask;
+		}
+	}
+
+	iPutColourBlock(Out, Best0, Best1, BestMask);
+}
+
+// Picks the better of an eight-alpha block spanning all the values and a
+//  six-alpha block spanning those other than 0 and 255, which it has for free.
+static void FitAlphaBlock(ILubyte *Block, ILubyte *Out)
+{
+	ILubyte	Min = 0xFF, Max = 0, Min6 = 0xFF, Max6 = 0, Test[16], Mask[6];
+	ILuint	i, Error6, Error8;
+
+	for (i = 0; i < 16; i++) {
+		Min = IL_MIN(Min, Block[i]);
+		Max = IL_MAX(Max, Block[i]);
+		if (Block[i] != 0 && Block[i] != 0xFF) {
+			Min6 = IL_MIN(Min6, Block[i]);
+			Max6 = IL_MAX(Max6, Block[i]);
+		}
+	}
+	if (Min6 > Max6)  // Only 0 and 255
+		Min6 = Max6 = 0;
+
+	Out[0] = Min6;
+	Out[1] = Max6;
+	GenAlphaBitMask(Min6, Max6, Block, Out + 2, Test);
+	Error6 = RMSAlpha(Block, Test);
+
+	if (Max > Min && Error6 > 0) {
+		GenAlphaBitMask(Max, Min, Block, Mask, Test);
+		Error8 = RMSAlpha(Block, Test);
+		if (Error8 < Error6) {
+			Out[0] = Max;
+			Out[1] = Min;
+			memcpy(Out + 2, Mask, 6);
+		}
+	}
+}
+
 //! Compresses data to a DXT format using different methods.
-//  The data must be in unsigned byte RGBA or BGRA format.  Only DXT1, DXT3 and DXT5 are supported.
+//  The data must be in unsigned byte RGBA or BGRA format.  Any format ilGetDXTCData writes is supported.
 ILAPI ILubyte* ILAPIENTRY ilCompressDXT(ILcontext* context, ILubyte *Data, ILuint Width, ILuint Height, ILuint Depth, ILenum DXTCFormat, ILuint *DXTCSize)
 {
 	ILimage *TempImage, *CurImage = context->impl->iCurImage;
 	ILuint	BuffSize;
 	ILubyte	*Buffer;
 
-	if ((DXTCFormat != IL_DXT1 && DXTCFormat != IL_DXT1A && DXTCFormat != IL_DXT3 && DXTCFormat != IL_DXT5)
-		|| Data == NULL || Width == 0 || Height == 0 || Depth == 0) {
+	if (iDxtcBlockSize(DXTCFormat) == 0 || Data == NULL || Width == 0 || Height == 0 || Depth == 0) {
 		ilSetError(context, IL_INVALID_PARAM);
 		return NULL;
 	}
 
 	// We want to try nVidia compression first, because it is the fastest.
 #ifdef IL_USE_DXTC_NVIDIA
-	if (ilIsEnabled(context, IL_NVIDIA_COMPRESS) && Depth == 1) {  // See if we need to use the nVidia Texture Tools library.
+	if (ilIsEnabled(context, IL_NVIDIA_COMPRESS) && Depth == 1
+		&& (DXTCFormat == IL_DXT1 || DXTCFormat == IL_DXT1A || DXTCFormat == IL_DXT3 || DXTCFormat == IL_DXT5)) {  // See if we need to use the nVidia Texture Tools library.
 		// NVTT needs data as BGRA 32-bit.
 		// Here's where all the compression and writing goes on.
 		return ilNVidiaCompressDXT(Data, Width, Height, 1, DXTCFormat, DXTCSize);
@@ -1274,28 +1712,26 @@ ILAPI ILubyte* ILAPIENTRY ilCompressDXT(ILcontext* context, ILubyte *Data, ILuin
 	TempImage->Format = IL_BGRA;
 	TempImage->Bpc = 1;  // Unsigned bytes only
 	TempImage->Type = IL_UNSIGNED_BYTE;
+	TempImage->Bps = Width * 4;
 	TempImage->SizeOfPlane = TempImage->Bps * Height;
 	TempImage->SizeOfData  = TempImage->SizeOfPlane * Depth;
 	TempImage->Origin = IL_ORIGIN_UPPER_LEFT;
 	TempImage->Data = Data;
+	context->impl->iCurImage = TempImage;  // ilGetDXTCData and ilGetAlpha work on the current image.
 
 	BuffSize = ilGetDXTCData(context, NULL, 0, DXTCFormat);
-	if (BuffSize == 0)
-		return NULL;
-	Buffer = (ILubyte*)ialloc(context, BuffSize);
-	if (Buffer == NULL)
-		return NULL;
-
-	if (ilGetDXTCData(context, Buffer, BuffSize, DXTCFormat) != BuffSize) {
-		ifree(Buffer);
-		return NULL;
+	Buffer = BuffSize ? (ILubyte*)ialloc(context, BuffSize) : NULL;
+	if (Buffer != NULL && ilGetDXTCData(context, Buffer, BuffSize, DXTCFormat) != BuffSize) {
+		ifree(context, Buffer);
+		Buffer = NULL;
 	}
-	*DXTCSize = BuffSize;
+	if (Buffer != NULL)
+		*DXTCSize = BuffSize;
 
 	// Restore backup of context->impl->iCurImage.
 	context->impl->iCurImage = CurImage;
 	TempImage->Data = NULL;
-	ilCloseImage(TempImage);
+	ilCloseImage(context, TempImage);
 
 	return Buffer;
 }
\ No newline at end of file
@@ -23,6 +23,8 @@
 //	too strictly while reading.
 
 #include "il_internal.h"
+#include "il_simd.h"
+#include "il_threads.h"
 
 #ifndef IL_NO_DDS
 
@@ -38,6 +40,9 @@ ILuint CubemapDirections[CUBEMAP_SIDES] = {
 };
 
 ILboolean	check(DDSHEAD *Head);
+ILboolean	iCheckDxt10(DXT10HEAD *Head);
+ILuint		iDx10BlockBytes(ILuint DxgiFormat);
+ILboolean	iGetDXT10Head(ILcontext* context, DXT10HEAD *Header);
 void		GetBitsFromMask(ILuint Mask, ILuint *ShiftLeft, ILuint *ShiftRight);
 
 DdsHandler::DdsHandler(ILcontext* context) :
@@ -72,7 +77,7 @@ ILboolean DdsHandler::isValid(ILconst_string FileName)
 //! Checks if the ILHANDLE contains a valid .dds file at the current position.
 ILboolean DdsHandler::isValidF(ILHANDLE File)
 {
-	ILuint		FirstPos;
+	ILuint64	FirstPos;
 	ILboolean	bRet;
 
 	iSetInputFile(context, File);
@@ -154,6 +159,81 @@ ILboolean DdsHandler::isValidInternal()
 	return IsValid;
 }
 
+// Reads the image properties from an already-opened .dds without decoding the pixels
+ILboolean DdsHandler::getInfoF(ILHANDLE File, ILimageinfo *Info)
+{
+	ILuint64	FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = getInfoInternal(Info);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+// Reads the image properties from a memory "lump" without decoding the pixels
+ILboolean DdsHandler::getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info)
+{
+	iSetInputLump(context, Lump, Size);
+	return getInfoInternal(Info);
+}
+
+// Reads DDSHEAD (and the DX10 extension) and works out what loadInternal would build from it.
+ILboolean DdsHandler::getInfoInternal(ILimageinfo *Info)
+{
+	ILuint		CompFormat, i;
+	ILboolean	IsDXT10 = IL_FALSE;
+	ILubyte		Channels;
+
+	iGetDdsHead(&Head);
+	if (!check(&Head)) {
+		ilSetError(context, IL_INVALID_FILE_HEADER);
+		return IL_FALSE;
+	}
+
+	DecodePixelFormat(&CompFormat);
+	if (CompFormat == PF_UNKNOWN) {
+		ilSetError(context, IL_INVALID_FILE_HEADER);
+		return IL_FALSE;
+	}
+	if (CompFormat == PF_DX10) {
+		IsDXT10 = IL_TRUE;
+		iGetDXT10Head(context, &HeadDXT10);
+		if (!iCheckDxt10(&HeadDXT10)) {
+			ilSetError(context, IL_INVALID_FILE_HEADER);
+			return IL_FALSE;
+		}
+		CompFormat = HeadDXT10.dxgiFormat;
+	}
+
+	Check16BitComponents(&Head);
+	if (!GetImageFormat(CompFormat, IsDXT10, &Channels, &Info->Format, &Info->Type))
+		return IL_FALSE;
+
+	Info->Width = Head.Width;
+	Info->Height = Head.Height;
+	Info->Depth = Head.Depth;
+	// Same rule as AdjustVolumeTexture
+	if (Info->Depth > 1 && !IsDXT10 && !(Head.ddsCaps2 & DDS_VOLUME))
+		Info->Depth = 1;
+
+	if ((!IsDXT10 || iDx10BlockBytes(CompFormat) != 0) && (Head.Flags1 & DDS_MIPMAPCOUNT) && Head.MipMapCount > 0)
+		Info->NumMips = Head.MipMapCount - 1;
+
+	if ((Head.ddsCaps1 & DDS_COMPLEX) && (Head.ddsCaps2 & DDS_CUBEMAP)) {
+		for (i = 0; i < CUBEMAP_SIDES; i++) {
+			if (Head.ddsCaps2 & CubemapDirections[i])
+				Info->NumFaces++;
+		}
+		if (Info->NumFaces > 0)
+			Info->NumFaces--;
+	}
+
+	return IL_TRUE;
+}
+
 // Internal function used to check if the HEADER is a valid .dds header.
 ILboolean check(DDSHEAD *Head)
 {
@@ -183,6 +263,35 @@ ILboolean iCheckDxt10(DXT10HEAD *Head)
 	return IL_TRUE;
 }
 
+// Size of a 4x4 block of the block compressed DirectX 10 formats that can be
+//  loaded, or 0 for any other format.
+ILuint iDx10BlockBytes(ILuint DxgiFormat)
+{
+	switch (DxgiFormat)
+	{
+		case DXGI_FORMAT_BC1_TYPELESS:
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+			return 8;
+
+		case DXGI_FORMAT_BC2_TYPELESS:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_TYPELESS:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC6H_TYPELESS:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+		case DXGI_FORMAT_BC7_TYPELESS:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return 16;
+	}
+
+	return 0;
+}
+
 //! Reads a .dds file
 ILboolean DdsHandler::load(ILconst_string FileName)
 {
@@ -204,7 +313,7 @@ ILboolean DdsHandler::load(ILconst_string FileName)
 //! Reads an already-opened .dds file
 ILboolean DdsHandler::loadF(ILHANDLE File)
 {
-	ILuint		FirstPos;
+	ILuint64	FirstPos;
 	ILboolean	bRet;
 
 	iSetInputFile(context, File);
@@ -345,7 +454,7 @@ ILboolean DdsHandler::iLoadCubemapInternal(ILuint CompFormat, ILboolean IsDXT10)
 
 			if (!AllocImage(CompFormat, IsDXT10)) {
 				if (CompData) {
-					ifree(CompData);
+					ifree(context, CompData);
 					CompData = NULL;
 				}
 				return IL_FALSE;
@@ -355,7 +464,7 @@ ILboolean DdsHandler::iLoadCubemapInternal(ILuint CompFormat, ILboolean IsDXT10)
 
 			if (!DdsDecompress(CompFormat, IsDXT10)) {
 				if (CompData) {
-					ifree(CompData);
+					ifree(context, CompData);
 					CompData = NULL;
 				}
 				return IL_FALSE;
@@ -363,7 +472,7 @@ ILboolean DdsHandler::iLoadCubemapInternal(ILuint CompFormat, ILboolean IsDXT10)
 
 			if (!ReadMipmaps(CompFormat, IsDXT10)) {
 				if (CompData) {
-					ifree(CompData);
+					ifree(context, CompData);
 					CompData = NULL;
 				}
 				return IL_FALSE;
@@ -372,7 +481,7 @@ ILboolean DdsHandler::iLoadCubemapInternal(ILuint CompFormat, ILboolean IsDXT10)
 	}
 
 	if (CompData) {
-		ifree(CompData);
+		ifree(context, CompData);
 		CompData = NULL;
 	}
 
@@ -428,6 +537,19 @@ ILboolean DdsHandler::loadInternal()
 		}
 
 		CompFormat = HeadDXT10.dxgiFormat;
+
+		// Writers disagree on what LinearSize holds for these, but the size
+		//  follows from the dimensions.
+		if (iDx10BlockBytes(CompFormat) != 0) {
+			ILuint64 Size = (ILuint64)((Head.Width + 3) / 4) * ((Head.Height + 3) / 4) * Head.Depth
+				* iDx10BlockBytes(CompFormat);
+			if (Size > 0xFFFFFFFF) {
+				ilSetError(context, IL_INVALID_FILE_HEADER);
+				return IL_FALSE;
+			}
+			Head.Flags1 |= DDS_LINEARSIZE;
+			Head.LinearSize = (ILuint)Size;
+		}
 	}
 	else
 	{
@@ -461,14 +583,14 @@ ILboolean DdsHandler::loadInternal()
 		return IL_FALSE;
 	if (!AllocImage(CompFormat, IsDXT10)) {
 		if (CompData) {
-			ifree(CompData);
+			ifree(context, CompData);
 			CompData = NULL;
 		}
 		return IL_FALSE;
 	}
 	if (!DdsDecompress(CompFormat, IsDXT10)) {
 		if (CompData) {
-			ifree(CompData);
+			ifree(context, CompData);
 			CompData = NULL;
 		}
 		return IL_FALSE;
@@ -476,14 +598,14 @@ ILboolean DdsHandler::loadInternal()
 
 	if (!ReadMipmaps(CompFormat, IsDXT10)) {
 		if (CompData) {
-			ifree(CompData);
+			ifree(context, CompData);
 			CompData = NULL;
 		}
 		return IL_FALSE;
 	}
 
 	if (CompData) {
-		ifree(CompData);
+		ifree(context, CompData);
 		CompData = NULL;
 	}
 
@@ -807,7 +929,7 @@ ILboolean DdsHandler::ReadData(ILuint CompFormat, ILboolean IsDXT10)
 	ILubyte	*Temp;
 
 	if (CompData) {
-		ifree(CompData);
+		ifree(context, CompData);
 		CompData = NULL;
 	}
 
@@ -820,7 +942,7 @@ ILboolean DdsHandler::ReadData(ILuint CompFormat, ILboolean IsDXT10)
 		}
 
 		if (context->impl->iread(context, CompData, 1, Head.LinearSize) != (ILuint)Head.LinearSize) {
-			ifree(CompData);
+			ifree(context, CompData);
 			CompData = NULL;
 			return IL_FALSE;
 		}
@@ -830,7 +952,7 @@ ILboolean DdsHandler::ReadData(ILuint CompFormat, ILboolean IsDXT10)
 			Bps = Head.LinearSize;  //@TODO: Head.RGBBitCount is always 0 from the texconv.exe tool?
 		else
 			Bps = Width * Head.RGBBitCount / 8;
-		CompSize = Bps * Height * Depth;
+		CompSize = (ILsizei)Bps * Height * Depth;
 		if (CompSize == 0) {
 			ilSetError(context, IL_INVALID_FILE_HEADER);
 			return IL_FALSE;
@@ -845,7 +967,7 @@ ILboolean DdsHandler::ReadData(ILuint CompFormat, ILboolean IsDXT10)
 		for (z = 0; z < Depth; z++) {
 			for (y = 0; y < Height; y++) {
 				if (context->impl->iread(context, Temp, 1, Bps) != Bps) {
-					ifree(CompData);
+					ifree(context, CompData);
 					CompData = NULL;
 					return IL_FALSE;
 				}
@@ -857,57 +979,57 @@ ILboolean DdsHandler::ReadData(ILuint CompFormat, ILboolean IsDXT10)
 	return IL_TRUE;
 }
 
-ILboolean DdsHandler::AllocImage(ILuint CompFormat, ILboolean IsDXT10)
+// Works out the channels, format and type AllocImage gives the image for CompFormat,
+//  which is also what getInfoInternal reports.
+ILboolean DdsHandler::GetImageFormat(ILuint CompFormat, ILboolean IsDXT10, ILubyte *Channels, ILenum *Format, ILenum *Type)
 {
-	ILubyte channels = 4;
-	ILenum format = IL_RGBA;
+	*Channels = 4;
+	*Format = IL_RGBA;
+	*Type = IL_UNSIGNED_BYTE;
 
 	if (!IsDXT10)
 	{
 		switch (CompFormat)
 		{
 			case PF_RGB:
-				if (!ilTexImage(context, Width, Height, Depth, 3, IL_RGB, IL_UNSIGNED_BYTE, NULL))
-					return IL_FALSE;
+				*Channels = 3;
+				*Format = IL_RGB;
 				break;
 			case PF_ARGB:
-				if (!ilTexImage(context, Width, Height, Depth, 4, IL_RGBA, Has16BitComponents ? IL_UNSIGNED_SHORT : IL_UNSIGNED_BYTE, NULL))
-					return IL_FALSE;
+				if (Has16BitComponents)
+					*Type = IL_UNSIGNED_SHORT;
 				break;
 
 			case PF_LUMINANCE:
-				if (Head.RGBBitCount == 16 && Head.RBitMask == 0xFFFF) { //HACK
-					if (!ilTexImage(context, Width, Height, Depth, 1, IL_LUMINANCE, IL_UNSIGNED_SHORT, NULL))
-						return IL_FALSE;
-				}
-				else
-					if (!ilTexImage(context, Width, Height, Depth, 1, IL_LUMINANCE, IL_UNSIGNED_BYTE, NULL))
-						return IL_FALSE;
+				*Channels = 1;
+				*Format = IL_LUMINANCE;
+				if (Head.RGBBitCount == 16 && Head.RBitMask == 0xFFFF) //HACK
+					*Type = IL_UNSIGNED_SHORT;
 				break;
 
 			case PF_LUMINANCE_ALPHA:
-				if (!ilTexImage(context, Width, Height, Depth, 2, IL_LUMINANCE_ALPHA, IL_UNSIGNED_BYTE, NULL))
-					return IL_FALSE;
+				*Channels = 2;
+				*Format = IL_LUMINANCE_ALPHA;
 				break;
 
 			case PF_ATI1N:
 				//right now there's no OpenGL api to use the compressed 3dc data, so
 				//throw it away (I don't know how DirectX works, though)?
-				if (!ilTexImage(context, Width, Height, Depth, 1, IL_LUMINANCE, IL_UNSIGNED_BYTE, NULL))
-					return IL_FALSE;
+				*Channels = 1;
+				*Format = IL_LUMINANCE;
 				break;
 
 			case PF_3DC:
 				//right now there's no OpenGL api to use the compressed 3dc data, so
 				//throw it away (I don't know how DirectX works, though)?
-				if (!ilTexImage(context, Width, Height, Depth, 3, IL_RGB, IL_UNSIGNED_BYTE, NULL))
-					return IL_FALSE;
+				*Channels = 3;
+				*Format = IL_RGB;
 				break;
 
 			case PF_A16B16G16R16:
-				if (!ilTexImage(context, Width, Height, Depth, iCompFormatToChannelCount(CompFormat),
-					ilGetFormatBpp(iCompFormatToChannelCount(CompFormat)), IL_UNSIGNED_SHORT, NULL))
-					return IL_FALSE;
+				*Channels = iCompFormatToChannelCount(CompFormat);
+				*Format = ilGetFormatBpp(*Channels);
+				*Type = IL_UNSIGNED_SHORT;
 				break;
 
 			case PF_R16F:
@@ -916,27 +1038,14 @@ ILboolean DdsHandler::AllocImage(ILuint CompFormat, ILboolean IsDXT10)
 			case PF_R32F:
 			case PF_G32R32F:
 			case PF_A32B32G32R32F:
-				if (!ilTexImage(context, Width, Height, Depth, iCompFormatToChannelCount(CompFormat),
-					ilGetFormatBpp(iCompFormatToChannelCount(CompFormat)), IL_FLOAT, NULL))
-					return IL_FALSE;
+				*Channels = iCompFormatToChannelCount(CompFormat);
+				*Format = ilGetFormatBpp(*Channels);
+				*Type = IL_FLOAT;
 				break;
 
-			default:
-				if (CompFormat == PF_RXGB) {
-					channels = 3; //normal map
-					format = IL_RGB;
-				}
-
-				if (!ilTexImage(context, Width, Height, Depth, channels, format, IL_UNSIGNED_BYTE, NULL))
-					return IL_FALSE;
-				if (ilGetInteger(context, IL_KEEP_DXTC_DATA) == IL_TRUE && CompData) {
-					context->impl->iCurImage->DxtcData = (ILubyte*)ialloc(context, Head.LinearSize);
-					if (context->impl->iCurImage->DxtcData == NULL)
-						return IL_FALSE;
-					context->impl->iCurImage->DxtcFormat = CompFormat - PF_DXT1 + IL_DXT1;
-					context->impl->iCurImage->DxtcSize = Head.LinearSize;
-					memcpy(context->impl->iCurImage->DxtcData, CompData, context->impl->iCurImage->DxtcSize);
-				}
+			case PF_RXGB:
+				*Channels = 3; //normal map
+				*Format = IL_RGB;
 				break;
 		}
 	}
@@ -944,23 +1053,64 @@ ILboolean DdsHandler::AllocImage(ILuint CompFormat, ILboolean IsDXT10)
 	{
 		switch (CompFormat)
 		{
+			case DXGI_FORMAT_BC1_TYPELESS:
+			case DXGI_FORMAT_BC1_UNORM:
+			case DXGI_FORMAT_BC1_UNORM_SRGB:
+			case DXGI_FORMAT_BC2_TYPELESS:
+			case DXGI_FORMAT_BC2_UNORM:
+			case DXGI_FORMAT_BC2_UNORM_SRGB:
+			case DXGI_FORMAT_BC3_TYPELESS:
+			case DXGI_FORMAT_BC3_UNORM:
+			case DXGI_FORMAT_BC3_UNORM_SRGB:
+			case DXGI_FORMAT_BC7_TYPELESS:
+			case DXGI_FORMAT_BC7_UNORM:
+			case DXGI_FORMAT_BC7_UNORM_SRGB:
+				return IL_TRUE;
+
+			case DXGI_FORMAT_BC6H_TYPELESS:
+			case DXGI_FORMAT_BC6H_UF16:
+			case DXGI_FORMAT_BC6H_SF16:
+				*Channels = 3;
+				*Format = IL_RGB;
+				*Type = IL_FLOAT;
+				return IL_TRUE;
+
 			case DXGI_FORMAT_R8G8B8A8_UNORM:
-				if (!ilTexImage(context, Width, Height, Depth, 4, IL_RGBA, Has16BitComponents ? IL_UNSIGNED_SHORT : IL_UNSIGNED_BYTE, NULL))
-					return IL_FALSE;
 				break;
 			case DXGI_FORMAT_B8G8R8A8_UNORM:
-				if (!ilTexImage(context, Width, Height, Depth, 4, IL_BGRA, Has16BitComponents ? IL_UNSIGNED_SHORT : IL_UNSIGNED_BYTE, NULL))
-					return IL_FALSE;
-				break;
 			case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
-				if (!ilTexImage(context, Width, Height, Depth, 4, IL_BGRA, Has16BitComponents ? IL_UNSIGNED_SHORT : IL_UNSIGNED_BYTE, NULL))
-					return IL_FALSE;
+				*Format = IL_BGRA;
 				break;
 
 			default:
 				ilSetError(context, IL_INVALID_FILE_HEADER);
 				return IL_FALSE;
 		}
+		if (Has16BitComponents)
+			*Type = IL_UNSIGNED_SHORT;
+	}
+
+	return IL_TRUE;
+}
+
+ILboolean DdsHandler::AllocImage(ILuint CompFormat, ILboolean IsDXT10)
+{
+	ILubyte	Channels;
+	ILenum	Format, Type;
+
+	if (!GetImageFormat(CompFormat, IsDXT10, &Channels, &Format, &Type))
+		return IL_FALSE;
+	if (!ilTexImage(context, Width, Height, Depth, Channels, Format, Type, NULL))
+		return IL_FALSE;
+
+	if (!IsDXT10 && ((CompFormat >= PF_DXT1 && CompFormat <= PF_DXT5) || CompFormat == PF_RXGB)
+		&& ilGetInteger(context, IL_KEEP_DXTC_DATA) == IL_TRUE && CompData) {
+		context->impl->iCurImage->DxtcData = (ILubyte*)ialloc(context, Head.LinearSize);
+		if (context->impl->iCurImage->DxtcData == NULL)
+			return IL_FALSE;
+		context->impl->iCurImage->DxtcFormat = CompFormat - PF_DXT1 + IL_DXT1;
+		context->impl->iCurImage->DxtcSize = Head.LinearSize;
+		memcpy(context->impl->iCurImage->DxtcData, CompData, context->impl->iCurImage->DxtcSize);
 	}
 
 	Image->Origin = IL_ORIGIN_UPPER_LEFT;
@@ -985,7 +1135,36 @@ ILboolean DdsHandler::AllocImage(ILuint CompFormat, ILboolean IsDXT10)
 ILboolean DdsHandler::DdsDecompress(ILuint CompFormat, ILboolean IsDXT10)
 {
 	if (IsDXT10)
-	{  //@TODO: Put in compressed formats
+	{
+		switch (CompFormat)
+		{
+			case DXGI_FORMAT_BC1_TYPELESS:
+			case DXGI_FORMAT_BC1_UNORM:
+			case DXGI_FORMAT_BC1_UNORM_SRGB:
+				return DecompressDXT1(Image, CompData);
+
+			case DXGI_FORMAT_BC2_TYPELESS:
+			case DXGI_FORMAT_BC2_UNORM:
+			case DXGI_FORMAT_BC2_UNORM_SRGB:
+				return DecompressDXT3(Image, CompData);
+
+			case DXGI_FORMAT_BC3_TYPELESS:
+			case DXGI_FORMAT_BC3_UNORM:
+			case DXGI_FORMAT_BC3_UNORM_SRGB:
+				return DecompressDXT5(Image, CompData);
+
+			case DXGI_FORMAT_BC6H_TYPELESS:
+			case DXGI_FORMAT_BC6H_UF16:
+				return DecompressBC6H(Image, CompData, IL_FALSE);
+
+			case DXGI_FORMAT_BC6H_SF16:
+				return DecompressBC6H(Image, CompData, IL_TRUE);
+
+			case DXGI_FORMAT_BC7_TYPELESS:
+			case DXGI_FORMAT_BC7_UNORM:
+			case DXGI_FORMAT_BC7_UNORM_SRGB:
+				return DecompressBC7(Image, CompData);
+		}
 		return DecompressARGBDX10(context, CompFormat);
 	}
 
@@ -1050,8 +1229,8 @@ ILboolean DdsHandler::ReadMipmaps(ILuint CompFormat, ILboolean IsDXT10)
 
 	ILboolean isCompressed = IL_FALSE;
 
-	if (IsDXT10)  //@TODO: Add in mipmap support
-		return IL_TRUE;
+	if (IsDXT10)
+		return ReadMipmapsDX10(CompFormat);
 
 	Bpp = iCompFormatToBpp(CompFormat);
 	Channels = iCompFormatToChannelCount(CompFormat);
@@ -1183,13 +1362,65 @@ mip_fail:
 	while (StartImage) {
 		TempImage = StartImage;
 		StartImage = StartImage->Mipmaps;
-		ifree(TempImage);
+		ifree(context, TempImage);
 	}
 
 	Image->Mipmaps = NULL;
 	return IL_FALSE;
 }
 
+// Reads the mipmaps of the block compressed DirectX 10 formats.
+ILboolean DdsHandler::ReadMipmapsDX10(ILuint CompFormat)
+{
+	ILuint	i, BlockBytes, LastLinear;
+	ILubyte	Channels;
+	ILenum	Format, Type;
+	ILimage	*StartImage;
+
+	BlockBytes = iDx10BlockBytes(CompFormat);
+	if (BlockBytes == 0)  //@TODO: Add in mipmap support for the other formats
+		return IL_TRUE;
+	if (!(Head.Flags1 & DDS_MIPMAPCOUNT) || Head.MipMapCount <= 1)
+		return IL_TRUE;
+	if (!GetImageFormat(CompFormat, IL_TRUE, &Channels, &Format, &Type))
+		return IL_FALSE;
+
+	StartImage = Image;
+	LastLinear = Head.LinearSize;
+	for (i = 0; i < Head.MipMapCount - 1; i++)
+	{
+		Width = IL_MAX(1, Width / 2);
+		Height = IL_MAX(1, Height / 2);
+		Depth = IL_MAX(1, Depth / 2);
+
+		Image->Mipmaps = ilNewImage(context, Width, Height, Depth, Channels, ilGetBpcType(Type));
+		if (Image->Mipmaps == NULL)
+			goto mip_fail;
+		Image = Image->Mipmaps;
+		Image->Origin = IL_ORIGIN_UPPER_LEFT;
+		Image->Format = Format;
+		Image->Type = Type;
+
+		Head.LinearSize = ((Width + 3) / 4) * ((Height + 3) / 4) * Depth * BlockBytes;
+		if (!ReadData(CompFormat, IL_TRUE))
+			goto mip_fail;
+		if (!DdsDecompress(CompFormat, IL_TRUE))
+			goto mip_fail;
+	}
+
+	Head.LinearSize = LastLinear;
+	Image = StartImage;
+
+	return IL_TRUE;
+
+mip_fail:
+	Head.LinearSize = LastLinear;
+	Image = StartImage;
+	ilCloseImage(context, Image->Mipmaps);
+	Image->Mipmaps = NULL;
+	return IL_FALSE;
+}
+
 void DxtcReadColors(const ILubyte* Data, Color8888* Out)
 {
 	ILubyte r0, g0, b0, r1, g1, b1;
@@ -1203,11 +1434,11 @@ void DxtcReadColors(const ILubyte* Data, Color8888* Out)
 	r1 = (Data[3] & 0xF8) >> 3;
 
 	Out[0].r = r0 << 3 | r0 >> 2;
-	Out[0].g = g0 << 2 | g0 >> 3;
+	Out[0].g = g0 << 2 | g0 >> 4;
 	Out[0].b = b0 << 3 | b0 >> 2;
 
 	Out[1].r = r1 << 3 | r1 >> 2;
-	Out[1].g = g1 << 2 | g1 >> 3;
+	Out[1].g = g1 << 2 | g1 >> 4;
 	Out[1].b = b1 << 3 | b1 >> 2;
 }
 
@@ -1221,8 +1452,8 @@ void DxtcReadColor(ILushort Data, Color8888* Out)
 	r = (Data & 0xF800) >> 11;
 
 	Out->r = r << 3 | r >> 2;
-	Out->g = g << 2 | g >> 3;
-	Out->b = b << 3 | r >> 2;
+	Out->g = g << 2 | g >> 4;
+	Out->b = b << 3 | b >> 2;
 }
 
 // Defined at the bottom of the file
@@ -1239,77 +1470,8 @@ ILboolean DdsHandler::DecompressDXT2(ILimage *lImage, ILubyte *lCompData)
 	return IL_TRUE;
 }
 
-ILboolean DecompressDXT3(ILimage *lImage, ILubyte *lCompData)
-{
-	ILuint		x, y, z, i, j, k, Select;
-	ILubyte		*Temp;
-	//Color565	*color_0, *color_1;
-	Color8888	colours[4], *col;
-	ILuint		bitmask, Offset;
-	ILushort	word;
-	ILubyte		*alpha;
-
-	if (!lCompData)
-		return IL_FALSE;
-
-	Temp = lCompData;
-	for (z = 0; z < lImage->Depth; z++) {
-		for (y = 0; y < lImage->Height; y += 4) {
-			for (x = 0; x < lImage->Width; x += 4) {
-				alpha = Temp;
-				Temp += 8;
-				DxtcReadColors(Temp, colours);
-				bitmask = ((ILuint*)Temp)[1];
-				UInt(&bitmask);
-				Temp += 8;
-
-				// Four-color block: derive the other two colors.    
-				// 00 = color_0, 01 = color_1, 10 = color_2, 11 = color_3
-				// These 2-bit codes correspond to the 2-bit fields 
-				// stored in the 64-bit block.
-				colours[2].b = (2 * colours[0].b + colours[1].b + 1) / 3;
-				colours[2].g = (2 * colours[0].g + colours[1].g + 1) / 3;
-				colours[2].r = (2 * colours[0].r + colours[1].r + 1) / 3;
-				//colours[2].a = 0xFF;
-
-				colours[3].b = (colours[0].b + 2 * colours[1].b + 1) / 3;
-				colours[3].g = (colours[0].g + 2 * colours[1].g + 1) / 3;
-				colours[3].r = (colours[0].r + 2 * colours[1].r + 1) / 3;
-				//colours[3].a = 0xFF;
-
-				k = 0;
-				for (j = 0; j < 4; j++) {
-					for (i = 0; i < 4; i++, k++) {
-						Select = (bitmask & (0x03 << k*2)) >> k*2;
-						col = &colours[Select];
-
-						if (((x + i) < lImage->Width) && ((y + j) < lImage->Height)) {
-							Offset = z * lImage->SizeOfPlane + (y + j) * lImage->Bps + (x + i) * lImage->Bpp;
-							lImage->Data[Offset + 0] = col->r;
-							lImage->Data[Offset + 1] = col->g;
-							lImage->Data[Offset + 2] = col->b;
-						}
-					}
-				}
-
-				for (j = 0; j < 4; j++) {
-					word = alpha[2*j] + 256*alpha[2*j+1];
-					for (i = 0; i < 4; i++) {
-						if (((x + i) < lImage->Width) && ((y + j) < lImage->Height)) {
-							Offset = z * lImage->SizeOfPlane + (y + j) * lImage->Bps + (x + i) * lImage->Bpp + 3;
-							lImage->Data[Offset] = word & 0x0F;
-							lImage->Data[Offset] = lImage->Data[Offset] | (lImage->Data[Offset] << 4);
-						}
-						word >>= 4;
-					}
-				}
-
-			}
-		}
-	}
-
-	return IL_TRUE;
-}
+// Defined at the bottom of the file
+//ILboolean DecompressDXT3(ILimage *lImage, ILubyte *lCompData)
 
 ILboolean DdsHandler::DecompressDXT4(ILimage *lImage, ILubyte *lCompData)
 {
@@ -1322,130 +1484,16 @@ ILboolean DdsHandler::DecompressDXT4(ILimage *lImage, ILubyte *lCompData)
 	return IL_FALSE;
 }
 
-ILboolean DecompressDXT5(ILimage *lImage, ILubyte *lCompData)
-{
-	ILuint		x, y, z, i, j, k, Select;
-	ILubyte		*Temp; //, r0, g0, b0, r1, g1, b1;
-	Color8888	colours[4], *col;
-	ILuint		bitmask, Offset;
-	ILubyte		alphas[8], *alphamask;
-	ILuint		bits;
-
-	if (!lCompData)
-		return IL_FALSE;
-
-	Temp = lCompData;
-	for (z = 0; z < lImage->Depth; z++) {
-		for (y = 0; y < lImage->Height; y += 4) {
-			for (x = 0; x < lImage->Width; x += 4) {
-				if (y >= lImage->Height || x >= lImage->Width)
-					break;
-				alphas[0] = Temp[0];
-				alphas[1] = Temp[1];
-				alphamask = Temp + 2;
-				Temp += 8;
-
-				DxtcReadColors(Temp, colours);
-				bitmask = ((ILuint*)Temp)[1];
-				UInt(&bitmask);
-				Temp += 8;
-
-				// Four-color block: derive the other two colors.    
-				// 00 = color_0, 01 = color_1, 10 = color_2, 11 = color_3
-				// These 2-bit codes correspond to the 2-bit fields 
-				// stored in the 64-bit block.
-				colours[2].b = (2 * colours[0].b + colours[1].b + 1) / 3;
-				colours[2].g = (2 * colours[0].g + colours[1].g + 1) / 3;
-				colours[2].r = (2 * colours[0].r + colours[1].r + 1) / 3;
-				//colours[2].a = 0xFF;
-
-				colours[3].b = (colours[0].b + 2 * colours[1].b + 1) / 3;
-				colours[3].g = (colours[0].g + 2 * colours[1].g + 1) / 3;
-				colours[3].r = (colours[0].r + 2 * colours[1].r + 1) / 3;
-				//colours[3].a = 0xFF;
-
-				k = 0;
-				for (j = 0; j < 4; j++) {
-					for (i = 0; i < 4; i++, k++) {
-
-						Select = (bitmask & (0x03 << k*2)) >> k*2;
-						col = &colours[Select];
-
-						// only put pixels out < width or height
-						if (((x + i) < lImage->Width) && ((y + j) < lImage->Height)) {
-							Offset = z * lImage->SizeOfPlane + (y + j) * lImage->Bps + (x + i) * lImage->Bpp;
-							lImage->Data[Offset + 0] = col->r;
-							lImage->Data[Offset + 1] = col->g;
-							lImage->Data[Offset + 2] = col->b;
-						}
-					}
-				}
-
-				// 8-alpha or 6-alpha block?    
-				if (alphas[0] > alphas[1]) {    
-					// 8-alpha block:  derive the other six alphas.    
-					// Bit code 000 = alpha_0, 001 = alpha_1, others are interpolated.
-					alphas[2] = (6 * alphas[0] + 1 * alphas[1] + 3) / 7;	// bit code 010
-					alphas[3] = (5 * alphas[0] + 2 * alphas[1] + 3) / 7;	// bit code 011
-					alphas[4] = (4 * alphas[0] + 3 * alphas[1] + 3) / 7;	// bit code 100
-					alphas[5] = (3 * alphas[0] + 4 * alphas[1] + 3) / 7;	// bit code 101
-					alphas[6] = (2 * alphas[0] + 5 * alphas[1] + 3) / 7;	// bit code 110
-					alphas[7] = (1 * alphas[0] + 6 * alphas[1] + 3) / 7;	// bit code 111
-				}
-				else {
-					// 6-alpha block.
-					// Bit code 000 = alpha_0, 001 = alpha_1, others are interpolated.
-					alphas[2] = (4 * alphas[0] + 1 * alphas[1] + 2) / 5;	// Bit code 010
-					alphas[3] = (3 * alphas[0] + 2 * alphas[1] + 2) / 5;	// Bit code 011
-					alphas[4] = (2 * alphas[0] + 3 * alphas[1] + 2) / 5;	// Bit code 100
-					alphas[5] = (1 * alphas[0] + 4 * alphas[1] + 2) / 5;	// Bit code 101
-					alphas[6] = 0x00;										// Bit code 110
-					alphas[7] = 0xFF;										// Bit code 111
-				}
-
-				// Note: Have to separate the next two loops,
-				//	it operates on a 6-byte system.
-
-				// First three bytes
-				//bits = *((ILint*)alphamask);
-				bits = (alphamask[0]) | (alphamask[1] << 8) | (alphamask[2] << 16);
-				for (j = 0; j < 2; j++) {
-					for (i = 0; i < 4; i++) {
-						// only put pixels out < width or height
-						if (((x + i) < lImage->Width) && ((y + j) < lImage->Height)) {
-							Offset = z * lImage->SizeOfPlane + (y + j) * lImage->Bps + (x + i) * lImage->Bpp + 3;
-							lImage->Data[Offset] = alphas[bits & 0x07];
-						}
-						bits >>= 3;
-					}
-				}
-
-				// Last three bytes
-				//bits = *((ILint*)&alphamask[3]);
-				bits = (alphamask[3]) | (alphamask[4] << 8) | (alphamask[5] << 16);
-				for (j = 2; j < 4; j++) {
-					for (i = 0; i < 4; i++) {
-						// only put pixels out < width or height
-						if (((x + i) < lImage->Width) && ((y + j) < lImage->Height)) {
-							Offset = z * lImage->SizeOfPlane + (y + j) * lImage->Bps + (x + i) * lImage->Bpp + 3;
-							lImage->Data[Offset] = alphas[bits & 0x07];
-						}
-						bits >>= 3;
-					}
-				}
-			}
-		}
-	}
-
-	return IL_TRUE;
-}
+// Defined at the bottom of the file
+//ILboolean DecompressDXT5(ILimage *lImage, ILubyte *lCompData)
 
 ILboolean DdsHandler::Decompress3Dc()
 {
 	int			x, y, z, i, j, k, t1, t2;
 	ILubyte		*Temp, *Temp2;
 	ILubyte		XColours[8], YColours[8];
-	ILuint		bitmask, bitmask2, Offset, CurrOffset;
+	ILuint		bitmask, bitmask2;
+	ILsizei		Offset, CurrOffset;
 
 	if (!CompData)
 		return IL_FALSE;
@@ -1535,7 +1583,8 @@ ILboolean DdsHandler::DecompressAti1n()
 	int			x, y, z, i, j, k, t1, t2;
 	ILubyte		*Temp;
 	ILubyte		Colours[8];
-	ILuint		bitmask, Offset, CurrOffset;
+	ILuint		bitmask;
+	ILsizei		Offset, CurrOffset;
 
 	if (!CompData)
 		return IL_FALSE;
@@ -1597,7 +1646,8 @@ ILboolean DdsHandler::DecompressRXGB()
 	ILubyte		*Temp;
 	Color565	*color_0, *color_1;
 	Color8888	colours[4], *col;
-	ILuint		bitmask, Offset;
+	ILuint		bitmask;
+	ILsizei		Offset;
 	ILubyte		alphas[8], *alphamask;
 	ILuint		bits;
 
@@ -1652,7 +1702,7 @@ ILboolean DdsHandler::DecompressRXGB()
 
 						// only put pixels out < width or height
 						if (((x + i) < Width) && ((y + j) < Height)) {
-							Offset = z * Image->SizeOfPlane + (y + j) * Image->Bps + (x + i) * Image->Bpp;
+							Offset = z * Image->SizeOfPlane + (ILsizei)(y + j) * Image->Bps + (x + i) * Image->Bpp;
 							Image->Data[Offset + 0] = col->r;
 							Image->Data[Offset + 1] = col->g;
 							Image->Data[Offset + 2] = col->b;
@@ -1690,7 +1740,7 @@ ILboolean DdsHandler::DecompressRXGB()
 					for (i = 0; i < 4; i++) {
 						// only put pixels out < width or height
 						if (((x + i) < Width) && ((y + j) < Height)) {
-							Offset = z * Image->SizeOfPlane + (y + j) * Image->Bps + (x + i) * Image->Bpp + 0;
+							Offset = z * Image->SizeOfPlane + (ILsizei)(y + j) * Image->Bps + (x + i) * Image->Bpp + 0;
 							Image->Data[Offset] = alphas[bits & 0x07];
 						}
 						bits >>= 3;
@@ -1703,7 +1753,7 @@ ILboolean DdsHandler::DecompressRXGB()
 					for (i = 0; i < 4; i++) {
 						// only put pixels out < width or height
 						if (((x + i) < Width) && ((y + j) < Height)) {
-							Offset = z * Image->SizeOfPlane + (y + j) * Image->Bps + (x + i) * Image->Bpp + 0;
+							Offset = z * Image->SizeOfPlane + (ILsizei)(y + j) * Image->Bps + (x + i) * Image->Bpp + 0;
 							Image->Data[Offset] = alphas[bits & 0x07];
 						}
 						bits >>= 3;
@@ -1863,7 +1913,7 @@ ILboolean DdsHandler::DecompressFloat(ILuint lCompFormat)
 
 void DdsHandler::CorrectPreMult()
 {
-	ILuint i;
+	ILsizei i;
 
 	for (i = 0; i < Image->SizeOfData; i += 4) {
 		if (Image->Data[i+3] != 0) {  // Cannot divide by 0.
@@ -1885,7 +1935,8 @@ ILboolean DdsHandler::DecompressARGBDX10(ILcontext* context, ILuint CompFormat)
 
 ILboolean DdsHandler::DecompressARGB(ILuint CompFormat)
 {
-	ILuint ReadI = 0, TempBpp, i;
+	ILuint ReadI = 0, TempBpp;
+	ILsizei i;
 	ILuint RedL, RedR;
 	ILuint GreenL, GreenR;
 	ILuint BlueL, BlueR;
@@ -1985,7 +2036,8 @@ ILuint CountBitsFromMask(ILuint Mask)
 //  per channel, such as a2r10g10b10 and a2b10g10r10.
 ILboolean DdsHandler::DecompressARGB16(ILuint CompFormat)
 {
-	ILuint ReadI = 0, TempBpp, i;
+	ILuint ReadI = 0, TempBpp;
+	ILsizei i;
 	ILuint RedL, RedR;
 	ILuint GreenL, GreenR;
 	ILuint BlueL, BlueR;
@@ -2109,7 +2161,7 @@ ILubyte* ILAPIENTRY ilGetDxtcData(ILcontext* context)
 void ilFreeSurfaceDxtcData(ILcontext* context)
 {
 	if (context->impl->iCurImage != NULL && context->impl->iCurImage->DxtcData != NULL) {
-		ifree(context->impl->iCurImage->DxtcData);
+		ifree(context, context->impl->iCurImage->DxtcData);
 		context->impl->iCurImage->DxtcData = NULL;
 		context->impl->iCurImage->DxtcSize = 0;
 		context->impl->iCurImage->DxtcFormat = IL_DXT_NO_COMP;
@@ -2168,7 +2220,7 @@ void ilFreeImageDxtcData(ILcontext* context)
 	if (context->impl->iCurImage->SizeOfData != context->impl->iCurImage->SizeOfPlane*context->impl->iCurImage->Depth) {
 		context->impl->iCurImage->SizeOfData = context->impl->iCurImage->Depth*context->impl->iCurImage->SizeOfPlane;
 		if (context->impl->iCurImage->Data != NULL)
-			ifree(context->impl->iCurImage->Data);
+			ifree(context, context->impl->iCurImage->Data);
 		context->impl->iCurImage->Data = NULL;
 	}
 
@@ -2297,19 +2349,19 @@ ILAPI ILboolean ILAPIENTRY ilTexImageDxtc(ILcontext* context, ILint w, ILint h,
 
 	// Not sure if we should be getting rid of the palette...
 	if (Image->Pal.Palette && Image->Pal.PalSize && Image->Pal.PalType != IL_PAL_NONE) {
-		ifree(Image->Pal.Palette);
+		ifree(context, Image->Pal.Palette);
 	}
 
 	// These are set NULL later by the memset call.
-	ilCloseImage(Image->Mipmaps);
-	ilCloseImage(Image->Next);
-	ilCloseImage(Image->Faces);
-	ilCloseImage(Image->Layers);
+	ilCloseImage(context, Image->Mipmaps);
+	ilCloseImage(context, Image->Next);
+	ilCloseImage(context, Image->Faces);
+	ilCloseImage(context, Image->Layers);
 
-	if (Image->AnimList) ifree(Image->AnimList);
-	if (Image->Profile)  ifree(Image->Profile);
-	if (Image->DxtcData) ifree(Image->DxtcData);
-	if (Image->Data)	 ifree(Image->Data);
+	if (Image->AnimList) ifree(context, Image->AnimList);
+	if (Image->Profile)  ifree(context, Image->Profile);
+	if (Image->DxtcData) ifree(context, Image->DxtcData);
+	if (Image->Data)	 ifree(context, Image->Data);
 
 
 	////
@@ -2523,7 +2575,7 @@ ILAPI void ILAPIENTRY ilFlipSurfaceDxtcData(ILcontext* context)
 		Runner += LineSize * numYBlocks;
 	}
 
-	ifree(Temp);
+	ifree(context, Temp);
 }
 
 /**********************************************************************/
@@ -2638,86 +2690,62 @@ ILAPI ILboolean ILAPIENTRY ilInvertSurfaceDxtcDataAlpha(ILcontext* context)
 
 #endif//IL_NO_DDS
 
-// Needed for UTX and potentially others outside of DDS
-ILboolean DecompressDXT1(ILimage *lImage, ILubyte *lCompData)
+// Needed for UTX, BLP, VTF and potentially others outside of DDS
+
+// Blocks worth a thread of their own
+#define DXTC_MIN_BLOCKS 4096
+
+// Decodes the blocks of lCompData, BlockSize bytes each, to the IL_RGBA,
+//	IL_UNSIGNED_BYTE image lImage with Decode.  Rows of blocks are spread over
+//	threads, and blocks that fit in the image are decoded straight into it.
+static ILboolean iDecompressDxtc(ILimage *lImage, const ILubyte *lCompData, ILuint BlockSize,
+	void (*Decode)(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride))
 {
-	ILuint		x, y, z, i, j, k, Select;
-	ILubyte		*Temp;
-	Color8888	colours[4], *col;
-	ILushort	color_0, color_1;
-	ILuint		bitmask, Offset;
+	ILuint BlocksX, BlocksY;
 
 	if (!lCompData)
 		return IL_FALSE;
 
-	Temp = lCompData;
-	colours[0].a = 0xFF;
-	colours[1].a = 0xFF;
-	colours[2].a = 0xFF;
-	//colours[3].a = 0xFF;
-	for (z = 0; z < lImage->Depth; z++) {
-		for (y = 0; y < lImage->Height; y += 4) {
-			for (x = 0; x < lImage->Width; x += 4) {
-				color_0 = *((ILushort*)Temp);
-				UShort(&color_0);
-				color_1 = *((ILushort*)(Temp + 2));
-				UShort(&color_1);
-				DxtcReadColor(color_0, colours);
-				DxtcReadColor(color_1, colours + 1);
-				bitmask = ((ILuint*)Temp)[1];
-				UInt(&bitmask);
-				Temp += 8;
-
-				if (color_0 > color_1) {
-					// Four-color block: derive the other two colors.
-					// 00 = color_0, 01 = color_1, 10 = color_2, 11 = color_3
-					// These 2-bit codes correspond to the 2-bit fields 
-					// stored in the 64-bit block.
-					colours[2].b = (2 * colours[0].b + colours[1].b + 1) / 3;
-					colours[2].g = (2 * colours[0].g + colours[1].g + 1) / 3;
-					colours[2].r = (2 * colours[0].r + colours[1].r + 1) / 3;
-					//colours[2].a = 0xFF;
-
-					colours[3].b = (colours[0].b + 2 * colours[1].b + 1) / 3;
-					colours[3].g = (colours[0].g + 2 * colours[1].g + 1) / 3;
-					colours[3].r = (colours[0].r + 2 * colours[1].r + 1) / 3;
-					colours[3].a = 0xFF;
-				}
-				else {
-					// Three-color block: derive the other color.
-					// 00 = color_0,  01 = color_1,  10 = color_2,
-					// 11 = transparent.
-					// These 2-bit codes correspond to the 2-bit fields 
-					// stored in the 64-bit block. 
-					colours[2].b = (colours[0].b + colours[1].b) / 2;
-					colours[2].g = (colours[0].g + colours[1].g) / 2;
-					colours[2].r = (colours[0].r + colours[1].r) / 2;
-					//colours[2].a = 0xFF;
-
-					colours[3].b = (colours[0].b + 2 * colours[1].b + 1) / 3;
-					colours[3].g = (colours[0].g + 2 * colours[1].g + 1) / 3;
-					colours[3].r = (colours[0].r + 2 * colours[1].r + 1) / 3;
-					colours[3].a = 0x00;
-				}
-
-				for (j = 0, k = 0; j < 4; j++) {
-					for (i = 0; i < 4; i++, k++) {
-						Select = (bitmask & (0x03 << k * 2)) >> k * 2;
-						col = &colours[Select];
-
-						if (((x + i) < lImage->Width) && ((y + j) < lImage->Height)) {
-							Offset = z * lImage->SizeOfPlane + (y + j) * lImage->Bps + (x + i) * lImage->Bpp;
-							lImage->Data[Offset + 0] = col->r;
-							lImage->Data[Offset + 1] = col->g;
-							lImage->Data[Offset + 2] = col->b;
-							lImage->Data[Offset + 3] = col->a;
-						}
-					}
-				}
+	BlocksX = (lImage->Width + 3) / 4;
+	BlocksY = (lImage->Height + 3) / 4;
+
+	iParallelFor(BlocksY * lImage->Depth, IL_MAX(DXTC_MIN_BLOCKS / BlocksX, 1), [&](ILuint First, ILuint Last) {
+		ILubyte	Pixels[64], *Dest;
+		ILuint	Row, bx, x, y, z, i, Full;
+
+		for (Row = First; Row < Last; Row++) {
+			const ILubyte *Block = lCompData + (ILsizei)Row * BlocksX * BlockSize;
+			z = Row / BlocksY;
+			y = (Row % BlocksY) * 4;
+			Dest = lImage->Data + z * lImage->SizeOfPlane + y * lImage->Bps;
+
+			// Whole blocks, then the ones that hang over the right or bottom edge
+			Full = y + 4 <= lImage->Height ? lImage->Width / 4 : 0;
+			Decode(Block, Dest, Full, lImage->Bps);
+			for (bx = Full; bx < BlocksX; bx++) {
+				Decode(Block + bx * BlockSize, Pixels, 1, 16);
+				x = bx * 4;
+				for (i = 0; i < 4 && y + i < lImage->Height; i++)
+					memcpy(Dest + i * lImage->Bps + x * 4, Pixels + i * 16, IL_MIN(4, lImage->Width - x) * 4);
 			}
 		}
-	}
+	});
 
 	return IL_TRUE;
 }
 
+ILboolean DecompressDXT1(ILimage *lImage, ILubyte *lCompData)
+{
+	return iDecompressDxtc(lImage, lCompData, 8, iGetConvKernels()->DecodeDxt1);
+}
+
+ILboolean DecompressDXT3(ILimage *lImage, ILubyte *lCompData)
+{
+	return iDecompressDxtc(lImage, lCompData, 16, iGetConvKernels()->DecodeDxt3);
+}
+
+ILboolean DecompressDXT5(ILimage *lImage, ILubyte *lCompData)
+{
+	return iDecompressDxtc(lImage, lCompData, 16, iGetConvKernels()->DecodeDxt5);
+}
+
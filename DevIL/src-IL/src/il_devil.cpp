@@ -16,6 +16,26 @@
 #include <limits.h>
 
 
+// Computes Bps, SizeOfPlane and SizeOfData from the dimensions of Image,
+//  failing if they do not fit (a single scanline must still fit in an ILuint).
+static ILboolean iComputeImageSizes(ILcontext* context, ILimage *Image)
+{
+	const ILsizei	MaxSize = (ILsizei)-1;
+	ILuint64		Bps = (ILuint64)Image->Width * Image->Bpp * Image->Bpc;
+
+	if (Bps > 0xFFFFFFFF || (Bps != 0 && (Image->Height > MaxSize / Bps ||
+		(Image->Height != 0 && Image->Depth > MaxSize / (Bps * Image->Height))))) {
+		ilSetError(context, IL_OUT_OF_MEMORY);
+		return IL_FALSE;
+	}
+
+	Image->Bps		   = (ILuint)Bps;
+	Image->SizeOfPlane = (ILsizei)Bps * Image->Height;
+	Image->SizeOfData  = Image->SizeOfPlane * Image->Depth;
+	return IL_TRUE;
+}
+
+
 ILAPI ILboolean ILAPIENTRY ilInitImage(ILcontext* context, ILimage *Image, ILuint Width, ILuint Height, ILuint Depth, ILubyte Bpp, ILenum Format, ILenum Type, void *Data)
 {
 	ILubyte BpcType = ilGetBpcType(Type);
@@ -35,9 +55,6 @@ ILAPI ILboolean ILAPIENTRY ilInitImage(ILcontext* context, ILimage *Image, ILuin
 	Image->Depth	   = Depth;
 	Image->Bpp		   = Bpp;
 	Image->Bpc		   = BpcType;
-	Image->Bps		   = Width * Bpp * Image->Bpc;
-	Image->SizeOfPlane = Image->Bps * Height;
-	Image->SizeOfData  = Image->SizeOfPlane * Depth;
 	Image->Format	   = Format;
 	Image->Type 	   = Type;
 	Image->Origin	   = IL_ORIGIN_LOWER_LEFT;
@@ -45,6 +62,10 @@ ILAPI ILboolean ILAPIENTRY ilInitImage(ILcontext* context, ILimage *Image, ILuin
 	Image->DxtcFormat  = IL_DXT_NO_COMP;
 	Image->DxtcData    = NULL;
 
+	if (!iComputeImageSizes(context, Image)) {
+		return IL_FALSE;
+	}
+
 	Image->Data = (ILubyte*)ialloc(context, Image->SizeOfData);
 	if (Image->Data == NULL) {
 		return IL_FALSE;
@@ -75,9 +96,9 @@ ILAPI ILimage* ILAPIENTRY ilNewImage(ILcontext* context, ILuint Width, ILuint He
 
 	if (!ilInitImage(context, Image, Width, Height, Depth, Bpp, ilGetFormatBpp(Bpp), ilGetTypeBpc(Bpc), NULL)) {
 		if (Image->Data != NULL) {
-			ifree(Image->Data);
+			ifree(context, Image->Data);
 		}
-		ifree(Image);
+		ifree(context, Image);
 		return NULL;
 	}
 	
@@ -101,9 +122,9 @@ ILAPI ILimage* ILAPIENTRY ilNewImageFull(ILcontext* context, ILuint Width, ILuin
 
 	if (!ilInitImage(context, Image, Width, Height, Depth, Bpp, Format, Type, Data)) {
 		if (Image->Data != NULL) {
-			ifree(Image->Data);
+			ifree(context, Image->Data);
 		}
-		ifree(Image);
+		ifree(context, Image);
 		return NULL;
 	}
 	
@@ -141,18 +162,18 @@ ILAPI ILboolean ILAPIENTRY ilTexImage_(ILcontext* context, ILimage *Image, ILuin
 
 	// Not sure if we should be getting rid of the palette...
 	if (Image->Pal.Palette && Image->Pal.PalSize && Image->Pal.PalType != IL_PAL_NONE) {
-		ifree(Image->Pal.Palette);
+		ifree(context, Image->Pal.Palette);
 	}
 
-	ilCloseImage(Image->Mipmaps);
-	ilCloseImage(Image->Next);
-	ilCloseImage(Image->Faces);
-	ilCloseImage(Image->Layers);
+	ilCloseImage(context, Image->Mipmaps);
+	ilCloseImage(context, Image->Next);
+	ilCloseImage(context, Image->Faces);
+	ilCloseImage(context, Image->Layers);
 
-	if (Image->AnimList) ifree(Image->AnimList);
-	if (Image->Profile)  ifree(Image->Profile);
-	if (Image->DxtcData) ifree(Image->DxtcData);
-	if (Image->Data)	 ifree(Image->Data);
+	if (Image->AnimList) ifree(context, Image->AnimList);
+	if (Image->Profile)  ifree(context, Image->Profile);
+	if (Image->DxtcData) ifree(context, Image->DxtcData);
+	if (Image->Data)	 ifree(context, Image->Data);
 
 	////
 
@@ -204,13 +225,13 @@ ILboolean ILAPIENTRY ilTexImageSurface_(ILcontext* context, ILimage *Image, ILui
 
 	// Not sure if we should be getting rid of the palette...
 	if (Image->Pal.Palette && Image->Pal.PalSize && Image->Pal.PalType != IL_PAL_NONE) {
-		ifree(Image->Pal.Palette);
+		ifree(context, Image->Pal.Palette);
 	}
 
-	if (Image->AnimList) ifree(Image->AnimList);
-	if (Image->Profile)  ifree(Image->Profile);
-	if (Image->DxtcData) ifree(Image->DxtcData);
-	if (Image->Data)	 ifree(Image->Data);
+	if (Image->AnimList) ifree(context, Image->AnimList);
+	if (Image->Profile)  ifree(context, Image->Profile);
+	if (Image->DxtcData) ifree(context, Image->DxtcData);
+	if (Image->Data)	 ifree(context, Image->Data);
 
 	////
 
@@ -316,26 +337,22 @@ ILubyte* ILAPIENTRY ilGetPalette(ILcontext* context)
 //	(http://www.newscientist.com/news/news.jsp?id=ns99991775)
 //	*(http://www.space.com/scienceastronomy/universe_color_020308.html)*
 //ILfloat ClearRed = 0.269f, ClearGreen = 0.388f, ClearBlue = 0.342f, ClearAlpha = 0.0f;
-static ILfloat ClearRed   = 1.0f;
-static ILfloat ClearGreen = 0.972549f;
-static ILfloat ClearBlue  = 0.90588f;
-static ILfloat ClearAlpha = 0.0f;
-static ILfloat ClearLum   = 1.0f;
+// The clear colour itself is kept per context, in ILcontext::Impl.
 
-void ILAPIENTRY ilClearColour(ILclampf Red, ILclampf Green, ILclampf Blue, ILclampf Alpha)
+void ILAPIENTRY ilClearColour(ILcontext* context, ILclampf Red, ILclampf Green, ILclampf Blue, ILclampf Alpha)
 {
 	// Clamp to 0.0f - 1.0f.
-	ClearRed	= Red < 0.0f ? 0.0f : (Red > 1.0f ? 1.0f : Red);
-	ClearGreen	= Green < 0.0f ? 0.0f : (Green > 1.0f ? 1.0f : Green);
-	ClearBlue	= Blue < 0.0f ? 0.0f : (Blue > 1.0f ? 1.0f : Blue);
-	ClearAlpha	= Alpha < 0.0f ? 0.0f : (Alpha > 1.0f ? 1.0f : Alpha);
+	context->impl->ClearRed	= Red < 0.0f ? 0.0f : (Red > 1.0f ? 1.0f : Red);
+	context->impl->ClearGreen	= Green < 0.0f ? 0.0f : (Green > 1.0f ? 1.0f : Green);
+	context->impl->ClearBlue	= Blue < 0.0f ? 0.0f : (Blue > 1.0f ? 1.0f : Blue);
+	context->impl->ClearAlpha	= Alpha < 0.0f ? 0.0f : (Alpha > 1.0f ? 1.0f : Alpha);
 	
 	if ((Red == Green) && (Red == Blue) && (Green == Blue)) {
-		ClearLum = Red < 0.0f ? 0.0f : (Red > 1.0f ? 1.0f : Red);
+		context->impl->ClearLum = Red < 0.0f ? 0.0f : (Red > 1.0f ? 1.0f : Red);
 	}
 	else {
-		ClearLum = 0.212671f * ClearRed + 0.715160f * ClearGreen + 0.072169f * ClearBlue;
-		ClearLum = ClearLum < 0.0f ? 0.0f : (ClearLum > 1.0f ? 1.0f : ClearLum);
+		context->impl->ClearLum = 0.212671f * context->impl->ClearRed + 0.715160f * context->impl->ClearGreen + 0.072169f * context->impl->ClearBlue;
+		context->impl->ClearLum = context->impl->ClearLum < 0.0f ? 0.0f : (context->impl->ClearLum > 1.0f ? 1.0f : context->impl->ClearLum);
 	}
 	
 	return;
@@ -358,42 +375,42 @@ ILAPI void ILAPIENTRY ilGetClear(ILcontext* context, void *Colours, ILenum Forma
 			switch (Format)
 			{
 				case IL_RGB:
-					BytePtr[0] = (ILubyte)(ClearRed * UCHAR_MAX);
-					BytePtr[1] = (ILubyte)(ClearGreen * UCHAR_MAX);
-					BytePtr[2] = (ILubyte)(ClearBlue * UCHAR_MAX);
+					BytePtr[0] = (ILubyte)(context->impl->ClearRed * UCHAR_MAX);
+					BytePtr[1] = (ILubyte)(context->impl->ClearGreen * UCHAR_MAX);
+					BytePtr[2] = (ILubyte)(context->impl->ClearBlue * UCHAR_MAX);
 					break;
 					
 				case IL_RGBA:
-					BytePtr[0] = (ILubyte)(ClearRed * UCHAR_MAX);
-					BytePtr[1] = (ILubyte)(ClearGreen * UCHAR_MAX);
-					BytePtr[2] = (ILubyte)(ClearBlue * UCHAR_MAX);
-					BytePtr[3] = (ILubyte)(ClearAlpha * UCHAR_MAX);
+					BytePtr[0] = (ILubyte)(context->impl->ClearRed * UCHAR_MAX);
+					BytePtr[1] = (ILubyte)(context->impl->ClearGreen * UCHAR_MAX);
+					BytePtr[2] = (ILubyte)(context->impl->ClearBlue * UCHAR_MAX);
+					BytePtr[3] = (ILubyte)(context->impl->ClearAlpha * UCHAR_MAX);
 					break;
 					
 				case IL_BGR:
-					BytePtr[2] = (ILubyte)(ClearRed * UCHAR_MAX);
-					BytePtr[1] = (ILubyte)(ClearGreen * UCHAR_MAX);
-					BytePtr[0] = (ILubyte)(ClearBlue * UCHAR_MAX);
-					BytePtr[3] = (ILubyte)(ClearAlpha * UCHAR_MAX);
+					BytePtr[2] = (ILubyte)(context->impl->ClearRed * UCHAR_MAX);
+					BytePtr[1] = (ILubyte)(context->impl->ClearGreen * UCHAR_MAX);
+					BytePtr[0] = (ILubyte)(context->impl->ClearBlue * UCHAR_MAX);
+					BytePtr[3] = (ILubyte)(context->impl->ClearAlpha * UCHAR_MAX);
 					break;
 					
 				case IL_BGRA:
-					BytePtr[2] = (ILubyte)(ClearRed * UCHAR_MAX);
-					BytePtr[1] = (ILubyte)(ClearGreen * UCHAR_MAX);
-					BytePtr[0] = (ILubyte)(ClearBlue * UCHAR_MAX);
-					BytePtr[3] = (ILubyte)(ClearAlpha * UCHAR_MAX);
+					BytePtr[2] = (ILubyte)(context->impl->ClearRed * UCHAR_MAX);
+					BytePtr[1] = (ILubyte)(context->impl->ClearGreen * UCHAR_MAX);
+					BytePtr[0] = (ILubyte)(context->impl->ClearBlue * UCHAR_MAX);
+					BytePtr[3] = (ILubyte)(context->impl->ClearAlpha * UCHAR_MAX);
 					break;
 					
 				case IL_LUMINANCE:
-					BytePtr[0] = (ILubyte)(ClearAlpha * UCHAR_MAX);
+					BytePtr[0] = (ILubyte)(context->impl->ClearAlpha * UCHAR_MAX);
 					break;
 					
 				case IL_LUMINANCE_ALPHA:
-					BytePtr[0] = (ILubyte)(ClearLum * UCHAR_MAX);
-					BytePtr[1] = (ILubyte)(ClearAlpha * UCHAR_MAX);
+					BytePtr[0] = (ILubyte)(context->impl->ClearLum * UCHAR_MAX);
+					BytePtr[1] = (ILubyte)(context->impl->ClearAlpha * UCHAR_MAX);
 					
 				case IL_COLOUR_INDEX:
-					BytePtr[0] = (ILubyte)(ClearAlpha * UCHAR_MAX);
+					BytePtr[0] = (ILubyte)(context->impl->ClearAlpha * UCHAR_MAX);
 					break;
 					
 				default:
@@ -408,43 +425,43 @@ ILAPI void ILAPIENTRY ilGetClear(ILcontext* context, void *Colours, ILenum Forma
 			switch (Format)
 			{
 				case IL_RGB:
-					ShortPtr[0] = (ILushort)(ClearRed * USHRT_MAX);
-					ShortPtr[1] = (ILushort)(ClearGreen * USHRT_MAX);
-					ShortPtr[2] = (ILushort)(ClearBlue * USHRT_MAX);
+					ShortPtr[0] = (ILushort)(context->impl->ClearRed * USHRT_MAX);
+					ShortPtr[1] = (ILushort)(context->impl->ClearGreen * USHRT_MAX);
+					ShortPtr[2] = (ILushort)(context->impl->ClearBlue * USHRT_MAX);
 					break;
 					
 				case IL_RGBA:
-					ShortPtr[0] = (ILushort)(ClearRed * USHRT_MAX);
-					ShortPtr[1] = (ILushort)(ClearGreen * USHRT_MAX);
-					ShortPtr[2] = (ILushort)(ClearBlue * USHRT_MAX);
-					ShortPtr[3] = (ILushort)(ClearAlpha * USHRT_MAX);
+					ShortPtr[0] = (ILushort)(context->impl->ClearRed * USHRT_MAX);
+					ShortPtr[1] = (ILushort)(context->impl->ClearGreen * USHRT_MAX);
+					ShortPtr[2] = (ILushort)(context->impl->ClearBlue * USHRT_MAX);
+					ShortPtr[3] = (ILushort)(context->impl->ClearAlpha * USHRT_MAX);
 					break;
 					
 				case IL_BGR:
-					ShortPtr[2] = (ILushort)(ClearRed * USHRT_MAX);
-					ShortPtr[1] = (ILushort)(ClearGreen * USHRT_MAX);
-					ShortPtr[0] = (ILushort)(ClearBlue * USHRT_MAX);
-					ShortPtr[3] = (ILushort)(ClearAlpha * USHRT_MAX);
+					ShortPtr[2] = (ILushort)(context->impl->ClearRed * USHRT_MAX);
+					ShortPtr[1] = (ILushort)(context->impl->ClearGreen * USHRT_MAX);
+					ShortPtr[0] = (ILushort)(context->impl->ClearBlue * USHRT_MAX);
+					ShortPtr[3] = (ILushort)(context->impl->ClearAlpha * USHRT_MAX);
 					break;
 					
 				case IL_BGRA:
-					ShortPtr[2] = (ILushort)(ClearRed * USHRT_MAX);
-					ShortPtr[1] = (ILushort)(ClearGreen * USHRT_MAX);
-					ShortPtr[0] = (ILushort)(ClearBlue * USHRT_MAX);
-					ShortPtr[3] = (ILushort)(ClearAlpha * USHRT_MAX);
+					ShortPtr[2] = (ILushort)(context->impl->ClearRed * USHRT_MAX);
+					ShortPtr[1] = (ILushort)(context->impl->ClearGreen * USHRT_MAX);
+					ShortPtr[0] = (ILushort)(context->impl->ClearBlue * USHRT_MAX);
+					ShortPtr[3] = (ILushort)(context->impl->ClearAlpha * USHRT_MAX);
 					break;
 					
 				case IL_LUMINANCE:
-					ShortPtr[0] = (ILushort)(ClearAlpha * USHRT_MAX);
+					ShortPtr[0] = (ILushort)(context->impl->ClearAlpha * USHRT_MAX);
 					break;
 					
 				case IL_LUMINANCE_ALPHA:
-					ShortPtr[0] = (ILushort)(ClearLum * USHRT_MAX);
-					ShortPtr[1] = (ILushort)(ClearAlpha * USHRT_MAX);
+					ShortPtr[0] = (ILushort)(context->impl->ClearLum * USHRT_MAX);
+					ShortPtr[1] = (ILushort)(context->impl->ClearAlpha * USHRT_MAX);
 					break;
 					
 				case IL_COLOUR_INDEX:
-					ShortPtr[0] = (ILushort)(ClearAlpha * USHRT_MAX);
+					ShortPtr[0] = (ILushort)(context->impl->ClearAlpha * USHRT_MAX);
 					break;
 					
 				default:
@@ -459,43 +476,43 @@ ILAPI void ILAPIENTRY ilGetClear(ILcontext* context, void *Colours, ILenum Forma
 			switch (Format)
 			{
 				case IL_RGB:
-					IntPtr[0] = (ILuint)(ClearRed * UINT_MAX);
-					IntPtr[1] = (ILuint)(ClearGreen * UINT_MAX);
-					IntPtr[2] = (ILuint)(ClearBlue * UINT_MAX);
+					IntPtr[0] = (ILuint)(context->impl->ClearRed * UINT_MAX);
+					IntPtr[1] = (ILuint)(context->impl->ClearGreen * UINT_MAX);
+					IntPtr[2] = (ILuint)(context->impl->ClearBlue * UINT_MAX);
 					break;
 					
 				case IL_RGBA:
-					IntPtr[0] = (ILuint)(ClearRed * UINT_MAX);
-					IntPtr[1] = (ILuint)(ClearGreen * UINT_MAX);
-					IntPtr[2] = (ILuint)(ClearBlue * UINT_MAX);
-					IntPtr[3] = (ILuint)(ClearAlpha * UINT_MAX);
+					IntPtr[0] = (ILuint)(context->impl->ClearRed * UINT_MAX);
+					IntPtr[1] = (ILuint)(context->impl->ClearGreen * UINT_MAX);
+					IntPtr[2] = (ILuint)(context->impl->ClearBlue * UINT_MAX);
+					IntPtr[3] = (ILuint)(context->impl->ClearAlpha * UINT_MAX);
 					break;
 					
 				case IL_BGR:
-					IntPtr[2] = (ILuint)(ClearRed * UINT_MAX);
-					IntPtr[1] = (ILuint)(ClearGreen * UINT_MAX);
-					IntPtr[0] = (ILuint)(ClearBlue * UINT_MAX);
-					IntPtr[3] = (ILuint)(ClearAlpha * UINT_MAX);
+					IntPtr[2] = (ILuint)(context->impl->ClearRed * UINT_MAX);
+					IntPtr[1] = (ILuint)(context->impl->ClearGreen * UINT_MAX);
+					IntPtr[0] = (ILuint)(context->impl->ClearBlue * UINT_MAX);
+					IntPtr[3] = (ILuint)(context->impl->ClearAlpha * UINT_MAX);
 					break;
 					
 				case IL_BGRA:
-					IntPtr[2] = (ILuint)(ClearRed * UINT_MAX);
-					IntPtr[1] = (ILuint)(ClearGreen * UINT_MAX);
-					IntPtr[0] = (ILuint)(ClearBlue * UINT_MAX);
-					IntPtr[3] = (ILuint)(ClearAlpha * UINT_MAX);
+					IntPtr[2] = (ILuint)(context->impl->ClearRed * UINT_MAX);
+					IntPtr[1] = (ILuint)(context->impl->ClearGreen * UINT_MAX);
+					IntPtr[0] = (ILuint)(context->impl->ClearBlue * UINT_MAX);
+					IntPtr[3] = (ILuint)(context->impl->ClearAlpha * UINT_MAX);
 					break;
 					
 				case IL_LUMINANCE:
-					IntPtr[0] = (ILuint)(ClearAlpha * UINT_MAX);
+					IntPtr[0] = (ILuint)(context->impl->ClearAlpha * UINT_MAX);
 					break;
 					
 				case IL_LUMINANCE_ALPHA:
-					IntPtr[0] = (ILuint)(ClearLum * UINT_MAX);
-					IntPtr[1] = (ILuint)(ClearAlpha * UINT_MAX);
+					IntPtr[0] = (ILuint)(context->impl->ClearLum * UINT_MAX);
+					IntPtr[1] = (ILuint)(context->impl->ClearAlpha * UINT_MAX);
 					break;
 					
 				case IL_COLOUR_INDEX:
-					IntPtr[0] = (ILuint)(ClearAlpha * UINT_MAX);
+					IntPtr[0] = (ILuint)(context->impl->ClearAlpha * UINT_MAX);
 					break;
 					
 				default:
@@ -509,43 +526,43 @@ ILAPI void ILAPIENTRY ilGetClear(ILcontext* context, void *Colours, ILenum Forma
 			switch (Format)
 			{
 				case IL_RGB:
-					FloatPtr[0] = ClearRed;
-					FloatPtr[1] = ClearGreen;
-					FloatPtr[2] = ClearBlue;
+					FloatPtr[0] = context->impl->ClearRed;
+					FloatPtr[1] = context->impl->ClearGreen;
+					FloatPtr[2] = context->impl->ClearBlue;
 					break;
 					
 				case IL_RGBA:
-					FloatPtr[0] = ClearRed;
-					FloatPtr[1] = ClearGreen;
-					FloatPtr[2] = ClearBlue;
-					FloatPtr[3] = ClearAlpha;
+					FloatPtr[0] = context->impl->ClearRed;
+					FloatPtr[1] = context->impl->ClearGreen;
+					FloatPtr[2] = context->impl->ClearBlue;
+					FloatPtr[3] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_BGR:
-					FloatPtr[2] = ClearRed;
-					FloatPtr[1] = ClearGreen;
-					FloatPtr[0] = ClearBlue;
-					FloatPtr[3] = ClearAlpha;
+					FloatPtr[2] = context->impl->ClearRed;
+					FloatPtr[1] = context->impl->ClearGreen;
+					FloatPtr[0] = context->impl->ClearBlue;
+					FloatPtr[3] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_BGRA:
-					FloatPtr[2] = ClearRed;
-					FloatPtr[1] = ClearGreen;
-					FloatPtr[0] = ClearBlue;
-					FloatPtr[3] = ClearAlpha;
+					FloatPtr[2] = context->impl->ClearRed;
+					FloatPtr[1] = context->impl->ClearGreen;
+					FloatPtr[0] = context->impl->ClearBlue;
+					FloatPtr[3] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_LUMINANCE:
-					FloatPtr[0] = ClearAlpha;
+					FloatPtr[0] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_LUMINANCE_ALPHA:
-					FloatPtr[0] = ClearLum;
-					FloatPtr[0] = ClearAlpha;
+					FloatPtr[0] = context->impl->ClearLum;
+					FloatPtr[0] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_COLOUR_INDEX:
-					FloatPtr[0] = ClearAlpha;
+					FloatPtr[0] = context->impl->ClearAlpha;
 					break;
 					
 				default:
@@ -559,43 +576,43 @@ ILAPI void ILAPIENTRY ilGetClear(ILcontext* context, void *Colours, ILenum Forma
 			switch (Format)
 			{
 				case IL_RGB:
-					DblPtr[0] = ClearRed;
-					DblPtr[1] = ClearGreen;
-					DblPtr[2] = ClearBlue;
+					DblPtr[0] = context->impl->ClearRed;
+					DblPtr[1] = context->impl->ClearGreen;
+					DblPtr[2] = context->impl->ClearBlue;
 					break;
 					
 				case IL_RGBA:
-					DblPtr[0] = ClearRed;
-					DblPtr[1] = ClearGreen;
-					DblPtr[2] = ClearBlue;
-					DblPtr[3] = ClearAlpha;
+					DblPtr[0] = context->impl->ClearRed;
+					DblPtr[1] = context->impl->ClearGreen;
+					DblPtr[2] = context->impl->ClearBlue;
+					DblPtr[3] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_BGR:
-					DblPtr[2] = ClearRed;
-					DblPtr[1] = ClearGreen;
-					DblPtr[0] = ClearBlue;
-					DblPtr[3] = ClearAlpha;
+					DblPtr[2] = context->impl->ClearRed;
+					DblPtr[1] = context->impl->ClearGreen;
+					DblPtr[0] = context->impl->ClearBlue;
+					DblPtr[3] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_BGRA:
-					DblPtr[2] = ClearRed;
-					DblPtr[1] = ClearGreen;
-					DblPtr[0] = ClearBlue;
-					DblPtr[3] = ClearAlpha;
+					DblPtr[2] = context->impl->ClearRed;
+					DblPtr[1] = context->impl->ClearGreen;
+					DblPtr[0] = context->impl->ClearBlue;
+					DblPtr[3] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_LUMINANCE:
-					DblPtr[0] = ClearAlpha;
+					DblPtr[0] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_LUMINANCE_ALPHA:
-					DblPtr[0] = ClearLum;
-					DblPtr[1] = ClearAlpha;
+					DblPtr[0] = context->impl->ClearLum;
+					DblPtr[1] = context->impl->ClearAlpha;
 					break;
 					
 				case IL_COLOUR_INDEX:
-					DblPtr[0] = ClearAlpha;
+					DblPtr[0] = context->impl->ClearAlpha;
 					break;
 					
 				default:
@@ -694,7 +711,7 @@ ILAPI ILboolean ILAPIENTRY ilClearImage_(ILcontext* context, ILimage *Image)
 		imemclear(Image->Data, Image->SizeOfData);
 		
 		if (Image->Pal.Palette)
-			ifree(Image->Pal.Palette);
+			ifree(context, Image->Pal.Palette);
 		Image->Pal.Palette = (ILubyte*)ialloc(context, 4);
 		if (Image->Pal.Palette == NULL) {
 			return IL_FALSE;
@@ -867,13 +884,13 @@ ILboolean ILAPIENTRY ilBlit(ILcontext* context, ILuint Source, ILint DestX,  ILi
 	}
 	
 	if (SrcTemp != context->impl->iCurImage->Data)
-		ifree(SrcTemp);
+		ifree(context, SrcTemp);
 	
 	ilBindImage(context, DestName);
 	if (DestFlipped)
 		ilFlipImage(context);
 	
-	ifree(Converted);
+	ifree(context, Converted);
 	
 	return IL_TRUE;
 }
@@ -963,32 +980,32 @@ ILAPI ILboolean ILAPIENTRY ilCopyImageAttr(ILcontext* context, ILimage *Dest, IL
 	}
 	
 	if (Dest->Pal.Palette && Dest->Pal.PalSize && Dest->Pal.PalType != IL_PAL_NONE) {
-		ifree(Dest->Pal.Palette);
+		ifree(context, Dest->Pal.Palette);
 		Dest->Pal.Palette = NULL;
 	}
 	if (Dest->Faces) {
-		ilCloseImage(Dest->Faces);
+		ilCloseImage(context, Dest->Faces);
 		Dest->Faces = NULL;
 	}
 	if (Dest->Layers) {
-		ilCloseImage(Dest->Layers);
+		ilCloseImage(context, Dest->Layers);
 		Dest->Layers = NULL;
 	}
 	if (Dest->Mipmaps) {
-		ilCloseImage(Dest->Mipmaps);
+		ilCloseImage(context, Dest->Mipmaps);
 		Dest->Mipmaps = NULL;
 	}
 	if (Dest->Next) {
-		ilCloseImage(Dest->Next);
+		ilCloseImage(context, Dest->Next);
 		Dest->Next = NULL;
 	}
 	if (Dest->Profile) {
-		ifree(Dest->Profile);
+		ifree(context, Dest->Profile);
 		Dest->Profile = NULL;
 		Dest->ProfileSize = 0;
 	}
 	if (Dest->DxtcData) {
-		ifree(Dest->DxtcData);
+		ifree(context, Dest->DxtcData);
 		Dest->DxtcData = NULL;
 		Dest->DxtcFormat = IL_DXT_NO_COMP;
 		Dest->DxtcSize = 0;
@@ -1123,16 +1140,17 @@ ILAPI ILboolean ILAPIENTRY ilResizeImage(ILcontext* context, ILimage *Image, ILu
 	}
 	
 	if (Image->Data != NULL)
-		ifree(Image->Data);
+		ifree(context, Image->Data);
+	Image->Data = NULL;
 	
 	Image->Depth = Depth;
 	Image->Width = Width;
 	Image->Height = Height;
 	Image->Bpp = Bpp;
 	Image->Bpc = Bpc;
-	Image->Bps = Bpp * Bpc * Width;
-	Image->SizeOfPlane = Image->Bps * Height;
-	Image->SizeOfData = Image->SizeOfPlane * Depth;
+	if (!iComputeImageSizes(context, Image)) {
+		return IL_FALSE;
+	}
 	
 	Image->Data = (ILubyte*)ialloc(context, Image->SizeOfData);
 	if (Image->Data == NULL) {
@@ -157,11 +157,11 @@ ILboolean DoomHandler::loadInternal()
 
 		if (!ilTexImage(context, context->impl->iCurImage->Width, context->impl->iCurImage->Height, context->impl->iCurImage->Depth,
 			4, IL_RGBA, context->impl->iCurImage->Type, NewData)) {
-			ifree(NewData);
+			ifree(context, NewData);
 			return IL_FALSE;
 		}
 		context->impl->iCurImage->Origin = IL_ORIGIN_UPPER_LEFT;
-		ifree(NewData);
+		ifree(context, NewData);
 	}
 
 	return ilFixImage(context);
@@ -262,11 +262,11 @@ ILboolean DoomFlatHandler::loadInternal()
 
 		if (!ilTexImage(context, context->impl->iCurImage->Width, context->impl->iCurImage->Height, context->impl->iCurImage->Depth,
 			4, IL_RGBA, context->impl->iCurImage->Type, NewData)) {
-			ifree(NewData);
+			ifree(context, NewData);
 			return IL_FALSE;
 		}
 		context->impl->iCurImage->Origin = IL_ORIGIN_UPPER_LEFT;
-		ifree(NewData);
+		ifree(context, NewData);
 	}
 
 	return ilFixImage(context);
@@ -423,7 +423,7 @@ ILboolean DpxHandler::loadInternal()
 			Val = breadVal(10, File);
 			ShortData[i] = (Val << 6) | (Val >> 4);
 		}
-		bclose(File);*/
+		bclose(context, File);*/
 
 		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
 		return IL_FALSE;
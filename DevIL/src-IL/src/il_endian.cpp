@@ -86,7 +86,7 @@ void iSwapDouble(ILdouble *d) {
 
 ILushort GetLittleUShort(ILcontext* context) {
 	ILushort s;
-	context->impl->iread(context, &s, sizeof(ILushort), 1);
+	iReadFast(context, &s, sizeof(ILushort), 1);
 #ifdef __BIG_ENDIAN__
 	iSwapUShort(&s);
 #endif
@@ -95,7 +95,7 @@ ILushort GetLittleUShort(ILcontext* context) {
 
 ILshort GetLittleShort(ILcontext* context) {
 	ILshort s;
-	context->impl->iread(context, &s, sizeof(ILshort), 1);
+	iReadFast(context, &s, sizeof(ILshort), 1);
 #ifdef __BIG_ENDIAN__
 	iSwapShort(&s);
 #endif
@@ -104,7 +104,7 @@ ILshort GetLittleShort(ILcontext* context) {
 
 ILuint GetLittleUInt(ILcontext* context) {
 	ILuint i;
-	context->impl->iread(context, &i, sizeof(ILuint), 1);
+	iReadFast(context, &i, sizeof(ILuint), 1);
 #ifdef __BIG_ENDIAN__
 	iSwapUInt(&i);
 #endif
@@ -113,7 +113,7 @@ ILuint GetLittleUInt(ILcontext* context) {
 
 ILint GetLittleInt(ILcontext* context) {
 	ILint i;
-	context->impl->iread(context, &i, sizeof(ILint), 1);
+	iReadFast(context, &i, sizeof(ILint), 1);
 #ifdef __BIG_ENDIAN__
 	iSwapInt(&i);
 #endif
@@ -122,7 +122,7 @@ ILint GetLittleInt(ILcontext* context) {
 
 ILfloat GetLittleFloat(ILcontext* context) {
 	ILfloat f;
-	context->impl->iread(context, &f, sizeof(ILfloat), 1);
+	iReadFast(context, &f, sizeof(ILfloat), 1);
 #ifdef __BIG_ENDIAN__
 	iSwapFloat(&f);
 #endif
@@ -131,7 +131,7 @@ ILfloat GetLittleFloat(ILcontext* context) {
 
 ILdouble GetLittleDouble(ILcontext* context) {
 	ILdouble d;
-	context->impl->iread(context, &d, sizeof(ILdouble), 1);
+	iReadFast(context, &d, sizeof(ILdouble), 1);
 #ifdef __BIG_ENDIAN__
 	iSwapDouble(&d);
 #endif
@@ -140,7 +140,7 @@ ILdouble GetLittleDouble(ILcontext* context) {
 
 ILushort GetBigUShort(ILcontext* context) {
 	ILushort s;
-	context->impl->iread(context, &s, sizeof(ILushort), 1);
+	iReadFast(context, &s, sizeof(ILushort), 1);
 #ifdef __LITTLE_ENDIAN__
 	iSwapUShort(&s);
 #endif
@@ -149,7 +149,7 @@ ILushort GetBigUShort(ILcontext* context) {
 
 ILshort GetBigShort(ILcontext* context) {
 	ILshort s;
-	context->impl->iread(context, &s, sizeof(ILshort), 1);
+	iReadFast(context, &s, sizeof(ILshort), 1);
 #ifdef __LITTLE_ENDIAN__
 	iSwapShort(&s);
 #endif
@@ -158,7 +158,7 @@ ILshort GetBigShort(ILcontext* context) {
 
 ILuint GetBigUInt(ILcontext* context) {
 	ILuint i;
-	context->impl->iread(context, &i, sizeof(ILuint), 1);
+	iReadFast(context, &i, sizeof(ILuint), 1);
 #ifdef __LITTLE_ENDIAN__
 	iSwapUInt(&i);
 #endif
@@ -167,7 +167,7 @@ ILuint GetBigUInt(ILcontext* context) {
 
 ILint GetBigInt(ILcontext* context) {
 	ILint i;
-	context->impl->iread(context, &i, sizeof(ILint), 1);
+	iReadFast(context, &i, sizeof(ILint), 1);
 #ifdef __LITTLE_ENDIAN__
 	iSwapInt(&i);
 #endif
@@ -176,7 +176,7 @@ ILint GetBigInt(ILcontext* context) {
 
 ILfloat GetBigFloat(ILcontext* context) {
 	ILfloat f;
-	context->impl->iread(context, &f, sizeof(ILfloat), 1);
+	iReadFast(context, &f, sizeof(ILfloat), 1);
 #ifdef __LITTLE_ENDIAN__
 	iSwapFloat(&f);
 #endif
@@ -185,13 +185,51 @@ ILfloat GetBigFloat(ILcontext* context) {
 
 ILdouble GetBigDouble(ILcontext* context) {
 	ILdouble d;
-	context->impl->iread(context, &d, sizeof(ILdouble), 1);
+	iReadFast(context, &d, sizeof(ILdouble), 1);
 #ifdef __LITTLE_ENDIAN__
 	iSwapDouble(&d);
 #endif
 	return d;
 }
 
+// Bulk versions of the above: read Count values into Buffer in one go.
+//  They return the number of values actually read.
+ILuint GetLittleUShorts(ILcontext* context, ILushort *Buffer, ILuint Count) {
+	ILuint Read = context->impl->iread(context, Buffer, sizeof(ILushort), Count);
+#ifdef __BIG_ENDIAN__
+	for (ILuint i = 0; i < Read; i++)
+		iSwapUShort(Buffer + i);
+#endif
+	return Read;
+}
+
+ILuint GetLittleUInts(ILcontext* context, ILuint *Buffer, ILuint Count) {
+	ILuint Read = context->impl->iread(context, Buffer, sizeof(ILuint), Count);
+#ifdef __BIG_ENDIAN__
+	for (ILuint i = 0; i < Read; i++)
+		iSwapUInt(Buffer + i);
+#endif
+	return Read;
+}
+
+ILuint GetBigUShorts(ILcontext* context, ILushort *Buffer, ILuint Count) {
+	ILuint Read = context->impl->iread(context, Buffer, sizeof(ILushort), Count);
+#ifdef __LITTLE_ENDIAN__
+	for (ILuint i = 0; i < Read; i++)
+		iSwapUShort(Buffer + i);
+#endif
+	return Read;
+}
+
+ILuint GetBigUInts(ILcontext* context, ILuint *Buffer, ILuint Count) {
+	ILuint Read = context->impl->iread(context, Buffer, sizeof(ILuint), Count);
+#ifdef __LITTLE_ENDIAN__
+	for (ILuint i = 0; i < Read; i++)
+		iSwapUInt(Buffer + i);
+#endif
+	return Read;
+}
+
 ILubyte SaveLittleUShort(ILcontext* context, ILushort s) {
 #ifdef __BIG_ENDIAN__
 	iSwapUShort(&s);
@@ -311,7 +349,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						s += 3;
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 
@@ -330,7 +368,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						s += 4;
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 			}
@@ -352,7 +390,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						*ShortD = *ShortS++; iSwapUShort(ShortD++);
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 
@@ -370,7 +408,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						*ShortD = *ShortS++; iSwapUShort(ShortD++);
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 			}
@@ -393,7 +431,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						*IntD = *IntS++; iSwapUInt(IntD++);
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 
@@ -411,7 +449,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						*IntD = *IntS++; iSwapUInt(IntD++);
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 			}
@@ -433,7 +471,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						*FltD = *FltS++; iSwapFloat(FltD++);
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 
@@ -451,7 +489,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						*FltD = *FltS++; iSwapFloat(FltD++);
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 			}
@@ -473,7 +511,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						*DblD = *DblS++; iSwapDouble(DblD++);
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 
@@ -491,7 +529,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 						*DblD = *DblS++; iSwapDouble(DblD++);
 					}
 
-					ifree(Image->Data);
+					ifree(context, Image->Data);
 					Image->Data = temp;
 					break;
 			}
@@ -515,7 +553,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 					s += 3;
 				}
 
-				ifree(Image->Pal.Palette);
+				ifree(context, Image->Pal.Palette);
 				Image->Pal.Palette = temp;
 				break;
 
@@ -537,7 +575,7 @@ void EndianSwapData(ILcontext* context, void *_Image)
 					s += 4;
 				}
 
-				ifree(Image->Pal.Palette);
+				ifree(context, Image->Pal.Palette);
 				Image->Pal.Palette = temp;
 				break;
 		}
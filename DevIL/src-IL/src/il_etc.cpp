@@ -0,0 +1,475 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/src/il_etc.cpp
+//
+// Description: Decodes and encodes ETC1, ETC2 and EAC compressed blocks
+//
+//-----------------------------------------------------------------------------
+
+//
+// The formats are described in appendix C of the OpenGL ES 3.0 specification
+//	and in the Khronos Data Format specification.  A colour block is 8 bytes
+//	and holds 4x4 pixels.  Its last 4 bytes are 2-bit pixel indices, most
+//	significant bits first, with pixels numbered down the columns.  ETC2
+//	reuses the differential mode colours that do not fit in 5 bits for its
+//	T, H and planar modes, so every ETC1 block is also an ETC2 block.  An EAC
+//	block holds one 8-bit channel, with 3-bit indices.
+//
+
+#include "il_internal.h"
+
+#ifndef IL_NO_KTX
+
+#include "il_ktx.h"
+#include "rg_etc1.h"
+#include <limits.h>
+
+
+// Intensity modifiers of the individual and differential modes, as the small
+//	and the large value; the other two are their negatives.
+static const ILint EtcModifiers[8][2] = {
+	{ 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+// Distances of the T and H modes
+static const ILint EtcDistances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+static const ILint EacModifiers[16][8] = {
+	{ -3, -6,  -9, -15, 2, 5, 8, 14 },
+	{ -3, -7, -10, -13, 2, 6, 9, 12 },
+	{ -2, -5,  -8, -13, 1, 4, 7, 12 },
+	{ -2, -4,  -6, -13, 1, 3, 5, 12 },
+	{ -3, -6,  -8, -12, 2, 5, 7, 11 },
+	{ -3, -7,  -9, -11, 2, 6, 8, 10 },
+	{ -4, -7,  -8, -11, 3, 6, 7, 10 },
+	{ -3, -5,  -8, -11, 2, 4, 7, 10 },
+	{ -2, -6,  -8, -10, 1, 5, 7,  9 },
+	{ -2, -5,  -8, -10, 1, 4, 7,  9 },
+	{ -2, -4,  -8, -10, 1, 3, 7,  9 },
+	{ -2, -5,  -7, -10, 1, 4, 6,  9 },
+	{ -3, -4,  -7, -10, 2, 3, 6,  9 },
+	{ -1, -2,  -3, -10, 0, 1, 2,  9 },
+	{ -4, -6,  -8,  -9, 3, 5, 7,  8 },
+	{ -3, -5,  -7,  -9, 2, 4, 6,  8 }
+};
+
+static inline ILint iEtcClamp(ILint Value)
+{
+	return Value < 0 ? 0 : (Value > UCHAR_MAX ? UCHAR_MAX : Value);
+}
+
+// 3-bit two's complement
+static inline ILint iEtcDelta(ILuint Bits)
+{
+	return (ILint)(Bits & 3) - (ILint)(Bits & 4);
+}
+
+
+//
+// Decoding
+//
+
+// The 4 colours of the T or H mode.  Paint[i][3] is the alpha.
+static void iEtcPaintColours(const ILubyte *Block, ILboolean HMode, ILint Paint[4][4])
+{
+	ILint	Colour[2][3], Dist, i;
+
+	if (!HMode) {
+		Colour[0][0] = (((Block[0] >> 3) & 0x3) << 2) | (Block[0] & 0x3);
+		Colour[0][1] = Block[1] >> 4;
+		Colour[0][2] = Block[1] & 0xF;
+		Colour[1][0] = Block[2] >> 4;
+		Colour[1][1] = Block[2] & 0xF;
+		Colour[1][2] = Block[3] >> 4;
+		Dist = (((Block[3] >> 2) & 0x3) << 1) | (Block[3] & 0x1);
+	}
+	else {
+		Colour[0][0] = (Block[0] >> 3) & 0xF;
+		Colour[0][1] = ((Block[0] & 0x7) << 1) | ((Block[1] >> 4) & 0x1);
+		Colour[0][2] = (Block[1] & 0x8) | ((Block[1] & 0x3) << 1) | (Block[2] >> 7);
+		Colour[1][0] = (Block[2] >> 3) & 0xF;
+		Colour[1][1] = ((Block[2] & 0x7) << 1) | (Block[3] >> 7);
+		Colour[1][2] = (Block[3] >> 3) & 0xF;
+		// The lowest bit of the distance is whether the first colour is the larger.
+		Dist = (Block[3] & 0x4) | ((Block[3] & 0x1) << 1);
+		if ((Colour[0][0] << 8 | Colour[0][1] << 4 | Colour[0][2]) >= (Colour[1][0] << 8 | Colour[1][1] << 4 | Colour[1][2]))
+			Dist |= 1;
+	}
+	Dist = EtcDistances[Dist];
+
+	for (i = 0; i < 3; i++) {
+		Colour[0][i] *= 17;
+		Colour[1][i] *= 17;
+		if (!HMode) {
+			Paint[0][i] = Colour[0][i];
+			Paint[1][i] = iEtcClamp(Colour[1][i] + Dist);
+			Paint[2][i] = Colour[1][i];
+			Paint[3][i] = iEtcClamp(Colour[1][i] - Dist);
+		}
+		else {
+			Paint[0][i] = iEtcClamp(Colour[0][i] + Dist);
+			Paint[1][i] = iEtcClamp(Colour[0][i] - Dist);
+			Paint[2][i] = iEtcClamp(Colour[1][i] + Dist);
+			Paint[3][i] = iEtcClamp(Colour[1][i] - Dist);
+		}
+	}
+	for (i = 0; i < 4; i++)
+		Paint[i][3] = UCHAR_MAX;
+}
+
+static void iEtcPlanar(const ILubyte *Block, ILubyte *Out)
+{
+	ILint O[3], H[3], V[3], x, y, i;
+
+	O[0] = (Block[0] >> 1) & 0x3F;
+	O[1] = ((Block[0] & 0x1) << 6) | ((Block[1] >> 1) & 0x3F);
+	O[2] = ((Block[1] & 0x1) << 5) | (Block[2] & 0x18) | ((Block[2] & 0x3) << 1) | (Block[3] >> 7);
+	H[0] = (((Block[3] >> 2) & 0x1F) << 1) | (Block[3] & 0x1);
+	H[1] = Block[4] >> 1;
+	H[2] = ((Block[4] & 0x1) << 5) | (Block[5] >> 3);
+	V[0] = ((Block[5] & 0x7) << 3) | (Block[6] >> 5);
+	V[1] = ((Block[6] & 0x1F) << 2) | (Block[7] >> 6);
+	V[2] = Block[7] & 0x3F;
+
+	// Red and blue have 6 bits, green has 7.
+	for (i = 0; i < 3; i++) {
+		if (i == 1) {
+			O[i] = (O[i] << 1) | (O[i] >> 6);
+			H[i] = (H[i] << 1) | (H[i] >> 6);
+			V[i] = (V[i] << 1) | (V[i] >> 6);
+		}
+		else {
+			O[i] = (O[i] << 2) | (O[i] >> 4);
+			H[i] = (H[i] << 2) | (H[i] >> 4);
+			V[i] = (V[i] << 2) | (V[i] >> 4);
+		}
+	}
+
+	for (y = 0; y < 4; y++) {
+		for (x = 0; x < 4; x++, Out += 4) {
+			for (i = 0; i < 3; i++)
+				Out[i] = (ILubyte)iEtcClamp((x * (H[i] - O[i]) + y * (V[i] - O[i]) + 4 * O[i] + 2) >> 2);
+			Out[3] = UCHAR_MAX;
+		}
+	}
+}
+
+//! Decodes an ETC1 or ETC2 colour block to 4x4 RGBA pixels, row by row.  With
+//	PunchThrough the block is from an ETC2 RGB8_A1 texture: there is no
+//	individual mode, and its bit says whether the block may have transparent
+//	pixels instead.
+void DecodeEtc2Block(const ILubyte *Block, ILboolean PunchThrough, ILubyte *Out)
+{
+	ILint		Base[2][3], Paint[4][4], Table[2], Index, Sub, Mod, x, y, p, i;
+	ILuint		Msb = (Block[4] << 8) | Block[5], Lsb = (Block[6] << 8) | Block[7];
+	ILboolean	Diff = (Block[3] & 0x2) != 0, Flip = (Block[3] & 0x1) != 0;
+	ILboolean	Opaque = !PunchThrough || Diff, Paints = IL_FALSE;
+
+	if (Diff || PunchThrough) {
+		for (i = 0; i < 3; i++) {
+			Base[0][i] = Block[i] >> 3;
+			Base[1][i] = Base[0][i] + iEtcDelta(Block[i]);
+			if (Base[1][i] < 0 || Base[1][i] > 31)
+				break;
+			Base[0][i] = (Base[0][i] << 3) | (Base[0][i] >> 2);
+			Base[1][i] = (Base[1][i] << 3) | (Base[1][i] >> 2);
+		}
+		// Red, green or blue out of range means the T, H or planar mode.
+		if (i == 2) {
+			iEtcPlanar(Block, Out);
+			return;
+		}
+		if (i < 2) {
+			iEtcPaintColours(Block, i == 1, Paint);
+			Paints = IL_TRUE;
+		}
+	}
+	else {
+		for (i = 0; i < 3; i++) {
+			Base[0][i] = (Block[i] >> 4) * 17;
+			Base[1][i] = (Block[i] & 0xF) * 17;
+		}
+	}
+	Table[0] = Block[3] >> 5;
+	Table[1] = (Block[3] >> 2) & 0x7;
+
+	for (y = 0; y < 4; y++) {
+		for (x = 0; x < 4; x++, Out += 4) {
+			p = x * 4 + y;
+			Index = (((Msb >> p) & 1) << 1) | ((Lsb >> p) & 1);
+			if (!Opaque && Index == 2) {
+				Out[0] = Out[1] = Out[2] = Out[3] = 0;
+				continue;
+			}
+			if (Paints) {
+				for (i = 0; i < 4; i++)
+					Out[i] = (ILubyte)Paint[Index][i];
+				continue;
+			}
+			Sub = Flip ? y >= 2 : x >= 2;
+			Mod = EtcModifiers[Table[Sub]][Index & 1];
+			if (Index & 2)
+				Mod = -Mod;
+			if (!Opaque && (Index & 1) == 0)
+				Mod = 0;
+			for (i = 0; i < 3; i++)
+				Out[i] = (ILubyte)iEtcClamp(Base[Sub][i] + Mod);
+			Out[3] = UCHAR_MAX;
+		}
+	}
+}
+
+//! Decodes an EAC block of 8-bit values to 4x4 values, row by row, Stride
+//	bytes apart.
+void DecodeEacBlock(const ILubyte *Block, ILubyte *Out, ILuint Stride)
+{
+	ILint		Base = Block[0], Mul = Block[1] >> 4;
+	const ILint	*Mods = EacModifiers[Block[1] & 0xF];
+	ILuint64	Bits = 0;
+	ILuint		x, y, i;
+
+	for (i = 2; i < 8; i++)
+		Bits = (Bits << 8) | Block[i];
+
+	for (y = 0; y < 4; y++) {
+		for (x = 0; x < 4; x++, Out += Stride) {
+			i = x * 4 + y;
+			*Out = (ILubyte)iEtcClamp(Base + Mods[(Bits >> (45 - i * 3)) & 7] * Mul);
+		}
+	}
+}
+
+
+//
+// Encoding
+//
+
+// Squared error of Block decoded against the RGB of Pixels
+static ILuint iEtcError(const ILubyte *Block, const ILubyte *Pixels)
+{
+	ILubyte	Decoded[64];
+	ILuint	Error = 0, i;
+	ILint	Diff;
+
+	DecodeEtc2Block(Block, IL_FALSE, Decoded);
+	for (i = 0; i < 64; i++) {
+		if (i % 4 == 3)
+			continue;
+		Diff = Decoded[i] - Pixels[i];
+		Error += Diff * Diff;
+	}
+	return Error;
+}
+
+// Best 6- or 7-bit planar values of one channel.  The colour at (x, y) is
+//	O + x (H - O) / 4 + y (V - O) / 4, so a least squares plane is fitted and
+//	its corners quantised; Search widens that to the neighbouring values.
+static ILuint iEtcFitPlane(const ILubyte *Pixels, ILuint Bits, ILboolean Search, ILint *Quant)
+{
+	ILfloat	Mean = 0, SlopeX = 0, SlopeY = 0, Corner[3];
+	ILint	Max = (1 << Bits) - 1, Trial[3], Best[3], Value[3], Err, x, y, i, j, k;
+	ILuint	BestError = UINT_MAX, Error;
+
+	for (y = 0; y < 4; y++) {
+		for (x = 0; x < 4; x++) {
+			Mean += Pixels[(y * 4 + x) * 4];
+			SlopeX += (x - 1.5f) * Pixels[(y * 4 + x) * 4];
+			SlopeY += (y - 1.5f) * Pixels[(y * 4 + x) * 4];
+		}
+	}
+	// The x and y offsets from 1.5 have a sum of squares of 20 over the block.
+	Mean /= 16.0f;
+	SlopeX /= 20.0f;
+	SlopeY /= 20.0f;
+	Corner[0] = Mean - 1.5f * SlopeX - 1.5f * SlopeY;
+	Corner[1] = Corner[0] + 4.0f * SlopeX;
+	Corner[2] = Corner[0] + 4.0f * SlopeY;
+	for (i = 0; i < 3; i++) {
+		Best[i] = (ILint)(Corner[i] * Max / 255.0f + 0.5f);
+		Best[i] = IL_MAX(0, IL_MIN(Max, Best[i]));
+	}
+
+	for (i = Search ? -1 : 0; i <= (Search ? 1 : 0); i++) {
+		for (j = Search ? -1 : 0; j <= (Search ? 1 : 0); j++) {
+			for (k = Search ? -1 : 0; k <= (Search ? 1 : 0); k++) {
+				Trial[0] = Best[0] + i;
+				Trial[1] = Best[1] + j;
+				Trial[2] = Best[2] + k;
+				if (Trial[0] < 0 || Trial[0] > Max || Trial[1] < 0 || Trial[1] > Max || Trial[2] < 0 || Trial[2] > Max)
+					continue;
+				for (x = 0; x < 3; x++)
+					Value[x] = Bits == 7 ? (Trial[x] << 1) | (Trial[x] >> 6) : (Trial[x] << 2) | (Trial[x] >> 4);
+				Error = 0;
+				for (y = 0; y < 4; y++) {
+					for (x = 0; x < 4; x++) {
+						Err = iEtcClamp((x * (Value[1] - Value[0]) + y * (Value[2] - Value[0]) + 4 * Value[0] + 2) >> 2)
+							- Pixels[(y * 4 + x) * 4];
+						Error += Err * Err;
+					}
+				}
+				if (Error < BestError) {
+					BestError = Error;
+					memcpy(Quant, Trial, sizeof(Trial));
+				}
+			}
+		}
+	}
+
+	return BestError;
+}
+
+// Packs a planar mode block.  The bits the mode leaves free are set so that
+//	red and green stay in range as differential colours and blue does not.
+static void iEtcPackPlanar(ILint O[3], ILint H[3], ILint V[3], ILubyte *Block)
+{
+	ILint Dir;
+
+	Block[0] = (ILubyte)((O[0] << 1) | (O[1] >> 6));
+	Block[1] = (ILubyte)(((O[1] & 0x3F) << 1) | (O[2] >> 5));
+	Block[2] = (ILubyte)((O[2] & 0x18) | ((O[2] >> 1) & 0x3));
+	Block[3] = (ILubyte)(((O[2] & 0x1) << 7) | ((H[0] >> 1) << 2) | 0x2 | (H[0] & 0x1));
+	Block[4] = (ILubyte)((H[1] << 1) | (H[2] >> 5));
+	Block[5] = (ILubyte)(((H[2] & 0x1F) << 3) | (V[0] >> 3));
+	Block[6] = (ILubyte)(((V[0] & 0x7) << 5) | (V[1] >> 2));
+	Block[7] = (ILubyte)(((V[1] & 0x3) << 6) | V[2]);
+
+	if ((Block[0] >> 3) + iEtcDelta(Block[0]) < 0)
+		Block[0] |= 0x80;
+	if ((Block[1] >> 3) + iEtcDelta(Block[1]) < 0)
+		Block[1] |= 0x80;
+	// Blue is either 28-31 plus 0-3 or 0-3 minus 1-4, whichever leaves 0-31.
+	Dir = ((Block[2] >> 3) & 0x3) + (Block[2] & 0x3);
+	if (Dir >= 4)
+		Block[2] |= 0xE0;
+	else
+		Block[2] |= 0x04;
+}
+
+// Copies Pixels with an opaque alpha, which rg_etc1 expects.
+static void iEtcOpaque(const ILubyte *Pixels, ILuint *Opaque)
+{
+	ILubyte	*Bytes = (ILubyte*)Opaque;
+	ILuint	i;
+
+	memcpy(Opaque, Pixels, 64);
+	for (i = 0; i < 16; i++)
+		Bytes[i * 4 + 3] = UCHAR_MAX;
+}
+
+// rg_etc1 builds its tables once, before the first block.
+static void iEtcInit()
+{
+	static const bool Init = (rg_etc1::pack_etc1_block_init(), true);
+	(void)Init;
+}
+
+//! Encodes the RGB of 4x4 RGBA pixels, row by row, as an ETC1 block.  Quality
+//	goes from 0 (fastest) to 2 (best).
+void EncodeEtc1Block(const ILubyte *Pixels, ILuint Quality, ILubyte *Block)
+{
+	rg_etc1::etc1_pack_params	Params;
+	ILuint						Opaque[16];
+
+	iEtcInit();
+	iEtcOpaque(Pixels, Opaque);
+	Params.m_quality = Quality == 0 ? rg_etc1::cLowQuality : (Quality == 1 ? rg_etc1::cMediumQuality : rg_etc1::cHighQuality);
+	rg_etc1::pack_etc1_block(Block, Opaque, Params);
+}
+
+//! Encodes the RGB of 4x4 RGBA pixels as an ETC2 block: the ETC1 block or a
+//	planar one, whichever is closer.  The T and H modes are not tried.
+void EncodeEtc2Block(const ILubyte *Pixels, ILuint Quality, ILubyte *Block)
+{
+	ILubyte	Planar[8];
+	ILint	Quant[3][3], O[3], H[3], V[3];
+	ILuint	i;
+
+	EncodeEtc1Block(Pixels, Quality, Block);
+
+	for (i = 0; i < 3; i++) {
+		iEtcFitPlane(Pixels + i, i == 1 ? 7 : 6, Quality > 0, Quant[i]);
+		O[i] = Quant[i][0];
+		H[i] = Quant[i][1];
+		V[i] = Quant[i][2];
+	}
+	iEtcPackPlanar(O, H, V, Planar);
+	if (iEtcError(Planar, Pixels) < iEtcError(Block, Pixels))
+		memcpy(Block, Planar, 8);
+}
+
+//! Encodes 16 8-bit values, row by row and Stride bytes apart, as an EAC
+//	block.  Every table is tried with the base and multiplier that map the
+//	values' range onto it; higher qualities also try the values around those.
+void EncodeEacBlock(const ILubyte *Values, ILuint Stride, ILuint Quality, ILubyte *Block)
+{
+	ILint		Pixels[16], Lo = UCHAR_MAX, Hi = 0, Spread, Table, Mul, Base, Err, Best, Value;
+	ILint		BestTable = 0, BestMul = 1, BestBase = 0, MulRange, BaseRange, dMul, dBase, i, j;
+	ILuint		Error, BestError = UINT_MAX, Index[16];
+	ILuint64	Bits;
+	const ILint	*Mods;
+
+	for (i = 0; i < 16; i++) {
+		Pixels[i] = Values[i * Stride];
+		Lo = IL_MIN(Lo, Pixels[i]);
+		Hi = IL_MAX(Hi, Pixels[i]);
+	}
+	MulRange = Quality == 0 ? 0 : (Quality == 1 ? 1 : 2);
+	BaseRange = Quality == 0 ? 0 : (Quality == 1 ? 1 : 3);
+
+	for (Table = 0; Table < 16 && BestError > 0; Table++) {
+		Mods = EacModifiers[Table];
+		Spread = Mods[7] - Mods[3];
+		for (dMul = -MulRange; dMul <= MulRange; dMul++) {
+			Mul = IL_MAX(1, IL_MIN(15, (Hi - Lo + Spread / 2) / Spread)) + dMul;
+			if (Mul < 1 || Mul > 15)
+				continue;
+			for (dBase = -BaseRange; dBase <= BaseRange; dBase++) {
+				Base = iEtcClamp(Lo - Mods[3] * Mul) + dBase;
+				if (Base < 0 || Base > UCHAR_MAX)
+					continue;
+				Error = 0;
+				for (i = 0; i < 16 && Error < BestError; i++) {
+					Best = INT_MAX;
+					for (j = 0; j < 8; j++) {
+						Err = iEtcClamp(Base + Mods[j] * Mul) - Pixels[i];
+						Best = IL_MIN(Best, Err * Err);
+					}
+					Error += Best;
+				}
+				if (Error < BestError) {
+					BestError = Error;
+					BestTable = Table;
+					BestMul = Mul;
+					BestBase = Base;
+				}
+			}
+		}
+	}
+
+	Mods = EacModifiers[BestTable];
+	for (i = 0; i < 16; i++) {
+		Best = INT_MAX;
+		for (j = 0; j < 8; j++) {
+			Value = iEtcClamp(BestBase + Mods[j] * BestMul) - Pixels[i];
+			if (Value * Value < Best) {
+				Best = Value * Value;
+				Index[i] = j;
+			}
+		}
+	}
+
+	// Indices go down the columns.
+	Bits = 0;
+	for (i = 0; i < 16; i++)
+		Bits = (Bits << 3) | Index[(i % 4) * 4 + i / 4];
+	Block[0] = (ILubyte)BestBase;
+	Block[1] = (ILubyte)((BestMul << 4) | BestTable);
+	for (i = 0; i < 6; i++)
+		Block[2 + i] = (ILubyte)(Bits >> (40 - i * 8));
+}
+
+#endif//IL_NO_KTX
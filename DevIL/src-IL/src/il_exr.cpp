@@ -20,13 +20,17 @@
 #endif //HAVE_CONFIG_H
 
 #include <ImfRgba.h>
-#include <ImfArray.h>
 #include <ImfRgbaFile.h>
-//#include <ImfTiledRgbaFile.h>
-//#include <ImfInputFile.h>
-//#include <ImfTiledInputFile.h>
-//#include <ImfPreviewImage.h>
-//#include <ImfChannelList.h>
+#include <ImfMultiPartInputFile.h>
+#include <ImfInputPart.h>
+#include <ImfPartType.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfThreading.h>
+#include <IlmThread.h>
+#include <set>
+#include <string>
+#include <thread>
 
 #include "il_exr.h"
 
@@ -178,9 +182,10 @@ ILboolean iCheckExr(EXRHEAD *Header)
 	// The file magic number (signature) is 0x76, 0x2f, 0x31, 0x01
 	if (Header->MagicNumber != 0x01312F76)
 		return IL_FALSE;
-	// The only valid version so far is version 2.  The upper value has
-	//  to do with tiling.
-	if (Header->Version != 0x002 && Header->Version != 0x202)
+	// The only valid version so far is version 2.  The upper bits flag
+	//  tiling (0x200), long names (0x400), deep data (0x800) and multiple
+	//  parts (0x1000).
+	if ((Header->Version & 0xFF) != 0x002 || (Header->Version & ~0x1EFF) != 0)
 		return IL_FALSE;
 
 	return IL_TRUE;
@@ -264,77 +269,229 @@ ILboolean ExrHandler::loadL(const void *Lump, ILuint Size)
 	return loadInternal();
 }
 
-ILboolean ExrHandler::loadInternal()
+// Returns the number of threads IL_EXR_THREADS asks for, which is passed to
+//  each file OpenEXR opens.  OpenEXR runs them on one thread pool shared by
+//  the whole process, so the pool is only ever grown here: shrinking it for
+//  one context would take threads away from files other contexts are reading.
+static int iExrThreads(ILcontext* context)
 {
-	Imf::Array<Imf::Rgba> pixels;
-	Imath::Box2i dataWindow;
-	float pixelAspectRatio;
-	ILfloat *FloatData;
+	int Threads;
 
-	ilIStream File(context);
-	Imf::RgbaInputFile in(File);
+	Threads = iGetInt(context, IL_EXR_THREADS);
+	if (Threads == 0)
+		Threads = (int)std::thread::hardware_concurrency();
+	if (Threads <= 1 || !IlmThread::supportsThreads())
+		return 0;  // 0 makes OpenEXR decompress on the calling thread.
+	if (Imf::globalThreadCount() < Threads)
+		Imf::setGlobalThreadCount(Threads);
 
-	Imf::Rgba a;
-    dataWindow = in.dataWindow();
-    pixelAspectRatio = in.pixelAspectRatio();
+	return Threads;
+}
 
-    int dw, dh, dx, dy;
- 
-	dw = dataWindow.max.x - dataWindow.min.x + 1;
-    dh = dataWindow.max.y - dataWindow.min.y + 1;
-    dx = dataWindow.min.x;
-    dy = dataWindow.min.y;
+// Channel Name if it is in Channels at full resolution, else NULL.
+static const Imf::Channel *iExrFullChannel(const Imf::ChannelList &Channels, const std::string &Name)
+{
+	const Imf::Channel *Channel = Channels.findChannel(Name.c_str());
 
-    pixels.resizeErase (dw * dh);
-	in.setFrameBuffer (pixels - dx - dy * dw, 1, dw);
+	if (Channel == NULL || Channel->xSampling != 1 || Channel->ySampling != 1)
+		return NULL;
+	return Channel;
+}
 
-	try
-    {
-		in.readPixels (dataWindow.min.y, dataWindow.max.y);
-    }
-    catch (const std::exception &e)
-    {
-	// If some of the pixels in the file cannot be read,
-	// print an error message, and return a partial image
-	// to the caller.
-		ilSetError(context, IL_LIB_EXR_ERROR);  // Could I use something a bit more descriptive based on e?
-		e;  // Prevent the compiler from yelling at us about this being unused.
+// Looks for R, G, B, A and Y in the layer named by Prefix.
+static ILuint iExrLayerChannels(const Imf::ChannelList &Channels, const std::string &Prefix, std::string Names[4], ILenum *Format)
+{
+	ILuint NumChannels = 0;
+
+	if (iExrFullChannel(Channels, Prefix + "R") && iExrFullChannel(Channels, Prefix + "G")
+		&& iExrFullChannel(Channels, Prefix + "B")) {
+		Names[NumChannels++] = Prefix + "R";
+		Names[NumChannels++] = Prefix + "G";
+		Names[NumChannels++] = Prefix + "B";
+		*Format = IL_RGB;
+	}
+	else if (iExrFullChannel(Channels, Prefix + "Y")) {
+		Names[NumChannels++] = Prefix + "Y";
+		*Format = IL_LUMINANCE;
+	}
+
+	if (iExrFullChannel(Channels, Prefix + "A")) {
+		Names[NumChannels++] = Prefix + "A";
+		*Format = NumChannels == 1 ? IL_ALPHA : NumChannels == 2 ? IL_LUMINANCE_ALPHA : IL_RGBA;
+	}
+
+	return NumChannels;
+}
+
+// Picks up to four full-resolution channels of a part and the format and
+//  type they are read as.  R, G, B, A and Y are looked for in the default
+//  layer, then in the other layers in name order; failing that, the first
+//  channels are read in order as luminance, luminance-alpha, RGB or RGBA.
+//  Half channels stay IL_HALF and uint channels IL_UNSIGNED_INT; a mix is
+//  read as IL_FLOAT.  Returns the number of channels, 0 if there are none.
+static ILuint iExrPickChannels(const Imf::ChannelList &Channels, std::string Names[4], ILenum *Format, ILenum *Type)
+{
+	static const ILenum Formats[] = { 0, IL_LUMINANCE, IL_LUMINANCE_ALPHA, IL_RGB, IL_RGBA };
+	std::set<std::string>	Layers;
+	std::set<std::string>::const_iterator Layer;
+	Imf::ChannelList::ConstIterator Chan;
+	Imf::PixelType			PixelType;
+	ILuint					NumChannels, i;
+
+	NumChannels = iExrLayerChannels(Channels, "", Names, Format);
+	if (NumChannels == 0) {
+		Channels.layers(Layers);
+		for (Layer = Layers.begin(); Layer != Layers.end() && NumChannels == 0; ++Layer)
+			NumChannels = iExrLayerChannels(Channels, *Layer + ".", Names, Format);
+	}
+	if (NumChannels == 0) {
+		for (Chan = Channels.begin(); Chan != Channels.end() && NumChannels < 4; ++Chan) {
+			if (Chan.channel().xSampling == 1 && Chan.channel().ySampling == 1)
+				Names[NumChannels++] = Chan.name();
+		}
+		*Format = Formats[NumChannels];
+	}
+	if (NumChannels == 0)
+		return 0;
+
+	PixelType = Channels.findChannel(Names[0].c_str())->type;
+	for (i = 1; i < NumChannels; i++) {
+		if (Channels.findChannel(Names[i].c_str())->type != PixelType)
+			PixelType = Imf::FLOAT;
+	}
+	*Type = PixelType == Imf::HALF ? IL_HALF : PixelType == Imf::UINT ? IL_UNSIGNED_INT : IL_FLOAT;
+
+	return NumChannels;
+}
+
+// Sets up Image (the current image if Image is NULL, otherwise a new one
+//  after it) for a data window of the given size.
+static ILimage *iExrNewImage(ILcontext* context, ILimage *Image, const Imath::Box2i &DataWindow, ILuint Bpp, ILenum Format, ILenum Type)
+{
+	ILimage	*New;
+	ILint	Width, Height;
+
+	Width = DataWindow.max.x - DataWindow.min.x + 1;
+	Height = DataWindow.max.y - DataWindow.min.y + 1;
+	if (Width <= 0 || Height <= 0) {
+		ilSetError(context, IL_ILLEGAL_FILE_VALUE);
+		return NULL;
+	}
+
+	if (Image == NULL) {
+		if (!ilTexImage(context, Width, Height, 1, (ILubyte)Bpp, Format, Type, NULL))
+			return NULL;
+		New = context->impl->iCurImage;
+	}
+	else {
+		New = ilNewImageFull(context, Width, Height, 1, (ILubyte)Bpp, Format, Type, NULL);
+		if (New == NULL)
+			return NULL;
+		Image->Next = New;
+	}
+
+	return New;
+}
+
+// Luminance/chroma parts are left to RgbaInputFile, which turns them back
+//  into RGBA.  Imf::Rgba is four halves, so it reads straight into an
+//  IL_RGBA, IL_HALF image.
+static ILboolean iExrLoadRgba(ILcontext* context, ilIStream &File, int Threads)
+{
+	Imf::RgbaInputFile	In(File, Threads);
+	Imath::Box2i		DataWindow = In.dataWindow();
+	ILimage				*Image;
+
+	Image = iExrNewImage(context, NULL, DataWindow, 4, IL_RGBA, IL_HALF);
+	if (Image == NULL)
 		return IL_FALSE;
-    }
+	Image->Origin = IL_ORIGIN_UPPER_LEFT;  // Rows are placed by their y, whatever the line order.
+
+	In.setFrameBuffer((Imf::Rgba*)Image->Data - DataWindow.min.x - (ptrdiff_t)DataWindow.min.y * Image->Width, 1, Image->Width);
+	In.readPixels(DataWindow.min.y, DataWindow.max.y);
 
-	//if (ilTexImage(dw, dh, 1, 4, IL_RGBA, IL_UNSIGNED_BYTE, NULL) == IL_FALSE)
-	//if (ilTexImage(dw, dh, 1, 4, IL_RGBA, IL_UNSIGNED_SHORT, NULL) == IL_FALSE)
-	if (ilTexImage(context, dw, dh, 1, 4, IL_RGBA, IL_FLOAT, NULL) == IL_FALSE)
+	return IL_TRUE;
+}
+
+// Reads part Part of In straight into a new image after *Image (or the
+//  current image if *Image is NULL) and moves *Image on to it.  Deep parts
+//  and parts with nothing at full resolution are skipped.
+static ILboolean iExrLoadPart(ILcontext* context, Imf::MultiPartInputFile &In, int Part, ILimage **Image)
+{
+	const Imf::Header	&Head = In.header(Part);
+	Imath::Box2i		DataWindow = Head.dataWindow();
+	Imf::FrameBuffer	FrameBuffer;
+	Imf::PixelType		PixelType;
+	std::string			Names[4];
+	ILenum				Format, Type;
+	ILuint				NumChannels, Bpc, i;
+	ILubyte				*Base;
+
+	if (Head.hasType() && Imf::isDeepData(Head.type()))
+		return IL_TRUE;
+	NumChannels = iExrPickChannels(Head.channels(), Names, &Format, &Type);
+	if (NumChannels == 0)
+		return IL_TRUE;
+
+	*Image = iExrNewImage(context, *Image, DataWindow, NumChannels, Format, Type);
+	if (*Image == NULL)
 		return IL_FALSE;
+	(*Image)->Origin = IL_ORIGIN_UPPER_LEFT;  // Rows are placed by their y, whatever the line order.
+
+	// OpenEXR addresses pixels by their coordinates in the data window,
+	//  which does not have to start at 0,0.
+	Bpc = ilGetBpcType(Type);
+	Base = (*Image)->Data - (ptrdiff_t)DataWindow.min.x * (*Image)->Bpp * Bpc - (ptrdiff_t)DataWindow.min.y * (*Image)->Bps;
+	PixelType = Type == IL_HALF ? Imf::HALF : Type == IL_UNSIGNED_INT ? Imf::UINT : Imf::FLOAT;
+	for (i = 0; i < NumChannels; i++) {
+		FrameBuffer.insert(Names[i].c_str(), Imf::Slice(PixelType, (char*)(Base + i * Bpc),
+			(*Image)->Bpp * Bpc, (*Image)->Bps));
+	}
 
-	// Determine where the origin is in the original file.
-	if (in.lineOrder() == Imf::INCREASING_Y)
-		context->impl->iCurImage->Origin = IL_ORIGIN_UPPER_LEFT;
-	else
-		context->impl->iCurImage->Origin = IL_ORIGIN_LOWER_LEFT;
+	Imf::InputPart Input(In, Part);
+	Input.setFrameBuffer(FrameBuffer);
+	Input.readPixels(DataWindow.min.y, DataWindow.max.y);
+
+	return IL_TRUE;
+}
 
-	// Better to access FloatData instead of recasting everytime.
-	FloatData = (ILfloat*)context->impl->iCurImage->Data;
+// Each part of the file (scanline or tiled) becomes an image, decompressed
+//  by OpenEXR's thread pool straight into the image's data.
+ILboolean ExrHandler::loadInternal()
+{
+	ILimage	*Image = NULL;
+	ILuint	FirstPos;
+	int		Threads, Part;
 
-	for (int i = 0; i < dw * dh; i++)
+	FirstPos = context->impl->itell(context);
+	ilIStream File(context);
+
+	try
 	{
-		// Too much data lost
-		//context->impl->iCurImage->Data[i * 4 + 0] = (ILubyte)(pixels[i].r.bits() >> 8);
-		//context->impl->iCurImage->Data[i * 4 + 1] = (ILubyte)(pixels[i].g.bits() >> 8);
-		//context->impl->iCurImage->Data[i * 4 + 2] = (ILubyte)(pixels[i].b.bits() >> 8);
-		//context->impl->iCurImage->Data[i * 4 + 3] = (ILubyte)(pixels[i].a.bits() >> 8);
-
-		// The images look kind of washed out with this.
-		//((ILshort*)(context->impl->iCurImage->Data))[i * 4 + 0] = pixels[i].r.bits();
-		//((ILshort*)(context->impl->iCurImage->Data))[i * 4 + 1] = pixels[i].g.bits();
-		//((ILshort*)(context->impl->iCurImage->Data))[i * 4 + 2] = pixels[i].b.bits();
-		//((ILshort*)(context->impl->iCurImage->Data))[i * 4 + 3] = pixels[i].a.bits();
-
-		// This gives the best results, since no data is lost.
-		FloatData[i * 4]     = pixels[i].r;
-		FloatData[i * 4 + 1] = pixels[i].g;
-		FloatData[i * 4 + 2] = pixels[i].b;
-		FloatData[i * 4 + 3] = pixels[i].a;
+		Threads = iExrThreads(context);
+		Imf::MultiPartInputFile In(File, Threads);
+
+		if (In.parts() == 1 && In.header(0).channels().findChannel("RY") != NULL) {
+			File.seekg(FirstPos);
+			if (!iExrLoadRgba(context, File, Threads))
+				return IL_FALSE;
+			return ilFixImage(context);
+		}
+
+		for (Part = 0; Part < In.parts(); Part++) {
+			if (!iExrLoadPart(context, In, Part, &Image))
+				return IL_FALSE;
+		}
+	}
+	catch (const std::exception &)
+	{
+		ilSetError(context, IL_LIB_EXR_ERROR);  // Could I use something a bit more descriptive based on e?
+		return IL_FALSE;
+	}
+
+	if (Image == NULL) {
+		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+		return IL_FALSE;
 	}
 
 	// Converts the image to predefined type, format and/or origin if needed.
@@ -415,8 +572,9 @@ ILuint ExrHandler::saveF(ILHANDLE File)
 //! Writes a Exr to a memory "lump"
 ILuint ExrHandler::saveL(void *Lump, ILuint Size)
 {
-	ILuint Pos = context->impl->itellw(context);
+	ILuint Pos;
 	iSetOutputLump(context, Lump, Size);
+	Pos = context->impl->itellw(context);
 	if (saveInternal() == IL_FALSE)
 		return 0;  // Error occurred
 	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
@@ -444,7 +602,7 @@ ILboolean ExrHandler::saveInternal()
 	if (context->impl->iCurImage->Format != IL_RGBA || context->impl->iCurImage->Type != IL_FLOAT) {
 		TempImage = iConvertImage(context, context->impl->iCurImage, IL_RGBA, IL_FLOAT);
 		if (TempImage == NULL) {
-			ifree(HalfData);
+			ifree(context, HalfData);
 			return IL_FALSE;
 		}
 	}
@@ -465,10 +623,10 @@ ILboolean ExrHandler::saveInternal()
 	Out.writePixels(TempImage->Height);  //@TODO: Do each scanline separately to keep from using so much memory.
 
 	// Free our half data.
-	ifree(HalfData);
+	ifree(context, HalfData);
 	// Destroy our temporary image if we used one.
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return IL_TRUE;
 }
@@ -12,6 +12,7 @@
 
 
 #include "il_internal.h"
+#include "il_simd.h"
 #ifdef ALTIVEC_GCC
 #include "altivec_typeconversion.h"
 #endif
@@ -26,7 +27,6 @@ ILboolean iFastConvert(ILcontext* context, ILenum DestFormat)
 
 #ifndef ALTIVEC_GCC
 	ILuint		SizeOfData, i=0;
-	ILubyte TempByte = 0;
 	ILushort TempShort = 0;
 	ILuint TempInt = 0;
 	ILfloat TempFloat = 0;
@@ -48,26 +48,7 @@ ILboolean iFastConvert(ILcontext* context, ILenum DestFormat)
 					abc2cba_byte(BytePtr,context->impl->iCurImage->SizeOfData,BytePtr);
 				#else
 					SizeOfData = context->impl->iCurImage->SizeOfData / 3;
-					#ifdef USE_WIN32_ASM
-						__asm
-						{
-							mov ebx, BytePtr
-							mov ecx, SizeOfData
-							L1:
-								mov al,[ebx+0]
-								xchg al,[ebx+2]
-								mov [ebx+0],al
-								add ebx,3
-								loop L1
-						}
-					#else
-						for (i = 0; i < SizeOfData; i++) {
-							TempByte = BytePtr[0];
-							BytePtr[0] = BytePtr[2];
-							BytePtr[2] = TempByte;
-							BytePtr += 3;
-						}
-					#endif//USE_WIN32_ASM
+					iGetConvKernels()->SwapRB3(BytePtr, BytePtr, SizeOfData);
 				#endif
 					return IL_TRUE;
 
@@ -172,27 +153,7 @@ ILboolean iFastConvert(ILcontext* context, ILenum DestFormat)
 					abcd2cbad_byte(BytePtr,context->impl->iCurImage->SizeOfData,BytePtr);
 				#else
 					SizeOfData = context->impl->iCurImage->SizeOfData / 4;
-					#ifdef USE_WIN32_ASM
-						__asm
-						{
-							mov ebx, BytePtr
-							mov ecx, SizeOfData
-							L4:
-								mov eax,[ebx]
-								bswap eax
-								ror eax,8
-								mov [ebx], eax
-								add ebx,4
-								loop L4
-						}
-					#else
-						for (i = 0; i < SizeOfData; i++) {
-							TempByte = BytePtr[0];
-							BytePtr[0] = BytePtr[2];
-							BytePtr[2] = TempByte;
-							BytePtr += 4;
-						}
-					#endif//USE_WIN32_ASM
+					iGetConvKernels()->SwapRB4(BytePtr, BytePtr, SizeOfData);
 				#endif
 					return IL_TRUE;
 
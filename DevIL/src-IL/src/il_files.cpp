@@ -15,6 +15,25 @@
 #include "il_internal.h"
 #include <stdarg.h>
 
+#ifndef _WIN32
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+// 64-bit versions of fseek/ftell, so that files larger than 2 GB can be used.
+#if defined(_MSC_VER)
+	#define iFileSeek(File, Offset, Mode)	_fseeki64(File, Offset, Mode)
+	#define iFileTell(File)					_ftelli64(File)
+#elif defined(_WIN32)
+	#define iFileSeek(File, Offset, Mode)	fseeko64(File, Offset, Mode)
+	#define iFileTell(File)					ftello64(File)
+#else
+	#define iFileSeek(File, Offset, Mode)	fseeko(File, (off_t)(Offset), Mode)
+	#define iFileTell(File)					ftello(File)
+#endif
+
 
 // All specific to the next set of functions
 ILboolean	ILAPIENTRY iEofFile(ILcontext* context);
@@ -23,23 +42,27 @@ ILint		ILAPIENTRY iGetcFile(ILcontext* context);
 ILint		ILAPIENTRY iGetcLump(ILcontext* context);
 ILuint		ILAPIENTRY iReadFile(ILcontext* context, void *Buffer, ILuint Size, ILuint Number);
 ILuint		ILAPIENTRY iReadLump(ILcontext* context, void *Buffer, const ILuint Size, const ILuint Number);
-ILint		ILAPIENTRY iSeekRFile(ILcontext* context, ILint Offset, ILuint Mode);
-ILint		ILAPIENTRY iSeekRLump(ILcontext* context, ILint Offset, ILuint Mode);
-ILint		ILAPIENTRY iSeekWFile(ILcontext* context, ILint Offset, ILuint Mode);
-ILint		ILAPIENTRY iSeekWLump(ILcontext* context, ILint Offset, ILuint Mode);
-ILuint		ILAPIENTRY iTellRFile(ILcontext* context);
-ILuint		ILAPIENTRY iTellRLump(ILcontext* context);
-ILuint		ILAPIENTRY iTellWFile(ILcontext* context);
-ILuint		ILAPIENTRY iTellWLump(ILcontext* context);
+ILint		ILAPIENTRY iSeekRFile(ILcontext* context, ILint64 Offset, ILuint Mode);
+ILint		ILAPIENTRY iSeekRLump(ILcontext* context, ILint64 Offset, ILuint Mode);
+ILint		ILAPIENTRY iSeekWFile(ILcontext* context, ILint64 Offset, ILuint Mode);
+ILint		ILAPIENTRY iSeekWLump(ILcontext* context, ILint64 Offset, ILuint Mode);
+ILuint64	ILAPIENTRY iTellRFile(ILcontext* context);
+ILuint64	ILAPIENTRY iTellRLump(ILcontext* context);
+ILuint64	ILAPIENTRY iTellWFile(ILcontext* context);
+ILuint64	ILAPIENTRY iTellWLump(ILcontext* context);
 ILint		ILAPIENTRY iPutcFile(ILcontext* context, ILubyte Char);
 ILint		ILAPIENTRY iPutcLump(ILcontext* context, ILubyte Char);
 ILint		ILAPIENTRY iWriteFile(ILcontext* context, const void *Buffer, ILuint Size, ILuint Number);
 ILint		ILAPIENTRY iWriteLump(ILcontext* context, const void *Buffer, ILuint Size, ILuint Number);
+ILint		ILAPIENTRY iSeekWDynamic(ILcontext* context, ILint64 Offset, ILuint Mode);
+ILuint64	ILAPIENTRY iTellWDynamic(ILcontext* context);
+ILint		ILAPIENTRY iPutcDynamic(ILcontext* context, ILubyte Char);
+ILint		ILAPIENTRY iWriteDynamic(ILcontext* context, const void *Buffer, ILuint Size, ILuint Number);
 
 // "Fake" size functions
 //  Definitions are in il_size.c.
-ILint		ILAPIENTRY iSizeSeek(ILcontext* context, ILint Offset, ILuint Mode);
-ILuint		ILAPIENTRY iSizeTell(ILcontext* context);
+ILint		ILAPIENTRY iSizeSeek(ILcontext* context, ILint64 Offset, ILuint Mode);
+ILuint64	ILAPIENTRY iSizeTell(ILcontext* context);
 ILint		ILAPIENTRY iSizePutc(ILcontext* context, ILubyte Char);
 ILint		ILAPIENTRY iSizeWrite(ILcontext* context, const void *Buffer, ILuint Size, ILuint Number);
 
@@ -136,7 +159,7 @@ void ILAPIENTRY iDefaultCloseR(ILHANDLE Handle)
 
 ILboolean ILAPIENTRY iDefaultEof(ILcontext* context, ILHANDLE Handle)
 {
-	ILuint OrigPos, FileSize;
+	ILuint64 OrigPos, FileSize;
 
 	// Find out the filesize for checking for the end of file
 	OrigPos = context->impl->itell(context);
@@ -174,27 +197,27 @@ ILint ILAPIENTRY iDefaultRead(void *Buffer, ILuint Size, ILuint Number, ILHANDLE
 }
 
 
-ILint ILAPIENTRY iDefaultRSeek(ILHANDLE Handle, ILint Offset, ILint Mode)
+ILint ILAPIENTRY iDefaultRSeek(ILHANDLE Handle, ILint64 Offset, ILint Mode)
 {
-	return fseek((FILE*)Handle, Offset, Mode);
+	return iFileSeek((FILE*)Handle, Offset, Mode);
 }
 
 
-ILint ILAPIENTRY iDefaultWSeek(ILHANDLE Handle, ILint Offset, ILint Mode)
+ILint ILAPIENTRY iDefaultWSeek(ILHANDLE Handle, ILint64 Offset, ILint Mode)
 {
-	return fseek((FILE*)Handle, Offset, Mode);
+	return iFileSeek((FILE*)Handle, Offset, Mode);
 }
 
 
-ILint ILAPIENTRY iDefaultRTell(ILHANDLE Handle)
+ILint64 ILAPIENTRY iDefaultRTell(ILHANDLE Handle)
 {
-	return ftell((FILE*)Handle);
+	return (ILint64)iFileTell((FILE*)Handle);
 }
 
 
-ILint ILAPIENTRY iDefaultWTell(ILHANDLE Handle)
+ILint64 ILAPIENTRY iDefaultWTell(ILHANDLE Handle)
 {
-	return ftell((FILE*)Handle);
+	return (ILint64)iFileTell((FILE*)Handle);
 }
 
 
@@ -278,6 +301,94 @@ void ILAPIENTRY ilSetWrite(ILcontext* context, fOpenRProc Open, fCloseRProc Clos
 }
 
 
+// Maps a whole file read-only into memory, so that it can be handed to the
+//  decoders through the lump functions without copying it into a cache.
+//  Returns NULL if the file cannot be mapped (or the user has replaced the
+//  default read functions with ilSetRead), in which case the caller should
+//  fall back to the normal file reading path.  No error is set on failure.
+const void* iMapFile(ILcontext* context, ILconst_string FileName, ILuint *Size)
+{
+	// User-specified read functions may not even be reading from disk.
+	if (context->impl->iopenr != iDefaultOpenR || FileName == NULL || Size == NULL)
+		return NULL;
+
+#ifdef _WIN32
+	HANDLE			File, Mapping;
+	LARGE_INTEGER	FileSize;
+	void			*View;
+
+	#ifdef _UNICODE
+		File = CreateFileW(FileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	#else
+		File = CreateFileA(FileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	#endif
+	if (File == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	// Lumps are limited to 32-bit sizes, and empty files cannot be mapped.
+	if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0 || FileSize.QuadPart > 0xFFFFFFFF) {
+		CloseHandle(File);
+		return NULL;
+	}
+
+	Mapping = CreateFileMapping(File, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(File);  // The mapping keeps its own reference to the file.
+	if (Mapping == NULL)
+		return NULL;
+
+	View = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(Mapping);  // Likewise, the view keeps the mapping alive.
+	if (View == NULL)
+		return NULL;
+
+	*Size = (ILuint)FileSize.QuadPart;
+	return View;
+#else
+	struct stat	Info;
+	void		*View;
+	int			File;
+
+	File = open((const char*)FileName, O_RDONLY);
+	if (File == -1)
+		return NULL;
+
+	// Lumps are limited to 32-bit sizes, and empty files cannot be mapped.
+	if (fstat(File, &Info) != 0 || !S_ISREG(Info.st_mode) || Info.st_size == 0 ||
+		(ILuint64)Info.st_size > 0xFFFFFFFF) {
+		close(File);
+		return NULL;
+	}
+
+	View = mmap(NULL, (size_t)Info.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+	close(File);  // The mapping stays valid after the descriptor is closed.
+	if (View == MAP_FAILED)
+		return NULL;
+
+	#ifdef MADV_SEQUENTIAL
+		// Most decoders walk through the file from front to back.
+		madvise(View, (size_t)Info.st_size, MADV_SEQUENTIAL);
+	#endif
+
+	*Size = (ILuint)Info.st_size;
+	return View;
+#endif//_WIN32
+}
+
+
+// Releases a view returned by iMapFile.
+void iUnmapFile(const void *View, ILuint Size)
+{
+	if (View == NULL)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(View);
+#else
+	munmap((void*)View, Size);
+#endif//_WIN32
+	return;
+}
+
+
 // Tells DevIL that we're reading from a file, not a lump
 void iSetInputFile(ILcontext* context, ILHANDLE File)
 {
@@ -287,12 +398,13 @@ void iSetInputFile(ILcontext* context, ILHANDLE File)
 	context->impl->iseek = iSeekRFile;
 	context->impl->itell = iTellRFile;
 	context->impl->FileRead = File;
+	context->impl->ReadBuffPos = context->impl->ReadBuffLen = 0;
 	context->impl->ReadFileStart = context->impl->itell(context);
 }
 
 
 // Tells DevIL that we're reading from a lump, not a file
-void iSetInputLump(ILcontext* context, const void *Lump, ILuint Size)
+void iSetInputLump(ILcontext* context, const void *Lump, ILsizei Size)
 {
 	context->impl->ieof  = iEofLump;
 	context->impl->igetc = iGetcLump;
@@ -302,6 +414,7 @@ void iSetInputLump(ILcontext* context, const void *Lump, ILuint Size)
 	context->impl->ReadLump = Lump;
 	context->impl->ReadLumpPos = 0;
 	context->impl->ReadLumpSize = Size;
+	context->impl->ReadBuffPos = context->impl->ReadBuffLen = 0;
 }
 
 
@@ -335,7 +448,7 @@ void iSetOutputFake(ILcontext* context)
 
 
 // Tells DevIL that we're writing to a lump, not a file
-void iSetOutputLump(ILcontext* context, void *Lump, ILuint Size)
+void iSetOutputLump(ILcontext* context, void *Lump, ILsizei Size)
 {
 	// In this case, ilDetermineSize is currently trying to determine the
 	//  output buffer size.  It already has the write functions it needs.
@@ -352,7 +465,23 @@ void iSetOutputLump(ILcontext* context, void *Lump, ILuint Size)
 }
 
 
-ILuint ILAPIENTRY ilGetLumpPos(ILcontext* context)
+// Tells DevIL that we're writing to a buffer that it allocates and grows as
+//  needed.  MaxPos tracks the amount of data written, and the caller takes
+//  ownership of WriteLump once the encoder is done.
+void iSetOutputDynamic(ILcontext* context)
+{
+	context->impl->iputc  = iPutcDynamic;
+	context->impl->iseekw = iSeekWDynamic;
+	context->impl->itellw = iTellWDynamic;
+	context->impl->iwrite = iWriteDynamic;
+	context->impl->WriteLump = NULL;
+	context->impl->WriteLumpPos = 0;
+	context->impl->WriteLumpSize = 0;
+	context->impl->MaxPos = 0;
+}
+
+
+ILsizei ILAPIENTRY ilGetLumpPos(ILcontext* context)
 {
 	if (context->impl->WriteLump)
 		return context->impl->WriteLumpPos;
@@ -377,6 +506,44 @@ ILuint ILAPIENTRY ilprintf(ILcontext* context, const char *Line, ...)
 }
 
 
+// Reads Size bytes, splitting the read into pieces that the 32-bit iread can
+//  handle.  Returns IL_FALSE if not everything could be read.
+ILboolean iReadLarge(ILcontext* context, void *Buffer, ILsizei Size)
+{
+	const ILsizei	MaxChunk = 0x40000000;  // 1 GB at a time
+	ILsizei			Chunk;
+
+	while (Size > 0) {
+		Chunk = IL_MIN(Size, MaxChunk);
+		if (context->impl->iread(context, Buffer, 1, (ILuint)Chunk) != (ILuint)Chunk)
+			return IL_FALSE;
+		Buffer = (ILubyte*)Buffer + Chunk;
+		Size -= Chunk;
+	}
+
+	return IL_TRUE;
+}
+
+
+// Writes Size bytes, splitting the write into pieces that the 32-bit iwrite
+//  can handle.  Returns IL_FALSE if not everything could be written.
+ILboolean iWriteLarge(ILcontext* context, const void *Buffer, ILsizei Size)
+{
+	const ILsizei	MaxChunk = 0x40000000;  // 1 GB at a time
+	ILsizei			Chunk;
+
+	while (Size > 0) {
+		Chunk = IL_MIN(Size, MaxChunk);
+		if (context->impl->iwrite(context, Buffer, 1, (ILuint)Chunk) != (ILint)Chunk)
+			return IL_FALSE;
+		Buffer = (const ILubyte*)Buffer + Chunk;
+		Size -= Chunk;
+	}
+
+	return IL_TRUE;
+}
+
+
 // To pad zeros where needed...
 void ipad(ILcontext* context, ILuint NumZeros)
 {
@@ -396,6 +563,8 @@ void ipad(ILcontext* context, ILuint NumZeros)
 
 ILboolean ILAPIENTRY iEofFile(ILcontext* context)
 {
+	if (context->impl->ReadBuffPos < context->impl->ReadBuffLen)
+		return IL_FALSE;
 	return context->impl->EofProc(context, (FILE*)context->impl->FileRead);
 }
 
@@ -408,10 +577,37 @@ ILboolean ILAPIENTRY iEofLump(ILcontext* context)
 }
 
 
+// Refills the read-ahead window from the current position of FileRead.
+//  Returns IL_FALSE if nothing more could be read.
+static ILboolean iFillReadBuff(ILcontext* context)
+{
+	ILcontext::Impl	*impl = context->impl;
+	ILint			Read;
+
+	if (impl->ReadBuffLen > 0)
+		impl->ReadBuffStart += impl->ReadBuffLen;
+	else
+		impl->ReadBuffStart = (ILuint64)impl->TellRProc(impl->FileRead);
+	impl->ReadBuffPos = impl->ReadBuffLen = 0;
+
+	Read = impl->ReadProc(impl->ReadBuff, 1, IL_READ_BUFF_SIZE, impl->FileRead);
+	if (Read <= 0)
+		return IL_FALSE;
+	impl->ReadBuffLen = (ILuint)Read;
+	return IL_TRUE;
+}
+
+
+// Bytes are served from the read-ahead window, so GetcProc is not used here.
 ILint ILAPIENTRY iGetcFile(ILcontext* context)
 {
-	if (!context->impl->UseCache) {
-		return context->impl->GetcProc(context, context->impl->FileRead);
+	ILcontext::Impl *impl = context->impl;
+
+	if (!impl->UseCache) {
+		if (impl->ReadBuffPos < impl->ReadBuffLen || iFillReadBuff(context))
+			return impl->ReadBuff[impl->ReadBuffPos++];
+		ilSetError(context, IL_FILE_READ_ERROR);
+		return IL_EOF;
 	}
 	if (context->impl->CachePos >= context->impl->CacheSize) {
 		iPreCache(context, context->impl->CacheSize);
@@ -437,6 +633,41 @@ ILint ILAPIENTRY iGetcLump(ILcontext* context)
 }
 
 
+// Reads Size bytes through the read-ahead window.  Large reads bypass the
+//  window and go straight into Buffer.  Returns the number of bytes read.
+static ILsizei iReadFileBuffered(ILcontext* context, ILubyte *Buffer, ILsizei Size)
+{
+	ILcontext::Impl	*impl = context->impl;
+	ILsizei			Copied = 0, Avail;
+	ILint			Read;
+
+	while (Copied < Size) {
+		Avail = impl->ReadBuffLen - impl->ReadBuffPos;
+		if (Avail == 0) {
+			if (Size - Copied >= IL_READ_BUFF_SIZE) {
+				// The window is drained, so FileRead is at the logical position.
+				impl->ReadBuffPos = impl->ReadBuffLen = 0;
+				Read = impl->ReadProc(Buffer + Copied, 1, (ILuint)(Size - Copied), impl->FileRead);
+				if (Read > 0)
+					Copied += Read;
+				break;
+			}
+			if (!iFillReadBuff(context))
+				break;
+			continue;
+		}
+
+		if (Avail > Size - Copied)
+			Avail = Size - Copied;
+		memcpy(Buffer + Copied, impl->ReadBuff + impl->ReadBuffPos, Avail);
+		impl->ReadBuffPos += (ILuint)Avail;
+		Copied += Avail;
+	}
+
+	return Copied;
+}
+
+
 ILuint ILAPIENTRY iReadFile(ILcontext* context, void *Buffer, ILuint Size, ILuint Number)
 {
 	ILuint	TotalBytes = 0, BytesCopied;
@@ -444,7 +675,9 @@ ILuint ILAPIENTRY iReadFile(ILcontext* context, void *Buffer, ILuint Size, ILuin
 	ILuint	NumRead;
 
 	if (!context->impl->UseCache) {
-		NumRead = context->impl->ReadProc(Buffer, Size, Number, context->impl->FileRead);
+		NumRead = (ILuint)iReadFileBuffered(context, (ILubyte*)Buffer, BuffSize);
+		if (Size != 0)
+			NumRead /= Size;
 		if (NumRead != Number)
 			ilSetError(context, IL_FILE_READ_ERROR);
 		return NumRead;
@@ -493,26 +726,23 @@ ILuint ILAPIENTRY iReadFile(ILcontext* context, void *Buffer, ILuint Size, ILuin
 
 ILuint ILAPIENTRY iReadLump(ILcontext* context, void *Buffer, const ILuint Size, const ILuint Number)
 {
-	ILuint i, ByteSize = IL_MIN( Size*Number, context->impl->ReadLumpSize - context->impl->ReadLumpPos);
+	ILsizei i = (ILsizei)Size * Number;
 
-	for (i = 0; i < ByteSize; i++) {
-		*((ILubyte*)Buffer + i) = *((ILubyte*)context->impl->ReadLump + context->impl->ReadLumpPos + i);
-		if (context->impl->ReadLumpSize > 0) {  // ReadLumpSize is too large to care about apparently
-			if (context->impl->ReadLumpPos + i > context->impl->ReadLumpSize) {
-				context->impl->ReadLumpPos += i;
-				if (i != Number)
-					ilSetError(context, IL_FILE_READ_ERROR);
-				return i;
-			}
-		}
+	// If ReadLumpSize is 0, the lump has no known bounds.
+	if (context->impl->ReadLumpSize > 0) {
+		if (context->impl->ReadLumpPos >= context->impl->ReadLumpSize)
+			i = 0;
+		else
+			i = IL_MIN(i, context->impl->ReadLumpSize - context->impl->ReadLumpPos);
 	}
 
+	memcpy(Buffer, (const ILubyte*)context->impl->ReadLump + context->impl->ReadLumpPos, i);
 	context->impl->ReadLumpPos += i;
 	if (Size != 0)
 		i /= Size;
 	if (i != Number)
 		ilSetError(context, IL_FILE_READ_ERROR);
-	return i;
+	return (ILuint)i;
 }
 
 
@@ -525,7 +755,7 @@ ILboolean iPreCache(ILcontext* context, ILuint Size)
 	}
 
 	if (context->impl->Cache) {
-		ifree(context->impl->Cache);
+		ifree(context, context->impl->Cache);
 	}
 
 	if (Size == 0) {
@@ -568,7 +798,7 @@ void iUnCache(ILcontext* context)
 	context->impl->CacheSize = 0;
 	context->impl->CachePos = 0;
 	if (context->impl->Cache) {
-		ifree(context->impl->Cache);
+		ifree(context, context->impl->Cache);
 		context->impl->Cache = NULL;
 	}
 	context->impl->UseCache = IL_FALSE;
@@ -579,8 +809,25 @@ void iUnCache(ILcontext* context)
 }
 
 
-ILint ILAPIENTRY iSeekRFile(ILcontext* context, ILint Offset, ILuint Mode)
+// Relative seeks that stay inside the read-ahead window do not touch FileRead.
+//  Absolute seeks always reach FileRead, so that the handle ends up where
+//  the caller expects after a handler seeks back to its starting position.
+ILint ILAPIENTRY iSeekRFile(ILcontext* context, ILint64 Offset, ILuint Mode)
 {
+	ILcontext::Impl *impl = context->impl;
+
+	if (impl->ReadBuffLen > 0) {
+		if (Mode == IL_SEEK_CUR) {
+			if (Offset >= -(ILint64)impl->ReadBuffPos && Offset <= (ILint64)(impl->ReadBuffLen - impl->ReadBuffPos)) {
+				impl->ReadBuffPos += (ILint)Offset;
+				return 0;
+			}
+			// FileRead is at the end of the window, not at the logical position.
+			Offset -= impl->ReadBuffLen - impl->ReadBuffPos;
+		}
+		impl->ReadBuffPos = impl->ReadBuffLen = 0;
+	}
+
 	if (Mode == IL_SEEK_SET)
 		Offset += context->impl->ReadFileStart;  // This allows us to use IL_SEEK_SET in the middle of a file.
 	return context->impl->SeekRProc(context->impl->FileRead, Offset, Mode);
@@ -588,29 +835,30 @@ ILint ILAPIENTRY iSeekRFile(ILcontext* context, ILint Offset, ILuint Mode)
 
 
 // Returns 1 on error, 0 on success
-ILint ILAPIENTRY iSeekRLump(ILcontext* context, ILint Offset, ILuint Mode)
+ILint ILAPIENTRY iSeekRLump(ILcontext* context, ILint64 Offset, ILuint Mode)
 {
 	switch (Mode)
 	{
 		case IL_SEEK_SET:
-			if (Offset > (ILint)context->impl->ReadLumpSize)
+			if (Offset < 0 || (ILuint64)Offset > context->impl->ReadLumpSize)
 				return 1;
-			context->impl->ReadLumpPos = Offset;
+			context->impl->ReadLumpPos = (ILsizei)Offset;
 			break;
 
 		case IL_SEEK_CUR:
-			if (context->impl->ReadLumpPos + Offset > context->impl->ReadLumpSize)
+			if ((ILint64)context->impl->ReadLumpPos + Offset < 0 ||
+				(ILuint64)((ILint64)context->impl->ReadLumpPos + Offset) > context->impl->ReadLumpSize)
 				return 1;
-			context->impl->ReadLumpPos += Offset;
+			context->impl->ReadLumpPos = (ILsizei)((ILint64)context->impl->ReadLumpPos + Offset);
 			break;
 
 		case IL_SEEK_END:
 			if (Offset > 0)
 				return 1;
 			// Should we use >= instead?
-			if (abs(Offset) > (ILint)context->impl->ReadLumpSize)  // If ReadLumpSize == 0, too bad
+			if ((ILuint64)-Offset > context->impl->ReadLumpSize)  // If ReadLumpSize == 0, too bad
 				return 1;
-			context->impl->ReadLumpPos = context->impl->ReadLumpSize + Offset;
+			context->impl->ReadLumpPos = (ILsizei)(context->impl->ReadLumpSize + Offset);
 			break;
 
 		default:
@@ -621,13 +869,15 @@ ILint ILAPIENTRY iSeekRLump(ILcontext* context, ILint Offset, ILuint Mode)
 }
 
 
-ILuint ILAPIENTRY iTellRFile(ILcontext* context)
+ILuint64 ILAPIENTRY iTellRFile(ILcontext* context)
 {
-	return context->impl->TellRProc(context->impl->FileRead);
+	if (context->impl->ReadBuffLen > 0)
+		return context->impl->ReadBuffStart + context->impl->ReadBuffPos;
+	return (ILuint64)context->impl->TellRProc(context->impl->FileRead);
 }
 
 
-ILuint ILAPIENTRY iTellRLump(ILcontext* context)
+ILuint64 ILAPIENTRY iTellRLump(ILcontext* context)
 {
 	return context->impl->ReadLumpPos;
 }
@@ -676,15 +926,15 @@ ILint ILAPIENTRY iWriteFile(ILcontext* context, const void *Buffer, ILuint Size,
 
 ILint ILAPIENTRY iWriteLump(ILcontext* context, const void *Buffer, ILuint Size, ILuint Number)
 {
-	ILuint SizeBytes = Size * Number;
-	ILuint i = 0;
+	ILsizei SizeBytes = (ILsizei)Size * Number;
+	ILsizei i = 0;
 
 	for (; i < SizeBytes; i++) {
 		if (context->impl->WriteLumpSize > 0) {
 			if (context->impl->WriteLumpPos + i >= context->impl->WriteLumpSize) {  // Should we use > instead?
 				ilSetError(context, IL_FILE_WRITE_ERROR);
 				context->impl->WriteLumpPos += i;
-				return i;
+				return (ILint)i;
 			}
 		}
 
@@ -693,11 +943,117 @@ ILint ILAPIENTRY iWriteLump(ILcontext* context, const void *Buffer, ILuint Size,
 
 	context->impl->WriteLumpPos += SizeBytes;
 	
-	return SizeBytes;
+	return (ILint)SizeBytes;
+}
+
+
+// Makes room for End bytes in the growable output buffer, doubling its size so
+//  that long runs of small writes stay linear.
+static ILboolean iGrowDynamic(ILcontext* context, ILuint64 End)
+{
+	ILuint64	NewSize;
+	ILubyte		*NewLump;
+
+	if (End <= context->impl->WriteLumpSize)
+		return IL_TRUE;
+
+	NewSize = context->impl->WriteLumpSize ? context->impl->WriteLumpSize : IL_DYNAMIC_LUMP_SIZE;
+	while (NewSize < End)
+		NewSize *= 2;
+	if ((ILsizei)NewSize != NewSize) {  // Only possible on 32-bit builds
+		ilSetError(context, IL_OUT_OF_MEMORY);
+		return IL_FALSE;
+	}
+
+	NewLump = (ILubyte*)ialloc(context, (ILsizei)NewSize);
+	if (NewLump == NULL)
+		return IL_FALSE;
+	if (context->impl->WriteLump != NULL) {
+		memcpy(NewLump, context->impl->WriteLump, (size_t)context->impl->MaxPos);
+		ifree(context, context->impl->WriteLump);
+	}
+	context->impl->WriteLump = NewLump;
+	context->impl->WriteLumpSize = (ILsizei)NewSize;
+
+	return IL_TRUE;
+}
+
+
+ILint ILAPIENTRY iPutcDynamic(ILcontext* context, ILubyte Char)
+{
+	ILcontext::Impl *impl = context->impl;
+
+	if (impl->WriteLumpPos < impl->WriteLumpSize && impl->WriteLumpPos <= impl->MaxPos) {
+		((ILubyte*)impl->WriteLump)[impl->WriteLumpPos++] = Char;
+		if (impl->WriteLumpPos > impl->MaxPos)
+			impl->MaxPos = impl->WriteLumpPos;
+		return Char;
+	}
+	if (iWriteDynamic(context, &Char, 1, 1) != 1)
+		return IL_EOF;
+	return Char;
+}
+
+
+ILint ILAPIENTRY iWriteDynamic(ILcontext* context, const void *Buffer, ILuint Size, ILuint Number)
+{
+	ILcontext::Impl *impl = context->impl;
+	ILuint64 SizeBytes = (ILuint64)Size * Number;
+	ILuint64 End = impl->WriteLumpPos + SizeBytes;
+
+	if (!iGrowDynamic(context, End)) {
+		ilSetError(context, IL_FILE_WRITE_ERROR);
+		return 0;
+	}
+
+	// Writing past the end after a seek leaves a gap, which reads back as zeros like a file.
+	if (impl->WriteLumpPos > impl->MaxPos)
+		memset((ILubyte*)impl->WriteLump + impl->MaxPos, 0, (size_t)(impl->WriteLumpPos - impl->MaxPos));
+	memcpy((ILubyte*)impl->WriteLump + impl->WriteLumpPos, Buffer, (size_t)SizeBytes);
+
+	impl->WriteLumpPos = (ILsizei)End;
+	if (End > impl->MaxPos)
+		impl->MaxPos = End;
+
+	return Number;
+}
+
+
+// Returns 1 on error, 0 on success
+ILint ILAPIENTRY iSeekWDynamic(ILcontext* context, ILint64 Offset, ILuint Mode)
+{
+	ILint64 NewPos;
+
+	switch (Mode)
+	{
+		case IL_SEEK_SET:
+			NewPos = Offset;
+			break;
+		case IL_SEEK_CUR:
+			NewPos = (ILint64)context->impl->WriteLumpPos + Offset;
+			break;
+		case IL_SEEK_END:
+			NewPos = (ILint64)context->impl->MaxPos + Offset;
+			break;
+		default:
+			return 1;
+	}
+
+	if (NewPos < 0 || (ILsizei)NewPos != (ILuint64)NewPos)
+		return 1;
+	context->impl->WriteLumpPos = (ILsizei)NewPos;
+
+	return 0;
+}
+
+
+ILuint64 ILAPIENTRY iTellWDynamic(ILcontext* context)
+{
+	return context->impl->WriteLumpPos;
 }
 
 
-ILint ILAPIENTRY iSeekWFile(ILcontext* context, ILint Offset, ILuint Mode)
+ILint ILAPIENTRY iSeekWFile(ILcontext* context, ILint64 Offset, ILuint Mode)
 {
 	if (Mode == IL_SEEK_SET)
 		Offset += context->impl->WriteFileStart;  // This allows us to use IL_SEEK_SET in the middle of a file.
@@ -706,29 +1062,30 @@ ILint ILAPIENTRY iSeekWFile(ILcontext* context, ILint Offset, ILuint Mode)
 
 
 // Returns 1 on error, 0 on success
-ILint ILAPIENTRY iSeekWLump(ILcontext* context, ILint Offset, ILuint Mode)
+ILint ILAPIENTRY iSeekWLump(ILcontext* context, ILint64 Offset, ILuint Mode)
 {
 	switch (Mode)
 	{
 		case IL_SEEK_SET:
-			if (Offset > (ILint)context->impl->WriteLumpSize)
+			if (Offset < 0 || (ILuint64)Offset > context->impl->WriteLumpSize)
 				return 1;
-			context->impl->WriteLumpPos = Offset;
+			context->impl->WriteLumpPos = (ILsizei)Offset;
 			break;
 
 		case IL_SEEK_CUR:
-			if (context->impl->WriteLumpPos + Offset > context->impl->WriteLumpSize)
+			if ((ILint64)context->impl->WriteLumpPos + Offset < 0 ||
+				(ILuint64)((ILint64)context->impl->WriteLumpPos + Offset) > context->impl->WriteLumpSize)
 				return 1;
-			context->impl->WriteLumpPos += Offset;
+			context->impl->WriteLumpPos = (ILsizei)((ILint64)context->impl->WriteLumpPos + Offset);
 			break;
 
 		case IL_SEEK_END:
 			if (Offset > 0)
 				return 1;
 			// Should we use >= instead?
-			if (abs(Offset) > (ILint)context->impl->WriteLumpSize)  // If WriteLumpSize == 0, too bad
+			if ((ILuint64)-Offset > context->impl->WriteLumpSize)  // If WriteLumpSize == 0, too bad
 				return 1;
-			context->impl->WriteLumpPos = context->impl->WriteLumpSize + Offset;
+			context->impl->WriteLumpPos = (ILsizei)(context->impl->WriteLumpSize + Offset);
 			break;
 
 		default:
@@ -739,13 +1096,13 @@ ILint ILAPIENTRY iSeekWLump(ILcontext* context, ILint Offset, ILuint Mode)
 }
 
 
-ILuint ILAPIENTRY iTellWFile(ILcontext* context)
+ILuint64 ILAPIENTRY iTellWFile(ILcontext* context)
 {
-	return context->impl->TellWProc(context->impl->FileWrite);
+	return (ILuint64)context->impl->TellWProc(context->impl->FileWrite);
 }
 
 
-ILuint ILAPIENTRY iTellWLump(ILcontext* context)
+ILuint64 ILAPIENTRY iTellWLump(ILcontext* context)
 {
 	return context->impl->WriteLumpPos;
 }
@@ -8,10 +8,6 @@
 //
 // Description: Reads from a Graphics Interchange Format (.gif) file.
 //
-//  The LZW decompression code is based on code released to the public domain
-//    by Javier Arevalo and can be found at
-//    http://www.programmersheaven.com/zone10/cat452
-//
 //-----------------------------------------------------------------------------
 
 #include "il_internal.h"
@@ -22,11 +18,10 @@
 
 ILboolean iGetPalette(ILcontext* context, ILubyte Info, ILpal *Pal, ILboolean UsePrevPal, ILimage *PrevImage);
 ILboolean SkipExtensions(ILcontext* context, GFXCONTROL *Gfx);
-ILboolean RemoveInterlace(ILcontext* context, ILimage *image);
 ILboolean ConvertTransparent(ILcontext* context, ILimage *Image, ILubyte TransColour);
 
 GifHandler::GifHandler(ILcontext* context) :
-	context(context)
+	context(context), CodeOffset(NULL), CodeLength(NULL), Frame(NULL), FrameSize(0)
 {
 
 }
@@ -134,8 +129,9 @@ ILboolean GifHandler::loadL(const void *Lump, ILuint Size)
 // Internal function used to load the Gif.
 ILboolean GifHandler::loadInternal()
 {
-	GIFHEAD	Header;
-	ILpal	GlobalPal;
+	GIFHEAD		Header;
+	ILpal		GlobalPal;
+	ILboolean	bRet;
 
 	if (context->impl->iCurImage == NULL) {
 		ilSetError(context, IL_ILLEGAL_OPERATION);
@@ -149,9 +145,9 @@ ILboolean GifHandler::loadInternal()
 	context->impl->iread(context, &Header.Sig, 1, 6);
   	Header.Width = GetLittleUShort(context);
     Header.Height = GetLittleUShort(context);
-	Header.ColourInfo = context->impl->igetc(context);
-	Header.Background = context->impl->igetc(context);
-	Header.Aspect = context->impl->igetc(context);
+	Header.ColourInfo = iGetcFast(context);
+	Header.Background = iGetcFast(context);
+	Header.Aspect = iGetcFast(context);
 		  
 	if (!strnicmp(Header.Sig, "GIF87A", 6)) {
 		GifType = GIF87A;
@@ -175,14 +171,17 @@ ILboolean GifHandler::loadInternal()
 		}
 	}
 
-	if (!GetImages(&GlobalPal, &Header))
-		return IL_FALSE;
+	bRet = GetImages(&GlobalPal, &Header);
+	cleanUpGifLoadState();
 
 	if (GlobalPal.Palette && GlobalPal.PalSize)
-		ifree(GlobalPal.Palette);
+		ifree(context, GlobalPal.Palette);
 	GlobalPal.Palette = NULL;
 	GlobalPal.PalSize = 0;
 
+	if (!bRet)
+		return IL_FALSE;
+
 	return ilFixImage(context);
 }
 
@@ -219,7 +218,7 @@ ILboolean iGetPalette(ILcontext* context, ILubyte Info, ILpal *Pal, ILboolean Us
 	if (UsePrevPal)
 		memcpy(Pal->Palette, PrevImage->Pal.Palette, PrevImage->Pal.PalSize);  // Copy the old palette over.
 	if (context->impl->iread(context, Pal->Palette + PalOffset, 1, Pal->PalSize) != Pal->PalSize) {  // Read the new palette.
-		ifree(Pal->Palette);
+		ifree(context, Pal->Palette);
 		Pal->Palette = NULL;
 		return IL_FALSE;
 	}
@@ -229,7 +228,7 @@ ILboolean iGetPalette(ILcontext* context, ILubyte Info, ILpal *Pal, ILboolean Us
 
 ILboolean GifHandler::GetImages(ILpal *GlobalPal, GIFHEAD *GifHead)
 {
-	IMAGEDESC	ImageDesc, OldImageDesc;
+	IMAGEDESC	ImageDesc;
 	GFXCONTROL	Gfx;
 	ILboolean	BaseImage = IL_TRUE;
 	ILimage		*Image = context->impl->iCurImage, *TempImage = NULL, *PrevImage = NULL;
@@ -237,7 +236,6 @@ ILboolean GifHandler::GetImages(ILpal *GlobalPal, GIFHEAD *GifHead)
 	ILint		input;
 	ILuint		PalOffset;
 
-	OldImageDesc.ImageInfo = 0; // to initialize the data with an harmless value 
 	Gfx.Used = IL_TRUE;
 
 	while (!context->impl->ieof(context)) {
@@ -252,14 +250,14 @@ ILboolean GifHandler::GetImages(ILpal *GlobalPal, GIFHEAD *GifHead)
 			DisposalMethod = (Gfx.Packed & 0x1C) >> 2;
 
 		//read image descriptor
-		ImageDesc.Separator = context->impl->igetc(context);
+		ImageDesc.Separator = iGetcFast(context);
 		if (ImageDesc.Separator != 0x2C) //end of image
 			break;
 		ImageDesc.OffX = GetLittleUShort(context);
 		ImageDesc.OffY = GetLittleUShort(context);
 		ImageDesc.Width = GetLittleUShort(context);
 		ImageDesc.Height = GetLittleUShort(context);
-		ImageDesc.ImageInfo = context->impl->igetc(context);
+		ImageDesc.ImageInfo = iGetcFast(context);
 
 		if (context->impl->ieof(context)) {
 			ilGetError(context);  // Gets rid of the IL_FILE_READ_ERROR that inevitably results.
@@ -289,11 +287,6 @@ ILboolean GifHandler::GetImages(ILpal *GlobalPal, GIFHEAD *GifHead)
 					memset(Image->Next->Data, GifHead->Background, Image->SizeOfData);
 			else if (DisposalMethod == 1 || DisposalMethod == 0)
 				memcpy(Image->Next->Data, Image->Data, Image->SizeOfData);
-			//Interlacing has to be removed after the image was copied (line above)
-			if (OldImageDesc.ImageInfo & (1 << 6)) {  // Image is interlaced.
-				if (!RemoveInterlace(context, Image))
-					goto error_clean;
-			}
 
 			PrevImage = Image;
 			Image = Image->Next;
@@ -327,8 +320,9 @@ ILboolean GifHandler::GetImages(ILpal *GlobalPal, GIFHEAD *GifHead)
 			}
 		}
 
-		if (!GifGetData(Image, Image->Data + ImageDesc.OffX + ImageDesc.OffY*Image->Width, Image->SizeOfData,
-				ImageDesc.Width, ImageDesc.Height, Image->Width, PalOffset, &Gfx)) {
+		// A frame cut short by the end of the file keeps what was decoded
+		//  (DataEof), and is the last one.
+		if (!GifGetData(Image, &ImageDesc, PalOffset, &Gfx)) {
 			memset(Image->Data, 0, Image->SizeOfData);  //@TODO: Remove this.  For debugging purposes right now.
 			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
 			goto error_clean;
@@ -346,22 +340,18 @@ ILboolean GifHandler::GetImages(ILpal *GlobalPal, GIFHEAD *GifHead)
 				}
 	    	}
 		}
+		if (DataEof) {
+			ilGetError(context);  // Gets rid of the IL_FILE_READ_ERROR from reading past the end.
+			break;
+		}
 		i = context->impl->itell(context);
 		// Terminates each block.
-		if((input = context->impl->igetc(context)) == IL_EOF)
+		if((input = iGetcFast(context)) == IL_EOF)
 			goto error_clean;
 
 		if (input != 0x00)
 		    context->impl->iseek(context, -1, IL_SEEK_CUR);
 		//	break;
-
-		OldImageDesc = ImageDesc;
-	}
-
-	//Deinterlace last image
-	if (OldImageDesc.ImageInfo & (1 << 6)) {  // Image is interlaced.
-		if (!RemoveInterlace(context, Image))
-			goto error_clean;
 	}
 
 	if (BaseImage)  // Was not able to load any images in...
@@ -374,7 +364,7 @@ error_clean:
     /*	while (Image) {
 		TempImage = Image;
 		Image = Image->Next;
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 	}*/
 	return IL_FALSE;
 }
@@ -390,7 +380,7 @@ ILboolean SkipExtensions(ILcontext* context, GFXCONTROL *Gfx)
 	//	return IL_TRUE;  // No extensions in the GIF87a format.
 
 	do {
-		if((Code = context->impl->igetc(context)) == IL_EOF)
+		if((Code = iGetcFast(context)) == IL_EOF)
 			return IL_FALSE;
 
 		if (Code != 0x21) {
@@ -398,17 +388,17 @@ ILboolean SkipExtensions(ILcontext* context, GFXCONTROL *Gfx)
 			return IL_TRUE;
 		}
 
-		if((Label = context->impl->igetc(context)) == IL_EOF)
+		if((Label = iGetcFast(context)) == IL_EOF)
 			return IL_FALSE;
 
 		switch (Label)
 		{
 			case 0xF9:
-				Gfx->Size = context->impl->igetc(context);
-				Gfx->Packed = context->impl->igetc(context);
+				Gfx->Size = iGetcFast(context);
+				Gfx->Packed = iGetcFast(context);
 				Gfx->Delay = GetLittleUShort(context);
-				Gfx->Transparent = context->impl->igetc(context);
-				Gfx->Terminator = context->impl->igetc(context);
+				Gfx->Transparent = iGetcFast(context);
+				Gfx->Terminator = iGetcFast(context);
 				if (context->impl->ieof(context))
 					return IL_FALSE;
 				Gfx->Used = IL_FALSE;
@@ -420,7 +410,7 @@ ILboolean SkipExtensions(ILcontext* context, GFXCONTROL *Gfx)
 				break;*/
 			default:
 				do {
-					if((Size = context->impl->igetc(context)) == IL_EOF)
+					if((Size = iGetcFast(context)) == IL_EOF)
 						return IL_FALSE;
 					context->impl->iseek(context, Size, IL_SEEK_CUR);
 				} while (!context->impl->ieof(context) && Size != 0);
@@ -438,222 +428,59 @@ ILboolean SkipExtensions(ILcontext* context, GFXCONTROL *Gfx)
 
 #define MAX_CODES 4096
 
-ILuint code_mask[13] =
+// Reads the next data sub-block into Block.  Each sub-block is fetched with a
+//  single iread, together with the size byte of the one after it.
+ILboolean GifHandler::NextBlock()
 {
-   0L,
-   0x0001L, 0x0003L,
-   0x0007L, 0x000FL,
-   0x001FL, 0x003FL,
-   0x007FL, 0x00FFL,
-   0x01FFL, 0x03FFL,
-   0x07FFL, 0x0FFFL
-};
-
-ILint GifHandler::get_next_code()
-{
-	ILint	i, t;
-	ILuint	ret;
-
-	//20050102: Tests for IL_EOF were added because this function
-	//crashed sometimes if igetc() returned IL_EOF
-	//(for example "table-add-column-before-active.gif" included in the
-	//mozilla source package)
-
-	if (!nbits_left) {
-		if (navail_bytes <= 0) {
-			pbytes = byte_buff;
-			navail_bytes = context->impl->igetc(context);
-
-			if(navail_bytes == IL_EOF) {
-				success = IL_FALSE;
-				return ending;
-			}
-
-			if (navail_bytes) {
-				for (i = 0; i < navail_bytes; i++) {
-					if((t = context->impl->igetc(context)) == IL_EOF) {
-						success = IL_FALSE;
-						return ending;
-					}
-					byte_buff[i] = t;
-				}
-			}
-		}
-		b1 = *pbytes++;
-		nbits_left = 8;
-		navail_bytes--;
-	}
-
-	ret = b1 >> (8 - nbits_left);
-	while (curr_size > nbits_left) {
-		if (navail_bytes <= 0) {
-			pbytes = byte_buff;
-			navail_bytes = context->impl->igetc(context);
+	ILuint Read;
 
-			if(navail_bytes == IL_EOF) {
-				success = IL_FALSE;
-				return ending;
-			}
+	if (NextSize == 0)  // Reached the block terminator.
+		return IL_FALSE;
 
-			if (navail_bytes) {
-				for (i = 0; i < navail_bytes; i++) {
-					if((t = context->impl->igetc(context)) == IL_EOF) {
-						success = IL_FALSE;
-						return ending;
-					}
-					byte_buff[i] = t;
-				}
-			}
-		}
-		b1 = *pbytes++;
-		ret |= b1 << nbits_left;
-		nbits_left += 8;
-		navail_bytes--;
+	Read = context->impl->iread(context, Block, 1, NextSize + 1);
+	BlockPos = 0;
+	if (Read == NextSize + 1) {
+		BlockSize = NextSize;
+		NextSize = Block[NextSize];
+	}
+	else {  // The file ends in the middle of the data.
+		BlockSize = IL_MIN(Read, NextSize);
+		NextSize = 0;
+		DataEof = IL_TRUE;
 	}
-	nbits_left -= curr_size;
-
-	return (ret & code_mask[curr_size]);
-}
 
-void GifHandler::cleanUpGifLoadState()
-{
-	ifree(stack);
-	ifree(suffix);
-	ifree(prefix);
+	return BlockSize != 0 ? IL_TRUE : IL_FALSE;
 }
 
-ILboolean GifHandler::GifGetData(ILimage *Image, ILubyte *Data, ILuint ImageSize, ILuint Width, ILuint Height, ILuint Stride, ILuint PalOffset, GFXCONTROL *Gfx)
+// Gets the next Size-bit code (codes are packed from the lowest bit up), or
+//  -1 if the data runs out.
+ILint GifHandler::GetCode(ILuint Size)
 {
-	ILubyte	*sp;
-	ILint	code, fc, oc;
-	ILubyte	DisposalMethod = 0;
-	ILint	c, size;
-	ILuint	i = 0, Read = 0, j = 0;
-	ILubyte	*DataPtr = Data;
-
-	if (!Gfx->Used)
-		DisposalMethod = (Gfx->Packed & 0x1C) >> 2;
-	if((size = context->impl->igetc(context)) == IL_EOF)
-		return IL_FALSE;
+	ILuint Code;
 
-	if (size < 2 || 9 < size) {
-		return IL_FALSE;
+	while (BitCount < Size) {
+		if (BlockPos == BlockSize && !NextBlock())
+			return -1;
+		BitBuf |= (ILuint)Block[BlockPos++] << BitCount;
+		BitCount += 8;
 	}
 
-	stack  = (ILubyte*)ialloc(context, MAX_CODES + 1);
-	suffix = (ILubyte*)ialloc(context, MAX_CODES + 1);
-	prefix = (ILshort*)ialloc(context, sizeof(*prefix) * (MAX_CODES + 1));
-	if (!stack || !suffix || !prefix)
-	{
-		cleanUpGifLoadState();
-		return IL_FALSE;
-	}
+	Code = BitBuf & ((1 << Size) - 1);
+	BitBuf >>= Size;
+	BitCount -= Size;
 
-	curr_size = size + 1;
-	top_slot = 1 << curr_size;
-	clear = 1 << size;
-	ending = clear + 1;
-	slot = newcodes = ending + 1;
-	navail_bytes = nbits_left = 0;
-	oc = fc = 0;
-	sp = stack;
-
-	while ((c = get_next_code()) != ending && Read < Height) {
-		if (c == clear)
-		{
-			curr_size = size + 1;
-			slot = newcodes;
-			top_slot = 1 << curr_size;
-			while ((c = get_next_code()) == clear);
-			if (c == ending)
-				break;
-			if (c >= slot)
-				c = 0;
-			oc = fc = c;
-
-			if (DisposalMethod == 1 && !Gfx->Used && Gfx->Transparent == c && (Gfx->Packed & 0x1) != 0)
-				i++;
-			else if (i < Width)
-				DataPtr[i++] = c + PalOffset;
-
-			if (i == Width)
-			{
-				DataPtr += Stride;
-				i = 0;
-				Read += 1;
-                ++j;
-                if (j >= Height) {
-                   cleanUpGifLoadState();
-                   return IL_FALSE;
-                }
-			}
-		}
-		else
-		{
-			code = c;
-            //BG-2007-01-10: several fixes for incomplete GIFs
-			if (code >= slot)
-			{
-				code = oc;
-                if (sp >= stack + MAX_CODES) {
-                   cleanUpGifLoadState();
-                   return IL_FALSE;
-                }
-                *sp++ = fc;
-			}
+	return Code;
+}
 
-            if (code >= MAX_CODES)
-                return IL_FALSE; 
-                while (code >= newcodes)
-				{
-                    if (sp >= stack + MAX_CODES)
-					{
-                        cleanUpGifLoadState();
-                        return IL_FALSE;
-                    }
-                    *sp++ = suffix[code];
-                    code = prefix[code];
-                }
-            
-                if (sp >= stack + MAX_CODES) {
-                cleanUpGifLoadState();
-                return IL_FALSE;
-            }
-
-            *sp++ = (ILbyte)code;
-			if (slot < top_slot)
-			{
-				fc = code;
-				suffix[slot]   = fc;
-				prefix[slot++] = oc;
-				oc = c;
-			}
-			if (slot >= top_slot && curr_size < 12)
-			{
-				top_slot <<= 1;
-				curr_size++;
-			}
-			while (sp > stack)
-			{
-				sp--;
-				if (DisposalMethod == 1 && !Gfx->Used && Gfx->Transparent == *sp && (Gfx->Packed & 0x1) != 0)
-					i++;
-				else if (i < Width)
-					DataPtr[i++] = *sp + PalOffset;
-
-				if (i == Width)
-				{
-					i = 0;
-					Read += 1;
-                    j = (j+1) % Height;
-					// Needs to start from Data, not Image->Data.
-					DataPtr = Data + j * Stride;
-				}
-			}
-		}
-	}
-	cleanUpGifLoadState();
-	return IL_TRUE;
+void GifHandler::cleanUpGifLoadState()
+{
+	ifree(context, CodeOffset);
+	ifree(context, CodeLength);
+	ifree(context, Frame);
+	CodeOffset = NULL;
+	CodeLength = NULL;
+	Frame = NULL;
+	FrameSize = 0;
 }
 
 /*From the GIF spec:
@@ -665,40 +492,164 @@ ILboolean GifHandler::GifGetData(ILimage *Image, ILubyte *Data, ILuint ImageSize
       Group 3 : Every 4th. row, starting with row 2.              (Pass 3)
       Group 4 : Every 2nd. row, starting with row 1.              (Pass 4)
 */
-
-ILboolean RemoveInterlace(ILcontext* context, ILimage *image)
+static const ILuint InterlaceStart[4] = { 0, 4, 2, 1 };
+static const ILuint InterlaceStep[4]  = { 8, 8, 4, 2 };
+
+// Decodes the frame described by Desc into Image.  Every string a code stands
+//  for has already been written out once (the string of the code before it,
+//  plus one more pixel), so the table only keeps where that was and how long
+//  it is, and each string is copied with one memcpy.  The frame is decoded
+//  straight into Image when it covers whole rows of it and needs no index
+//  changes; otherwise it goes to Frame and each row is then put where it
+//  belongs, so interlaced rows end up in order without another pass.
+ILboolean GifHandler::GifGetData(ILimage *Image, IMAGEDESC *Desc, ILuint PalOffset, GFXCONTROL *Gfx)
 {
-	ILubyte *NewData;
-	ILuint	i, j = 0;
-
-	NewData = (ILubyte*)ialloc(context, image->SizeOfData);
-	if (NewData == NULL)
+	ILubyte		*Out, *Src, *Dest;
+	ILuint		Width = Desc->Width, Height = Desc->Height, Stride = Image->Width;
+	ILuint		Size, Clear, Slot, CodeSize, Capacity, Pos, Len, PrevPos = 0, PrevLen = 0;
+	ILuint		Rows, Row, Pass, VisWidth, Count, i, x;
+	ILint		Code, Trans = -1;
+	ILboolean	First = IL_TRUE, Interlaced, Direct;
+
+	// With "keep the old image" disposal, transparent pixels leave what is there.
+	if (!Gfx->Used && (Gfx->Packed & 0x1) != 0 && ((Gfx->Packed & 0x1C) >> 2) == 1)
+		Trans = Gfx->Transparent;
+	Interlaced = (Desc->ImageInfo & (1 << 6)) ? IL_TRUE : IL_FALSE;
+
+	if ((Code = iGetcFast(context)) == IL_EOF)
+		return IL_FALSE;
+	Size = Code;
+	if (Size < 2 || 9 < Size) {
 		return IL_FALSE;
-
-	//changed 20041230: images with offsety != 0 were not
-	//deinterlaced correctly before...
-	for (i = 0; i < image->OffY; i++, j++) {
-		memcpy(&NewData[i * image->Bps], &image->Data[j * image->Bps], image->Bps);
 	}
-
-	for (i = 0 + image->OffY; i < image->Height; i += 8, j++) {
-		memcpy(&NewData[i * image->Bps], &image->Data[j * image->Bps], image->Bps);
+	BlockSize = BlockPos = BitBuf = BitCount = 0;
+	DataEof = IL_FALSE;
+	if ((Code = iGetcFast(context)) == IL_EOF) {
+		Code = 0;
+		DataEof = IL_TRUE;
 	}
+	NextSize = Code;
 
-	for (i = 4 + image->OffY; i < image->Height; i += 8, j++) {
-		memcpy(&NewData[i * image->Bps], &image->Data[j * image->Bps], image->Bps);
+	if (CodeOffset == NULL) {
+		CodeOffset = (ILuint*)ialloc(context, MAX_CODES * sizeof(ILuint));
+		CodeLength = (ILushort*)ialloc(context, MAX_CODES * sizeof(ILushort));
+		if (CodeOffset == NULL || CodeLength == NULL)
+			return IL_FALSE;
 	}
 
-	for (i = 2 + image->OffY; i < image->Height; i += 4, j++) {
-		memcpy(&NewData[i * image->Bps], &image->Data[j * image->Bps], image->Bps);
+	// Rows below the image are never seen, so only interlaced frames (whose
+	//  rows come out of order) need to be decoded in full.
+	Rows = Height;
+	if (!Interlaced)
+		Rows = Desc->OffY < Image->Height ? IL_MIN(Height, Image->Height - Desc->OffY) : 0;
+	Capacity = Width * Rows;
+	Direct = Desc->OffX == 0 && Width == Stride && !Interlaced && PalOffset == 0 && Trans < 0;
+	if (Direct) {
+		Out = Image->Data + Desc->OffY * Stride;
 	}
+	else {
+		if (FrameSize < Capacity) {
+			ifree(context, Frame);
+			Frame = (ILubyte*)ialloc(context, Capacity);
+			FrameSize = Frame != NULL ? Capacity : 0;
+			if (Frame == NULL)
+				return IL_FALSE;
+		}
+		Out = Frame;
+	}
+
+	Clear = 1 << Size;
+	CodeSize = Size + 1;
+	Slot = Clear + 2;
+	Pos = 0;
 
-	for (i = 1 + image->OffY; i < image->Height; i += 2, j++) {
-		memcpy(&NewData[i * image->Bps], &image->Data[j * image->Bps], image->Bps);
+	while (Pos < Capacity) {
+		Code = GetCode(CodeSize);
+		if (Code < 0 || Code == (ILint)Clear + 1)  // Out of data or the end code
+			break;
+		if (Code == (ILint)Clear) {
+			CodeSize = Size + 1;
+			Slot = Clear + 2;
+			First = IL_TRUE;
+			continue;
+		}
+
+		if (First) {
+			if (Code >= (ILint)Clear)  // Has to be a single pixel; broken files get 0.
+				Code = 0;
+			Out[Pos] = (ILubyte)Code;
+			PrevPos = Pos++;
+			PrevLen = 1;
+			First = IL_FALSE;
+			continue;
+		}
+
+		if (Code < (ILint)Clear) {
+			Out[Pos] = (ILubyte)Code;
+			Len = 1;
+		}
+		else if (Code < (ILint)Slot) {
+			Len = CodeLength[Code];
+			memcpy(Out + Pos, Out + CodeOffset[Code], IL_MIN(Len, Capacity - Pos));
+		}
+		else {  // Not in the table yet: the previous string and its first pixel again.
+			Len = PrevLen + 1;
+			memcpy(Out + Pos, Out + PrevPos, IL_MIN(PrevLen, Capacity - Pos));
+			if (PrevLen < Capacity - Pos)
+				Out[Pos + PrevLen] = Out[PrevPos];
+		}
+
+		// The new code is the previous string followed by the first pixel of
+		//  this one, which is exactly what was just written from PrevPos.
+		if (Slot < MAX_CODES) {
+			CodeOffset[Slot] = PrevPos;
+			CodeLength[Slot] = (ILushort)(PrevLen + 1);
+			if (++Slot == (1U << CodeSize) && CodeSize < 12)
+				CodeSize++;
+		}
+
+		PrevPos = Pos;
+		PrevLen = Len;
+		Pos += IL_MIN(Len, Capacity - Pos);
 	}
 
-	ifree(image->Data);
-	image->Data = NewData;
+	// Skip whatever is left, but leave the block terminator for GetImages.
+	while (NextBlock())
+		;
+	if (!DataEof)
+		context->impl->iseek(context, -1, IL_SEEK_CUR);
+
+	if (Direct || Pos == 0)
+		return IL_TRUE;
+
+	// Puts each decoded row where it goes, clipped to the image.
+	VisWidth = Desc->OffX < Stride ? IL_MIN(Width, Stride - Desc->OffX) : 0;
+	Rows = (Pos + Width - 1) / Width;
+	Pass = 0;
+	Row = 0;
+	for (i = 0; i < Rows; i++) {
+		if (Interlaced) {
+			while (Pass < 3 && Row >= Height) {
+				Pass++;
+				Row = InterlaceStart[Pass];
+			}
+		}
+		if (Desc->OffY + Row < Image->Height) {
+			Src = Out + i * Width;
+			Dest = Image->Data + (Desc->OffY + Row) * Stride + Desc->OffX;
+			Count = IL_MIN(VisWidth, Pos - i * Width);
+			if (PalOffset == 0 && Trans < 0) {
+				memcpy(Dest, Src, Count);
+			}
+			else {
+				for (x = 0; x < Count; x++) {
+					if (Src[x] != Trans)
+						Dest[x] = (ILubyte)(Src[x] + PalOffset);
+				}
+			}
+		}
+		Row += Interlaced ? InterlaceStep[Pass] : 1;
+	}
 
 	return IL_TRUE;
 }
@@ -728,7 +679,7 @@ ILboolean ConvertTransparent(ILcontext* context, ILimage *Image, ILubyte TransCo
 			Palette[j+3] = 0xFF;
 	}
 
-	ifree(Image->Pal.Palette);
+	ifree(context, Image->Pal.Palette);
 	Image->Pal.Palette = Palette;
 	Image->Pal.PalSize = Image->Pal.PalSize / 3 * 4;
 	Image->Pal.PalType = IL_PAL_RGBA32;
@@ -188,13 +188,43 @@ ILboolean HdrHandler::loadL(const void *Lump, ILuint Size)
 	return loadInternal();
 }
 
+// Converts Width pixels of a decoded scanline from hdrs internal format to floats.
+static void iHdrRgbeToFloat(const ILubyte *scanline, ILuint Width, ILfloat *data)
+{
+	ILuint j, e, r, g, b;
+
+	for (j = 0; j < 4*Width; j += 4) {
+		ILuint *ee;
+		ILfloat t, *ff;
+		e = scanline[j + 3];
+		r = scanline[j + 0];
+		g = scanline[j + 1];
+		b = scanline[j + 2];
+
+		//t = (float)pow(2.f, ((ILint)e) - 128);
+		if (e != 0)
+			e = (e - 1) << 23;
+		
+		// All this just to avoid stric-aliasing warnings...
+		// was: t = *(ILfloat*)&e
+		ee = &e;
+		ff = (ILfloat*)ee;
+		t = *ff;
+		
+		data[0] = (r/255.0f)*t;
+		data[1] = (g/255.0f)*t;
+		data[2] = (b/255.0f)*t;
+		data += 3;
+	}
+}
+
 // Internal function used to load the .hdr.
 ILboolean HdrHandler::loadInternal()
 {
 	HDRHEADER	Header;
 	ILfloat *data;
 	ILubyte *scanline;
-	ILuint i, j, e, r, g, b;
+	ILuint i;
 
 	if (context->impl->iCurImage == NULL) {
 		ilSetError(context, IL_ILLEGAL_OPERATION);
@@ -225,38 +255,67 @@ ILboolean HdrHandler::loadInternal()
 	scanline = (ILubyte*)ialloc(context, Header.Width*4);
 	for (i = 0; i < Header.Height; ++i) {
 		ReadScanline(scanline, Header.Width);
-
-		//convert hdrs internal format to floats
-		for (j = 0; j < 4*Header.Width; j += 4) {
-			ILuint *ee;
-			ILfloat t, *ff;
-			e = scanline[j + 3];
-			r = scanline[j + 0];
-			g = scanline[j + 1];
-			b = scanline[j + 2];
-
-			//t = (float)pow(2.f, ((ILint)e) - 128);
-			if (e != 0)
-				e = (e - 1) << 23;
-			
-			// All this just to avoid stric-aliasing warnings...
-			// was: t = *(ILfloat*)&e
-			ee = &e;
-			ff = (ILfloat*)ee;
-			t = *ff;
-			
-			data[0] = (r/255.0f)*t;
-			data[1] = (g/255.0f)*t;
-			data[2] = (b/255.0f)*t;
-			data += 3;
-		}
+		iHdrRgbeToFloat(scanline, Header.Width, data);
+		data += 3 * Header.Width;
 	}
 	iUnCache(context);
-	ifree(scanline);
+	ifree(context, scanline);
 
 	return ilFixImage(context);
 }
 
+//! Reads an already-opened .hdr file and gives its rows to Sink (ilLoadRows)
+ILboolean HdrHandler::loadRowsF(ILHANDLE File, iRowSink *Sink)
+{
+	ILuint		FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = loadRowsInternal(Sink);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+//! Reads a .hdr in a memory "lump" and gives its rows to Sink (ilLoadRows)
+ILboolean HdrHandler::loadRowsL(const void *Lump, ILuint Size, iRowSink *Sink)
+{
+	iSetInputLump(context, Lump, Size);
+	return loadRowsInternal(Sink);
+}
+
+// Decodes each scanline straight into the band that goes to the sink.
+ILboolean HdrHandler::loadRowsInternal(iRowSink *Sink)
+{
+	HDRHEADER	Header;
+	ILubyte		*scanline, *Row;
+	ILuint		i;
+
+	if (!iGetHdrHead(context, &Header) || !iCheckHdr(&Header)) {
+		ilSetError(context, IL_INVALID_FILE_HEADER);
+		return IL_FALSE;
+	}
+	if (!iSinkBegin(context, Sink, Header.Width, Header.Height, IL_RGB, IL_FLOAT))
+		return IL_FALSE;
+
+	scanline = (ILubyte*)ialloc(context, Header.Width*4);
+	if (scanline == NULL)
+		return IL_FALSE;
+	for (i = 0; i < Header.Height; ++i) {
+		Row = iSinkRows(context, Sink, 1);
+		if (Row == NULL) {
+			ifree(context, scanline);
+			return IL_FALSE;
+		}
+		ReadScanline(scanline, Header.Width);
+		iHdrRgbeToFloat(scanline, Header.Width, (ILfloat*)Row);
+	}
+	ifree(context, scanline);
+
+	return IL_TRUE;
+}
+
 void HdrHandler::ReadScanline(ILubyte *scanline, ILuint w) {
 	ILubyte *runner;
 	ILuint r, g, b, e, read, shift;
@@ -396,6 +455,17 @@ ILuint HdrHandler::saveL(void *Lump, ILuint Size)
 	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
 }
 
+//! Writes an image given as rows (ilSaveRows) to an already-opened file
+ILuint HdrHandler::saveRowsF(ILHANDLE File, iRowSource *Src)
+{
+	ILuint Pos;
+	iSetOutputFile(context, File);
+	Pos = context->impl->itellw(context);
+	if (saveRowsInternal(Src) == IL_FALSE)
+		return 0;  // Error occurred
+	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+}
+
 //
 // Much of the saving code is based on the code by Bruce Walter,
 //  available at http://www.graphics.cornell.edu/online/formats/rgbe/.
@@ -555,15 +625,44 @@ ILboolean RGBE_WriteBytes_RLE(ILcontext* context, ILubyte *data, ILuint numbytes
 #undef MINRUNLENGTH
 }
 
+// Writes a row of Width RGB floats, each of the four RGBE channels run length
+//	encoded separately.  Buffer holds 4 * Width bytes.
+static ILboolean iHdrWriteRleRow(ILcontext* context, const ILfloat *data, ILuint Width, ILubyte *buffer)
+{
+	unsigned char rgbe[4];
+	ILuint i;
+
+	rgbe[0] = 2;
+	rgbe[1] = 2;
+	rgbe[2] = Width >> 8;
+	rgbe[3] = Width & 0xFF;
+	if (context->impl->iwrite(context, rgbe, sizeof(rgbe), 1) < 1)
+		return IL_FALSE;
+
+	for(i=0;i<Width;i++) {
+		float2rgbe(rgbe,data[RGBE_DATA_RED],data[RGBE_DATA_GREEN],data[RGBE_DATA_BLUE]);
+		buffer[i] = rgbe[0];
+		buffer[i+Width] = rgbe[1];
+		buffer[i+2*Width] = rgbe[2];
+		buffer[i+3*Width] = rgbe[3];
+		data += RGBE_DATA_SIZE;
+	}
+	/* write out each of the four channels separately run length encoded */
+	/* first red, then green, then blue, then exponent */
+	for(i=0;i<4;i++) {
+		if (RGBE_WriteBytes_RLE(context, &buffer[i*Width],Width) != IL_TRUE)
+			return IL_FALSE;
+	}
+	return IL_TRUE;
+}
+
 // Internal function used to save the Hdr.
 ILboolean HdrHandler::saveInternal()
 {
 	ILimage *TempImage;
 	rgbe_header_info stHeader;
-	unsigned char rgbe[4];
 	ILubyte		*buffer;
 	ILfloat		*data;
-	ILuint		i;
 	ILboolean	bRet;
 
 	if (context->impl->iCurImage == NULL) {
@@ -595,7 +694,7 @@ ILboolean HdrHandler::saveInternal()
 		/* run length encoding is not allowed so write flat*/
 		bRet = RGBE_WritePixels(context, data,TempImage->Width*TempImage->Height);
 		if (context->impl->iCurImage != TempImage)
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 		return bRet;
 	}
 	buffer = (ILubyte*)ialloc(context, sizeof(ILubyte)*4*TempImage->Width);
@@ -603,46 +702,68 @@ ILboolean HdrHandler::saveInternal()
 		/* no buffer space so write flat */
 		bRet = RGBE_WritePixels(context, data,TempImage->Width*TempImage->Height);
 		if (context->impl->iCurImage != TempImage)
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 		return bRet;
 	}
 
 	while(TempImage->Height-- > 0) {
-		rgbe[0] = 2;
-		rgbe[1] = 2;
-		rgbe[2] = TempImage->Width >> 8;
-		rgbe[3] = TempImage->Width & 0xFF;
-		if (context->impl->iwrite(context, rgbe, sizeof(rgbe), 1) < 1) {
-			free(buffer);
+		if (!iHdrWriteRleRow(context, data, TempImage->Width, buffer)) {
+			ifree(context, buffer);
 			if (context->impl->iCurImage != TempImage)
-				ilCloseImage(TempImage);
+				ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
-
-		for(i=0;i<TempImage->Width;i++) {
-			float2rgbe(rgbe,data[RGBE_DATA_RED],data[RGBE_DATA_GREEN],data[RGBE_DATA_BLUE]);
-			buffer[i] = rgbe[0];
-			buffer[i+TempImage->Width] = rgbe[1];
-			buffer[i+2*TempImage->Width] = rgbe[2];
-			buffer[i+3*TempImage->Width] = rgbe[3];
-			data += RGBE_DATA_SIZE;
-		}
-		/* write out each of the four channels separately run length encoded */
-		/* first red, then green, then blue, then exponent */
-		for(i=0;i<4;i++) {
-			if (RGBE_WriteBytes_RLE(context, &buffer[i*TempImage->Width],TempImage->Width) != IL_TRUE) {
-				ifree(buffer);
-				if (context->impl->iCurImage != TempImage)
-					ilCloseImage(TempImage);
-				return IL_FALSE;
-			}
-		}
+		data += RGBE_DATA_SIZE * TempImage->Width;
 	}
-	ifree(buffer);
+	ifree(context, buffer);
 
 	if (context->impl->iCurImage != TempImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 	return IL_TRUE;
 }
 
+// Writes the rows as they arrive; .hdr files are stored top-down anyway.
+ILboolean HdrHandler::saveRowsInternal(iRowSource *Src)
+{
+	rgbe_header_info stHeader;
+	ILubyte		*buffer = NULL, *Row;
+	ILuint		y;
+	ILboolean	Rle, bRet = IL_FALSE;
+
+	stHeader.exposure = 0;
+	stHeader.gamma = 0;
+	stHeader.programtype[0] = 0;
+	stHeader.valid = 0;
+
+	if (!iRowsBegin(context, Src, IL_RGB, IL_FLOAT))
+		return IL_FALSE;
+	/* run length encoding is not allowed for these widths so write flat */
+	Rle = Src->Width >= 8 && Src->Width <= 0x7fff;
+	if (Rle) {
+		buffer = (ILubyte*)ialloc(context, sizeof(ILubyte)*4*Src->Width);
+		if (buffer == NULL)
+			return IL_FALSE;
+	}
+
+	if (!RGBE_WriteHeader(context, Src->Width, Src->Height, &stHeader))
+		goto cleanup;
+
+	for (y = 0; y < Src->Height; y++) {
+		Row = iRowsNext(context, Src);
+		if (Row == NULL)
+			goto cleanup;
+		if (Rle) {
+			if (!iHdrWriteRleRow(context, (ILfloat*)Row, Src->Width, buffer))
+				goto cleanup;
+		}
+		else if (!RGBE_WritePixels(context, (ILfloat*)Row, Src->Width))
+			goto cleanup;
+	}
+	bRet = IL_TRUE;
+
+cleanup:
+	ifree(context, buffer);
+	return bRet;
+}
+
 #endif//IL_NO_HDR
\ No newline at end of file
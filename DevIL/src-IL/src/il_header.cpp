@@ -109,7 +109,7 @@ ILboolean CHeaderHandler::save(ILconst_string FileName)
 		fprintf(HeadFile, "\n");
 	}
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	fprintf(HeadFile, "};\n");
 
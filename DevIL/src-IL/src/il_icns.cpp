@@ -302,7 +302,7 @@ ILboolean iIcnsReadData(ILcontext* context, ILboolean *BaseCreated, ILboolean Is
 		context->impl->iread(context, Data, Entry->Size - 8, 1);  // Size includes the header
 		if (Entry->Size - 8 != Width * Width)
 		{
-			ifree(Data);
+			ifree(context, Data);
 			return IL_FALSE;
 		}
 
@@ -317,7 +317,7 @@ ILboolean iIcnsReadData(ILcontext* context, ILboolean *BaseCreated, ILboolean Is
 		context->impl->iread(context, Data, Entry->Size - 8, 1);  // Size includes the header
 		if (Jp2Handler::LoadLToImage(context, Data, Entry->Size - 8, TempImage) == IL_FALSE)
 		{
-			ifree(Data);
+			ifree(context, Data);
 			ilSetError(context, IL_LIB_JP2_ERROR);
 			return IL_TRUE;
 		}
@@ -376,7 +376,7 @@ ILboolean iIcnsReadData(ILcontext* context, ILboolean *BaseCreated, ILboolean Is
 		}
 	}
 
-	ifree(Data);
+	ifree(context, Data);
 	return IL_TRUE;
 }
 
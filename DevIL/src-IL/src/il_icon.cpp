@@ -144,8 +144,8 @@ ILboolean IconHandler::loadInternal()
 	DirEntries = (ICODIRENTRY*)ialloc(context, sizeof(ICODIRENTRY) * IconDir.Count);
 	IconImages = (ICOIMAGE*)ialloc(context, sizeof(ICOIMAGE) * IconDir.Count);
 	if (DirEntries == NULL || IconImages == NULL) {
-		ifree(DirEntries);
-		ifree(IconImages);
+		ifree(context, DirEntries);
+		ifree(context, IconImages);
 		return IL_FALSE;
 	}
 
@@ -416,12 +416,12 @@ ILboolean IconHandler::loadInternal()
 
 
 	for (i = 0; i < IconDir.Count; i++) {
-		ifree(IconImages[i].Pal);
-		ifree(IconImages[i].Data);
-		ifree(IconImages[i].AND);
+		ifree(context, IconImages[i].Pal);
+		ifree(context, IconImages[i].Data);
+		ifree(context, IconImages[i].AND);
 	}
-	ifree(IconImages);
-	ifree(DirEntries);
+	ifree(context, IconImages);
+	ifree(context, DirEntries);
 
 	return ilFixImage(context);
 
@@ -429,44 +429,48 @@ file_read_error:
 	if (IconImages) {
 		for (i = 0; i < IconDir.Count; i++) {
 			if (IconImages[i].Pal)
-				ifree(IconImages[i].Pal);
+				ifree(context, IconImages[i].Pal);
 			if (IconImages[i].Data)
-				ifree(IconImages[i].Data);
+				ifree(context, IconImages[i].Data);
 			if (IconImages[i].AND)
-				ifree(IconImages[i].AND);
+				ifree(context, IconImages[i].AND);
 		}
-		ifree(IconImages);
+		ifree(context, IconImages);
 	}
 	if (DirEntries)
-		ifree(DirEntries);
+		ifree(context, DirEntries);
 	return IL_FALSE;
 }
 
 #ifndef IL_NO_PNG
 // 08-22-2008: Copying a lot of this over from il_png.c for the moment.
 // @TODO: Make .ico and .png use the same functions.
-png_structp ico_png_ptr = NULL;
-png_infop   ico_info_ptr = NULL;
-ILint		ico_color_type;
+typedef struct ICOPNG
+{
+	png_structp	png_ptr;
+	png_infop	info_ptr;
+	ILint		color_type;
+} ICOPNG;
 
 #define GAMMA_CORRECTION 1.0  // Doesn't seem to be doing anything...
 
-ILint ico_readpng_init(ILcontext* context);
-ILboolean ico_readpng_get_image(ILcontext* context, ICOIMAGE *Icon, ILdouble display_exponent);
-void ico_readpng_cleanup();
+ILint ico_readpng_init(ILcontext* context, ICOPNG *Png);
+ILboolean ico_readpng_get_image(ILcontext* context, ICOPNG *Png, ICOIMAGE *Icon, ILdouble display_exponent);
+void ico_readpng_cleanup(ICOPNG *Png);
 #endif
 
 ILboolean iLoadIconPNG(ILcontext* context, ICOIMAGE *Icon)
 {
 #ifndef IL_NO_PNG
+	ICOPNG Png = { NULL, NULL, 0 };
 	ILint init;
-	init = ico_readpng_init(context);
+	init = ico_readpng_init(context, &Png);
 	if (init)
 		return IL_FALSE;
-	if (!ico_readpng_get_image(context, Icon, GAMMA_CORRECTION))
+	if (!ico_readpng_get_image(context, &Png, Icon, GAMMA_CORRECTION))
 		return IL_FALSE;
 
-	ico_readpng_cleanup();
+	ico_readpng_cleanup(&Png);
 	Icon->Head.Size = 0;	// Easiest way to tell that this is a PNG.
 							// In the normal routine, it will not be 0.
 
@@ -509,15 +513,15 @@ static void ico_png_warn_func(png_structp png_ptr, png_const_charp message)
 	return;
 }
 
-ILint ico_readpng_init(ILcontext* context)
+ILint ico_readpng_init(ILcontext* context, ICOPNG *Png)
 {
-	ico_png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, ico_png_error_func, ico_png_warn_func);
-	if (!ico_png_ptr)
+	Png->png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, ico_png_error_func, ico_png_warn_func);
+	if (!Png->png_ptr)
 		return 4;	/* out of memory */
 
-	ico_info_ptr = png_create_info_struct(ico_png_ptr);
-	if (!ico_info_ptr) {
-		png_destroy_read_struct(&ico_png_ptr, NULL, NULL);
+	Png->info_ptr = png_create_info_struct(Png->png_ptr);
+	if (!Png->info_ptr) {
+		png_destroy_read_struct(&Png->png_ptr, NULL, NULL);
 		return 4;	/* out of memory */
 	}
 
@@ -530,21 +534,21 @@ ILint ico_readpng_init(ILcontext* context)
 	/* setjmp() must be called in every function that calls a PNG-reading
 	 * libpng function */
 
-	if (setjmp(png_jmpbuf(ico_png_ptr))) {
-		png_destroy_read_struct(&ico_png_ptr, &ico_info_ptr, NULL);
+	if (setjmp(png_jmpbuf(Png->png_ptr))) {
+		png_destroy_read_struct(&Png->png_ptr, &Png->info_ptr, NULL);
 		return 2;
 	}
 
 
-	png_set_read_fn(ico_png_ptr, context, ico_png_read);
-	png_set_error_fn(ico_png_ptr, context, ico_png_error_func, ico_png_warn_func);
+	png_set_read_fn(Png->png_ptr, context, ico_png_read);
+	png_set_error_fn(Png->png_ptr, context, ico_png_error_func, ico_png_warn_func);
 
-//	png_set_sig_bytes(ico_png_ptr, 8);	/* we already read the 8 signature bytes */
+//	png_set_sig_bytes(Png->png_ptr, 8);	/* we already read the 8 signature bytes */
 
-	png_read_info(ico_png_ptr, ico_info_ptr);  /* read all PNG info up to image data */
+	png_read_info(Png->png_ptr, Png->info_ptr);  /* read all PNG info up to image data */
 
 	/* alternatively, could make separate calls to png_get_image_width(),
-	 * etc., but want bit_depth and ico_color_type for later [don't care about
+	 * etc., but want bit_depth and color_type for later [don't care about
 	 * compression_type and filter_type => NULLs] */
 
 	/* OK, that's all we need for now; return happy */
@@ -552,7 +556,7 @@ ILint ico_readpng_init(ILcontext* context)
 	return 0;
 }
 
-ILboolean ico_readpng_get_image(ILcontext* context, ICOIMAGE *Icon, ILdouble display_exponent)
+ILboolean ico_readpng_get_image(ILcontext* context, ICOPNG *Png, ICOIMAGE *Icon, ILdouble display_exponent)
 {
 	png_bytepp	row_pointers = NULL;
 	png_uint_32 width, height; // Changed the type to fix AMD64 bit problems, thanks to Eric Werness
@@ -570,40 +574,40 @@ ILboolean ico_readpng_get_image(ILcontext* context, ICOIMAGE *Icon, ILdouble dis
 	/* setjmp() must be called in every function that calls a PNG-reading
 	 * libpng function */
 
-	if (setjmp(png_jmpbuf(ico_png_ptr))) {
-		png_destroy_read_struct(&ico_png_ptr, &ico_info_ptr, NULL);
+	if (setjmp(png_jmpbuf(Png->png_ptr))) {
+		png_destroy_read_struct(&Png->png_ptr, &Png->info_ptr, NULL);
 		return IL_FALSE;
 	}
 
-	png_get_IHDR(ico_png_ptr, ico_info_ptr, (png_uint_32*)&width, (png_uint_32*)&height,
-	             &bit_depth, &ico_color_type, NULL, NULL, NULL);
+	png_get_IHDR(Png->png_ptr, Png->info_ptr, (png_uint_32*)&width, (png_uint_32*)&height,
+	             &bit_depth, &Png->color_type, NULL, NULL, NULL);
 
 	// Expand low-bit-depth grayscale images to 8 bits
-	if (ico_color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) {
-		png_set_expand_gray_1_2_4_to_8(ico_png_ptr);
+	if (Png->color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) {
+		png_set_expand_gray_1_2_4_to_8(Png->png_ptr);
 	}
 
 	// Expand RGB images with transparency to full alpha channels
 	//	so the data will be available as RGBA quartets.
  	// But don't expand paletted images, since we want alpha palettes!
-	if (png_get_valid(ico_png_ptr, ico_info_ptr, PNG_INFO_tRNS) && !(png_get_valid(ico_png_ptr, ico_info_ptr, PNG_INFO_PLTE)))
-		png_set_tRNS_to_alpha(ico_png_ptr);
+	if (png_get_valid(Png->png_ptr, Png->info_ptr, PNG_INFO_tRNS) && !(png_get_valid(Png->png_ptr, Png->info_ptr, PNG_INFO_PLTE)))
+		png_set_tRNS_to_alpha(Png->png_ptr);
 
 	//refresh information (added 20040224)
-	png_get_IHDR(ico_png_ptr, ico_info_ptr, (png_uint_32*)&width, (png_uint_32*)&height,
-	             &bit_depth, &ico_color_type, NULL, NULL, NULL);
+	png_get_IHDR(Png->png_ptr, Png->info_ptr, (png_uint_32*)&width, (png_uint_32*)&height,
+	             &bit_depth, &Png->color_type, NULL, NULL, NULL);
 
 	if (bit_depth < 8) {	// Expanded earlier for grayscale, now take care of palette and rgb
 		bit_depth = 8;
-		png_set_packing(ico_png_ptr);
+		png_set_packing(Png->png_ptr);
 	}
 
 	// Perform gamma correction.
 	// @TODO:  Determine if we should call png_set_gamma if image_gamma is 1.0.
 #if _WIN32 || DJGPP
 	screen_gamma = 2.2;
-	if (png_get_gAMA(ico_png_ptr, ico_info_ptr, &image_gamma))
-		png_set_gamma(ico_png_ptr, screen_gamma, image_gamma);
+	if (png_get_gAMA(Png->png_ptr, Png->info_ptr, &image_gamma))
+		png_set_gamma(Png->png_ptr, screen_gamma, image_gamma);
 #else
 	screen_gamma = screen_gamma;
 #endif
@@ -611,18 +615,18 @@ ILboolean ico_readpng_get_image(ILcontext* context, ICOIMAGE *Icon, ILdouble dis
 	//fix endianess
 #ifdef __LITTLE_ENDIAN__
 	if (bit_depth == 16)
-		png_set_swap(ico_png_ptr);
+		png_set_swap(Png->png_ptr);
 #endif
 
 
-	png_read_update_info(ico_png_ptr, ico_info_ptr);
-	channels = (ILint)png_get_channels(ico_png_ptr, ico_info_ptr);
-	// added 20040224: update ico_color_type so that it has the correct value
+	png_read_update_info(Png->png_ptr, Png->info_ptr);
+	channels = (ILint)png_get_channels(Png->png_ptr, Png->info_ptr);
+	// added 20040224: update color_type so that it has the correct value
 	// in iLoadPngInternal (globals rule...)
-	ico_color_type = png_get_color_type(ico_png_ptr, ico_info_ptr);
+	Png->color_type = png_get_color_type(Png->png_ptr, Png->info_ptr);
 
 	// Determine internal format
-	switch (ico_color_type)
+	switch (Png->color_type)
 	{
 		case PNG_COLOR_TYPE_PALETTE:
 			Icon->Head.BitCount = 8;
@@ -638,19 +642,19 @@ ILboolean ico_readpng_get_image(ILcontext* context, ICOIMAGE *Icon, ILdouble dis
 			break;
 		default:
 			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
-			png_destroy_read_struct(&ico_png_ptr, &ico_info_ptr, NULL);
+			png_destroy_read_struct(&Png->png_ptr, &Png->info_ptr, NULL);
 			return IL_FALSE;
 	}
 
-	if (ico_color_type & PNG_COLOR_MASK_COLOR)
-		png_set_bgr(ico_png_ptr);
+	if (Png->color_type & PNG_COLOR_MASK_COLOR)
+		png_set_bgr(Png->png_ptr);
 
 	Icon->Head.Width = width;
 	Icon->Head.Height = height;
 	Icon->Data = (ILubyte*)ialloc(context, width * height * Icon->Head.BitCount / 8);
 	if (Icon->Data == NULL)
 	{
-		png_destroy_read_struct(&ico_png_ptr, &ico_info_ptr, NULL);
+		png_destroy_read_struct(&Png->png_ptr, &Png->info_ptr, NULL);
 		return IL_FALSE;
 	}
 
@@ -660,16 +664,16 @@ ILboolean ico_readpng_get_image(ILcontext* context, ICOIMAGE *Icon, ILdouble dis
 		int chans;
 		png_bytep trans = NULL;
 		int num_trans = -1;
-		if (!png_get_PLTE(ico_png_ptr, ico_info_ptr, &palette, &num_palette)) {
+		if (!png_get_PLTE(Png->png_ptr, Png->info_ptr, &palette, &num_palette)) {
 			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
-			png_destroy_read_struct(&ico_png_ptr, &ico_info_ptr, NULL);
+			png_destroy_read_struct(&Png->png_ptr, &Png->info_ptr, NULL);
 			return IL_FALSE;
 		}
 
 		chans = 4;
 
-		if (png_get_valid(ico_png_ptr, ico_info_ptr, PNG_INFO_tRNS)) {
-			png_get_tRNS(ico_png_ptr, ico_info_ptr, &trans, &num_trans, NULL);
+		if (png_get_valid(Png->png_ptr, Png->info_ptr, PNG_INFO_tRNS)) {
+			png_get_tRNS(Png->png_ptr, Png->info_ptr, &trans, &num_trans, NULL);
 		}
 
 // @TODO: We may need to keep track of the size of the palette.
@@ -692,7 +696,7 @@ ILboolean ico_readpng_get_image(ILcontext* context, ICOIMAGE *Icon, ILdouble dis
 
 	//allocate row pointers
 	if ((row_pointers = (png_bytepp)ialloc(context, height * sizeof(png_bytep))) == NULL) {
-		png_destroy_read_struct(&ico_png_ptr, &ico_info_ptr, NULL);
+		png_destroy_read_struct(&Png->png_ptr, &Png->info_ptr, NULL);
 		return IL_FALSE;
 	}
 
@@ -705,22 +709,22 @@ ILboolean ico_readpng_get_image(ILcontext* context, ICOIMAGE *Icon, ILdouble dis
 
 
 	// Now we can go ahead and just read the whole image
-	png_read_image(ico_png_ptr, row_pointers);
+	png_read_image(Png->png_ptr, row_pointers);
 
 	/* and we're done!	(png_read_end() can be omitted if no processing of
 	 * post-IDAT text/time/etc. is desired) */
-	//png_read_end(ico_png_ptr, NULL);
-	ifree(row_pointers);
+	//png_read_end(Png->png_ptr, NULL);
+	ifree(context, row_pointers);
 
 	return IL_TRUE;
 }
 
-void ico_readpng_cleanup()
+void ico_readpng_cleanup(ICOPNG *Png)
 {
-	if (ico_png_ptr && ico_info_ptr) {
-		png_destroy_read_struct(&ico_png_ptr, &ico_info_ptr, NULL);
-		ico_png_ptr = NULL;
-		ico_info_ptr = NULL;
+	if (Png->png_ptr && Png->info_ptr) {
+		png_destroy_read_struct(&Png->png_ptr, &Png->info_ptr, NULL);
+		Png->png_ptr = NULL;
+		Png->info_ptr = NULL;
 	}
 }
 #endif//IL_NO_PNG
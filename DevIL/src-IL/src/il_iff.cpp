@@ -17,20 +17,7 @@
 #include "il_iff.h"
 #include "il_ilbm.h"
 
-// Chunk type, data and functions:
-typedef struct _iff_chunk {
-	ILuint	tag;
-	ILuint	start;
-	ILuint	size;
-	ILuint	chunkType;
-} iff_chunk;
-
-#define CHUNK_STACK_SIZE (32)
-static iff_chunk chunkStack[CHUNK_STACK_SIZE];
-static int chunkDepth = -1;
-
-iff_chunk iff_begin_read_chunk(ILcontext* context);
-void iff_end_read_chunk(ILcontext* context);
+// Chunk functions:
 char *iff_read_data(ILcontext* context, int size);
 
 /* Define the IFF tags we are looking for in the file. */
@@ -145,7 +132,7 @@ ILboolean IffHandler::loadInternal()
 	chunkDepth = -1;
 
 	// -- File should begin with a FOR4 chunk of type CIMG
-	chunkInfo = iff_begin_read_chunk(context);
+	chunkInfo = iff_begin_read_chunk();
 	if (chunkInfo.chunkType != IFF_TAG_CIMG) {
 		ilSetError(context, IL_ILLEGAL_FILE_VALUE);
 		return IL_FALSE;
@@ -162,7 +149,7 @@ ILboolean IffHandler::loadInternal()
 	*/
 	while (1) {
 
-		chunkInfo = iff_begin_read_chunk(context);
+		chunkInfo = iff_begin_read_chunk();
 		
 		// -- Right now, the only info we need about the image is in TBHD
 		// -- so search this level until we find it.
@@ -177,7 +164,7 @@ ILboolean IffHandler::loadInternal()
 			tiles = GetBigUShort(context);
 			compress	= GetBigUInt(context);
 			
-			iff_end_read_chunk(context);
+			iff_end_read_chunk();
 		
 			if( compress > 1 ) {
 				ilSetError(context, IL_ILLEGAL_FILE_VALUE);
@@ -185,7 +172,7 @@ ILboolean IffHandler::loadInternal()
 			}
    				break;
 		} else
-			iff_end_read_chunk(context);
+			iff_end_read_chunk();
 	} /* END find TBHD while loop */
 
 	if (!(flags & RGB_FLAG)) {
@@ -210,7 +197,7 @@ ILboolean IffHandler::loadInternal()
 		ILuint tileImage;
 		ILuint tileZ;
 	
-		chunkInfo = iff_begin_read_chunk(context);
+		chunkInfo = iff_begin_read_chunk();
 
 		/*
 		 * OK, we have a FOR4 of type TBMP, (embedded FOR4)
@@ -224,7 +211,7 @@ ILboolean IffHandler::loadInternal()
 		 *		FOR4 <size>	BLUR (twice embedded FOR4)
 		 */
 		if (chunkInfo.chunkType != IFF_TAG_TBMP) {
-			iff_end_read_chunk(context);
+			iff_end_read_chunk();
 			continue;
 		}
 		tileImageDataFound = IL_TRUE;
@@ -242,7 +229,7 @@ ILboolean IffHandler::loadInternal()
 			ILushort	tile_area;
 			ILuint	tileCompressed;
 
-			chunkInfo = iff_begin_read_chunk(context);
+			chunkInfo = iff_begin_read_chunk();
 			if ((chunkInfo.tag != IFF_TAG_RGBA) && (chunkInfo.tag != IFF_TAG_ZBUF)) {
 				ilSetError(context, IL_ILLEGAL_FILE_VALUE);
 				return IL_FALSE;
@@ -266,7 +253,7 @@ ILboolean IffHandler::loadInternal()
 					if (data) {
 						tileData = iff_decompress_tile_rle(context, tile_width, tile_height,
 															bpp, data, remainingDataSize);
-						ifree(data);
+						ifree(context, data);
 					}
 				} else {
 					tileData = iffReadUncompressedTile(context, tile_width, tile_height, bpp);
@@ -282,16 +269,16 @@ ILboolean IffHandler::loadInternal()
 								&tileData[bpp*i*tile_width],
 								tile_width*bpp*sizeof(char));
 					}
-					ifree(tileData);
+					ifree(context, tileData);
 					tileData = NULL;
 	    
-					iff_end_read_chunk(context);
+					iff_end_read_chunk();
 					tileImage++;
 				} else
 					return IL_FALSE;
 			} else if (chunkInfo.tag == IFF_TAG_ZBUF) {
 				tileZ++;
-				iff_end_read_chunk(context);
+				iff_end_read_chunk();
 			}
 
 		}
@@ -305,7 +292,7 @@ ILboolean IffHandler::loadInternal()
  *
  */
 
-iff_chunk iff_begin_read_chunk(ILcontext* context)
+iff_chunk IffHandler::iff_begin_read_chunk()
 {
 	chunkDepth++;
 	if (chunkDepth >= CHUNK_STACK_SIZE){
@@ -331,7 +318,7 @@ iff_chunk iff_begin_read_chunk(ILcontext* context)
 	return chunkStack[chunkDepth];
 }
 
-void iff_end_read_chunk(ILcontext* context)
+void IffHandler::iff_end_read_chunk()
 {
 	ILuint	end;
 	int		part;
@@ -359,7 +346,7 @@ char * iff_read_data(ILcontext* context, int size)
 		return NULL;
 	
 	if (context->impl->iread(context, buffer, size*sizeof(char), 1) != 1) {
-		ifree(buffer);
+		ifree(context, buffer);
 		return NULL;
 	}
 
@@ -380,7 +367,7 @@ char *iffReadUncompressedTile(ILcontext* context, ILushort width, ILushort heigh
 		return NULL;
 
 	if (context->impl->iread(context, data, tam, 1) != 1) {
-		ifree(data);
+		ifree(context, data);
 		return NULL;
 	}
 
@@ -430,8 +417,8 @@ char *iff_decompress_tile_rle(ILcontext* context, ILushort width, ILushort heigh
 				data[depth*(row*width + column) + k] =
 					channels[k][row*width + column];
 	
-	ifree(channels[0]); ifree(channels[1]);
-	ifree(channels[2]); ifree(channels[3]);
+	ifree(context, channels[0]); ifree(context, channels[1]);
+	ifree(context, channels[2]); ifree(context, channels[3]);
 
 	return data;
 }
@@ -11,6 +11,7 @@
 //-----------------------------------------------------------------------------
 
 #include <string>
+#include <ctype.h>
 
 #include "il_internal.h"
 #include "il_register.h"
@@ -243,665 +244,199 @@ ILenum ILAPIENTRY ilDetermineType(ILcontext* context, ILconst_string FileName)
 	return Type;
 }
 
-ILenum ILAPIENTRY ilDetermineTypeF(ILcontext* context, ILHANDLE File)
+// Magic numbers of the formats that have them.  ilDetermineTypeF/L read the
+//  start of the image once, match it against this table and only ask the
+//  handlers of the formats that matched.  Entries are in the order that the
+//  handlers used to be tried in, and a match is only a hint: the handler
+//  still has to accept the header.
+#define IL_SIG_NOCASE	0x01  // Compare the magic number case-insensitively.
+#define IL_SIG_STREAM	0x02  // The handler may read past IL_SIG_HEADER_SIZE bytes.
+
+// Enough for the largest fixed-size header checked by a handler (Scitex).
+#define IL_SIG_HEADER_SIZE	4096
+
+typedef struct iSignature
 {
-	if (File == nullptr)
-	{
-		return IL_TYPE_UNKNOWN;
-	}
+	ILenum		Type;
+	ILuint		Offset;
+	ILuint		Length;
+	ILuint		Flags;
+	const char	*Magic;
+} iSignature;
 
+static const iSignature iSignatures[] =
+{
 #ifndef IL_NO_JPG
-	{
-		JpegHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_JPG;
-		}
-	}
+	{ IL_JPG,    0,   2,  0, "\xFF\xD8" },
 #endif
-
 #ifndef IL_NO_DDS
-	{
-		DdsHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_DDS;
-		}
-	}
+	{ IL_DDS,    0,   4,  0, "DDS " },
 #endif
-
 #ifndef IL_NO_PNG
-	{
-		PngHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_PNG;
-		}
-	}
+	{ IL_PNG,    0,   8,  0, "\x89PNG\r\n\x1A\n" },
 #endif
-
 #ifndef IL_NO_BMP
-	{
-		BmpHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_BMP;
-		}
-	}
+	{ IL_BMP,    0,   2,  0, "BM" },
 #endif
-
 #ifndef IL_NO_BLP
-	{
-		BlpHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_BLP;
-		}
-	}
+	{ IL_BLP,    0,   4,  0, "BLP2" },
+#endif
+#ifndef IL_NO_DICOM
+	{ IL_DICOM,  128, 4,  IL_SIG_STREAM, "DICM" },
 #endif
-
 #ifndef IL_NO_EXR
-	{
-		ExrHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_EXR;
-		}
-	}
+	{ IL_EXR,    0,   4,  0, "\x76\x2F\x31\x01" },
 #endif
-
 #ifndef IL_NO_GIF
-	{
-		GifHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_GIF;
-		}
-	}
+	{ IL_GIF,    0,   4,  IL_SIG_NOCASE, "GIF8" },
 #endif
-
 #ifndef IL_NO_HDR
-	{
-		HdrHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_HDR;
-		}
-	}
+	{ IL_HDR,    0,   2,  0, "#?" },
 #endif
-
 #ifndef IL_NO_ICNS
-	{
-		IcnsHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_ICNS;
-		}
-	}
+	{ IL_ICNS,   0,   4,  0, "icns" },
 #endif
-
 #ifndef IL_NO_ILBM
-	{
-		IcnsHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_ILBM;
-		}
-	}
+	{ IL_ILBM,   0,   4,  0, "FORM" },
 #endif
-
 #ifndef IL_NO_IWI
-	{
-		IwiHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_IWI;
-		}
-	}
+	{ IL_IWI,    0,   3,  0, "IWi" },
 #endif
-
 #ifndef IL_NO_JP2
-	{
-		Jp2Handler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_JP2;
-		}
-	}
+	{ IL_JP2,    4,   4,  0, "jP  " },
 #endif
-
 #ifndef IL_NO_KTX
-	{
-		KtxHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_KTX;
-		}
-	}
+	{ IL_KTX,    0,   12, 0, "\xABKTX 11\xBB\r\n\x1A\n" },
 #endif
-
 #ifndef IL_NO_LIF
-	{
-		LifHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_LIF;
-		}
-	}
+	{ IL_LIF,    0,   8,  IL_SIG_NOCASE, "Willy 7" },
 #endif
-
 #ifndef IL_NO_MDL
-	{
-		MdlHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_MDL;
-		}
-	}
+	{ IL_MDL,    0,   4,  0, "IDST" },
 #endif
-
 #ifndef IL_NO_MP3
-	{
-		Mp3Handler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_MP3;
-		}
-	}
+	{ IL_MP3,    0,   3,  IL_SIG_STREAM, "ID3" },
 #endif
-
 #ifndef IL_NO_PCX
-	{
-		PcxHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_PCX;
-		}
-	}
+	{ IL_PCX,    0,   1,  0, "\x0A" },
 #endif
-
 #ifndef IL_NO_PIC
-	{
-		PicHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_PIC;
-		}
-	}
+	{ IL_PIC,    0,   4,  0, "\x53\x80\xF6\x34" },
 #endif
-
 #ifndef IL_NO_PNM
-	{
-		PnmHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_PNM;
-		}
-	}
+	{ IL_PNM,    0,   1,  0, "P" },
 #endif
-
 #ifndef IL_NO_PSD
-	{
-		PsdHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_PSD;
-		}
-	}
+	{ IL_PSD,    0,   4,  0, "8BPS" },
 #endif
-
 #ifndef IL_NO_PSP
-	{
-		PspHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_PSP;
-		}
-	}
+	{ IL_PSP,    0,   27, IL_SIG_NOCASE, "Paint Shop Pro Image File\n\x1A" },
 #endif
-
-#ifndef IL_NO_SGI
-	{
-		SgiHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_SGI;
-		}
-	}
-#endif
-
 #ifndef IL_NO_SCITEX
-	{
-		ScitexHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_SCITEX;
-		}
-	}
+	{ IL_SCITEX, 80,  2,  0, "CT" },
+#endif
+#ifndef IL_NO_SGI
+	{ IL_SGI,    0,   2,  0, "\x01\xDA" },
 #endif
-
 #ifndef IL_NO_SUN
-	{
-		SunHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_SUN;
-		}
-	}
+	{ IL_SUN,    0,   4,  0, "\x59\xA6\x6A\x95" },
 #endif
-
 #ifndef IL_NO_TIF
-	{
-		TiffHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_TIF;
-		}
-	}
+	{ IL_TIF,    0,   4,  0, "II*\0" },
+	{ IL_TIF,    0,   4,  0, "MM\0*" },
 #endif
-
 #ifndef IL_NO_TPL
-	{
-		TplHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_TPL;
-		}
-	}
+	{ IL_TPL,    0,   4,  0, "\x00\x20\xAF\x30" },
 #endif
-
 #ifndef IL_NO_VTF
-	{
-		VtfHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_VTF;
-		}
-	}
+	{ IL_VTF,    0,   4,  0, "VTF\0" },
 #endif
-
 #ifndef IL_NO_XPM
-	{
-		XpmHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_XPM;
-		}
-	}
-#endif
-
-	//moved tga to end of list because it has no magic number
-	//in header to assure that this is really a tga... (20040218)
-#ifndef IL_NO_TGA
-	{
-		TargaHandler handler(context);
-
-		if (handler.isValidF(File))
-		{
-			return IL_TGA;
-		}
-	}
+	{ IL_XPM,    0,   9,  0, "/* XPM */" },
 #endif
+};
 
-	return IL_TYPE_UNKNOWN;
-}
 
-
-ILenum ILAPIENTRY ilDetermineTypeL(ILcontext* context, const void *Lump, ILuint Size)
+static ILboolean iMatchSignature(const iSignature *Sig, const ILubyte *Header, ILuint Size)
 {
-	if (Lump == nullptr)
-		return IL_TYPE_UNKNOWN;
+	ILuint i;
 
-#ifndef IL_NO_JPG
-	{
-		JpegHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_JPG;
-		}
-	}
-#endif
-
-#ifndef IL_NO_DDS
-	{
-		DdsHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_DDS;
-		}
-	}
-#endif
-
-#ifndef IL_NO_PNG
-	{
-		PngHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_PNG;
-		}
-	}
-#endif
-
-#ifndef IL_NO_BMP
-	{
-		BmpHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_BMP;
-		}
-	}
-#endif
-
-#ifndef IL_NO_BLP
-	{
-		BlpHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_BLP;
-		}
-	}
-#endif
-
-#ifndef IL_NO_EXR
-	{
-		ExrHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_EXR;
-		}
-	}
-#endif
-
-#ifndef IL_NO_GIF
-	{
-		GifHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_GIF;
-		}
-	}
-#endif
-
-#ifndef IL_NO_HDR
-	{
-		HdrHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_HDR;
-		}
-	}
-#endif
-
-#ifndef IL_NO_ICNS
-	{
-		IcnsHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_ICNS;
-		}
-	}
-#endif
-
-#ifndef IL_NO_IWI
-	{
-		IwiHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_IWI;
-		}
-	}
-#endif
-
-#ifndef IL_NO_ILBM
-	{
-		IcnsHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_ILBM;
-		}
-	}
-#endif
-
-#ifndef IL_NO_JP2
-	{
-		Jp2Handler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_JP2;
-		}
-	}
-#endif
-
-#ifndef IL_NO_KTX
-	{
-		KtxHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_KTX;
-		}
-	}
-#endif
-
-#ifndef IL_NO_LIF
-	{
-		LifHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_LIF;
-		}
-	}
-#endif
-
-#ifndef IL_NO_MDL
-	{
-		MdlHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_MDL;
-		}
-	}
-#endif
-
-#ifndef IL_NO_MP3
-	{
-		Mp3Handler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_MP3;
-		}
-	}
-#endif
-
-#ifndef IL_NO_PCX
-	{
-		PcxHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_PCX;
-		}
-	}
-#endif
-
-#ifndef IL_NO_PIC
-	{
-		PicHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_PIC;
-		}
-	}
-#endif
-
-#ifndef IL_NO_PNM
-	{
-		PnmHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_PNM;
-		}
-	}
-#endif
-
-#ifndef IL_NO_PSD
-	{
-		PsdHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_PSD;
-		}
-	}
-#endif
-
-#ifndef IL_NO_PSP
-	{
-		PspHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_PSP;
-		}
-	}
-#endif
-
-#ifndef IL_NO_SCITEX
-	{
-		ScitexHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_SCITEX;
-		}
+	if (Size < Sig->Offset + Sig->Length)
+		return IL_FALSE;
+	if (!(Sig->Flags & IL_SIG_NOCASE))
+		return memcmp(Header + Sig->Offset, Sig->Magic, Sig->Length) == 0;
+	for (i = 0; i < Sig->Length; i++) {
+		if (tolower(Header[Sig->Offset + i]) != tolower((ILubyte)Sig->Magic[i]))
+			return IL_FALSE;
 	}
-#endif
+	return IL_TRUE;
+}
 
-#ifndef IL_NO_SGI
-	{
-		SgiHandler handler(context);
+// Matches Header against iSignatures and confirms any match with the format's
+//  handler.  If File is not NULL, Header was read from it, and handlers that
+//  need more than the header are given the file instead.  A Size of 0 means
+//  that Header is a lump with no known bounds.  Formats without a magic number
+//  (only Targa) are probed last.
+static ILenum iDetermineTypeSig(ILcontext* context, const ILubyte *Header, ILuint Size, ILHANDLE File)
+{
+	ILuint		i, MatchSize = Size ? Size : IL_SIG_HEADER_SIZE;
+	ILboolean	IsValid;
 
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_SGI;
-		}
+	for (i = 0; i < sizeof(iSignatures) / sizeof(iSignatures[0]); i++) {
+		if (!iMatchSignature(&iSignatures[i], Header, MatchSize))
+			continue;
+		if (File != nullptr && (iSignatures[i].Flags & IL_SIG_STREAM))
+			IsValid = ilIsValidF(context, iSignatures[i].Type, File);
+		else
+			IsValid = ilIsValidL(context, iSignatures[i].Type, (void*)Header, Size);
+		if (IsValid)
+			return iSignatures[i].Type;
 	}
-#endif
-
-#ifndef IL_NO_SUN
-	{
-		SunHandler handler(context);
 
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_SUN;
-		}
-	}
+	//moved tga to end of list because it has no magic number
+	//in header to assure that this is really a tga... (20040218)
+#ifndef IL_NO_TGA
+	if (ilIsValidL(context, IL_TGA, (void*)Header, Size))
+		return IL_TGA;
 #endif
 
-#ifndef IL_NO_TIF
-	{
-		TiffHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_TIF;
-		}
-	}
-#endif
+	return IL_TYPE_UNKNOWN;
+}
 
-#ifndef IL_NO_TPL
-	{
-		TplHandler handler(context);
 
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_TPL;
-		}
-	}
-#endif
+ILenum ILAPIENTRY ilDetermineTypeF(ILcontext* context, ILHANDLE File)
+{
+	ILubyte		Header[IL_SIG_HEADER_SIZE];
+	ILuint64	FirstPos;
+	ILuint		Read;
+	ILenum		Type;
 
-#ifndef IL_NO_VTF
+	if (File == nullptr)
 	{
-		VtfHandler handler(context);
-
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_VTF;
-		}
+		return IL_TYPE_UNKNOWN;
 	}
-#endif
 
-#ifndef IL_NO_XPM
-	{
-		XpmHandler handler(context);
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	Read = context->impl->iread(context, Header, 1, IL_SIG_HEADER_SIZE);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+	if (Read == 0 || Read > IL_SIG_HEADER_SIZE)
+		return IL_TYPE_UNKNOWN;
 
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_XPM;
-		}
-	}
-#endif
+	Type = iDetermineTypeSig(context, Header, Read, File);
 
-	//Moved Targa to end of list because it has no magic number
-	// in header to assure that this is really a tga... (20040218).
-#ifndef IL_NO_TGA
-	{
-		TargaHandler handler(context);
+	// The checks leave the input set to the header, so point it back at File.
+	iSetInputFile(context, File);
+	return Type;
+}
 
-		if (handler.isValidL(Lump, Size))
-		{
-			return IL_TGA;
-		}
-	}
-#endif
 
-	return IL_TYPE_UNKNOWN;
+ILenum ILAPIENTRY ilDetermineTypeL(ILcontext* context, const void *Lump, ILuint Size)
+{
+	if (Lump == nullptr)
+		return IL_TYPE_UNKNOWN;
+
+	return iDetermineTypeSig(context, (const ILubyte*)Lump, Size, nullptr);
 }
 
 
@@ -1759,6 +1294,40 @@ ILboolean ILAPIENTRY ilIsValidL(ILcontext* context, ILenum Type, void *Lump, ILu
 }
 
 
+// Loads FileName through a read-only memory view and the lump loaders when
+//  IL_FILE_MAPPING is enabled, which avoids the read cache and the per-call
+//  overhead of the file callbacks.  Returns IL_FALSE if the file could not be
+//  mapped, in which case the caller should use the normal file loaders.
+static ILboolean iLoadMapped(ILcontext* context, ILenum Type, ILconst_string FileName, ILboolean *Ret)
+{
+	const void	*View;
+	ILuint		Size;
+
+	if (!ilIsEnabled(context, IL_FILE_MAPPING))
+		return IL_FALSE;
+	// No lump loader for these
+	if (Type == IL_WDP)
+		return IL_FALSE;
+
+	View = iMapFile(context, FileName, &Size);
+	if (View == nullptr)
+		return IL_FALSE;
+
+	if (Type == IL_TYPE_UNKNOWN)
+		Type = ilDetermineTypeL(context, View, Size);
+	if (Type == IL_TYPE_UNKNOWN) {
+		ilSetError(context, IL_INVALID_EXTENSION);
+		*Ret = IL_FALSE;
+	}
+	else {
+		*Ret = ilLoadL(context, Type, View, Size);
+	}
+
+	iUnmapFile(View, Size);
+	return IL_TRUE;
+}
+
+
 //! Attempts to load an image from a file.  The file format is specified by the user.
 /*! \param Type Format of this file.  Acceptable values are IL_BLP, IL_BMP, IL_CUT, IL_DCX, IL_DDS,
 IL_DICOM, IL_DOOM, IL_DOOM_FLAT, IL_DPX, IL_EXR, IL_FITS, IL_FTX, IL_GIF, IL_HDR, IL_ICO, IL_ICNS,
@@ -1769,7 +1338,9 @@ If IL_TYPE_UNKNOWN is specified, ilLoad will try to determine the type of the fi
 \param FileName Ansi or Unicode string, depending on the compiled version of DevIL, that gives
 the filename of the file to load.
 \return Boolean value of failure or success.  Returns IL_FALSE if all three loading methods
-have been tried and failed.*/
+have been tried and failed.
+If IL_FILE_MAPPING is enabled, the file is mapped into memory and decoded with the
+lump loaders instead of being read through the file callbacks.*/
 ILboolean ILAPIENTRY ilLoad(ILcontext* context, ILenum Type, ILconst_string FileName)
 {
 	ILboolean	bRet;
@@ -1779,6 +1350,9 @@ ILboolean ILAPIENTRY ilLoad(ILcontext* context, ILenum Type, ILconst_string File
 		return IL_FALSE;
 	}
 
+	if (Type != IL_TYPE_UNKNOWN && iLoadMapped(context, Type, FileName, &bRet))
+		return bRet;
+
 	switch (Type)
 	{
 	case IL_TYPE_UNKNOWN:
@@ -3158,6 +2732,219 @@ ILboolean ILAPIENTRY ilLoadL(ILcontext* context, ILenum Type, const void *Lump,
 }
 
 
+// Fills Info by decoding File or Lump into a scratch image, for formats that have no
+//  header probe.  The bound image is restored afterwards (as its base image).
+static ILboolean iGetImageInfoDecoded(ILcontext* context, ILenum Type, ILHANDLE File, const void *Lump, ILuint Size, ILimageinfo *Info)
+{
+	ILuint		PrevName, Scratch;
+	ILimage		*Image;
+	ILboolean	bRet;
+
+	PrevName = ilGetCurName(context);
+	Scratch = ilGenImage(context);
+	ilBindImage(context, Scratch);
+
+	bRet = File != nullptr ? ilLoadF(context, Type, File) : ilLoadL(context, Type, Lump, Size);
+	if (bRet) {
+		Image = context->impl->iCurImage;
+		Info->Width = Image->Width;
+		Info->Height = Image->Height;
+		Info->Depth = Image->Depth;
+		Info->Format = Image->Format;
+		Info->Type = Image->Type;
+		Info->NumMips = ilGetInteger(context, IL_NUM_MIPMAPS);
+		Info->NumFaces = ilGetInteger(context, IL_NUM_FACES);
+		Info->NumImages = ilGetInteger(context, IL_NUM_IMAGES);
+		Info->HasProfile = Image->Profile != nullptr && Image->ProfileSize > 0;
+	}
+
+	ilBindImage(context, PrevName);
+	ilDeleteImages(context, 1, &Scratch);
+	return bRet;
+}
+
+
+//! Reads the dimensions, format and layout of an image without decoding its pixels.
+/*! Only the header is read for IL_DDS, IL_JPG, IL_PNG, IL_PSD and IL_TIF.  Other types are
+decoded into a scratch image, so they give the same answers at the cost of a full load.
+The bound image is not changed.
+\param Type Format of the file, or IL_TYPE_UNKNOWN to determine it from the header.
+\param FileName Ansi or Unicode string, depending on the compiled version of DevIL, that gives
+the filename of the file to probe.
+\param Info Receives the image properties.
+\return Boolean value of failure or success.*/
+ILboolean ILAPIENTRY ilGetImageInfo(ILcontext* context, ILenum Type, ILconst_string FileName, ILimageinfo *Info)
+{
+	ILHANDLE	File;
+	ILboolean	bRet;
+
+	if (FileName == nullptr || ilStrLen(FileName) < 1 || Info == nullptr) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+
+	File = context->impl->iopenr(FileName);
+	if (File == nullptr) {
+		ilSetError(context, IL_COULD_NOT_OPEN_FILE);
+		return IL_FALSE;
+	}
+
+	if (Type == IL_TYPE_UNKNOWN)
+		Type = ilDetermineTypeF(context, File);
+	if (Type == IL_TYPE_UNKNOWN)
+		Type = ilTypeFromExt(context, FileName);
+
+	bRet = ilGetImageInfoF(context, Type, File, Info);
+	context->impl->icloser(File);
+
+	return bRet;
+}
+
+
+//! Reads the properties of an image from an already-opened file without decoding its pixels.
+/*! See ilGetImageInfo.  The file position is left where it was.*/
+ILboolean ILAPIENTRY ilGetImageInfoF(ILcontext* context, ILenum Type, ILHANDLE File, ILimageinfo *Info)
+{
+	if (File == nullptr || Info == nullptr) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+
+	if (Type == IL_TYPE_UNKNOWN)
+		Type = ilDetermineTypeF(context, File);
+	if (Type == IL_TYPE_UNKNOWN) {
+		ilSetError(context, IL_INVALID_EXTENSION);
+		return IL_FALSE;
+	}
+
+	imemclear(Info, sizeof(ILimageinfo));
+
+	switch (Type)
+	{
+#ifndef IL_NO_DDS
+	case IL_DDS:
+	{
+		DdsHandler handler(context);
+
+		return handler.getInfoF(File, Info);
+	}
+#endif
+
+#ifndef IL_NO_JPG
+#ifndef IL_USE_IJL
+	case IL_JPG:
+	{
+		JpegHandler handler(context);
+
+		return handler.getInfoF(File, Info);
+	}
+#endif
+#endif
+
+#ifndef IL_NO_PNG
+	case IL_PNG:
+	{
+		PngHandler handler(context);
+
+		return handler.getInfoF(File, Info);
+	}
+#endif
+
+#ifndef IL_NO_PSD
+	case IL_PSD:
+	{
+		PsdHandler handler(context);
+
+		return handler.getInfoF(File, Info);
+	}
+#endif
+
+#ifndef IL_NO_TIF
+	case IL_TIF:
+	{
+		TiffHandler handler(context);
+
+		return handler.getInfoF(File, Info);
+	}
+#endif
+	}
+
+	return iGetImageInfoDecoded(context, Type, File, nullptr, 0, Info);
+}
+
+
+//! Reads the properties of an image in a memory "lump" without decoding its pixels.
+/*! See ilGetImageInfo.*/
+ILboolean ILAPIENTRY ilGetImageInfoL(ILcontext* context, ILenum Type, const void *Lump, ILuint Size, ILimageinfo *Info)
+{
+	if (Lump == nullptr || Size == 0 || Info == nullptr) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+
+	if (Type == IL_TYPE_UNKNOWN)
+		Type = ilDetermineTypeL(context, Lump, Size);
+	if (Type == IL_TYPE_UNKNOWN) {
+		ilSetError(context, IL_INVALID_EXTENSION);
+		return IL_FALSE;
+	}
+
+	imemclear(Info, sizeof(ILimageinfo));
+
+	switch (Type)
+	{
+#ifndef IL_NO_DDS
+	case IL_DDS:
+	{
+		DdsHandler handler(context);
+
+		return handler.getInfoL(Lump, Size, Info);
+	}
+#endif
+
+#ifndef IL_NO_JPG
+#ifndef IL_USE_IJL
+	case IL_JPG:
+	{
+		JpegHandler handler(context);
+
+		return handler.getInfoL(Lump, Size, Info);
+	}
+#endif
+#endif
+
+#ifndef IL_NO_PNG
+	case IL_PNG:
+	{
+		PngHandler handler(context);
+
+		return handler.getInfoL(Lump, Size, Info);
+	}
+#endif
+
+#ifndef IL_NO_PSD
+	case IL_PSD:
+	{
+		PsdHandler handler(context);
+
+		return handler.getInfoL(Lump, Size, Info);
+	}
+#endif
+
+#ifndef IL_NO_TIF
+	case IL_TIF:
+	{
+		TiffHandler handler(context);
+
+		return handler.getInfoL(Lump, Size, Info);
+	}
+#endif
+	}
+
+	return iGetImageInfoDecoded(context, Type, nullptr, Lump, Size, Info);
+}
+
+
 //! Attempts to load an image from a file with various different methods before failing - very generic.
 /*! The ilLoadImage function allows a general interface to the specific internal file-loading
 routines.  First, it finds the extension and checks to see if any user-registered functions
@@ -3192,6 +2979,9 @@ ILboolean ILAPIENTRY ilLoadImage(ILcontext* context, ILconst_string FileName)
 		if (iRegisterLoad(context, FileName))
 			return IL_TRUE;
 
+		if (iLoadMapped(context, ilTypeFromExt(context, FileName), FileName, &bRet))
+			return bRet;
+
 #ifndef IL_NO_TGA
 		if (!iStrCmp(Ext, IL_TEXT("tga")) || !iStrCmp(Ext, IL_TEXT("vda")) ||
 			!iStrCmp(Ext, IL_TEXT("icb")) || !iStrCmp(Ext, IL_TEXT("vst")))
@@ -3439,7 +3229,7 @@ ILboolean ILAPIENTRY ilLoadImage(ILcontext* context, ILconst_string FileName)
 #ifndef IL_NO_KTX
 		if (!iStrCmp(Ext, IL_TEXT("ktx")))
 		{
-			IwiHandler handler(context);
+			KtxHandler handler(context);
 
 			bRet = handler.load(FileName);
 
@@ -3800,10 +3590,14 @@ ILboolean ILAPIENTRY ilSave(ILcontext* context, ILenum Type, ILconst_string File
 	}
 #endif
 
-	/*#ifndef IL_NO_KTX
+#ifndef IL_NO_KTX
 	case IL_KTX:
-	return ilSaveKtx(context, FileName);
-	#endif*/
+	{
+		KtxHandler handler(context);
+
+		return handler.save(FileName);
+	}
+#endif
 
 #ifndef IL_NO_PCX
 	case IL_PCX:
@@ -3986,6 +3780,16 @@ ILuint ILAPIENTRY ilSaveF(ILcontext* context, ILenum Type, ILHANDLE File)
 #endif
 #endif
 
+#ifndef IL_NO_KTX
+	case IL_KTX:
+	{
+		KtxHandler handler(context);
+
+		Ret = handler.saveF(File);
+	}
+	break;
+#endif
+
 #ifndef IL_NO_PNM
 	case IL_PNM:
 	{
@@ -4155,6 +3959,24 @@ ILuint ILAPIENTRY ilSaveL(ILcontext* context, ILenum Type, void *Lump, ILuint Si
 	}
 #endif
 
+#ifndef IL_NO_KTX
+	case IL_KTX:
+	{
+		KtxHandler handler(context);
+
+		return handler.saveL(Lump, Size);
+	}
+#endif
+
+#ifndef IL_NO_PCX
+	case IL_PCX:
+	{
+		PcxHandler handler(context);
+
+		return handler.saveL(Lump, Size);
+	}
+#endif
+
 #ifndef IL_NO_PNG
 	case IL_PNG:
 	{
@@ -4353,6 +4175,17 @@ ILboolean ILAPIENTRY ilSaveImage(ILcontext* context, ILconst_string FileName)
 	}
 #endif
 
+#ifndef IL_NO_KTX
+	if (!iStrCmp(Ext, IL_TEXT("ktx")))
+	{
+		KtxHandler handler(context);
+
+		bRet = handler.save(FileName);
+
+		goto finish;
+	}
+#endif
+
 #ifndef IL_NO_PCX
 	if (!iStrCmp(Ext, IL_TEXT("pcx")))
 	{
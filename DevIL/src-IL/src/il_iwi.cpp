@@ -309,7 +309,7 @@ ILboolean IwiReadImage(ILcontext* context, ILimage *BaseImage, IWIHEAD *Header,
 				if (CompData == NULL)
 					return IL_FALSE;
 				if (context->impl->iread(context, CompData, 1, SizeOfData) != SizeOfData) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 				for (k = 0, m = 0; k < (ILint)Image->SizeOfData; k += 4, m += 2) {
@@ -328,13 +328,13 @@ ILboolean IwiReadImage(ILcontext* context, ILimage *BaseImage, IWIHEAD *Header,
 				if (CompData == NULL)
 					return IL_FALSE;
 				if (context->impl->iread(context, CompData, 1, SizeOfData) != SizeOfData) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 
 				// Decompress the DXT1 data into Image (ith mipmap).
 				if (!DecompressDXT1(Image, CompData)) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 
@@ -355,13 +355,13 @@ ILboolean IwiReadImage(ILcontext* context, ILimage *BaseImage, IWIHEAD *Header,
 				if (CompData == NULL)
 					return IL_FALSE;
 				if (context->impl->iread(context, CompData, 1, SizeOfData) != SizeOfData) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 
 				// Decompress the DXT3 data into Image (ith mipmap).
 				if (!DecompressDXT3(Image, CompData)) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 				break;
@@ -373,19 +373,19 @@ ILboolean IwiReadImage(ILcontext* context, ILimage *BaseImage, IWIHEAD *Header,
 				if (CompData == NULL)
 					return IL_FALSE;
 				if (context->impl->iread(context, CompData, 1, SizeOfData) != SizeOfData) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 
 				// Decompress the DXT5 data into Image (ith mipmap).
 				if (!DecompressDXT5(Image, CompData)) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 				break;
 		}
 	
-		ifree(CompData);
+		ifree(context, CompData);
 	}
 
 	return IL_TRUE;
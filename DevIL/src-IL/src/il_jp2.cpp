@@ -28,7 +28,13 @@
 	#endif
 #endif
 
-ILboolean JasperInit = IL_FALSE;
+// Initialises Jasper once per process; the function-local static makes this
+//  safe when several contexts load their first JPEG 2000 image at once.
+static ILboolean iJasperInit()
+{
+	static const ILboolean JasperInit = jas_init() == 0 ? IL_TRUE : IL_FALSE;
+	return JasperInit;
+}
 
 ILboolean		loadInternal(ILcontext* context, jas_stream_t *Stream, ILimage *Image);
 jas_stream_t	*iJp2ReadStream(ILcontext* context);
@@ -134,12 +140,9 @@ ILboolean Jp2Handler::loadF(ILHANDLE File)
 	iSetInputFile(context, File);
 	FirstPos = context->impl->itell(context);
 
-	if (!JasperInit) {
-		if (jas_init()) {
-			ilSetError(context, IL_LIB_JP2_ERROR);
-			return IL_FALSE;
-		}
-		JasperInit = IL_TRUE;
+	if (!iJasperInit()) {
+		ilSetError(context, IL_LIB_JP2_ERROR);
+		return IL_FALSE;
 	}
 	Stream = iJp2ReadStream(context);
 	if (!Stream)
@@ -169,12 +172,9 @@ ILboolean Jp2Handler::LoadLToImage(ILcontext* context, const void *Lump, ILuint
 	ILboolean		bRet;
 	jas_stream_t	*Stream;
 
-	if (!JasperInit) {
-		if (jas_init()) {
-			ilSetError(context, IL_LIB_JP2_ERROR);
-			return IL_FALSE;
-		}
-		JasperInit = IL_TRUE;
+	if (!iJasperInit()) {
+		ilSetError(context, IL_LIB_JP2_ERROR);
+		return IL_FALSE;
 	}
 	Stream = jas_stream_memopen((char*)Lump, Size);
 	if (!Stream)
@@ -233,7 +233,7 @@ ILboolean loadInternal(ILcontext* context, jas_stream_t	*Stream, ILimage *Image)
 				TempImage = context->impl->iCurImage;
 			}
 			else {
-				ifree(Image->Data);  // @TODO: Not really the most efficient way to do this...
+				ifree(context, Image->Data);  // @TODO: Not really the most efficient way to do this...
 				ilInitImage(context, Image, jas_image_width(Jp2Image), jas_image_height(Jp2Image), 1, 1, IL_LUMINANCE, IL_UNSIGNED_BYTE, NULL);
 				TempImage = Image;
 			}
@@ -245,7 +245,7 @@ ILboolean loadInternal(ILcontext* context, jas_stream_t	*Stream, ILimage *Image)
 				TempImage = context->impl->iCurImage;
 			}
 			else {
-				ifree(Image->Data);  // @TODO: Not really the most efficient way to do this...
+				ifree(context, Image->Data);  // @TODO: Not really the most efficient way to do this...
 				ilInitImage(context, Image, jas_image_width(Jp2Image), jas_image_height(Jp2Image), 1, 2, IL_LUMINANCE_ALPHA, IL_UNSIGNED_BYTE, NULL);
 				TempImage = Image;
 			}
@@ -257,7 +257,7 @@ ILboolean loadInternal(ILcontext* context, jas_stream_t	*Stream, ILimage *Image)
 				TempImage = context->impl->iCurImage;
 			}
 			else {
-				ifree(Image->Data);  // @TODO: Not really the most efficient way to do this...
+				ifree(context, Image->Data);  // @TODO: Not really the most efficient way to do this...
 				ilInitImage(context, Image, jas_image_width(Jp2Image), jas_image_height(Jp2Image), 1, 3, IL_RGB, IL_UNSIGNED_BYTE, NULL);
 				TempImage = Image;
 			}
@@ -268,7 +268,7 @@ ILboolean loadInternal(ILcontext* context, jas_stream_t	*Stream, ILimage *Image)
 				TempImage = context->impl->iCurImage;
 			}
 			else {
-				ifree(Image->Data);  // @TODO: Not really the most efficient way to do this...
+				ifree(context, Image->Data);  // @TODO: Not really the most efficient way to do this...
 				ilInitImage(context, Image, jas_image_width(Jp2Image), jas_image_height(Jp2Image), 1, 4, IL_RGBA, IL_UNSIGNED_BYTE, NULL);
 				TempImage = Image;
 			}
@@ -630,12 +630,9 @@ ILboolean Jp2Handler::saveInternal()
 	ILenum	NewFormat, NewType = IL_UNSIGNED_BYTE;
 	ILimage	*TempImage = context->impl->iCurImage;
 
-	if (!JasperInit) {
-		if (jas_init()) {
-			ilSetError(context, IL_LIB_JP2_ERROR);
-			return IL_FALSE;
-		}
-		JasperInit = IL_TRUE;
+	if (!iJasperInit()) {
+		ilSetError(context, IL_LIB_JP2_ERROR);
+		return IL_FALSE;
 	}
 
 	if (context->impl->iCurImage->Type != IL_UNSIGNED_BYTE) {  //@TODO: Support greater than 1 bpc.
@@ -764,7 +761,7 @@ ILboolean Jp2Handler::saveInternal()
 
 	// Destroy our temporary image if we used one.
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return IL_TRUE;
 }
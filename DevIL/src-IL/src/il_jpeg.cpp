@@ -299,6 +299,50 @@ void JpegHandler::iJpegErrorExit(j_common_ptr cinfo)
 	longjmp(err->handler->context->impl->jumpBuffer, 1);
 }
 
+// Has libjpeg shrink the image as IL_JPG_DECODE_SCALE and IL_JPG_DECODE_SIZE
+//  ask while it decodes.  Only the low frequency coefficients are transformed
+//  then, so this is much faster than loading the whole image and scaling it.
+void JpegHandler::setDecodeScale(j_decompress_ptr cinfo)
+{
+	ILuint Denom = iGetInt(context, IL_JPG_DECODE_SCALE);
+	ILuint Size = iGetInt(context, IL_JPG_DECODE_SIZE);
+	ILuint Longer = IL_MAX(cinfo->image_width, cinfo->image_height);
+
+	// Halve the image again while its longer side stays at least Size.
+	if (Size > 0) {
+		while (Denom < 8 && (Longer + Denom * 2 - 1) / (Denom * 2) >= Size)
+			Denom *= 2;
+	}
+
+	cinfo->scale_num = 1;
+	cinfo->scale_denom = Denom;
+}
+
+// If the format images are loaded in is fixed with ilFormatFunc, has a colour
+//  jpeg come out of libjpeg in that layout already, so that ilFixImage does
+//  not need another pass over the pixels.  Only the channel orders that
+//  libjpeg-turbo adds are used, which give the same bytes as ilConvertImage.
+void JpegHandler::setOutputSpace(j_decompress_ptr cinfo)
+{
+#ifdef JCS_EXTENSIONS
+	if (!ilIsEnabled(context, IL_FORMAT_SET) || cinfo->out_color_space != JCS_RGB)
+		return;
+
+	switch (ilGetInteger(context, IL_FORMAT_MODE))
+	{
+		case IL_RGBA:
+			cinfo->out_color_space = JCS_EXT_RGBA;
+			break;
+		case IL_BGRA:
+			cinfo->out_color_space = JCS_EXT_BGRA;
+			break;
+		case IL_BGR:
+			cinfo->out_color_space = JCS_EXT_BGR;
+			break;
+	}
+#endif
+}
+
 // Internal function used to load the jpeg.
 ILboolean JpegHandler::loadInternal()
 {
@@ -324,6 +368,8 @@ ILboolean JpegHandler::loadInternal()
 
 		devil_jpeg_read_init(&JpegInfo);
 		jpeg_read_header(&JpegInfo, (boolean)IL_TRUE);
+		setDecodeScale(&JpegInfo);
+		setOutputSpace(&JpegInfo);
 
 		result = loadFromJpegStruct(&JpegInfo);
 
@@ -339,6 +385,183 @@ ILboolean JpegHandler::loadInternal()
 	return result;
 }
 
+//! Reads an already-opened jpeg and gives its rows to Sink (ilLoadRows)
+ILboolean JpegHandler::loadRowsF(ILHANDLE File, iRowSink *Sink)
+{
+	ILuint64	FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = loadRowsInternal(Sink);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+//! Reads a jpeg in a memory "lump" and gives its rows to Sink (ilLoadRows)
+ILboolean JpegHandler::loadRowsL(const void *Lump, ILuint Size, iRowSink *Sink)
+{
+	iSetInputLump(context, Lump, Size);
+	return loadRowsInternal(Sink);
+}
+
+// Decodes as loadInternal does, but has libjpeg write each scanline into the
+//  band that goes to the sink.  libjpeg only keeps an MCU row of its own.
+ILboolean JpegHandler::loadRowsInternal(iRowSink *Sink)
+{
+	error_mgr						Error;
+	struct jpeg_decompress_struct	JpegInfo;
+	ILubyte							*Row;
+	ILenum							Format;
+
+	if (!isValidInternal()) {
+		ilSetError(context, IL_INVALID_FILE_HEADER);
+		return IL_FALSE;
+	}
+
+	JpegInfo.err = jpeg_std_error(&Error.pub);
+	Error.pub.error_exit = iJpegErrorExit;
+	Error.pub.output_message = OutputMsg;
+	Error.handler = this;
+	jpgErrorOccured = IL_FALSE;
+
+	// iJpegErrorExit has already destroyed JpegInfo when it jumps back here.
+	if (setjmp(context->impl->jumpBuffer))
+		return IL_FALSE;
+
+	jpeg_create_decompress(&JpegInfo);
+	JpegInfo.do_block_smoothing = (boolean)IL_TRUE;
+	JpegInfo.do_fancy_upsampling = (boolean)IL_TRUE;
+	devil_jpeg_read_init(&JpegInfo);
+	jpeg_read_header(&JpegInfo, (boolean)IL_TRUE);
+	setDecodeScale(&JpegInfo);
+	setOutputSpace(&JpegInfo);
+	jpeg_start_decompress(&JpegInfo);
+
+	switch (JpegInfo.output_components)
+	{
+		case 1:
+			Format = IL_LUMINANCE;
+			break;
+		case 3:
+			Format = IL_RGB;
+			break;
+		case 4:
+			Format = IL_RGBA;
+			break;
+		default:
+			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
+			jpeg_destroy_decompress(&JpegInfo);
+			return IL_FALSE;
+	}
+#ifdef JCS_EXTENSIONS
+	if (JpegInfo.out_color_space == JCS_EXT_BGR)
+		Format = IL_BGR;
+	else if (JpegInfo.out_color_space == JCS_EXT_BGRA)
+		Format = IL_BGRA;
+#endif
+
+	if (!iSinkBegin(context, Sink, JpegInfo.output_width, JpegInfo.output_height, Format, IL_UNSIGNED_BYTE)) {
+		jpeg_destroy_decompress(&JpegInfo);
+		return IL_FALSE;
+	}
+
+	while (JpegInfo.output_scanline < JpegInfo.output_height) {
+		Row = iSinkRows(context, Sink, 1);
+		if (Row == NULL) {
+			jpeg_destroy_decompress(&JpegInfo);
+			return IL_FALSE;
+		}
+		// Nothing comes back once the data has run out.
+		if (jpeg_read_scanlines(&JpegInfo, &Row, 1) != 1) {
+			ilSetError(context, IL_LIB_JPEG_ERROR);
+			jpeg_destroy_decompress(&JpegInfo);
+			return IL_FALSE;
+		}
+	}
+
+	jpeg_finish_decompress(&JpegInfo);
+	jpeg_destroy_decompress(&JpegInfo);
+	return jpgErrorOccured ? IL_FALSE : IL_TRUE;
+}
+
+// Reads the image properties from an already-opened jpeg without decoding the pixels
+ILboolean JpegHandler::getInfoF(ILHANDLE File, ILimageinfo *Info)
+{
+	ILuint64	FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = getInfoInternal(Info);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+// Reads the image properties from a memory "lump" without decoding the pixels
+ILboolean JpegHandler::getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info)
+{
+	iSetInputLump(context, Lump, Size);
+	return getInfoInternal(Info);
+}
+
+// Reads the markers up to the first SOS.  APP2 markers are kept so an ICC profile can be found.
+ILboolean JpegHandler::getInfoInternal(ILimageinfo *Info)
+{
+	error_mgr						Error;
+	struct jpeg_decompress_struct	JpegInfo;
+	jpeg_saved_marker_ptr			Marker;
+
+	if (!isValidInternal()) {
+		ilSetError(context, IL_INVALID_FILE_HEADER);
+		return IL_FALSE;
+	}
+
+	JpegInfo.err = jpeg_std_error(&Error.pub);
+	Error.pub.error_exit = iJpegErrorExit;
+	Error.pub.output_message = OutputMsg;
+	Error.handler = this;
+
+	// iJpegErrorExit has already destroyed JpegInfo when it jumps back here.
+	if (setjmp(context->impl->jumpBuffer))
+		return IL_FALSE;
+
+	jpeg_create_decompress(&JpegInfo);
+	devil_jpeg_read_init(&JpegInfo);
+	jpeg_save_markers(&JpegInfo, JPEG_APP0 + 2, 0xFFFF);
+	jpeg_read_header(&JpegInfo, (boolean)IL_TRUE);
+	setDecodeScale(&JpegInfo);  // Report the size the image would load at
+	jpeg_calc_output_dimensions(&JpegInfo);
+
+	Info->Width = JpegInfo.output_width;
+	Info->Height = JpegInfo.output_height;
+	Info->Depth = 1;
+	Info->Type = IL_UNSIGNED_BYTE;
+	switch (JpegInfo.output_components)
+	{
+		case 1:
+			Info->Format = IL_LUMINANCE;
+			break;
+		case 4:
+			Info->Format = IL_RGBA;
+			break;
+		default:
+			Info->Format = IL_RGB;
+			break;
+	}
+
+	for (Marker = JpegInfo.marker_list; Marker != NULL; Marker = Marker->next) {
+		if (Marker->marker == JPEG_APP0 + 2 && Marker->data_length >= 14
+			&& !memcmp(Marker->data, "ICC_PROFILE", 12))
+			Info->HasProfile = IL_TRUE;
+	}
+
+	jpeg_destroy_decompress(&JpegInfo);
+	return IL_TRUE;
+}
+
 typedef struct
 {
 	struct jpeg_destination_mgr		pub;
@@ -448,6 +671,17 @@ ILuint JpegHandler::saveL(void *Lump, ILuint Size)
 	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
 }
 
+//! Writes an image given as rows (ilSaveRows) to an already-opened file
+ILuint JpegHandler::saveRowsF(ILHANDLE File, iRowSource *Src)
+{
+	ILuint Pos;
+	iSetOutputFile(context, File);
+	Pos = context->impl->itellw(context);
+	if (saveRowsInternal(Src) == IL_FALSE)
+		return 0;  // Error occurred
+	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+}
+
 // Internal function used to save the Jpeg.
 ILboolean JpegHandler::saveInternal()
 {
@@ -482,7 +716,7 @@ ILboolean JpegHandler::saveInternal()
 		TempData = iGetFlipped(context, TempImage);
 		if (TempData == NULL) {
 			if (TempImage != context->impl->iCurImage)
-				ilCloseImage(TempImage);
+				ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	}
@@ -551,13 +785,62 @@ ILboolean JpegHandler::saveInternal()
 	jpeg_destroy_compress(&JpegInfo);
 
 	if (TempImage->Origin == IL_ORIGIN_LOWER_LEFT)
-		ifree(TempData);
+		ifree(context, TempData);
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return IL_TRUE;
 }
 
+// Compresses the rows as they arrive.  Progressive files still make libjpeg
+//	buffer the whole image's coefficients until the end.
+ILboolean JpegHandler::saveRowsInternal(iRowSource *Src)
+{
+	struct		jpeg_compress_struct JpegInfo;
+	struct		jpeg_error_mgr Error;
+	JSAMPROW	row_pointer[1];
+	ILenum		Format;
+
+	if (Src->Width > JPEG_MAX_DIMENSION || Src->Height > JPEG_MAX_DIMENSION) {
+		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+		return IL_FALSE;
+	}
+
+	Format = Src->Format == IL_LUMINANCE ? IL_LUMINANCE : IL_RGB;
+	if (!iRowsBegin(context, Src, Format, IL_UNSIGNED_BYTE))
+		return IL_FALSE;
+
+	JpegInfo.err = jpeg_std_error(&Error);
+	jpeg_create_compress(&JpegInfo);
+	devil_jpeg_write_init(context, &JpegInfo);
+
+	JpegInfo.image_width = Src->Width;
+	JpegInfo.image_height = Src->Height;
+	JpegInfo.input_components = ilGetBppFormat(Format);
+	JpegInfo.in_color_space = Format == IL_LUMINANCE ? JCS_GRAYSCALE : JCS_RGB;
+
+	jpeg_set_defaults(&JpegInfo);
+	JpegInfo.write_JFIF_header = (boolean)TRUE;
+	jpeg_set_quality(&JpegInfo, iGetInt(context, IL_JPG_QUALITY), (boolean)IL_TRUE);
+	if (ilGetBoolean(context, IL_JPG_PROGRESSIVE))
+		jpeg_simple_progression(&JpegInfo);
+
+	jpeg_start_compress(&JpegInfo, (boolean)IL_TRUE);
+	while (JpegInfo.next_scanline < JpegInfo.image_height) {
+		row_pointer[0] = iRowsNext(context, Src);
+		if (row_pointer[0] == NULL) {
+			jpeg_destroy_compress(&JpegInfo);
+			return IL_FALSE;
+		}
+		(void)jpeg_write_scanlines(&JpegInfo, row_pointer, 1);
+	}
+	jpeg_finish_compress(&JpegInfo);
+	jpeg_destroy_compress(&JpegInfo);
+
+	return IL_TRUE;
+}
+
+
 #else // Use the IJL instead of libjpeg.
 
 //! Reads a jpeg file
@@ -740,7 +1023,7 @@ ILboolean JpegHandler::saveInternal(ILstring FileName, void *Lump, ILuint Size)
 		TempData = iGetFlipped(context, TempImage);
 		if (TempData == NULL) {
 			if (TempImage != context->impl->iCurImage)
-				ilCloseImage(TempImage);
+				ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	}
@@ -783,7 +1066,7 @@ ILboolean JpegHandler::saveInternal(ILstring FileName, void *Lump, ILuint Size)
 		Image.JPGFile = FileName;
 		if (ijlWrite(&Image, IJL_JFILE_WRITEWHOLEIMAGE) != IJL_OK) {
 			if (TempImage != context->impl->iCurImage)
-				ilCloseImage(TempImage);
+				ilCloseImage(context, TempImage);
 			ilSetError(context, IL_LIB_JPEG_ERROR);
 			return IL_FALSE;
 		}
@@ -793,7 +1076,7 @@ ILboolean JpegHandler::saveInternal(ILstring FileName, void *Lump, ILuint Size)
 		Image.JPGSizeBytes = Size;
 		if (ijlWrite(&Image, IJL_JBUFF_WRITEWHOLEIMAGE) != IJL_OK) {
 			if (TempImage != context->impl->iCurImage)
-				ilCloseImage(TempImage);
+				ilCloseImage(context, TempImage);
 			ilSetError(context, IL_LIB_JPEG_ERROR);
 			return IL_FALSE;
 		}
@@ -802,9 +1085,9 @@ ILboolean JpegHandler::saveInternal(ILstring FileName, void *Lump, ILuint Size)
 	ijlFree(&Image);
 
 	if (TempImage->Origin == IL_ORIGIN_LOWER_LEFT)
-		ifree(TempData);
+		ifree(context, TempData);
 	if (Temp != context->impl->iCurImage)
-		ilCloseImage(Temp);
+		ilCloseImage(context, Temp);
 
 	return IL_TRUE;
 }
@@ -823,8 +1106,8 @@ ILboolean JpegHandler::loadFromJpegStruct(void *_JpegInfo)
 #ifndef IL_NO_JPG
 #ifndef IL_USE_IJL
 	// sam. void (*errorHandler)(j_common_ptr);
-	ILubyte	*TempPtr[1];
-	ILuint	Returned;
+	ILubyte	**Rows;
+	ILuint	Returned, y;
 	j_decompress_ptr JpegInfo = (j_decompress_ptr)_JpegInfo;
 
 	//added on 2003-08-31 as explained in sf bug 596793
@@ -854,11 +1137,24 @@ ILboolean JpegHandler::loadFromJpegStruct(void *_JpegInfo)
 		//@TODO: Anyway to get here?  Need to error out or something...
 		break;
 	}
+#ifdef JCS_EXTENSIONS
+	if (JpegInfo->out_color_space == JCS_EXT_BGR)
+		context->impl->iCurImage->Format = IL_BGR;
+	else if (JpegInfo->out_color_space == JCS_EXT_BGRA)
+		context->impl->iCurImage->Format = IL_BGRA;
+#endif
+
+	// Every row is handed over at once, so libjpeg writes as many as it has
+	//  ready (at least rec_outbuf_height) straight into the image each call.
+	//  The pointers come from libjpeg's pool, which an error also frees.
+	Rows = (ILubyte**)(*JpegInfo->mem->alloc_small)((j_common_ptr)JpegInfo, JPOOL_IMAGE,
+		JpegInfo->output_height * sizeof(ILubyte*));
+	for (y = 0; y < JpegInfo->output_height; y++)
+		Rows[y] = context->impl->iCurImage->Data + y * context->impl->iCurImage->Bps;
 
-	TempPtr[0] = context->impl->iCurImage->Data;
 	while (JpegInfo->output_scanline < JpegInfo->output_height) {
-		Returned = jpeg_read_scanlines(JpegInfo, TempPtr, 1);  // anyway to make it read all at once?
-		TempPtr[0] += context->impl->iCurImage->Bps;
+		Returned = jpeg_read_scanlines(JpegInfo, Rows + JpegInfo->output_scanline,
+			JpegInfo->output_height - JpegInfo->output_scanline);
 		if (Returned == 0)
 			break;
 	}
@@ -919,7 +1215,7 @@ ILboolean JpegHandler::saveFromJpegStruct(void *_JpegInfo)
 		TempData = iGetFlipped(context, TempImage);
 		if (TempData == NULL) {
 			if (TempImage != context->impl->iCurImage)
-				ilCloseImage(TempImage);
+				ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	}
@@ -944,9 +1240,9 @@ ILboolean JpegHandler::saveFromJpegStruct(void *_JpegInfo)
 	}
 
 	if (TempImage->Origin == IL_ORIGIN_LOWER_LEFT)
-		ifree(TempData);
+		ifree(context, TempData);
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return (!jpgErrorOccured);
 #endif//IL_USE_IJL
@@ -2,11 +2,11 @@
 //
 // ImageLib Sources
 // Copyright (C) 2000-2016 by Denton Woods
-// Last modified: 05/15/2016
+// Last modified: 10/17/2026
 //
 // Filename: src-IL/src/il_ktx.cpp
 //
-// Description: Reads a Khronos Texture .ktx file
+// Description: Reads and writes a Khronos Texture .ktx file
 //
 //-----------------------------------------------------------------------------
 
@@ -17,9 +17,10 @@
 #include "il_ktx.h"
 
 #include "il_bits.h"
-#include "rg_etc1.h"
+#include "il_threads.h"
 
 ILboolean	iKtxReadMipmaps(ILcontext* context, ILboolean Compressed, ILuint NumMips, ILenum Origin);
+ILboolean	iKtxReadCompressed(ILcontext* context, ILenum InternalFormat, ILuint NumMips, ILenum Origin);
 ILboolean	iKtxKeyValueData(ILcontext* context, ILuint bytesOfKeyValueData, ILenum &Origin);
 
 #ifdef _MSC_VER
@@ -65,6 +66,10 @@ typedef struct KTX_HEAD
 #define I_GL_RGBA                           0x1908
 #define I_GL_LUMINANCE                      0x1909
 #define I_GL_LUMINANCE_ALPHA                0x190A
+#define I_GL_LUMINANCE8                     0x8040
+#define I_GL_LUMINANCE8_ALPHA8              0x8045
+#define I_GL_RGB8                           0x8051
+#define I_GL_RGBA8                          0x8058
 // From gl2ext.h
 #define I_GL_ETC1_RGB8_OES                  0x8D64
 // From https://www.opengl.org/registry/specs/ARB/ES3_compatibility.txt
@@ -79,6 +84,11 @@ typedef struct KTX_HEAD
 #define I_GL_COMPRESSED_RG11_EAC                              0x9272
 #define I_GL_COMPRESSED_SIGNED_RG11_EAC                       0x9273
 
+// Blocks worth a thread of their own when decoding, and rows of blocks when
+//	encoding
+#define ETC_MIN_BLOCKS 4096
+#define ETC_MIN_ROWS 4
+
 KtxHandler::KtxHandler(ILcontext* context) :
 	context(context)
 {
@@ -181,13 +191,12 @@ ILboolean KtxHandler::loadL(const void *Lump, ILuint Size)
 ILboolean KtxHandler::loadInternal()
 {
 	KTX_HEAD	Header;
-	ILuint		imageSize;
 	ILenum		Format, Type, Origin;
-	ILubyte		Bpp, Bpc;
+	ILubyte		Bpp;
 	ILboolean	Compressed;
 	char		FileIdentifier[12] = {
 		//0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
-		'�', 'K', 'T', 'X', ' ', '1', '1', '�', '\r', '\n', '\x1A', '\n'
+		'\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n'
 	};
 
 	if (context->impl->iCurImage == NULL) {
@@ -276,6 +285,12 @@ ILboolean KtxHandler::loadInternal()
 		switch (Header.glInternalFormat)
 		{
 		case I_GL_ETC1_RGB8_OES:
+		case I_GL_COMPRESSED_RGB8_ETC2:
+		case I_GL_COMPRESSED_SRGB8_ETC2:
+		case I_GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case I_GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case I_GL_COMPRESSED_RGBA8_ETC2_EAC:
+		case I_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
 			Bpp = 4;
 			Format = IL_RGBA;
 			Compressed = IL_TRUE;
@@ -293,11 +308,9 @@ ILboolean KtxHandler::loadInternal()
 		switch (Header.glType)
 		{
 		case I_GL_UNSIGNED_BYTE:
-			Bpc = 1;
 			Type = IL_UNSIGNED_BYTE;
 			break;
 		case I_GL_HALF:
-			Bpc = 2;
 			Type = IL_HALF;
 			break;
 			//case I_GL_SHORT:
@@ -313,58 +326,10 @@ ILboolean KtxHandler::loadInternal()
 	}
 	else  // Compressed formats require different handling
 	{
-		//@TODO: Add support for compressed mipmaps
-		if (Header.numberOfMipmapLevels != 1)
-		{
-			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
-			return IL_FALSE;
-		}
-
-		imageSize = GetLittleUInt(context);
-
 		if (!ilTexImage(context, Header.pixelWidth, Header.pixelHeight, 1, Bpp, Format, Type, NULL))
 			return IL_FALSE;
-
-		switch (Header.glInternalFormat)
-		{
-		case I_GL_ETC1_RGB8_OES:
-			ILubyte * FullBuffer = (ILubyte*)ialloc(context, Header.pixelWidth * Header.pixelHeight / 2);
-			ILuint UnpackBuff[16 * 4];
-			ILuint *Data = (ILuint*)context->impl->iCurImage->Data;  // Easier copies
-
-			if (FullBuffer == NULL)
-				return IL_FALSE;
-			if (imageSize != Header.pixelWidth * Header.pixelHeight / 2) {
-				ilSetError(context, IL_ILLEGAL_FILE_VALUE);
-				return IL_FALSE;
-			}
-			if (context->impl->iread(context, FullBuffer, 1, imageSize) != imageSize)
-				return IL_FALSE;
-
-			ILuint BlockPos = 0;
-			for (ILuint y = 0; y < context->impl->iCurImage->Height; y += 4)
-			{
-				for (ILuint x = 0; x < context->impl->iCurImage->Width; x += 4)
-				{
-					ILuint ImagePos = y * context->impl->iCurImage->Width + x;
-					rg_etc1::unpack_etc1_block(&FullBuffer[BlockPos], (ILuint*)UnpackBuff, false);
-					ILuint c = 0;
-					for (ILuint y1 = 0; y1 < 4; y1++)
-					{
-						for (ILuint x1 = 0; x1 < 4; x1++)
-						{
-							Data[ImagePos + y1 * context->impl->iCurImage->Width + x1] = UnpackBuff[c++];
-						}
-					}
-					BlockPos += 8;
-				}
-			}
-
-			ifree(FullBuffer);
-			break;
-		}
-
-		context->impl->iCurImage->Origin = Origin;  //@TODO: Correct for all?
+		if (!iKtxReadCompressed(context, Header.glInternalFormat, IL_MAX(Header.numberOfMipmapLevels, 1), Origin))
+			return IL_FALSE;
 	}
 
 	return ilFixImage(context);
@@ -411,7 +376,7 @@ ILboolean iKtxKeyValueData(ILcontext* context, ILuint bytesOfKeyValueData, ILenu
 			break;
 	}
 
-	ifree(KeyValueData);
+	ifree(context, KeyValueData);
 
 	return IL_TRUE;
 }
@@ -475,11 +440,338 @@ mip_fail:
 	while (StartImage) {
 		TempImage = StartImage;
 		StartImage = StartImage->Mipmaps;
-		ifree(TempImage);
+		ifree(context, TempImage);
 	}
 
 	Image->Mipmaps = NULL;
 	return IL_FALSE;
 }
 
+// Decodes one ETC1, ETC2 or ETC2 + EAC block of InternalFormat to 4x4 RGBA
+//	pixels, row by row.
+static void iKtxDecodeBlock(ILenum InternalFormat, const ILubyte *Block, ILubyte *Pixels)
+{
+	switch (InternalFormat)
+	{
+	case I_GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+	case I_GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		DecodeEtc2Block(Block, IL_TRUE, Pixels);
+		break;
+	case I_GL_COMPRESSED_RGBA8_ETC2_EAC:
+	case I_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+		// The alpha block comes first.
+		DecodeEtc2Block(Block + 8, IL_FALSE, Pixels);
+		DecodeEacBlock(Block, Pixels + 3, 4);
+		break;
+	default:  // ETC1 blocks are ETC2 blocks that do not use the new modes.
+		DecodeEtc2Block(Block, IL_FALSE, Pixels);
+	}
+}
+
+// Reads and decodes NumMips compressed levels into the IL_RGBA, IL_UNSIGNED_BYTE
+//	current image and its mipmaps.  Rows of blocks are decoded on several threads.
+ILboolean iKtxReadCompressed(ILcontext* context, ILenum InternalFormat, ILuint NumMips, ILenum Origin)
+{
+	ILimage		*Image = context->impl->iCurImage;
+	ILubyte		*CompData;
+	ILuint		imageSize, BlockSize, BlocksX, BlocksY, Mip;
+
+	BlockSize = (InternalFormat == I_GL_COMPRESSED_RGBA8_ETC2_EAC || InternalFormat == I_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC) ? 16 : 8;
+
+	for (Mip = 0; Mip < NumMips; Mip++)
+	{
+		BlocksX = (Image->Width + 3) / 4;
+		BlocksY = (Image->Height + 3) / 4;
+
+		imageSize = GetLittleUInt(context);
+		if (imageSize != BlocksX * BlocksY * BlockSize) {
+			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
+			goto mip_fail;
+		}
+		CompData = (ILubyte*)ialloc(context, imageSize);
+		if (CompData == NULL)
+			goto mip_fail;
+		if (context->impl->iread(context, CompData, 1, imageSize) != imageSize) {
+			ifree(context, CompData);
+			goto mip_fail;
+		}
+
+		iParallelFor(BlocksY, IL_MAX(ETC_MIN_BLOCKS / BlocksX, 1), [&](ILuint First, ILuint Last) {
+			ILubyte	Pixels[64], *Dest;
+			ILuint	Row, bx, x, y, i;
+
+			for (Row = First; Row < Last; Row++) {
+				y = Row * 4;
+				for (bx = 0; bx < BlocksX; bx++) {
+					iKtxDecodeBlock(InternalFormat, CompData + (Row * BlocksX + bx) * BlockSize, Pixels);
+					x = bx * 4;
+					Dest = Image->Data + y * Image->Bps + x * 4;
+					for (i = 0; i < 4 && y + i < Image->Height; i++)
+						memcpy(Dest + i * Image->Bps, Pixels + i * 16, IL_MIN(4, Image->Width - x) * 4);
+				}
+			}
+		});
+
+		ifree(context, CompData);
+		Image->Origin = Origin;
+
+		if (Mip < NumMips - 1)
+		{
+			Image->Mipmaps = ilNewImageFull(context, IL_MAX(Image->Width / 2, 1), IL_MAX(Image->Height / 2, 1), 1,
+				4, IL_RGBA, IL_UNSIGNED_BYTE, NULL);
+			if (Image->Mipmaps == NULL)
+				goto mip_fail;
+			Image = Image->Mipmaps;
+		}
+	}
+
+	return IL_TRUE;
+
+mip_fail:
+	ilCloseImage(context, context->impl->iCurImage->Mipmaps);
+	context->impl->iCurImage->Mipmaps = NULL;
+	return IL_FALSE;
+}
+
+
+//! Writes a .ktx file
+ILboolean KtxHandler::save(ILconst_string FileName)
+{
+	ILHANDLE	KtxFile;
+	ILuint		KtxSize;
+
+	if (ilGetBoolean(context, IL_FILE_MODE) == IL_FALSE) {
+		if (iFileExists(FileName)) {
+			ilSetError(context, IL_FILE_ALREADY_EXISTS);
+			return IL_FALSE;
+		}
+	}
+
+	KtxFile = context->impl->iopenw(FileName);
+	if (KtxFile == NULL) {
+		ilSetError(context, IL_COULD_NOT_OPEN_FILE);
+		return IL_FALSE;
+	}
+
+	KtxSize = saveF(KtxFile);
+	context->impl->iclosew(KtxFile);
+
+	if (KtxSize == 0)
+		return IL_FALSE;
+	return IL_TRUE;
+}
+
+//! Writes a .ktx to an already-opened file
+ILuint KtxHandler::saveF(ILHANDLE File)
+{
+	ILuint Pos;
+	iSetOutputFile(context, File);
+	Pos = context->impl->itellw(context);
+	if (saveInternal() == IL_FALSE)
+		return 0;  // Error occurred
+	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+}
+
+//! Writes a .ktx to a memory "lump"
+ILuint KtxHandler::saveL(void *Lump, ILuint Size)
+{
+	ILuint Pos;
+	iSetOutputLump(context, Lump, Size);
+	Pos = context->impl->itellw(context);
+	if (saveInternal() == IL_FALSE)
+		return 0;  // Error occurred
+	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+}
+
+// Encodes the Width x Height RGBA pixels at Data as Compression, one of IL_ETC1,
+//	IL_ETC2_RGB or IL_ETC2_RGBA, into Out.  Blocks that hang over the edges
+//	repeat the last column or row, and rows of blocks are spread over threads.
+static void iKtxEncode(const ILubyte *Data, ILuint Width, ILuint Height, ILenum Compression, ILuint Quality, ILubyte *Out)
+{
+	ILuint BlocksX = (Width + 3) / 4, BlocksY = (Height + 3) / 4;
+	ILuint BlockSize = Compression == IL_ETC2_RGBA ? 16 : 8;
+
+	iParallelFor(BlocksY, ETC_MIN_ROWS, [&](ILuint First, ILuint Last) {
+		ILubyte	Pixels[64], *Dest;
+		ILuint	Row, bx, x, y;
+
+		for (Row = First; Row < Last; Row++) {
+			Dest = Out + Row * BlocksX * BlockSize;
+			for (bx = 0; bx < BlocksX; bx++, Dest += BlockSize) {
+				for (y = 0; y < 4; y++) {
+					for (x = 0; x < 4; x++) {
+						memcpy(Pixels + (y * 4 + x) * 4, Data + (IL_MIN(Row * 4 + y, Height - 1) * Width
+							+ IL_MIN(bx * 4 + x, Width - 1)) * 4, 4);
+					}
+				}
+
+				switch (Compression)
+				{
+				case IL_ETC1:
+					EncodeEtc1Block(Pixels, Quality, Dest);
+					break;
+				case IL_ETC2_RGB:
+					EncodeEtc2Block(Pixels, Quality, Dest);
+					break;
+				case IL_ETC2_RGBA:
+					EncodeEacBlock(Pixels + 3, 4, Quality, Dest);
+					EncodeEtc2Block(Pixels, Quality, Dest + 8);
+					break;
+				}
+			}
+		}
+	});
+}
+
+// Internal function used to save the .ktx.  Images are written uncompressed as
+//	luminance, luminance-alpha, RGB or RGBA bytes, or compressed as IL_KTX_COMP
+//	says, along with any mipmaps that halve in size.
+ILboolean KtxHandler::saveInternal()
+{
+	ILimage		*Image = context->impl->iCurImage, *Mip, *TempImage;
+	ILubyte		*TempData, *CompData = NULL, Padding[3] = { 0, 0, 0 };
+	ILenum		Compression, Format;
+	ILuint		Quality, NumMips, GlFormat, GlInternal, GlBase, imageSize, Bps, Width, Height, y;
+	const char	FileIdentifier[12] = {
+		'\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n'
+	};
+
+	if (Image == NULL) {
+		ilSetError(context, IL_ILLEGAL_OPERATION);
+		return IL_FALSE;
+	}
+	if (Image->Depth > 1) {  //@TODO: 3D textures
+		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+		return IL_FALSE;
+	}
+
+	Compression = ilGetInteger(context, IL_KTX_COMP);
+	Quality = ilGetInteger(context, IL_ETC_QUALITY);
+
+	switch (Compression)
+	{
+	case IL_ETC1:
+		Format = IL_RGBA;
+		GlFormat = 0;
+		GlInternal = I_GL_ETC1_RGB8_OES;
+		GlBase = I_GL_RGB;
+		break;
+	case IL_ETC2_RGB:
+		Format = IL_RGBA;
+		GlFormat = 0;
+		GlInternal = I_GL_COMPRESSED_RGB8_ETC2;
+		GlBase = I_GL_RGB;
+		break;
+	case IL_ETC2_RGBA:
+		Format = IL_RGBA;
+		GlFormat = 0;
+		GlInternal = I_GL_COMPRESSED_RGBA8_ETC2_EAC;
+		GlBase = I_GL_RGBA;
+		break;
+	default:
+		switch (Image->Format)
+		{
+		case IL_LUMINANCE:
+			Format = IL_LUMINANCE;
+			GlFormat = I_GL_LUMINANCE;
+			GlInternal = I_GL_LUMINANCE8;
+			break;
+		case IL_LUMINANCE_ALPHA:
+			Format = IL_LUMINANCE_ALPHA;
+			GlFormat = I_GL_LUMINANCE_ALPHA;
+			GlInternal = I_GL_LUMINANCE8_ALPHA8;
+			break;
+		case IL_RGB:
+		case IL_BGR:
+			Format = IL_RGB;
+			GlFormat = I_GL_RGB;
+			GlInternal = I_GL_RGB8;
+			break;
+		default:
+			Format = IL_RGBA;
+			GlFormat = I_GL_RGBA;
+			GlInternal = I_GL_RGBA8;
+		}
+		GlBase = GlFormat;
+	}
+
+	// Mipmaps are only written while each is half the size of the one before.
+	NumMips = 1;
+	for (Mip = Image; Mip->Mipmaps != NULL; Mip = Mip->Mipmaps, NumMips++) {
+		if (Mip->Mipmaps->Width != IL_MAX(Mip->Width / 2, 1) || Mip->Mipmaps->Height != IL_MAX(Mip->Height / 2, 1)
+			|| Mip->Mipmaps->Depth != 1)
+			break;
+	}
+
+	context->impl->iwrite(context, FileIdentifier, 1, 12);
+	SaveLittleUInt(context, 0x04030201);
+	SaveLittleUInt(context, GlFormat == 0 ? 0 : I_GL_UNSIGNED_BYTE);  // glType
+	SaveLittleUInt(context, 1);  // glTypeSize
+	SaveLittleUInt(context, GlFormat);
+	SaveLittleUInt(context, GlInternal);
+	SaveLittleUInt(context, GlBase);
+	SaveLittleUInt(context, Image->Width);
+	SaveLittleUInt(context, Image->Height);
+	SaveLittleUInt(context, 0);  // pixelDepth
+	SaveLittleUInt(context, 0);  // numberOfArrayElements
+	SaveLittleUInt(context, 1);  // numberOfFaces
+	SaveLittleUInt(context, NumMips);
+	SaveLittleUInt(context, 0);  // bytesOfKeyValueData: the rows are written top down, the default.
+
+	for (Mip = Image; NumMips > 0; Mip = Mip->Mipmaps, NumMips--)
+	{
+		TempImage = Mip;
+		if (Mip->Format != Format || Mip->Type != IL_UNSIGNED_BYTE) {
+			TempImage = iConvertImage(context, Mip, Format, IL_UNSIGNED_BYTE);
+			if (TempImage == NULL)
+				return IL_FALSE;
+		}
+
+		if (Mip->Origin != IL_ORIGIN_UPPER_LEFT) {
+			TempData = iGetFlipped(context, TempImage);
+			if (TempData == NULL) {
+				if (TempImage != Mip)
+					ilCloseImage(context, TempImage);
+				return IL_FALSE;
+			}
+		}
+		else {
+			TempData = TempImage->Data;
+		}
+
+		Width = TempImage->Width;
+		Height = TempImage->Height;
+		Bps = TempImage->Bps;
+
+		if (GlFormat != 0) {
+			// Each row is padded to a multiple of 4 bytes.
+			imageSize = ((Bps + 3) & ~3u) * Height;
+			SaveLittleUInt(context, imageSize);
+			for (y = 0; y < Height; y++) {
+				context->impl->iwrite(context, TempData + y * Bps, 1, Bps);
+				context->impl->iwrite(context, Padding, 1, ((Bps + 3) & ~3u) - Bps);
+			}
+		}
+		else {
+			imageSize = ((Width + 3) / 4) * ((Height + 3) / 4) * (Compression == IL_ETC2_RGBA ? 16 : 8);
+			CompData = (ILubyte*)ialloc(context, imageSize);
+			if (CompData != NULL) {
+				iKtxEncode(TempData, Width, Height, Compression, Quality, CompData);
+				SaveLittleUInt(context, imageSize);
+				context->impl->iwrite(context, CompData, 1, imageSize);
+				ifree(context, CompData);
+			}
+		}
+
+		if (TempData != TempImage->Data)
+			ifree(context, TempData);
+		if (TempImage != Mip)
+			ilCloseImage(context, TempImage);
+		if (GlFormat == 0 && CompData == NULL)
+			return IL_FALSE;
+	}
+
+	return IL_TRUE;
+}
+
 #endif//IL_NO_KTX
\ No newline at end of file
@@ -0,0 +1,360 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/src/il_loadrows.cpp
+//
+// Description: Loads images by handing their rows over a band at a time, so
+//				the whole image never has to be in memory
+//
+//-----------------------------------------------------------------------------
+
+#include "il_internal.h"
+#include "il_bmp.h"
+#include "il_hdr.h"
+#include "il_jpeg.h"
+#include "il_png.h"
+#include "il_tiff.h"
+
+
+// About how much of the image is handed over at a time
+#define ROW_BAND_SIZE (1 << 20)
+
+
+static ILboolean	iLoadRows(ILcontext* context, ILenum Type, ILHANDLE File, const void *Lump, ILuint Size, iRowSink *Sink);
+static ILboolean	iLoadRowsWhole(ILcontext* context, ILenum Type, ILHANDLE File, const void *Lump, ILuint Size, iRowSink *Sink);
+static ILboolean	iSinkInit(ILcontext* context, iRowSink *Sink, ILenum Format, ILenum DataType, IL_ROWSINKPROC Proc, void *UserData);
+
+
+//! Decodes the image in FileName and gives its rows to Proc, a band at a time
+//	and top row first, instead of loading it into the current image.  Each
+//	band is handed over as soon as it is decoded, and only about a megabyte
+//	of it is kept.
+/*! BMP (uncompressed 8, 24 and 32-bit), HDR, JPEG, PNG (not interlaced) and
+	TIFF (one sample per pixel or chunky grey and RGB, stored top-down) files
+	are decoded row by row.  Other files, and the other kinds of these, are
+	loaded whole into a scratch image first, which is then handed over the
+	same way.  Only the first image in the file is given, and the current
+	image does not change.
+	\param Type Format of the file, or IL_TYPE_UNKNOWN to work it out as ilLoad does.
+	\param Format Format to give the rows in, or 0 for the one ilLoad would give.
+	Colour-indexed images are always expanded through their palette.
+	\param DataType Type to give the rows in, or 0 for the one ilLoad would give.
+	\return Boolean value of failure or success.  If Proc returns IL_FALSE the
+	load stops there with IL_INTERNAL_ERROR.*/
+ILboolean ILAPIENTRY ilLoadRows(ILcontext* context, ILenum Type, ILconst_string FileName, ILenum Format, ILenum DataType,
+	IL_ROWSINKPROC Proc, void *UserData)
+{
+	ILHANDLE	File;
+	ILboolean	bRet;
+
+	if (FileName == NULL || ilStrLen(FileName) < 1) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+
+	File = context->impl->iopenr(FileName);
+	if (File == NULL) {
+		ilSetError(context, IL_COULD_NOT_OPEN_FILE);
+		return IL_FALSE;
+	}
+
+	if (Type == IL_TYPE_UNKNOWN)
+		Type = ilDetermineTypeF(context, File);
+	if (Type == IL_TYPE_UNKNOWN)
+		Type = ilTypeFromExt(context, FileName);
+
+	bRet = ilLoadRowsF(context, Type, File, Format, DataType, Proc, UserData);
+	context->impl->icloser(File);
+
+	return bRet;
+}
+
+
+//! Gives the rows of an image in an already-opened file to Proc, like ilLoadRows.
+ILboolean ILAPIENTRY ilLoadRowsF(ILcontext* context, ILenum Type, ILHANDLE File, ILenum Format, ILenum DataType,
+	IL_ROWSINKPROC Proc, void *UserData)
+{
+	iRowSink	Sink;
+
+	if (File == NULL) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+	if (!iSinkInit(context, &Sink, Format, DataType, Proc, UserData))
+		return IL_FALSE;
+
+	if (Type == IL_TYPE_UNKNOWN)
+		Type = ilDetermineTypeF(context, File);
+	if (Type == IL_TYPE_UNKNOWN) {
+		ilSetError(context, IL_INVALID_EXTENSION);
+		return IL_FALSE;
+	}
+
+	return iLoadRows(context, Type, File, NULL, 0, &Sink);
+}
+
+
+//! Gives the rows of an image in a memory "lump" to Proc, like ilLoadRows.
+ILboolean ILAPIENTRY ilLoadRowsL(ILcontext* context, ILenum Type, const void *Lump, ILuint Size, ILenum Format, ILenum DataType,
+	IL_ROWSINKPROC Proc, void *UserData)
+{
+	iRowSink	Sink;
+
+	if (Lump == NULL || Size == 0) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+	if (!iSinkInit(context, &Sink, Format, DataType, Proc, UserData))
+		return IL_FALSE;
+
+	if (Type == IL_TYPE_UNKNOWN)
+		Type = ilDetermineTypeL(context, Lump, Size);
+	if (Type == IL_TYPE_UNKNOWN) {
+		ilSetError(context, IL_INVALID_EXTENSION);
+		return IL_FALSE;
+	}
+
+	return iLoadRows(context, Type, NULL, Lump, Size, &Sink);
+}
+
+
+static ILboolean iSinkInit(ILcontext* context, iRowSink *Sink, ILenum Format, ILenum DataType, IL_ROWSINKPROC Proc, void *UserData)
+{
+	if (Proc == NULL) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+	if ((Format != 0 && ilGetBppFormat(Format) == 0) || (DataType != 0 && ilGetBpcType(DataType) == 0)) {
+		ilSetError(context, IL_INVALID_ENUM);
+		return IL_FALSE;
+	}
+	if (Format == IL_COLOUR_INDEX) {
+		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+		return IL_FALSE;
+	}
+
+	imemclear(Sink, sizeof(iRowSink));
+	Sink->Proc = Proc;
+	Sink->UserData = UserData;
+
+	// Without a format of its own, the caller gets what ilLoad would make.
+	Sink->DestFormat = Format;
+	Sink->DestType = DataType;
+	if (Format == 0 && ilIsEnabled(context, IL_FORMAT_SET))
+		Sink->DestFormat = ilGetInteger(context, IL_FORMAT_MODE);
+	if (DataType == 0 && ilIsEnabled(context, IL_TYPE_SET))
+		Sink->DestType = ilGetInteger(context, IL_TYPE_MODE);
+
+	return IL_TRUE;
+}
+
+
+static ILboolean iLoadRows(ILcontext* context, ILenum Type, ILHANDLE File, const void *Lump, ILuint Size, iRowSink *Sink)
+{
+	ILboolean	bRet;
+
+	switch (Type)
+	{
+#ifndef IL_NO_BMP
+	case IL_BMP:
+	{
+		BmpHandler handler(context);
+
+		bRet = File != NULL ? handler.loadRowsF(File, Sink) : handler.loadRowsL(Lump, Size, Sink);
+	}
+	break;
+#endif
+
+#ifndef IL_NO_HDR
+	case IL_HDR:
+	{
+		HdrHandler handler(context);
+
+		bRet = File != NULL ? handler.loadRowsF(File, Sink) : handler.loadRowsL(Lump, Size, Sink);
+	}
+	break;
+#endif
+
+#ifndef IL_NO_JPG
+#ifndef IL_USE_IJL
+	case IL_JPG:
+	{
+		JpegHandler handler(context);
+
+		bRet = File != NULL ? handler.loadRowsF(File, Sink) : handler.loadRowsL(Lump, Size, Sink);
+	}
+	break;
+#endif
+#endif
+
+#ifndef IL_NO_PNG
+	case IL_PNG:
+	{
+		PngHandler handler(context);
+
+		bRet = File != NULL ? handler.loadRowsF(File, Sink) : handler.loadRowsL(Lump, Size, Sink);
+	}
+	break;
+#endif
+
+#ifndef IL_NO_TIF
+	case IL_TIF:
+	{
+		TiffHandler handler(context);
+
+		bRet = File != NULL ? handler.loadRowsF(File, Sink) : handler.loadRowsL(Lump, Size, Sink);
+	}
+	break;
+#endif
+
+	default:
+		Sink->Whole = IL_TRUE;
+		bRet = IL_FALSE;
+		break;
+	}
+
+	// Decoders give up on files they cannot stream before any rows are sent.
+	if (!bRet && Sink->Whole) {
+		iSinkEnd(context, Sink);
+		bRet = iLoadRowsWhole(context, Type, File, Lump, Size, Sink);
+	}
+	if (bRet)
+		bRet = iSinkFlush(context, Sink);
+
+	iSinkEnd(context, Sink);
+	return bRet;
+}
+
+
+// Loads the file into a scratch image with ilLoad and hands that over.  The
+//  bound image is restored afterwards (as its base image).
+static ILboolean iLoadRowsWhole(ILcontext* context, ILenum Type, ILHANDLE File, const void *Lump, ILuint Size, iRowSink *Sink)
+{
+	ILuint		PrevName, Scratch, y;
+	ILimage		*Image;
+	ILubyte		*Rows;
+	ILboolean	bRet;
+
+	PrevName = ilGetCurName(context);
+	Scratch = ilGenImage(context);
+	ilBindImage(context, Scratch);
+
+	bRet = File != NULL ? ilLoadF(context, Type, File) : ilLoadL(context, Type, Lump, Size);
+	if (bRet && context->impl->iCurImage->Format == IL_COLOUR_INDEX)
+		bRet = ilConvertImage(context, ilGetPalBaseType(context->impl->iCurImage->Pal.PalType), IL_UNSIGNED_BYTE);
+	Image = context->impl->iCurImage;
+
+	// Only the first slice of a 3d image is given.
+	if (bRet)
+		bRet = iSinkBegin(context, Sink, Image->Width, Image->Height, Image->Format, Image->Type);
+	for (y = 0; bRet && y < Image->Height; y++) {
+		Rows = iSinkRows(context, Sink, 1);
+		if (Rows == NULL) {
+			bRet = IL_FALSE;
+			break;
+		}
+		memcpy(Rows, Image->Data + (ILsizei)(Image->Origin == IL_ORIGIN_LOWER_LEFT ? Image->Height - 1 - y : y) * Image->Bps,
+			Image->Bps);
+	}
+
+	ilBindImage(context, PrevName);
+	ilDeleteImages(context, 1, &Scratch);
+	return bRet;
+}
+
+
+// Called by the decoder once it knows what it will give: Width x Height
+//	rows in Format and Type.
+ILboolean iSinkBegin(ILcontext* context, iRowSink *Sink, ILuint Width, ILuint Height, ILenum Format, ILenum Type)
+{
+	if (Width == 0 || Height == 0) {
+		ilSetError(context, IL_ILLEGAL_FILE_VALUE);
+		return IL_FALSE;
+	}
+
+	Sink->Format = Format;
+	Sink->Type = Type;
+	Sink->Bps = Width * ilGetBppFormat(Format) * ilGetBpcType(Type);
+	Sink->BandRows = IL_MIN(IL_MAX(ROW_BAND_SIZE / Sink->Bps, 1), Height);
+	Sink->BandFirst = Sink->BandCount = 0;
+
+	imemclear(&Sink->Info, sizeof(ILimageinfo));
+	Sink->Info.Width = Width;
+	Sink->Info.Height = Height;
+	Sink->Info.Depth = 1;
+	Sink->Info.Format = Sink->DestFormat != 0 ? Sink->DestFormat : Format;
+	Sink->Info.Type = Sink->DestType != 0 ? Sink->DestType : Type;
+
+	Sink->Band = (ILubyte*)ialloc(context, (ILsizei)Sink->BandRows * Sink->Bps);
+	if (Sink->Band == NULL)
+		return IL_FALSE;
+	return IL_TRUE;
+}
+
+
+// Room for the next NumRows rows down, which the decoder fills before asking
+//	again.  The band is handed over first if they do not fit after it, and
+//	grows if NumRows would never fit.  NULL if Proc gave up.
+ILubyte *iSinkRows(ILcontext* context, iRowSink *Sink, ILuint NumRows)
+{
+	ILubyte	*Rows;
+
+	if (Sink->Band == NULL || NumRows > Sink->Info.Height - Sink->BandFirst - Sink->BandCount) {
+		ilSetError(context, IL_INTERNAL_ERROR);
+		return NULL;
+	}
+
+	if (Sink->BandCount + NumRows > Sink->BandRows) {
+		if (!iSinkFlush(context, Sink))
+			return NULL;
+		if (NumRows > Sink->BandRows) {
+			ifree(context, Sink->Band);
+			Sink->Band = (ILubyte*)ialloc(context, (ILsizei)NumRows * Sink->Bps);
+			if (Sink->Band == NULL)
+				return NULL;
+			Sink->BandRows = NumRows;
+		}
+	}
+
+	Rows = Sink->Band + (ILsizei)Sink->BandCount * Sink->Bps;
+	Sink->BandCount += NumRows;
+	return Rows;
+}
+
+
+// Hands the rows in the band over to Proc.
+ILboolean iSinkFlush(ILcontext* context, iRowSink *Sink)
+{
+	ILubyte		*Conv = NULL;
+	ILboolean	bRet;
+
+	if (Sink->BandCount == 0)
+		return IL_TRUE;
+
+	if (Sink->Format != Sink->Info.Format || Sink->Type != Sink->Info.Type) {
+		Conv = (ILubyte*)ilConvertBuffer(context, (ILsizei)Sink->BandCount * Sink->Bps, Sink->Format, Sink->Info.Format,
+			Sink->Type, Sink->Info.Type, NULL, Sink->Band);
+		if (Conv == NULL)
+			return IL_FALSE;
+	}
+
+	bRet = Sink->Proc(Sink->UserData, &Sink->Info, Sink->BandFirst, Sink->BandCount, Conv != NULL ? Conv : Sink->Band);
+	ifree(context, Conv);
+	if (!bRet)
+		ilSetError(context, IL_INTERNAL_ERROR);  // Proc gave up.
+
+	Sink->BandFirst += Sink->BandCount;
+	Sink->BandCount = 0;
+	return bRet;
+}
+
+
+void iSinkEnd(ILcontext* context, iRowSink *Sink)
+{
+	ifree(context, Sink->Band);
+	Sink->Band = NULL;
+	Sink->BandCount = 0;
+}
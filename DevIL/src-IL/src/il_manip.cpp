@@ -369,7 +369,7 @@ ILboolean ILAPIENTRY iMirror(ILcontext* context) {
 			break;
 	}
 
-	ifree(context->impl->iCurImage->Data);
+	ifree(context, context->impl->iCurImage->Data);
 	context->impl->iCurImage->Data = Data;
 
 	return IL_TRUE;
@@ -408,7 +408,7 @@ ILboolean ilCopyPixels1D(ILcontext* context, ILuint XOff, ILuint Width, void *Da
 	}
 
 	if (TempData != context->impl->iCurImage->Data)
-		ifree(TempData);
+		ifree(context, TempData);
 
 	return IL_TRUE;
 }
@@ -446,14 +446,14 @@ ILboolean ilCopyPixels2D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint Wi
 	for (y = 0; y < NewHeight; y++) {
 		for (x = 0; x < NewBps; x += PixBpp) {
 			for (c = 0; c < PixBpp; c++) {
-				Temp[y * DataBps + x + c] = 
-					TempData[(y + YOff) * context->impl->iCurImage->Bps + x + NewXOff + c];
+				Temp[(ILsizei)y * DataBps + x + c] = 
+					TempData[(ILsizei)(y + YOff) * context->impl->iCurImage->Bps + x + NewXOff + c];
 			}
 		}
 	}
 
 	if (TempData != context->impl->iCurImage->Data)
-		ifree(TempData);
+		ifree(context, TempData);
 
 	return IL_TRUE;
 }
@@ -462,7 +462,8 @@ ILboolean ilCopyPixels2D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint Wi
 // Copies a 3d block of pixels to the buffer pointed to by Data.
 ILboolean ilCopyPixels3D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZOff, ILuint Width, ILuint Height, ILuint Depth, void *Data)
 {
-	ILuint	x, y, z, c, NewBps, DataBps, NewSizePlane, NewH, NewD, NewXOff, PixBpp;
+	ILuint	x, y, z, c, NewBps, DataBps, NewH, NewD, NewXOff, PixBpp;
+	ILsizei	NewSizePlane;
 	ILubyte	*Temp = (ILubyte*)Data, *TempData = context->impl->iCurImage->Data;
 
 	if (ilIsEnabled(context, IL_ORIGIN_SET)) {
@@ -491,7 +492,7 @@ ILboolean ilCopyPixels3D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZO
 		NewD = Depth;
 
 	DataBps = Width * PixBpp;
-	NewSizePlane = NewBps * NewH;
+	NewSizePlane = (ILsizei)NewBps * NewH;
 
 	NewXOff = XOff * PixBpp;
 
@@ -499,8 +500,8 @@ ILboolean ilCopyPixels3D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZO
 		for (y = 0; y < NewH; y++) {
 			for (x = 0; x < NewBps; x += PixBpp) {
 				for (c = 0; c < PixBpp; c++) {
-					Temp[z * NewSizePlane + y * DataBps + x + c] = 
-						TempData[(z + ZOff) * context->impl->iCurImage->SizeOfPlane + (y + YOff) * context->impl->iCurImage->Bps + x + NewXOff + c];
+					Temp[z * NewSizePlane + (ILsizei)y * DataBps + x + c] = 
+						TempData[(z + ZOff) * context->impl->iCurImage->SizeOfPlane + (ILsizei)(y + YOff) * context->impl->iCurImage->Bps + x + NewXOff + c];
 						//TempData[(z + ZOff) * context->impl->iCurImage->SizeOfPlane + (y + YOff) * context->impl->iCurImage->Bps + (x + XOff) * context->impl->iCurImage->Bpp + c];
 				}
 			}
@@ -508,23 +509,23 @@ ILboolean ilCopyPixels3D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZO
 	}
 
 	if (TempData != context->impl->iCurImage->Data)
-		ifree(TempData);
+		ifree(context, TempData);
 
 	return IL_TRUE;
 }
 
 
-ILuint ILAPIENTRY ilCopyPixels(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZOff, ILuint Width, ILuint Height, ILuint Depth, ILenum Format, ILenum Type, void *Data)
+ILsizei ILAPIENTRY ilCopyPixels(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZOff, ILuint Width, ILuint Height, ILuint Depth, ILenum Format, ILenum Type, void *Data)
 {
 	void	*Converted = NULL;
 	ILubyte	*TempBuff = NULL;
-	ILuint	SrcSize, DestSize;
+	ILsizei	SrcSize, DestSize;
 
 	if (context->impl->iCurImage == NULL) {
 		ilSetError(context, IL_ILLEGAL_OPERATION);
 		return 0;
 	}
-	DestSize = Width * Height * Depth * ilGetBppFormat(Format) * ilGetBpcType(Type);
+	DestSize = (ILsizei)Width * Height * Depth * ilGetBppFormat(Format) * ilGetBpcType(Type);
 	if (DestSize == 0) {
 		return DestSize;
 	}
@@ -532,7 +533,7 @@ ILuint ILAPIENTRY ilCopyPixels(ILcontext* context, ILuint XOff, ILuint YOff, ILu
 		ilSetError(context, IL_INVALID_PARAM);
 		return 0;
 	}
-	SrcSize = Width * Height * Depth * context->impl->iCurImage->Bpp * context->impl->iCurImage->Bpc;
+	SrcSize = (ILsizei)Width * Height * Depth * context->impl->iCurImage->Bpp * context->impl->iCurImage->Bpc;
 
 	if (Format == context->impl->iCurImage->Format && Type == context->impl->iCurImage->Type) {
 		TempBuff = (ILubyte*)Data;
@@ -570,16 +571,16 @@ ILuint ILAPIENTRY ilCopyPixels(ILcontext* context, ILuint XOff, ILuint YOff, ILu
 
 	memcpy(Data, Converted, DestSize);
 
-	ifree(Converted);
+	ifree(context, Converted);
 	if (TempBuff != Data)
-		ifree(TempBuff);
+		ifree(context, TempBuff);
 
 	return DestSize;
 
 failed:
 	if (TempBuff != Data)
-		ifree(TempBuff);
-	ifree(Converted);
+		ifree(context, TempBuff);
+	ifree(context, Converted);
 	return 0;
 }
 
@@ -621,7 +622,7 @@ ILboolean ilSetPixels1D(ILcontext* context, ILint XOff, ILuint Width, void *Data
 	}
 
 	if (TempData != context->impl->iCurImage->Data) {
-		ifree(context->impl->iCurImage->Data);
+		ifree(context, context->impl->iCurImage->Data);
 		context->impl->iCurImage->Data = TempData;
 	}
 
@@ -678,7 +679,7 @@ ILboolean ilSetPixels2D(ILcontext* context, ILint XOff, ILint YOff, ILuint Width
 	}
 
 	if (TempData != context->impl->iCurImage->Data) {
-		ifree(context->impl->iCurImage->Data);
+		ifree(context, context->impl->iCurImage->Data);
 		context->impl->iCurImage->Data = TempData;
 	}
 
@@ -748,7 +749,7 @@ ILboolean ilSetPixels3D(ILcontext* context, ILint XOff, ILint YOff, ILint ZOff,
 	}
 
 	if (TempData != context->impl->iCurImage->Data) {
-		ifree(context->impl->iCurImage->Data);
+		ifree(context, context->impl->iCurImage->Data);
 		context->impl->iCurImage->Data = TempData;
 	}
 
@@ -773,7 +774,7 @@ void ILAPIENTRY ilSetPixels(ILcontext* context, ILint XOff, ILint YOff, ILint ZO
 		Converted = (void*)Data;
 	}
 	else {
-		Converted = ilConvertBuffer(context, Width * Height * Depth * ilGetBppFormat(Format) * ilGetBpcType(Type), Format, context->impl->iCurImage->Format, Type, context->impl->iCurImage->Type, NULL, Data);
+		Converted = ilConvertBuffer(context, (ILsizei)Width * Height * Depth * ilGetBppFormat(Format) * ilGetBpcType(Type), Format, context->impl->iCurImage->Format, Type, context->impl->iCurImage->Type, NULL, Data);
 		if (!Converted)
 			return;
 	}
@@ -793,7 +794,7 @@ void ILAPIENTRY ilSetPixels(ILcontext* context, ILint XOff, ILint YOff, ILint ZO
 	}
 
 	if (Converted != Data)
-		ifree(Converted);
+		ifree(context, Converted);
 
 	return;
 }
@@ -895,7 +896,7 @@ ILubyte* ILAPIENTRY ilGetAlpha(ILcontext* context, ILenum Type)
 	Alpha = (ILubyte*)ialloc(context, Size / TempImage->Bpp * Bpc);
 	if (Alpha == NULL) {
 		if (TempImage != context->impl->iCurImage)
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 		return NULL;
 	}
 
@@ -907,7 +908,7 @@ ILubyte* ILAPIENTRY ilGetAlpha(ILcontext* context, ILenum Type)
 		case IL_COLOUR_INDEX:  // @TODO: Make IL_COLOUR_INDEX separate.
 			memset(Alpha, 0xFF, Size / TempImage->Bpp * Bpc);
 			if (TempImage != context->impl->iCurImage)
-				ilCloseImage(TempImage);
+				ilCloseImage(context, TempImage);
 			return Alpha;
 	}
 
@@ -953,7 +954,7 @@ ILubyte* ILAPIENTRY ilGetAlpha(ILcontext* context, ILenum Type)
 	}
 
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return Alpha;
 }
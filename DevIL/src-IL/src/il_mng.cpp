@@ -63,7 +63,7 @@ mng_ptr MNG_DECL mymngalloc(mng_size_t size)
 //---------------------------------------------------------------------------------------------
 void MNG_DECL mymngfree(mng_ptr p, mng_size_t size)
 {
-	ifree(p);
+	ifree(context, p);
 }
 
 
@@ -34,13 +34,6 @@
 #include "il_internal.h"
 
 
-// Function definitions
-void	initnet(ILubyte *thepic, ILint len, ILint sample);
-void	unbiasnet();
-void	inxbuild();
-ILubyte	inxsearch(ILint b, ILint g, ILint r);
-void	learn();
-
 // four primes near 500 - assume no image has a length so large
 // that it is divisible by all four primes
 #define prime1			499
@@ -55,7 +48,7 @@ void	learn();
 // -------------------
    
 #define netsize			256					// number of colours used
-#define maxnetpos		(netsizethink-1)
+#define maxnetpos		(nq->netsizethink-1)
 #define netbiasshift	4					// bias for colour values
 #define ncycles			100					// no. of learning cycles
 
@@ -78,7 +71,6 @@ void	learn();
 // defs for decreasing alpha factor
 #define alphabiasshift	10						// alpha starts at 1.0
 #define initalpha		(((ILint) 1)<<alphabiasshift)
-ILint	alphadec;								// biased by 10 bits
 
 // radbias and alpharadbias used for radpower calculation
 #define radbiasshift	8
@@ -87,38 +79,43 @@ ILint	alphadec;								// biased by 10 bits
 #define alpharadbias	(((ILint) 1)<<alpharadbshift)
 
 
-// Types and Global Variables
-// --------------------------
-   
-unsigned char	*thepicture;			// the input image itself
-int				lengthcount;			// lengthcount = H*W*3
-int				samplefac;				// sampling factor 1..30
+// Types and State
+// ---------------
+
 typedef int		pixel[4];				// BGRc
-static pixel	network[netsize];		// the network itself
-int				netindex[256];			// for network lookup - really 256
-int				bias [netsize];			// bias and freq arrays for learning
-int				freq [netsize];
-int				radpower[initrad];		// radpower for precomputation
 
-int netsizethink; // number of colors we want to reduce to, 2-256
+// Everything one quantization run works on, so that runs don't share state.
+typedef struct NeuQuant
+{
+	unsigned char	*thepicture;			// the input image itself
+	int				lengthcount;			// lengthcount = H*W*3
+	int				samplefac;				// sampling factor 1..30
+	pixel			network[netsize];		// the network itself
+	int				netindex[256];			// for network lookup - really 256
+	int				bias [netsize];			// bias and freq arrays for learning
+	int				freq [netsize];
+	int				radpower[initrad];		// radpower for precomputation
+	ILint			alphadec;				// biased by 10 bits
+	int				netsizethink;			// number of colors we want to reduce to, 2-256
+} NeuQuant;
 
 // Initialise network in range (0,0,0) to (255,255,255) and set parameters
 // -----------------------------------------------------------------------
 
-void initnet(ILubyte *thepic, ILint len, ILint sample)	
+void initnet(NeuQuant *nq, ILubyte *thepic, ILint len, ILint sample)	
 {
 	ILint i;
 	ILint *p;
 	
-	thepicture = thepic;
-	lengthcount = len;
-	samplefac = sample;
+	nq->thepicture = thepic;
+	nq->lengthcount = len;
+	nq->samplefac = sample;
 	
-	for (i=0; i<netsizethink; i++) {
-		p = network[i];
+	for (i=0; i<nq->netsizethink; i++) {
+		p = nq->network[i];
 		p[0] = p[1] = p[2] = (i << (netbiasshift+8))/netsize;
-		freq[i] = intbias/netsizethink;	// 1/netsize
-		bias[i] = 0;
+		nq->freq[i] = intbias/nq->netsizethink;	// 1/netsize
+		nq->bias[i] = 0;
 	}
 	return;
 }
@@ -127,14 +124,14 @@ void initnet(ILubyte *thepic, ILint len, ILint sample)
 // Unbias network to give byte values 0..255 and record position i to prepare for sort
 // -----------------------------------------------------------------------------------
 
-void unbiasnet()
+void unbiasnet(NeuQuant *nq)
 {
 	ILint i,j;
 
-	for (i=0; i<netsizethink; i++) {
+	for (i=0; i<nq->netsizethink; i++) {
 		for (j=0; j<3; j++)
-			network[i][j] >>= netbiasshift;
-		network[i][3] = i;			// record colour no
+			nq->network[i][j] >>= netbiasshift;
+		nq->network[i][3] = i;			// record colour no
 	}
 	return;
 }
@@ -143,7 +140,7 @@ void unbiasnet()
 // Insertion sort of network and building of netindex[0..255] (to do after unbias)
 // -------------------------------------------------------------------------------
 
-void inxbuild()
+void inxbuild(NeuQuant *nq)
 {
 	ILint i,j,smallpos,smallval;
 	ILint *p,*q;
@@ -151,19 +148,19 @@ void inxbuild()
 
 	previouscol = 0;
 	startpos = 0;
-	for (i=0; i<netsizethink; i++) {
-		p = network[i];
+	for (i=0; i<nq->netsizethink; i++) {
+		p = nq->network[i];
 		smallpos = i;
 		smallval = p[1];			// index on g
 		// find smallest in i..netsize-1
-		for (j=i+1; j<netsizethink; j++) {
-			q = network[j];
+		for (j=i+1; j<nq->netsizethink; j++) {
+			q = nq->network[j];
 			if (q[1] < smallval) {	// index on g
 				smallpos = j;
 				smallval = q[1];	// index on g
 			}
 		}
-		q = network[smallpos];
+		q = nq->network[smallpos];
 		// swap p (i) and q (smallpos) entries
 		if (i != smallpos) {
 			j = q[0];   q[0] = p[0];   p[0] = j;
@@ -173,14 +170,14 @@ void inxbuild()
 		}
 		// smallval entry is now in position i
 		if (smallval != previouscol) {
-			netindex[previouscol] = (startpos+i)>>1;
-			for (j=previouscol+1; j<smallval; j++) netindex[j] = i;
+			nq->netindex[previouscol] = (startpos+i)>>1;
+			for (j=previouscol+1; j<smallval; j++) nq->netindex[j] = i;
 			previouscol = smallval;
 			startpos = i;
 		}
 	}
-	netindex[previouscol] = (startpos+maxnetpos)>>1;
-	for (j=previouscol+1; j<256; j++) netindex[j] = maxnetpos; // really 256
+	nq->netindex[previouscol] = (startpos+maxnetpos)>>1;
+	for (j=previouscol+1; j<256; j++) nq->netindex[j] = maxnetpos; // really 256
 	return;
 }
 
@@ -188,7 +185,7 @@ void inxbuild()
 // Search for BGR values 0..255 (after net is unbiased) and return colour index
 // ----------------------------------------------------------------------------
 
-ILubyte inxsearch(ILint b, ILint g, ILint r)
+ILubyte inxsearch(NeuQuant *nq, ILint b, ILint g, ILint r)
 {
 	ILint i,j,dist,a,bestd;
 	ILint *p;
@@ -196,14 +193,14 @@ ILubyte inxsearch(ILint b, ILint g, ILint r)
 
 	bestd = 1000;		// biggest possible dist is 256*3
 	best = -1;
-	i = netindex[g];	// index on g
+	i = nq->netindex[g];	// index on g
 	j = i-1;			// start at netindex[g] and work outwards
 
-	while ((i<netsizethink) || (j>=0)) {
-		if (i<netsizethink) {
-			p = network[i];
+	while ((i<nq->netsizethink) || (j>=0)) {
+		if (i<nq->netsizethink) {
+			p = nq->network[i];
 			dist = p[1] - g;		// inx key
-			if (dist >= bestd) i = netsizethink;	// stop iter
+			if (dist >= bestd) i = nq->netsizethink;	// stop iter
 			else {
 				i++;
 				if (dist<0) dist = -dist;
@@ -217,7 +214,7 @@ ILubyte inxsearch(ILint b, ILint g, ILint r)
 			}
 		}
 		if (j>=0) {
-			p = network[j];
+			p = nq->network[j];
 			dist = g - p[1]; // inx key - reverse dif
 			if (dist >= bestd) j = -1; // stop iter
 			else {
@@ -240,7 +237,7 @@ ILubyte inxsearch(ILint b, ILint g, ILint r)
 // Search for biased BGR values
 // ----------------------------
 
-ILint contest(ILint b, ILint g, ILint r)
+ILint contest(NeuQuant *nq, ILint b, ILint g, ILint r)
 {
 	// finds closest neuron (min dist) and updates freq
 	// finds best neuron (min dist-bias) and returns position
@@ -255,11 +252,11 @@ ILint contest(ILint b, ILint g, ILint r)
 	bestbiasd = bestd;
 	bestpos = -1;
 	bestbiaspos = bestpos;
-	p = bias;
-	f = freq;
+	p = nq->bias;
+	f = nq->freq;
 
-	for (i=0; i<netsizethink; i++) {
-		n = network[i];
+	for (i=0; i<nq->netsizethink; i++) {
+		n = nq->network[i];
 		dist = n[0] - b;   if (dist<0) dist = -dist;
 		a = n[1] - g;   if (a<0) a = -a;
 		dist += a;
@@ -272,8 +269,8 @@ ILint contest(ILint b, ILint g, ILint r)
 		*f++ -= betafreq;
 		*p++ += (betafreq<<gammashift);
 	}
-	freq[bestpos] += beta;
-	bias[bestpos] -= betagamma;
+	nq->freq[bestpos] += beta;
+	nq->bias[bestpos] -= betagamma;
 	return(bestbiaspos);
 }
 
@@ -281,11 +278,11 @@ ILint contest(ILint b, ILint g, ILint r)
 // Move neuron i towards biased (b,g,r) by factor alpha
 // ----------------------------------------------------
 
-void altersingle(ILint alpha, ILint i, ILint b, ILint g, ILint r)
+void altersingle(NeuQuant *nq, ILint alpha, ILint i, ILint b, ILint g, ILint r)
 {
 	ILint *n;
 
-	n = network[i];				// alter hit neuron
+	n = nq->network[i];				// alter hit neuron
 	*n -= (alpha*(*n - b)) / initalpha;
 	n++;
 	*n -= (alpha*(*n - g)) / initalpha;
@@ -298,21 +295,21 @@ void altersingle(ILint alpha, ILint i, ILint b, ILint g, ILint r)
 // Move adjacent neurons by precomputed alpha*(1-((i-j)^2/[r]^2)) in radpower[|i-j|]
 // ---------------------------------------------------------------------------------
 
-void alterneigh(ILint rad, ILint i, ILint b, ILint g, ILint r)
+void alterneigh(NeuQuant *nq, ILint rad, ILint i, ILint b, ILint g, ILint r)
 {
 	ILint j,k,lo,hi,a;
 	ILint *p, *q;
 
 	lo = i-rad;   if (lo<-1) lo=-1;
-	hi = i+rad;   if (hi>netsizethink) hi=netsizethink;
+	hi = i+rad;   if (hi>nq->netsizethink) hi=nq->netsizethink;
 
 	j = i+1;
 	k = i-1;
-	q = radpower;
+	q = nq->radpower;
 	while ((j<hi) || (k>lo)) {
 		a = (*(++q));
 		if (j<hi) {
-			p = network[j];
+			p = nq->network[j];
 			*p -= (a*(*p - b)) / alpharadbias;
 			p++;
 			*p -= (a*(*p - g)) / alpharadbias;
@@ -321,7 +318,7 @@ void alterneigh(ILint rad, ILint i, ILint b, ILint g, ILint r)
 			j++;
 		}
 		if (k>lo) {
-			p = network[k];
+			p = nq->network[k];
 			*p -= (a*(*p - b)) / alpharadbias;
 			p++;
 			*p -= (a*(*p - g)) / alpharadbias;
@@ -337,17 +334,17 @@ void alterneigh(ILint rad, ILint i, ILint b, ILint g, ILint r)
 // Main Learning Loop
 // ------------------
 
-void learn()
+void learn(NeuQuant *nq)
 {
 	ILint i,j,b,g,r;
 	ILint radius,rad,alpha,step,delta,samplepixels;
 	ILubyte *p;
 	ILubyte *lim;
 
-	alphadec = 30 + ((samplefac-1)/3);
-	p = thepicture;
-	lim = thepicture + lengthcount;
-	samplepixels = lengthcount/(3*samplefac);
+	nq->alphadec = 30 + ((nq->samplefac-1)/3);
+	p = nq->thepicture;
+	lim = nq->thepicture + nq->lengthcount;
+	samplepixels = nq->lengthcount/(3*nq->samplefac);
 	delta = samplepixels/ncycles;
 	alpha = initalpha;
 	radius = initradius;
@@ -355,15 +352,15 @@ void learn()
 	rad = radius >> radiusbiasshift;
 	if (rad <= 1) rad = 0;
 	for (i=0; i<rad; i++) 
-		radpower[i] = alpha*(((rad*rad - i*i)*radbias)/(rad*rad));
+		nq->radpower[i] = alpha*(((rad*rad - i*i)*radbias)/(rad*rad));
 	
 	// beginning 1D learning: initial radius=rad
 
-	if ((lengthcount%prime1) != 0) step = 3*prime1;
+	if ((nq->lengthcount%prime1) != 0) step = 3*prime1;
 	else {
-		if ((lengthcount%prime2) !=0) step = 3*prime2;
+		if ((nq->lengthcount%prime2) !=0) step = 3*prime2;
 		else {
-			if ((lengthcount%prime3) !=0) step = 3*prime3;
+			if ((nq->lengthcount%prime3) !=0) step = 3*prime3;
 			else step = 3*prime4;
 		}
 	}
@@ -373,22 +370,22 @@ void learn()
 		b = p[0] << netbiasshift;
 		g = p[1] << netbiasshift;
 		r = p[2] << netbiasshift;
-		j = contest(b,g,r);
+		j = contest(nq,b,g,r);
 
-		altersingle(alpha,j,b,g,r);
-		if (rad) alterneigh(rad,j,b,g,r);   // alter neighbours
+		altersingle(nq,alpha,j,b,g,r);
+		if (rad) alterneigh(nq,rad,j,b,g,r);   // alter neighbours
 
 		p += step;
-		if (p >= lim) p -= lengthcount;
+		if (p >= lim) p -= nq->lengthcount;
 	
 		i++;
 		if (i%delta == 0) {	
-			alpha -= alpha / alphadec;
+			alpha -= alpha / nq->alphadec;
 			radius -= radius / radiusdec;
 			rad = radius >> radiusbiasshift;
 			if (rad <= 1) rad = 0;
 			for (j=0; j<rad; j++) 
-				radpower[j] = alpha*(((rad*rad - j*j)*radbias)/(rad*rad));
+				nq->radpower[j] = alpha*(((rad*rad - j*j)*radbias)/(rad*rad));
 		}
 	}
 	// finished 1D learning: final alpha=alpha/initalpha;
@@ -400,8 +397,10 @@ ILimage *iNeuQuant(ILcontext* context, ILimage *Image, ILuint NumCols)
 {
 	ILimage	*TempImage, *NewImage;
 	ILuint	sample, i, j;
+	NeuQuant	State, *nq = &State;
 
-	netsizethink=NumCols;
+	imemclear(nq, sizeof(NeuQuant));
+	nq->netsizethink=NumCols;
 
 	NewImage = context->impl->iCurImage;
 	context->impl->iCurImage = Image;
@@ -412,19 +411,19 @@ ILimage *iNeuQuant(ILcontext* context, ILimage *Image, ILuint NumCols)
 	if (TempImage == NULL)
 		return NULL;
 
-	initnet(TempImage->Data, TempImage->SizeOfData, sample);
-	learn();
-	unbiasnet();
+	initnet(nq, TempImage->Data, TempImage->SizeOfData, sample);
+	learn(nq);
+	unbiasnet(nq);
 
 	NewImage = (ILimage*)icalloc(context, sizeof(ILimage), 1);
 	if (NewImage == NULL) {
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 		return NULL;
 	}
 	NewImage->Data = (ILubyte*)ialloc(context, TempImage->SizeOfData / 3);
 	if (NewImage->Data == NULL) {
-		ilCloseImage(TempImage);
-		ifree(NewImage);
+		ilCloseImage(context, TempImage);
+		ifree(context, NewImage);
 		return NULL;
 	}
 	ilCopyImageAttr(context, NewImage, Image);
@@ -435,28 +434,28 @@ ILimage *iNeuQuant(ILcontext* context, ILimage *Image, ILuint NumCols)
 	NewImage->Format = IL_COLOUR_INDEX;
 	NewImage->Type = IL_UNSIGNED_BYTE;
 
-	NewImage->Pal.PalSize = netsizethink * 3;
+	NewImage->Pal.PalSize = nq->netsizethink * 3;
 	NewImage->Pal.PalType = IL_PAL_BGR24;
 	NewImage->Pal.Palette = (ILubyte*)ialloc(context, 256*3);
 	if (NewImage->Pal.Palette == NULL) {
-		ilCloseImage(TempImage);
-		ilCloseImage(NewImage);
+		ilCloseImage(context, TempImage);
+		ilCloseImage(context, NewImage);
 		return NULL;
 	}
 
-	for (i = 0, j = 0; i < (unsigned)netsizethink; i++, j += 3) {
-		NewImage->Pal.Palette[j  ] = network[i][0];
-		NewImage->Pal.Palette[j+1] = network[i][1];
-		NewImage->Pal.Palette[j+2] = network[i][2];
+	for (i = 0, j = 0; i < (unsigned)nq->netsizethink; i++, j += 3) {
+		NewImage->Pal.Palette[j  ] = nq->network[i][0];
+		NewImage->Pal.Palette[j+1] = nq->network[i][1];
+		NewImage->Pal.Palette[j+2] = nq->network[i][2];
 	}
 
-	inxbuild();
+	inxbuild(nq);
 	for (i = 0, j = 0; j < TempImage->SizeOfData; i++, j += 3) {
-		NewImage->Data[i] = inxsearch(
+		NewImage->Data[i] = inxsearch(nq,
 			TempImage->Data[j], TempImage->Data[j+1], TempImage->Data[j+2]);
 	}
 
-	ilCloseImage(TempImage);
+	ilCloseImage(context, TempImage);
 
 	return NewImage;
 }
@@ -139,7 +139,7 @@ ILboolean PalHandler::load(ILconst_string FileName)
 	}
 
 	if (context->impl->iCurImage->Pal.Palette && context->impl->iCurImage->Pal.PalSize > 0 && context->impl->iCurImage->Pal.PalType != IL_PAL_NONE) {
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 		context->impl->iCurImage->Pal.Palette = NULL;
 	}
 
@@ -298,7 +298,7 @@ ILboolean PalHandler::save(ILconst_string FileName)
 
 	memcpy(context->impl->iCurImage->Pal.Palette, CurPal, context->impl->iCurImage->Pal.PalSize);
 	if (!ilConvertPal(context, IL_PAL_RGB24)) {
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 		context->impl->iCurImage->Pal.Palette = CurPal;
 		return IL_FALSE;
 	}
@@ -327,7 +327,7 @@ ILboolean PalHandler::save(ILconst_string FileName)
 		fprintf(PalFile, "0 0 0\n");
 	}
 
-	ifree(context->impl->iCurImage->Pal.Palette);
+	ifree(context, context->impl->iCurImage->Pal.Palette);
 	context->impl->iCurImage->Pal.Palette = CurPal;
 
 	fclose(PalFile);
@@ -377,12 +377,12 @@ ILboolean ilLoadHaloPal(ILcontext* context, ILconst_string FileName)
 
 	if (context->impl->iread(context, TempPal, sizeof(ILushort), Size) != Size) {
 		context->impl->icloser(HaloFile);
-		ifree(TempPal);
+		ifree(context, TempPal);
 		return IL_FALSE;
 	}
 
 	if (context->impl->iCurImage->Pal.Palette && context->impl->iCurImage->Pal.PalSize > 0 && context->impl->iCurImage->Pal.PalType != IL_PAL_NONE) {
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 		context->impl->iCurImage->Pal.Palette = NULL;
 	}
 	context->impl->iCurImage->Pal.PalType = IL_PAL_RGB24;
@@ -397,7 +397,7 @@ ILboolean ilLoadHaloPal(ILcontext* context, ILconst_string FileName)
 		context->impl->iCurImage->Pal.Palette[i] = (ILubyte)*TempPal;
 	}
 	TempPal -= context->impl->iCurImage->Pal.PalSize;
-	ifree(TempPal);
+	ifree(context, TempPal);
 
 	context->impl->icloser(HaloFile);
 
@@ -428,7 +428,7 @@ ILboolean ilLoadColPal(ILcontext* context, ILconst_string FileName)
 	}
 
 	if (context->impl->iCurImage->Pal.Palette && context->impl->iCurImage->Pal.PalSize > 0 && context->impl->iCurImage->Pal.PalType != IL_PAL_NONE) {
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 		context->impl->iCurImage->Pal.Palette = NULL;
 	}
 
@@ -471,7 +471,7 @@ ILboolean ilLoadColPal(ILcontext* context, ILconst_string FileName)
 
 	if (context->impl->iread(context, context->impl->iCurImage->Pal.Palette, 1, 768) != 768) {
 		context->impl->icloser(ColFile);
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 		context->impl->iCurImage->Pal.Palette = NULL;
 		return IL_FALSE;
 	}
@@ -506,7 +506,7 @@ ILboolean ilLoadActPal(ILcontext* context, ILconst_string FileName)
 	}
 
 	if (context->impl->iCurImage->Pal.Palette && context->impl->iCurImage->Pal.PalSize > 0 && context->impl->iCurImage->Pal.PalType != IL_PAL_NONE) {
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 		context->impl->iCurImage->Pal.Palette = NULL;
 	}
 
@@ -550,7 +550,7 @@ ILboolean ilLoadPltPal(ILcontext* context, ILconst_string FileName)
 	}
 
 	if (context->impl->iCurImage->Pal.Palette && context->impl->iCurImage->Pal.PalSize > 0 && context->impl->iCurImage->Pal.PalType != IL_PAL_NONE) {
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 		context->impl->iCurImage->Pal.Palette = NULL;
 	}
 
@@ -567,7 +567,7 @@ ILboolean ilLoadPltPal(ILcontext* context, ILconst_string FileName)
 	}
 
 	if (context->impl->iread(context, context->impl->iCurImage->Pal.Palette, context->impl->iCurImage->Pal.PalSize, 1) != 1) {
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 		context->impl->iCurImage->Pal.Palette = NULL;
 		context->impl->icloser(PltFile);
 		return IL_FALSE;
@@ -611,7 +611,7 @@ ILAPI ILpal* ILAPIENTRY iCopyPal(ILcontext* context)
 		return NULL;
 	}
 	if (!iCopyPalette(context, Pal, &context->impl->iCurImage->Pal)) {
-		ifree(Pal);
+		ifree(context, Pal);
 		return NULL;
 	}
 
@@ -870,7 +870,7 @@ ILAPI ILpal* ILAPIENTRY iConvertPal(ILcontext* context, ILpal *Pal, ILenum DestF
 	return NewPal;
 
 alloc_error:
-	ifree(NewPal);
+	ifree(context, NewPal);
 	return NULL;
 }
 
@@ -889,7 +889,7 @@ ILboolean ILAPIENTRY ilConvertPal(ILcontext* context, ILenum DestFormat)
 	if (Pal == NULL)
 		return IL_FALSE;
 
-	ifree(context->impl->iCurImage->Pal.Palette);
+	ifree(context, context->impl->iCurImage->Pal.Palette);
 	context->impl->iCurImage->Pal.PalSize = Pal->PalSize;
 	context->impl->iCurImage->Pal.PalType = Pal->PalType;
 
@@ -899,8 +899,8 @@ ILboolean ILAPIENTRY ilConvertPal(ILcontext* context, ILenum DestFormat)
 	}
 	memcpy(context->impl->iCurImage->Pal.Palette, Pal->Palette, Pal->PalSize);
 
-	ifree(Pal->Palette);
-	ifree(Pal);
+	ifree(context, Pal->Palette);
+	ifree(context, Pal);
 	
 	return IL_TRUE;
 }
@@ -909,7 +909,7 @@ ILboolean ILAPIENTRY ilConvertPal(ILcontext* context, ILenum DestFormat)
 ILAPI void ILAPIENTRY ilSetPal(ILcontext* context, ILpal *Pal)
 {
 	if (context->impl->iCurImage->Pal.Palette && context->impl->iCurImage->Pal.PalSize && context->impl->iCurImage->Pal.PalType != IL_PAL_NONE) {
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 	}
 
 	if (Pal->Palette && Pal->PalSize && Pal->PalType != IL_PAL_NONE) {
@@ -929,7 +929,8 @@ ILAPI void ILAPIENTRY ilSetPal(ILcontext* context, ILpal *Pal)
 	return;
 }
 
-ILuint CurSort = 0;
+// Only used by the disabled colour cube code in ilApplyPal.
+/*ILuint CurSort = 0;
 typedef struct COL_CUBE
 {
 	ILubyte	Min[3];
@@ -940,7 +941,7 @@ typedef struct COL_CUBE
 int sort_func(void *e1, void *e2)
 {
 	return ((COL_CUBE*)e1)->Val[CurSort] - ((COL_CUBE*)e2)->Val[CurSort];
-}
+}*/
 
 ILboolean ILAPIENTRY ilApplyPal(ILcontext* context, ILconst_string FileName)
 {
@@ -966,7 +967,7 @@ ILboolean ILAPIENTRY ilApplyPal(ILcontext* context, ILconst_string FileName)
 	imemclear(&Image, sizeof(ILimage));
 	// IL_PAL_RGB24, because we don't want to make parts transparent that shouldn't be.
 	if (!ilLoadPal(context, FileName) || !ilConvertPal(context, IL_PAL_RGB24)) {
-		ifree(NewData);
+		ifree(context, NewData);
 		context->impl->iCurImage = CurImage;
 		return IL_FALSE;
 	}
@@ -974,7 +975,7 @@ ILboolean ILAPIENTRY ilApplyPal(ILcontext* context, ILconst_string FileName)
 	NumColours = Image.Pal.PalSize / 3;  // RGB24 is 3 bytes per entry.
 	PalInfo = (ILuint*)ialloc(context, NumColours * sizeof(ILuint));
 	if (PalInfo == NULL) {
-		ifree(NewData);
+		ifree(context, NewData);
 		context->impl->iCurImage = CurImage;
 		return IL_FALSE;
 	}
@@ -985,8 +986,8 @@ ILboolean ILAPIENTRY ilApplyPal(ILcontext* context, ILconst_string FileName)
 		case IL_COLOUR_INDEX:
 			context->impl->iCurImage = CurImage;
 			if (!ilConvertPal(context, IL_PAL_RGB24)) {
-				ifree(NewData);
-				ifree(PalInfo);
+				ifree(context, NewData);
+				ifree(context, PalInfo);
 				return IL_FALSE;
 			}
 
@@ -1125,9 +1126,9 @@ ILboolean ILAPIENTRY ilApplyPal(ILcontext* context, ILconst_string FileName)
 	Origin = context->impl->iCurImage->Origin;
 	if (!ilTexImage(context, context->impl->iCurImage->Width, context->impl->iCurImage->Height, context->impl->iCurImage->Depth, 1,
 		IL_COLOUR_INDEX, IL_UNSIGNED_BYTE, NewData)) {
-		ifree(Image.Pal.Palette);
-		ifree(PalInfo);
-		ifree(NewData);
+		ifree(context, Image.Pal.Palette);
+		ifree(context, PalInfo);
+		ifree(context, NewData);
 		return IL_FALSE;
 	}
 	context->impl->iCurImage->Origin = Origin;
@@ -1135,8 +1136,8 @@ ILboolean ILAPIENTRY ilApplyPal(ILcontext* context, ILconst_string FileName)
 	context->impl->iCurImage->Pal.Palette = Image.Pal.Palette;
 	context->impl->iCurImage->Pal.PalSize = Image.Pal.PalSize;
 	context->impl->iCurImage->Pal.PalType = Image.Pal.PalType;
-	ifree(PalInfo);
-	ifree(NewData);
+	ifree(context, PalInfo);
+	ifree(context, NewData);
 
 	return IL_TRUE;
 }
\ No newline at end of file
@@ -146,16 +146,16 @@ ILboolean PcdHandler::loadInternal()
 			return IL_FALSE;
 	}
 
-	if (context->impl->itell(context) == IL_EOF)  // Supposed to have data here.
+	if (context->impl->ieof(context))  // Supposed to have data here.
 		return IL_FALSE;
 
 	Y1 = (ILubyte*)ialloc(context, Width);
 	Y2 = (ILubyte*)ialloc(context, Width);
 	CbCr = (ILubyte*)ialloc(context, Width);
 	if (Y1 == NULL || Y2 == NULL || CbCr == NULL) {
-		ifree(Y1);
-		ifree(Y2);
-		ifree(CbCr);
+		ifree(context, Y1);
+		ifree(context, Y2);
+		ifree(context, CbCr);
 		return IL_FALSE;
 	}
 
@@ -169,9 +169,9 @@ ILboolean PcdHandler::loadInternal()
 		context->impl->iread(context, Y1, 1, Width);
 		context->impl->iread(context, Y2, 1, Width);
 		if (context->impl->iread(context, CbCr, 1, Width) != Width) {  // Only really need to check the last one.
-			ifree(Y1);
-			ifree(Y2);
-			ifree(CbCr);
+			ifree(context, Y1);
+			ifree(context, Y2);
+			ifree(context, CbCr);
 			return IL_FALSE;
 		}
 
@@ -190,9 +190,9 @@ ILboolean PcdHandler::loadInternal()
 		}
 	}
 
-	ifree(Y1);
-	ifree(Y2);
-	ifree(CbCr);
+	ifree(context, Y1);
+	ifree(context, Y2);
+	ifree(context, CbCr);
 
 	// Not sure how it is...the documentation is hard to understand
 	if ((VertOrientation & 0x3F) != 8)
@@ -105,10 +105,10 @@ ILboolean PcxHandler::isValidL(const void *Lump, ILuint Size)
 // Internal function obtain the .pcx header from the current file.
 ILboolean iGetPcxHead(ILcontext* context, PCXHEAD *Head)
 {
-	Head->Manufacturer = context->impl->igetc(context);
-	Head->Version = context->impl->igetc(context);
-	Head->Encoding = context->impl->igetc(context);
-	Head->Bpp = context->impl->igetc(context);
+	Head->Manufacturer = iGetcFast(context);
+	Head->Version = iGetcFast(context);
+	Head->Encoding = iGetcFast(context);
+	Head->Bpp = iGetcFast(context);
 	Head->Xmin = GetLittleUShort(context);
 	Head->Ymin = GetLittleUShort(context);
 	Head->Xmax = GetLittleUShort(context);
@@ -116,8 +116,8 @@ ILboolean iGetPcxHead(ILcontext* context, PCXHEAD *Head)
 	Head->HDpi = GetLittleUShort(context);
 	Head->VDpi = GetLittleUShort(context);
 	context->impl->iread(context, Head->ColMap, 1, 48);
-	Head->Reserved = context->impl->igetc(context);
-	Head->NumPlanes = context->impl->igetc(context);
+	Head->Reserved = iGetcFast(context);
+	Head->NumPlanes = iGetcFast(context);
 	Head->Bps = GetLittleUShort(context);
 	Head->PaletteInfo = GetLittleUShort(context);
 	Head->HScreenSize = GetLittleUShort(context);
@@ -355,7 +355,7 @@ ILboolean iUncompressPcx(ILcontext* context, PCXHEAD *Header)
 			ilGetError(context);  // Get rid of the IL_FILE_READ_ERROR.
 			context->impl->iCurImage->Format = IL_LUMINANCE;
 			if (context->impl->iCurImage->Pal.Palette)
-				ifree(context->impl->iCurImage->Pal.Palette);
+				ifree(context, context->impl->iCurImage->Pal.Palette);
 			context->impl->iCurImage->Pal.PalSize = 0;
 			context->impl->iCurImage->Pal.PalType = IL_PAL_NONE;
 		}
@@ -367,12 +367,12 @@ ILboolean iUncompressPcx(ILcontext* context, PCXHEAD *Header)
 		}
 	}
 
-	ifree(ScanLine);
+	ifree(context, ScanLine);
 
 	return IL_TRUE;
 
 file_read_error:
-	ifree(ScanLine);
+	ifree(context, ScanLine);
 
 	//added 2003-09-01
 	ilSetError(context, IL_FILE_READ_ERROR);
@@ -439,7 +439,7 @@ ILboolean iUncompressSmall(ILcontext* context, PCXHEAD *Header)
 			//one pad byte has to be read otherwise.
 			//(let's hope the above is true ;-))
 			if(!((context->impl->iCurImage->Width >> 3) & 0x1))
-				context->impl->igetc(context);	// Skip pad byte
+				iGetcFast(context);	// Skip pad byte
 		}
 	}
 	else if (Header->NumPlanes == 4 && Header->Bpp == 1){   // 4-bit images
@@ -449,8 +449,8 @@ ILboolean iUncompressSmall(ILcontext* context, PCXHEAD *Header)
 		context->impl->iCurImage->Pal.Palette = (ILubyte*)ialloc(context, 16 * 3);  // Size of palette always (48 bytes).
 		ScanLine = (ILubyte*)ialloc(context, Bps);
 		if (context->impl->iCurImage->Pal.Palette == NULL || ScanLine == NULL) {
-			ifree(ScanLine);
-			ifree(context->impl->iCurImage->Pal.Palette);
+			ifree(context, ScanLine);
+			ifree(context, context->impl->iCurImage->Pal.Palette);
 			return IL_FALSE;
 		}
 		memcpy(context->impl->iCurImage->Pal.Palette, Header->ColMap, 16 * 3);
@@ -466,14 +466,14 @@ ILboolean iUncompressSmall(ILcontext* context, PCXHEAD *Header)
 			while (x < Bps) {
 				if (context->impl->iread(context, &HeadByte, 1, 1) != 1) {
 					iUnCache(context);
-					ifree(ScanLine);
+					ifree(context, ScanLine);
 					return IL_FALSE;
 				}
 				if ((HeadByte & 0xC0) == 0xC0) {
 					HeadByte &= 0x3F;
 					if (context->impl->iread(context, &Colour, 1, 1) != 1) {
 						iUnCache(context);
-						ifree(ScanLine);
+						ifree(context, ScanLine);
 						return IL_FALSE;
 					}
 					for (i = 0; i < HeadByte; i++) {
@@ -499,7 +499,7 @@ ILboolean iUncompressSmall(ILcontext* context, PCXHEAD *Header)
 			}
 		}
 		iUnCache(context);
-		ifree(ScanLine);
+		ifree(context, ScanLine);
 	}
 	else {
 		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
@@ -603,7 +603,7 @@ ILboolean PcxHandler::saveInternal()
 		TempData = iGetFlipped(context, TempImage);
 		if (TempData == NULL) {
 			if (TempImage != context->impl->iCurImage) {
-				ilCloseImage(TempImage);
+				ilCloseImage(context, TempImage);
 			}
 			return IL_FALSE;
 		}
@@ -661,15 +661,15 @@ ILboolean PcxHandler::saveInternal()
 			TempPal = iConvertPal(context, &TempImage->Pal, IL_PAL_RGB24);
 			if (TempPal == NULL) {
 				if (TempImage->Origin == IL_ORIGIN_LOWER_LEFT)
-					ifree(TempData);
+					ifree(context, TempData);
 				if (TempImage != context->impl->iCurImage)
-					ilCloseImage(TempImage);
+					ilCloseImage(context, TempImage);
 				return IL_FALSE;
 			}
 
 			context->impl->iwrite(context, TempPal->Palette, 1, TempPal->PalSize);
-			ifree(TempPal->Palette);
-			ifree(TempPal);
+			ifree(context, TempPal->Palette);
+			ifree(context, TempPal);
 		}
 	}
 
@@ -680,9 +680,9 @@ ILboolean PcxHandler::saveInternal()
 	}
 
 	if (TempImage->Origin == IL_ORIGIN_LOWER_LEFT)
-		ifree(TempData);
+		ifree(context, TempData);
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return IL_TRUE;
 }
@@ -243,7 +243,7 @@ ILboolean PicHandler::loadInternal()
 				while (Channel) {
 					Prev = Channel;
 					Channel = (CHANNEL*)Channel->Next;
-					ifree(Prev);
+					ifree(context, Prev);
 				}
 				return IL_FALSE;
 			}
@@ -287,7 +287,7 @@ finish:
 	while (Channel) {
 		Prev = Channel;
 		Channel = (CHANNEL*)Channel->Next;
-		ifree(Prev);
+		ifree(context, Prev);
 	}
 
 	if (Read == IL_FALSE)
@@ -16,7 +16,9 @@
 #include "il_png.h"
 
 #ifndef IL_NO_PNG
+#include "il_threads.h"
 #include <stdlib.h>
+#include <zlib.h>
 #if PNG_LIBPNG_VER < 10200
 	#warning DevIL was designed with libpng 1.2.0 or higher in mind.  Consider upgrading at www.libpng.org.
 #endif
@@ -41,6 +43,12 @@ PngHandler::PngHandler(ILcontext* context) :
 
 }
 
+// Frees the png structs if decoding was abandoned (ilPushEnd was never called)
+PngHandler::~PngHandler()
+{
+	readpng_cleanup();
+}
+
 ILboolean PngHandler::isValid(ILconst_string FileName)
 {
 	ILHANDLE	PngFile;
@@ -93,6 +101,86 @@ ILboolean PngHandler::isValidInternal()
 	return !png_sig_cmp(Signature, 0, 8);  // DW 5/2/2016: They changed the behavior of this function?
 }
 
+// Reads the image properties from an already-opened file without decoding the pixels
+ILboolean PngHandler::getInfoF(ILHANDLE File, ILimageinfo *Info)
+{
+	ILuint64	FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = getInfoInternal(Info);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+// Reads the image properties from a memory "lump" without decoding the pixels
+ILboolean PngHandler::getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info)
+{
+	iSetInputLump(context, Lump, Size);
+	return getInfoInternal(Info);
+}
+
+// Reads every chunk up to IDAT and works out the format readpng_get_image would give.
+ILboolean PngHandler::getInfoInternal(ILimageinfo *Info)
+{
+	png_uint_32	width, height;
+	ILint		bit_depth, color_type;
+	ILboolean	HasTrans;
+
+	png_ptr = NULL;
+	info_ptr = NULL;
+
+	if (!isValidInternal()) {
+		ilSetError(context, IL_INVALID_FILE_HEADER);
+		return IL_FALSE;
+	}
+	if (readpng_init())
+		return IL_FALSE;
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+		return IL_FALSE;
+	}
+
+	png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, NULL, NULL, NULL);
+	// tRNS is expanded to an alpha channel for everything but paletted images.
+	HasTrans = png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) && !png_get_valid(png_ptr, info_ptr, PNG_INFO_PLTE);
+
+	switch (color_type)
+	{
+		case PNG_COLOR_TYPE_PALETTE:
+			Info->Format = IL_COLOUR_INDEX;
+			break;
+		case PNG_COLOR_TYPE_GRAY:
+			Info->Format = HasTrans ? IL_LUMINANCE_ALPHA : IL_LUMINANCE;
+			break;
+		case PNG_COLOR_TYPE_GRAY_ALPHA:
+			Info->Format = IL_LUMINANCE_ALPHA;
+			break;
+		case PNG_COLOR_TYPE_RGB:
+			Info->Format = HasTrans ? IL_RGBA : IL_RGB;
+			break;
+		case PNG_COLOR_TYPE_RGB_ALPHA:
+			Info->Format = IL_RGBA;
+			break;
+		default:
+			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
+			readpng_cleanup();
+			return IL_FALSE;
+	}
+
+	Info->Width = width;
+	Info->Height = height;
+	Info->Depth = 1;
+	Info->Type = bit_depth == 16 ? IL_UNSIGNED_SHORT : IL_UNSIGNED_BYTE;
+	Info->HasProfile = png_get_valid(png_ptr, info_ptr, PNG_INFO_iCCP) ? IL_TRUE : IL_FALSE;
+
+	readpng_cleanup();
+	return IL_TRUE;
+}
+
 // Reads a file
 ILboolean PngHandler::load(ILconst_string FileName)
 {
@@ -156,6 +244,76 @@ ILboolean PngHandler::loadInternal()
 	return ilFixImage(context);
 }
 
+// Reads an already-opened file and gives its rows to Sink (ilLoadRows)
+ILboolean PngHandler::loadRowsF(ILHANDLE File, iRowSink *Sink)
+{
+	ILuint		FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = loadRowsInternal(Sink);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+// Reads from a memory "lump" and gives its rows to Sink (ilLoadRows)
+ILboolean PngHandler::loadRowsL(const void *Lump, ILuint Size, iRowSink *Sink)
+{
+	iSetInputLump(context, Lump, Size);
+	return loadRowsInternal(Sink);
+}
+
+// Rows of a non-interlaced png are decoded one at a time into the band that
+//  goes to the sink, with palettes expanded.  Interlaced pngs need the whole
+//  image for their passes, so they are left to ilLoad.
+ILboolean PngHandler::loadRowsInternal(iRowSink *Sink)
+{
+	png_uint_32	width, height, y;
+	ILenum		format, type;
+	png_bytep	Row;
+
+	png_ptr = NULL;
+	info_ptr = NULL;
+
+	if (!isValidInternal()) {
+		ilSetError(context, IL_INVALID_VALUE);
+		return IL_FALSE;
+	}
+	if (readpng_init())
+		return IL_FALSE;
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		readpng_cleanup();
+		return IL_FALSE;
+	}
+
+	if (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE) {
+		readpng_cleanup();
+		Sink->Whole = IL_TRUE;
+		return IL_FALSE;
+	}
+
+	if (!readpng_transform(&width, &height, &format, &type, IL_TRUE)
+		|| !iSinkBegin(context, Sink, width, height, format, type)) {
+		readpng_cleanup();
+		return IL_FALSE;
+	}
+
+	for (y = 0; y < height; y++) {
+		Row = iSinkRows(context, Sink, 1);
+		if (Row == NULL) {
+			readpng_cleanup();
+			return IL_FALSE;
+		}
+		png_read_row(png_ptr, Row, NULL);
+	}
+
+	readpng_cleanup();
+	return IL_TRUE;
+}
+
 static void png_read(png_structp png_ptr, png_bytep data, png_size_t length)
 {
 	ILcontext* context = (ILcontext*)png_get_io_ptr(png_ptr);
@@ -232,27 +390,20 @@ ILint PngHandler::readpng_init()
 
 /* display_exponent == LUT_exponent * CRT_exponent */
 
-ILboolean PngHandler::readpng_get_image(ILdouble display_exponent)
+// Sets up the transforms once the header has been read and says what the
+//  rows will be.  Palettes are kept, unless ExpandPalette is set to have
+//  libpng give their colours instead.  The caller's setjmp catches libpng
+//  errors.
+ILboolean PngHandler::readpng_transform(png_uint_32 *Width, png_uint_32 *Height, ILenum *Format, ILenum *Type, ILboolean ExpandPalette)
 {
-	png_bytepp	row_pointers = NULL;
 	png_uint_32 width, height; // Changed the type to fix AMD64 bit problems, thanks to Eric Werness
 	ILdouble	screen_gamma = 1.0;
-	ILuint		i, channels;
 	ILenum		format;
-	png_colorp	palette;
-	ILint		num_palette, j, bit_depth;
+	ILint		bit_depth;
 #if _WIN32 || DJGPP
 	ILdouble image_gamma;
 #endif
 
-	/* setjmp() must be called in every function that calls a PNG-reading
-	 * libpng function */
-
-	if (setjmp(png_jmpbuf(png_ptr))) {
-		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-		return IL_FALSE;
-	}
-
 	png_get_IHDR(png_ptr, info_ptr, (png_uint_32*)&width, (png_uint_32*)&height,
 	             &bit_depth, &png_color_type, NULL, NULL, NULL);
 
@@ -266,6 +417,11 @@ ILboolean PngHandler::readpng_get_image(ILdouble display_exponent)
  	// But don't expand paletted images, since we want alpha palettes!
 	if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) && !(png_get_valid(png_ptr, info_ptr, PNG_INFO_PLTE)))
 		png_set_tRNS_to_alpha(png_ptr);
+	else if (ExpandPalette && png_color_type == PNG_COLOR_TYPE_PALETTE) {
+		png_set_palette_to_rgb(png_ptr);
+		if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+			png_set_tRNS_to_alpha(png_ptr);
+	}
 
 	//refresh information (added 20040224)
 	png_get_IHDR(png_ptr, info_ptr, (png_uint_32*)&width, (png_uint_32*)&height,
@@ -292,9 +448,10 @@ ILboolean PngHandler::readpng_get_image(ILdouble display_exponent)
 		png_set_swap(png_ptr);
 #endif
 
+	// Rows of interlaced images come out once per pass
+	png_set_interlace_handling(png_ptr);
 
 	png_read_update_info(png_ptr, info_ptr);
-	channels = (ILint)png_get_channels(png_ptr, info_ptr);
 	//added 20040224: update png_color_type so that it has the correct value
 	//in iLoadPngInternal (globals rule...)
 	png_color_type = png_get_color_type(png_ptr, info_ptr);
@@ -319,14 +476,42 @@ ILboolean PngHandler::readpng_get_image(ILdouble display_exponent)
 			break;
 		default:
 			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
-			png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 			return IL_FALSE;
 	}
 
-	if (!ilTexImage(context, width, height, 1, (ILubyte)channels, format, ilGetTypeBpc((ILubyte)(bit_depth >> 3)), NULL)) {
-		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+	*Width = width;
+	*Height = height;
+	*Format = format;
+	*Type = ilGetTypeBpc((ILubyte)(bit_depth >> 3));
+	return IL_TRUE;
+}
+
+// Sets up the transforms once the header has been read and creates the image
+//  (and its palette) the rows are read into.  The caller's setjmp catches
+//  libpng errors.
+ILboolean PngHandler::readpng_setup()
+{
+	png_uint_32	width, height;
+	ILenum		format, type;
+	png_colorp	palette;
+	ILint		num_palette, j;
+
+	if (!readpng_transform(&width, &height, &format, &type, IL_FALSE))
 		return IL_FALSE;
+
+	// Rows of non-interlaced images are decoded in order, so ilLoadRegion can
+	//	stop after the rectangle's last one.
+	readRegion = IL_FALSE;
+	if (png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE && iRegionActive(context)) {
+		if (!iRegionClaim(context, width, height))
+			return IL_FALSE;
+		width = context->impl->RegionW;
+		height = context->impl->RegionH;
+		readRegion = IL_TRUE;
 	}
+
+	if (!ilTexImage(context, width, height, 1, png_get_channels(png_ptr, info_ptr), format, type, NULL))
+		return IL_FALSE;
 	context->impl->iCurImage->Origin = IL_ORIGIN_UPPER_LEFT;
 
 	//copy palette
@@ -336,7 +521,6 @@ ILboolean PngHandler::readpng_get_image(ILdouble display_exponent)
 		int  num_trans = -1;
 		if (!png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette)) {
 			ilSetError(context, IL_ILLEGAL_FILE_VALUE);
-			png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 			return IL_FALSE;
 		}
 
@@ -366,6 +550,49 @@ ILboolean PngHandler::readpng_get_image(ILdouble display_exponent)
 		}
 	}
 
+	return IL_TRUE;
+}
+
+ILboolean PngHandler::readpng_get_image(ILdouble display_exponent)
+{
+	png_bytepp	row_pointers = NULL;
+	png_bytep volatile row = NULL;
+	ILuint		i, height;
+
+	/* setjmp() must be called in every function that calls a PNG-reading
+	 * libpng function */
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		ifree(context, row);
+		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+		return IL_FALSE;
+	}
+
+	if (!readpng_setup()) {
+		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+		return IL_FALSE;
+	}
+	height = context->impl->iCurImage->Height;
+
+	// Whole rows are decoded through a scratch row down to the region's last.
+	if (readRegion) {
+		ILimage	*Image = context->impl->iCurImage;
+		ILuint	XOff = context->impl->RegionX * Image->Bpp * Image->Bpc, YOff = context->impl->RegionY;
+
+		row = (png_bytep)ialloc(context, (ILuint)png_get_rowbytes(png_ptr, info_ptr));
+		if (row == NULL) {
+			png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+			return IL_FALSE;
+		}
+		for (i = 0; i < YOff + height; i++) {
+			png_read_row(png_ptr, row, NULL);
+			if (i >= YOff)
+				memcpy(Image->Data + (ILsizei)(i - YOff) * Image->Bps, row + XOff, Image->Bps);
+		}
+		ifree(context, row);
+		return IL_TRUE;
+	}
+
 	//allocate row pointers
 	if ((row_pointers = (png_bytepp)ialloc(context, height * sizeof(png_bytep))) == NULL) {
 		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
@@ -385,7 +612,7 @@ ILboolean PngHandler::readpng_get_image(ILdouble display_exponent)
 	/* and we're done!	(png_read_end() can be omitted if no processing of
 	 * post-IDAT text/time/etc. is desired) */
 	//png_read_end(png_ptr, NULL);
-	ifree(row_pointers);
+	ifree(context, row_pointers);
 
 	return IL_TRUE;
 }
@@ -399,6 +626,110 @@ void PngHandler::readpng_cleanup()
 	}
 }
 
+
+//
+// Push decoding, with libpng's progressive reader.  The context is libpng's
+//  progressive (io) pointer, so png_error_func works as for normal loading.
+//
+
+void PngHandler::push_info(png_structp png_ptr, png_infop info_ptr)
+{
+	ILcontext	*context = (ILcontext*)png_get_progressive_ptr(png_ptr);
+	PngHandler	*handler = context->impl->PushPng;
+
+	(void)info_ptr;  // readpng_setup uses the handler's own info_ptr.
+	if (!handler->readpng_setup())
+		png_error(png_ptr, "could not create the image");
+}
+
+void PngHandler::push_row(png_structp png_ptr, png_bytep new_row, png_uint_32 row_num, int pass)
+{
+	ILcontext	*context = (ILcontext*)png_get_progressive_ptr(png_ptr);
+	ILimage		*Image = context->impl->PushPng->pushImage;
+
+	context->impl->PushRows = row_num + 1;
+	context->impl->PushPasses = pass;
+	if (new_row == NULL)  // No pixels of this pass on this row
+		return;
+
+	// The rows of the early passes of an interlaced png are handed over for
+	//  each row of the block they stand for, and libpng spreads their pixels
+	//  across the row, so the image fills in coarsely at first.
+	png_progressive_combine_row(png_ptr, Image->Data + row_num * Image->Bps, new_row);
+}
+
+void PngHandler::push_end(png_structp png_ptr, png_infop info_ptr)
+{
+	ILcontext *context = (ILcontext*)png_get_progressive_ptr(png_ptr);
+
+	context->impl->PushPng->pushDone = IL_TRUE;
+	context->impl->PushPasses = png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE ? 1 : 7;
+}
+
+//! Starts decoding a png into the current image from data handed to pushData
+ILboolean PngHandler::pushBegin()
+{
+	if (context->impl->iCurImage == NULL) {
+		ilSetError(context, IL_ILLEGAL_OPERATION);
+		return IL_FALSE;
+	}
+
+	png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, png_error_func, png_warn_func);
+	if (png_ptr == NULL) {
+		ilSetError(context, IL_OUT_OF_MEMORY);
+		return IL_FALSE;
+	}
+	info_ptr = png_create_info_struct(png_ptr);
+	if (info_ptr == NULL) {
+		png_destroy_read_struct(&png_ptr, NULL, NULL);
+		ilSetError(context, IL_OUT_OF_MEMORY);
+		return IL_FALSE;
+	}
+
+	png_set_progressive_read_fn(png_ptr, context, push_info, push_row, push_end);
+	pushImage = context->impl->iCurImage;
+	pushDone = IL_FALSE;
+
+	return IL_TRUE;
+}
+
+//! Decodes the next Size bytes of the png.  Rows are stored in the image as
+//	they are completed.
+ILboolean PngHandler::pushData(const void *Data, ILuint Size)
+{
+	// Decoding goes into the image that was current when it started.
+	if (png_ptr == NULL || context->impl->iCurImage != pushImage) {
+		ilSetError(context, IL_ILLEGAL_OPERATION);
+		return IL_FALSE;
+	}
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		readpng_cleanup();
+		return IL_FALSE;
+	}
+	png_process_data(png_ptr, info_ptr, (png_bytep)Data, Size);
+
+	return IL_TRUE;
+}
+
+//! Finishes push decoding.  Fails if the png was not complete, but whatever
+//	was decoded stays in the image.
+ILboolean PngHandler::pushEnd()
+{
+	ILboolean Done = pushDone;
+
+	readpng_cleanup();
+	if (!Done) {
+		ilSetError(context, IL_FILE_READ_ERROR);
+		return IL_FALSE;
+	}
+	if (context->impl->iCurImage != pushImage) {
+		ilSetError(context, IL_ILLEGAL_OPERATION);
+		return IL_FALSE;
+	}
+	return ilFixImage(context);
+}
+
 //! Writes a Png file
 ILboolean PngHandler::save(const ILstring FileName)
 {
@@ -448,6 +779,17 @@ ILuint PngHandler::saveL(void *Lump, ILuint Size)
 	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
 }
 
+//! Writes an image given as rows (ilSaveRows) to an already-opened file
+ILuint PngHandler::saveRowsF(ILHANDLE File, iRowSource *Src)
+{
+	ILuint Pos;
+	iSetOutputFile(context, File);
+	Pos = context->impl->itellw(context);
+	if (saveRowsInternal(Src) == IL_FALSE)
+		return 0;  // Error occurred
+	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+}
+
 void png_write(png_structp png_ptr, png_bytep data, png_size_t length)
 {
 	ILcontext* context = (ILcontext*)png_get_io_ptr(png_ptr);
@@ -460,16 +802,302 @@ void flush_data(png_structp png_ptr)
 	return;
 }
 
+
+// Images with more than this much filtered data are deflated in bands of
+//  about this size by iPngWriteBands.  Smaller ones are left to libpng.
+#define PNG_BAND_SIZE (1 << 20)
+// Filter "type" for choosing the filter of each row, as libpng does
+#define PNG_FILTER_VALUE_ADAPTIVE PNG_FILTER_VALUE_LAST
+
+// What the pixel is predicted as by filter Type, from the byte to its left (a),
+//  above it (b) and above that (c).
+static inline ILubyte iPngPredict(ILuint Type, ILint a, ILint b, ILint c)
+{
+	ILint p, pa, pb, pc;
+
+	switch (Type)
+	{
+		case PNG_FILTER_VALUE_SUB:
+			return a;
+		case PNG_FILTER_VALUE_UP:
+			return b;
+		case PNG_FILTER_VALUE_AVG:
+			return (a + b) >> 1;
+		case PNG_FILTER_VALUE_PAETH:
+			p = a + b - c;
+			pa = abs(p - a);
+			pb = abs(p - b);
+			pc = abs(p - c);
+			if (pa <= pb && pa <= pc)
+				return a;
+			return pb <= pc ? b : c;
+	}
+	return 0;
+}
+
+// Filters the Size bytes of Row, given the row above, into Dest.  Returns the
+//  sum of the filtered bytes taken as signed, which is what libpng goes by to
+//  choose a filter.  If Dest is NULL, only the sum is worked out, and only
+//  until it passes Limit.
+template <ILuint Type>
+static ILuint iPngFilterRow(const ILubyte *Row, const ILubyte *Prev, ILuint Size, ILuint Bpp, ILubyte *Dest, ILuint Limit)
+{
+	ILuint	Sum = 0, i;
+	ILubyte	v;
+
+	for (i = 0; i < Bpp && i < Size; i++) {
+		v = Row[i] - iPngPredict(Type, 0, Prev[i], 0);
+		Sum += v < 128 ? v : 256 - v;
+		if (Dest)
+			Dest[i] = v;
+	}
+	for (; i < Size; i++) {
+		v = Row[i] - iPngPredict(Type, Row[i - Bpp], Prev[i], Prev[i - Bpp]);
+		Sum += v < 128 ? v : 256 - v;
+		if (Dest)
+			Dest[i] = v;
+		else if (Sum > Limit)
+			break;
+	}
+
+	return Sum;
+}
+
+static ILuint iPngFilterRow(ILuint Type, const ILubyte *Row, const ILubyte *Prev, ILuint Size, ILuint Bpp, ILubyte *Dest, ILuint Limit = UINT_MAX)
+{
+	switch (Type)
+	{
+		case PNG_FILTER_VALUE_SUB:
+			return iPngFilterRow<PNG_FILTER_VALUE_SUB>(Row, Prev, Size, Bpp, Dest, Limit);
+		case PNG_FILTER_VALUE_UP:
+			return iPngFilterRow<PNG_FILTER_VALUE_UP>(Row, Prev, Size, Bpp, Dest, Limit);
+		case PNG_FILTER_VALUE_AVG:
+			return iPngFilterRow<PNG_FILTER_VALUE_AVG>(Row, Prev, Size, Bpp, Dest, Limit);
+		case PNG_FILTER_VALUE_PAETH:
+			return iPngFilterRow<PNG_FILTER_VALUE_PAETH>(Row, Prev, Size, Bpp, Dest, Limit);
+	}
+	return iPngFilterRow<PNG_FILTER_VALUE_NONE>(Row, Prev, Size, Bpp, Dest, Limit);
+}
+
+// Writes the pixels of Image as IDAT chunks.  Rows are filtered with Filter (a
+//  PNG_FILTER_VALUE_*) on as many threads as there are processors, then
+//  deflated in bands, also in parallel.  Each band starts with the end of the
+//  one before it as its dictionary, so the image compresses about as well as
+//  in one piece, and the file is the same however many threads there are.
+//  Pixels must be in RGB order with the most significant byte first.
+static ILboolean iPngWriteBands(ILcontext *context, png_structp png_ptr, ILimage *Image, ILuint Filter, ILint Level, ILint Strategy)
+{
+	ILuint		Stride = Image->Bps + 1, Bpp = Image->Bpp * Image->Bpc;
+	ILuint		BandRows = IL_MAX(PNG_BAND_SIZE / Stride, 1);
+	ILuint		NumBands = (Image->Height + BandRows - 1) / BandRows;
+	ILuint		Bound, b, Size, Flg;
+	ILubyte		*Filtered = NULL, *Zero = NULL, *Out = NULL, Header[2], Trailer[4];
+	ILuint		*OutSizes = NULL;
+	uLong		*Adlers = NULL, Adler;
+	ILboolean	Ret = IL_FALSE;
+
+	Filtered = (ILubyte*)ialloc(context, (ILsizei)Image->Height * Stride);
+	Zero = (ILubyte*)icalloc(context, Image->Bps, 1);
+	Bound = (ILuint)deflateBound(NULL, BandRows * Stride) + 16;
+	Out = (ILubyte*)ialloc(context, (ILsizei)NumBands * Bound);
+	OutSizes = (ILuint*)ialloc(context, NumBands * sizeof(ILuint));
+	Adlers = (uLong*)ialloc(context, NumBands * sizeof(uLong));
+	if (Filtered == NULL || Zero == NULL || Out == NULL || OutSizes == NULL || Adlers == NULL)
+		goto cleanup;
+
+	iParallelFor(Image->Height, 16, [&](ILuint First, ILuint Last) {
+		const ILubyte	*Row, *Prev;
+		ILubyte			*Dest;
+		ILuint			y, Type, Best, Sum, BestSum;
+
+		for (y = First; y < Last; y++) {
+			if (Image->Origin == IL_ORIGIN_UPPER_LEFT) {
+				Row = Image->Data + y * Image->Bps;
+				Prev = y > 0 ? Row - Image->Bps : Zero;
+			}
+			else {
+				Row = Image->Data + (Image->Height - 1 - y) * Image->Bps;
+				Prev = y > 0 ? Row + Image->Bps : Zero;
+			}
+
+			Best = Filter;
+			if (Filter == PNG_FILTER_VALUE_ADAPTIVE) {
+				BestSum = UINT_MAX;
+				for (Type = PNG_FILTER_VALUE_NONE; Type < PNG_FILTER_VALUE_LAST; Type++) {
+					Sum = iPngFilterRow(Type, Row, Prev, Image->Bps, Bpp, NULL, BestSum);
+					if (Sum < BestSum) {
+						Best = Type;
+						BestSum = Sum;
+					}
+				}
+			}
+
+			Dest = Filtered + y * Stride;
+			Dest[0] = (ILubyte)Best;
+			iPngFilterRow(Best, Row, Prev, Image->Bps, Bpp, Dest + 1);
+		}
+	});
+
+	// Bands are independent raw deflate streams that end on a byte boundary
+	//  (Z_SYNC_FLUSH), so they can simply follow each other.
+	iParallelFor(NumBands, 1, [&](ILuint First, ILuint Last) {
+		z_stream	Strm;
+		ILubyte		*In;
+		ILuint		Band, InSize, Dict;
+		int			ZRet;
+
+		for (Band = First; Band < Last; Band++) {
+			In = Filtered + Band * BandRows * Stride;
+			InSize = (IL_MIN((Band + 1) * BandRows, Image->Height) - Band * BandRows) * Stride;
+			OutSizes[Band] = 0;
+			Adlers[Band] = adler32(adler32(0, NULL, 0), In, InSize);
+
+			memset(&Strm, 0, sizeof(Strm));
+			if (deflateInit2(&Strm, Level, Z_DEFLATED, -15, 8, Strategy) != Z_OK)
+				continue;
+			if (Band > 0) {
+				Dict = IL_MIN(Band * BandRows * Stride, 32768);
+				deflateSetDictionary(&Strm, In - Dict, Dict);
+			}
+			Strm.next_in = In;
+			Strm.avail_in = InSize;
+			Strm.next_out = Out + Band * Bound;
+			Strm.avail_out = Bound;
+			ZRet = deflate(&Strm, Band == NumBands - 1 ? Z_FINISH : Z_SYNC_FLUSH);
+			if ((ZRet == Z_STREAM_END || ZRet == Z_OK) && Strm.avail_in == 0 && Strm.avail_out > 0)
+				OutSizes[Band] = Bound - Strm.avail_out;
+			deflateEnd(&Strm);
+		}
+	});
+
+	for (b = 0; b < NumBands; b++) {
+		if (OutSizes[b] == 0) {
+			ilSetError(context, IL_OUT_OF_MEMORY);
+			goto cleanup;
+		}
+	}
+
+	// zlib header and the Adler-32 of all the filtered data
+	Header[0] = 0x78;  // Deflate with a 32k window
+	Flg = (Level < 2 ? 0 : Level < 6 ? 1 : Level == 6 ? 2 : 3) << 6;
+	Header[1] = (ILubyte)(Flg + (31 - (Header[0] * 256 + Flg) % 31) % 31);
+	Adler = Adlers[0];
+	for (b = 1; b < NumBands; b++) {
+		Size = (IL_MIN((b + 1) * BandRows, Image->Height) - b * BandRows) * Stride;
+		Adler = adler32_combine(Adler, Adlers[b], Size);
+	}
+	Trailer[0] = (ILubyte)(Adler >> 24);
+	Trailer[1] = (ILubyte)(Adler >> 16);
+	Trailer[2] = (ILubyte)(Adler >> 8);
+	Trailer[3] = (ILubyte)Adler;
+
+	for (b = 0; b < NumBands; b++) {
+		Size = OutSizes[b] + (b == 0 ? 2 : 0) + (b == NumBands - 1 ? 4 : 0);
+		png_write_chunk_start(png_ptr, (png_const_bytep)"IDAT", Size);
+		if (b == 0)
+			png_write_chunk_data(png_ptr, Header, 2);
+		png_write_chunk_data(png_ptr, Out + b * Bound, OutSizes[b]);
+		if (b == NumBands - 1)
+			png_write_chunk_data(png_ptr, Trailer, 4);
+		png_write_chunk_end(png_ptr);
+	}
+
+	Ret = IL_TRUE;
+
+cleanup:
+	ifree(context, Filtered);
+	ifree(context, Zero);
+	ifree(context, Out);
+	ifree(context, OutSizes);
+	ifree(context, Adlers);
+	return Ret;
+}
+
+// Sets the comments DevIL puts in its files and writes the header chunks.
+static void iPngWriteInfo(ILcontext* context, png_structp png_ptr, png_infop info_ptr)
+{
+	png_text	text[4];
+
+	imemclear(text, sizeof(png_text) * 4);
+	text[0].key = (png_charp)"Generated by";
+	text[0].text = (png_charp)"Generated by the Developer's Image Library (DevIL)";
+	text[0].compression = PNG_TEXT_COMPRESSION_NONE;
+	text[1].key = (png_charp)"Author";
+	text[1].text = (png_charp)iGetString(context, IL_PNG_AUTHNAME_STRING);  // Will not actually be modified!
+	text[1].compression = PNG_TEXT_COMPRESSION_NONE;
+	text[2].key = (png_charp)"Description";
+	text[2].text = iGetString(context, IL_PNG_DESCRIPTION_STRING);
+	text[2].compression = PNG_TEXT_COMPRESSION_NONE;
+	text[3].key = (png_charp)"Title";
+	text[3].text = iGetString(context, IL_PNG_TITLE_STRING);
+	text[3].compression = PNG_TEXT_COMPRESSION_NONE;
+	png_set_text(png_ptr, info_ptr, text, 3);
+
+	// Write the file header information.  REQUIRED.
+	png_write_info(png_ptr, info_ptr);
+
+	// Free up our user-defined text.
+	if (text[1].text)
+		ifree(context, text[1].text);
+	if (text[2].text)
+		ifree(context, text[2].text);
+	if (text[3].text)
+		ifree(context, text[3].text);
+}
+
+// Compression settings.  Adaptive filtering is what libpng does by default,
+//	except for paletted images, which are best left unfiltered.  The filter,
+//	level and zlib strategy are given back for iPngWriteBands.
+static void iPngSetCompression(ILcontext* context, png_structp png_ptr, ILenum PngType, ILuint *Filter, ILint *Level, ILint *Strategy)
+{
+	ILenum		FilterMode, StrategyMode;
+
+	if (ilIsEnabled(context, IL_PNG_FAST)) {
+		*Level = 1;
+		FilterMode = IL_PNG_FILTER_UP;
+		StrategyMode = IL_PNG_STRATEGY_DEFAULT;
+	}
+	else {
+		*Level = iGetInt(context, IL_PNG_COMPRESSION);
+		FilterMode = iGetInt(context, IL_PNG_FILTER);
+		StrategyMode = iGetInt(context, IL_PNG_STRATEGY);
+	}
+	if (FilterMode == IL_PNG_FILTER_ADAPTIVE)
+		*Filter = PngType == PNG_COLOR_TYPE_PALETTE ? PNG_FILTER_VALUE_NONE : PNG_FILTER_VALUE_ADAPTIVE;
+	else
+		*Filter = FilterMode - IL_PNG_FILTER_NONE;
+	switch (StrategyMode)
+	{
+		case IL_PNG_STRATEGY_FILTERED:
+			*Strategy = Z_FILTERED;
+			break;
+		case IL_PNG_STRATEGY_HUFFMAN:
+			*Strategy = Z_HUFFMAN_ONLY;
+			break;
+		case IL_PNG_STRATEGY_RLE:
+			*Strategy = Z_RLE;
+			break;
+		default:
+			*Strategy = *Filter == PNG_FILTER_VALUE_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+			break;
+	}
+	png_set_compression_level(png_ptr, *Level);
+	png_set_compression_strategy(png_ptr, *Strategy);
+	png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, *Filter == PNG_FILTER_VALUE_ADAPTIVE ? PNG_ALL_FILTERS : PNG_FILTER_NONE << *Filter);
+}
+
 // Internal function used to save the Png.
 ILboolean PngHandler::saveInternal()
 {
 	png_structp png_ptr;
 	png_infop	info_ptr;
-	png_text	text[4];
 	ILenum		PngType;
-	ILuint		BitDepth, i, j;
+	ILuint		BitDepth, i, j, Filter;
+	ILint		Level, Strategy;
 	ILubyte 	**RowPtr = NULL;
-	ILimage 	*Temp = NULL;
+	ILimage 	*Temp = NULL, *Src;
+	ILushort	*ShortPtr;
+	ILboolean	Written;
 
 	if (context->impl->iCurImage == NULL) {
 		ilSetError(context, IL_ILLEGAL_OPERATION);
@@ -586,7 +1214,7 @@ ILboolean PngHandler::saveInternal()
 
 		TempPal = iConvertPal(context, &context->impl->iCurImage->Pal, IL_PAL_RGB24);
 		png_set_PLTE(png_ptr, info_ptr, (png_colorp)TempPal->Palette, numCols);
-        ilClosePal(TempPal);
+        ilClosePal(context, TempPal);
 
         palType = ilGetInteger(context, IL_PALETTE_TYPE);
         if( palType==IL_PAL_RGBA32 || palType==IL_PAL_BGRA32 ) {
@@ -627,32 +1255,47 @@ ILboolean PngHandler::saveInternal()
 	*/
 	//png_set_gAMA(png_ptr, info_ptr, gamma);
 
-	// Optionally write comments into the image.
-	imemclear(text, sizeof(png_text) * 4);
-	text[0].key = (png_charp)"Generated by";
-	text[0].text = (png_charp)"Generated by the Developer's Image Library (DevIL)";
-	text[0].compression = PNG_TEXT_COMPRESSION_NONE;
-	text[1].key = (png_charp)"Author";
-	text[1].text = (png_charp)iGetString(context, IL_PNG_AUTHNAME_STRING);  // Will not actually be modified!
-	text[1].compression = PNG_TEXT_COMPRESSION_NONE;
-	text[2].key = (png_charp)"Description";
-	text[2].text = iGetString(context, IL_PNG_DESCRIPTION_STRING);
-	text[2].compression = PNG_TEXT_COMPRESSION_NONE;
-	text[3].key = (png_charp)"Title";
-	text[3].text = iGetString(context, IL_PNG_TITLE_STRING);
-	text[3].compression = PNG_TEXT_COMPRESSION_NONE;
-	png_set_text(png_ptr, info_ptr, text, 3);
+	// Optionally write comments into the image, then the file header information.
+	iPngWriteInfo(context, png_ptr, info_ptr);
+
+	iPngSetCompression(context, png_ptr, PngType, &Filter, &Level, &Strategy);
+
+	// Large images are filtered and compressed on several threads.  The rows
+	//	have to be RGB with 16-bit values big-endian, as libpng's transforms
+	//	are not used.
+	if (iGetInt(context, IL_PNG_INTERLACE) == IL_FALSE && Temp->Height * (Temp->Bps + 1) > PNG_BAND_SIZE) {
+		Src = Temp;
+		if (Temp->Format == IL_BGR)
+			Src = iConvertImage(context, Temp, IL_RGB, Temp->Type);
+		else if (Temp->Format == IL_BGRA)
+			Src = iConvertImage(context, Temp, IL_RGBA, Temp->Type);
+		#ifdef __LITTLE_ENDIAN__
+		if (Src != NULL && BitDepth == 16) {
+			if (Src == Temp)
+				Src = ilCopyImage_(context, Temp);
+			if (Src != NULL) {
+				ShortPtr = (ILushort*)Src->Data;
+				for (i = 0; i < Src->SizeOfData / 2; i++)
+					ShortPtr[i] = (ILushort)((ShortPtr[i] >> 8) | (ShortPtr[i] << 8));
+			}
+		}
+		#endif//__LITTLE_ENDIAN__
+		if (Src == NULL)
+			goto error_label;
 
-	// Write the file header information.  REQUIRED.
-	png_write_info(png_ptr, info_ptr);
+		Written = iPngWriteBands(context, png_ptr, Src, Filter, Level, Strategy);
+		if (Src != Temp)
+			ilCloseImage(context, Src);
+		if (!Written)
+			goto error_label;
 
-	// Free up our user-defined text.
-	if (text[1].text)
-		ifree(text[1].text);
-	if (text[2].text)
-		ifree(text[2].text);
-	if (text[3].text)
-		ifree(text[3].text);
+		// png_write_end only knows about IDATs written by libpng.
+		png_write_chunk(png_ptr, (png_const_bytep)"IEND", NULL, 0);
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		if (Temp != context->impl->iCurImage)
+			ilCloseImage(context, Temp);
+		return IL_TRUE;
+	}
 
 	/* Shift the pixels up to a legal bit depth and fill in
 	* as appropriate to correctly scale the image.
@@ -698,19 +1341,108 @@ ILboolean PngHandler::saveInternal()
 	// clean up after the write, and ifree any memory allocated
 	png_destroy_write_struct(&png_ptr, &info_ptr);
 
-	ifree(RowPtr);
+	ifree(context, RowPtr);
 
 	if (Temp != context->impl->iCurImage)
-		ilCloseImage(Temp);
+		ilCloseImage(context, Temp);
 
 	return IL_TRUE;
 
 error_label:
 	png_destroy_write_struct(&png_ptr, &info_ptr);
-	ifree(RowPtr);
+	ifree(context, RowPtr);
 	if (Temp != context->impl->iCurImage)
-		ilCloseImage(Temp);
+		ilCloseImage(context, Temp);
 	return IL_FALSE;
 }
 
+// Compresses each row with png_write_row as it arrives.  Interlacing needs
+//	the whole image, so streamed files are never interlaced.
+ILboolean PngHandler::saveRowsInternal(iRowSource *Src)
+{
+	png_structp png_ptr;
+	png_infop	info_ptr;
+	ILenum		Format, Type;
+	ILint		Level, Strategy;
+	ILuint		Filter, y;
+	ILubyte		*Row;
+	// Kept in memory, so that they still hold their values after a longjmp.
+	volatile ILint	PngType;
+	volatile ILuint	BitDepth;
+
+	switch (Src->Format)
+	{
+		case IL_LUMINANCE:
+			Format = IL_LUMINANCE;
+			PngType = PNG_COLOR_TYPE_GRAY;
+			break;
+		case IL_LUMINANCE_ALPHA:
+			Format = IL_LUMINANCE_ALPHA;
+			PngType = PNG_COLOR_TYPE_GRAY_ALPHA;
+			break;
+		case IL_RGBA:
+		case IL_BGRA:
+		case IL_ALPHA:
+			Format = IL_RGBA;
+			PngType = PNG_COLOR_TYPE_RGB_ALPHA;
+			break;
+		default:
+			Format = IL_RGB;
+			PngType = PNG_COLOR_TYPE_RGB;
+			break;
+	}
+	if (Src->Type == IL_BYTE || Src->Type == IL_UNSIGNED_BYTE) {
+		Type = IL_UNSIGNED_BYTE;
+		BitDepth = 8;
+	}
+	else {
+		Type = IL_UNSIGNED_SHORT;
+		BitDepth = 16;
+	}
+	if (!iRowsBegin(context, Src, Format, Type))
+		return IL_FALSE;
+
+	png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, png_error_func, png_warn_func);
+	if (png_ptr == NULL) {
+		ilSetError(context, IL_LIB_PNG_ERROR);
+		return IL_FALSE;
+	}
+	info_ptr = png_create_info_struct(png_ptr);
+	if (info_ptr == NULL) {
+		png_destroy_write_struct(&png_ptr, NULL);
+		ilSetError(context, IL_LIB_PNG_ERROR);
+		return IL_FALSE;
+	}
+	png_set_write_fn(png_ptr, context, png_write, flush_data);
+
+	// png_error_func has already set the error.
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		return IL_FALSE;
+	}
+
+	png_set_IHDR(png_ptr, info_ptr, Src->Width, Src->Height, BitDepth, PngType,
+		PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+	iPngWriteInfo(context, png_ptr, info_ptr);
+	iPngSetCompression(context, png_ptr, PngType, &Filter, &Level, &Strategy);
+
+	// swap bytes of 16-bit files to most significant byte first
+	#ifdef	__LITTLE_ENDIAN__
+	png_set_swap(png_ptr);
+	#endif//__LITTLE_ENDIAN__
+
+	for (y = 0; y < Src->Height; y++) {
+		Row = iRowsNext(context, Src);
+		if (Row == NULL) {
+			png_destroy_write_struct(&png_ptr, &info_ptr);
+			return IL_FALSE;
+		}
+		png_write_row(png_ptr, Row);
+	}
+
+	png_write_end(png_ptr, info_ptr);
+	png_destroy_write_struct(&png_ptr, &info_ptr);
+	return IL_TRUE;
+}
+
 #endif // IL_NO_PNG
\ No newline at end of file
@@ -43,25 +43,14 @@ typedef struct PPMINFO
 } PPMINFO;
 
 ILboolean	iCheckPnm(char Header[2]);
-ILimage		*ilReadAsciiPpm(ILcontext* context, PPMINFO *Info);
+ILimage		*ilReadAsciiPpm(ILcontext* context, PPMINFO *Info, ILbyte *SmallBuff);
 ILimage		*ilReadBinaryPpm(ILcontext* context, PPMINFO *Info);
 ILimage		*ilReadBitPbm(ILcontext* context, PPMINFO *Info);
-ILboolean	ilReadPam(ILcontext* context);
-ILboolean	iGetWord(ILcontext* context, ILboolean);
+ILboolean	ilReadPam(ILcontext* context, ILbyte *SmallBuff);
+ILboolean	iGetWord(ILcontext* context, ILbyte *SmallBuff, ILboolean);
 void		PbmMaximize(ILimage *Image);
 ILint		DecodeTupleType(std::string &TupleStr);
 
-// According to the ppm specs, it's 70, but PSP
-//  likes to output longer lines.
-#define MAX_BUFFER 180  
-
-//@TODO: Get rid of these globals
-static ILbyte LineBuffer[MAX_BUFFER];
-static ILbyte SmallBuff[MAX_BUFFER];
-
-// Can't read direct bits from a lump yet
-ILboolean IsLump = IL_FALSE;
-
 PnmHandler::PnmHandler(ILcontext* context) :
 	context(context)
 {
@@ -204,7 +193,7 @@ ILboolean PnmHandler::loadInternal()
 	}
 
 	// Find out what type of pgm/ppm this is
-	if (iGetWord(context, IL_FALSE) == IL_FALSE)
+	if (iGetWord(context, SmallBuff, IL_FALSE) == IL_FALSE)
 		return IL_FALSE;
 
 	if (SmallBuff[0] != 'P') {
@@ -225,10 +214,6 @@ ILboolean PnmHandler::loadInternal()
 			break;
 		case '4':
 			Info.Type = IL_PBM_BINARY;
-			if (IsLump) {
-				ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
-				return IL_FALSE;
-			}
 			break;
 		case '5':
 			Info.Type = IL_PGM_BINARY;
@@ -238,14 +223,14 @@ ILboolean PnmHandler::loadInternal()
 			break;
 		case '7':
 			//Info.Type = IL_PAM;
-			return ilReadPam(context);
+			return ilReadPam(context, SmallBuff);
 		default:
 			ilSetError(context, IL_INVALID_FILE_HEADER);
 			return IL_FALSE;
 	}
 	
 	// Retrieve the width and height
-	if (iGetWord(context, IL_FALSE) == IL_FALSE)
+	if (iGetWord(context, SmallBuff, IL_FALSE) == IL_FALSE)
 		return IL_FALSE;
 	Info.Width = atoi((const char*)SmallBuff);
 	if (Info.Width == 0) {
@@ -253,7 +238,7 @@ ILboolean PnmHandler::loadInternal()
 		return IL_FALSE;
 	}
 
-	if (iGetWord(context, IL_FALSE) == IL_FALSE)
+	if (iGetWord(context, SmallBuff, IL_FALSE) == IL_FALSE)
 		return IL_FALSE;
 	Info.Height = atoi((const char*)SmallBuff);
 	if (Info.Height == 0) {
@@ -264,7 +249,7 @@ ILboolean PnmHandler::loadInternal()
 	// Retrieve the maximum colour component value
 	if (Info.Type != IL_PBM_ASCII && Info.Type != IL_PBM_BINARY)
 	{
-		if (iGetWord(context, IL_TRUE) == IL_FALSE)
+		if (iGetWord(context, SmallBuff, IL_TRUE) == IL_FALSE)
 			return IL_FALSE;
 		if ((Info.MaxColour = atoi((const char*)SmallBuff)) == 0)
 		{
@@ -299,7 +284,7 @@ ILboolean PnmHandler::loadInternal()
 		case IL_PBM_ASCII:
 		case IL_PGM_ASCII:
 		case IL_PPM_ASCII:
-			PmImage = ilReadAsciiPpm(context, &Info);
+			PmImage = ilReadAsciiPpm(context, &Info, SmallBuff);
 			break;
 		case IL_PBM_BINARY:
 			PmImage = ilReadBitPbm(context, &Info);
@@ -342,8 +327,9 @@ ILboolean PnmHandler::loadInternal()
 	return ilFixImage(context);
 }
 
-ILimage *ilReadAsciiPpm(ILcontext* context, PPMINFO *Info)
+ILimage *ilReadAsciiPpm(ILcontext* context, PPMINFO *Info, ILbyte *SmallBuff)
 {
+	ILbyte	LineBuffer[MAX_BUFFER];
 	ILint	LineInc = 0, SmallInc = 0, DataInc = 0, Size;
 //	ILint	BytesRead = 0;
 
@@ -401,7 +387,7 @@ ILimage *ilReadAsciiPpm(ILcontext* context, PPMINFO *Info)
 
 	// If we read less than what we should have...
 	if (DataInc < Size) {
-		//ilCloseImage(context->impl->iCurImage);
+		//ilCloseImage(context, context->impl->iCurImage);
 		//ilSetCurImage(NULL);
 		ilSetError(context, IL_ILLEGAL_FILE_VALUE);
 		return NULL;
@@ -432,7 +418,7 @@ ILimage *ilReadBinaryPpm(ILcontext* context, PPMINFO *Info)
 	context->impl->iseek(context, size-Size,IL_SEEK_SET);
 	*/
 	if (context->impl->iread(context, context->impl->iCurImage->Data, 1, Size) != Size) {
-		ilCloseImage(context->impl->iCurImage);	
+		ilCloseImage(context, context->impl->iCurImage);	
 		return NULL;
 	}
 	return context->impl->iCurImage;
@@ -460,7 +446,7 @@ ILimage *ilReadBitPbm(ILcontext* context, PPMINFO *Info)
 	return context->impl->iCurImage;
 }
 
-ILboolean ilReadPam(ILcontext* context)
+ILboolean ilReadPam(ILcontext* context, ILbyte *SmallBuff)
 {
 	PPMINFO Info;
 	std::string TempStr;
@@ -470,13 +456,13 @@ ILboolean ilReadPam(ILcontext* context)
 
 	while (!context->impl->ieof(context))
 	{
-		if (iGetWord(context, IL_FALSE) == IL_FALSE)
+		if (iGetWord(context, SmallBuff, IL_FALSE) == IL_FALSE)
 			return IL_FALSE;
 		if (!strncmp((const char*)SmallBuff, "ENDHDR", 6))
 			break;
 
 		TempStr = (char*)SmallBuff;  // Save the first identifier of the line
-		if (iGetWord(context, IL_FALSE) == IL_FALSE)
+		if (iGetWord(context, SmallBuff, IL_FALSE) == IL_FALSE)
 			return IL_FALSE;
 		if (!strncmp(TempStr.c_str(), "WIDTH", 5))
 			Info.Width = atoi((const char*)SmallBuff);
@@ -572,7 +558,7 @@ ILboolean ilReadPam(ILcontext* context)
 
 	if (context->impl->iread(context, context->impl->iCurImage->Data, 1, Size) != Size)
 	{
-		ilCloseImage(context->impl->iCurImage);
+		ilCloseImage(context, context->impl->iCurImage);
 		return IL_FALSE;
 	}
 
@@ -597,7 +583,7 @@ ILint DecodeTupleType(std::string &TupleStr)
 	return 0;
 }
 
-ILboolean iGetWord(ILcontext* context, ILboolean final)
+ILboolean iGetWord(ILcontext* context, ILbyte *SmallBuff, ILboolean final)
 {
 	ILint WordPos = 0;
 	ILint Current = 0;
@@ -657,8 +643,6 @@ ILboolean iGetWord(ILcontext* context, ILboolean final)
 	return IL_TRUE;
 }
 
-ILstring FName = NULL;
-
 //! Writes a Pnm file
 ILboolean PnmHandler::save(const ILstring FileName)
 {
@@ -709,6 +693,17 @@ ILuint PnmHandler::saveL(void *Lump, ILuint Size)
 	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
 }
 
+//! Writes an image given as rows (ilSaveRows) to an already-opened file
+ILuint PnmHandler::saveRowsF(ILHANDLE File, iRowSource *Src)
+{
+	ILuint Pos;
+	iSetOutputFile(context, File);
+	Pos = context->impl->itellw(context);
+	if (saveRowsInternal(Src) == IL_FALSE)
+		return 0;  // Error occurred
+	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+}
+
 // Internal function used to save the Pnm.
 ILboolean PnmHandler::saveInternal()
 {
@@ -811,7 +806,7 @@ ILboolean PnmHandler::saveInternal()
 	if (TempImage->Origin != IL_ORIGIN_UPPER_LEFT) {
 		TempData = iGetFlipped(context, TempImage);
 		if (TempData == NULL) {
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	}
@@ -858,8 +853,8 @@ ILboolean PnmHandler::saveInternal()
 	}
 
 	if (TempImage->Origin != IL_ORIGIN_UPPER_LEFT)
-		ifree(TempData);
-	ilCloseImage(TempImage);
+		ifree(context, TempData);
+	ilCloseImage(context, TempImage);
 
 	return IL_TRUE;
 }
@@ -874,4 +869,46 @@ void PbmMaximize(ILimage *Image)
 	return;
 }
 
+// Writes the rows as they arrive.  Luminance rows make a .pgm and anything
+//	else a .ppm, 8 bits per sample; there is no file name to go by.
+ILboolean PnmHandler::saveRowsInternal(iRowSource *Src)
+{
+	ILenum		Format;
+	ILboolean	Binary;
+	ILuint		LinePos = 0, x, y;
+	ILubyte		*Row;
+
+	Binary = iGetHint(context, IL_COMPRESSION_HINT) == IL_USE_COMPRESSION;
+	Format = Src->Format == IL_LUMINANCE || Src->Format == IL_LUMINANCE_ALPHA ? IL_LUMINANCE : IL_RGB;
+	if (!iRowsBegin(context, Src, Format, IL_UNSIGNED_BYTE))
+		return IL_FALSE;
+
+	if (Format == IL_LUMINANCE)
+		ilprintf(context, Binary ? "P5\n" : "P2\n");
+	else
+		ilprintf(context, Binary ? "P6\n" : "P3\n");
+	ilprintf(context, "%d %d\n", Src->Width, Src->Height);
+	ilprintf(context, "%d\n", UCHAR_MAX);
+
+	for (y = 0; y < Src->Height; y++) {
+		Row = iRowsNext(context, Src);
+		if (Row == NULL)
+			return IL_FALSE;
+
+		if (Binary) {
+			context->impl->iwrite(context, Row, 1, Src->DestBps);
+			continue;
+		}
+		for (x = 0; x < Src->DestBps; x++) {
+			LinePos += ilprintf(context, "%d ", Row[x]);
+			if (LinePos > 65) {  // Just a good number =]
+				ilprintf(context, "\n");
+				LinePos = 0;
+			}
+		}
+	}
+
+	return IL_TRUE;
+}
+
 #endif//IL_NO_PNM
\ No newline at end of file
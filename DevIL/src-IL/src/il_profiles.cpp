@@ -160,7 +160,7 @@ ILboolean ILAPIENTRY ilApplyProfile(ILcontext* context, ILstring InProfile, ILst
 
 	cmsDoTransform(hTransform, context->impl->iCurImage->Data, Temp, context->impl->iCurImage->SizeOfData / 3);
 
-	ifree(context->impl->iCurImage->Data);
+	ifree(context, context->impl->iCurImage->Data);
 	context->impl->iCurImage->Data = Temp;
 
 	cmsDeleteTransform(hTransform);
@@ -76,7 +76,7 @@ ILboolean PsdHandler::isValid(ILconst_string FileName)
 //! Checks if the ILHANDLE contains a valid Psd file at the current position.
 ILboolean PsdHandler::isValidF(ILHANDLE File)
 {
-	ILuint		FirstPos;
+	ILuint64	FirstPos;
 	ILboolean	bRet;
 
 	iSetInputFile(context, File);
@@ -120,6 +120,114 @@ ILboolean PsdHandler::isValidInternal()
 	return check(&Head);
 }
 
+//! Reads the image properties from an already-opened Psd without decoding the pixels.
+ILboolean PsdHandler::getInfoF(ILHANDLE File, ILimageinfo *Info)
+{
+	ILuint64	FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = getInfoInternal(Info);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+//! Reads the image properties from a Psd lump without decoding the pixels.
+ILboolean PsdHandler::getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info)
+{
+	iSetInputLump(context, Lump, Size);
+	return getInfoInternal(Info);
+}
+
+// Reads the header and walks the image resources looking for an ICC profile (0x040F),
+//  seeking over each resource instead of reading the section in like ParseResources.
+ILboolean PsdHandler::getInfoInternal(ILimageinfo *Info)
+{
+	PSDHEAD		Head;
+	ILuint		ColorMode, ResourceSize, Size, HeadSize;
+	ILushort	ID;
+	ILubyte		Sig[4], NameLen;
+
+	iGetPsdHead(context, &Head);
+	if (!check(&Head)) {
+		ilSetError(context, IL_INVALID_FILE_HEADER);
+		return IL_FALSE;
+	}
+
+	// Same choices as ReadGrey, ReadIndexed, ReadRGB and ReadCMYK
+	switch (Head.Mode)
+	{
+		case 1:  // Greyscale
+			Info->Format = IL_LUMINANCE;
+			break;
+		case 2:  // Indexed
+			if (Head.Channels != 1 || Head.Depth != 8) {
+				ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+				return IL_FALSE;
+			}
+			Info->Format = IL_COLOUR_INDEX;
+			break;
+		case 3:  // RGB
+			if (Head.Channels < 3) {
+				ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+				return IL_FALSE;
+			}
+			Info->Format = Head.Channels == 3 ? IL_RGB : IL_RGBA;
+			break;
+		case 4:  // CMYK
+			if (Head.Channels != 4 && Head.Channels != 5) {
+				ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+				return IL_FALSE;
+			}
+			Info->Format = Head.Channels == 4 ? IL_RGB : IL_RGBA;
+			break;
+		default:
+			ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+			return IL_FALSE;
+	}
+	if (Head.Depth != 8 && Head.Depth != 16) {
+		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+		return IL_FALSE;
+	}
+
+	Info->Width = Head.Width;
+	Info->Height = Head.Height;
+	Info->Depth = 1;
+	Info->Type = Head.Depth == 16 ? IL_UNSIGNED_SHORT : IL_UNSIGNED_BYTE;
+
+	ColorMode = GetBigUInt(context);  // Skip over the 'color mode data section'
+	context->impl->iseek(context, ColorMode, IL_SEEK_CUR);
+
+	ResourceSize = GetBigUInt(context);
+	while (ResourceSize > 13) {
+		if (context->impl->iread(context, Sig, 1, 4) != 4 || strncmp("8BIM", (const char*)Sig, 4))
+			break;
+		ID = GetBigUShort(context);
+		NameLen = (ILubyte)context->impl->igetc(context);
+		// NameLen + the byte it occupies must be padded to an even number.
+		NameLen = NameLen + (NameLen & 1 ? 0 : 1);
+		context->impl->iseek(context, NameLen, IL_SEEK_CUR);
+		Size = GetBigUInt(context);
+
+		if (ID == 0x040F) {  // ICC Profile
+			Info->HasProfile = IL_TRUE;
+			break;
+		}
+
+		if (Size & 1)  // Must be an even number.
+			Size++;
+		HeadSize = 4 + 2 + 1 + NameLen + 4;
+		if (HeadSize + Size > ResourceSize)
+			break;
+		ResourceSize -= HeadSize + Size;
+		context->impl->iseek(context, Size, IL_SEEK_CUR);
+	}
+
+	return IL_TRUE;
+}
+
 // Internal function used to check if the HEADER is a valid Psd header.
 ILboolean PsdHandler::check(PSDHEAD *Header)
 {
@@ -164,7 +272,7 @@ ILboolean PsdHandler::load(ILconst_string FileName)
 //! Reads an already-opened Psd file
 ILboolean PsdHandler::loadF(ILHANDLE File)
 {
-	ILuint		FirstPos;
+	ILuint64	FirstPos;
 	ILboolean	bRet;
 
 	iSetInputFile(context, File);
@@ -271,12 +379,12 @@ ILboolean PsdHandler::ReadGrey(PSDHEAD *Head)
 		goto cleanup_error;
 	if (!ParseResources(context, ResourceSize, Resources))
 		goto cleanup_error;
-	ifree(Resources);
+	ifree(context, Resources);
 
 	return IL_TRUE;
 
 cleanup_error:
-	ifree(Resources);
+	ifree(context, Resources);
 	return IL_FALSE;
 }
 
@@ -336,21 +444,21 @@ ILboolean PsdHandler::ReadIndexed(PSDHEAD *Head)
 		context->impl->iCurImage->Pal.Palette[i+1] = Palette[j+NumEnt];
 		context->impl->iCurImage->Pal.Palette[i+2] = Palette[j+NumEnt*2];
 	}
-	ifree(Palette);
+	ifree(context, Palette);
 	Palette = NULL;
 
 	if (!PsdGetData(Head, context->impl->iCurImage->Data, (ILboolean)Compressed))
 		goto cleanup_error;
 
 	ParseResources(context, ResourceSize, Resources);
-	ifree(Resources);
+	ifree(context, Resources);
 	Resources = NULL;
 
 	return IL_TRUE;
 
 cleanup_error:
-	ifree(Palette);
-	ifree(Resources);
+	ifree(context, Palette);
+	ifree(context, Resources);
 
 	return IL_FALSE;
 }
@@ -417,18 +525,19 @@ ILboolean PsdHandler::ReadRGB(PSDHEAD *Head)
 		goto cleanup_error;
 	if (!ParseResources(context, ResourceSize, Resources))
 		goto cleanup_error;
-	ifree(Resources);
+	ifree(context, Resources);
 
 	return IL_TRUE;
 
 cleanup_error:
-	ifree(Resources);
+	ifree(context, Resources);
 	return IL_FALSE;
 }
 
 ILboolean PsdHandler::ReadCMYK(PSDHEAD *Head)
 {
-	ILuint		ColorMode, ResourceSize, MiscInfo, Size, i, j;
+	ILuint		ColorMode, ResourceSize, MiscInfo;
+	ILsizei		Size, i, j;
 	ILushort	Compressed;
 	ILenum		Format, Type;
 	ILubyte		*Resources = NULL, *KChannel = NULL;
@@ -482,7 +591,7 @@ ILboolean PsdHandler::ReadCMYK(PSDHEAD *Head)
 	if (!PsdGetData(Head, context->impl->iCurImage->Data, (ILboolean)Compressed))
 		goto cleanup_error;
 
-	Size = context->impl->iCurImage->Bpc * context->impl->iCurImage->Width * context->impl->iCurImage->Height;
+	Size = (ILsizei)context->impl->iCurImage->Bpc * context->impl->iCurImage->Width * context->impl->iCurImage->Height;
 	KChannel = (ILubyte*)ialloc(context, Size);
 	if (KChannel == NULL)
 		goto cleanup_error;
@@ -509,14 +618,14 @@ ILboolean PsdHandler::ReadCMYK(PSDHEAD *Head)
 	if (!ParseResources(context, ResourceSize, Resources))
 		goto cleanup_error;
 
-	ifree(Resources);
-	ifree(KChannel);
+	ifree(context, Resources);
+	ifree(context, KChannel);
 
 	return IL_TRUE;
 
 cleanup_error:
-	ifree(Resources);
-	ifree(KChannel);
+	ifree(context, Resources);
+	ifree(context, KChannel);
 	return IL_FALSE;
 }
 
@@ -531,16 +640,11 @@ ILuint* PsdHandler::GetCompChanLen(PSDHEAD *Head)
 		return NULL;
 	}
 
-	if (context->impl->iread(context, RleTable, sizeof(ILushort), Head->Height * ChannelNum) != Head->Height * ChannelNum) {
-		ifree(RleTable);
-		ifree(ChanLen);
+	if (GetBigUShorts(context, RleTable, Head->Height * ChannelNum) != Head->Height * ChannelNum) {
+		ifree(context, RleTable);
+		ifree(context, ChanLen);
 		return NULL;
 	}
-#ifdef __LITTLE_ENDIAN__
-	for (i = 0; i < Head->Height * ChannelNum; i++) {
-		iSwapUShort(&RleTable[i]);
-	}
-#endif
 
 	imemclear(ChanLen, ChannelNum * sizeof(ILuint));
 	for (c = 0; c < ChannelNum; c++) {
@@ -550,7 +654,7 @@ ILuint* PsdHandler::GetCompChanLen(PSDHEAD *Head)
 		}
 	}
 
-	ifree(RleTable);
+	ifree(context, RleTable);
 
 	return ChanLen;
 }
@@ -619,7 +723,8 @@ static ILuint ReadCompressedChannel(ILcontext* context, const ILuint ChanLen, IL
 
 ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compressed)
 {
-	ILuint		c, x, y, i, Size, ReadResult, NumChan;
+	ILuint		c, x, Size, ReadResult, NumChan;
+	ILsizei		y, i;
 	ILubyte		*Channel = NULL;
 	ILushort	*ShortPtr;
 	ILuint		*ChanLen = NULL;
@@ -636,7 +741,7 @@ ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compress
 			NumChan = 3;
 	}
 
-	Channel = (ILubyte*)ialloc(context, Head->Width * Head->Height * context->impl->iCurImage->Bpc);
+	Channel = (ILubyte*)ialloc(context, (ILsizei)Head->Width * Head->Height * context->impl->iCurImage->Bpc);
 	if (Channel == NULL) {
 		return IL_FALSE;
 	}
@@ -654,10 +759,10 @@ ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compress
 			for (c = 0; c < NumChan; c++) {
 				i = 0;
 				if (context->impl->iread(context, Channel, Head->Width * Head->Height, 1) != 1) {
-					ifree(Channel);
+					ifree(context, Channel);
 					return IL_FALSE;
 				}
-				for (y = 0; y < Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
+				for (y = 0; y < (ILsizei)Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
 					for (x = 0; x < context->impl->iCurImage->Bps; x += context->impl->iCurImage->Bpp, i++) {
 						context->impl->iCurImage->Data[y + x + c] = Channel[i];
 					}
@@ -668,10 +773,10 @@ ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compress
 			for (; c < Head->Channels; c++) {
 				i = 0;
 				if (context->impl->iread(context, Channel, Head->Width * Head->Height, 1) != 1) {
-					ifree(Channel);
+					ifree(context, Channel);
 					return IL_FALSE;
 				}
-				for (y = 0; y < Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
+				for (y = 0; y < (ILsizei)Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
 					for (x = 0; x < context->impl->iCurImage->Bps; x += context->impl->iCurImage->Bpp, i++) {
 						float curVal = ubyte_to_float(context->impl->iCurImage->Data[y + x + 3]);
 						float newVal = ubyte_to_float(Channel[i]);
@@ -684,11 +789,11 @@ ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compress
 			for (c = 0; c < NumChan; c++) {
 				i = 0;
 				if (context->impl->iread(context, Channel, Head->Width * Head->Height * 2, 1) != 1) {
-					ifree(Channel);
+					ifree(context, Channel);
 					return IL_FALSE;
 				}
 				context->impl->iCurImage->Bps /= 2;
-				for (y = 0; y < Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
+				for (y = 0; y < (ILsizei)Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
 					for (x = 0; x < context->impl->iCurImage->Bps; x += context->impl->iCurImage->Bpp, i++) {
 					 #ifndef WORDS_BIGENDIAN
 						iSwapUShort(ShortPtr+i);
@@ -703,11 +808,11 @@ ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compress
 			for (; c < Head->Channels; c++) {
 				i = 0;
 				if (context->impl->iread(context, Channel, Head->Width * Head->Height * 2, 1) != 1) {
-					ifree(Channel);
+					ifree(context, Channel);
 					return IL_FALSE;
 				}
 				context->impl->iCurImage->Bps /= 2;
-				for (y = 0; y < Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
+				for (y = 0; y < (ILsizei)Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
 					for (x = 0; x < context->impl->iCurImage->Bps; x += context->impl->iCurImage->Bpp, i++) {
 						float curVal = ushort_to_float(((ILushort*)context->impl->iCurImage->Data)[y + x + 3]);
 						float newVal = ushort_to_float(ShortPtr[i]);
@@ -730,7 +835,7 @@ ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compress
 				goto file_read_error;
 
 			i = 0;
-			for (y = 0; y < Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
+			for (y = 0; y < (ILsizei)Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
 				for (x = 0; x < context->impl->iCurImage->Bps; x += context->impl->iCurImage->Bpp, i++) {
 					context->impl->iCurImage->Data[y + x + c] = Channel[i];
 				}
@@ -740,7 +845,7 @@ ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compress
 		// Initialize the alpha channel to solid
 		//@TODO: This needs to be changed for greyscale images.
 		if (Head->Channels >= 4) {
-			for (y = 0; y < Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
+			for (y = 0; y < (ILsizei)Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
 				for (x = 0; x < context->impl->iCurImage->Bps; x += context->impl->iCurImage->Bpp) {
 					context->impl->iCurImage->Data[y + x + 3] = 255;
 				}
@@ -754,7 +859,7 @@ ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compress
 					goto file_read_error;
 
 				i = 0;
-				for (y = 0; y < Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
+				for (y = 0; y < (ILsizei)Head->Height * context->impl->iCurImage->Bps; y += context->impl->iCurImage->Bps) {
 					for (x = 0; x < context->impl->iCurImage->Bps; x += context->impl->iCurImage->Bpp, i++) {
 						float curVal = ubyte_to_float(context->impl->iCurImage->Data[y + x + 3]);
 						float newVal = ubyte_to_float(Channel[i]);
@@ -764,22 +869,22 @@ ILboolean PsdHandler::PsdGetData(PSDHEAD *Head, void *Buffer, ILboolean Compress
 			}
 		}
 
-		ifree(ChanLen);
+		ifree(context, ChanLen);
 	}
 
-	ifree(Channel);
+	ifree(context, Channel);
 
 	return IL_TRUE;
 
 file_corrupt:
-	ifree(ChanLen);
-	ifree(Channel);
+	ifree(context, ChanLen);
+	ifree(context, Channel);
 	ilSetError(context, IL_ILLEGAL_FILE_VALUE);
 	return IL_FALSE;
 
 file_read_error:
-	ifree(ChanLen);
-	ifree(Channel);
+	ifree(context, ChanLen);
+	ifree(context, Channel);
 	return IL_FALSE;
 }
 
@@ -918,23 +1023,23 @@ ILboolean PsdHandler::save(const ILstring FileName)
 //! Writes a Psd to an already-opened file
 ILuint PsdHandler::saveF(ILHANDLE File)
 {
-	ILuint Pos;
+	ILuint64 Pos;
 	iSetOutputFile(context, File);
 	Pos = context->impl->itellw(context);
 	if (saveInternal() == IL_FALSE)
 		return 0;  // Error occurred
-	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+	return (ILuint)(context->impl->itellw(context) - Pos);  // Return the number of bytes written.
 }
 
 //! Writes a Psd to a memory "lump"
 ILuint PsdHandler::saveL(void *Lump, ILuint Size)
 {
-	ILuint Pos;
+	ILuint64 Pos;
 	iSetOutputLump(context, Lump, Size);
 	Pos = context->impl->itellw(context);
 	if (saveInternal() == IL_FALSE)
 		return 0;  // Error occurred
-	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+	return (ILuint)(context->impl->itellw(context) - Pos);  // Return the number of bytes written.
 }
 
 // Internal function used to save the Psd.
@@ -1016,7 +1121,7 @@ ILboolean PsdHandler::saveInternal()
 			}
 		}
 
-		ifree(TempPal->Palette);
+		ifree(context, TempPal->Palette);
 	}
 	else {
 		SaveBigInt(context, 0);  // No colour mode data.
@@ -1031,7 +1136,7 @@ ILboolean PsdHandler::saveInternal()
 	if (TempImage->Origin == IL_ORIGIN_LOWER_LEFT) {
 		TempData = iGetFlipped(context, TempImage);
 		if (TempData == NULL) {
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	}
@@ -1058,10 +1163,10 @@ ILboolean PsdHandler::saveInternal()
 	}
 
 	if (TempData != TempImage->Data)
-		ifree(TempData);
+		ifree(context, TempData);
 
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 
 	return IL_TRUE;
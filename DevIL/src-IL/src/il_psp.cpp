@@ -127,104 +127,6 @@ enum PSPLayerType {
 	TRUE
 };*/
 
-#ifdef _MSC_VER
-#pragma pack(push, packed_struct, 1)
-#endif
-
-typedef struct PSPRECT
-{
-	ILuint x1,y1,x2,y2;
-} IL_PACKSTRUCT PSPRECT;
-
-typedef struct PSPHEAD
-{
-	char		FileSig[32];
-	ILushort	MajorVersion;
-	ILushort	MinorVersion;
-} IL_PACKSTRUCT PSPHEAD;
-
-typedef struct BLOCKHEAD
-{
-	ILubyte		HeadID[4];
-	ILushort	BlockID;
-	ILuint		BlockLen;
-} IL_PACKSTRUCT BLOCKHEAD;
-
-typedef struct GENATT_CHUNK
-{
-	ILint		Width;
-	ILint		Height;
-	ILdouble	Resolution;
-	ILubyte		ResMetric;
-	ILushort	Compression;
-	ILushort	BitDepth;
-	ILushort	PlaneCount;
-	ILuint		ColourCount;
-	ILubyte		GreyscaleFlag;
-	ILuint		SizeOfImage;
-	ILint		ActiveLayer;
-	ILushort	LayerCount;
-	ILuint		GraphicContents;
-} IL_PACKSTRUCT GENATT_CHUNK;
-
-typedef struct LAYERINFO_CHUNK
-{
-	ILubyte		LayerType;
-	PSPRECT		ImageRect;
-	PSPRECT		SavedImageRect;
-	ILubyte		Opacity;
-	ILubyte		BlendingMode;
-	ILubyte		LayerFlags;
-	ILubyte		TransProtFlag;
-	ILubyte		LinkID;
-	PSPRECT		MaskRect;
-	PSPRECT		SavedMaskRect;
-	ILubyte		MaskLinked;
-	ILubyte		MaskDisabled;
-	ILubyte		InvertMaskBlend;
-	ILushort	BlendRange;
-	ILubyte		SourceBlend1[4];
-	ILubyte		DestBlend1[4];
-	ILubyte		SourceBlend2[4];
-	ILubyte		DestBlend2[4];
-	ILubyte		SourceBlend3[4];
-	ILubyte		DestBlend3[4];
-	ILubyte		SourceBlend4[4];
-	ILubyte		DestBlend4[4];
-	ILubyte		SourceBlend5[4];
-	ILubyte		DestBlend5[4];
-} IL_PACKSTRUCT LAYERINFO_CHUNK;
-
-typedef struct LAYERBITMAP_CHUNK
-{
-	ILushort	NumBitmaps;
-	ILushort	NumChannels;
-} IL_PACKSTRUCT LAYERBITMAP_CHUNK;
-
-typedef struct CHANNEL_CHUNK
-{
-	ILuint		CompLen;
-	ILuint		Length;
-	ILushort	BitmapType;
-	ILushort	ChanType;
-} IL_PACKSTRUCT CHANNEL_CHUNK;
-
-typedef struct ALPHAINFO_CHUNK
-{
-	PSPRECT		AlphaRect;
-	PSPRECT		AlphaSavedRect;
-} IL_PACKSTRUCT ALPHAINFO_CHUNK;
-
-typedef struct ALPHA_CHUNK
-{
-	ILushort	BitmapCount;
-	ILushort	ChannelCount;
-} IL_PACKSTRUCT ALPHA_CHUNK;
-
-#ifdef _MSC_VER
-#pragma pack(pop,  packed_struct)
-#endif
-
 ILubyte PSPSignature[32] = {
 	0x50, 0x61, 0x69, 0x6E, 0x74, 0x20, 0x53, 0x68, 0x6F, 0x70, 0x20, 0x50, 0x72, 0x6F, 0x20, 0x49,
 	0x6D, 0x61, 0x67, 0x65, 0x20, 0x46, 0x69, 0x6C, 0x65, 0x0A, 0x1A, 0x00, 0x00, 0x00, 0x00, 0x00
@@ -234,25 +136,8 @@ ILubyte GenAttHead[4] = {
 	0x7E, 0x42, 0x4B, 0x00
 };
 
-// Make these global, since they contain most of the image information.
-GENATT_CHUNK	AttChunk;
-PSPHEAD			Header;
-ILuint			NumChannels;
-ILubyte			**Channels = NULL;
-ILubyte			*Alpha = NULL;
-ILpal			Pal;
-
 // Function definitions
-ILboolean	iCheckPsp(void);
-ILboolean	ReadGenAttributes(ILcontext* context);
-ILboolean	ParseChunks(ILcontext* context);
-ILboolean	ReadLayerBlock(ILcontext* context, ILuint BlockLen);
-ILboolean	ReadAlphaBlock(ILcontext* context, ILuint BlockLen);
-ILubyte		*GetChannel(ILcontext* context);
 ILboolean	UncompRLE(ILubyte *CompData, ILubyte *Data, ILuint CompLen);
-ILboolean	ReadPalette(ILcontext* context, ILuint BlockLen);
-ILboolean	AssembleImage(ILcontext* context);
-ILboolean	Cleanup(void);
 
 PspHandler::PspHandler(ILcontext* context) :
 	context(context)
@@ -305,7 +190,7 @@ ILboolean PspHandler::isValidL(const void *Lump, ILuint Size)
 }
 
 // Internal function used to get the Psp header from the current file.
-ILboolean iGetPspHead(ILcontext* context)
+ILboolean PspHandler::iGetPspHead()
 {
 	if (context->impl->iread(context, Header.FileSig, 1, 32) != 32)
 		return IL_FALSE;
@@ -318,7 +203,7 @@ ILboolean iGetPspHead(ILcontext* context)
 // Internal function to get the header and check it.
 ILboolean PspHandler::isValidInternal()
 {
-	if (!iGetPspHead(context))
+	if (!iGetPspHead())
 		return IL_FALSE;
 	context->impl->iseek(context, -(ILint)sizeof(PSPHEAD), IL_SEEK_CUR);
 
@@ -326,7 +211,7 @@ ILboolean PspHandler::isValidInternal()
 }
 
 // Internal function used to check if the HEADER is a valid Psp header.
-ILboolean iCheckPsp()
+ILboolean PspHandler::iCheckPsp()
 {
 	if (stricmp(Header.FileSig, "Paint Shop Pro Image File\n\x1a"))
 		return IL_FALSE;
@@ -390,25 +275,25 @@ ILboolean PspHandler::loadInternal()
 	Alpha = NULL;
 	Pal.Palette = NULL;
 
-	if (!iGetPspHead(context))
+	if (!iGetPspHead())
 		return IL_FALSE;
 	if (!iCheckPsp()) {
 		ilSetError(context, IL_INVALID_FILE_HEADER);
 		return IL_FALSE;
 	}
 
-	if (!ReadGenAttributes(context))
+	if (!ReadGenAttributes())
 		return IL_FALSE;
-	if (!ParseChunks(context))
+	if (!ParseChunks())
 		return IL_FALSE;
-	if (!AssembleImage(context))
+	if (!AssembleImage())
 		return IL_FALSE;
 
 	Cleanup();
 	return ilFixImage(context);
 }
 
-ILboolean ReadGenAttributes(ILcontext* context)
+ILboolean PspHandler::ReadGenAttributes()
 {
 	BLOCKHEAD		AttHead;
 	ILint			Padding;
@@ -457,7 +342,7 @@ ILboolean ReadGenAttributes(ILcontext* context)
 	return IL_TRUE;
 }
 
-ILboolean ParseChunks(ILcontext* context)
+ILboolean PspHandler::ParseChunks()
 {
 	BLOCKHEAD	Block;
 	ILuint		Pos;
@@ -484,17 +369,17 @@ ILboolean ParseChunks(ILcontext* context)
 		switch (Block.BlockID)
 		{
 			case PSP_LAYER_START_BLOCK:
-				if (!ReadLayerBlock(context, Block.BlockLen))
+				if (!ReadLayerBlock(Block.BlockLen))
 					return IL_FALSE;
 				break;
 
 			case PSP_ALPHA_BANK_BLOCK:
-				if (!ReadAlphaBlock(context, Block.BlockLen))
+				if (!ReadAlphaBlock(Block.BlockLen))
 					return IL_FALSE;
 				break;
 
 			case PSP_COLOR_BLOCK:
-				if (!ReadPalette(context, Block.BlockLen))
+				if (!ReadPalette(Block.BlockLen))
 					return IL_FALSE;
 				break;
 
@@ -513,7 +398,7 @@ ILboolean ParseChunks(ILcontext* context)
 	return IL_TRUE;
 }
 
-ILboolean ReadLayerBlock(ILcontext* context, ILuint BlockLen)
+ILboolean PspHandler::ReadLayerBlock(ILuint BlockLen)
 {
 	BLOCKHEAD			Block;
 	LAYERINFO_CHUNK		LayerInfo;
@@ -577,10 +462,10 @@ ILboolean ReadLayerBlock(ILcontext* context, ILuint BlockLen)
 	NumChannels = Bitmap.NumChannels;
 
 	for (i = 0; i < NumChannels; i++) {
-		Channels[i] = GetChannel(context);
+		Channels[i] = GetChannel();
 		if (Channels[i] == NULL) {
 			for (j = 0; j < i; j++)
-				ifree(Channels[j]);
+				ifree(context, Channels[j]);
 			return IL_FALSE;
 		}
 	}
@@ -588,7 +473,7 @@ ILboolean ReadLayerBlock(ILcontext* context, ILuint BlockLen)
 	return IL_TRUE;
 }
 
-ILboolean ReadAlphaBlock(ILcontext* context, ILuint BlockLen)
+ILboolean PspHandler::ReadAlphaBlock(ILuint BlockLen)
 {
 	BLOCKHEAD		Block;
 	ALPHAINFO_CHUNK	AlphaInfo;
@@ -654,14 +539,14 @@ ILboolean ReadAlphaBlock(ILcontext* context, ILuint BlockLen)
 	}*/
 
 
-	Alpha = GetChannel(context);
+	Alpha = GetChannel();
 	if (Alpha == NULL)
 		return IL_FALSE;
 
 	return IL_TRUE;
 }
 
-ILubyte *GetChannel(ILcontext* context)
+ILubyte *PspHandler::GetChannel()
 {
 	BLOCKHEAD		Block;
 	CHANNEL_CHUNK	Channel;
@@ -704,40 +589,40 @@ ILubyte *GetChannel(ILcontext* context)
 	CompData = (ILubyte*)ialloc(context, Channel.CompLen);
 	Data = (ILubyte*)ialloc(context, AttChunk.Width * AttChunk.Height);
 	if (CompData == NULL || Data == NULL) {
-		ifree(Data);
-		ifree(CompData);
+		ifree(context, Data);
+		ifree(context, CompData);
 		return NULL;
 	}
 
 	if (context->impl->iread(context, CompData, 1, Channel.CompLen) != Channel.CompLen) {
-		ifree(CompData);
-		ifree(Data);
+		ifree(context, CompData);
+		ifree(context, Data);
 		return NULL;
 	}
 
 	switch (AttChunk.Compression)
 	{
 		case PSP_COMP_NONE:
-			ifree(Data);
+			ifree(context, Data);
 			return CompData;
 			break;
 
 		case PSP_COMP_RLE:
 			if (!UncompRLE(CompData, Data, Channel.CompLen)) {
-				ifree(CompData);
-				ifree(Data);
+				ifree(context, CompData);
+				ifree(context, Data);
 				return IL_FALSE;
 			}
 			break;
 
 		default:
-			ifree(CompData);
-			ifree(Data);
+			ifree(context, CompData);
+			ifree(context, Data);
 			ilSetError(context, IL_INVALID_FILE_HEADER);
 			return NULL;
 	}
 
-	ifree(CompData);
+	ifree(context, CompData);
 
 	return Data;
 }
@@ -798,7 +683,7 @@ ILboolean UncompRLE(ILubyte *CompData, ILubyte *Data, ILuint CompLen)
 	return IL_TRUE;
 }
 
-ILboolean ReadPalette(ILcontext* context, ILuint BlockLen)
+ILboolean PspHandler::ReadPalette(ILuint BlockLen)
 {
 	ILuint ChunkSize, PalCount, Padding;
 
@@ -820,14 +705,14 @@ ILboolean ReadPalette(ILcontext* context, ILuint BlockLen)
 		return IL_FALSE;
 
 	if (context->impl->iread(context, Pal.Palette, Pal.PalSize, 1) != 1) {
-		ifree(Pal.Palette);
+		ifree(context, Pal.Palette);
 		return IL_FALSE;
 	}
 
 	return IL_TRUE;
 }
 
-ILboolean AssembleImage(ILcontext* context)
+ILboolean PspHandler::AssembleImage()
 {
 	ILuint Size, i, j;
 
@@ -891,19 +776,19 @@ ILboolean AssembleImage(ILcontext* context)
 	return IL_TRUE;
 }
 
-ILboolean Cleanup()
+ILboolean PspHandler::Cleanup()
 {
 	ILuint	i;
 
 	if (Channels) {
 		for (i = 0; i < NumChannels; i++) {
-			ifree(Channels[i]);
+			ifree(context, Channels[i]);
 		}
-		ifree(Channels);
+		ifree(context, Channels);
 	}
 
 	if (Alpha) {
-		ifree(Alpha);
+		ifree(context, Alpha);
 	}
 
 	Channels = NULL;
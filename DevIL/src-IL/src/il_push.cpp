@@ -0,0 +1,96 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/src/il_push.cpp
+//
+// Description: Loads images from data handed over piece by piece as it
+//				arrives, such as from a socket
+//
+//-----------------------------------------------------------------------------
+
+#include "il_internal.h"
+#include "il_png.h"
+
+
+//! Starts loading an image of type Type into the current image from data that
+//	is passed to ilPushData as it arrives.  Only IL_PNG can be loaded this way.
+//	The image takes its size and format as soon as the header has been pushed,
+//	and rows are filled in as they are decoded, so it can be shown while
+//	loading; ilGetInteger with IL_PUSH_PASSES and IL_PUSH_ROWS says how far it
+//	has got.  Each pass of an interlaced image covers the whole image, with
+//	every pixel spread over the ones later passes have not reached yet.
+/*! \param Type Format of the data.  Only IL_PNG is supported.
+	\return Boolean value of failure or success.*/
+ILboolean ILAPIENTRY ilPushBegin(ILcontext* context, ILenum Type)
+{
+	iPushCleanup(context);
+	context->impl->PushRows = 0;
+	context->impl->PushPasses = 0;
+
+	switch (Type)
+	{
+#ifndef IL_NO_PNG
+		case IL_PNG:
+			context->impl->PushPng = new PngHandler(context);
+			if (!context->impl->PushPng->pushBegin()) {
+				iPushCleanup(context);
+				return IL_FALSE;
+			}
+			return IL_TRUE;
+#endif
+
+		default:
+			ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+			return IL_FALSE;
+	}
+}
+
+
+//! Decodes the next Size bytes of the image started with ilPushBegin.  The
+//	same image must still be current.
+/*! \return Boolean value of failure or success.  After a failure, the rest of
+	the data cannot be pushed and ilPushEnd should be called.*/
+ILboolean ILAPIENTRY ilPushData(ILcontext* context, const void *Data, ILuint Size)
+{
+	if (context->impl->PushPng == NULL) {
+		ilSetError(context, IL_ILLEGAL_OPERATION);
+		return IL_FALSE;
+	}
+	if (Data == NULL && Size > 0) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+
+	return context->impl->PushPng->pushData(Data, Size);
+}
+
+
+//! Ends loading the image started with ilPushBegin.
+/*! \return IL_TRUE if the whole image was pushed.  Otherwise what was decoded
+	is left in the image and IL_FALSE is returned.*/
+ILboolean ILAPIENTRY ilPushEnd(ILcontext* context)
+{
+	ILboolean Ret;
+
+	if (context->impl->PushPng == NULL) {
+		ilSetError(context, IL_ILLEGAL_OPERATION);
+		return IL_FALSE;
+	}
+
+	Ret = context->impl->PushPng->pushEnd();
+	iPushCleanup(context);
+	return Ret;
+}
+
+
+// Throws away the decoder of an unfinished ilPushBegin.
+void iPushCleanup(ILcontext* context)
+{
+#ifndef IL_NO_PNG
+	delete context->impl->PushPng;
+#endif
+	context->impl->PushPng = NULL;
+}
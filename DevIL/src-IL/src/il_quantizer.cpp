@@ -54,22 +54,18 @@ typedef struct Box
 /* Histogram is in elements 1..HISTSIZE along each axis,
  * element 0 is for base or marginal value
  * NB: these must start out 0!
+ *
+ * Kept in one block allocated per call, so that several contexts can
+ * quantize at the same time.
  */
-
-ILfloat		gm2[33][33][33];
-ILint		wt[33][33][33], mr[33][33][33],	mg[33][33][33],	mb[33][33][33];
-ILuint		size; //image size
-ILint		K;    //colour look-up table size
-ILushort	*Qadd;
-
-
-ILint	WindW, WindH, WindD;
-ILint	i;
-ILubyte	*buffer;
-static ILint	Width, Height, Depth, Comp;
-/*ILint	TotalColors;
-ILint	a, b;
-ILubyte	*buf1, *buf2;*/
+typedef struct QuantState
+{
+	ILfloat		gm2[33][33][33];
+	ILint		wt[33][33][33], mr[33][33][33],	mg[33][33][33],	mb[33][33][33];
+	ILuint		size; //image size
+	ILint		K;    //colour look-up table size
+	ILushort	*Qadd;
+} QuantState;
 
 ILuint n2(ILint s)
 {
@@ -86,7 +82,7 @@ ILuint n2(ILint s)
 
 
 // Build 3-D color histogram of counts, r/g/b, c^2
-ILboolean Hist3d(ILcontext* context, ILubyte *Ir, ILubyte *Ig, ILubyte *Ib, ILint *vwt, ILint *vmr, ILint *vmg, ILint *vmb, ILfloat *m2)
+ILboolean Hist3d(ILcontext* context, QuantState *q, ILubyte *Ir, ILubyte *Ig, ILubyte *Ib, ILint *vwt, ILint *vmr, ILint *vmg, ILint *vmb, ILfloat *m2)
 {
 	ILint	ind, r, g, b;
 	ILint	inr, ing, inb, table[2560];
@@ -96,21 +92,21 @@ ILboolean Hist3d(ILcontext* context, ILubyte *Ir, ILubyte *Ig, ILubyte *Ib, ILin
 	{
 		table[i] = i * i;
 	}
-	Qadd = (ILushort*)ialloc(context, sizeof(ILushort) * size);
-	if (Qadd == NULL)
+	q->Qadd = (ILushort*)ialloc(context, sizeof(ILushort) * q->size);
+	if (q->Qadd == NULL)
 	{
 		return IL_FALSE;
 	}
 	
-        imemclear(Qadd, sizeof(ILushort) * size);
+        imemclear(q->Qadd, sizeof(ILushort) * q->size);
         
-	for (i = 0; i < size; i++)
+	for (i = 0; i < q->size; i++)
 	{
 	    r = Ir[i]; g = Ig[i]; b = Ib[i];
 	    inr = (r>>3) + 1; 
 	    ing = (g>>3) + 1; 
 	    inb = (b>>3) + 1; 
-	    Qadd[i] = ind = (inr<<10)+(inr<<6)+inr+(ing<<5)+ing+inb;
+	    q->Qadd[i] = ind = (inr<<10)+(inr<<6)+inr+(ing<<5)+ing+inb;
 	    //[inr][ing][inb]
 	    vwt[ind]++;
 	    vmr[ind] += r;
@@ -256,23 +252,23 @@ ILint Top(Box *cube, ILubyte dir, ILint pos, ILint mmt[33][33][33])
 
 // Compute the weighted variance of a Box
 //	NB: as with the raw statistics, this is really the variance * size
-ILfloat Var(Box *cube)
+ILfloat Var(QuantState *q, Box *cube)
 {
 	ILfloat dr, dg, db, xx;
 
-	dr = (ILfloat)Vol(cube, mr); 
-	dg = (ILfloat)Vol(cube, mg); 
-	db = (ILfloat)Vol(cube, mb);
-	xx = gm2[cube->r1][cube->g1][cube->b1] 
-		-gm2[cube->r1][cube->g1][cube->b0]
-		-gm2[cube->r1][cube->g0][cube->b1]
-		+gm2[cube->r1][cube->g0][cube->b0]
-		-gm2[cube->r0][cube->g1][cube->b1]
-		+gm2[cube->r0][cube->g1][cube->b0]
-		+gm2[cube->r0][cube->g0][cube->b1]
-		-gm2[cube->r0][cube->g0][cube->b0];
-
-	return xx - (dr*dr+dg*dg+db*db) / (ILfloat)Vol(cube, wt);
+	dr = (ILfloat)Vol(cube, q->mr); 
+	dg = (ILfloat)Vol(cube, q->mg); 
+	db = (ILfloat)Vol(cube, q->mb);
+	xx = q->gm2[cube->r1][cube->g1][cube->b1] 
+		-q->gm2[cube->r1][cube->g1][cube->b0]
+		-q->gm2[cube->r1][cube->g0][cube->b1]
+		+q->gm2[cube->r1][cube->g0][cube->b0]
+		-q->gm2[cube->r0][cube->g1][cube->b1]
+		+q->gm2[cube->r0][cube->g1][cube->b0]
+		+q->gm2[cube->r0][cube->g0][cube->b1]
+		-q->gm2[cube->r0][cube->g0][cube->b0];
+
+	return xx - (dr*dr+dg*dg+db*db) / (ILfloat)Vol(cube, q->wt);
 }
 
 /* We want to minimize the sum of the variances of two subBoxes.
@@ -282,7 +278,7 @@ ILfloat Var(Box *cube)
  * so we drop the minus sign and MAXIMIZE the sum of the two terms.
  */
 
-ILfloat Maximize(Box *cube, ILubyte dir, ILint first, ILint last, ILint *cut,
+ILfloat Maximize(QuantState *q, Box *cube, ILubyte dir, ILint first, ILint last, ILint *cut,
 				 ILint whole_r, ILint whole_g, ILint whole_b, ILint whole_w)
 {
 	ILint	half_r, half_g, half_b, half_w;
@@ -290,18 +286,18 @@ ILfloat Maximize(Box *cube, ILubyte dir, ILint first, ILint last, ILint *cut,
 	ILint	i;
 	ILfloat	temp, max;
 
-	base_r = Bottom(cube, dir, mr);
-	base_g = Bottom(cube, dir, mg);
-	base_b = Bottom(cube, dir, mb);
-	base_w = Bottom(cube, dir, wt);
+	base_r = Bottom(cube, dir, q->mr);
+	base_g = Bottom(cube, dir, q->mg);
+	base_b = Bottom(cube, dir, q->mb);
+	base_w = Bottom(cube, dir, q->wt);
 	max = 0.0;
 	*cut = -1;
 
 	for (i = first; i < last; ++i) {
-		half_r = base_r + Top(cube, dir, i, mr);
-		half_g = base_g + Top(cube, dir, i, mg);
-		half_b = base_b + Top(cube, dir, i, mb);
-		half_w = base_w + Top(cube, dir, i, wt);
+		half_r = base_r + Top(cube, dir, i, q->mr);
+		half_g = base_g + Top(cube, dir, i, q->mg);
+		half_b = base_b + Top(cube, dir, i, q->mb);
+		half_w = base_w + Top(cube, dir, i, q->wt);
 		// Now half_x is sum over lower half of Box, if split at i 
 		if (half_w == 0) {  // subBox could be empty of pixels!
 			continue;       // never split into an empty Box
@@ -333,21 +329,21 @@ ILfloat Maximize(Box *cube, ILubyte dir, ILint first, ILint last, ILint *cut,
 }
 
 
-ILint Cut(Box *set1, Box *set2)
+ILint Cut(QuantState *q, Box *set1, Box *set2)
 {
 	ILubyte dir;
 	ILint cutr, cutg, cutb;
 	ILfloat maxr, maxg, maxb;
 	ILint whole_r, whole_g, whole_b, whole_w;
 
-	whole_r = Vol(set1, mr);
-	whole_g = Vol(set1, mg);
-	whole_b = Vol(set1, mb);
-	whole_w = Vol(set1, wt);
+	whole_r = Vol(set1, q->mr);
+	whole_g = Vol(set1, q->mg);
+	whole_b = Vol(set1, q->mb);
+	whole_w = Vol(set1, q->wt);
 
-	maxr = Maximize(set1, RED, set1->r0+1, set1->r1, &cutr, whole_r, whole_g, whole_b, whole_w);
-	maxg = Maximize(set1, GREEN, set1->g0+1, set1->g1, &cutg, whole_r, whole_g, whole_b, whole_w);
-	maxb = Maximize(set1, BLUE, set1->b0+1, set1->b1, &cutb, whole_r, whole_g, whole_b, whole_w);
+	maxr = Maximize(q, set1, RED, set1->r0+1, set1->r1, &cutr, whole_r, whole_g, whole_b, whole_w);
+	maxg = Maximize(q, set1, GREEN, set1->g0+1, set1->g1, &cutg, whole_r, whole_g, whole_b, whole_w);
+	maxb = Maximize(q, set1, BLUE, set1->b0+1, set1->b1, &cutb, whole_r, whole_g, whole_b, whole_w);
 
 	if ((maxr >= maxg) && (maxr >= maxb)) {
 		dir = RED;
@@ -417,6 +413,9 @@ ILimage *iQuantizeImage(ILcontext* context, ILimage *Image, ILuint NumCols)
 	ILubyte	*NewData = NULL, *Palette = NULL;
 	ILimage	*TempImage = NULL, *NewImage = NULL;
 	ILubyte	*Ir = NULL, *Ig = NULL, *Ib = NULL;
+	QuantState	*q = NULL;
+	ILint	Width, Height, Depth;
+	ILint	i;
 
 	ILint num_alloced_colors; // number of colors we allocated space for in palette, as NumCols but will not be less than 256
 
@@ -434,20 +433,20 @@ ILimage *iQuantizeImage(ILcontext* context, ILimage *Image, ILuint NumCols)
 	if (TempImage == NULL)
 		return NULL;
 
-	buffer = Image->Data;
-	WindW = Width = Image->Width;
-	WindH = Height = Image->Height;
-	WindD = Depth = Image->Depth;
-	Comp = Image->Bpp;
-	Qadd = NULL;
+	Width = Image->Width;
+	Height = Image->Height;
+	Depth = Image->Depth;
 
 	//color_num = ImagePrecalculate(Image);
 
 	NewData = (ILubyte*)ialloc(context, Image->Width * Image->Height * Image->Depth);
 	Palette = (ILubyte*)ialloc(context, 3 * num_alloced_colors);
-	if (!NewData || !Palette) {
-		ifree(NewData);
-		ifree(Palette);
+	q = (QuantState*)icalloc(context, sizeof(QuantState), 1);
+	if (!NewData || !Palette || !q) {
+		ifree(context, NewData);
+		ifree(context, Palette);
+		ifree(context, q);
+		ilCloseImage(context, TempImage);
 		return NULL;
 	}
 
@@ -455,18 +454,20 @@ ILimage *iQuantizeImage(ILcontext* context, ILimage *Image, ILuint NumCols)
 	Ig = (ILubyte*)ialloc(context, Width * Height * Depth);
 	Ib = (ILubyte*)ialloc(context, Width * Height * Depth);
 	if (!Ir || !Ig || !Ib) {
-		ifree(Ir);
-		ifree(Ig);
-		ifree(Ib);
-		ifree(NewData);
-		ifree(Palette);
+		ifree(context, Ir);
+		ifree(context, Ig);
+		ifree(context, Ib);
+		ifree(context, NewData);
+		ifree(context, Palette);
+		ifree(context, q);
+		ilCloseImage(context, TempImage);
 		return NULL;
 	}
 
-	size = Width * Height * Depth;
+	q->size = Width * Height * Depth;
         
         #ifdef ALTIVEC_GCC
-            register ILuint v_size = size>>4;
+            register ILuint v_size = q->size>>4;
             register ILuint pos = 0;
             v_size = v_size /3;
             register vector unsigned char d0,d1,d2;
@@ -512,45 +513,38 @@ ILimage *iQuantizeImage(ILcontext* context, ILimage *Image, ILuint NumCols)
                 
                 pos += 48;
             }
-            size -= pos;
+            q->size -= pos;
         #endif
 
-	for (k = 0; k < size; k++) {
+	for (k = 0; k < q->size; k++) {
                 Ir[k] = TempImage->Data[k * 3];
 		Ig[k] = TempImage->Data[k * 3 + 1];
 		Ib[k] = TempImage->Data[k * 3 + 2];
 	}
         
         #ifdef ALTIVEC_GCC
-           size = Width * Height * Depth;
+           q->size = Width * Height * Depth;
         #endif
         
 	// Set new colors number
-	K = NumCols;
+	q->K = NumCols;
 
-	if (K <= 256) {
+	if (q->K <= 256) {
 		// Begin Wu's color quantization algorithm
 
-		// May have "leftovers" from a previous run.
-		
-                imemclear(gm2, 33 * 33 * 33 * sizeof(ILfloat));
-                imemclear(wt, 33 * 33 * 33 * sizeof(ILint));
-                imemclear(mr, 33 * 33 * 33 * sizeof(ILint));
-                imemclear(mg, 33 * 33 * 33 * sizeof(ILint));
-                imemclear(mb, 33 * 33 * 33 * sizeof(ILint));
-                
-		if (!Hist3d(context, Ir, Ig, Ib, (ILint*)wt, (ILint*)mr, (ILint*)mg, (ILint*)mb, (ILfloat*)gm2))
+		// The moment tables start out cleared by icalloc.
+		if (!Hist3d(context, q, Ir, Ig, Ib, (ILint*)q->wt, (ILint*)q->mr, (ILint*)q->mg, (ILint*)q->mb, (ILfloat*)q->gm2))
 			goto error_label;
 
-		M3d((ILint*)wt, (ILint*)mr, (ILint*)mg, (ILint*)mb, (ILfloat*)gm2);
+		M3d((ILint*)q->wt, (ILint*)q->mr, (ILint*)q->mg, (ILint*)q->mb, (ILfloat*)q->gm2);
 
 		cube[0].r0 = cube[0].g0 = cube[0].b0 = 0;
 		cube[0].r1 = cube[0].g1 = cube[0].b1 = 32;
 		next = 0;
-		for (i = 1; i < K; ++i) {
-			if (Cut(&cube[next], &cube[i])) { // volume test ensures we won't try to cut one-cell Box */
-				vv[next] = (cube[next].vol>1) ? Var(&cube[next]) : 0.0f;
-				vv[i] = (cube[i].vol>1) ? Var(&cube[i]) : 0.0f;
+		for (i = 1; i < q->K; ++i) {
+			if (Cut(q, &cube[next], &cube[i])) { // volume test ensures we won't try to cut one-cell Box */
+				vv[next] = (cube[next].vol>1) ? Var(q, &cube[next]) : 0.0f;
+				vv[i] = (cube[i].vol>1) ? Var(q, &cube[i]) : 0.0f;
 			}
 			else {
 				vv[next] = 0.0;   // don't try to split this Box again
@@ -565,7 +559,7 @@ ILimage *iQuantizeImage(ILcontext* context, ILimage *Image, ILuint NumCols)
 			}
 				
 			if (temp <= 0.0) {
-				K = i+1;
+				q->K = i+1;
 				// Only got K Boxes
 				break;
 			}
@@ -574,13 +568,13 @@ ILimage *iQuantizeImage(ILcontext* context, ILimage *Image, ILuint NumCols)
 		tag = (ILubyte*)ialloc(context, 33 * 33 * 33 * sizeof(ILubyte));
 		if (tag == NULL)
 			goto error_label;
-		for (k = 0; (ILint)k < K; k++) {
+		for (k = 0; (ILint)k < q->K; k++) {
 			Mark(&cube[k], k, tag);
-			weight = Vol(&cube[k], wt);
+			weight = Vol(&cube[k], q->wt);
 			if (weight) {
-				lut_r[k] = (ILubyte)(Vol(&cube[k], mr) / weight);
-				lut_g[k] = (ILubyte)(Vol(&cube[k], mg) / weight);
-				lut_b[k] = (ILubyte)(Vol(&cube[k], mb) / weight);
+				lut_r[k] = (ILubyte)(Vol(&cube[k], q->mr) / weight);
+				lut_g[k] = (ILubyte)(Vol(&cube[k], q->mg) / weight);
+				lut_b[k] = (ILubyte)(Vol(&cube[k], q->mb) / weight);
 			}
 			else {
 				// Bogus Box
@@ -588,11 +582,11 @@ ILimage *iQuantizeImage(ILcontext* context, ILimage *Image, ILuint NumCols)
 			}
 		}
 
-		for (i = 0; i < (ILint)size; i++) {
-			NewData[i] = tag[Qadd[i]];
+		for (i = 0; i < (ILint)q->size; i++) {
+			NewData[i] = tag[q->Qadd[i]];
 		}
-		ifree(tag);
-		ifree(Qadd);
+		ifree(context, tag);
+		ifree(context, q->Qadd);
 
 		for (k = 0; k < NumCols; k++) {
 			Palette[k * 3]     = lut_b[k];
@@ -607,10 +601,11 @@ ILimage *iQuantizeImage(ILcontext* context, ILimage *Image, ILuint NumCols)
 		goto error_label;
 	}
 
-	ifree(Ig);
-	ifree(Ib);
-	ifree(Ir);
-	ilCloseImage(TempImage);
+	ifree(context, Ig);
+	ifree(context, Ib);
+	ifree(context, Ir);
+	ifree(context, q);
+	ilCloseImage(context, TempImage);
 
 	NewImage = (ILimage*)icalloc(context, sizeof(ILimage), 1);
 	if (NewImage == NULL) {
@@ -632,12 +627,14 @@ ILimage *iQuantizeImage(ILcontext* context, ILimage *Image, ILuint NumCols)
 	return NewImage;
 
 error_label:
-	ifree(NewData);
-	ifree(Palette);
-	ifree(Ig);
-	ifree(Ib);
-	ifree(Ir);
-	ifree(tag);
-	ifree(Qadd);
+	ifree(context, NewData);
+	ifree(context, Palette);
+	ifree(context, Ig);
+	ifree(context, Ib);
+	ifree(context, Ir);
+	ifree(context, tag);
+	ifree(context, q->Qadd);
+	ifree(context, q);
+	ilCloseImage(context, TempImage);
 	return NULL;
 }
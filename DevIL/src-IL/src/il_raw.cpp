@@ -49,7 +49,7 @@ ILboolean RawHandler::load(ILconst_string FileName)
 //! Reads an already-opened raw file
 ILboolean RawHandler::loadF(ILHANDLE File)
 {
-	ILuint		FirstPos;
+	ILuint64	FirstPos;
 	ILboolean	bRet;
 
 	iSetInputFile(context, File);
@@ -93,7 +93,7 @@ ILboolean RawHandler::loadInternal()
 	context->impl->iCurImage->Origin = IL_ORIGIN_LOWER_LEFT;
 
 	// Tries to read the correct amount of data
-	if (context->impl->iread(context, context->impl->iCurImage->Data, 1, context->impl->iCurImage->SizeOfData) < context->impl->iCurImage->SizeOfData)
+	if (!iReadLarge(context, context->impl->iCurImage->Data, context->impl->iCurImage->SizeOfData))
 		return IL_FALSE;
 
 	if (ilIsEnabled(context, IL_ORIGIN_SET)) {
@@ -143,23 +143,23 @@ ILboolean RawHandler::save(const ILstring FileName)
 //! Writes Raw to an already-opened file
 ILuint RawHandler::saveF(ILHANDLE File)
 {
-	ILuint Pos;
+	ILuint64 Pos;
 	iSetOutputFile(context, File);
 	Pos = context->impl->itellw(context);
 	if (saveInternal() == IL_FALSE)
 		return 0;  // Error occurred
-	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+	return (ILuint)(context->impl->itellw(context) - Pos);  // Return the number of bytes written.
 }
 
 //! Writes Raw to a memory "lump"
 ILuint RawHandler::saveL(void *Lump, ILuint Size)
 {
-	ILuint Pos;
+	ILuint64 Pos;
 	iSetOutputLump(context, Lump, Size);
 	Pos = context->impl->itellw(context);
 	if (saveInternal() == IL_FALSE)
 		return 0;  // Error occurred
-	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+	return (ILuint)(context->impl->itellw(context) - Pos);  // Return the number of bytes written.
 }
 
 // Internal function used to load the raw data.
@@ -175,7 +175,8 @@ ILboolean RawHandler::saveInternal()
 	SaveLittleUInt(context, context->impl->iCurImage->Depth);
 	context->impl->iputc(context, context->impl->iCurImage->Bpp);
 	context->impl->iputc(context, context->impl->iCurImage->Bpc);
-	context->impl->iwrite(context, context->impl->iCurImage->Data, 1, context->impl->iCurImage->SizeOfData);
+	if (!iWriteLarge(context, context->impl->iCurImage->Data, context->impl->iCurImage->SizeOfData))
+		return IL_FALSE;
 
 	return IL_TRUE;
 }
@@ -74,14 +74,26 @@ ILboolean iLoadDataInternal(ILcontext* context, ILuint Width, ILuint Height, ILu
 		return IL_FALSE;
 	}
 
-	if (!ilTexImage(context, Width, Height, Depth, Bpp, 0, IL_UNSIGNED_BYTE, NULL)) {
-		return IL_FALSE;
+	// Just the rows of an ilLoadDataRegion rectangle
+	if (Depth == 1 && iRegionActive(context)) {
+		if (!iRegionClaim(context, Width, Height))
+			return IL_FALSE;
+		if (!ilTexImage(context, context->impl->RegionW, context->impl->RegionH, 1, Bpp, 0, IL_UNSIGNED_BYTE, NULL))
+			return IL_FALSE;
+		context->impl->iCurImage->Origin = IL_ORIGIN_UPPER_LEFT;
+		if (!iRegionReadRows(context, context->impl->iCurImage, Width * Bpp, context->impl->RegionX, context->impl->RegionY))
+			return IL_FALSE;
+	}
+	else {
+		if (!ilTexImage(context, Width, Height, Depth, Bpp, 0, IL_UNSIGNED_BYTE, NULL)) {
+			return IL_FALSE;
+		}
+		context->impl->iCurImage->Origin = IL_ORIGIN_UPPER_LEFT;
+
+		// Tries to read the correct amount of data
+		if (context->impl->iread(context, context->impl->iCurImage->Data, Width * Height * Depth * Bpp, 1) != 1)
+			return IL_FALSE;
 	}
-	context->impl->iCurImage->Origin = IL_ORIGIN_UPPER_LEFT;
-
-	// Tries to read the correct amount of data
-	if (context->impl->iread(context, context->impl->iCurImage->Data, Width * Height * Depth * Bpp, 1) != 1)
-		return IL_FALSE;
 
 	if (context->impl->iCurImage->Bpp == 1)
 		context->impl->iCurImage->Format = IL_LUMINANCE;
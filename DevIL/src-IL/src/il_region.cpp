@@ -0,0 +1,195 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/src/il_region.cpp
+//
+// Description: Loads just a rectangle of an image, decoding no more of the
+//				file than the format allows
+//
+//-----------------------------------------------------------------------------
+
+#include "il_internal.h"
+
+
+static ILboolean	iRegionBegin(ILcontext* context, ILuint XOff, ILuint YOff, ILuint Width, ILuint Height);
+static ILboolean	iRegionEnd(ILcontext* context, ILboolean Loaded);
+static ILboolean	iCropToRegion(ILcontext* context, ILuint XOff, ILuint YOff, ILuint Width, ILuint Height);
+
+
+//! Loads the Width x Height rectangle at XOff, YOff of the image in FileName
+//	into the current image.  YOff counts down from the top of the picture,
+//	whatever the file's origin.  TIFF, PNG, BMP, TGA and SGI files only decode
+//	the strips, tiles or rows the rectangle needs where their layout allows;
+//	other files are loaded whole and cropped.  Only the first image in the
+//	file is loaded.
+/*! \param Type Format of the file, or IL_TYPE_UNKNOWN to work it out as ilLoad does.
+	\return Boolean value of failure or success.  IL_INVALID_PARAM is set if
+	the rectangle is empty or does not fit inside the image.*/
+ILboolean ILAPIENTRY ilLoadRegion(ILcontext* context, ILenum Type, ILconst_string FileName, ILuint XOff, ILuint YOff, ILuint Width, ILuint Height)
+{
+	if (!iRegionBegin(context, XOff, YOff, Width, Height))
+		return IL_FALSE;
+	return iRegionEnd(context, ilLoad(context, Type, FileName));
+}
+
+
+//! Loads a rectangle of an image in memory, like ilLoadRegion.
+ILboolean ILAPIENTRY ilLoadRegionL(ILcontext* context, ILenum Type, const void *Lump, ILuint Size, ILuint XOff, ILuint YOff, ILuint Width, ILuint Height)
+{
+	if (!iRegionBegin(context, XOff, YOff, Width, Height))
+		return IL_FALSE;
+	return iRegionEnd(context, ilLoadL(context, Type, Lump, Size));
+}
+
+
+//! Loads the RegionWidth x RegionHeight rectangle at XOff, YOff of a raw data
+//	file that ilLoadData would load with these Width, Height and Bpp, reading
+//	only the rows it needs.
+ILboolean ILAPIENTRY ilLoadDataRegion(ILcontext* context, ILconst_string FileName, ILuint Width, ILuint Height, ILubyte Bpp,
+	ILuint XOff, ILuint YOff, ILuint RegionWidth, ILuint RegionHeight)
+{
+	if (!iRegionBegin(context, XOff, YOff, RegionWidth, RegionHeight))
+		return IL_FALSE;
+	return iRegionEnd(context, ilLoadData(context, FileName, Width, Height, 1, Bpp));
+}
+
+
+static ILboolean iRegionBegin(ILcontext* context, ILuint XOff, ILuint YOff, ILuint Width, ILuint Height)
+{
+	if (Width == 0 || Height == 0) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+
+	context->impl->RegionX = XOff;
+	context->impl->RegionY = YOff;
+	context->impl->RegionW = Width;
+	context->impl->RegionH = Height;
+	context->impl->RegionDone = IL_FALSE;
+	return IL_TRUE;
+}
+
+
+// Crops the image if the loader could not load just the region itself.
+static ILboolean iRegionEnd(ILcontext* context, ILboolean Loaded)
+{
+	ILboolean	Done = context->impl->RegionDone;
+	ILuint		Width = context->impl->RegionW, Height = context->impl->RegionH;
+
+	context->impl->RegionW = context->impl->RegionH = 0;
+	context->impl->RegionDone = IL_FALSE;
+
+	if (!Loaded)
+		return IL_FALSE;
+	if (Done)
+		return IL_TRUE;
+	return iCropToRegion(context, context->impl->RegionX, context->impl->RegionY, Width, Height);
+}
+
+
+static ILboolean iCropToRegion(ILcontext* context, ILuint XOff, ILuint YOff, ILuint Width, ILuint Height)
+{
+	ILimage	*Image = context->impl->iCurImage;
+	ILubyte	*Data;
+	ILuint	PixSize, FirstRow, y, z;
+
+	if (XOff > Image->Width || Width > Image->Width - XOff || YOff > Image->Height || Height > Image->Height - YOff) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+
+	PixSize = Image->Bpp * Image->Bpc;
+	FirstRow = Image->Origin == IL_ORIGIN_LOWER_LEFT ? Image->Height - YOff - Height : YOff;
+	Data = (ILubyte*)ialloc(context, (ILsizei)Width * Height * Image->Depth * PixSize);
+	if (Data == NULL)
+		return IL_FALSE;
+
+	for (z = 0; z < Image->Depth; z++) {
+		for (y = 0; y < Height; y++) {
+			memcpy(Data + ((ILsizei)z * Height + y) * Width * PixSize,
+				Image->Data + z * Image->SizeOfPlane + (ILsizei)(FirstRow + y) * Image->Bps + XOff * PixSize,
+				Width * PixSize);
+		}
+	}
+
+	ifree(context, Image->Data);
+	Image->Data = Data;
+	Image->Width = Width;
+	Image->Height = Height;
+	Image->Bps = Width * PixSize;
+	Image->SizeOfPlane = (ILsizei)Image->Bps * Height;
+	Image->SizeOfData = Image->SizeOfPlane * Image->Depth;
+
+	// Nothing else in the file is kept, as when the loader does the work.
+	ifree(context, Image->DxtcData);
+	Image->DxtcData = NULL;
+	Image->DxtcSize = 0;
+	Image->DxtcFormat = IL_DXT_NO_COMP;
+	ilCloseImage(context, Image->Mipmaps);
+	ilCloseImage(context, Image->Next);
+	ilCloseImage(context, Image->Faces);
+	ilCloseImage(context, Image->Layers);
+	Image->Mipmaps = Image->Next = Image->Faces = Image->Layers = NULL;
+
+	return IL_TRUE;
+}
+
+
+// Whether the image being loaded should only be the ilLoadRegion rectangle.
+ILboolean iRegionActive(ILcontext* context)
+{
+	return context->impl->RegionW != 0 && !context->impl->RegionDone;
+}
+
+
+// Called by a loader that will load just the region of its Width x Height
+//	image, so the image it makes is RegionW x RegionH.  Fails if the region
+//	does not fit.
+ILboolean iRegionClaim(ILcontext* context, ILuint Width, ILuint Height)
+{
+	ILcontext::Impl *impl = context->impl;
+
+	if (impl->RegionX > Width || impl->RegionW > Width - impl->RegionX
+		|| impl->RegionY > Height || impl->RegionH > Height - impl->RegionY) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+
+	impl->RegionDone = IL_TRUE;
+	return IL_TRUE;
+}
+
+
+// The first of the region's rows, counted in the order the Height rows of the
+//	image are stored.
+ILuint iRegionFirstRow(ILcontext* context, ILuint Height, ILboolean BottomUp)
+{
+	if (BottomUp)
+		return Height - context->impl->RegionY - context->impl->RegionH;
+	return context->impl->RegionY;
+}
+
+
+// Reads Image->Height rows of Image->Bps bytes, starting FirstCol pixels into
+//	stored row FirstRow, from uncompressed data at the current position whose
+//	rows are FileBps bytes apart.  Only forward seeks are made, so the
+//	read-ahead window is reused when rows are close together.
+ILboolean iRegionReadRows(ILcontext* context, ILimage *Image, ILuint FileBps, ILuint FirstCol, ILuint FirstRow)
+{
+	ILuint64	Skip;
+	ILuint		y;
+
+	Skip = (ILuint64)FirstRow * FileBps + (ILuint64)FirstCol * Image->Bpp * Image->Bpc;
+	for (y = 0; y < Image->Height; y++) {
+		if (Skip > 0 && context->impl->iseek(context, (ILint64)Skip, IL_SEEK_CUR) != 0)
+			return IL_FALSE;
+		if (context->impl->iread(context, Image->Data + (ILsizei)y * Image->Bps, 1, Image->Bps) != Image->Bps)
+			return IL_FALSE;
+		Skip = FileBps - Image->Bps;
+	}
+
+	return IL_TRUE;
+}
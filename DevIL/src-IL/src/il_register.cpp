@@ -18,15 +18,10 @@
 #include <string.h>
 
 
-// Linked lists of registered formats
-iFormatL *LoadProcs = NULL;
-iFormatS *SaveProcs = NULL;
-
-
 ILboolean ILAPIENTRY ilRegisterLoad(ILcontext* context, ILconst_string Ext, IL_LOADPROC Load) {
 	iFormatL *TempNode, *NewNode;
 
-	TempNode = LoadProcs;
+	TempNode = context->impl->LoadProcs;
 	if (TempNode != NULL) {
 		while (TempNode->Next != NULL) {
 			TempNode = TempNode->Next;
@@ -41,8 +36,8 @@ ILboolean ILAPIENTRY ilRegisterLoad(ILcontext* context, ILconst_string Ext, IL_L
 		return IL_FALSE;
 	}
 
-	if (LoadProcs == NULL) {
-		LoadProcs = NewNode;
+	if (context->impl->LoadProcs == NULL) {
+		context->impl->LoadProcs = NewNode;
 	}
 	else {
 		TempNode->Next = NewNode;
@@ -60,7 +55,7 @@ ILboolean ILAPIENTRY ilRegisterSave(ILcontext* context, ILconst_string Ext, IL_S
 {
 	iFormatS *TempNode, *NewNode;
 
-	TempNode = SaveProcs;
+	TempNode = context->impl->SaveProcs;
 	if (TempNode != NULL) {
 		while (TempNode->Next != NULL) {
 			TempNode = TempNode->Next;
@@ -75,8 +70,8 @@ ILboolean ILAPIENTRY ilRegisterSave(ILcontext* context, ILconst_string Ext, IL_S
 		return IL_FALSE;
 	}
 
-	if (SaveProcs == NULL) {
-		SaveProcs = NewNode;
+	if (context->impl->SaveProcs == NULL) {
+		context->impl->SaveProcs = NewNode;
 	}
 	else {
 		TempNode->Next = NewNode;
@@ -91,21 +86,21 @@ ILboolean ILAPIENTRY ilRegisterSave(ILcontext* context, ILconst_string Ext, IL_S
 
 
 //! Unregisters a load extension - doesn't have to be called.
-ILboolean ILAPIENTRY ilRemoveLoad(ILconst_string Ext)
+ILboolean ILAPIENTRY ilRemoveLoad(ILcontext* context, ILconst_string Ext)
 {
-	iFormatL *TempNode = LoadProcs, *PrevNode = NULL;
+	iFormatL *TempNode = context->impl->LoadProcs, *PrevNode = NULL;
 
 	while (TempNode != NULL) {
 		if (!iStrCmp(Ext, TempNode->Ext)) {
 			if (PrevNode == NULL) {  // first node in the list
-				LoadProcs = TempNode->Next;
-				ifree((void*)TempNode->Ext);
-				ifree(TempNode);
+				context->impl->LoadProcs = TempNode->Next;
+				ifree(context, (void*)TempNode->Ext);
+				ifree(context, TempNode);
 			}
 			else {
 				PrevNode->Next = TempNode->Next;
-				ifree((void*)TempNode->Ext);
-				ifree(TempNode);
+				ifree(context, (void*)TempNode->Ext);
+				ifree(context, TempNode);
 			}
 
 			return IL_TRUE;
@@ -120,21 +115,21 @@ ILboolean ILAPIENTRY ilRemoveLoad(ILconst_string Ext)
 
 
 //! Unregisters a save extension - doesn't have to be called.
-ILboolean ILAPIENTRY ilRemoveSave(ILconst_string Ext)
+ILboolean ILAPIENTRY ilRemoveSave(ILcontext* context, ILconst_string Ext)
 {
-	iFormatS *TempNode = SaveProcs, *PrevNode = NULL;
+	iFormatS *TempNode = context->impl->SaveProcs, *PrevNode = NULL;
 
 	while (TempNode != NULL) {
 		if (!iStrCmp(Ext, TempNode->Ext)) {
 			if (PrevNode == NULL) {  // first node in the list
-				SaveProcs = TempNode->Next;
-				ifree((void*)TempNode->Ext);
-				ifree(TempNode);
+				context->impl->SaveProcs = TempNode->Next;
+				ifree(context, (void*)TempNode->Ext);
+				ifree(context, TempNode);
 			}
 			else {
 				PrevNode->Next = TempNode->Next;
-				ifree((void*)TempNode->Ext);
-				ifree(TempNode);
+				ifree(context, (void*)TempNode->Ext);
+				ifree(context, TempNode);
 			}
 
 			return IL_TRUE;
@@ -149,23 +144,23 @@ ILboolean ILAPIENTRY ilRemoveSave(ILconst_string Ext)
 
 
 // Automatically removes all registered formats.
-void ilRemoveRegistered()
+void ilRemoveRegistered(ILcontext* context)
 {
-	iFormatL *TempNodeL = LoadProcs;
-	iFormatS *TempNodeS = SaveProcs;
-
-	while (LoadProcs != NULL) {
-		TempNodeL = LoadProcs->Next;
-		ifree((void*)LoadProcs->Ext);
-		ifree(LoadProcs);
-		LoadProcs = TempNodeL;
+	iFormatL *TempNodeL = context->impl->LoadProcs;
+	iFormatS *TempNodeS = context->impl->SaveProcs;
+
+	while (context->impl->LoadProcs != NULL) {
+		TempNodeL = context->impl->LoadProcs->Next;
+		ifree(context, (void*)context->impl->LoadProcs->Ext);
+		ifree(context, context->impl->LoadProcs);
+		context->impl->LoadProcs = TempNodeL;
 	}
 
-	while (SaveProcs != NULL) {
-		TempNodeS = SaveProcs->Next;
-		ifree((void*)SaveProcs->Ext);
-		ifree(SaveProcs);
-		SaveProcs = TempNodeS;
+	while (context->impl->SaveProcs != NULL) {
+		TempNodeS = context->impl->SaveProcs->Next;
+		ifree(context, (void*)context->impl->SaveProcs->Ext);
+		ifree(context, context->impl->SaveProcs);
+		context->impl->SaveProcs = TempNodeS;
 	}
 
 	return;
@@ -174,7 +169,7 @@ void ilRemoveRegistered()
 
 ILboolean iRegisterLoad(ILcontext* context, ILconst_string FileName)
 {
-	iFormatL	*TempNode = LoadProcs;
+	iFormatL	*TempNode = context->impl->LoadProcs;
 	ILstring	Ext = iGetExtension(FileName);
 	ILenum		Error;
 
@@ -201,7 +196,7 @@ ILboolean iRegisterLoad(ILcontext* context, ILconst_string FileName)
 
 ILboolean iRegisterSave(ILcontext* context, ILconst_string FileName)
 {
-	iFormatS	*TempNode = SaveProcs;
+	iFormatS	*TempNode = context->impl->SaveProcs;
 	ILstring	Ext = iGetExtension(FileName);
 	ILenum		Error;
 
@@ -270,7 +265,7 @@ ILboolean ILAPIENTRY ilRegisterNumFaces(ILcontext* context, ILuint Num)
 	ILimage *Next, *Prev;
 
 	ilBindImage(context, ilGetCurName(context));  // Make sure the current image is actually bound.
-	ilCloseImage(context->impl->iCurImage->Faces);  // Close any current mipmaps.
+	ilCloseImage(context, context->impl->iCurImage->Faces);  // Close any current mipmaps.
 
 	context->impl->iCurImage->Faces = NULL;
 	if (Num == 0)  // Just gets rid of all the mipmaps.
@@ -289,7 +284,7 @@ ILboolean ILAPIENTRY ilRegisterNumFaces(ILcontext* context, ILuint Num)
 			Prev = context->impl->iCurImage->Faces;
 			while (Prev) {
 				Next = Prev->Faces;
-				ilCloseImage(Prev);
+				ilCloseImage(context, Prev);
 				Prev = Next;
 			}
 			return IL_FALSE;
@@ -307,7 +302,7 @@ ILboolean ILAPIENTRY ilRegisterMipNum(ILcontext* context, ILuint Num)
 	ILimage *Next, *Prev;
 
 	ilBindImage(context, ilGetCurName(context));  // Make sure the current image is actually bound.
-	ilCloseImage(context->impl->iCurImage->Mipmaps);  // Close any current mipmaps.
+	ilCloseImage(context, context->impl->iCurImage->Mipmaps);  // Close any current mipmaps.
 
 	context->impl->iCurImage->Mipmaps = NULL;
 	if (Num == 0)  // Just gets rid of all the mipmaps.
@@ -326,7 +321,7 @@ ILboolean ILAPIENTRY ilRegisterMipNum(ILcontext* context, ILuint Num)
 			Prev = context->impl->iCurImage->Mipmaps;
 			while (Prev) {
 				Next = Prev->Next;
-				ilCloseImage(Prev);
+				ilCloseImage(context, Prev);
 				Prev = Next;
 			}
 			return IL_FALSE;
@@ -344,7 +339,7 @@ ILboolean ILAPIENTRY ilRegisterNumImages(ILcontext* context, ILuint Num)
 	ILimage *Next, *Prev;
 
 	ilBindImage(context, ilGetCurName(context));  // Make sure the current image is actually bound.
-	ilCloseImage(context->impl->iCurImage->Next);  // Close any current "next" images.
+	ilCloseImage(context, context->impl->iCurImage->Next);  // Close any current "next" images.
 
 	context->impl->iCurImage->Next = NULL;
 	if (Num == 0)  // Just gets rid of all the "next" images.
@@ -363,7 +358,7 @@ ILboolean ILAPIENTRY ilRegisterNumImages(ILcontext* context, ILuint Num)
 			Prev = context->impl->iCurImage->Next;
 			while (Prev) {
 				Next = Prev->Next;
-				ilCloseImage(Prev);
+				ilCloseImage(context, Prev);
 				Prev = Next;
 			}
 			return IL_FALSE;
@@ -401,7 +396,7 @@ void ILAPIENTRY ilRegisterType(ILcontext* context, ILenum Type)
 void ILAPIENTRY ilRegisterPal(ILcontext* context, void *Pal, ILuint Size, ILenum Type)
 {
 	if (!context->impl->iCurImage->Pal.Palette || !context->impl->iCurImage->Pal.PalSize || context->impl->iCurImage->Pal.PalType != IL_PAL_NONE) {
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 	}
 
 	context->impl->iCurImage->Pal.PalSize = Size;
@@ -101,7 +101,6 @@ ILboolean ilRleCompressLine(ILcontext* context, ILubyte *p, ILuint n, ILubyte bp
 			n -= SameCount;
 			RLEBufSize += bpp + 1;
 			p += (SameCount - 1) * bpp;
-			*q++ = *p++;
 			switch(bpp) {
 				case 4:	*q++ = *p++;
 				case 3: *q++ = *p++;
@@ -216,7 +216,7 @@ ILboolean RotHandler::loadInternal()
 					return IL_FALSE;
 				// ...and decompress it.
 				if (!DecompressDXT1(Image, CompData)) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 				if (ilGetInteger(context, IL_KEEP_DXTC_DATA) == IL_TRUE) {
@@ -243,7 +243,7 @@ ILboolean RotHandler::loadInternal()
 					return IL_FALSE;
 				// ...and decompress it.
 				if (!DecompressDXT3(Image, CompData)) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 				if (ilGetInteger(context, IL_KEEP_DXTC_DATA) == IL_TRUE) {
@@ -270,7 +270,7 @@ ILboolean RotHandler::loadInternal()
 					return IL_FALSE;
 				// ...and decompress it.
 				if (!DecompressDXT5(Image, CompData)) {
-					ifree(CompData);
+					ifree(context, CompData);
 					return IL_FALSE;
 				}
 				// Keeps a copy
@@ -282,7 +282,7 @@ ILboolean RotHandler::loadInternal()
 				}
 				break;
 		}
-		ifree(CompData);  // Free it if it was not saved.
+		ifree(context, CompData);  // Free it if it was not saved.
 	} while (!context->impl->ieof(context));  //@TODO: Is there any other condition that should end this?
 
 	return ilFixImage(context);
@@ -0,0 +1,244 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/src/il_saverows.cpp
+//
+// Description: Saves images whose rows are handed over a band at a time, so
+//				the whole image never has to be in memory
+//
+//-----------------------------------------------------------------------------
+
+#include "il_internal.h"
+#include "il_bmp.h"
+#include "il_hdr.h"
+#include "il_jpeg.h"
+#include "il_png.h"
+#include "il_pnm.h"
+#include "il_targa.h"
+#include "il_tiff.h"
+
+
+// About how much of the image is asked for at a time
+#define ROW_BAND_SIZE (1 << 20)
+
+
+//! Saves a Width x Height image to FileName without it ever being in memory
+//	as a whole.  Proc is called for bands of rows, top row first, which it
+//	fills in Format and DataType; each band is encoded and written before the
+//	next one is asked for.
+/*! \param Type Format of the file: IL_BMP, IL_HDR, IL_JPG, IL_PNG, IL_PNM,
+	IL_TGA or IL_TIF.  The usual format states apply, except that PNGs are
+	never interlaced.
+	\param Format Format of the rows Proc gives.  Colour-indexed rows are not
+	supported.
+	\return Boolean value of failure or success.  If Proc returns IL_FALSE the
+	save stops there with IL_INTERNAL_ERROR, and the file is left incomplete.*/
+ILboolean ILAPIENTRY ilSaveRows(ILcontext* context, ILenum Type, ILconst_string FileName, ILuint Width, ILuint Height,
+	ILenum Format, ILenum DataType, IL_ROWPROC Proc, void *UserData)
+{
+	ILHANDLE	File;
+	ILuint		Size;
+
+	if (FileName == NULL || ilStrLen(FileName) < 1) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return IL_FALSE;
+	}
+
+	if (ilGetBoolean(context, IL_FILE_MODE) == IL_FALSE) {
+		if (iFileExists(FileName)) {
+			ilSetError(context, IL_FILE_ALREADY_EXISTS);
+			return IL_FALSE;
+		}
+	}
+
+	File = context->impl->iopenw(FileName);
+	if (File == NULL) {
+		ilSetError(context, IL_COULD_NOT_OPEN_FILE);
+		return IL_FALSE;
+	}
+
+	Size = ilSaveRowsF(context, Type, File, Width, Height, Format, DataType, Proc, UserData);
+	context->impl->iclosew(File);
+
+	return Size != 0 ? IL_TRUE : IL_FALSE;
+}
+
+
+//! Saves an image given as rows to a file stream, like ilSaveRows.
+/*! \return The number of bytes written, or 0 if saving failed.*/
+ILuint ILAPIENTRY ilSaveRowsF(ILcontext* context, ILenum Type, ILHANDLE File, ILuint Width, ILuint Height,
+	ILenum Format, ILenum DataType, IL_ROWPROC Proc, void *UserData)
+{
+	iRowSource	Src;
+	ILuint		Ret;
+
+	if (File == NULL || Proc == NULL || Width == 0 || Height == 0) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return 0;
+	}
+	if (ilGetBppFormat(Format) == 0 || ilGetBpcType(DataType) == 0) {
+		ilSetError(context, IL_INVALID_ENUM);
+		return 0;
+	}
+	if (Format == IL_COLOUR_INDEX) {
+		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+		return 0;
+	}
+
+	imemclear(&Src, sizeof(Src));
+	Src.Width = Width;
+	Src.Height = Height;
+	Src.Format = Format;
+	Src.Type = DataType;
+	Src.Proc = Proc;
+	Src.UserData = UserData;
+
+	switch (Type)
+	{
+#ifndef IL_NO_BMP
+	case IL_BMP:
+	{
+		BmpHandler handler(context);
+
+		Ret = handler.saveRowsF(File, &Src);
+	}
+	break;
+#endif
+
+#ifndef IL_NO_HDR
+	case IL_HDR:
+	{
+		HdrHandler handler(context);
+
+		Ret = handler.saveRowsF(File, &Src);
+	}
+	break;
+#endif
+
+#ifndef IL_NO_JPG
+#ifndef IL_USE_IJL
+	case IL_JPG:
+	{
+		JpegHandler handler(context);
+
+		Ret = handler.saveRowsF(File, &Src);
+	}
+	break;
+#endif
+#endif
+
+#ifndef IL_NO_PNG
+	case IL_PNG:
+	{
+		PngHandler handler(context);
+
+		Ret = handler.saveRowsF(File, &Src);
+	}
+	break;
+#endif
+
+#ifndef IL_NO_PNM
+	case IL_PNM:
+	{
+		PnmHandler handler(context);
+
+		Ret = handler.saveRowsF(File, &Src);
+	}
+	break;
+#endif
+
+#ifndef IL_NO_TGA
+	case IL_TGA:
+	{
+		TargaHandler handler(context);
+
+		Ret = handler.saveRowsF(File, &Src);
+	}
+	break;
+#endif
+
+#ifndef IL_NO_TIF
+	case IL_TIF:
+	{
+		TiffHandler handler(context);
+
+		Ret = handler.saveRowsF(File, &Src);
+	}
+	break;
+#endif
+
+	default:
+		ilSetError(context, IL_INVALID_ENUM);
+		Ret = 0;
+		break;
+	}
+
+	iRowsEnd(context, &Src);
+	return Ret;
+}
+
+
+// Sets up Src to give rows in DestFormat and DestType.
+ILboolean iRowsBegin(ILcontext* context, iRowSource *Src, ILenum DestFormat, ILenum DestType)
+{
+	Src->DestFormat = DestFormat;
+	Src->DestType = DestType;
+	Src->Bps = Src->Width * ilGetBppFormat(Src->Format) * ilGetBpcType(Src->Type);
+	Src->DestBps = Src->Width * ilGetBppFormat(DestFormat) * ilGetBpcType(DestType);
+	Src->BandRows = IL_MIN(IL_MAX(ROW_BAND_SIZE / Src->Bps, 1), Src->Height);
+	Src->BandFirst = Src->BandCount = Src->NextRow = 0;
+
+	Src->Band = (ILubyte*)ialloc(context, (ILsizei)Src->BandRows * Src->Bps);
+	if (Src->Band == NULL)
+		return IL_FALSE;
+	return IL_TRUE;
+}
+
+
+// The next row down, or NULL if there are no more or Proc gave up.
+ILubyte *iRowsNext(ILcontext* context, iRowSource *Src)
+{
+	ILubyte	*Conv;
+	ILuint	Count;
+
+	if (Src->NextRow >= Src->Height) {
+		ilSetError(context, IL_INTERNAL_ERROR);
+		return NULL;
+	}
+
+	if (Src->NextRow == Src->BandFirst + Src->BandCount) {
+		Count = IL_MIN(Src->BandRows, Src->Height - Src->NextRow);
+		if (!Src->Proc(Src->UserData, Src->NextRow, Count, Src->Band)) {
+			ilSetError(context, IL_INTERNAL_ERROR);  // Proc gave up.
+			return NULL;
+		}
+
+		if (Src->DestBand != Src->Band)
+			ifree(context, Src->DestBand);
+		Src->DestBand = Src->Band;
+		if (Src->Format != Src->DestFormat || Src->Type != Src->DestType) {
+			Conv = (ILubyte*)ilConvertBuffer(context, (ILsizei)Count * Src->Bps, Src->Format, Src->DestFormat,
+				Src->Type, Src->DestType, NULL, Src->Band);
+			if (Conv == NULL)
+				return NULL;
+			Src->DestBand = Conv;
+		}
+
+		Src->BandFirst = Src->NextRow;
+		Src->BandCount = Count;
+	}
+
+	return Src->DestBand + (ILsizei)(Src->NextRow++ - Src->BandFirst) * Src->DestBps;
+}
+
+
+void iRowsEnd(ILcontext* context, iRowSource *Src)
+{
+	if (Src->DestBand != Src->Band)
+		ifree(context, Src->DestBand);
+	ifree(context, Src->Band);
+	Src->Band = Src->DestBand = NULL;
+}
@@ -233,7 +233,7 @@ ILboolean ScitexHandler::loadInternal()
 		case 7:
 			if (!ilTexImage(context, Header.WidthPixels, Header.HeightPixels, 1, Header.NumChans, 0, IL_UNSIGNED_BYTE, NULL))
 			{
-				ifree(RowData);
+				ifree(context, RowData);
 				return IL_FALSE;
 			}
 			context->impl->iCurImage->Format = IL_RGB;
@@ -244,7 +244,7 @@ ILboolean ScitexHandler::loadInternal()
 				{
 					if (context->impl->iread(context, RowData, 1, Header.WidthPixels) != Header.WidthPixels)
 					{
-						ifree(RowData);
+						ifree(context, RowData);
 						return IL_FALSE;
 					}
 					for (ILuint w = 0; w < context->impl->iCurImage->Width; w++)
@@ -261,7 +261,7 @@ ILboolean ScitexHandler::loadInternal()
 		case 8:
 			if (!ilTexImage(context, Header.WidthPixels, Header.HeightPixels, 1, Header.NumChans, 0, IL_UNSIGNED_BYTE, NULL))
 			{
-				ifree(RowData);
+				ifree(context, RowData);
 				return IL_FALSE;
 			}
 			context->impl->iCurImage->Format = IL_LUMINANCE;
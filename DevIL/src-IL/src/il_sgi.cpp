@@ -58,6 +58,7 @@ ILint		iGetScanLineFast(ILubyte *ScanLine, iSgiHeader *Head, ILuint Length, ILub
 void		sgiSwitchData(ILubyte *Data, ILuint SizeOfData);
 ILboolean	iNewSgi(ILcontext* context, iSgiHeader *Head);
 ILboolean	iReadNonRleSgi(ILcontext* context, iSgiHeader *Head);
+ILboolean	iReadNonRleSgiRegion(ILcontext* context, iSgiHeader *Head);
 ILboolean	iReadRleSgi(ILcontext* context, iSgiHeader *Head);
 ILboolean 	iSaveRleSgi(ILcontext* context, ILubyte *Data, ILuint w, ILuint h, ILuint numChannels, ILuint bps);
 
@@ -321,24 +322,24 @@ ILboolean iReadRleSgi(ILcontext* context, iSgiHeader *Head)
 		sgiSwitchData(context->impl->iCurImage->Data, context->impl->iCurImage->SizeOfData);
 	#endif
 
-	ifree(OffTable);
-	ifree(LenTable);
+	ifree(context, OffTable);
+	ifree(context, LenTable);
 
 	for (ixPlane = 0; ixPlane < Head->ZSize; ixPlane++) {
-		ifree(TempData[ixPlane]);
+		ifree(context, TempData[ixPlane]);
 	}
-	ifree(TempData);
+	ifree(context, TempData);
 
 	return IL_TRUE;
 
 cleanup_error:
-	ifree(OffTable);
-	ifree(LenTable);
+	ifree(context, OffTable);
+	ifree(context, LenTable);
 	if (TempData) {
 		for (ixPlane = 0; ixPlane < Head->ZSize; ixPlane++) {
-			ifree(TempData[ixPlane]);
+			ifree(context, TempData[ixPlane]);
 		}
-		ifree(TempData);
+		ifree(context, TempData);
 	}
 
 	return IL_FALSE;
@@ -403,6 +404,9 @@ ILboolean iReadNonRleSgi(ILcontext* context, iSgiHeader *Head)
 	ILint 		ChanSize;
 	ILboolean	Cache = IL_FALSE;
 
+	if (Head->Bpc == 1 && iRegionActive(context))
+		return iReadNonRleSgiRegion(context, Head);
+
 	if (!iNewSgi(context, Head)) {
 		return IL_FALSE;
 	}
@@ -429,6 +433,48 @@ ILboolean iReadNonRleSgi(ILcontext* context, iSgiHeader *Head)
 	return IL_TRUE;
 }
 
+// Reads just the ilLoadRegion rectangle.  Each channel is stored whole, bottom
+//	row first, so the rectangle's part of every row is read for each channel.
+ILboolean iReadNonRleSgiRegion(ILcontext* context, iSgiHeader *Head)
+{
+	iSgiHeader	Region = *Head;
+	ILimage		*Image;
+	ILubyte		*Row;
+	ILuint64	Pos = 0, Off;
+	ILuint		FirstRow, c, x, y;
+
+	if (!iRegionClaim(context, Head->XSize, Head->YSize))
+		return IL_FALSE;
+	Region.XSize = (ILushort)context->impl->RegionW;
+	Region.YSize = (ILushort)context->impl->RegionH;
+	if (!iNewSgi(context, &Region))
+		return IL_FALSE;
+	Image = context->impl->iCurImage;
+
+	Row = (ILubyte*)ialloc(context, Image->Width);
+	if (Row == NULL)
+		return IL_FALSE;
+
+	FirstRow = iRegionFirstRow(context, Head->YSize, IL_TRUE);
+	for (c = 0; c < Image->Bpp; c++) {
+		for (y = 0; y < Image->Height; y++) {
+			Off = ((ILuint64)c * Head->YSize + FirstRow + y) * Head->XSize + context->impl->RegionX;
+			if ((Off > Pos && context->impl->iseek(context, (ILint64)(Off - Pos), IL_SEEK_CUR) != 0)
+				|| context->impl->iread(context, Row, 1, Image->Width) != Image->Width) {
+				ifree(context, Row);
+				return IL_FALSE;
+			}
+			Pos = Off + Image->Width;
+
+			for (x = 0; x < Image->Width; x++)
+				Image->Data[((ILsizei)y * Image->Width + x) * Image->Bpp + c] = Row[x];
+		}
+	}
+
+	ifree(context, Row);
+	return IL_TRUE;
+}
+
 void sgiSwitchData(ILubyte *Data, ILuint SizeOfData)
 {	
 	ILubyte	Temp;
@@ -675,7 +721,7 @@ ILboolean SgiHandler::saveInternal()
 		TempData = iGetFlipped(context, Temp);
 		if (TempData == NULL) {
 			if (Temp!= context->impl->iCurImage)
-				ilCloseImage(Temp);
+				ilCloseImage(context, Temp);
 			return IL_FALSE;
 		}
 	}
@@ -697,9 +743,9 @@ ILboolean SgiHandler::saveInternal()
 
 
 	if (TempData != Temp->Data)
-		ifree(TempData);
+		ifree(context, TempData);
 	if (Temp != context->impl->iCurImage)
-		ilCloseImage(Temp);
+		ilCloseImage(context, Temp);
 
 	return IL_TRUE;
 }
@@ -719,10 +765,10 @@ ILboolean iSaveRleSgi(ILcontext* context, ILubyte *Data, ILuint w, ILuint h, ILu
 	StartTable = (ILuint*)ialloc(context, h * numChannels * sizeof(ILuint));
 	LenTable = (ILuint*)icalloc(context, h * numChannels, sizeof(ILuint));
 	if (!ScanLine || !CompLine || !StartTable || !LenTable) {
-		ifree(ScanLine);
-		ifree(CompLine);
-		ifree(StartTable);
-		ifree(LenTable);
+		ifree(context, ScanLine);
+		ifree(context, CompLine);
+		ifree(context, StartTable);
+		ifree(context, LenTable);
 		return IL_FALSE;
 	}
 
@@ -759,10 +805,10 @@ ILboolean iSaveRleSgi(ILcontext* context, ILubyte *Data, ILuint w, ILuint h, ILu
 	context->impl->iwrite(context, StartTable, sizeof(ILuint), h * numChannels);
 	context->impl->iwrite(context, LenTable, sizeof(ILuint), h * numChannels);
 
-	ifree(ScanLine);
-	ifree(CompLine);
-	ifree(StartTable);
-	ifree(LenTable);
+	ifree(context, ScanLine);
+	ifree(context, CompLine);
+	ifree(context, StartTable);
+	ifree(context, LenTable);
 
 	return IL_TRUE;
 }
@@ -0,0 +1,1160 @@
+//-----------------------------------------------------------------------------
+//
+// ImageLib Sources
+// Copyright (C) 2000-2017 by Denton Woods
+// Last modified: 10/17/2026
+//
+// Filename: src-IL/src/il_simd.cpp
+//
+// Description: Vectorised kernels for the byte conversions in ilConvertBuffer
+//				and for DXTC decoding, chosen at runtime from what the CPU
+//				supports
+//
+//-----------------------------------------------------------------------------
+
+#include "il_internal.h"
+#include "il_simd.h"
+#include <limits.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define IL_HAVE_X86_SIMD
+	#include <immintrin.h>
+	#if defined(__GNUC__) || defined(__clang__)
+		// Lets single functions use instructions the rest of the library is not built for.
+		#define IL_TARGET(x) __attribute__((target(x)))
+	#else
+		#include <intrin.h>
+		#define IL_TARGET(x)
+	#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	// NEON is always there on 64-bit ARM, so it needs no runtime check.
+	#define IL_HAVE_NEON
+	#include <arm_neon.h>
+#endif
+
+
+//
+// Scalar versions, used when nothing better is available and for the tails
+//  of the vector loops.
+//
+
+static void iSwapRB3_C(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix)
+{
+	ILubyte Temp;
+
+	for (; NumPix > 0; NumPix--, Src += 3, Dest += 3) {
+		Temp = Src[0];
+		Dest[0] = Src[2];
+		Dest[1] = Src[1];
+		Dest[2] = Temp;
+	}
+}
+
+static void iSwapRB4_C(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix)
+{
+	ILubyte Temp;
+
+	for (; NumPix > 0; NumPix--, Src += 4, Dest += 4) {
+		Temp = Src[0];
+		Dest[0] = Src[2];
+		Dest[1] = Src[1];
+		Dest[2] = Temp;
+		Dest[3] = Src[3];
+	}
+}
+
+static void iExpand3To4_C(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILboolean SwapRB)
+{
+	ILuint R = SwapRB ? 2 : 0, B = 2 - R;
+
+	for (; NumPix > 0; NumPix--, Src += 3, Dest += 4) {
+		Dest[0] = Src[R];
+		Dest[1] = Src[1];
+		Dest[2] = Src[B];
+		Dest[3] = UCHAR_MAX;
+	}
+}
+
+static void iShrink4To3_C(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILboolean SwapRB)
+{
+	ILuint	R = SwapRB ? 2 : 0, B = 2 - R;
+	ILubyte	Red, Blue;
+
+	for (; NumPix > 0; NumPix--, Src += 4, Dest += 3) {
+		Red = Src[R];
+		Blue = Src[B];
+		Dest[0] = Red;
+		Dest[1] = Src[1];
+		Dest[2] = Blue;
+	}
+}
+
+static void iLuminance_C(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILuint Bpp, const ILfloat *Factors)
+{
+	ILfloat Resultf;
+
+	for (; NumPix > 0; NumPix--, Src += Bpp, Dest++) {
+		Resultf = Src[0] * Factors[0];
+		Resultf += Src[1] * Factors[1];
+		Resultf += Src[2] * Factors[2];
+		*Dest = (ILubyte)Resultf;
+	}
+}
+
+static void iByteToShort_C(const ILubyte *Src, ILushort *Dest, ILsizei Num)
+{
+	for (; Num > 0; Num--, Src++)
+		*Dest++ = (*Src << 8) | *Src;
+}
+
+static void iShortToByte_C(const ILushort *Src, ILubyte *Dest, ILsizei Num)
+{
+	for (; Num > 0; Num--)
+		*Dest++ = *Src++ >> 8;
+}
+
+static void iByteToFloat_C(const ILubyte *Src, ILfloat *Dest, ILsizei Num)
+{
+	for (; Num > 0; Num--)
+		*Dest++ = *Src++ / (ILfloat)UCHAR_MAX;
+}
+
+static void iFloatToByte_C(const ILfloat *Src, ILubyte *Dest, ILsizei Num)
+{
+	ILfloat Temp;
+
+	for (; Num > 0; Num--) {
+		Temp = *Src++;
+		Temp = IL_CLAMP(Temp);
+		*Dest++ = (ILubyte)(Temp * UCHAR_MAX);
+	}
+}
+
+
+// Colours 0-3 of the colour half of a DXTC block as RGBA bytes, with alpha
+//  set to Alpha.  Only DXT1 blocks whose first colour is not larger than the
+//  second have three colours and a transparent fourth.
+static void iDxtcPalette(const ILubyte *Block, ILboolean Dxt1, ILubyte Alpha, ILubyte *Pal)
+{
+	ILuint	Colour0 = Block[0] | (Block[1] << 8), Colour1 = Block[2] | (Block[3] << 8);
+	ILuint	i;
+
+	Pal[0] = ((Colour0 >> 8) & 0xF8) | (Colour0 >> 13);
+	Pal[1] = ((Colour0 >> 3) & 0xFC) | ((Colour0 >> 9) & 0x03);
+	Pal[2] = ((Colour0 << 3) & 0xF8) | ((Colour0 >> 2) & 0x07);
+	Pal[4] = ((Colour1 >> 8) & 0xF8) | (Colour1 >> 13);
+	Pal[5] = ((Colour1 >> 3) & 0xFC) | ((Colour1 >> 9) & 0x03);
+	Pal[6] = ((Colour1 << 3) & 0xF8) | ((Colour1 >> 2) & 0x07);
+
+	for (i = 0; i < 3; i++) {
+		if (!Dxt1 || Colour0 > Colour1)
+			Pal[8 + i] = (2 * Pal[i] + Pal[4 + i] + 1) / 3;
+		else
+			Pal[8 + i] = (Pal[i] + Pal[4 + i]) / 2;
+		Pal[12 + i] = (Pal[i] + 2 * Pal[4 + i] + 1) / 3;
+	}
+
+	Pal[3] = Pal[7] = Pal[11] = Alpha;
+	Pal[15] = (Dxt1 && Colour0 <= Colour1) ? 0 : Alpha;
+}
+
+// The 8 alpha values of a DXT5 block
+static void iDxt5Alphas(const ILubyte *Block, ILubyte *Alphas)
+{
+	ILuint a0 = Block[0], a1 = Block[1], i;
+
+	Alphas[0] = a0;
+	Alphas[1] = a1;
+	if (a0 > a1) {
+		for (i = 1; i < 7; i++)
+			Alphas[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+	}
+	else {
+		for (i = 1; i < 5; i++)
+			Alphas[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+		Alphas[6] = 0x00;
+		Alphas[7] = 0xFF;
+	}
+}
+
+// Writes the 16 colours of the colour half of a DXTC block.
+static void iDxtcColours_C(const ILubyte *Block, const ILubyte *Pal, ILubyte *Dest, ILsizei Stride)
+{
+	ILuint Bits = Block[4] | (Block[5] << 8) | (Block[6] << 16) | ((ILuint)Block[7] << 24);
+	ILuint i, j;
+
+	for (j = 0; j < 4; j++, Dest += Stride) {
+		for (i = 0; i < 4; i++, Bits >>= 2)
+			memcpy(Dest + i * 4, Pal + (Bits & 3) * 4, 4);
+	}
+}
+
+static void iDecodeDxt1_C(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte Pal[16];
+
+	for (; NumBlocks > 0; NumBlocks--, Src += 8, Dest += 16) {
+		iDxtcPalette(Src, IL_TRUE, 0xFF, Pal);
+		iDxtcColours_C(Src, Pal, Dest, Stride);
+	}
+}
+
+static void iDecodeDxt3_C(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte	Pal[16];
+	ILuint	i, j, Nibble;
+
+	for (; NumBlocks > 0; NumBlocks--, Src += 16, Dest += 16) {
+		iDxtcPalette(Src + 8, IL_FALSE, 0, Pal);
+		iDxtcColours_C(Src + 8, Pal, Dest, Stride);
+		for (j = 0; j < 4; j++) {
+			for (i = 0; i < 4; i++) {
+				Nibble = (Src[j * 2 + i / 2] >> ((i & 1) * 4)) & 0x0F;
+				Dest[j * Stride + i * 4 + 3] = (ILubyte)(Nibble | (Nibble << 4));
+			}
+		}
+	}
+}
+
+static void iDecodeDxt5_C(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte	Pal[16], Alphas[8];
+	ILuint	i, j, Bits = 0;
+
+	for (; NumBlocks > 0; NumBlocks--, Src += 16, Dest += 16) {
+		iDxtcPalette(Src + 8, IL_FALSE, 0, Pal);
+		iDxtcColours_C(Src + 8, Pal, Dest, Stride);
+		iDxt5Alphas(Src, Alphas);
+		// Two rows in each 24 bits
+		for (j = 0; j < 4; j++) {
+			if (j % 2 == 0)
+				Bits = Src[2 + j / 2 * 3] | (Src[3 + j / 2 * 3] << 8) | (Src[4 + j / 2 * 3] << 16);
+			for (i = 0; i < 4; i++, Bits >>= 3)
+				Dest[j * Stride + i * 4 + 3] = Alphas[Bits & 7];
+		}
+	}
+}
+
+
+#ifdef IL_HAVE_X86_SIMD
+
+//
+// SSE2
+//
+
+IL_TARGET("sse2")
+static void iSwapRB4_SSE2(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix)
+{
+	const __m128i	MaskGA = _mm_set1_epi32((int)0xFF00FF00), MaskRB = _mm_set1_epi32(0x00FF00FF);
+	__m128i			v, rb;
+
+	for (; NumPix >= 4; NumPix -= 4, Src += 16, Dest += 16) {
+		v = _mm_loadu_si128((const __m128i*)Src);
+		rb = _mm_and_si128(v, MaskRB);
+		rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+		_mm_storeu_si128((__m128i*)Dest, _mm_or_si128(_mm_and_si128(v, MaskGA), rb));
+	}
+	iSwapRB4_C(Src, Dest, NumPix);
+}
+
+// Factors[0] * R + Factors[1] * G + Factors[2] * B, added in the same order as
+//  iLuminance_C so that the results are identical.
+IL_TARGET("sse2")
+static inline __m128i iWeigh_SSE2(__m128i R, __m128i G, __m128i B, const ILfloat *Factors)
+{
+	__m128 Sum;
+
+	Sum = _mm_mul_ps(_mm_cvtepi32_ps(R), _mm_set1_ps(Factors[0]));
+	Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_cvtepi32_ps(G), _mm_set1_ps(Factors[1])));
+	Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_cvtepi32_ps(B), _mm_set1_ps(Factors[2])));
+	return _mm_cvttps_epi32(Sum);
+}
+
+IL_TARGET("sse2")
+static inline __m128i iLuminance4Px_SSE2(const ILubyte *Src, const ILfloat *Factors)
+{
+	const __m128i	Mask = _mm_set1_epi32(0xFF);
+	__m128i			v = _mm_loadu_si128((const __m128i*)Src);
+
+	return iWeigh_SSE2(_mm_and_si128(v, Mask), _mm_and_si128(_mm_srli_epi32(v, 8), Mask),
+		_mm_and_si128(_mm_srli_epi32(v, 16), Mask), Factors);
+}
+
+// Only 4-byte pixels; 3-byte pixels need the byte shuffles of SSSE3.
+IL_TARGET("sse2")
+static void iLuminance_SSE2(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILuint Bpp, const ILfloat *Factors)
+{
+	__m128i a, b, c, d;
+
+	if (Bpp == 4) {
+		for (; NumPix >= 16; NumPix -= 16, Src += 64, Dest += 16) {
+			a = iLuminance4Px_SSE2(Src, Factors);
+			b = iLuminance4Px_SSE2(Src + 16, Factors);
+			c = iLuminance4Px_SSE2(Src + 32, Factors);
+			d = iLuminance4Px_SSE2(Src + 48, Factors);
+			_mm_storeu_si128((__m128i*)Dest, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+		}
+	}
+	iLuminance_C(Src, Dest, NumPix, Bpp, Factors);
+}
+
+IL_TARGET("sse2")
+static void iByteToShort_SSE2(const ILubyte *Src, ILushort *Dest, ILsizei Num)
+{
+	__m128i v;
+
+	// Interleaving a byte with itself gives (b << 8) | b.
+	for (; Num >= 16; Num -= 16, Src += 16, Dest += 16) {
+		v = _mm_loadu_si128((const __m128i*)Src);
+		_mm_storeu_si128((__m128i*)Dest, _mm_unpacklo_epi8(v, v));
+		_mm_storeu_si128((__m128i*)(Dest + 8), _mm_unpackhi_epi8(v, v));
+	}
+	iByteToShort_C(Src, Dest, Num);
+}
+
+IL_TARGET("sse2")
+static void iShortToByte_SSE2(const ILushort *Src, ILubyte *Dest, ILsizei Num)
+{
+	__m128i a, b;
+
+	for (; Num >= 16; Num -= 16, Src += 16, Dest += 16) {
+		a = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)Src), 8);
+		b = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(Src + 8)), 8);
+		_mm_storeu_si128((__m128i*)Dest, _mm_packus_epi16(a, b));
+	}
+	iShortToByte_C(Src, Dest, Num);
+}
+
+IL_TARGET("sse2")
+static void iByteToFloat_SSE2(const ILubyte *Src, ILfloat *Dest, ILsizei Num)
+{
+	const __m128	Max = _mm_set1_ps((ILfloat)UCHAR_MAX);
+	const __m128i	Zero = _mm_setzero_si128();
+	__m128i			v, lo, hi;
+
+	for (; Num >= 16; Num -= 16, Src += 16, Dest += 16) {
+		v = _mm_loadu_si128((const __m128i*)Src);
+		lo = _mm_unpacklo_epi8(v, Zero);
+		hi = _mm_unpackhi_epi8(v, Zero);
+		// Divide rather than multiply by 1/255, to match the scalar rounding.
+		_mm_storeu_ps(Dest,      _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, Zero)), Max));
+		_mm_storeu_ps(Dest + 4,  _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, Zero)), Max));
+		_mm_storeu_ps(Dest + 8,  _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, Zero)), Max));
+		_mm_storeu_ps(Dest + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, Zero)), Max));
+	}
+	iByteToFloat_C(Src, Dest, Num);
+}
+
+// Clamps to [0, 1] and scales to [0, 255].  A NaN is kept through the clamp
+//  (min/max return their second operand then) and ends up as 0, like the
+//  scalar conversion on x86.
+IL_TARGET("sse2")
+static inline __m128i iFloatToInt_SSE2(const ILfloat *Src)
+{
+	__m128 v = _mm_loadu_ps(Src);
+
+	v = _mm_min_ps(_mm_set1_ps(1.0f), v);
+	v = _mm_max_ps(_mm_setzero_ps(), v);
+	return _mm_cvttps_epi32(_mm_mul_ps(v, _mm_set1_ps((ILfloat)UCHAR_MAX)));
+}
+
+IL_TARGET("sse2")
+static void iFloatToByte_SSE2(const ILfloat *Src, ILubyte *Dest, ILsizei Num)
+{
+	__m128i a, b, c, d;
+
+	for (; Num >= 16; Num -= 16, Src += 16, Dest += 16) {
+		a = iFloatToInt_SSE2(Src);
+		b = iFloatToInt_SSE2(Src + 4);
+		c = iFloatToInt_SSE2(Src + 8);
+		d = iFloatToInt_SSE2(Src + 12);
+		_mm_storeu_si128((__m128i*)Dest, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+	}
+	iFloatToByte_C(Src, Dest, Num);
+}
+
+
+//
+// SSSE3, for the 3-byte pixels
+//
+
+IL_TARGET("ssse3")
+static void iSwapRB3_SSSE3(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix)
+{
+	// Five pixels per 16 bytes; the last byte is put back unchanged, so that
+	//  this also works in place.
+	const __m128i	Shuf = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+
+	for (; NumPix >= 6; NumPix -= 5, Src += 15, Dest += 15)
+		_mm_storeu_si128((__m128i*)Dest, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)Src), Shuf));
+	iSwapRB3_C(Src, Dest, NumPix);
+}
+
+IL_TARGET("ssse3")
+static void iExpand3To4_SSSE3(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILboolean SwapRB)
+{
+	const __m128i	Shuf = SwapRB ?
+		_mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1) :
+		_mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	const __m128i	Alpha = _mm_set1_epi32((int)0xFF000000);
+
+	// Reads 16 bytes for each 4 pixels (12 bytes).
+	for (; NumPix >= 6; NumPix -= 4, Src += 12, Dest += 16)
+		_mm_storeu_si128((__m128i*)Dest, _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)Src), Shuf), Alpha));
+	iExpand3To4_C(Src, Dest, NumPix, SwapRB);
+}
+
+IL_TARGET("ssse3")
+static void iShrink4To3_SSSE3(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILboolean SwapRB)
+{
+	const __m128i	Shuf = SwapRB ?
+		_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+		_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+	// Writes 16 bytes for each 4 pixels (12 bytes).
+	for (; NumPix >= 6; NumPix -= 4, Src += 16, Dest += 12)
+		_mm_storeu_si128((__m128i*)Dest, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)Src), Shuf));
+	iShrink4To3_C(Src, Dest, NumPix, SwapRB);
+}
+
+IL_TARGET("ssse3")
+static void iLuminance_SSSE3(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILuint Bpp, const ILfloat *Factors)
+{
+	const __m128i	ShufR = _mm_setr_epi8(0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1, 9, -1, -1, -1);
+	const __m128i	ShufG = _mm_setr_epi8(1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1);
+	const __m128i	ShufB = _mm_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1);
+	__m128i			v, Lum;
+	int				Packed;
+
+	if (Bpp != 3) {
+		iLuminance_SSE2(Src, Dest, NumPix, Bpp, Factors);
+		return;
+	}
+
+	for (; NumPix >= 6; NumPix -= 4, Src += 12, Dest += 4) {
+		v = _mm_loadu_si128((const __m128i*)Src);
+		Lum = iWeigh_SSE2(_mm_shuffle_epi8(v, ShufR), _mm_shuffle_epi8(v, ShufG), _mm_shuffle_epi8(v, ShufB), Factors);
+		Lum = _mm_packs_epi32(Lum, Lum);
+		Packed = _mm_cvtsi128_si32(_mm_packus_epi16(Lum, Lum));
+		memcpy(Dest, &Packed, 4);
+	}
+	iLuminance_C(Src, Dest, NumPix, Bpp, Factors);
+}
+
+
+// Byte p of the result is the 2-bit colour index of pixel p of a DXTC block.
+//  Multiplying moves the wanted bits of each 16-bit lane to the top.
+IL_TARGET("ssse3")
+static inline __m128i iDxtcIndices_SSSE3(const ILubyte *Block)
+{
+	const __m128i	Mul = _mm_setr_epi16(1 << 14, 1 << 12, 1 << 10, 1 << 8, 1 << 6, 1 << 4, 1 << 2, 1);
+	__m128i			Lo = _mm_set1_epi16((short)(Block[4] | (Block[5] << 8)));
+	__m128i			Hi = _mm_set1_epi16((short)(Block[6] | (Block[7] << 8)));
+
+	Lo = _mm_srli_epi16(_mm_mullo_epi16(Lo, Mul), 14);
+	Hi = _mm_srli_epi16(_mm_mullo_epi16(Hi, Mul), 14);
+	return _mm_packus_epi16(Lo, Hi);
+}
+
+// Byte p of the result is the alpha of pixel p of a DXT3 block.
+IL_TARGET("ssse3")
+static inline __m128i iDxt3Alphas_SSSE3(const ILubyte *Block)
+{
+	const __m128i	Low = _mm_set1_epi8(0x0F);
+	__m128i			Packed = _mm_loadl_epi64((const __m128i*)Block);
+	__m128i			Alphas;
+
+	Alphas = _mm_unpacklo_epi8(_mm_and_si128(Packed, Low), _mm_and_si128(_mm_srli_epi16(Packed, 4), Low));
+	return _mm_or_si128(Alphas, _mm_slli_epi16(Alphas, 4));
+}
+
+// Byte p of the result is the alpha of pixel p of a DXT5 block.
+IL_TARGET("ssse3")
+static inline __m128i iDxt5Alphas_SSSE3(const ILubyte *Block)
+{
+	const __m128i	Mul = _mm_setr_epi16(1 << 13, 1 << 10, 1 << 7, 1 << 4, 1 << 13, 1 << 10, 1 << 7, 1 << 4);
+	ILubyte			Alphas[16];
+	ILuint			Bits01 = Block[2] | (Block[3] << 8) | (Block[4] << 16);
+	ILuint			Bits23 = Block[5] | (Block[6] << 8) | (Block[7] << 16);
+	__m128i			Rows01, Rows23;
+
+	iDxt5Alphas(Block, Alphas);
+	// Each 16-bit lane holds the 12 bits of its row.
+	Rows01 = _mm_unpacklo_epi64(_mm_set1_epi16((short)(Bits01 & 0xFFF)), _mm_set1_epi16((short)(Bits01 >> 12)));
+	Rows23 = _mm_unpacklo_epi64(_mm_set1_epi16((short)(Bits23 & 0xFFF)), _mm_set1_epi16((short)(Bits23 >> 12)));
+	Rows01 = _mm_srli_epi16(_mm_mullo_epi16(Rows01, Mul), 13);
+	Rows23 = _mm_srli_epi16(_mm_mullo_epi16(Rows23, Mul), 13);
+	return _mm_shuffle_epi8(_mm_loadl_epi64((const __m128i*)Alphas), _mm_packus_epi16(Rows01, Rows23));
+}
+
+// Row Row of a DXTC block: the colours of Indices (from iDxtcIndices) looked up
+//  in Pal, with the alphas of Alphas, if any, in the fourth bytes.
+IL_TARGET("ssse3")
+static inline __m128i iDxtcRow_SSSE3(__m128i Pal, __m128i Indices, const __m128i *Alphas, int Row)
+{
+	const __m128i	Channels = _mm_set1_epi32(0x03020100);
+	const __m128i	Spread = _mm_add_epi8(_mm_set1_epi8((char)(Row * 4)),
+						_mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3));
+	__m128i			Pixels;
+
+	Pixels = _mm_shuffle_epi8(Pal, _mm_add_epi8(_mm_slli_epi16(_mm_shuffle_epi8(Indices, Spread), 2), Channels));
+	if (Alphas != NULL)  // Keeps byte 3 of each pixel; the other bytes of the mask have the top bit set.
+		Pixels = _mm_or_si128(Pixels, _mm_shuffle_epi8(*Alphas, _mm_or_si128(Spread, _mm_set1_epi32(0x00808080))));
+	return Pixels;
+}
+
+IL_TARGET("ssse3")
+static void iDecodeDxt1_SSSE3(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte	Pal[16];
+	__m128i	Indices;
+	int		j;
+
+	for (; NumBlocks > 0; NumBlocks--, Src += 8, Dest += 16) {
+		iDxtcPalette(Src, IL_TRUE, 0xFF, Pal);
+		Indices = iDxtcIndices_SSSE3(Src);
+		for (j = 0; j < 4; j++)
+			_mm_storeu_si128((__m128i*)(Dest + j * Stride), iDxtcRow_SSSE3(_mm_loadu_si128((const __m128i*)Pal), Indices, NULL, j));
+	}
+}
+
+IL_TARGET("ssse3")
+static void iDecodeDxt3_SSSE3(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte	Pal[16];
+	__m128i	Indices, Alphas;
+	int		j;
+
+	for (; NumBlocks > 0; NumBlocks--, Src += 16, Dest += 16) {
+		iDxtcPalette(Src + 8, IL_FALSE, 0, Pal);
+		Indices = iDxtcIndices_SSSE3(Src + 8);
+		Alphas = iDxt3Alphas_SSSE3(Src);
+		for (j = 0; j < 4; j++)
+			_mm_storeu_si128((__m128i*)(Dest + j * Stride), iDxtcRow_SSSE3(_mm_loadu_si128((const __m128i*)Pal), Indices, &Alphas, j));
+	}
+}
+
+IL_TARGET("ssse3")
+static void iDecodeDxt5_SSSE3(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte	Pal[16];
+	__m128i	Indices, Alphas;
+	int		j;
+
+	for (; NumBlocks > 0; NumBlocks--, Src += 16, Dest += 16) {
+		iDxtcPalette(Src + 8, IL_FALSE, 0, Pal);
+		Indices = iDxtcIndices_SSSE3(Src + 8);
+		Alphas = iDxt5Alphas_SSSE3(Src);
+		for (j = 0; j < 4; j++)
+			_mm_storeu_si128((__m128i*)(Dest + j * Stride), iDxtcRow_SSSE3(_mm_loadu_si128((const __m128i*)Pal), Indices, &Alphas, j));
+	}
+}
+
+
+//
+// AVX2
+//
+
+// Packs 32 values in [0, 255] held in four vectors of 32-bit integers to bytes, in order.
+IL_TARGET("avx2")
+static inline __m256i iPackToBytes_AVX2(__m256i a, __m256i b, __m256i c, __m256i d)
+{
+	// The packs work within each 128-bit lane, which leaves groups of four
+	//  values from a, b, c and d interleaved; the permute puts them back.
+	__m256i v = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+	return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+IL_TARGET("avx2")
+static void iSwapRB4_AVX2(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix)
+{
+	const __m256i	MaskGA = _mm256_set1_epi32((int)0xFF00FF00), MaskRB = _mm256_set1_epi32(0x00FF00FF);
+	__m256i			v, rb;
+
+	for (; NumPix >= 8; NumPix -= 8, Src += 32, Dest += 32) {
+		v = _mm256_loadu_si256((const __m256i*)Src);
+		rb = _mm256_and_si256(v, MaskRB);
+		rb = _mm256_or_si256(_mm256_slli_epi32(rb, 16), _mm256_srli_epi32(rb, 16));
+		_mm256_storeu_si256((__m256i*)Dest, _mm256_or_si256(_mm256_and_si256(v, MaskGA), rb));
+	}
+	iSwapRB4_SSE2(Src, Dest, NumPix);
+}
+
+// Loads pixels 0-3 of Src into the low lane and pixels 4-7 into the high lane.
+IL_TARGET("avx2")
+static inline __m256i iLoad3Px8_AVX2(const ILubyte *Src)
+{
+	__m256i v = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)Src));
+	return _mm256_inserti128_si256(v, _mm_loadu_si128((const __m128i*)(Src + 12)), 1);
+}
+
+IL_TARGET("avx2")
+static void iExpand3To4_AVX2(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILboolean SwapRB)
+{
+	const __m256i	Shuf = SwapRB ?
+		_mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+						 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1) :
+		_mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+						 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	const __m256i	Alpha = _mm256_set1_epi32((int)0xFF000000);
+
+	// Reads 28 bytes for each 8 pixels (24 bytes).
+	for (; NumPix >= 10; NumPix -= 8, Src += 24, Dest += 32)
+		_mm256_storeu_si256((__m256i*)Dest, _mm256_or_si256(_mm256_shuffle_epi8(iLoad3Px8_AVX2(Src), Shuf), Alpha));
+	iExpand3To4_SSSE3(Src, Dest, NumPix, SwapRB);
+}
+
+IL_TARGET("avx2")
+static inline __m256i iWeigh_AVX2(__m256i R, __m256i G, __m256i B, const ILfloat *Factors)
+{
+	__m256 Sum;
+
+	Sum = _mm256_mul_ps(_mm256_cvtepi32_ps(R), _mm256_set1_ps(Factors[0]));
+	Sum = _mm256_add_ps(Sum, _mm256_mul_ps(_mm256_cvtepi32_ps(G), _mm256_set1_ps(Factors[1])));
+	Sum = _mm256_add_ps(Sum, _mm256_mul_ps(_mm256_cvtepi32_ps(B), _mm256_set1_ps(Factors[2])));
+	return _mm256_cvttps_epi32(Sum);
+}
+
+IL_TARGET("avx2")
+static inline __m256i iLuminance8Px_AVX2(const ILubyte *Src, ILuint Bpp, const ILfloat *Factors)
+{
+	const __m256i	Mask = _mm256_set1_epi32(0xFF);
+	const __m256i	ShufR = _mm256_setr_epi8(0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1, 9, -1, -1, -1,
+											 0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1, 9, -1, -1, -1);
+	const __m256i	ShufG = _mm256_setr_epi8(1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1,
+											 1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1);
+	const __m256i	ShufB = _mm256_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1,
+											 2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1);
+	__m256i			v;
+
+	if (Bpp == 4) {
+		v = _mm256_loadu_si256((const __m256i*)Src);
+		return iWeigh_AVX2(_mm256_and_si256(v, Mask), _mm256_and_si256(_mm256_srli_epi32(v, 8), Mask),
+			_mm256_and_si256(_mm256_srli_epi32(v, 16), Mask), Factors);
+	}
+	v = iLoad3Px8_AVX2(Src);
+	return iWeigh_AVX2(_mm256_shuffle_epi8(v, ShufR), _mm256_shuffle_epi8(v, ShufG), _mm256_shuffle_epi8(v, ShufB), Factors);
+}
+
+IL_TARGET("avx2")
+static void iLuminance_AVX2(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILuint Bpp, const ILfloat *Factors)
+{
+	__m256i a, b, c, d;
+
+	// 3-byte pixels read 4 bytes past the last pixel of each block.
+	for (; NumPix >= 34; NumPix -= 32, Src += 32 * Bpp, Dest += 32) {
+		a = iLuminance8Px_AVX2(Src, Bpp, Factors);
+		b = iLuminance8Px_AVX2(Src + 8 * Bpp, Bpp, Factors);
+		c = iLuminance8Px_AVX2(Src + 16 * Bpp, Bpp, Factors);
+		d = iLuminance8Px_AVX2(Src + 24 * Bpp, Bpp, Factors);
+		_mm256_storeu_si256((__m256i*)Dest, iPackToBytes_AVX2(a, b, c, d));
+	}
+	iLuminance_SSSE3(Src, Dest, NumPix, Bpp, Factors);
+}
+
+IL_TARGET("avx2")
+static void iByteToShort_AVX2(const ILubyte *Src, ILushort *Dest, ILsizei Num)
+{
+	__m256i v;
+
+	for (; Num >= 16; Num -= 16, Src += 16, Dest += 16) {
+		v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)Src));
+		_mm256_storeu_si256((__m256i*)Dest, _mm256_or_si256(v, _mm256_slli_epi16(v, 8)));
+	}
+	iByteToShort_C(Src, Dest, Num);
+}
+
+IL_TARGET("avx2")
+static void iShortToByte_AVX2(const ILushort *Src, ILubyte *Dest, ILsizei Num)
+{
+	__m256i a, b;
+
+	for (; Num >= 32; Num -= 32, Src += 32, Dest += 32) {
+		a = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)Src), 8);
+		b = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(Src + 16)), 8);
+		_mm256_storeu_si256((__m256i*)Dest, _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+	}
+	iShortToByte_SSE2(Src, Dest, Num);
+}
+
+IL_TARGET("avx2")
+static void iByteToFloat_AVX2(const ILubyte *Src, ILfloat *Dest, ILsizei Num)
+{
+	const __m256	Max = _mm256_set1_ps((ILfloat)UCHAR_MAX);
+	__m256i			v;
+
+	for (; Num >= 8; Num -= 8, Src += 8, Dest += 8) {
+		v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)Src));
+		_mm256_storeu_ps(Dest, _mm256_div_ps(_mm256_cvtepi32_ps(v), Max));
+	}
+	iByteToFloat_C(Src, Dest, Num);
+}
+
+IL_TARGET("avx2")
+static inline __m256i iFloatToInt_AVX2(const ILfloat *Src)
+{
+	__m256 v = _mm256_loadu_ps(Src);
+
+	v = _mm256_min_ps(_mm256_set1_ps(1.0f), v);
+	v = _mm256_max_ps(_mm256_setzero_ps(), v);
+	return _mm256_cvttps_epi32(_mm256_mul_ps(v, _mm256_set1_ps((ILfloat)UCHAR_MAX)));
+}
+
+IL_TARGET("avx2")
+static void iFloatToByte_AVX2(const ILfloat *Src, ILubyte *Dest, ILsizei Num)
+{
+	for (; Num >= 32; Num -= 32, Src += 32, Dest += 32) {
+		_mm256_storeu_si256((__m256i*)Dest, iPackToBytes_AVX2(iFloatToInt_AVX2(Src),
+			iFloatToInt_AVX2(Src + 8), iFloatToInt_AVX2(Src + 16), iFloatToInt_AVX2(Src + 24)));
+	}
+	iFloatToByte_SSE2(Src, Dest, Num);
+}
+
+// Two blocks at a time, one in each lane, so that each row of both is one store.
+IL_TARGET("avx2")
+static inline __m256i iPair_AVX2(__m128i Lo, __m128i Hi)
+{
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(Lo), Hi, 1);
+}
+
+// iDxtcRow_SSSE3 for both lanes
+IL_TARGET("avx2")
+static inline __m256i iDxtcRow_AVX2(__m256i Pal, __m256i Indices, const __m256i *Alphas, int Row)
+{
+	const __m256i	Channels = _mm256_set1_epi32(0x03020100);
+	const __m256i	Spread = _mm256_add_epi8(_mm256_set1_epi8((char)(Row * 4)),
+						_mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+										 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3));
+	__m256i			Pixels;
+
+	Pixels = _mm256_shuffle_epi8(Pal, _mm256_add_epi8(_mm256_slli_epi16(_mm256_shuffle_epi8(Indices, Spread), 2), Channels));
+	if (Alphas != NULL)
+		Pixels = _mm256_or_si256(Pixels, _mm256_shuffle_epi8(*Alphas, _mm256_or_si256(Spread, _mm256_set1_epi32(0x00808080))));
+	return Pixels;
+}
+
+IL_TARGET("avx2")
+static void iDecodeDxt1_AVX2(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte	Pal[32];
+	__m256i	Indices;
+	int		j;
+
+	for (; NumBlocks >= 2; NumBlocks -= 2, Src += 16, Dest += 32) {
+		iDxtcPalette(Src, IL_TRUE, 0xFF, Pal);
+		iDxtcPalette(Src + 8, IL_TRUE, 0xFF, Pal + 16);
+		Indices = iPair_AVX2(iDxtcIndices_SSSE3(Src), iDxtcIndices_SSSE3(Src + 8));
+		for (j = 0; j < 4; j++)
+			_mm256_storeu_si256((__m256i*)(Dest + j * Stride), iDxtcRow_AVX2(_mm256_loadu_si256((const __m256i*)Pal), Indices, NULL, j));
+	}
+	if (NumBlocks > 0)
+		iDecodeDxt1_SSSE3(Src, Dest, NumBlocks, Stride);
+}
+
+IL_TARGET("avx2")
+static void iDecodeDxt3_AVX2(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte	Pal[32];
+	__m256i	Indices, Alphas;
+	int		j;
+
+	for (; NumBlocks >= 2; NumBlocks -= 2, Src += 32, Dest += 32) {
+		iDxtcPalette(Src + 8, IL_FALSE, 0, Pal);
+		iDxtcPalette(Src + 24, IL_FALSE, 0, Pal + 16);
+		Indices = iPair_AVX2(iDxtcIndices_SSSE3(Src + 8), iDxtcIndices_SSSE3(Src + 24));
+		Alphas = iPair_AVX2(iDxt3Alphas_SSSE3(Src), iDxt3Alphas_SSSE3(Src + 16));
+		for (j = 0; j < 4; j++)
+			_mm256_storeu_si256((__m256i*)(Dest + j * Stride), iDxtcRow_AVX2(_mm256_loadu_si256((const __m256i*)Pal), Indices, &Alphas, j));
+	}
+	if (NumBlocks > 0)
+		iDecodeDxt3_SSSE3(Src, Dest, NumBlocks, Stride);
+}
+
+IL_TARGET("avx2")
+static void iDecodeDxt5_AVX2(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte	Pal[32];
+	__m256i	Indices, Alphas;
+	int		j;
+
+	for (; NumBlocks >= 2; NumBlocks -= 2, Src += 32, Dest += 32) {
+		iDxtcPalette(Src + 8, IL_FALSE, 0, Pal);
+		iDxtcPalette(Src + 24, IL_FALSE, 0, Pal + 16);
+		Indices = iPair_AVX2(iDxtcIndices_SSSE3(Src + 8), iDxtcIndices_SSSE3(Src + 24));
+		Alphas = iPair_AVX2(iDxt5Alphas_SSSE3(Src), iDxt5Alphas_SSSE3(Src + 16));
+		for (j = 0; j < 4; j++)
+			_mm256_storeu_si256((__m256i*)(Dest + j * Stride), iDxtcRow_AVX2(_mm256_loadu_si256((const __m256i*)Pal), Indices, &Alphas, j));
+	}
+	if (NumBlocks > 0)
+		iDecodeDxt5_SSSE3(Src, Dest, NumBlocks, Stride);
+}
+
+#endif//IL_HAVE_X86_SIMD
+
+
+#ifdef IL_HAVE_NEON
+
+static void iSwapRB3_NEON(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix)
+{
+	uint8x16x3_t	v;
+	uint8x16_t		Temp;
+
+	for (; NumPix >= 16; NumPix -= 16, Src += 48, Dest += 48) {
+		v = vld3q_u8(Src);
+		Temp = v.val[0];  v.val[0] = v.val[2];  v.val[2] = Temp;
+		vst3q_u8(Dest, v);
+	}
+	iSwapRB3_C(Src, Dest, NumPix);
+}
+
+static void iSwapRB4_NEON(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix)
+{
+	uint8x16x4_t	v;
+	uint8x16_t		Temp;
+
+	for (; NumPix >= 16; NumPix -= 16, Src += 64, Dest += 64) {
+		v = vld4q_u8(Src);
+		Temp = v.val[0];  v.val[0] = v.val[2];  v.val[2] = Temp;
+		vst4q_u8(Dest, v);
+	}
+	iSwapRB4_C(Src, Dest, NumPix);
+}
+
+static void iExpand3To4_NEON(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILboolean SwapRB)
+{
+	uint8x16x3_t	v;
+	uint8x16x4_t	Out;
+
+	Out.val[3] = vdupq_n_u8(UCHAR_MAX);
+	for (; NumPix >= 16; NumPix -= 16, Src += 48, Dest += 64) {
+		v = vld3q_u8(Src);
+		Out.val[0] = SwapRB ? v.val[2] : v.val[0];
+		Out.val[1] = v.val[1];
+		Out.val[2] = SwapRB ? v.val[0] : v.val[2];
+		vst4q_u8(Dest, Out);
+	}
+	iExpand3To4_C(Src, Dest, NumPix, SwapRB);
+}
+
+static void iShrink4To3_NEON(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILboolean SwapRB)
+{
+	uint8x16x4_t	v;
+	uint8x16x3_t	Out;
+
+	for (; NumPix >= 16; NumPix -= 16, Src += 64, Dest += 48) {
+		v = vld4q_u8(Src);
+		Out.val[0] = SwapRB ? v.val[2] : v.val[0];
+		Out.val[1] = v.val[1];
+		Out.val[2] = SwapRB ? v.val[0] : v.val[2];
+		vst3q_u8(Dest, Out);
+	}
+	iShrink4To3_C(Src, Dest, NumPix, SwapRB);
+}
+
+// Widens bytes 4 * Quarter to 4 * Quarter + 3 of v to floats.
+static inline float32x4_t iBytesToFloats_NEON(uint8x16_t v, int Quarter)
+{
+	uint16x8_t Half = Quarter < 2 ? vmovl_u8(vget_low_u8(v)) : vmovl_high_u8(v);
+	uint32x4_t Words = (Quarter & 1) ? vmovl_high_u16(Half) : vmovl_u16(vget_low_u16(Half));
+	return vcvtq_f32_u32(Words);
+}
+
+static void iLuminance_NEON(const ILubyte *Src, ILubyte *Dest, ILsizei NumPix, ILuint Bpp, const ILfloat *Factors)
+{
+	uint8x16_t	R, G, B;
+	uint32x4_t	Lum[4];
+	float32x4_t	Sum;
+	int			q;
+
+	for (; NumPix >= 16; NumPix -= 16, Src += 16 * Bpp, Dest += 16) {
+		if (Bpp == 4) {
+			uint8x16x4_t v = vld4q_u8(Src);
+			R = v.val[0];  G = v.val[1];  B = v.val[2];
+		}
+		else {
+			uint8x16x3_t v = vld3q_u8(Src);
+			R = v.val[0];  G = v.val[1];  B = v.val[2];
+		}
+		for (q = 0; q < 4; q++) {
+			Sum = vmulq_n_f32(iBytesToFloats_NEON(R, q), Factors[0]);
+			Sum = vaddq_f32(Sum, vmulq_n_f32(iBytesToFloats_NEON(G, q), Factors[1]));
+			Sum = vaddq_f32(Sum, vmulq_n_f32(iBytesToFloats_NEON(B, q), Factors[2]));
+			Lum[q] = vcvtq_u32_f32(Sum);
+		}
+		vst1q_u8(Dest, vcombine_u8(
+			vmovn_u16(vcombine_u16(vmovn_u32(Lum[0]), vmovn_u32(Lum[1]))),
+			vmovn_u16(vcombine_u16(vmovn_u32(Lum[2]), vmovn_u32(Lum[3])))));
+	}
+	iLuminance_C(Src, Dest, NumPix, Bpp, Factors);
+}
+
+static void iByteToShort_NEON(const ILubyte *Src, ILushort *Dest, ILsizei Num)
+{
+	uint8x16_t v;
+
+	// Interleaving a byte with itself gives (b << 8) | b.
+	for (; Num >= 16; Num -= 16, Src += 16, Dest += 16) {
+		v = vld1q_u8(Src);
+		vst1q_u16(Dest, vreinterpretq_u16_u8(vzip1q_u8(v, v)));
+		vst1q_u16(Dest + 8, vreinterpretq_u16_u8(vzip2q_u8(v, v)));
+	}
+	iByteToShort_C(Src, Dest, Num);
+}
+
+static void iShortToByte_NEON(const ILushort *Src, ILubyte *Dest, ILsizei Num)
+{
+	for (; Num >= 16; Num -= 16, Src += 16, Dest += 16)
+		vst1q_u8(Dest, vcombine_u8(vshrn_n_u16(vld1q_u16(Src), 8), vshrn_n_u16(vld1q_u16(Src + 8), 8)));
+	iShortToByte_C(Src, Dest, Num);
+}
+
+static void iByteToFloat_NEON(const ILubyte *Src, ILfloat *Dest, ILsizei Num)
+{
+	const float32x4_t	Max = vdupq_n_f32((ILfloat)UCHAR_MAX);
+	uint8x16_t			v;
+	int					q;
+
+	for (; Num >= 16; Num -= 16, Src += 16, Dest += 16) {
+		v = vld1q_u8(Src);
+		for (q = 0; q < 4; q++)
+			vst1q_f32(Dest + 4 * q, vdivq_f32(iBytesToFloats_NEON(v, q), Max));
+	}
+	iByteToFloat_C(Src, Dest, Num);
+}
+
+static void iFloatToByte_NEON(const ILfloat *Src, ILubyte *Dest, ILsizei Num)
+{
+	const float32x4_t	One = vdupq_n_f32(1.0f), Zero = vdupq_n_f32(0.0f), Max = vdupq_n_f32((ILfloat)UCHAR_MAX);
+	uint32x4_t			Val[4];
+	int					q;
+
+	for (; Num >= 16; Num -= 16, Src += 16, Dest += 16) {
+		for (q = 0; q < 4; q++)
+			Val[q] = vcvtq_u32_f32(vmulq_f32(vmaxq_f32(Zero, vminq_f32(One, vld1q_f32(Src + 4 * q))), Max));
+		vst1q_u8(Dest, vcombine_u8(
+			vmovn_u16(vcombine_u16(vmovn_u32(Val[0]), vmovn_u32(Val[1]))),
+			vmovn_u16(vcombine_u16(vmovn_u32(Val[2]), vmovn_u32(Val[3])))));
+	}
+	iFloatToByte_C(Src, Dest, Num);
+}
+
+// Byte p of the result is the 2-bit colour index of pixel p of a DXTC block.
+static inline uint8x16_t iDxtcIndices_NEON(const ILubyte *Block)
+{
+	const int16_t	Shifts[8] = { 0, -2, -4, -6, -8, -10, -12, -14 };
+	const int16x8_t	Shift = vld1q_s16(Shifts);
+	const uint16x8_t Three = vdupq_n_u16(3);
+	uint16x8_t		Lo = vdupq_n_u16((uint16_t)(Block[4] | (Block[5] << 8)));
+	uint16x8_t		Hi = vdupq_n_u16((uint16_t)(Block[6] | (Block[7] << 8)));
+
+	Lo = vandq_u16(vshlq_u16(Lo, Shift), Three);
+	Hi = vandq_u16(vshlq_u16(Hi, Shift), Three);
+	return vcombine_u8(vmovn_u16(Lo), vmovn_u16(Hi));
+}
+
+// Byte p of the result is the alpha of pixel p of a DXT3 block.
+static inline uint8x16_t iDxt3Alphas_NEON(const ILubyte *Block)
+{
+	uint8x8_t	Packed = vld1_u8(Block);
+	uint8x8x2_t	Nibbles = vzip_u8(vand_u8(Packed, vdup_n_u8(0x0F)), vshr_n_u8(Packed, 4));
+	uint8x16_t	Alphas = vcombine_u8(Nibbles.val[0], Nibbles.val[1]);
+
+	return vorrq_u8(Alphas, vshlq_n_u8(Alphas, 4));
+}
+
+// Byte p of the result is the alpha of pixel p of a DXT5 block.
+static inline uint8x16_t iDxt5Alphas_NEON(const ILubyte *Block)
+{
+	const int16_t	Shifts[8] = { 0, -3, -6, -9, 0, -3, -6, -9 };
+	const int16x8_t	Shift = vld1q_s16(Shifts);
+	const uint16x8_t Seven = vdupq_n_u16(7);
+	ILubyte			Alphas[16];
+	ILuint			Bits01 = Block[2] | (Block[3] << 8) | (Block[4] << 16);
+	ILuint			Bits23 = Block[5] | (Block[6] << 8) | (Block[7] << 16);
+	uint16x8_t		Rows01, Rows23;
+
+	iDxt5Alphas(Block, Alphas);
+	memset(Alphas + 8, 0, 8);
+	Rows01 = vcombine_u16(vdup_n_u16((uint16_t)(Bits01 & 0xFFF)), vdup_n_u16((uint16_t)(Bits01 >> 12)));
+	Rows23 = vcombine_u16(vdup_n_u16((uint16_t)(Bits23 & 0xFFF)), vdup_n_u16((uint16_t)(Bits23 >> 12)));
+	Rows01 = vandq_u16(vshlq_u16(Rows01, Shift), Seven);
+	Rows23 = vandq_u16(vshlq_u16(Rows23, Shift), Seven);
+	return vqtbl1q_u8(vld1q_u8(Alphas), vcombine_u8(vmovn_u16(Rows01), vmovn_u16(Rows23)));
+}
+
+// Row Row of a DXTC block, as in iDxtcRow_SSSE3.  Out-of-range table indices
+//  give 0 here, which keeps everything but the fourth bytes out of the alphas.
+static inline uint8x16_t iDxtcRow_NEON(uint8x16_t Pal, uint8x16_t Indices, const uint8x16_t *Alphas, int Row)
+{
+	const ILubyte	SpreadBytes[16] = { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3 };
+	const uint8x16_t Channels = vreinterpretq_u8_u32(vdupq_n_u32(0x03020100));
+	uint8x16_t		Spread = vaddq_u8(vld1q_u8(SpreadBytes), vdupq_n_u8((uint8_t)(Row * 4)));
+	uint8x16_t		Pixels;
+
+	Pixels = vqtbl1q_u8(Pal, vaddq_u8(vshlq_n_u8(vqtbl1q_u8(Indices, Spread), 2), Channels));
+	if (Alphas != NULL)
+		Pixels = vorrq_u8(Pixels, vqtbl1q_u8(*Alphas, vorrq_u8(Spread, vreinterpretq_u8_u32(vdupq_n_u32(0x00808080)))));
+	return Pixels;
+}
+
+static void iDecodeDxt1_NEON(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte		Pal[16];
+	uint8x16_t	Indices;
+	int			j;
+
+	for (; NumBlocks > 0; NumBlocks--, Src += 8, Dest += 16) {
+		iDxtcPalette(Src, IL_TRUE, 0xFF, Pal);
+		Indices = iDxtcIndices_NEON(Src);
+		for (j = 0; j < 4; j++)
+			vst1q_u8(Dest + j * Stride, iDxtcRow_NEON(vld1q_u8(Pal), Indices, NULL, j));
+	}
+}
+
+static void iDecodeDxt3_NEON(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte		Pal[16];
+	uint8x16_t	Indices, Alphas;
+	int			j;
+
+	for (; NumBlocks > 0; NumBlocks--, Src += 16, Dest += 16) {
+		iDxtcPalette(Src + 8, IL_FALSE, 0, Pal);
+		Indices = iDxtcIndices_NEON(Src + 8);
+		Alphas = iDxt3Alphas_NEON(Src);
+		for (j = 0; j < 4; j++)
+			vst1q_u8(Dest + j * Stride, iDxtcRow_NEON(vld1q_u8(Pal), Indices, &Alphas, j));
+	}
+}
+
+static void iDecodeDxt5_NEON(const ILubyte *Src, ILubyte *Dest, ILsizei NumBlocks, ILsizei Stride)
+{
+	ILubyte		Pal[16];
+	uint8x16_t	Indices, Alphas;
+	int			j;
+
+	for (; NumBlocks > 0; NumBlocks--, Src += 16, Dest += 16) {
+		iDxtcPalette(Src + 8, IL_FALSE, 0, Pal);
+		Indices = iDxtcIndices_NEON(Src + 8);
+		Alphas = iDxt5Alphas_NEON(Src);
+		for (j = 0; j < 4; j++)
+			vst1q_u8(Dest + j * Stride, iDxtcRow_NEON(vld1q_u8(Pal), Indices, &Alphas, j));
+	}
+}
+
+#endif//IL_HAVE_NEON
+
+
+// Finds the best instruction set the CPU and operating system support.
+static ILenum iDetectSimd()
+{
+#if defined(IL_HAVE_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return IL_SIMD_AVX2;
+	if (__builtin_cpu_supports("ssse3"))
+		return IL_SIMD_SSSE3;
+	if (__builtin_cpu_supports("sse2"))
+		return IL_SIMD_SSE2;
+	return IL_SIMD_NONE;
+#elif defined(IL_HAVE_X86_SIMD) && defined(_MSC_VER)
+	int Info[4], MaxLeaf;
+
+	__cpuid(Info, 0);
+	MaxLeaf = Info[0];
+	__cpuid(Info, 1);
+	// AVX2 also needs the OS to save the upper halves of the registers (OSXSAVE and XCR0).
+	if (MaxLeaf >= 7 && (Info[2] & (1 << 27)) && (Info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6) {
+		int Leaf7[4];
+		__cpuidex(Leaf7, 7, 0);
+		if (Leaf7[1] & (1 << 5))
+			return IL_SIMD_AVX2;
+	}
+	if (Info[2] & (1 << 9))
+		return IL_SIMD_SSSE3;
+	if (Info[3] & (1 << 26))
+		return IL_SIMD_SSE2;
+	return IL_SIMD_NONE;
+#elif defined(IL_HAVE_NEON)
+	return IL_SIMD_NEON;
+#else
+	return IL_SIMD_NONE;
+#endif
+}
+
+
+// Kernels for Level, which the CPU must support.
+static iConvKernels iMakeConvKernels(ILenum Level)
+{
+	iConvKernels K;
+
+	K.Level = Level;
+	K.SwapRB3 = iSwapRB3_C;
+	K.SwapRB4 = iSwapRB4_C;
+	K.Expand3To4 = iExpand3To4_C;
+	K.Shrink4To3 = iShrink4To3_C;
+	K.Luminance = iLuminance_C;
+	K.ByteToShort = iByteToShort_C;
+	K.ShortToByte = iShortToByte_C;
+	K.ByteToFloat = iByteToFloat_C;
+	K.FloatToByte = iFloatToByte_C;
+	K.DecodeDxt1 = iDecodeDxt1_C;
+	K.DecodeDxt3 = iDecodeDxt3_C;
+	K.DecodeDxt5 = iDecodeDxt5_C;
+
+#ifdef IL_HAVE_X86_SIMD
+	if (Level >= IL_SIMD_SSE2) {
+		K.SwapRB4 = iSwapRB4_SSE2;
+		K.Luminance = iLuminance_SSE2;
+		K.ByteToShort = iByteToShort_SSE2;
+		K.ShortToByte = iShortToByte_SSE2;
+		K.ByteToFloat = iByteToFloat_SSE2;
+		K.FloatToByte = iFloatToByte_SSE2;
+	}
+	if (Level >= IL_SIMD_SSSE3) {
+		K.SwapRB3 = iSwapRB3_SSSE3;
+		K.Expand3To4 = iExpand3To4_SSSE3;
+		K.Shrink4To3 = iShrink4To3_SSSE3;
+		K.Luminance = iLuminance_SSSE3;
+		K.DecodeDxt1 = iDecodeDxt1_SSSE3;
+		K.DecodeDxt3 = iDecodeDxt3_SSSE3;
+		K.DecodeDxt5 = iDecodeDxt5_SSSE3;
+	}
+	if (Level >= IL_SIMD_AVX2) {
+		K.SwapRB4 = iSwapRB4_AVX2;
+		K.Expand3To4 = iExpand3To4_AVX2;
+		K.Luminance = iLuminance_AVX2;
+		K.ByteToShort = iByteToShort_AVX2;
+		K.ShortToByte = iShortToByte_AVX2;
+		K.ByteToFloat = iByteToFloat_AVX2;
+		K.FloatToByte = iFloatToByte_AVX2;
+		K.DecodeDxt1 = iDecodeDxt1_AVX2;
+		K.DecodeDxt3 = iDecodeDxt3_AVX2;
+		K.DecodeDxt5 = iDecodeDxt5_AVX2;
+	}
+#endif
+#ifdef IL_HAVE_NEON
+	if (Level == IL_SIMD_NEON) {
+		K.SwapRB3 = iSwapRB3_NEON;
+		K.SwapRB4 = iSwapRB4_NEON;
+		K.Expand3To4 = iExpand3To4_NEON;
+		K.Shrink4To3 = iShrink4To3_NEON;
+		K.Luminance = iLuminance_NEON;
+		K.ByteToShort = iByteToShort_NEON;
+		K.ShortToByte = iShortToByte_NEON;
+		K.ByteToFloat = iByteToFloat_NEON;
+		K.FloatToByte = iFloatToByte_NEON;
+		K.DecodeDxt1 = iDecodeDxt1_NEON;
+		K.DecodeDxt3 = iDecodeDxt3_NEON;
+		K.DecodeDxt5 = iDecodeDxt5_NEON;
+	}
+#endif
+
+	return K;
+}
+
+
+const iConvKernels* iGetConvKernels(void)
+{
+	static const iConvKernels Kernels = iMakeConvKernels(iDetectSimd());
+	return &Kernels;
+}
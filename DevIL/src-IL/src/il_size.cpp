@@ -6,7 +6,8 @@
 //
 // Filename: src-IL/src/il_size.cpp
 //
-// Description: Determines the size of output files for lump writing.
+// Description: Determines the size of output files for lump writing and saves
+//              to growable memory buffers.
 //
 //-----------------------------------------------------------------------------
 
@@ -18,6 +19,7 @@
 #include "il_hdr.h"
 #include "il_jp2.h"
 #include "il_jpeg.h"
+#include "il_ktx.h"
 #include "il_pcx.h"
 #include "il_png.h"
 #include "il_pnm.h"
@@ -26,10 +28,11 @@
 #include "il_sgi.h"
 #include "il_targa.h"
 #include "il_tiff.h"
+#include "il_vtf.h"
 #include "il_wbmp.h"
 
 //! Fake seek function
-ILint ILAPIENTRY iSizeSeek(ILcontext* context, ILint Offset, ILuint Mode)
+ILint ILAPIENTRY iSizeSeek(ILcontext* context, ILint64 Offset, ILuint Mode)
 {
 	switch (Mode)
 	{
@@ -58,7 +61,7 @@ ILint ILAPIENTRY iSizeSeek(ILcontext* context, ILint Offset, ILuint Mode)
 	return 0;  // Code for success
 }
 
-ILuint ILAPIENTRY iSizeTell(ILcontext* context)
+ILuint64 ILAPIENTRY iSizeTell(ILcontext* context)
 {
 	return context->impl->CurPos;
 }
@@ -73,23 +76,17 @@ ILint ILAPIENTRY iSizePutc(ILcontext* context, ILubyte Char)
 
 ILint ILAPIENTRY iSizeWrite(ILcontext* context, const void *Buffer, ILuint Size, ILuint Number)
 {
-	context->impl->CurPos += Size * Number;
+	context->impl->CurPos += (ILuint64)Size * Number;
 	if (context->impl->CurPos > context->impl->MaxPos)
 		context->impl->MaxPos = context->impl->CurPos;
 	return Number;
 }
 
 
-//@TODO: Do computations for uncompressed formats without going through the
-//       whole writing process.
-
-//! Returns the size of the memory buffer needed to save the current image into this Type.
-//  A return value of 0 is an error.
-ILuint ilDetermineSize(ILcontext* context, ILenum Type)
+// Runs the encoder for Type against the output functions that are currently set.
+//  The handlers leave those alone when saveL is given a NULL lump.
+static ILboolean iSaveToOutput(ILcontext* context, ILenum Type)
 {
-	context->impl->MaxPos = context->impl->CurPos = 0;
-	iSetOutputFake(context);  // Sets iputc, context->impl->iwrite(, etc. to functions above.
-
 	switch (Type)
 	{
 		#ifndef IL_NO_BMP
@@ -97,9 +94,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			BmpHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_BMP
 
 		#ifndef IL_NO_DDS
@@ -107,9 +103,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			DdsHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_DDS
 
 		#ifndef IL_NO_EXR
@@ -117,9 +112,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			ExrHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_EXR
 
 		#ifndef IL_NO_HDR
@@ -127,9 +121,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			HdrHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_HDR
 
 		#ifndef IL_NO_JP2
@@ -137,9 +130,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			Jp2Handler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_JP2
 
 		#ifndef IL_NO_JPG
@@ -147,19 +139,26 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			JpegHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_JPG
 
+		#ifndef IL_NO_KTX
+		case IL_KTX:
+		{
+			KtxHandler handler(context);
+
+			return handler.saveL(NULL, 0) != 0;
+		}
+		#endif//IL_NO_KTX
+
 		#ifndef IL_NO_PCX
 		case IL_PCX:
 		{
 			PcxHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_PCX
 
 		#ifndef IL_NO_PNG
@@ -167,9 +166,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			PngHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_PNG
 
 		#ifndef IL_NO_PNM
@@ -177,9 +175,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			PnmHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_PNM
 
 		#ifndef IL_NO_PSD
@@ -187,9 +184,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			PsdHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_PSD
 
 		#ifndef IL_NO_RAW
@@ -197,9 +193,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			RawHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_RAW
 
 		#ifndef IL_NO_SGI
@@ -207,9 +202,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			SgiHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_SGI
 
 		#ifndef IL_NO_TGA
@@ -217,9 +211,8 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			TargaHandler handler(context);
 
-			handler.size();
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_TGA
 
 		#ifndef IL_NO_TIF
@@ -227,26 +220,89 @@ ILuint ilDetermineSize(ILcontext* context, ILenum Type)
 		{
 			TiffHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_TIF
 
+		#ifndef IL_NO_VTF
+		case IL_VTF:
+		{
+			VtfHandler handler(context);
+
+			return handler.saveL(NULL, 0) != 0;
+		}
+		#endif//IL_NO_VTF
+
 		#ifndef IL_NO_WBMP
 		case IL_WBMP:
 		{
 			WbmpHandler handler(context);
 
-			handler.saveL(NULL, 0);
+			return handler.saveL(NULL, 0) != 0;
 		}
-		break;
 		#endif//IL_NO_WBMP
 
-		default:
-			// 0 is an error for this.
-			ilSetError(context, IL_INVALID_ENUM);
-			return 0;
 	}
 
-	return context->impl->MaxPos;
+	ilSetError(context, IL_INVALID_ENUM);
+	return IL_FALSE;
+
+}
+
+
+//@TODO: Do computations for uncompressed formats without going through the
+//       whole writing process.
+
+//! Returns the size of the memory buffer needed to save the current image into this Type.
+//  A return value of 0 is an error.
+ILuint ilDetermineSize(ILcontext* context, ILenum Type)
+{
+	context->impl->MaxPos = context->impl->CurPos = 0;
+	iSetOutputFake(context);  // Sets iputc, context->impl->iwrite(, etc. to functions above.
+
+	if (!iSaveToOutput(context, Type))
+		return 0;
+
+	// Sizes that do not fit the lump functions are reported as errors, too.
+	if (context->impl->MaxPos > 0xFFFFFFFF) {
+		ilSetError(context, IL_OUT_OF_MEMORY);
+		return 0;
+	}
+	return (ILuint)context->impl->MaxPos;
+}
+
+
+//! Saves the current image to a memory buffer that DevIL allocates and grows as needed.
+/*! Unlike calling ilSaveL twice, once to get the size and once to save, the image is
+	only encoded once.
+	\param Type Format of the saved image.  Accepts the same values as ilSaveL.
+	\param Size Receives the number of bytes written.
+	\return The saved image, or NULL on failure.  Free it with ifree(context, ...),
+	as it comes from the allocator of context.*/
+void* ILAPIENTRY ilSaveToMemory(ILcontext* context, ILenum Type, ILsizei *Size)
+{
+	void *Lump;
+
+	if (Size == NULL) {
+		ilSetError(context, IL_INVALID_PARAM);
+		return NULL;
+	}
+	*Size = 0;
+
+	iSetOutputDynamic(context);
+	if (!iSaveToOutput(context, Type) || context->impl->MaxPos == 0) {
+		ifree(context, context->impl->WriteLump);
+		context->impl->WriteLump = NULL;
+		context->impl->WriteLumpSize = 0;
+		return NULL;
+	}
+
+	// Hand the buffer over to the caller, so that ilGetLumpPos does not see it anymore.
+	Lump = context->impl->WriteLump;
+	*Size = (ILsizei)context->impl->MaxPos;
+	context->impl->WriteLump = NULL;
+	context->impl->WriteLumpPos = 0;
+	context->impl->WriteLumpSize = 0;
+
+	return Lump;
 }
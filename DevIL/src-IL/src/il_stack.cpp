@@ -39,7 +39,7 @@ void ILAPIENTRY ilGenImages(ILcontext* context, ILsizei Num, ILuint *Images)
 			TempFree = (iFree*)context->impl->FreeNames->Next;
 			Images[Index] = context->impl->FreeNames->Name;
 			context->impl->ImageStack[context->impl->FreeNames->Name] = ilNewImage(context, 1, 1, 1, 1, 1);
-			ifree(context->impl->FreeNames);
+			ifree(context, context->impl->FreeNames);
 			context->impl->FreeNames = TempFree;
 		}
 		else {
@@ -129,7 +129,7 @@ void ILAPIENTRY ilDeleteImages(ILcontext* context, ILsizei Num, const ILuint *Im
 			}
 			
 			// Should *NOT* be NULL here!
-			ilCloseImage(context->impl->ImageStack[Images[Index]]);
+			ilCloseImage(context, context->impl->ImageStack[Images[Index]]);
 			context->impl->ImageStack[Images[Index]] = NULL;
 
 			// Add to head of list - works for empty and non-empty lists
@@ -175,60 +175,60 @@ ILboolean ILAPIENTRY ilIsImage(ILcontext* context, ILuint Image)
 
 
 //! Closes Image and frees all memory associated with it.
-ILAPI void ILAPIENTRY ilCloseImage(ILimage *Image)
+ILAPI void ILAPIENTRY ilCloseImage(ILcontext* context, ILimage *Image)
 {
 	if (Image == NULL)
 		return;
 
 	if (Image->Data != NULL) {
-		ifree(Image->Data);
+		ifree(context, Image->Data);
 		Image->Data = NULL;
 	}
 
 	if (Image->Pal.Palette != NULL && Image->Pal.PalSize > 0 && Image->Pal.PalType != IL_PAL_NONE) {
-		ifree(Image->Pal.Palette);
+		ifree(context, Image->Pal.Palette);
 		Image->Pal.Palette = NULL;
 	}
 
 	if (Image->Next != NULL) {
-		ilCloseImage(Image->Next);
+		ilCloseImage(context, Image->Next);
 		Image->Next = NULL;
 	}
 
 	if (Image->Faces != NULL) {
-		ilCloseImage(Image->Faces);
+		ilCloseImage(context, Image->Faces);
 		Image->Mipmaps = NULL;
 	}
 
 	if (Image->Mipmaps != NULL) {
-		ilCloseImage(Image->Mipmaps);
+		ilCloseImage(context, Image->Mipmaps);
 		Image->Mipmaps = NULL;
 	}
 
 	if (Image->Layers != NULL) {
-		ilCloseImage(Image->Layers);
+		ilCloseImage(context, Image->Layers);
 		Image->Layers = NULL;
 	}
 
 	if (Image->AnimList != NULL && Image->AnimSize != 0) {
-		ifree(Image->AnimList);
+		ifree(context, Image->AnimList);
 		Image->AnimList = NULL;
 	}
 
 	if (Image->Profile != NULL && Image->ProfileSize != 0) {
-		ifree(Image->Profile);
+		ifree(context, Image->Profile);
 		Image->Profile = NULL;
 		Image->ProfileSize = 0;
 	}
 
 	if (Image->DxtcData != NULL && Image->DxtcFormat != IL_DXT_NO_COMP) {
-		ifree(Image->DxtcData);
+		ifree(context, Image->DxtcData);
 		Image->DxtcData = NULL;
 		Image->DxtcFormat = IL_DXT_NO_COMP;
 		Image->DxtcSize = 0;
 	}
 
-	ifree(Image);
+	ifree(context, Image);
 	Image = NULL;
 
 	return;
@@ -256,14 +256,14 @@ ILAPI ILboolean ILAPIENTRY ilIsValidPal(ILpal *Palette)
 
 
 //! Closes Palette and frees all memory associated with it.
-ILAPI void ILAPIENTRY ilClosePal(ILpal *Palette)
+ILAPI void ILAPIENTRY ilClosePal(ILcontext* context, ILpal *Palette)
 {
 	if (Palette == NULL)
 		return;
 	if (!ilIsValidPal(Palette))
 		return;
-	ifree(Palette->Palette);
-	ifree(Palette);
+	ifree(context, Palette->Palette);
+	ifree(context, Palette);
 	return;
 }
 
@@ -447,21 +447,21 @@ ILuint ILAPIENTRY ilCreateSubImage(ILcontext* context, ILenum Type, ILuint Num)
 	{
 		case IL_SUB_NEXT:
 			if (context->impl->iCurImage->Next)
-				ilCloseImage(context->impl->iCurImage->Next);
+				ilCloseImage(context, context->impl->iCurImage->Next);
 			context->impl->iCurImage->Next = ilNewImage(context, 1, 1, 1, 1, 1);
 			SubImage = context->impl->iCurImage->Next;
 			break;
 
 		case IL_SUB_MIPMAP:
 			if (context->impl->iCurImage->Mipmaps)
-				ilCloseImage(context->impl->iCurImage->Mipmaps);
+				ilCloseImage(context, context->impl->iCurImage->Mipmaps);
 			context->impl->iCurImage->Mipmaps = ilNewImage(context, 1, 1, 1, 1, 1);
 			SubImage = context->impl->iCurImage->Mipmaps;
 			break;
 
 		case IL_SUB_LAYER:
 			if (context->impl->iCurImage->Layers)
-				ilCloseImage(context->impl->iCurImage->Layers);
+				ilCloseImage(context, context->impl->iCurImage->Layers);
 			context->impl->iCurImage->Layers = ilNewImage(context, 1, 1, 1, 1, 1);
 			SubImage = context->impl->iCurImage->Layers;
 			break;
@@ -515,7 +515,7 @@ ILAPI void ILAPIENTRY ilReplaceCurImage(ILcontext* context, ILimage *Image)
 {
 	if (context->impl->iCurImage) {
 		ilActiveImage(context, 0);
-		ilCloseImage(context->impl->iCurImage);
+		ilCloseImage(context, context->impl->iCurImage);
 	}
 	context->impl->ImageStack[ilGetCurName(context)] = Image;
 	context->impl->iCurImage = Image;
@@ -533,7 +533,7 @@ void* ILAPIENTRY ilRecalloc(ILcontext* context, void *Ptr, ILuint OldSize, ILuin
 	if (Temp != NULL) {
 		if (Ptr != NULL) {
 			memcpy(Temp, Ptr, CopySize);
-			ifree(Ptr);
+			ifree(context, Ptr);
 		}
 
 		Ptr = Temp;
@@ -574,12 +574,6 @@ ILboolean iEnlargeStack(ILcontext* context)
 	return IL_TRUE;
 }
 
-// To keep Visual Studio happy with its unhappiness with ILAPIENTRY for atexit
-void ilRemoveRegisteredInternal()
-{
-	ilRemoveRegistered();
-}
-
 // ONLY call at startup.
 ILcontext* ILAPIENTRY ilInit()
 {
@@ -591,11 +585,6 @@ ILcontext* ILAPIENTRY ilInit()
 	// Sets default file-reading callbacks.
 	ilResetRead(context);
 	ilResetWrite(context);
-#if (!defined(_WIN32_WCE)) && (!defined(IL_STATIC_LIB))
-	atexit(ilRemoveRegisteredInternal);
-#endif
-	//_WIN32_WCE
-	//ilShutDown();
 	iSetImage0(context);  // Beware!  Clears all existing textures!
 	iBindImageTemp(context);  // Go ahead and create the temporary image.
 	
@@ -603,31 +592,42 @@ ILcontext* ILAPIENTRY ilInit()
 }
 
 
-// Frees any extra memory in the stack.
-//	- Called on exit
-void ILAPIENTRY ilShutDown(ILcontext* context)
+// Frees every image and image name of the context.
+void iFreeImageStack(ILcontext* context)
 {
-	// if it is not initialized do not shutdown
 	iFree* TempFree = (iFree*)context->impl->FreeNames;
 	ILuint i;
-	
+
 	while (TempFree != NULL) {
 		context->impl->FreeNames = (iFree*)TempFree->Next;
-		ifree(TempFree);
+		ifree(context, TempFree);
 		TempFree = context->impl->FreeNames;
 	}
 
 	//for (i = 0; i < context->impl->LastUsed; i++) {
 	for (i = 0; i < context->impl->StackSize; i++) {
 		if (context->impl->ImageStack[i] != NULL)
-			ilCloseImage(context->impl->ImageStack[i]);
+			ilCloseImage(context, context->impl->ImageStack[i]);
 	}
 
 	if (context->impl->ImageStack)
-		ifree(context->impl->ImageStack);
+		ifree(context, context->impl->ImageStack);
 	context->impl->ImageStack = NULL;
+	context->impl->iCurImage = NULL;
 	context->impl->LastUsed = 0;
 	context->impl->StackSize = 0;
+}
+
+
+// Frees all memory held by the context, including the context itself, which
+//  must not be used afterwards.
+void ILAPIENTRY ilShutDown(ILcontext* context)
+{
+	iPushCleanup(context);
+	iFreeImageStack(context);
+	ilRemoveRegistered(context);
+	iFreeStateStrings(context);
+	delete context;
 
 	return;
 }
@@ -26,7 +26,7 @@ ILconst_string _ilVersion		= IL_TEXT("Developer's Image Library (DevIL) 1.8.0");
 char* _ilLoadExt		= (char*)"" IL_BLP_EXT IL_BMP_EXT IL_CUT_EXT IL_DCX_EXT IL_DDS_EXT
 									IL_DCM_EXT IL_DPX_EXT IL_EXR_EXT IL_FITS_EXT IL_FTX_EXT
 									IL_GIF_EXT IL_HDR_EXT IL_ICNS_EXT IL_ICO_EXT IL_IFF_EXT
-									IL_IWI_EXT IL_JPG_EXT IL_JP2_EXT IL_LIF_EXT IL_MDL_EXT
+									IL_IWI_EXT IL_JPG_EXT IL_JP2_EXT IL_KTX_EXT IL_LIF_EXT IL_MDL_EXT
 									IL_MNG_EXT IL_MP3_EXT IL_PCD_EXT IL_PCX_EXT IL_PIC_EXT
 									IL_PIX_EXT IL_PNG_EXT IL_PNM_EXT IL_PSD_EXT IL_PSP_EXT
 									IL_PXR_EXT IL_RAW_EXT IL_ROT_EXT IL_SGI_EXT IL_SUN_EXT
@@ -34,7 +34,7 @@ char* _ilLoadExt		= (char*)"" IL_BLP_EXT IL_BMP_EXT IL_CUT_EXT IL_DCX_EXT IL_DDS
 									IL_VTF_EXT IL_WAL_EXT IL_WDP_EXT IL_XPM_EXT;
 
 char* _ilSaveExt		= (char*)"" IL_BMP_EXT IL_CHEAD_EXT IL_DDS_EXT IL_EXR_EXT
-									IL_HDR_EXT IL_JP2_EXT IL_JPG_EXT IL_PCX_EXT
+									IL_HDR_EXT IL_JP2_EXT IL_JPG_EXT IL_KTX_EXT IL_PCX_EXT
 									IL_PNG_EXT IL_PNM_EXT IL_PSD_EXT IL_RAW_EXT
 									IL_SGI_EXT IL_TGA_EXT IL_TIF_EXT IL_VTF_EXT
 									IL_WBMP_EXT;
@@ -50,6 +50,7 @@ void ilDefaultStates(ILcontext* context)
 	context->impl->ilStates[context->impl->ilCurrentPos].ilTypeSet = IL_FALSE;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilTypeMode = IL_UNSIGNED_BYTE;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilOverWriteFiles = IL_FALSE;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilMapFiles = IL_FALSE;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilAutoConvPal = IL_FALSE;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilDefaultOnFail = IL_FALSE;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilUseKeyColour = IL_FALSE;
@@ -65,10 +66,21 @@ void ilDefaultStates(ILcontext* context)
 	context->impl->ilStates[context->impl->ilCurrentPos].ilSgiRle = IL_FALSE;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilJpgFormat = IL_JFIF;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilJpgProgressive = IL_FALSE;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilJpgDecodeScale = 1;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilJpgDecodeSize = 0;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilPngCompression = 6;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilPngFilter = IL_PNG_FILTER_ADAPTIVE;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilPngStrategy = IL_PNG_STRATEGY_DEFAULT;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilExrThreads = 0;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilPngFast = IL_FALSE;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilDxtcFormat = IL_DXT1;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilDxtcQuality = IL_DXTC_MINMAX;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilBptcEffort = 4;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilPcdPicNum = 2;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilPngAlphaIndex = -1;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilVtfCompression = IL_DXT_NO_COMP;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilKtxCompression = IL_DXT_NO_COMP;
+	context->impl->ilStates[context->impl->ilCurrentPos].ilEtcQuality = 1;
 
 	context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId = NULL;
 	context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName = NULL;
@@ -145,6 +157,72 @@ ILconst_string ILAPIENTRY ilGetString(ILcontext* context, ILenum StringName)
 }
 
 
+// Copies a string set with ilSetString with the allocator of context, which
+//  frees it again.  Returns NULL for NULL.
+static char *iStateStrDup(ILcontext* context, const char *String)
+{
+	char	*Copy;
+	ILuint	Length;
+
+	if (String == NULL)
+		return NULL;
+
+	Length = ilCharStrLen(String);
+	Copy = (char*)ialloc(context, Length + 1);
+	if (Copy != NULL)
+		memcpy(Copy, String, Length + 1);
+
+	return Copy;
+}
+
+
+// Fills Strings with the addresses of the string members of States and
+//  returns how many there are.
+static ILuint iStateStrings(IL_STATES *States, char **Strings[])
+{
+	Strings[0] = &States->ilTgaId;
+	Strings[1] = &States->ilTgaAuthName;
+	Strings[2] = &States->ilTgaAuthComment;
+	Strings[3] = &States->ilPngAuthName;
+	Strings[4] = &States->ilPngTitle;
+	Strings[5] = &States->ilPngDescription;
+	Strings[6] = &States->ilTifDescription;
+	Strings[7] = &States->ilTifHostComputer;
+	Strings[8] = &States->ilTifDocumentName;
+	Strings[9] = &States->ilTifAuthName;
+	Strings[10] = &States->ilCHeader;
+	return 11;
+}
+
+
+// Replaces the strings of States, which belong to another context, with
+//  copies of its own.
+void iCopyStateStrings(ILcontext* context, IL_STATES *States)
+{
+	char	**Strings[11];
+	ILuint	i, Num = iStateStrings(States, Strings);
+
+	for (i = 0; i < Num; i++)
+		*Strings[i] = iStateStrDup(context, *Strings[i]);
+}
+
+
+// Frees the strings of every level of the attribute stack.
+void iFreeStateStrings(ILcontext* context)
+{
+	char	**Strings[11];
+	ILuint	i, Num, Pos;
+
+	for (Pos = 0; Pos < IL_ATTRIB_STACK_MAX; Pos++) {
+		Num = iStateStrings(&context->impl->ilStates[Pos], Strings);
+		for (i = 0; i < Num; i++) {
+			ifree(context, *Strings[i]);
+			*Strings[i] = NULL;
+		}
+	}
+}
+
+
 // Clips a string to a certain length and returns a new string.
 char *iClipString(ILcontext* context, char *String, ILuint MaxLen)
 {
@@ -235,6 +313,9 @@ ILboolean ilAble(ILcontext* context, ILenum Mode, ILboolean Flag)
 		case IL_FILE_OVERWRITE:
 			context->impl->ilStates[context->impl->ilCurrentPos].ilOverWriteFiles = Flag;
 			break;
+		case IL_FILE_MAPPING:
+			context->impl->ilStates[context->impl->ilCurrentPos].ilMapFiles = Flag;
+			break;
 		case IL_CONV_PAL:
 			context->impl->ilStates[context->impl->ilCurrentPos].ilAutoConvPal = Flag;
 			break;
@@ -253,6 +334,9 @@ ILboolean ilAble(ILcontext* context, ILenum Mode, ILboolean Flag)
 		case IL_JPG_PROGRESSIVE:
 			context->impl->ilStates[context->impl->ilCurrentPos].ilJpgProgressive = Flag;
 			break;
+		case IL_PNG_FAST:
+			context->impl->ilStates[context->impl->ilCurrentPos].ilPngFast = Flag;
+			break;
 		case IL_NVIDIA_COMPRESS:
 			context->impl->ilStates[context->impl->ilCurrentPos].ilUseNVidiaDXT = Flag;
 			break;
@@ -282,6 +366,8 @@ ILboolean ILAPIENTRY ilIsEnabled(ILcontext* context, ILenum Mode)
 			return context->impl->ilStates[context->impl->ilCurrentPos].ilTypeSet;
 		case IL_FILE_OVERWRITE:
 			return context->impl->ilStates[context->impl->ilCurrentPos].ilOverWriteFiles;
+		case IL_FILE_MAPPING:
+			return context->impl->ilStates[context->impl->ilCurrentPos].ilMapFiles;
 		case IL_CONV_PAL:
 			return context->impl->ilStates[context->impl->ilCurrentPos].ilAutoConvPal;
 		case IL_DEFAULT_ON_FAIL:
@@ -294,6 +380,8 @@ ILboolean ILAPIENTRY ilIsEnabled(ILcontext* context, ILenum Mode)
 			return context->impl->ilStates[context->impl->ilCurrentPos].ilInterlace;
 		case IL_JPG_PROGRESSIVE:
 			return context->impl->ilStates[context->impl->ilCurrentPos].ilJpgProgressive;
+		case IL_PNG_FAST:
+			return context->impl->ilStates[context->impl->ilCurrentPos].ilPngFast;
 		case IL_NVIDIA_COMPRESS:
 			return context->impl->ilStates[context->impl->ilCurrentPos].ilUseNVidiaDXT;
 		case IL_SQUISH_COMPRESS:
@@ -432,6 +520,12 @@ void ILAPIENTRY ilGetIntegerv(ILcontext* context, ILenum Mode, ILint *Param)
 		case IL_FORMAT_MODE:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilFormatMode;
 			break;
+		case IL_PUSH_PASSES:
+			*Param = context->impl->PushPasses;
+			break;
+		case IL_PUSH_ROWS:
+			*Param = context->impl->PushRows;
+			break;
 		case IL_INTERLACE_MODE:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilInterlace;
 			break;
@@ -471,12 +565,24 @@ void ILAPIENTRY ilGetIntegerv(ILcontext* context, ILenum Mode, ILint *Param)
 		case IL_DXTC_FORMAT:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilDxtcFormat;
 			break;
+		case IL_DXTC_QUALITY:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilDxtcQuality;
+			break;
+		case IL_BPTC_EFFORT:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilBptcEffort;
+			break;
 		case IL_JPG_QUALITY:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilJpgQuality;
 			break;
 		case IL_JPG_SAVE_FORMAT:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilJpgFormat;
 			break;
+		case IL_JPG_DECODE_SCALE:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilJpgDecodeScale;
+			break;
+		case IL_JPG_DECODE_SIZE:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilJpgDecodeSize;
+			break;
 		case IL_PCD_PICNUM:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilPcdPicNum;
 			break;
@@ -486,6 +592,18 @@ void ILAPIENTRY ilGetIntegerv(ILcontext* context, ILenum Mode, ILint *Param)
 		case IL_PNG_INTERLACE:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilPngInterlace;
 			break;
+		case IL_PNG_COMPRESSION:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilPngCompression;
+			break;
+		case IL_PNG_FILTER:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilPngFilter;
+			break;
+		case IL_PNG_STRATEGY:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilPngStrategy;
+			break;
+		case IL_EXR_THREADS:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilExrThreads;
+			break;
 		case IL_SGI_RLE:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilSgiRle;
 			break;
@@ -498,6 +616,12 @@ void ILAPIENTRY ilGetIntegerv(ILcontext* context, ILenum Mode, ILint *Param)
 		case IL_VTF_COMP:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilVtfCompression;
 			break;
+		case IL_KTX_COMP:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilKtxCompression;
+			break;
+		case IL_ETC_QUALITY:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilEtcQuality;
+			break;
 
 		// Boolean values
 		case IL_CONV_PAL:
@@ -509,6 +633,9 @@ void ILAPIENTRY ilGetIntegerv(ILcontext* context, ILenum Mode, ILint *Param)
 		case IL_FILE_MODE:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilOverWriteFiles;
 			break;
+		case IL_FILE_MAPPING:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilMapFiles;
+			break;
 		case IL_FORMAT_SET:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilFormatSet;
 			break;
@@ -527,6 +654,9 @@ void ILAPIENTRY ilGetIntegerv(ILcontext* context, ILenum Mode, ILint *Param)
 		case IL_JPG_PROGRESSIVE:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilJpgProgressive;
 			break;
+		case IL_PNG_FAST:
+			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilPngFast;
+			break;
 		case IL_NVIDIA_COMPRESS:
 			*Param = context->impl->ilStates[context->impl->ilCurrentPos].ilUseNVidiaDXT;
 			break;
@@ -791,6 +921,7 @@ void ILAPIENTRY ilPushAttrib(ILcontext* context, ILuint Bits)
 	}
 	if (Bits & IL_FILE_BIT) {
 		context->impl->ilStates[context->impl->ilCurrentPos].ilOverWriteFiles = context->impl->ilStates[context->impl->ilCurrentPos-1].ilOverWriteFiles;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilMapFiles = context->impl->ilStates[context->impl->ilCurrentPos-1].ilMapFiles;
 	}
 	if (Bits & IL_PAL_BIT) {
 		context->impl->ilStates[context->impl->ilCurrentPos].ilAutoConvPal = context->impl->ilStates[context->impl->ilCurrentPos-1].ilAutoConvPal;
@@ -809,52 +940,63 @@ void ILAPIENTRY ilPushAttrib(ILcontext* context, ILuint Bits)
 		context->impl->ilStates[context->impl->ilCurrentPos].ilBmpRle = context->impl->ilStates[context->impl->ilCurrentPos-1].ilBmpRle;
 		context->impl->ilStates[context->impl->ilCurrentPos].ilSgiRle = context->impl->ilStates[context->impl->ilCurrentPos-1].ilSgiRle;
 		context->impl->ilStates[context->impl->ilCurrentPos].ilJpgFormat = context->impl->ilStates[context->impl->ilCurrentPos-1].ilJpgFormat;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilJpgDecodeScale = context->impl->ilStates[context->impl->ilCurrentPos-1].ilJpgDecodeScale;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilJpgDecodeSize = context->impl->ilStates[context->impl->ilCurrentPos-1].ilJpgDecodeSize;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilPngCompression = context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngCompression;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilPngFilter = context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngFilter;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilPngStrategy = context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngStrategy;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilPngFast = context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngFast;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilExrThreads = context->impl->ilStates[context->impl->ilCurrentPos-1].ilExrThreads;
 		context->impl->ilStates[context->impl->ilCurrentPos].ilDxtcFormat = context->impl->ilStates[context->impl->ilCurrentPos-1].ilDxtcFormat;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilDxtcQuality = context->impl->ilStates[context->impl->ilCurrentPos-1].ilDxtcQuality;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilBptcEffort = context->impl->ilStates[context->impl->ilCurrentPos-1].ilBptcEffort;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilKtxCompression = context->impl->ilStates[context->impl->ilCurrentPos-1].ilKtxCompression;
+		context->impl->ilStates[context->impl->ilCurrentPos].ilEtcQuality = context->impl->ilStates[context->impl->ilCurrentPos-1].ilEtcQuality;
 		context->impl->ilStates[context->impl->ilCurrentPos].ilPcdPicNum = context->impl->ilStates[context->impl->ilCurrentPos-1].ilPcdPicNum;
 
 		context->impl->ilStates[context->impl->ilCurrentPos].ilPngAlphaIndex = context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngAlphaIndex;
 
 		// Strings
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId);
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName);
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment);
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName);
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle);
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription);
 
 		//2003-09-01: added tif strings
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription);
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer);
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName);
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName);
 
 		if (context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader)
-			ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader);
+			ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader);
 
-		context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilTgaId);
-		context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilTgaAuthName);
-		context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilTgaAuthComment);
-		context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngAuthName);
-		context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngTitle);
-		context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngDescription);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilTgaId);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilTgaAuthName);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilTgaAuthComment);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngAuthName);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngTitle);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilPngDescription);
 
 		//2003-09-01: added tif strings
-		context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilTifDescription);
-		context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilTifHostComputer);
-		context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilTifDocumentName);
-		context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilTifAuthName);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilTifDescription);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilTifHostComputer);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilTifDocumentName);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilTifAuthName);
 
-		context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader = strdup(context->impl->ilStates[context->impl->ilCurrentPos-1].ilCHeader);
+		context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader = iStateStrDup(context, context->impl->ilStates[context->impl->ilCurrentPos-1].ilCHeader);
 	}
 
 	return;
@@ -956,61 +1098,61 @@ void ILAPIENTRY ilSetString(ILcontext* context, ILenum Mode, const char *String)
 	{
 		case IL_TGA_ID_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilTgaId = iStateStrDup(context, String);
 			break;
 		case IL_TGA_AUTHNAME_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthName = iStateStrDup(context, String);
 			break;
 		case IL_TGA_AUTHCOMMENT_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilTgaAuthComment = iStateStrDup(context, String);
 			break;
 		case IL_PNG_AUTHNAME_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilPngAuthName = iStateStrDup(context, String);
 			break;
 		case IL_PNG_TITLE_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilPngTitle = iStateStrDup(context, String);
 			break;
 		case IL_PNG_DESCRIPTION_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilPngDescription = iStateStrDup(context, String);
 			break;
 
 		//2003-09-01: added tif strings
 		case IL_TIF_DESCRIPTION_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilTifDescription = iStateStrDup(context, String);
 			break;
 		case IL_TIF_HOSTCOMPUTER_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilTifHostComputer = iStateStrDup(context, String);
 			break;
 		case IL_TIF_DOCUMENTNAME_STRING:
 						if (context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilTifDocumentName = iStateStrDup(context, String);
 			break;
 		case IL_TIF_AUTHNAME_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilTifAuthName = iStateStrDup(context, String);
 			break;
 
 		case IL_CHEAD_HEADER_STRING:
 			if (context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader)
-				ifree(context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader);
-			context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader = strdup(String);
+				ifree(context, context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader);
+			context->impl->ilStates[context->impl->ilCurrentPos].ilCHeader = iStateStrDup(context, String);
 			break;
 
 		default:
@@ -1098,11 +1240,24 @@ void ILAPIENTRY ilSetInteger(ILcontext* context, ILenum Mode, ILint Param)
 			}
 			break;
 		case IL_DXTC_FORMAT:
-			if (Param >= IL_DXT1 || Param <= IL_DXT5 || Param == IL_DXT1A) {
+			if ((Param >= IL_DXT1 && Param <= IL_DXT5) || Param == IL_DXT1A || Param == IL_3DC || Param == IL_RXGB
+				|| Param == IL_ATI1N || Param == IL_BC7 || Param == IL_BC6H || Param == IL_BC6H_SF) {
 				context->impl->ilStates[context->impl->ilCurrentPos].ilDxtcFormat = Param;
 				return;
 			}
 			break;
+		case IL_DXTC_QUALITY:
+			if (Param == IL_DXTC_MINMAX || Param == IL_DXTC_RANGE_FIT || Param == IL_DXTC_CLUSTER_FIT) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilDxtcQuality = Param;
+				return;
+			}
+			break;
+		case IL_BPTC_EFFORT:
+			if (Param >= 0 && Param <= 64) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilBptcEffort = Param;
+				return;
+			}
+			break;
 		case IL_JPG_SAVE_FORMAT:
 			if (Param == IL_JFIF || Param == IL_EXIF) {
 				context->impl->ilStates[context->impl->ilCurrentPos].ilJpgFormat = Param;
@@ -1115,12 +1270,48 @@ void ILAPIENTRY ilSetInteger(ILcontext* context, ILenum Mode, ILint Param)
 				return;
 			}
 			break;
+		case IL_JPG_DECODE_SCALE:
+			if (Param == 1 || Param == 2 || Param == 4 || Param == 8) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilJpgDecodeScale = Param;
+				return;
+			}
+			break;
+		case IL_JPG_DECODE_SIZE:
+			if (Param >= 0) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilJpgDecodeSize = Param;
+				return;
+			}
+			break;
 		case IL_PNG_INTERLACE:
 			if (Param == IL_FALSE || Param == IL_TRUE) {
 				context->impl->ilStates[context->impl->ilCurrentPos].ilPngInterlace = Param;
 				return;
 			}
 			break;
+		case IL_PNG_COMPRESSION:
+			if (Param >= 0 && Param <= 9) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilPngCompression = Param;
+				return;
+			}
+			break;
+		case IL_PNG_FILTER:
+			if (Param >= IL_PNG_FILTER_NONE && Param <= IL_PNG_FILTER_ADAPTIVE) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilPngFilter = Param;
+				return;
+			}
+			break;
+		case IL_PNG_STRATEGY:
+			if (Param >= IL_PNG_STRATEGY_DEFAULT && Param <= IL_PNG_STRATEGY_RLE) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilPngStrategy = Param;
+				return;
+			}
+			break;
+		case IL_EXR_THREADS:
+			if (Param >= 0 && Param <= 256) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilExrThreads = Param;
+				return;
+			}
+			break;
 		case IL_PCD_PICNUM:
 			if (Param >= 0 || Param <= 2) {
 				context->impl->ilStates[context->impl->ilCurrentPos].ilPcdPicNum = Param;
@@ -1157,6 +1348,18 @@ void ILAPIENTRY ilSetInteger(ILcontext* context, ILenum Mode, ILint Param)
 				return;
 			}
 			break;
+		case IL_KTX_COMP:
+			if (Param == IL_DXT_NO_COMP || Param == IL_ETC1 || Param == IL_ETC2_RGB || Param == IL_ETC2_RGBA) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilKtxCompression = Param;
+				return;
+			}
+			break;
+		case IL_ETC_QUALITY:
+			if (Param >= 0 && Param <= 2) {
+				context->impl->ilStates[context->impl->ilCurrentPos].ilEtcQuality = Param;
+				return;
+			}
+			break;
 
 		default:
 			ilSetError(context, IL_INVALID_ENUM);
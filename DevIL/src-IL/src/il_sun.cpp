@@ -277,14 +277,14 @@ ILboolean SunHandler::loadInternal()
 				for (i = 0; i < Header.Height; i++) {
 					context->impl->iread(context, context->impl->iCurImage->Data + i * Header.Width, 1, context->impl->iCurImage->Bps);
 					if (Padding)  // Only possible for padding to be 0 or 1.
-						context->impl->igetc(context);
+						iGetcFast(context);
 				}
 			}
 			else {  // RLE image data
 				for (i = 0; i < context->impl->iCurImage->Height; i++) {
 					BytesRead = iSunGetRle(context, context->impl->iCurImage->Data + context->impl->iCurImage->Bps * i, context->impl->iCurImage->Bps);
 					if (BytesRead % 2)  // Each scanline must be aligned on a 2-byte boundary.
-						context->impl->igetc(context);  // Skip padding
+						iGetcFast(context);  // Skip padding
 				}
 			}
 			break;
@@ -307,14 +307,14 @@ ILboolean SunHandler::loadInternal()
 				for (i = 0; i < Header.Height; i++) {
 					context->impl->iread(context, context->impl->iCurImage->Data + i * Header.Width * 3, 1, context->impl->iCurImage->Bps);
 					if (Padding)  // Only possible for padding to be 0 or 1.
-						context->impl->igetc(context);
+						iGetcFast(context);
 				}
 			}
 			else {  // RLE image data
 				for (i = 0; i < context->impl->iCurImage->Height; i++) {
 					BytesRead = iSunGetRle(context, context->impl->iCurImage->Data + context->impl->iCurImage->Bps * i, context->impl->iCurImage->Bps);
 					if (BytesRead % 2)  // Each scanline must be aligned on a 2-byte boundary.
-						context->impl->igetc(context);  // Skip padding
+						iGetcFast(context);  // Skip padding
 				}
 			}
 
@@ -337,10 +337,10 @@ ILboolean SunHandler::loadInternal()
 			Offset = 0;
 			for (i = 0; i < Header.Height; i++) {
 				for (j = 0; j < Header.Width; j++) {
-					context->impl->igetc(context);  // There is a pad byte before each pixel.
-					context->impl->iCurImage->Data[Offset]   = context->impl->igetc(context);
-					context->impl->iCurImage->Data[Offset+1] = context->impl->igetc(context);
-					context->impl->iCurImage->Data[Offset+2] = context->impl->igetc(context);
+					iGetcFast(context);  // There is a pad byte before each pixel.
+					context->impl->iCurImage->Data[Offset]   = iGetcFast(context);
+					context->impl->iCurImage->Data[Offset+1] = iGetcFast(context);
+					context->impl->iCurImage->Data[Offset+2] = iGetcFast(context);
 				}
 			}
 			break;
@@ -361,16 +361,16 @@ ILuint iSunGetRle(ILcontext* context, ILubyte *Data, ILuint Length)
 	ILuint	Count;
 
 	for (i = 0; i < Length; ) {
-		Flag = context->impl->igetc(context);
+		Flag = iGetcFast(context);
 		if (Flag == 0x80) {  // Run follows (or 1 byte of 0x80)
-			Count = context->impl->igetc(context);
+			Count = iGetcFast(context);
 			if (Count == 0) {  // 1 pixel of value (0x80)
 				*Data = 0x80;
 				Data++;
 				i++;
 			}
 			else {  // Here we have a run.
-				Value = context->impl->igetc(context);
+				Value = iGetcFast(context);
 				Count++;  // Should really be Count+1
 				for (j = 0; j < Count && i + j < Length; j++, Data++) {
 					*Data = Value;
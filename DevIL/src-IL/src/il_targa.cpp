@@ -79,19 +79,19 @@ ILboolean TargaHandler::isValidL(const void *Lump, ILuint Size)
 // Internal function used to get the Targa header from the current file.
 ILboolean TargaHandler::iGetTgaHead(TARGAHEAD *Header)
 {
-	Header->IDLen = (ILubyte)context->impl->igetc(context);
-	Header->ColMapPresent = (ILubyte)context->impl->igetc(context);
-	Header->ImageType = (ILubyte)context->impl->igetc(context);
+	Header->IDLen = (ILubyte)iGetcFast(context);
+	Header->ColMapPresent = (ILubyte)iGetcFast(context);
+	Header->ImageType = (ILubyte)iGetcFast(context);
 	Header->FirstEntry = GetLittleShort(context);
 	Header->ColMapLen = GetLittleShort(context);
-	Header->ColMapEntSize = (ILubyte)context->impl->igetc(context);
+	Header->ColMapEntSize = (ILubyte)iGetcFast(context);
 
 	Header->OriginX = GetLittleShort(context);
 	Header->OriginY = GetLittleShort(context);
 	Header->Width = GetLittleUShort(context);
 	Header->Height = GetLittleUShort(context);
-	Header->Bpp = (ILubyte)context->impl->igetc(context);
-	Header->ImageDesc = (ILubyte)context->impl->igetc(context);
+	Header->Bpp = (ILubyte)iGetcFast(context);
+	Header->ImageDesc = (ILubyte)iGetcFast(context);
 	
 	return IL_TRUE;
 }
@@ -253,11 +253,11 @@ ILboolean TargaHandler::iReadColMapTga(TARGAHEAD *Header)
 	if (context->impl->iread(context, ID, 1, Header->IDLen) != Header->IDLen)
 		return IL_FALSE;
 	
-	if (!ilTexImage(context, Header->Width, Header->Height, 1, (ILubyte)(Header->Bpp >> 3), 0, IL_UNSIGNED_BYTE, NULL)) {
+	if (!iNewTga(Header, (ILubyte)(Header->Bpp >> 3), 0)) {
 		return IL_FALSE;
 	}
 	if (context->impl->iCurImage->Pal.Palette && context->impl->iCurImage->Pal.PalSize)
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 	
 	context->impl->iCurImage->Format = IL_COLOUR_INDEX;
 	context->impl->iCurImage->Pal.PalSize = Header->ColMapLen * (Header->ColMapEntSize >> 3);
@@ -306,22 +306,7 @@ ILboolean TargaHandler::iReadColMapTga(TARGAHEAD *Header)
 		}
 	}
 	
-	if (Header->ImageType == TGA_COLMAP_COMP)
-	{
-		if (!iUncompressTgaData(context->impl->iCurImage))
-		{
-			return IL_FALSE;
-		}
-	}
-	else
-	{
-		if (context->impl->iread(context, context->impl->iCurImage->Data, 1, context->impl->iCurImage->SizeOfData) != context->impl->iCurImage->SizeOfData)
-		{
-			return IL_FALSE;
-		}
-	}
-	
-	return IL_TRUE;
+	return iReadTgaData(Header);
 }
 
 ILboolean TargaHandler::iReadUnmapTga(TARGAHEAD *Header)
@@ -337,7 +322,7 @@ ILboolean TargaHandler::iReadUnmapTga(TARGAHEAD *Header)
 	else*/
 	Bpp = (ILubyte)(Header->Bpp >> 3);
 	
-	if (!ilTexImage(context, Header->Width, Header->Height, 1, Bpp, 0, IL_UNSIGNED_BYTE, NULL)) {
+	if (!iNewTga(Header, Bpp, 0)) {
 		return IL_FALSE;
 	}
 	
@@ -353,7 +338,7 @@ ILboolean TargaHandler::iReadUnmapTga(TARGAHEAD *Header)
 			//context->impl->iCurImage->Type = IL_UNSIGNED_SHORT_5_6_5_REV;
 			
 			// Remove?
-			//ilCloseImage(context->impl->iCurImage);
+			//ilCloseImage(context, context->impl->iCurImage);
 			//ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
 			//return IL_FALSE;
 			
@@ -381,16 +366,8 @@ ILboolean TargaHandler::iReadUnmapTga(TARGAHEAD *Header)
 	//	Should we mess with it or not?
 	
 	
-	if (Header->ImageType == TGA_UNMAP_COMP) {
-		if (!iUncompressTgaData(context->impl->iCurImage)) {
-			return IL_FALSE;
-		}
-	}
-	else {
-		if (context->impl->iread(context, context->impl->iCurImage->Data, 1, context->impl->iCurImage->SizeOfData) != context->impl->iCurImage->SizeOfData) {
-			return IL_FALSE;
-		}
-	}
+	if (!iReadTgaData(Header))
+		return IL_FALSE;
 	
 	// Go ahead and expand it to 24-bit.
 	if (Header->Bpp == 16) {
@@ -412,22 +389,46 @@ ILboolean TargaHandler::iReadBwTga(TARGAHEAD *Header)
 	// We assume that no palette is present, but it's possible...
 	//	Should we mess with it or not?
 	
-	if (!ilTexImage(context, Header->Width, Header->Height, 1, (ILubyte)(Header->Bpp >> 3), IL_LUMINANCE, IL_UNSIGNED_BYTE, NULL)) {
+	if (!iNewTga(Header, (ILubyte)(Header->Bpp >> 3), IL_LUMINANCE)) {
 		return IL_FALSE;
 	}
 	
-	if (Header->ImageType == TGA_BW_COMP) {
-		if (!iUncompressTgaData(context->impl->iCurImage)) {
+	return iReadTgaData(Header);
+}
+
+// Makes the image the pixel data is read into.  Uncompressed data can be read
+//	a row at a time, so only the ilLoadRegion rectangle is made then.
+ILboolean TargaHandler::iNewTga(TARGAHEAD *Header, ILubyte Bpp, ILenum Format)
+{
+	ILuint Width = Header->Width, Height = Header->Height;
+
+	if (Header->ImageType < TGA_COLMAP_COMP && iRegionActive(context)) {
+		if (!iRegionClaim(context, Width, Height))
 			return IL_FALSE;
-		}
+		Width = context->impl->RegionW;
+		Height = context->impl->RegionH;
 	}
-	else {
-		if (context->impl->iread(context, context->impl->iCurImage->Data, 1, context->impl->iCurImage->SizeOfData) != context->impl->iCurImage->SizeOfData) {
+
+	return ilTexImage(context, Width, Height, 1, Bpp, Format, IL_UNSIGNED_BYTE, NULL);
+}
+
+ILboolean TargaHandler::iReadTgaData(TARGAHEAD *Header)
+{
+	ILimage	*Image = context->impl->iCurImage;
+	ILuint	FirstRow;
+
+	if (Header->ImageType >= TGA_COLMAP_COMP)
+		return iUncompressTgaData(Image);
+
+	if (Image->Width == Header->Width && Image->Height == Header->Height) {
+		if (context->impl->iread(context, Image->Data, 1, Image->SizeOfData) != Image->SizeOfData)
 			return IL_FALSE;
-		}
+		return IL_TRUE;
 	}
-	
-	return IL_TRUE;
+
+	// Just the region (check() turns away right-to-left rows)
+	FirstRow = iRegionFirstRow(context, Header->Height, (Header->ImageDesc & IMAGEDESC_ORIGIN_MASK) == IMAGEDESC_BOTLEFT);
+	return iRegionReadRows(context, Image, Header->Width * Image->Bpp, context->impl->RegionX, FirstRow);
 }
 
 ILboolean TargaHandler::iUncompressTgaData(ILimage *Image)
@@ -442,7 +443,7 @@ ILboolean TargaHandler::iUncompressTgaData(ILimage *Image)
 		iPreCache(context, context->impl->iCurImage->SizeOfData / 2);
 	
 	while (BytesRead < Size) {
-		Header = (ILubyte)context->impl->igetc(context);
+		Header = (ILubyte)iGetcFast(context);
 		if (Header & BIT_7) {
 			ClearBits(Header, BIT_7);
 			if (context->impl->iread(context, Color, 1, Image->Bpp) != Image->Bpp) {
@@ -519,11 +520,11 @@ ILboolean TargaHandler::i16BitTarga(ILimage *Image)
 	}
 	
 	if (!ilTexImage(context, Image->Width, Image->Height, 1, 3, IL_BGR, IL_UNSIGNED_BYTE, Data)) {
-		ifree(Data);
+		ifree(context, Data);
 		return IL_FALSE;
 	}
 	
-	ifree(Data);
+	ifree(context, Data);
 	
 	return IL_TRUE;
 }
@@ -569,13 +570,81 @@ ILuint TargaHandler::saveF(ILHANDLE File)
 //! Writes a Targa to a memory "lump"
 ILuint TargaHandler::saveL(void *Lump, ILuint Size)
 {
-	ILuint Pos = context->impl->itellw(context);
+	ILuint Pos;
 	iSetOutputLump(context, Lump, Size);
+	Pos = context->impl->itellw(context);
 	if (saveInternal() == IL_FALSE)
 		return 0;  // Error occurred
 	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
 }
 
+//! Writes an image given as rows (ilSaveRows) to an already-opened file
+ILuint TargaHandler::saveRowsF(ILHANDLE File, iRowSource *Src)
+{
+	ILuint Pos;
+	iSetOutputFile(context, File);
+	Pos = context->impl->itellw(context);
+	if (saveRowsInternal(Src) == IL_FALSE)
+		return 0;  // Error occurred
+	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+}
+
+// Writes the TGA 2.0 extension area and the footer that points to it.
+static void iTgaWriteExtension(ILcontext* context, const char *AuthName, const char *AuthComment)
+{
+	const char	*Footer = "TRUEVISION-XFILE.\0";
+	const char	*idString = "Developer's Image Library (DevIL)";
+	ILuint		ExtOffset, i;
+	ILuint		Day, Month, Year, Hour, Minute, Second;
+
+	// Write the extension area.
+	ExtOffset = context->impl->itellw(context);
+	SaveLittleUShort(context, 495);	// Number of bytes in the extension area (TGA 2.0 spec)
+	context->impl->iwrite(context, AuthName, 1, ilCharStrLen(AuthName));
+	ipad(context, 41 - ilCharStrLen(AuthName));
+	context->impl->iwrite(context, AuthComment, 1, ilCharStrLen(AuthComment));
+	ipad(context, 324 - ilCharStrLen(AuthComment));
+	
+	// Write time/date
+	iGetDateTime(&Month, &Day, &Year, &Hour, &Minute, &Second);
+	SaveLittleUShort(context, (ILushort)Month);
+	SaveLittleUShort(context, (ILushort)Day);
+	SaveLittleUShort(context, (ILushort)Year);
+	SaveLittleUShort(context, (ILushort)Hour);
+	SaveLittleUShort(context, (ILushort)Minute);
+	SaveLittleUShort(context, (ILushort)Second);
+	
+	for (i = 0; i < 6; i++) {  // Time created
+		SaveLittleUShort(context, 0);
+	}
+	for (i = 0; i < 41; i++) {	// Job name/ID
+		context->impl->iputc(context, 0);
+	}
+	for (i = 0; i < 3; i++) {  // Job time
+		SaveLittleUShort(context, 0);
+	}
+	
+	context->impl->iwrite(context, idString, 1, ilCharStrLen(idString));	// Software ID
+	for (i = 0; i < 41 - ilCharStrLen(idString); i++) {
+		context->impl->iputc(context, 0);
+	}
+	SaveLittleUShort(context, IL_VERSION);  // Software version
+	context->impl->iputc(context, ' ');  // Release letter (not beta anymore, so use a space)
+	
+	SaveLittleUInt(context, 0);	// Key colour
+	SaveLittleUInt(context, 0);	// Pixel aspect ratio
+	SaveLittleUInt(context, 0);	// Gamma correction offset
+	SaveLittleUInt(context, 0);	// Colour correction offset
+	SaveLittleUInt(context, 0);	// Postage stamp offset
+	SaveLittleUInt(context, 0);	// Scan line offset
+	context->impl->iputc(context, 3);  // Attributes type
+	
+	// Write the footer.
+	SaveLittleUInt(context, ExtOffset);	// No extension area
+	SaveLittleUInt(context, 0);	// No developer directory
+	context->impl->iwrite(context, Footer, 1, ilCharStrLen(Footer)+1);
+}
+
 // Internal function used to save the Targa.
 ILboolean TargaHandler::saveInternal()
 {
@@ -591,10 +660,6 @@ ILboolean TargaHandler::saveInternal()
 	ILubyte 	*Rle;
 	ILpal		*TempPal = NULL;
 	ILimage 	*TempImage = NULL;
-	ILuint		ExtOffset, i;
-	char		*Footer = (char*)"TRUEVISION-XFILE.\0";
-	char		*idString = (char*)"Developer's Image Library (DevIL)";
-	ILuint		Day, Month, Year, Hour, Minute, Second;
 	char		*TempData;
 	ILshort		zero_short = 0;
 
@@ -651,9 +716,9 @@ ILboolean TargaHandler::saveInternal()
 		default:
 			// Should convert the types here...
 			ilSetError(context, IL_INVALID_VALUE);
-			ifree(ID);
-			ifree(AuthName);
-			ifree(AuthComment);
+			ifree(context, ID);
+			ifree(context, AuthName);
+			ifree(context, AuthComment);
 			return IL_FALSE;
 	}
 	
@@ -685,9 +750,9 @@ ILboolean TargaHandler::saveInternal()
 			break;
 		default:
 			ilSetError(context, IL_INVALID_VALUE);
-			ifree(ID);
-			ifree(AuthName);
-			ifree(AuthComment);
+			ifree(context, ID);
+			ifree(context, AuthName);
+			ifree(context, AuthComment);
 			PalSize = 0;
 			PalEntSize = 0;
 			return IL_FALSE;
@@ -698,9 +763,9 @@ ILboolean TargaHandler::saveInternal()
 	if (context->impl->iCurImage->Bpc > 1) {
 		TempImage = iConvertImage(context, context->impl->iCurImage, context->impl->iCurImage->Format, IL_UNSIGNED_BYTE);
 		if (TempImage == NULL) {
-			ifree(ID);
-			ifree(AuthName);
-			ifree(AuthComment);
+			ifree(context, ID);
+			ifree(context, AuthName);
+			ifree(context, AuthComment);
 			return IL_FALSE;
 		}
 	}
@@ -726,14 +791,13 @@ ILboolean TargaHandler::saveInternal()
 	// Still don't know what exactly this is for...
 	// It's actually the 'Image Descriptor Byte'
 	// from wiki: Image descriptor (1 byte): bits 3-0 give the alpha channel depth, bits 5-4 give direction
+	// The rows were flipped to bottom-up above, so the origin bit stays clear.
 	Temp = 0;
 	if (context->impl->iCurImage->Bpp > 3)
 		Temp = 8;
-	if (TempImage->Origin == IL_ORIGIN_UPPER_LEFT)
-		Temp |= 0x20; //set 5th bit
 	context->impl->iwrite(context, &Temp, sizeof(ILubyte), 1);
 	context->impl->iwrite(context, ID, sizeof(char), IDLen);
-	ifree(ID);
+	ifree(context, ID);
 	//context->impl->iwrite((ID, sizeof(ILbyte), IDLen - sizeof(ILuint));
 	//context->impl->iwrite(context, &context->impl->iCurImage->Depth, sizeof(ILuint), 1);
 	
@@ -747,129 +811,39 @@ ILboolean TargaHandler::saveInternal()
 	else {
 		Rle = (ILubyte*)ialloc(context, TempImage->SizeOfData + TempImage->SizeOfData / 2 + 1);	// max
 		if (Rle == NULL) {
-			ifree(AuthName);
-			ifree(AuthComment);
+			ifree(context, AuthName);
+			ifree(context, AuthComment);
 			return IL_FALSE;
 		}
 		RleLen = ilRleCompress(context, (unsigned char*)TempData, TempImage->Width, TempImage->Height,
 		                       TempImage->Depth, TempImage->Bpp, Rle, IL_TGACOMP, NULL);
 		
 		context->impl->iwrite(context, Rle, 1, RleLen);
-		ifree(Rle);
-	}
-	
-	// Write the extension area.
-	ExtOffset = context->impl->itellw(context);
-	SaveLittleUShort(context, 495);	// Number of bytes in the extension area (TGA 2.0 spec)
-	context->impl->iwrite(context, AuthName, 1, ilCharStrLen(AuthName));
-	ipad(context, 41 - ilCharStrLen(AuthName));
-	context->impl->iwrite(context, AuthComment, 1, ilCharStrLen(AuthComment));
-	ipad(context, 324 - ilCharStrLen(AuthComment));
-	ifree(AuthName);
-	ifree(AuthComment);
-	
-	// Write time/date
-	iGetDateTime(&Month, &Day, &Year, &Hour, &Minute, &Second);
-	SaveLittleUShort(context, (ILushort)Month);
-	SaveLittleUShort(context, (ILushort)Day);
-	SaveLittleUShort(context, (ILushort)Year);
-	SaveLittleUShort(context, (ILushort)Hour);
-	SaveLittleUShort(context, (ILushort)Minute);
-	SaveLittleUShort(context, (ILushort)Second);
-	
-	for (i = 0; i < 6; i++) {  // Time created
-		SaveLittleUShort(context, 0);
-	}
-	for (i = 0; i < 41; i++) {	// Job name/ID
-		context->impl->iputc(context, 0);
-	}
-	for (i = 0; i < 3; i++) {  // Job time
-		SaveLittleUShort(context, 0);
+		ifree(context, Rle);
 	}
 	
-	context->impl->iwrite(context, idString, 1, ilCharStrLen(idString));	// Software ID
-	for (i = 0; i < 41 - ilCharStrLen(idString); i++) {
-		context->impl->iputc(context, 0);
-	}
-	SaveLittleUShort(context, IL_VERSION);  // Software version
-	context->impl->iputc(context, ' ');  // Release letter (not beta anymore, so use a space)
-	
-	SaveLittleUInt(context, 0);	// Key colour
-	SaveLittleUInt(context, 0);	// Pixel aspect ratio
-	SaveLittleUInt(context, 0);	// Gamma correction offset
-	SaveLittleUInt(context, 0);	// Colour correction offset
-	SaveLittleUInt(context, 0);	// Postage stamp offset
-	SaveLittleUInt(context, 0);	// Scan line offset
-	context->impl->iputc(context, 3);  // Attributes type
-	
-	// Write the footer.
-	SaveLittleUInt(context, ExtOffset);	// No extension area
-	SaveLittleUInt(context, 0);	// No developer directory
-	context->impl->iwrite(context, Footer, 1, ilCharStrLen(Footer)+1);
+	iTgaWriteExtension(context, AuthName, AuthComment);
+	ifree(context, AuthName);
+	ifree(context, AuthComment);
 	
 	if (TempImage->Origin != IL_ORIGIN_LOWER_LEFT) {
-		ifree(TempData);
+		ifree(context, TempData);
 	}
 	if (Format == IL_RGB || Format == IL_RGBA) {
 		ilSwapColours(context);
 	}
 	
 	if (TempPal != &context->impl->iCurImage->Pal && TempPal != NULL) {
-		ifree(TempPal->Palette);
-		ifree(TempPal);
+		ifree(context, TempPal->Palette);
+		ifree(context, TempPal);
 	}
 	
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return IL_TRUE;
 }
 
-// Only to be called by ilDetermineSize.  Returns the buffer size needed to save the
-//  current image as a Targa file.
-ILuint TargaHandler::size()
-{
-	ILuint	Size, Bpp;
-	ILubyte	IDLen = 0;
-	const char	*ID = iGetString(context, IL_TGA_ID_STRING);
-	const char	*AuthName = iGetString(context, IL_TGA_AUTHNAME_STRING);
-	const char	*AuthComment = iGetString(context, IL_TGA_AUTHCOMMENT_STRING);
-
-	//@TODO: Support color indexed images.
-	if (iGetInt(context, IL_TGA_RLE) == IL_TRUE || context->impl->iCurImage->Format == IL_COLOUR_INDEX) {
-		// Use the slower method, since we are using compression.  We do a "fake" write.
-		saveL(NULL, 0);
-	}
-
-	if (ID)
-		IDLen = (ILubyte)ilCharStrLen(ID);
-
-	Size = 18 + IDLen;  // Header + ID
-
-	// Bpp may not be context->impl->iCurImage->Bpp.
-	switch (context->impl->iCurImage->Format)
-	{
-		case IL_BGR:
-		case IL_RGB:
-			Bpp = 3;
-			break;
-		case IL_BGRA:
-		case IL_RGBA:
-			Bpp = 4;
-			break;
-		case IL_LUMINANCE:
-			Bpp = 1;
-			break;
-		default:  //@TODO: Do not know what to do with the others yet.
-			return 0;
-	}
-
-	Size += context->impl->iCurImage->Width * context->impl->iCurImage->Height * Bpp;
-	Size += 532;  // Size of the extension area
-
-	return Size;
-}
-
 /*// Makes a neat string to go into the id field of the .tga
 void iMakeString(char *Str)
 {
@@ -942,4 +916,93 @@ void iGetDateTime(ILuint *Month, ILuint *Day, ILuint *Yr, ILuint *Hr, ILuint *Mi
 #endif
 }
 
+// Writes the rows top-down, as they arrive, with the top-left origin bit set.
+//	RLE packets never cross rows, so each row is compressed on its own.
+ILboolean TargaHandler::saveRowsInternal(iRowSource *Src)
+{
+	const char	*ID = iGetString(context, IL_TGA_ID_STRING);
+	const char	*AuthName = iGetString(context, IL_TGA_AUTHNAME_STRING);
+	const char	*AuthComment = iGetString(context, IL_TGA_AUTHCOMMENT_STRING);
+	ILubyte		IDLen = 0, Type, Bpp;
+	ILenum		Format;
+	ILboolean	Compress, Ret = IL_FALSE;
+	ILuint		RleLen, y;
+	ILubyte		*Row, *Rle = NULL;
+
+	Compress = iGetInt(context, IL_TGA_RLE) == IL_TRUE;
+	if (ID)
+		IDLen = (ILubyte)ilCharStrLen(ID);
+
+	if (Src->Width > 0xFFFF || Src->Height > 0xFFFF) {
+		ilSetError(context, IL_FORMAT_NOT_SUPPORTED);
+		goto cleanup;
+	}
+
+	switch (Src->Format)
+	{
+		case IL_LUMINANCE:
+			Format = IL_LUMINANCE;
+			Type = Compress ? 11 : 3;
+			break;
+		case IL_RGBA:
+		case IL_BGRA:
+		case IL_LUMINANCE_ALPHA:
+		case IL_ALPHA:
+			Format = IL_BGRA;
+			Type = Compress ? 10 : 2;
+			break;
+		default:
+			Format = IL_BGR;
+			Type = Compress ? 10 : 2;
+			break;
+	}
+	Bpp = ilGetBppFormat(Format);
+
+	if (!iRowsBegin(context, Src, Format, IL_UNSIGNED_BYTE))
+		goto cleanup;
+	if (Compress) {
+		Rle = (ILubyte*)ialloc(context, Src->DestBps + Src->DestBps / 2 + 1);	// max
+		if (Rle == NULL)
+			goto cleanup;
+	}
+
+	context->impl->iputc(context, IDLen);
+	context->impl->iputc(context, 0);  // No colour map
+	context->impl->iputc(context, Type);
+	SaveLittleShort(context, 0);  // Colour map start
+	SaveLittleShort(context, 0);  // Colour map length
+	context->impl->iputc(context, 0);  // Colour map entry size
+	SaveLittleShort(context, 0);  // X origin
+	SaveLittleShort(context, 0);  // Y origin
+	SaveLittleUShort(context, (ILushort)Src->Width);
+	SaveLittleUShort(context, (ILushort)Src->Height);
+	context->impl->iputc(context, (ILubyte)(Bpp << 3));
+	context->impl->iputc(context, (ILubyte)((Bpp == 4 ? 8 : 0) | 0x20));  // Alpha bits, upper-left origin
+	if (IDLen)
+		context->impl->iwrite(context, ID, sizeof(char), IDLen);
+
+	for (y = 0; y < Src->Height; y++) {
+		Row = iRowsNext(context, Src);
+		if (Row == NULL)
+			goto cleanup;
+		if (Compress) {
+			RleLen = 0;
+			ilRleCompressLine(context, Row, Src->Width, Bpp, Rle, &RleLen, IL_TGACOMP);
+			context->impl->iwrite(context, Rle, 1, RleLen);
+		}
+		else
+			context->impl->iwrite(context, Row, 1, Src->DestBps);
+	}
+
+	iTgaWriteExtension(context, AuthName, AuthComment);
+	Ret = IL_TRUE;
+
+cleanup:
+	ifree(context, Rle);
+	ifree(context, ID);
+	ifree(context, AuthName);
+	ifree(context, AuthComment);
+	return Ret;
+}
+
 #endif//IL_NO_TGA
\ No newline at end of file
@@ -18,6 +18,9 @@
 
 #include "tiffio.h"
 
+#include "il_threads.h"
+#include <atomic>
+#include <mutex>
 #include <time.h>
 
 #define MAGIC_HEADER1	0x4949
@@ -35,8 +38,12 @@
 #endif
 
 // No need for a separate header
-static char*     iMakeString(void);
+static char*     iMakeString(char *TimeStr);
 static TIFF*     iTIFFOpen(ILcontext* context, char *Mode);
+static ILboolean iTiffTileFormat(uint16 photometric, uint16 samplesperpixel, uint16 extrasamples,
+					uint16 bitspersample, uint16 sampleformat, ILenum *Format, ILenum *Type);
+static ILboolean iTiffStripFormat(uint16 photometric, uint16 samplesperpixel, uint16 extrasamples,
+					uint16 bitspersample, uint16 planarconfig);
 
 ILboolean isValidExtension(ILconst_string FileName)
 {
@@ -99,7 +106,7 @@ ILboolean TiffHandler::isValidInternal()
 //! Checks if the ILHANDLE contains a valid tiff file at the current position.
 ILboolean TiffHandler::isValidF(ILHANDLE File)
 {
-	ILuint		FirstPos;
+	ILuint64	FirstPos;
 	ILboolean	bRet;
 
 	iSetInputFile(context, File);
@@ -117,6 +124,116 @@ ILboolean TiffHandler::isValidL(const void *Lump, ILuint Size)
 	return isValidInternal();
 }
 
+//! Reads the image properties from an already-opened Tiff without decoding the pixels.
+ILboolean TiffHandler::getInfoF(ILHANDLE File, ILimageinfo *Info)
+{
+	ILuint64	FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = getInfoInternal(Info);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+//! Reads the image properties from a Tiff lump without decoding the pixels.
+ILboolean TiffHandler::getInfoL(const void *Lump, ILuint Size, ILimageinfo *Info)
+{
+	iSetInputLump(context, Lump, Size);
+	return getInfoInternal(Info);
+}
+
+// Reads the first IFD and follows the IFD chain to count the images, which only
+//  touches the directories.  The format mirrors the cases in loadInternal.
+ILboolean TiffHandler::getInfoInternal(ILimageinfo *Info)
+{
+	TIFF	 *tif;
+	uint16	 photometric, planarconfig, orientation;
+	uint16	 samplesperpixel, bitspersample, *sampleinfo, extrasamples, sampleformat;
+	uint32	 w = 0, h = 0, d = 1, tilewidth, tilelength, ProfileLen;
+	void	 *Buffer;
+	ILenum	 Format, Type;
+
+	TIFFSetWarningHandler (NULL);
+	TIFFSetErrorHandler   (NULL);
+
+	tif = iTIFFOpen(context, (char*)"r");
+	if (tif == NULL) {
+		ilSetError(context, IL_COULD_NOT_OPEN_FILE);
+		return IL_FALSE;
+	}
+
+	TIFFGetField(tif, TIFFTAG_IMAGEWIDTH,  &w);
+	TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesperpixel);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE,	&bitspersample);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_EXTRASAMPLES,	&extrasamples, &sampleinfo);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION, 	&orientation);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_PHOTOMETRIC,  &photometric);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planarconfig);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sampleformat);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGEDEPTH, &d);
+	tilewidth = w; tilelength = h;
+	TIFFGetFieldDefaulted(tif, TIFFTAG_TILEWIDTH,  &tilewidth);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_TILELENGTH, &tilelength);
+
+	Info->Width = w;
+	Info->Height = h;
+	Info->Depth = 1;
+	Info->Type = IL_UNSIGNED_BYTE;
+	Info->HasProfile = TIFFGetField(tif, TIFFTAG_ICCPROFILE, &ProfileLen, &Buffer) ? IL_TRUE : IL_FALSE;
+
+	if (TIFFIsTiled(tif) && d <= 1
+		&& (orientation == ORIENTATION_TOPLEFT || orientation == ORIENTATION_BOTLEFT)
+		&& iTiffTileFormat(photometric, samplesperpixel, extrasamples, bitspersample, sampleformat, &Format, &Type)) {
+		Info->Format = Format;
+		Info->Type = Type;
+	}
+	else if (extrasamples == 0 && samplesperpixel == 1
+		&& (bitspersample == 8 || bitspersample == 1 || bitspersample == 16)
+		&& (photometric == PHOTOMETRIC_MINISWHITE
+			|| photometric == PHOTOMETRIC_MINISBLACK
+			|| photometric == PHOTOMETRIC_PALETTE)
+		&& (orientation == ORIENTATION_TOPLEFT || orientation == ORIENTATION_BOTLEFT)
+		&& tilewidth == w && tilelength == h) {
+		Info->Format = photometric == PHOTOMETRIC_PALETTE ? IL_COLOUR_INDEX : IL_LUMINANCE;
+		if (bitspersample == 16)
+			Info->Type = IL_UNSIGNED_SHORT;
+	}
+	else if (extrasamples == 0 && samplesperpixel == 3
+		&& (bitspersample == 8 || bitspersample == 16)
+		&& photometric == PHOTOMETRIC_RGB
+		&& planarconfig == 1
+		&& (orientation == ORIENTATION_TOPLEFT || orientation == ORIENTATION_BOTLEFT)
+		&& tilewidth == w && tilelength == h) {
+		Info->Format = IL_RGB;
+		if (bitspersample == 16)
+			Info->Type = IL_UNSIGNED_SHORT;
+	}
+	else {
+		// Decoded through TIFFReadRGBAImage and then converted
+		switch (samplesperpixel)
+		{
+			case 1:
+				Info->Format = photometric != PHOTOMETRIC_PALETTE ? IL_LUMINANCE : IL_RGB;
+				break;
+			case 3:
+				Info->Format = IL_RGB;
+				break;
+			default:
+				Info->Format = IL_RGBA;
+				break;
+		}
+	}
+
+	Info->NumImages = TIFFNumberOfDirectories(tif) - 1;
+
+	TIFFClose(tif);
+	return IL_TRUE;
+}
+
 //! Reads a Tiff file
 ILboolean TiffHandler::load(ILconst_string FileName)
 {
@@ -138,7 +255,7 @@ ILboolean TiffHandler::load(ILconst_string FileName)
 //! Reads an already-opened Tiff file
 ILboolean TiffHandler::loadF(ILHANDLE File)
 {
-	ILuint		FirstPos;
+	ILuint64	FirstPos;
 	ILboolean	bRet;
 
 	iSetInputFile(context, File);
@@ -238,10 +355,13 @@ ILboolean TiffHandler::loadInternal()
 {
 	TIFF	 *tif;
 	uint16	 photometric, planarconfig, orientation;
-	uint16	 samplesperpixel, bitspersample, *sampleinfo, extrasamples;
+	uint16	 samplesperpixel, bitspersample, *sampleinfo, extrasamples, sampleformat;
 	uint32	 w, h, d, linesize, tilewidth, tilelength;
 	ILubyte  *pImageData;
 	ILuint	 i, ProfileLen, DirCount = 0;
+	ILuint	 XOff, YOff, Width, Height;
+	ILboolean Region = iRegionActive(context);
+	ILenum	 Format, Type;
 	void	 *Buffer;
 	ILimage  *Image, *TempImage;
 	ILushort si;
@@ -274,6 +394,10 @@ ILboolean TiffHandler::loadInternal()
 		DirCount++;
 	} while (TIFFReadDirectory(tif));
 
+	// ilLoadRegion only wants the first image
+	if (Region)
+		DirCount = 1;
+
 	/*
 	 if (!ilTexImage(1, 1, 1, 1, IL_RGBA, IL_UNSIGNED_BYTE, NULL)) {
 		 TIFFClose(tif);
@@ -309,6 +433,7 @@ ILboolean TiffHandler::loadInternal()
 		//have a palette (photometric == 3)...get this information
 		TIFFGetFieldDefaulted(tif, TIFFTAG_PHOTOMETRIC,  &photometric);
 		TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planarconfig);
+		TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT, &sampleformat);
 
 		//special-case code for frequent data cases that may be read more
 		//efficiently than with the TIFFReadRGBAImage() interface.
@@ -320,7 +445,55 @@ ILboolean TiffHandler::loadInternal()
 		TIFFGetFieldDefaulted(tif, TIFFTAG_TILELENGTH, &tilelength);
 
 
-		if (extrasamples == 0
+		//tiles are decoded straight into the image, at their own bit depth,
+		//and so are the strips an ilLoadRegion rectangle needs
+		if ((TIFFIsTiled(tif)
+				|| (Region && iTiffStripFormat(photometric, samplesperpixel, extrasamples, bitspersample, planarconfig)))
+			&& d <= 1
+			&& (orientation == ORIENTATION_TOPLEFT || orientation == ORIENTATION_BOTLEFT)
+			&& iTiffTileFormat(photometric, samplesperpixel, extrasamples, bitspersample, sampleformat, &Format, &Type)
+			) {
+			XOff = YOff = 0;
+			Width = w;
+			Height = h;
+			if (Region) {
+				if (!iRegionClaim(context, w, h)) {
+					TIFFClose(tif);
+					return IL_FALSE;
+				}
+				XOff = context->impl->RegionX;
+				YOff = iRegionFirstRow(context, h, orientation == ORIENTATION_BOTLEFT);
+				Width = context->impl->RegionW;
+				Height = context->impl->RegionH;
+			}
+
+			if (!Image) {
+				if (!ilTexImage(context, Width, Height, 1, samplesperpixel, Format, Type, NULL)) {
+					TIFFClose(tif);
+					return IL_FALSE;
+				}
+				Image = context->impl->iCurImage;
+			}
+			else {
+				Image->Next = ilNewImageFull(context, Width, Height, 1, samplesperpixel, Format, Type, NULL);
+				if (Image->Next == NULL) {
+					TIFFClose(tif);
+					return IL_FALSE;
+				}
+				Image = Image->Next;
+			}
+
+			if (!loadTiles(tif, Image, i, XOff, YOff)) {
+				TIFFClose(tif);
+				return IL_FALSE;
+			}
+
+			if (orientation == ORIENTATION_TOPLEFT)
+				Image->Origin = IL_ORIGIN_UPPER_LEFT;
+			else
+				Image->Origin = IL_ORIGIN_LOWER_LEFT;
+		}
+		else if (extrasamples == 0
 			&& samplesperpixel == 1  //luminance or palette
 			&& (bitspersample == 8 || bitspersample == 1 || bitspersample == 16)
 			&& (photometric == PHOTOMETRIC_MINISWHITE
@@ -395,7 +568,7 @@ ILboolean TiffHandler::loadInternal()
 
 					if (TIFFReadEncodedStrip(tif, TIFFComputeStrip(tif, y, 0), strip, stripsize) == -1) {
 						ilSetError(context, IL_LIB_TIFF_ERROR);
-						ifree(strip);
+						ifree(context, strip);
 						TIFFClose(tif);
 						return IL_FALSE;
 					}
@@ -413,7 +586,7 @@ ILboolean TiffHandler::loadInternal()
 					}
 					else
 						for(j = 0; j < linesread; ++j)
-							memcpy(&Image->Data[(y + j)*Image->Bps], &strip[j*linesize], Image->Bps);
+							memcpy(&Image->Data[(ILsizei)(y + j)*Image->Bps], &strip[(ILsizei)j*linesize], Image->Bps);
 				}
 			}
 			else if (bitspersample == 1) {
@@ -433,7 +606,7 @@ ILboolean TiffHandler::loadInternal()
 
 					if (TIFFReadEncodedStrip(tif, TIFFComputeStrip(tif, y, 0), strip, stripsize) == -1) {
 						ilSetError(context, IL_LIB_TIFF_ERROR);
-						ifree(strip);
+						ifree(context, strip);
 						TIFFClose(tif);
 						return IL_FALSE;
 					}
@@ -460,7 +633,7 @@ ILboolean TiffHandler::loadInternal()
 				}
 			}
 
-			ifree(strip);
+			ifree(context, strip);
 
 			if(orientation == ORIENTATION_TOPLEFT)
 				Image->Origin = IL_ORIGIN_UPPER_LEFT;
@@ -517,16 +690,16 @@ ILboolean TiffHandler::loadInternal()
 
 				if (TIFFReadEncodedStrip(tif, TIFFComputeStrip(tif, y, 0), strip, stripsize) == -1) {
 					ilSetError(context, IL_LIB_TIFF_ERROR);
-					ifree(strip);
+					ifree(context, strip);
 					TIFFClose(tif);
 					return IL_FALSE;
 				}
 
 				for(j = 0; j < linesread; ++j)
-						memcpy(&Image->Data[(y + j)*Image->Bps], &strip[j*linesize], Image->Bps);
+						memcpy(&Image->Data[(ILsizei)(y + j)*Image->Bps], &strip[(ILsizei)j*linesize], Image->Bps);
 			}
 
-			ifree(strip);
+			ifree(context, strip);
 			
 			if(orientation == ORIENTATION_TOPLEFT)
 				Image->Origin = IL_ORIGIN_UPPER_LEFT;
@@ -639,7 +812,7 @@ ILboolean TiffHandler::loadInternal()
 
 		if (TIFFGetField(tif, TIFFTAG_ICCPROFILE, &ProfileLen, &Buffer)) {
 			if (Image->Profile && Image->ProfileSize)
-				ifree(Image->Profile);
+				ifree(context, Image->Profile);
 			Image->Profile = (ILubyte*)ialloc(context, ProfileLen);
 			if (Image->Profile == NULL) {
 				TIFFClose(tif);
@@ -693,6 +866,218 @@ ILboolean TiffHandler::loadInternal()
 	return ilFixImage(context);
 }
 
+//! Reads an already-opened Tiff file and gives its rows to Sink (ilLoadRows)
+ILboolean TiffHandler::loadRowsF(ILHANDLE File, iRowSink *Sink)
+{
+	ILuint64	FirstPos;
+	ILboolean	bRet;
+
+	iSetInputFile(context, File);
+	FirstPos = context->impl->itell(context);
+	bRet = loadRowsInternal(Sink);
+	context->impl->iseek(context, FirstPos, IL_SEEK_SET);
+
+	return bRet;
+}
+
+//! Reads a Tiff in a memory "lump" and gives its rows to Sink (ilLoadRows)
+ILboolean TiffHandler::loadRowsL(const void *Lump, ILuint Size, iRowSink *Sink)
+{
+	iSetInputLump(context, Lump, Size);
+	return loadRowsInternal(Sink);
+}
+
+// The first image is decoded a scanline or a row of tiles at a time, in the
+//  format loadInternal reads it in, when that is its own: tiles that
+//  iTiffTileFormat takes, and strips that iTiffStripFormat takes.  Only
+//  top-down images with their samples together are streamed; the rest is
+//  left to ilLoad.
+ILboolean TiffHandler::loadRowsInternal(iRowSink *Sink)
+{
+	TIFF		*tif;
+	uint16		photometric, planarconfig, orientation;
+	uint16		samplesperpixel, bitspersample, *sampleinfo, extrasamples, sampleformat;
+	uint32		w = 0, h = 0, d = 0, tilewidth = 0, tilelength = 0;
+	ILenum		Format, Type;
+	ILboolean	Tiled;
+	ILubyte		*Buf = NULL, *Rows;
+	tsize_t		TileSize;
+	ILuint		PixSize, NumRows, y, x, i, k;
+
+	TIFFSetWarningHandler(NULL);
+	TIFFSetErrorHandler(NULL);
+
+	tif = iTIFFOpen(context, (char*)"r");
+	if (tif == NULL) {
+		ilSetError(context, IL_COULD_NOT_OPEN_FILE);
+		return IL_FALSE;
+	}
+
+	TIFFGetField(tif, TIFFTAG_IMAGEWIDTH,  &w);
+	TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_IMAGEDEPTH,		&d);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesperpixel);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE,	&bitspersample);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_EXTRASAMPLES,	&extrasamples, &sampleinfo);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION, 	&orientation);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_PHOTOMETRIC,		&photometric);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG,	&planarconfig);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLEFORMAT,	&sampleformat);
+	Tiled = TIFFIsTiled(tif) ? IL_TRUE : IL_FALSE;
+	if (Tiled) {
+		TIFFGetField(tif, TIFFTAG_TILEWIDTH,  &tilewidth);
+		TIFFGetField(tif, TIFFTAG_TILELENGTH, &tilelength);
+	}
+
+	if (d > 1 || orientation != ORIENTATION_TOPLEFT
+		|| (planarconfig != PLANARCONFIG_CONTIG && samplesperpixel > 1)
+		|| (!Tiled && !iTiffStripFormat(photometric, samplesperpixel, extrasamples, bitspersample, planarconfig))
+		|| (Tiled && (tilewidth == 0 || tilelength == 0))
+		|| !iTiffTileFormat(photometric, samplesperpixel, extrasamples, bitspersample, sampleformat, &Format, &Type)) {
+		TIFFClose(tif);
+		Sink->Whole = IL_TRUE;
+		return IL_FALSE;
+	}
+
+	if (!iSinkBegin(context, Sink, w, h, Format, Type)) {
+		TIFFClose(tif);
+		return IL_FALSE;
+	}
+	PixSize = Sink->Bps / w;
+
+	if (Tiled) {
+		TileSize = TIFFTileSize(tif);
+		Buf = (ILubyte*)_TIFFmalloc(TileSize);
+		if (Buf == NULL) {
+			ilSetError(context, IL_OUT_OF_MEMORY);
+			TIFFClose(tif);
+			return IL_FALSE;
+		}
+	}
+
+	for (y = 0; y < h; y += NumRows) {
+		NumRows = Tiled ? IL_MIN(tilelength, h - y) : 1;
+		Rows = iSinkRows(context, Sink, NumRows);
+		if (Rows == NULL)
+			break;
+
+		if (!Tiled) {
+			if (TIFFReadScanline(tif, Rows, y, 0) == -1) {
+				ilSetError(context, IL_LIB_TIFF_ERROR);
+				break;
+			}
+		}
+		else {
+			// The tiles across this band, each copied to its place in the rows
+			for (x = 0; x < w; x += tilewidth) {
+				if (TIFFReadTile(tif, Buf, x, y, 0, 0) == -1) {
+					ilSetError(context, IL_LIB_TIFF_ERROR);
+					break;
+				}
+				for (i = 0; i < NumRows; i++) {
+					memcpy(Rows + (ILsizei)i * Sink->Bps + x * PixSize, Buf + (ILsizei)i * tilewidth * PixSize,
+						IL_MIN(tilewidth, w - x) * PixSize);
+				}
+			}
+			if (x < w)
+				break;
+		}
+
+		// Inverted as it is read, as loadInternal does
+		if (photometric == PHOTOMETRIC_MINISWHITE) {
+			for (k = 0; k < NumRows * Sink->Bps; k++)
+				Rows[k] = ~Rows[k];
+		}
+	}
+
+	_TIFFfree(Buf);
+	TIFFClose(tif);
+	return y >= h ? IL_TRUE : IL_FALSE;
+}
+
+// Whether the strips of an image are read at their own bit depth below, in
+//  which case those an ilLoadRegion rectangle needs can be read like tiles.
+ILboolean iTiffStripFormat(uint16 photometric, uint16 samplesperpixel, uint16 extrasamples,
+	uint16 bitspersample, uint16 planarconfig)
+{
+	if (extrasamples != 0 || (bitspersample != 8 && bitspersample != 16))
+		return IL_FALSE;
+	if (samplesperpixel == 1)
+		return photometric == PHOTOMETRIC_MINISBLACK || photometric == PHOTOMETRIC_MINISWHITE;
+	return samplesperpixel == 3 && photometric == PHOTOMETRIC_RGB && planarconfig == PLANARCONFIG_CONTIG;
+}
+
+// The format and type of images whose tiles can be copied into an image as
+//  they are: grey or RGB, with or without alpha, and samples of a size DevIL
+//  has a type for.
+ILboolean iTiffTileFormat(uint16 photometric, uint16 samplesperpixel, uint16 extrasamples,
+	uint16 bitspersample, uint16 sampleformat, ILenum *Format, ILenum *Type)
+{
+	switch (photometric)
+	{
+		case PHOTOMETRIC_MINISWHITE:
+			// Inverted as it is read, which only works for unsigned values
+			if (samplesperpixel != 1 || sampleformat != SAMPLEFORMAT_UINT)
+				return IL_FALSE;
+			*Format = IL_LUMINANCE;
+			break;
+		case PHOTOMETRIC_MINISBLACK:
+			if (samplesperpixel == 1 && extrasamples == 0)
+				*Format = IL_LUMINANCE;
+			else if (samplesperpixel == 2 && extrasamples == 1)
+				*Format = IL_LUMINANCE_ALPHA;
+			else
+				return IL_FALSE;
+			break;
+		case PHOTOMETRIC_RGB:
+			if (samplesperpixel == 3 && extrasamples == 0)
+				*Format = IL_RGB;
+			else if (samplesperpixel == 4 && extrasamples == 1)
+				*Format = IL_RGBA;
+			else
+				return IL_FALSE;
+			break;
+		default:
+			return IL_FALSE;
+	}
+
+	switch (sampleformat * 100 + bitspersample)
+	{
+		case SAMPLEFORMAT_UINT * 100 + 8:
+			*Type = IL_UNSIGNED_BYTE;
+			break;
+		case SAMPLEFORMAT_UINT * 100 + 16:
+			*Type = IL_UNSIGNED_SHORT;
+			break;
+		case SAMPLEFORMAT_UINT * 100 + 32:
+			*Type = IL_UNSIGNED_INT;
+			break;
+		case SAMPLEFORMAT_INT * 100 + 8:
+			*Type = IL_BYTE;
+			break;
+		case SAMPLEFORMAT_INT * 100 + 16:
+			*Type = IL_SHORT;
+			break;
+		case SAMPLEFORMAT_INT * 100 + 32:
+			*Type = IL_INT;
+			break;
+		case SAMPLEFORMAT_IEEEFP * 100 + 16:
+			*Type = IL_HALF;
+			break;
+		case SAMPLEFORMAT_IEEEFP * 100 + 32:
+			*Type = IL_FLOAT;
+			break;
+		case SAMPLEFORMAT_IEEEFP * 100 + 64:
+			*Type = IL_DOUBLE;
+			break;
+		default:
+			return IL_FALSE;
+	}
+
+	return IL_TRUE;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // Extension to load tiff files from memory
 // Marco Fabbricatore (fabbrica@ai-lab.fh-furtwangen.de)
@@ -729,11 +1114,12 @@ _tiffFileSeekProc(thandle_t fd, toff_t tOff, int whence)
 	ILcontext* context = (ILcontext*)fd;
 
 	/* we use this as a special code, so avoid accepting it */
-	if (tOff == 0xFFFFFFFF)
-		return 0xFFFFFFFF;
+	if (tOff == (toff_t)-1)
+		return (toff_t)-1;
 
-	context->impl->iseek(context, (ILint)tOff, whence);
-	return context->impl->itell(context);
+	if (context->impl->iseek(context, (ILint64)tOff, whence) != 0)
+		return (toff_t)-1;
+	return (toff_t)context->impl->itell(context);
 	//return tOff;
 }
 
@@ -741,12 +1127,13 @@ static toff_t
 _tiffFileSeekProcW(thandle_t fd, toff_t tOff, int whence)
 {
 	/* we use this as a special code, so avoid accepting it */
-	if (tOff == 0xFFFFFFFF)
-		return 0xFFFFFFFF;
+	if (tOff == (toff_t)-1)
+		return (toff_t)-1;
 
 	ILcontext* context = (ILcontext*)fd;
-	context->impl->iseekw(context, (ILint)tOff, whence);
-	return context->impl->itellw(context);
+	if (context->impl->iseekw(context, (ILint64)tOff, whence) != 0)
+		return (toff_t)-1;
+	return (toff_t)context->impl->itellw(context);
 	//return tOff;
 }
 
@@ -762,7 +1149,7 @@ _tiffFileSizeProc(thandle_t fd)
 {
 	ILcontext* context = (ILcontext*)fd;
 
-	ILint Offset, Size;
+	ILuint64 Offset, Size;
 	Offset = context->impl->itell(context);
 	context->impl->iseek(context, 0, IL_SEEK_END);
 	Size = context->impl->itell(context);
@@ -770,20 +1157,20 @@ _tiffFileSizeProc(thandle_t fd)
 
 	fd;
 
-	return Size;
+	return (toff_t)Size;
 }
 
 static toff_t
 _tiffFileSizeProcW(thandle_t fd)
 {
 	ILcontext* context = (ILcontext*)fd;
-	ILint Offset, Size;
+	ILuint64 Offset, Size;
 	Offset = context->impl->itellw(context);
 	context->impl->iseekw(context, 0, IL_SEEK_END);
 	Size = context->impl->itellw(context);
 	context->impl->iseekw(context, Offset, IL_SEEK_SET);
 
-	return Size;
+	return (toff_t)Size;
 }
 
 #ifdef __BORLANDC__
@@ -828,6 +1215,187 @@ TIFF *iTIFFOpen(ILcontext* context, char *Mode)
 	return tif;
 }
 
+// Each thread decoding tiles has a TIFF handle of its own.  They all read the
+//  same file or lump, one at a time, each from its own position.
+typedef struct iTiffView
+{
+	ILcontext	*context;
+	std::mutex	*Lock;
+	toff_t		Pos, Size;
+} iTiffView;
+
+static tsize_t _tiffViewReadProc(thandle_t fd, tdata_t pData, tsize_t tSize)
+{
+	iTiffView	*View = (iTiffView*)fd;
+	ILcontext	*context = View->context;
+	ILuint		Read;
+
+	std::lock_guard<std::mutex> Guard(*View->Lock);
+	context->impl->iseek(context, (ILint64)View->Pos, IL_SEEK_SET);
+	Read = context->impl->iread(context, pData, 1, (ILuint)tSize);
+	View->Pos += Read;
+	return Read;
+}
+
+static toff_t _tiffViewSeekProc(thandle_t fd, toff_t tOff, int whence)
+{
+	iTiffView *View = (iTiffView*)fd;
+
+	switch (whence)
+	{
+		case SEEK_SET:
+			View->Pos = tOff;
+			break;
+		case SEEK_CUR:
+			View->Pos += tOff;
+			break;
+		case SEEK_END:
+			View->Pos = View->Size + tOff;
+			break;
+	}
+	return View->Pos;
+}
+
+static toff_t _tiffViewSizeProc(thandle_t fd)
+{
+	return ((iTiffView*)fd)->Size;
+}
+
+// Decodes the tiles of directory Dir that Image covers straight into it.  Image
+//  already has the format iTiffTileFormat gave, and its first pixel is at
+//  XOff, YOff in the stored pixels.  Strips are treated as tiles as wide as the
+//  image.  Tiles are shared out between threads, which each open the file
+//  again, so only the reading is done one at a time.
+ILboolean TiffHandler::loadTiles(TIFF *tif, ILimage *Image, ILuint Dir, ILuint XOff, ILuint YOff)
+{
+	uint32				w, h, tilewidth, tilelength;
+	uint16				photometric, planarconfig;
+	ILboolean			Tiled = TIFFIsTiled(tif) ? IL_TRUE : IL_FALSE;
+	ILuint				NumTiles, TilesAcross, TilesPerPlane, NumPlanes, PixSize, SampleSize;
+	ILuint				FirstX, LastX, FirstY, LastY, NumNeeded, *Needed, n, p, tx, ty;
+	toff_t				Size = _tiffFileSizeProc(context);
+	std::mutex			Lock;
+	std::atomic<bool>	Failed(false);
+
+	TIFFGetField(tif, TIFFTAG_IMAGEWIDTH,  &w);
+	TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+	if (Tiled) {
+		TIFFGetField(tif, TIFFTAG_TILEWIDTH,  &tilewidth);
+		TIFFGetField(tif, TIFFTAG_TILELENGTH, &tilelength);
+	}
+	else {
+		tilewidth = w;
+		TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &tilelength);
+		tilelength = IL_MIN(tilelength, h);
+	}
+	TIFFGetFieldDefaulted(tif, TIFFTAG_PHOTOMETRIC,  &photometric);
+	TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planarconfig);
+	if (tilewidth == 0 || tilelength == 0) {
+		ilSetError(context, IL_INVALID_FILE_HEADER);
+		return IL_FALSE;
+	}
+
+	NumTiles = Tiled ? TIFFNumberOfTiles(tif) : TIFFNumberOfStrips(tif);
+	TilesAcross = (w + tilewidth - 1) / tilewidth;
+	TilesPerPlane = TilesAcross * ((h + tilelength - 1) / tilelength);
+	NumPlanes = planarconfig == PLANARCONFIG_SEPARATE ? Image->Bpp : 1;
+	PixSize = Image->Bpp * Image->Bpc;
+	SampleSize = planarconfig == PLANARCONFIG_SEPARATE ? Image->Bpc : PixSize;
+	if (NumTiles != TilesPerPlane * NumPlanes) {
+		ilSetError(context, IL_INVALID_FILE_HEADER);
+		return IL_FALSE;
+	}
+
+	// The tiles Image overlaps, in each plane
+	FirstX = XOff / tilewidth;
+	LastX = (XOff + Image->Width - 1) / tilewidth;
+	FirstY = YOff / tilelength;
+	LastY = (YOff + Image->Height - 1) / tilelength;
+	NumNeeded = NumPlanes * (LastX - FirstX + 1) * (LastY - FirstY + 1);
+	Needed = (ILuint*)ialloc(context, NumNeeded * sizeof(ILuint));
+	if (Needed == NULL)
+		return IL_FALSE;
+	n = 0;
+	for (p = 0; p < NumPlanes; p++)
+		for (ty = FirstY; ty <= LastY; ty++)
+			for (tx = FirstX; tx <= LastX; tx++)
+				Needed[n++] = p * TilesPerPlane + ty * TilesAcross + tx;
+
+	iParallelFor(NumNeeded, 4, [&](ILuint First, ILuint Last) {
+		iTiffView	View = { context, &Lock, 0, Size };
+		TIFF		*Handle = tif;
+		ILubyte		*Buf, *Src, *Dest;
+		tsize_t		TileSize;
+		ILuint		Tile, Plane, x, y, x0, x1, y0, y1, Row, i, k;
+
+		// The calling thread uses the handle it has if it does all the tiles.
+		if (First > 0 || Last < NumNeeded) {
+			Handle = TIFFClientOpen("TIFFMemFile", "r", (thandle_t)&View,
+				_tiffViewReadProc, _tiffFileReadProcW,
+				_tiffViewSeekProc, _tiffFileCloseProc,
+				_tiffViewSizeProc, _tiffDummyMapProc,
+				_tiffDummyUnmapProc);
+			if (Handle == NULL || !TIFFSetDirectory(Handle, (tdir_t)Dir)) {
+				if (Handle)
+					TIFFClose(Handle);
+				Failed = true;
+				return;
+			}
+		}
+
+		TileSize = Tiled ? TIFFTileSize(Handle) : TIFFStripSize(Handle);
+		Buf = (ILubyte*)_TIFFmalloc(TileSize);
+		for (i = First; i < Last && Buf != NULL && !Failed; i++) {
+			Tile = Needed[i];
+			if ((Tiled ? TIFFReadEncodedTile(Handle, Tile, Buf, TileSize)
+					: TIFFReadEncodedStrip(Handle, Tile, Buf, TileSize)) == -1) {
+				Failed = true;
+				break;
+			}
+			if (photometric == PHOTOMETRIC_MINISWHITE) {
+				for (k = 0; k < (ILuint)TileSize; k++)
+					Buf[k] = ~Buf[k];
+			}
+
+			// Where the tile and Image overlap, in stored pixels
+			Plane = Tile / TilesPerPlane;
+			x = (Tile % TilesPerPlane) % TilesAcross * tilewidth;
+			y = (Tile % TilesPerPlane) / TilesAcross * tilelength;
+			x0 = IL_MAX(x, XOff);
+			x1 = IL_MIN(IL_MIN(x + tilewidth, w), XOff + Image->Width);
+			y0 = IL_MAX(y, YOff);
+			y1 = IL_MIN(IL_MIN(y + tilelength, h), YOff + Image->Height);
+			for (Row = y0; Row < y1; Row++) {
+				Src = Buf + ((ILsizei)(Row - y) * tilewidth + (x0 - x)) * SampleSize;
+				Dest = Image->Data + (ILsizei)(Row - YOff) * Image->Bps + (x0 - XOff) * PixSize;
+				if (planarconfig == PLANARCONFIG_SEPARATE) {
+					// One sample of each pixel
+					Dest += Plane * Image->Bpc;
+					for (k = 0; k < x1 - x0; k++)
+						memcpy(Dest + k * PixSize, Src + k * Image->Bpc, Image->Bpc);
+				}
+				else
+					memcpy(Dest, Src, (x1 - x0) * PixSize);
+			}
+		}
+
+		if (Buf == NULL)
+			Failed = true;
+		_TIFFfree(Buf);
+		if (Handle != tif)
+			TIFFClose(Handle);
+	});
+
+	ifree(context, Needed);
+	if (Failed) {
+		ilSetError(context, IL_LIB_TIFF_ERROR);
+		return IL_FALSE;
+	}
+
+	return IL_TRUE;
+}
+
+
 //! Writes a Tiff file
 ILboolean TiffHandler::save(const ILstring FileName)
 {
@@ -858,22 +1426,74 @@ ILboolean TiffHandler::save(const ILstring FileName)
 //! Writes a Tiff to an already-opened file
 ILuint TiffHandler::saveF(ILHANDLE File)
 {
-	ILuint Pos;
+	ILuint64 Pos;
 	iSetOutputFile(context, File);
 	Pos = context->impl->itellw(context);
 	if (saveInternal() == IL_FALSE)
 		return 0;  // Error occurred
-	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+	return (ILuint)(context->impl->itellw(context) - Pos);  // Return the number of bytes written.
 }
 
 //! Writes a Tiff to a memory "lump"
 ILuint TiffHandler::saveL(void *Lump, ILuint Size)
 {
-	ILuint Pos = context->impl->itellw(context);
+	ILuint64 Pos;
 	iSetOutputLump(context, Lump, Size);
+	Pos = context->impl->itellw(context);
 	if (saveInternal() == IL_FALSE)
 		return 0;  // Error occurred
-	return context->impl->itellw(context) - Pos;  // Return the number of bytes written.
+	return (ILuint)(context->impl->itellw(context) - Pos);  // Return the number of bytes written.
+}
+
+//! Writes an image given as rows (ilSaveRows) to an already-opened file
+ILuint TiffHandler::saveRowsF(ILHANDLE File, iRowSource *Src)
+{
+	ILuint64 Pos;
+	iSetOutputFile(context, File);
+	Pos = context->impl->itellw(context);
+	if (saveRowsInternal(Src) == IL_FALSE)
+		return 0;  // Error occurred
+	return (ILuint)(context->impl->itellw(context) - Pos);  // Return the number of bytes written.
+}
+
+// Sets the tags that say where a saved file came from.
+static void iTiffSetInfoTags(ILcontext* context, TIFF *File)
+{
+	const char	*str;
+	char		TimeStr[20];
+
+	TIFFSetField(File, TIFFTAG_SOFTWARE, ilGetString(context, IL_VERSION_NUM));  //@TODO: Will probably not work properly under Windows if Unicode
+	/*TIFFSetField(File, TIFFTAG_DOCUMENTNAME,
+		iGetString(context, IL_TIF_DOCUMENTNAME_STRING) ?
+		iGetString(context, IL_TIF_DOCUMENTNAME_STRING) : FileName);
+*/
+	str = iGetString(context, IL_TIF_DOCUMENTNAME_STRING);
+	if (str) {
+		TIFFSetField(File, TIFFTAG_DOCUMENTNAME, str);
+		ifree(context, str);
+	}
+
+
+	str = iGetString(context, IL_TIF_AUTHNAME_STRING);
+	if (iGetString(context, IL_TIF_AUTHNAME_STRING)) {
+		TIFFSetField(File, TIFFTAG_ARTIST, str);
+		ifree(context, str);
+	}
+
+	str = iGetString(context, IL_TIF_HOSTCOMPUTER_STRING);
+	if (str) {
+		TIFFSetField(File, TIFFTAG_HOSTCOMPUTER, str);
+		ifree(context, str);
+	}
+
+	str = iGetString(context, IL_TIF_HOSTCOMPUTER_STRING);
+	if (str) {
+		TIFFSetField(File, TIFFTAG_IMAGEDESCRIPTION, str);
+		ifree(context, str);
+	}
+
+	// Set the date and time string.
+	TIFFSetField(File, TIFFTAG_DATETIME, iMakeString(TimeStr));
 }
 
 // @TODO:  Accept palettes!
@@ -887,7 +1507,6 @@ ILboolean TiffHandler::saveInternal(/*ILconst_string Filename*/)
 	TIFF	*File;
 	char	Description[512];
 	ILimage *TempImage;
-	const char	*str;
 	ILboolean SwapColors;
 	ILubyte *OldData;
 
@@ -952,38 +1571,7 @@ ILboolean TiffHandler::saveInternal(/*ILconst_string Filename*/)
 		TIFFSetField(File, TIFFTAG_MATTEING, 1);
 	TIFFSetField(File, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
 	TIFFSetField(File, TIFFTAG_ROWSPERSTRIP, 1);
-	TIFFSetField(File, TIFFTAG_SOFTWARE, ilGetString(context, IL_VERSION_NUM));  //@TODO: Will probably not work properly under Windows if Unicode
-	/*TIFFSetField(File, TIFFTAG_DOCUMENTNAME,
-		iGetString(context, IL_TIF_DOCUMENTNAME_STRING) ?
-		iGetString(context, IL_TIF_DOCUMENTNAME_STRING) : FileName);
-*/
-	str = iGetString(context, IL_TIF_DOCUMENTNAME_STRING);
-	if (str) {
-		TIFFSetField(File, TIFFTAG_DOCUMENTNAME, str);
-		ifree(str);
-	}
-
-
-	str = iGetString(context, IL_TIF_AUTHNAME_STRING);
-	if (iGetString(context, IL_TIF_AUTHNAME_STRING)) {
-		TIFFSetField(File, TIFFTAG_ARTIST, str);
-		ifree(str);
-	}
-
-	str = iGetString(context, IL_TIF_HOSTCOMPUTER_STRING);
-	if (str) {
-		TIFFSetField(File, TIFFTAG_HOSTCOMPUTER, str);
-		ifree(str);
-	}
-
-	str = iGetString(context, IL_TIF_HOSTCOMPUTER_STRING);
-	if (str) {
-		TIFFSetField(File, TIFFTAG_IMAGEDESCRIPTION, str);
-		ifree(str);
-	}
-
-	// Set the date and time string.
-	TIFFSetField(File, TIFFTAG_DATETIME, iMakeString());
+	iTiffSetInfoTags(context, File);
 
 	// 24/4/2003
 	// Orientation flag is not always supported (Photoshop, ...), orient the image data 
@@ -1014,11 +1602,11 @@ ILboolean TiffHandler::saveInternal(/*ILconst_string Filename*/)
 			if (SwapColors)
 				ilSwapColours(context);
 			if (TempImage->Data != OldData) {
-				ifree( TempImage->Data );
+				ifree(context,  TempImage->Data );
 				TempImage->Data = OldData;
 			}
 			if (TempImage != context->impl->iCurImage)
-				ilCloseImage(TempImage);
+				ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	}
@@ -1027,39 +1615,108 @@ ILboolean TiffHandler::saveInternal(/*ILconst_string Filename*/)
  		ilSwapColours(context);
 
 	if (TempImage->Data != OldData) {
-		ifree(TempImage->Data);
+		ifree(context, TempImage->Data);
 		TempImage->Data = OldData;
 	}
 
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	TIFFClose(File);
 
 	return IL_TRUE;
 }
 
+// Writes a strip per row as the rows arrive.  Rows are saved at 8 bits per
+//	sample if they come as bytes and at 16 otherwise.
+ILboolean TiffHandler::saveRowsInternal(iRowSource *Src)
+{
+	ILenum	Format, Type;
+	ILuint	y;
+	TIFF	*File;
+	ILubyte	*Row;
+
+	TIFFSetWarningHandler (NULL);
+	TIFFSetErrorHandler   (NULL);
+
+	switch (Src->Format)
+	{
+		case IL_LUMINANCE:
+			Format = IL_LUMINANCE;
+			break;
+		case IL_RGBA:
+		case IL_BGRA:
+		case IL_LUMINANCE_ALPHA:
+		case IL_ALPHA:
+			Format = IL_RGBA;
+			break;
+		default:
+			Format = IL_RGB;
+			break;
+	}
+	Type = Src->Type == IL_BYTE || Src->Type == IL_UNSIGNED_BYTE ? IL_UNSIGNED_BYTE : IL_UNSIGNED_SHORT;
+	if (!iRowsBegin(context, Src, Format, Type))
+		return IL_FALSE;
+
+	File = iTIFFOpen(context, (char*)"w");
+	if (File == NULL) {
+		ilSetError(context, IL_COULD_NOT_OPEN_FILE);
+		return IL_FALSE;
+	}
+
+	TIFFSetField(File, TIFFTAG_IMAGEWIDTH, Src->Width);
+	TIFFSetField(File, TIFFTAG_IMAGELENGTH, Src->Height);
+	TIFFSetField(File, TIFFTAG_COMPRESSION,
+		iGetHint(context, IL_COMPRESSION_HINT) == IL_USE_COMPRESSION ? COMPRESSION_LZW : COMPRESSION_NONE);
+	TIFFSetField(File, TIFFTAG_PHOTOMETRIC, Format == IL_LUMINANCE ? PHOTOMETRIC_MINISBLACK : PHOTOMETRIC_RGB);
+	TIFFSetField(File, TIFFTAG_BITSPERSAMPLE, ilGetBpcType(Type) << 3);
+	TIFFSetField(File, TIFFTAG_SAMPLESPERPIXEL, ilGetBppFormat(Format));
+	if (Format == IL_RGBA)
+		TIFFSetField(File, TIFFTAG_MATTEING, 1);
+	TIFFSetField(File, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+	TIFFSetField(File, TIFFTAG_ROWSPERSTRIP, 1);
+	TIFFSetField(File, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+	iTiffSetInfoTags(context, File);
+
+	for (y = 0; y < Src->Height; y++) {
+		Row = iRowsNext(context, Src);
+		if (Row == NULL) {
+			TIFFClose(File);
+			return IL_FALSE;
+		}
+		if (TIFFWriteScanline(File, Row, y, 0) < 0) {
+			TIFFClose(File);
+			ilSetError(context, IL_LIB_TIFF_ERROR);
+			return IL_FALSE;
+		}
+	}
+
+	TIFFClose(File);
+	return IL_TRUE;
+}
+
 // Makes a neat date string for the date field.
 // From http://www.awaresystems.be/imaging/tiff/tifftags/datetime.html :
 // The format is: "YYYY:MM:DD HH:MM:SS", with hours like those on
 // a 24-hour clock, and one space character between the date and the
 // time. The length of the string, including the terminating NUL, is
-// 20 bytes.)
-char *iMakeString()
+// 20 bytes.)  TimeStr receives the string and must hold those 20 bytes.
+char *iMakeString(char *TimeStr)
 {
-	static char TimeStr[20];
 	time_t		Time;
-	struct tm	*CurTime;
+	struct tm	CurTime;
 
 	imemclear(TimeStr, 20);
 
 	time(&Time);
 #ifdef _WIN32
 	_tzset();
+	localtime_s(&CurTime, &Time);
+#else
+	localtime_r(&Time, &CurTime);
 #endif
-	CurTime = localtime(&Time);
 
-	strftime(TimeStr, 20, "%Y:%m:%d %H:%M:%S", CurTime);
+	strftime(TimeStr, 20, "%Y:%m:%d %H:%M:%S", &CurTime);
 	
 	return TimeStr;
 }
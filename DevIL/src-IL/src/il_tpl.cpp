@@ -314,7 +314,7 @@ ILboolean TplHandler::loadInternal()
 							}
 							DataOff = Image->Bps * (y + yBlock) + Image->Bpp * x;
 							for (xBlock = 0; xBlock < 8; xBlock += 2) {
-								BytePixel = context->impl->igetc(context);
+								BytePixel = iGetcFast(context);
 								if ((x + xBlock) >= Image->Width)
 									continue;  // Already read the pad byte.
 								Image->Data[DataOff] = (BytePixel & 0xF0) | (BytePixel & 0xF0) >> 4;
@@ -342,10 +342,10 @@ ILboolean TplHandler::loadInternal()
 							DataOff = Image->Bps * (y + yBlock) + Image->Bpp * x;
 							for (xBlock = 0; xBlock < 8; xBlock++) {
 								if ((x + xBlock) >= Image->Width) {
-									context->impl->igetc(context);  // Skip the pad byte.
+									iGetcFast(context);  // Skip the pad byte.
 									continue;
 								}
-								Image->Data[DataOff] = context->impl->igetc(context);  // Luminance value
+								Image->Data[DataOff] = iGetcFast(context);  // Luminance value
 								DataOff++;
 							}
 						}
@@ -364,7 +364,7 @@ ILboolean TplHandler::loadInternal()
 							}
 							DataOff = Image->Bps * (y + yBlock) + Image->Bpp * x;
 							for (xBlock = 0; xBlock < 8; xBlock += 2) {
-								BytePixel = context->impl->igetc(context);
+								BytePixel = iGetcFast(context);
 								if ((x + xBlock) >= Image->Width)
 									continue;  // Already read the pad byte.
 								Image->Data[DataOff] = (BytePixel & 0xF0) | (BytePixel & 0xF0) >> 4;
@@ -391,8 +391,8 @@ ILboolean TplHandler::loadInternal()
 									context->impl->iseek(context, 2, IL_SEEK_CUR);  // Skip the pad bytes.
 									continue;
 								}
-								Image->Data[DataOff] = context->impl->igetc(context);
-								Image->Data[DataOff+1] = context->impl->igetc(context);
+								Image->Data[DataOff] = iGetcFast(context);
+								Image->Data[DataOff+1] = iGetcFast(context);
 								DataOff += 2;
 							}
 						}
@@ -478,8 +478,8 @@ ILboolean TplHandler::loadInternal()
 									context->impl->iseek(context, 2, IL_SEEK_CUR);  // Skip pad bytes.
 									continue;
 								}
-								Image->Data[DataOff+3] = context->impl->igetc(context);  // Alpha
-								Image->Data[DataOff] = context->impl->igetc(context);  // Red
+								Image->Data[DataOff+3] = iGetcFast(context);  // Alpha
+								Image->Data[DataOff] = iGetcFast(context);  // Red
 								DataOff += 3;
 							}
 
@@ -490,8 +490,8 @@ ILboolean TplHandler::loadInternal()
 									context->impl->iseek(context, 2, IL_SEEK_CUR);  // Skip pad bytes.
 									continue;
 								}
-								Image->Data[DataOff+1] = context->impl->igetc(context);  // Green
-								Image->Data[DataOff+2] = context->impl->igetc(context);  // Blue
+								Image->Data[DataOff+1] = iGetcFast(context);  // Green
+								Image->Data[DataOff+2] = iGetcFast(context);  // Blue
 								DataOff += 3;
 							}
 						}
@@ -613,12 +613,12 @@ ILboolean TplGetIndexImage(ILcontext* context, ILimage *Image, ILuint TexOff, IL
 			PalBpp = 4;
 
 			for (i = 0; i < NumPal; i++) {
-				LumVal = context->impl->igetc(context);
+				LumVal = iGetcFast(context);
 				//@TODO: Do proper conversion of luminance, or support this format natively.
 				Image->Pal.Palette[i * 4] = LumVal;  // Assign the luminance value.
 				Image->Pal.Palette[i * 4 + 1] = LumVal;
 				Image->Pal.Palette[i * 4 + 2] = LumVal;
-				Image->Pal.Palette[i * 4 + 3] = context->impl->igetc(context);  // Get alpha value.
+				Image->Pal.Palette[i * 4 + 3] = iGetcFast(context);  // Get alpha value.
 			}
 			break;
 
@@ -690,7 +690,7 @@ ILboolean TplGetIndexImage(ILcontext* context, ILimage *Image, ILuint TexOff, IL
 						}
 						DataOff = Image->Bps * (y + yBlock) + Image->Bpp * x;
 						for (xBlock = 0; xBlock < 8; xBlock += 2) {
-							BytePixel = context->impl->igetc(context);
+							BytePixel = iGetcFast(context);
 							if ((x + xBlock) >= Image->Width)
 								continue;  // Already read the pad byte.
 							Image->Data[DataOff] = (BytePixel & 0xF0) | (BytePixel & 0xF0) >> 4;
@@ -719,10 +719,10 @@ ILboolean TplGetIndexImage(ILcontext* context, ILimage *Image, ILuint TexOff, IL
 						DataOff = Image->Bps * (y + yBlock) + Image->Bpp * x;
 						for (xBlock = 0; xBlock < 8; xBlock++) {
 							if ((x + xBlock) >= Image->Width) {
-								context->impl->igetc(context);  // Skip the pad byte.
+								iGetcFast(context);  // Skip the pad byte.
 								continue;
 							}
-							Image->Data[DataOff] = context->impl->igetc(context);  // Color index
+							Image->Data[DataOff] = iGetcFast(context);  // Color index
 							DataOff++;
 						}
 					}
@@ -763,7 +763,7 @@ ILboolean TplGetIndexImage(ILcontext* context, ILimage *Image, ILuint TexOff, IL
 				}
 			}
 			// Get rid of the palette, since we no longer need it.
-			ifree(Image->Pal.Palette);
+			ifree(context, Image->Pal.Palette);
 			Image->Pal.PalType = IL_PAL_NONE;
 			Image->Pal.PalSize = 0;
 			break;
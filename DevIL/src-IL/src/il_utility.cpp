@@ -166,6 +166,6 @@ ILAPI void ILAPIENTRY iMemSwap(ILcontext* context, ILubyte *s1, ILubyte *s2, con
 		memcpy(s1,s2,i);
 		memcpy(s2,block,i);
 	}
-	ifree(block);
+	ifree(context, block);
 	return;
 }
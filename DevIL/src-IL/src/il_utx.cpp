@@ -361,10 +361,10 @@ bool GetUtxImportTable(ILcontext* context, std::vector <UTXIMPORTTABLE> &ImportT
 {
 	ILuint i;
 	for (i = 0; i < NumPal; i++) {
-		//ifree(Palettes[i].Name);
-		ifree(Palettes[i].Pal);
+		//ifree(context, Palettes[i].Name);
+		ifree(context, Palettes[i].Pal);
 	}
-	ifree(Palettes);
+	ifree(context, Palettes);
 }*/
 
 ILenum UtxFormatToDevIL(ILuint Format)
@@ -586,7 +586,7 @@ ILboolean UtxHandler::loadInternal()
 						return IL_FALSE;
 
 					if (context->impl->iread(context, CompData, Image->DxtcSize, 1) != 1) {
-						ifree(CompData);
+						ifree(context, CompData);
 						return IL_FALSE;
 					}
 					// Keep a copy of the DXTC data if the user wants it.
@@ -596,10 +596,10 @@ ILboolean UtxHandler::loadInternal()
 						CompData = NULL;
 					}
 					if (DecompressDXT1(Image, CompData) == IL_FALSE) {
-						ifree(CompData);
+						ifree(context, CompData);
 						return IL_FALSE;
 					}
-					ifree(CompData);
+					ifree(context, CompData);
 					break;
 			}
 			Image->Origin = IL_ORIGIN_UPPER_LEFT;
@@ -708,7 +708,7 @@ ILboolean VtfHandler::loadInternal()
 						break;
 				}
 
-				ifree(CompData);
+				ifree(context, CompData);
 				CompData = NULL;
 				if (bVtf == IL_FALSE)  //@TODO: Do we need to do any cleanup here?
 					return IL_FALSE;
@@ -944,7 +944,7 @@ ILboolean VtfHandler::saveInternal()
 	if (TempImage->Origin != IL_ORIGIN_UPPER_LEFT) {
 		TempData = iGetFlipped(context, TempImage);
 		if (TempData == NULL) {
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	} else {
@@ -1005,13 +1005,13 @@ ILboolean VtfHandler::saveInternal()
 		if (CompSize == 0) {
 			ilSetError(context, IL_INTERNAL_ERROR);
 			if (TempData != TempImage->Data)
-				ifree(TempData);
+				ifree(context, TempData);
 			return IL_FALSE;
 		}
 		CompData = (ILubyte*)ialloc(context, CompSize);
 		if (CompData == NULL) {
 			if (TempData != TempImage->Data)
-				ifree(TempData);
+				ifree(context, TempData);
 			return IL_FALSE;
 		}
 
@@ -1020,22 +1020,22 @@ ILboolean VtfHandler::saveInternal()
 		if (CompSize == 0) {
 			ilSetError(context, IL_INTERNAL_ERROR);
 			if (TempData != TempImage->Data)
-				ifree(TempData);
+				ifree(context, TempData);
 			return IL_FALSE;
 		}
 		// Finally write the data.
 		if (context->impl->iwrite(context, CompData, CompSize, 1) != 1) {
-			ifree(CompData);
+			ifree(context, CompData);
 			if (TempData != TempImage->Data)
-				ifree(TempData);
+				ifree(context, TempData);
 			return IL_FALSE;
 		}
 	}
 
 	if (TempData != TempImage->Data)
-		ifree(TempData);
+		ifree(context, TempData);
 	if (TempImage != context->impl->iCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 
 	return IL_TRUE;
 }
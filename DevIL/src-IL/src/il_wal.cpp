@@ -128,7 +128,7 @@ ILboolean WalHandler::loadInternal()
 	}
 
 	context->impl->iCurImage = CurImage;
-	ilCloseImage(context->impl->iCurImage->Mipmaps);
+	ilCloseImage(context, context->impl->iCurImage->Mipmaps);
 	context->impl->iCurImage->Mipmaps = Mipmaps[0];
 	Mipmaps[0]->Mipmaps = Mipmaps[1];
 	Mipmaps[1]->Mipmaps = Mipmaps[2];
@@ -136,7 +136,7 @@ ILboolean WalHandler::loadInternal()
 	context->impl->iCurImage->Origin = IL_ORIGIN_UPPER_LEFT;
 
 	if (context->impl->iCurImage->Pal.Palette && context->impl->iCurImage->Pal.PalSize && context->impl->iCurImage->Pal.PalType != IL_PAL_NONE)
-		ifree(context->impl->iCurImage->Pal.Palette);
+		ifree(context, context->impl->iCurImage->Pal.Palette);
 	context->impl->iCurImage->Pal.Palette = (ILubyte*)ialloc(context, 768);
 	if (context->impl->iCurImage->Pal.Palette == NULL)
 		goto cleanup_error;
@@ -160,7 +160,7 @@ ILboolean WalHandler::loadInternal()
 
 cleanup_error:
 	for (i = 0; i < 3; i++) {
-		ilCloseImage(Mipmaps[i]);
+		ilCloseImage(context, Mipmaps[i]);
 	}
 	return IL_FALSE;
 }
@@ -116,7 +116,7 @@ ILboolean WbmpHandler::loadInternal()
 			context->impl->iCurImage->Data[i] = 0xFF;  // White
 	}
 
-	bclose(File);
+	bclose(context, File);
 
 	return IL_TRUE;
 }
@@ -238,7 +238,7 @@ ILboolean WbmpHandler::saveInternal()
 	if (TempImage->Origin != IL_ORIGIN_UPPER_LEFT) {
 		TempData = iGetFlipped(context, TempImage);
 		if (TempData == NULL) {
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 			return IL_FALSE;
 		}
 	} else {
@@ -259,8 +259,8 @@ ILboolean WbmpHandler::saveInternal()
 	}
 
 	if (TempData != TempImage->Data)
-		ifree(TempData);
-	ilCloseImage(TempImage);
+		ifree(context, TempData);
+	ilCloseImage(context, TempImage);
 
 	return IL_TRUE;
 }
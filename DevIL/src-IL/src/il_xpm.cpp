@@ -173,7 +173,7 @@ XPMHASHENTRY** XpmCreateHashTable(ILcontext* context)
 	return Table;
 }
 
-void XpmDestroyHashTable(XPMHASHENTRY **Table)
+void XpmDestroyHashTable(ILcontext* context, XPMHASHENTRY **Table)
 {
 	ILint i;
 	XPMHASHENTRY* Entry;
@@ -181,12 +181,12 @@ void XpmDestroyHashTable(XPMHASHENTRY **Table)
 	for (i = 0; i < XPM_HASH_LEN; ++i) {
 		while (Table[i] != NULL) {
 			Entry = Table[i]->Next;
-			ifree(Table[i]);
+			ifree(context, Table[i]);
 			Table[i] = Entry;
 		}
 	}
 
-	ifree(Table);
+	ifree(context, Table);
 }
 
 void XpmInsertEntry(ILcontext* context, XPMHASHENTRY **Table, const ILubyte* Name, int Len, XpmPixel Colour)
@@ -587,10 +587,10 @@ ILboolean XpmHandler::loadInternal()
 		Size = XpmGets(context, Buffer, BUFFER_SIZE);
 #ifndef XPM_DONT_USE_HASHTABLE
 		if (!XpmGetColour(context, Buffer, Size, CharsPerPixel, HashTable)) {
-			XpmDestroyHashTable(HashTable);
+			XpmDestroyHashTable(context, HashTable);
 #else
 		if (!XpmGetColour(Buffer, Size, CharsPerPixel, Colours)) {
-			ifree(Colours);
+			ifree(context, Colours);
 #endif
 			return IL_FALSE;
 		}
@@ -598,9 +598,9 @@ ILboolean XpmHandler::loadInternal()
 	
 	if (!ilTexImage(context, Width, Height, 1, 4, IL_RGBA, IL_UNSIGNED_BYTE, NULL)) {
 #ifndef XPM_DONT_USE_HASHTABLE
-		XpmDestroyHashTable(HashTable);
+		XpmDestroyHashTable(context, HashTable);
 #else
-		ifree(Colours);
+		ifree(context, Colours);
 #endif
 		return IL_FALSE;
 	}
@@ -629,9 +629,9 @@ ILboolean XpmHandler::loadInternal()
 
 
 #ifndef XPM_DONT_USE_HASHTABLE
-	XpmDestroyHashTable(HashTable);
+	XpmDestroyHashTable(context, HashTable);
 #else
-	ifree(Colours);
+	ifree(context, Colours);
 #endif
 	return IL_TRUE;
 
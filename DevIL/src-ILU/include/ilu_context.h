@@ -5,6 +5,7 @@
 struct ILUcontext
 {
     ILcontext* ilContext;
+	ILenum		Filter;  // ILU_FILTER at the time of the call
 
 	// Resize variables
 	ILuint		x1, x2;
@@ -51,9 +51,6 @@
 	#define TEXT(s) s
 #endif
 
-extern ILimage *iluCurImage;
-
-
 // Useful global variables
 extern const ILdouble	IL_PI;
 extern const ILdouble	IL_DEGCONV;
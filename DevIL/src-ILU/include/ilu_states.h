@@ -14,7 +14,21 @@
 #ifndef STATES_H
 #define STATES_H
 
-extern ILenum iluFilter;
-extern ILenum iluPlacement;
+// ILU state of a single context, created the first time it is needed
+//  and freed together with the context.
+class ILcontext::IluImpl
+{
+public:
+	ILenum		iluFilter = ILU_NEAREST;
+	ILenum		iluPlacement = ILU_CENTER;
+	ILenum		iluLanguage = ILU_ENGLISH;
+
+	// Region set by iluRegionfv/iluRegioniv
+	ILpointi	*RegionPointsi = NULL;
+	ILpointf	*RegionPointsf = NULL;
+	ILuint		PointNum = 0;
+};
+
+ILcontext::IluImpl *iluGetState(ILcontext* context);
 
 #endif//STATES_H
@@ -12,6 +12,7 @@
 
 
 #include "ilu_internal.h"
+#include "ilu_states.h"
 #include "ilu_error/ilu_err-arabic.h"
 #include "ilu_error/ilu_err-dutch.h"
 #include "ilu_error/ilu_err-english.h"
@@ -22,9 +23,6 @@
 #include "ilu_error/ilu_err-spanish.h"
 
 
-ILconst_string *iluErrors;
-ILconst_string *iluLibErrors;
-ILconst_string *iluMiscErrors;
 #define ILU_NUM_LANGUAGES 8
 
 ILconst_string *iluErrorStrings[ILU_NUM_LANGUAGES] = {
@@ -61,8 +59,13 @@ ILconst_string *iluMiscErrorStrings[ILU_NUM_LANGUAGES] = {
 };
 
 
-ILconst_string ILAPIENTRY iluErrorString(ILenum Error)
+ILconst_string ILAPIENTRY iluErrorString(ILcontext* context, ILenum Error)
 {
+	ILuint			Language = iluGetState(context)->iluLanguage - ILU_ENGLISH;
+	ILconst_string	*iluErrors = iluErrorStrings[Language];
+	ILconst_string	*iluLibErrors = iluLibErrorStrings[Language];
+	ILconst_string	*iluMiscErrors = iluMiscErrorStrings[Language];
+
 	// Now we are dealing with Unicode strings.
 	if (Error == IL_NO_ERROR) {
 		return iluMiscErrors[0];
@@ -93,9 +96,7 @@ ILboolean ILAPIENTRY iluSetLanguage(ILcontext* context, ILenum Language)
 		case ILU_SPANISH:
 		case ILU_GERMAN:
 		case ILU_ITALIAN:
-			iluErrors = iluErrorStrings[Language - ILU_ENGLISH];
-			iluLibErrors = iluLibErrorStrings[Language - ILU_ENGLISH];
-			iluMiscErrors = iluMiscErrorStrings[Language - ILU_ENGLISH];
+			iluGetState(context)->iluLanguage = Language;
 			break;
 
 		default:
@@ -17,7 +17,7 @@ ILboolean ILAPIENTRY iluPixelize(ILcontext* context, ILuint PixSize)
 	ILdouble	*DblPtr, DblTotal, DblTested;
 	ILubyte		*RegionMask;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -175,7 +175,7 @@ ILboolean ILAPIENTRY iluPixelize(ILcontext* context, ILuint PixSize)
 			break;
 	}
 
-	ifree(RegionMask);
+	ifree(context, RegionMask);
 
 	return IL_TRUE;
 }
@@ -288,7 +288,9 @@ ILubyte *Filter(ILcontext* context, ILimage *Image, const ILint *matrix, ILint s
 		for (x = 1; x < (ILint)Image->Width-1; x++) {
 			if (RegionMask) {
 				if (!RegionMask[x]) {
-					Data[y + x * Image->Bpp + c] = Image->Data[y + x * Image->Bpp + c];
+					for (c = 0; c < Image->Bpp; c++) {
+						Data[x * Image->Bpp + c] = Image->Data[x * Image->Bpp + c];
+					}
 					continue;
 				}
 			}
@@ -316,7 +318,9 @@ ILubyte *Filter(ILcontext* context, ILimage *Image, const ILint *matrix, ILint s
 		for (x = 1; x < (ILint)Image->Width-1; x++) {
 			if (RegionMask) {
 				if (!RegionMask[(Image->Height - 1) * Image->Width + x]) {
-					Data[y + x * Image->Bpp + c] = Image->Data[y + x * Image->Bpp + c];
+					for (c = 0; c < Image->Bpp; c++) {
+						Data[y + x * Image->Bpp + c] = Image->Data[y + x * Image->Bpp + c];
+					}
 					continue;
 				}
 			}
@@ -343,7 +347,9 @@ ILubyte *Filter(ILcontext* context, ILimage *Image, const ILint *matrix, ILint s
 		for (i = 1, y = Image->Bps; i < Image->Height-1; i++, y += Image->Bps) {
 			if (RegionMask) {
 				if (!RegionMask[y / Image->Bpp]) {
-					Data[y + c] = Image->Data[y + c];
+					for (c = 0; c < Image->Bpp; c++) {
+						Data[y + c] = Image->Data[y + c];
+					}
 					continue;
 				}
 			}
@@ -377,15 +383,17 @@ ILubyte *Filter(ILcontext* context, ILimage *Image, const ILint *matrix, ILint s
 				}
 			}
 			for (c = 0; c < Image->Bpp; c++) {
-				Num =   Image->Data[y - Image->Bps + c] * matrix[0] +
-						Image->Data[y - Image->Bps + Image->Bpp + c] * matrix[1]+
-						Image->Data[y - Image->Bps + 2 * Image->Bpp + c] * matrix[2]+
-						Image->Data[y + c] * matrix[3]+
-						Image->Data[y + Image->Bpp + c] * matrix[4]+
-						Image->Data[y + 2 * Image->Bpp + c] * matrix[5]+
-						Image->Data[y + Image->Bps + c] * matrix[6]+
-						Image->Data[y + Image->Bps + Image->Bpp + c] * matrix[7]+
-						Image->Data[y + Image->Bps + 2 * Image->Bpp + c] * matrix[8];
+				// Mirror of the left side: the last three columns, so the window
+				//	never runs past the end of the row (or of the image).
+				Num =   Image->Data[y - Image->Bps - 2 * Image->Bpp + c] * matrix[0] +
+						Image->Data[y - Image->Bps - Image->Bpp + c] * matrix[1]+
+						Image->Data[y - Image->Bps + c] * matrix[2]+
+						Image->Data[y - 2 * Image->Bpp + c] * matrix[3]+
+						Image->Data[y - Image->Bpp + c] * matrix[4]+
+						Image->Data[y + c] * matrix[5]+
+						Image->Data[y + Image->Bps - 2 * Image->Bpp + c] * matrix[6]+
+						Image->Data[y + Image->Bps - Image->Bpp + c] * matrix[7]+
+						Image->Data[y + Image->Bps + c] * matrix[8];
 
 					Temp = (ILuint)fabs((Num / (ILdouble)scale) + bias);
 					if (Temp > 255)
@@ -400,7 +408,7 @@ ILubyte *Filter(ILcontext* context, ILimage *Image, const ILint *matrix, ILint s
 		Data += Image->SizeOfPlane;
 	}
 
-	ifree(RegionMask);
+	ifree(context, RegionMask);
 
 	// Restore original data.
 	Image->Data = ImgData;
@@ -417,7 +425,7 @@ ILboolean ILAPIENTRY iluEdgeDetectP(ILcontext* context)
 	ILboolean	Palette = IL_FALSE, Converted = IL_FALSE;
 	ILenum		Type = 0;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -437,8 +445,8 @@ ILboolean ILAPIENTRY iluEdgeDetectP(ILcontext* context)
 	HPass = Filter(context, iluCurImage, filter_h_prewitt, filter_h_prewitt_scale, filter_h_prewitt_bias);
 	VPass = Filter(context, iluCurImage, filter_v_prewitt, filter_v_prewitt_scale, filter_v_prewitt_bias);
 	if (!HPass || !VPass) {
-		ifree(HPass);
-		ifree(VPass);
+		ifree(context, HPass);
+		ifree(context, VPass);
 		return IL_FALSE;
 	}
 
@@ -457,8 +465,8 @@ ILboolean ILAPIENTRY iluEdgeDetectP(ILcontext* context)
 		iluCurImage->Data[i] = (ILubyte)sqrt(HPass[i]*HPass[i]+VPass[i]*VPass[i]);
 	}*/
 	
-	ifree(HPass);
-	ifree(VPass);
+	ifree(context, HPass);
+	ifree(context, VPass);
 
 	if (Palette)
 		ilConvertImage(context, IL_COLOUR_INDEX, IL_UNSIGNED_BYTE);
@@ -476,7 +484,7 @@ ILboolean ILAPIENTRY iluEdgeDetectS(ILcontext* context)
 	ILboolean	Palette = IL_FALSE, Converted = IL_FALSE;
 	ILenum		Type = 0;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -495,8 +503,8 @@ ILboolean ILAPIENTRY iluEdgeDetectS(ILcontext* context)
 	HPass = Filter(context, iluCurImage, filter_h_sobel, filter_h_sobel_scale, filter_h_sobel_bias);
 	VPass = Filter(context, iluCurImage, filter_v_sobel, filter_v_sobel_scale, filter_v_sobel_bias);
 	if (!HPass || !VPass) {
-		ifree(HPass);
-		ifree(VPass);
+		ifree(context, HPass);
+		ifree(context, VPass);
 		return IL_FALSE;
 	}
 
@@ -515,8 +523,8 @@ ILboolean ILAPIENTRY iluEdgeDetectS(ILcontext* context)
 		iluCurImage->Data[i] = (ILubyte)sqrt(HPass[i]*HPass[i]+VPass[i]*VPass[i]);
 	}*/
 	
-	ifree(HPass);
-	ifree(VPass);
+	ifree(context, HPass);
+	ifree(context, VPass);
 
 	if (Palette)
 		ilConvertImage(context, IL_COLOUR_INDEX, IL_UNSIGNED_BYTE);
@@ -534,7 +542,7 @@ ILboolean ILAPIENTRY iluBlurAvg(ILcontext* context, ILuint Iter)
 	ILboolean	Palette = IL_FALSE, Converted = IL_FALSE;
 	ILenum		Type = 0;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -554,7 +562,7 @@ ILboolean ILAPIENTRY iluBlurAvg(ILcontext* context, ILuint Iter)
 		Data = Filter(context, iluCurImage, filter_average, filter_average_scale, filter_average_bias);
 		if (!Data)
 			return IL_FALSE;
-		ifree(iluCurImage->Data);
+		ifree(context, iluCurImage->Data);
 		iluCurImage->Data = Data;
 	}
 
@@ -574,7 +582,7 @@ ILboolean ILAPIENTRY iluBlurGaussian(ILcontext* context, ILuint Iter)
 	ILboolean	Palette = IL_FALSE, Converted = IL_FALSE;
 	ILenum		Type = 0;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -594,7 +602,7 @@ ILboolean ILAPIENTRY iluBlurGaussian(ILcontext* context, ILuint Iter)
 		Data = Filter(context, iluCurImage, filter_gaussian, filter_gaussian_scale, filter_gaussian_bias );
 		if (!Data)
 			return IL_FALSE;
-		ifree(iluCurImage->Data);
+		ifree(context, iluCurImage->Data);
 		iluCurImage->Data = Data;
 	}
 
@@ -613,7 +621,7 @@ ILboolean ILAPIENTRY iluEmboss(ILcontext* context)
 	ILboolean	Palette = IL_FALSE, Converted = IL_FALSE;
 	ILenum		Type = 0;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -632,7 +640,7 @@ ILboolean ILAPIENTRY iluEmboss(ILcontext* context)
 	Data = Filter(context, iluCurImage, filter_emboss, filter_emboss_scale, filter_emboss_bias);
 	if (!Data)
 		return IL_FALSE;
-	ifree(iluCurImage->Data);
+	ifree(context, iluCurImage->Data);
 	iluCurImage->Data = Data;
 
 	if (Palette)
@@ -648,7 +656,7 @@ ILboolean ILAPIENTRY iluEmboss(ILcontext* context)
 	ILuint	x, y, c, i = 0;
 	ILubyte	*Data;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -668,7 +676,7 @@ ILboolean ILAPIENTRY iluEmboss(ILcontext* context)
 		Data[i+x] = 128;
 	}
 
-	ifree(iluCurImage->Data);
+	ifree(context, iluCurImage->Data);
 	iluCurImage->Data = Data;
 
 	return IL_TRUE;
@@ -681,7 +689,7 @@ ILboolean ILAPIENTRY iluEdgeDetectE(ILcontext* context)
 	ILboolean	Palette = IL_FALSE, Converted = IL_FALSE;
 	ILenum		Type = 0;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -700,7 +708,7 @@ ILboolean ILAPIENTRY iluEdgeDetectE(ILcontext* context)
 	Data = Filter(context, iluCurImage, filter_embossedge, filter_embossedge_scale, filter_embossedge_bias);
 	if (!Data)
 		return IL_FALSE;
-	ifree(iluCurImage->Data);
+	ifree(context, iluCurImage->Data);
 	iluCurImage->Data = Data;
 
 	if (Palette)
@@ -716,7 +724,7 @@ ILboolean ILAPIENTRY iluScaleAlpha(ILcontext* context, ILfloat scale)
 	ILuint		i;
 	ILint		alpha;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -779,7 +787,7 @@ ILboolean ILAPIENTRY iluScaleColours(ILcontext* context, ILfloat r, ILfloat g, I
 	ILuint		*IntPtr, NumPix;
 	ILdouble	*DblPtr;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -939,7 +947,7 @@ ILboolean ILAPIENTRY iluGammaCorrect(ILcontext* context, ILfloat Gamma)
 	ILushort	*ShortPtr;
 	ILuint		*IntPtr;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -1092,7 +1100,7 @@ ILboolean ILAPIENTRY iluSaturate4f(ILcontext* context, ILfloat r, ILfloat g, ILf
 	Mat[3][2] = 0.0f;
 	Mat[3][3] = 1.0f;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -1112,7 +1120,7 @@ ILboolean ILAPIENTRY iluAlienify(ILcontext* context)
 	ILubyte	*Data;
 	ILuint	i;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -1196,7 +1204,7 @@ void iIntExtImg(ILimage *Image1, ILimage *Image2, ILfloat a)
 	ILimage	*Black;
 	ILuint	i;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, IL_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -1213,7 +1221,7 @@ void iIntExtImg(ILimage *Image1, ILimage *Image2, ILfloat a)
 	}
 
 	iIntExtImg(Black, iluCurImage, Gamma);
-	ilCloseImage(Black);
+	ilCloseImage(context, Black);
 
 	return IL_TRUE;
 }*/
@@ -1225,7 +1233,7 @@ ILboolean ILAPIENTRY iluContrast(ILcontext* context, ILfloat Contrast)
 	ILimage	*Grey;
 	ILuint	i;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, IL_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -1242,7 +1250,7 @@ ILboolean ILAPIENTRY iluContrast(ILcontext* context, ILfloat Contrast)
 	}
 
 	iIntExtImg(Grey, iluCurImage, Contrast);
-	ilCloseImage(Grey);
+	ilCloseImage(context, Grey);
 
 	return IL_TRUE;
 }
@@ -1275,7 +1283,7 @@ ILboolean ILAPIENTRY iluSharpen(ILcontext* context, ILfloat Factor, ILuint Iter)
 		iIntExtImg(Blur, CurImage, Factor);
 	}
 
-	ilCloseImage(Blur);
+	ilCloseImage(context, Blur);
 	ilSetCurImage(context, CurImage);
 
 	return IL_TRUE;
@@ -1305,7 +1313,7 @@ ILAPI ILboolean ILAPIENTRY iluConvolution(ILcontext* context, ILint *matrix, ILi
 	Data = Filter(context, iluCurImage, matrix, scale, bias);
 	if (!Data)
 		return IL_FALSE;
-	ifree(iluCurImage->Data);
+	ifree(context, iluCurImage->Data);
 	iluCurImage->Data = Data;
 	
 	if (Palette)
@@ -1323,7 +1331,7 @@ ILboolean ILAPIENTRY iluSepia(ILcontext* context)
 {
 	ILubyte	*Data;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -197,8 +197,6 @@ char	_Copyright[] = "Public Domain 1991 by Dale Schumacher. Mods by Ray Gardener
 
 #define CLAMP(v,l,h)    ((v)<(l) ? (l) : (v) > (h) ? (h) : v)
 
-static ILuint c;  // Current colour plane offset
-
 typedef struct {
 	int	pixel;
 	double	weight;
@@ -209,8 +207,6 @@ typedef struct {
 	CONTRIB	*p;		/* pointer to list of contributions */
 } CLIST;
 
-CLIST	*contrib;		/* array of contribution lists */
-
 /*
  *	generic image access and i/o support routines
  */
@@ -288,10 +284,10 @@ int calc_x_contrib( ILcontext* context, CLIST *contribX, double xscale, double f
 /*
 	zoom()
 
-	Resizes bitmaps while resampling them.
+	Resizes bitmaps while resampling them, one colour plane (offset c) at a time.
 	Returns -1 if error, 0 if success.
 */
-int zoom( ILcontext* context, ILimage *dst, ILimage *src, double (*filterf)(double), double fwidth) {
+int zoom( ILcontext* context, ILimage *dst, ILimage *src, double (*filterf)(double), double fwidth, ILuint c) {
 	ILubyte* tmp;
 	double xscale, yscale;		/* zoom scale factors */
 	int xx;
@@ -317,7 +313,7 @@ int zoom( ILcontext* context, ILimage *dst, ILimage *src, double (*filterf)(doub
 	/* pre-calculate filter contributions for a column */
 	contribY = (CLIST*)icalloc(context, dst->Height, sizeof(CLIST));
 	if (contribY == NULL) {
-		ifree(tmp);
+		ifree(context, tmp);
 		return -1;
 	}
 
@@ -333,8 +329,8 @@ int zoom( ILcontext* context, ILimage *dst, ILimage *src, double (*filterf)(doub
 			contribY[i].p = (CONTRIB*)icalloc(context, (int) (width * 2 + 1),
 					sizeof(CONTRIB));
 			if(contribY[i].p == NULL) {
-				ifree(tmp);
-				ifree(contribY);
+				ifree(context, tmp);
+				ifree(context, contribY);
 				return -1;
 			}
 			center = (double) i / yscale;
@@ -355,8 +351,8 @@ int zoom( ILcontext* context, ILimage *dst, ILimage *src, double (*filterf)(doub
 			contribY[i].p = (CONTRIB*)icalloc(context, (int) (fwidth * 2 + 1),
 					sizeof(CONTRIB));
 			if (contribY[i].p == NULL) {
-				ifree(tmp);
-				ifree(contribY);
+				ifree(context, tmp);
+				ifree(context, contribY);
 				return -1;
 			}
 			center = (double) i / yscale;
@@ -403,7 +399,7 @@ int zoom( ILcontext* context, ILimage *dst, ILimage *src, double (*filterf)(doub
 			tmp[k] = (ILubyte)CLAMP(weight, BLACK_PIXEL, WHITE_PIXEL);
 		} /* next row in temp column */
 
-		ifree(contribX.p);
+		ifree(context, contribX.p);
 
 		/* The temp column has been built. Now stretch it 
 		 vertically into dst column. */
@@ -430,12 +426,12 @@ int zoom( ILcontext* context, ILimage *dst, ILimage *src, double (*filterf)(doub
 	nRet = 0; /* success */
 
 __zoom_cleanup:
-	ifree(tmp);
+	ifree(context, tmp);
 
 	// Free the memory allocated for vertical filter weights
 	for (i = 0; i < (ILint)dst->Height; ++i)
-		ifree(contribY[i].p);
-	ifree(contribY);
+		ifree(context, contribY[i].p);
+	ifree(context, contribY);
 
 	return nRet;
 } /* zoom */
@@ -446,8 +442,9 @@ ILuint iluScaleAdvanced(ILcontext* context, ILuint Width, ILuint Height, ILenum
 	double (*f)(double) = filter;
 	double s = filter_support;
 	ILimage *Dest;
+	ILuint	c;  // Current colour plane offset
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -476,7 +473,7 @@ ILuint iluScaleAdvanced(ILcontext* context, ILuint Width, ILuint Height, ILenum
 	Dest->Origin = iluCurImage->Origin;
 	Dest->Duration = iluCurImage->Duration;
 	for (c = 0; c < (ILuint)iluCurImage->Bpp; c++) {
-		if (zoom(context, Dest, iluCurImage, f, s) != 0) {
+		if (zoom(context, Dest, iluCurImage, f, s, c) != 0) {
 			return IL_FALSE;
 		}
 	}
@@ -484,7 +481,7 @@ ILuint iluScaleAdvanced(ILcontext* context, ILuint Width, ILuint Height, ILenum
 	ilTexImage(context, Width, Height, 1, iluCurImage->Bpp, iluCurImage->Format, iluCurImage->Type, Dest->Data);
 	iluCurImage->Origin = Dest->Origin;
 	iluCurImage->Duration = Dest->Duration;
-	ilCloseImage(Dest);
+	ilCloseImage(context, Dest);
 
 	return IL_TRUE;
 }
@@ -5,7 +5,6 @@
 
 const ILdouble IL_PI      = 3.1415926535897932384626;
 const ILdouble IL_DEGCONV = 0.0174532925199432957692;
-ILimage *iluCurImage = NULL;
 
 ILfloat ilCos(ILfloat Angle) {
     return (ILfloat)(cos(Angle * IL_DEGCONV));
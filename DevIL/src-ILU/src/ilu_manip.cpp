@@ -10,7 +10,7 @@ ILboolean iluCrop2D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint Width,
 	ILubyte	*Data;
 	ILenum	Origin;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -46,7 +46,7 @@ ILboolean iluCrop2D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint Width,
 		}
 	}
 
-	ifree(Data);
+	ifree(context, Data);
 
 	return IL_TRUE;
 }
@@ -58,7 +58,7 @@ ILboolean iluCrop3D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZOff, I
 	ILubyte	*Data;
 	ILenum	Origin;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -80,7 +80,7 @@ ILboolean iluCrop3D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZOff, I
 	Origin = iluCurImage->Origin;
 	ilCopyPixels(context, 0, 0, 0, iluCurImage->Width, iluCurImage->Height, iluCurImage->Depth, iluCurImage->Format, iluCurImage->Type, Data);
 	if (!ilTexImage(context, Width - XOff, Height - YOff, Depth - ZOff, iluCurImage->Bpp, iluCurImage->Format, iluCurImage->Type, NULL)) {
-		ifree(Data);
+		ifree(context, Data);
 	}
 	iluCurImage->Origin = Origin;
 
@@ -95,7 +95,7 @@ ILboolean iluCrop3D(ILcontext* context, ILuint XOff, ILuint YOff, ILuint ZOff, I
 		}
 	}
 
-	ifree(Data);
+	ifree(context, Data);
 
 	return IL_TRUE;
 }
@@ -116,7 +116,7 @@ ILboolean ILAPIENTRY iluEnlargeCanvas(ILcontext* context, ILuint Width, ILuint H
 	ILuint	x, y, z, OldBps, OldH, OldD, OldPlane, AddX, AddY;
 	ILenum	Origin;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -129,7 +129,7 @@ ILboolean ILAPIENTRY iluEnlargeCanvas(ILcontext* context, ILuint Width, ILuint H
 	}
 
 	if (iluCurImage->Origin == IL_ORIGIN_LOWER_LEFT) {
-		switch (iluPlacement)
+		switch (iluGetState(context)->iluPlacement)
 		{
 			case ILU_LOWER_LEFT:
 				AddX = 0;
@@ -157,7 +157,7 @@ ILboolean ILAPIENTRY iluEnlargeCanvas(ILcontext* context, ILuint Width, ILuint H
 		}
 	}
 	else {  // IL_ORIGIN_UPPER_LEFT
-		switch (iluPlacement)
+		switch (iluGetState(context)->iluPlacement)
 		{
 			case ILU_LOWER_LEFT:
 				AddX = 0;
@@ -225,7 +225,7 @@ ILboolean ILAPIENTRY iluEnlargeCanvas(ILcontext* context, ILuint Width, ILuint H
 		}
 	}
 
-	ifree(Data);
+	ifree(context, Data);
 
 	return IL_TRUE;
 }
@@ -274,7 +274,7 @@ ILboolean ILAPIENTRY iluInvertAlpha(ILcontext* context) {
 	ILdouble	*DblPtr;
 	ILubyte		Bpp;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -339,7 +339,7 @@ ILboolean ILAPIENTRY iluNegative(ILcontext* context)
 	ILushort	*ShortPtr;
 	ILubyte		*RegionMask;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -423,7 +423,7 @@ ILboolean ILAPIENTRY iluNegative(ILcontext* context)
 		}
 	}
 
-	ifree(RegionMask);
+	ifree(context, RegionMask);
 
 	return IL_TRUE;
 }
@@ -438,7 +438,7 @@ ILboolean ILAPIENTRY iluWave(ILcontext* context, ILfloat Angle)
 	ILuint	y;
 	ILubyte	*DataPtr, *TempBuff;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -469,7 +469,7 @@ ILboolean ILAPIENTRY iluWave(ILcontext* context, ILfloat Angle)
 		}
 	}
 
-	ifree(TempBuff);
+	ifree(context, TempBuff);
 
 	return IL_TRUE;
 }
@@ -487,8 +487,8 @@ ILboolean ILAPIENTRY iluSwapColours(ILcontext* context) {
 		return IL_FALSE;
 	}
 
-	if (iluCurImage->Bpp == 1) {
-		if (ilGetBppPal(iluCurImage->Pal.PalType) == 0 || iluCurImage->Format != IL_COLOUR_INDEX) {
+	if (img->Bpp == 1) {
+		if (ilGetBppPal(img->Pal.PalType) == 0 || img->Format != IL_COLOUR_INDEX) {
 			ilSetError(context, ILU_ILLEGAL_OPERATION);  // Can be luminance.
 			return IL_FALSE;
 		}
@@ -544,7 +544,7 @@ ILuint ILAPIENTRY iluColoursUsed(ILcontext* context)
 		Heap[c] = 0;
 	}
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return 0;
@@ -625,14 +625,14 @@ ILuint ILAPIENTRY iluColoursUsed(ILcontext* context)
 	for (i = 0; i < 9; i++) {
 		if (Heap[i] == NULL)
 			break;
-		ifree(Heap[i]);
+		ifree(context, Heap[i]);
 	}
 
 	return NumCols;
 
 alloc_error:
 	for (i = 0; i < 9; i++) {
-		ifree(Heap[i]);
+		ifree(context, Heap[i]);
 	}
 
 	return 0;
@@ -645,7 +645,7 @@ ILboolean ILAPIENTRY iluCompareImage(ILcontext* context, ILuint Comp)
 	ILuint		OrigName, i;
 	ILboolean	Same = IL_TRUE;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	OrigName = ilGetCurName(context);
 
 	// Same image, so return true.
@@ -691,7 +691,7 @@ ILboolean ILAPIENTRY iluReplaceColour(ILcontext* context, ILubyte Red, ILubyte G
 	ILint	TolVal, Distance, Dist1, Dist2, Dist3;
 	ILuint	i, NumPix;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return 0;
@@ -774,7 +774,7 @@ ILboolean ILAPIENTRY iluEqualize(ILcontext* context) {
 
 	NewColour[0] = NewColour[1] = NewColour[2] = NewColour[3] = 0;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return 0;
@@ -899,7 +899,7 @@ ILboolean ILAPIENTRY iluEqualize(ILcontext* context) {
 		}
 	}
 
-	ilCloseImage(LumImage);
+	ilCloseImage(context, LumImage);
 
 	return IL_TRUE;
 }
@@ -912,7 +912,7 @@ ILboolean ILAPIENTRY iluEqualize(ILcontext* context) {
 // Note that the ordering of the colors does not matter for the first part of this method.
 ILboolean ILAPIENTRY iluEqualize2(ILcontext* context)
 {
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return 0;
@@ -1017,7 +1017,7 @@ ILboolean ILAPIENTRY iluEqualize2(ILcontext* context)
 		}
 	}
 
-	ifree(Corrected);
+	ifree(context, Corrected);
 
 	return IL_TRUE;
 }
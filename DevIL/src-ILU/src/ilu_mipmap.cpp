@@ -44,7 +44,7 @@ ILboolean iBuildMipmaps(ILcontext* context, ILimage *Parent, ILuint Width, ILuin
 // Note: No longer changes all textures to powers of 2.
 ILboolean ILAPIENTRY iluBuildMipmaps(ILcontext* context)
 {
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -52,7 +52,7 @@ ILboolean ILAPIENTRY iluBuildMipmaps(ILcontext* context)
 
 	// Get rid of any existing mipmaps.
 	if (iluCurImage->Mipmaps) {
-		ilCloseImage(iluCurImage->Mipmaps);
+		ilCloseImage(context, iluCurImage->Mipmaps);
 		iluCurImage->Mipmaps = NULL;
 	}
 
@@ -27,7 +27,7 @@ ILboolean ILAPIENTRY iluNoisify(ILcontext* context, ILclampf Tolerance)
 	ILuint		*IntPtr;
 	ILubyte		*RegionMask;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -108,7 +108,7 @@ ILboolean ILAPIENTRY iluNoisify(ILcontext* context, ILclampf Tolerance)
 			break;
 	}
 
-	ifree(RegionMask);
+	ifree(context, RegionMask);
 
 	return IL_TRUE;
 }
@@ -200,7 +200,7 @@ ILboolean ILAPIENTRY iluNoisify()
 	ILuint x, y, c;
 	ILint Val;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -13,56 +13,60 @@
 
 #include "ilu_internal.h"
 #include "ilu_region.h"
-
-ILpointi	*RegionPointsi = NULL;
-ILpointf	*RegionPointsf = NULL;
-ILuint		PointNum = 0;
-ILubyte		*iRegionMask = NULL;
+#include "ilu_states.h"
 
 void ILAPIENTRY iluRegionfv(ILcontext* context, ILpointf *Points, ILuint n)
 {
+	ILcontext::IluImpl *State = iluGetState(context);
+
 	if (Points == NULL || n == 0) {
-		ifree(RegionPointsi);
-		ifree(RegionPointsf);
-		RegionPointsf = NULL;
-		PointNum = 0;
+		ifree(context, State->RegionPointsi);
+		ifree(context, State->RegionPointsf);
+		State->RegionPointsi = NULL;
+		State->RegionPointsf = NULL;
+		State->PointNum = 0;
 		return;
 	}
 	if (n < 3) {
 		ilSetError(context, ILU_INVALID_PARAM);
 		return;
 	}
-	ifree(RegionPointsi);
-	ifree(RegionPointsf);
-	RegionPointsf = (ILpointf*)ialloc(context, sizeof(ILpointf) * n);
-	if (RegionPointsf == NULL)
+	ifree(context, State->RegionPointsi);
+	ifree(context, State->RegionPointsf);
+	State->RegionPointsi = NULL;
+	State->RegionPointsf = (ILpointf*)ialloc(context, sizeof(ILpointf) * n);
+	if (State->RegionPointsf == NULL)
 		return;
-	memcpy(RegionPointsf, Points, sizeof(ILpointi) * n);
-	PointNum = n;
+	memcpy(State->RegionPointsf, Points, sizeof(ILpointi) * n);
+	State->PointNum = n;
 	return;
 }
 
 
 void ILAPIENTRY iluRegioniv(ILcontext* context, ILpointi *Points, ILuint n)
 {
+	ILcontext::IluImpl *State = iluGetState(context);
+
 	if (Points == NULL || n == 0) {
-		ifree(RegionPointsi);
-		ifree(RegionPointsf);
-		RegionPointsi = NULL;
-		PointNum = 0;
+		ifree(context, State->RegionPointsi);
+		ifree(context, State->RegionPointsf);
+		State->RegionPointsi = NULL;
+		State->RegionPointsf = NULL;
+		State->PointNum = 0;
 		return;
 	}
 	if (n < 3) {
 		ilSetError(context, ILU_INVALID_PARAM);
 		return;
 	}
-	ifree(RegionPointsi);
-	ifree(RegionPointsf);
-	RegionPointsi = (ILpointi*)ialloc(context, sizeof(ILpointi) * n);
-	if (RegionPointsi == NULL)
+	ifree(context, State->RegionPointsi);
+	ifree(context, State->RegionPointsf);
+	State->RegionPointsf = NULL;
+	State->RegionPointsi = (ILpointi*)ialloc(context, sizeof(ILpointi) * n);
+	if (State->RegionPointsi == NULL)
 		return;
-	memcpy(RegionPointsi, Points, sizeof(ILpointi) * n);
-	PointNum = n;
+	memcpy(State->RegionPointsi, Points, sizeof(ILpointi) * n);
+	State->PointNum = n;
 	return;
 }
 
@@ -164,10 +168,10 @@ void BuildActiveList(ILint scan, Edge *active, Edge *edges[])
 }
 
 
-#define iRegionSetPixel(x,y) (iRegionMask[y * iluCurImage->Width + x] = 1 )
+#define iRegionSetPixel(x,y) (iRegionMask[y * Width + x] = 1 )
 
 
-void FillScan(ILint scan, Edge *active)
+void FillScan(ILint scan, Edge *active, ILubyte *iRegionMask, ILuint Width)
 {
 	Edge *p1, *p2;
 	ILint i;
@@ -183,23 +187,23 @@ void FillScan(ILint scan, Edge *active)
 }
 
 
-void DeleteAfter(Edge *q)
+void DeleteAfter(ILcontext* context, Edge *q)
 {
 	Edge *p = q->next;
 	q->next = p->next;
-	free(p);
+	ifree(context, p);
 }
 
 
 // Delete completed edges.  Update 'xIntersect' field for others
-void UpdateActiveList(ILint scan, Edge *active)
+void UpdateActiveList(ILcontext* context, ILint scan, Edge *active)
 {
 	Edge *q = active, *p = active->next;
 
 	while (p) {
 		if (scan >= p->yUpper) {
 			p = p->next;
-			DeleteAfter(q);
+			DeleteAfter(context, q);
 		}
 		else {
 			p->xIntersect = p->xIntersect + p->dxPerScan;
@@ -225,26 +229,27 @@ void ResortActiveList(Edge *active)
 
 ILubyte *iScanFill(ILcontext* context)
 {
-	Edge	**edges = NULL, *active = NULL/*, *temp*/;
+	Edge	**edges = NULL, *active = NULL, *temp;
 	ILuint	i, scan;
+	ILubyte	*iRegionMask = NULL;
+	ILimage	*iluCurImage = ilGetCurImage(context);
+	ILcontext::IluImpl *State = iluGetState(context);
 
-	iRegionMask = NULL;
-
-	if ((RegionPointsi == NULL && RegionPointsf == NULL) || PointNum == 0)
+	if ((State->RegionPointsi == NULL && State->RegionPointsf == NULL) || State->PointNum == 0)
 		return NULL;
 
-	if (RegionPointsf) {
-		RegionPointsi = (ILpointi*)ialloc(context, sizeof(ILpointi) * PointNum);
-		if (RegionPointsi == NULL)
+	if (State->RegionPointsf) {
+		State->RegionPointsi = (ILpointi*)ialloc(context, sizeof(ILpointi) * State->PointNum);
+		if (State->RegionPointsi == NULL)
 			goto error;
 	}
 
-	for (i = 0; i < PointNum; i++) {
-		if (RegionPointsf) {
-			RegionPointsi[i].x = (ILuint)(iluCurImage->Width * RegionPointsf[i].x);
-			RegionPointsi[i].y = (ILuint)(iluCurImage->Height * RegionPointsf[i].y);
+	for (i = 0; i < State->PointNum; i++) {
+		if (State->RegionPointsf) {
+			State->RegionPointsi[i].x = (ILuint)(iluCurImage->Width * State->RegionPointsf[i].x);
+			State->RegionPointsi[i].y = (ILuint)(iluCurImage->Height * State->RegionPointsf[i].y);
 		}
-		if (RegionPointsi[i].x >= (ILint)iluCurImage->Width || RegionPointsi[i].y >= (ILint)iluCurImage->Height)
+		if (State->RegionPointsi[i].x >= (ILint)iluCurImage->Width || State->RegionPointsi[i].y >= (ILint)iluCurImage->Height)
 			goto error;
 	}
 
@@ -258,47 +263,49 @@ ILubyte *iScanFill(ILcontext* context)
 		edges[i] = (Edge*)ialloc(context, sizeof(Edge));
 		edges[i]->next = NULL;
 	}
-	BuildEdgeList(context, PointNum, RegionPointsi, edges);
+	BuildEdgeList(context, State->PointNum, State->RegionPointsi, edges);
 	active = (Edge*)ialloc(context, sizeof(Edge));
 	active->next = NULL;
 
 	for (scan = 0; scan < iluCurImage->Height; scan++) {
 		BuildActiveList(scan, active, edges);
 		if (active->next) {
-			FillScan(scan, active);
-			UpdateActiveList(scan, active);
+			FillScan(scan, active, iRegionMask, iluCurImage->Width);
+			UpdateActiveList(context, scan, active);
 			ResortActiveList(active);
 		}
 	}
 
-	// Free edge records that have been allocated.
-	/*for (i = 0; i < iluCurImage->Height; i++) {
-		while (edges[i]) {
-			temp = edges[i]->next;
-			ifree(edges[i]);
-			edges[i] = temp;
-		}
-	}*/
+	// Free edge records that have been allocated.  The edges hanging off
+	//  edges[i] were moved to the active list, which still holds the ones
+	//  that reach past the last scanline.
+	for (i = 0; i < iluCurImage->Height; i++)
+		ifree(context, edges[i]);
+	while (active) {
+		temp = active->next;
+		ifree(context, active);
+		active = temp;
+	}
 
-	ifree(edges);
+	ifree(context, edges);
 
-	if (RegionPointsf) {
-		ifree(RegionPointsi);
-		RegionPointsi = NULL;
+	if (State->RegionPointsf) {
+		ifree(context, State->RegionPointsi);
+		State->RegionPointsi = NULL;
 	}
 
 	return iRegionMask;
 
 error:
-	if (RegionPointsf) {
-		ifree(RegionPointsi);
-		RegionPointsi = NULL;
+	if (State->RegionPointsf) {
+		ifree(context, State->RegionPointsi);
+		State->RegionPointsi = NULL;
 	}
 
 	// Free edge records that have been allocated.
 
-	ifree(edges);
-	ifree(iRegionMask);
+	ifree(context, edges);
+	ifree(context, iRegionMask);
 	return NULL;
 }
 
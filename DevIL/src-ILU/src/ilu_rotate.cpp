@@ -20,7 +20,7 @@ ILboolean ILAPIENTRY iluRotate(ILcontext* context, ILfloat Angle)
 	ILimage	*Temp, *Temp1, *CurImage = NULL;
 	ILenum	PalType = 0;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -35,9 +35,9 @@ ILboolean ILAPIENTRY iluRotate(ILcontext* context, ILfloat Angle)
 	Temp = iluRotate_(context, iluCurImage, Angle);
 	if (Temp != NULL) {
 		if (PalType != 0) {
-			ilCloseImage(iluCurImage);
+			ilCloseImage(context, iluCurImage);
 			Temp1 = iConvertImage(context, Temp, IL_COLOUR_INDEX, IL_UNSIGNED_BYTE);
-			ilCloseImage(Temp);
+			ilCloseImage(context, Temp);
 			Temp = Temp1;
 			ilSetCurImage(context, CurImage);
 		}
@@ -48,14 +48,14 @@ ILboolean ILAPIENTRY iluRotate(ILcontext* context, ILfloat Angle)
 			iluCurImage->Pal.PalType = Temp->Pal.PalType;
 			iluCurImage->Pal.Palette = (ILubyte*)ialloc(context, Temp->Pal.PalSize);
 			if (iluCurImage->Pal.Palette == NULL) {
-				ilCloseImage(Temp);
+				ilCloseImage(context, Temp);
 				return IL_FALSE;
 			}
 			memcpy(iluCurImage->Pal.Palette, Temp->Pal.Palette, Temp->Pal.PalSize);
 		}
 
 		iluCurImage->Origin = Temp->Origin;
-		ilCloseImage(Temp);
+		ilCloseImage(context, Temp);
 		return IL_TRUE;
 	}
 	return IL_FALSE;
@@ -68,13 +68,13 @@ ILboolean ILAPIENTRY iluRotate3D(ILcontext* context, ILfloat x, ILfloat y, ILflo
 
 // return IL_FALSE;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	Temp = iluRotate3D_(iluCurImage, x, y, z, Angle);
 	if (Temp != NULL) {
 		ilTexImage(context, Temp->Width, Temp->Height, Temp->Depth, Temp->Bpp, Temp->Format, Temp->Type, Temp->Data);
 		iluCurImage->Origin = Temp->Origin;
 		ilSetPal(context, &Temp->Pal);
-		ilCloseImage(Temp);
+		ilCloseImage(context, Temp);
 		return IL_TRUE;
 	}
 	return IL_FALSE;
@@ -120,23 +120,23 @@ ILAPI ILimage* ILAPIENTRY iluRotate_(ILcontext* context, ILimage *Image, ILfloat
 	if (Rotated == NULL)
 		return NULL;
 	if (ilCopyImageAttr(context, Rotated, Image) == IL_FALSE) {
-		ilCloseImage(Rotated);
+		ilCloseImage(context, Rotated);
 		return NULL;
 	}
 
 	if (ilResizeImage(context, Rotated, (ILuint)ceil(fabs(MaxX) - MinX), (ILuint)ceil(fabs(MaxY) - MinY), 1, Image->Bpp, Image->Bpc) == IL_FALSE) {
-		ilCloseImage(Rotated);
+		ilCloseImage(context, Rotated);
 		return IL_FALSE;
 	}
 
 	ilClearImage_(context, Rotated);
 
-	ShortPtr = (ILushort*)iluCurImage->Data;
-	IntPtr = (ILuint*)iluCurImage->Data;
-	DblPtr = (ILdouble*)iluCurImage->Data;
+	ShortPtr = (ILushort*)Image->Data;
+	IntPtr = (ILuint*)Image->Data;
+	DblPtr = (ILdouble*)Image->Data;
 
 	//if (iluFilter == ILU_NEAREST) {
-	switch (iluCurImage->Bpc)
+	switch (Image->Bpc)
 	{
 		case 1:  // Byte-based (most images)
 			if (Angle == 90.0) {
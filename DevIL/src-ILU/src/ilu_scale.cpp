@@ -23,7 +23,7 @@ ILboolean ILAPIENTRY iluEnlargeImage(ILcontext* context, ILfloat XDim, ILfloat Y
 		return IL_FALSE;
 	}
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 
 	return iluScale(context, (ILuint)(iluCurImage->Width * XDim), (ILuint)(iluCurImage->Height * YDim), (ILuint)(iluCurImage->Depth * ZDim));
 }
@@ -39,7 +39,7 @@ ILboolean ILAPIENTRY iluScale(ILcontext* context, ILuint Width, ILuint Height, I
 	ILenum		PalType;
 	ILenum		Origin;
 
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -55,7 +55,7 @@ ILboolean ILAPIENTRY iluScale(ILcontext* context, ILuint Width, ILuint Height, I
 
 	if ((iluCurImage->Width<Width) || (iluCurImage->Height<Height)) // only do special scale if there is some zoom?
 	{
-		switch (iluFilter)
+		switch (iluGetState(context)->iluFilter)
 		{
 			case ILU_SCALE_BOX:
 			case ILU_SCALE_TRIANGLE:
@@ -84,11 +84,11 @@ ILboolean ILAPIENTRY iluScale(ILcontext* context, ILuint Width, ILuint Height, I
 					Temp = iluScale_(context, iluCurImage, Width, iluCurImage->Height, iluCurImage->Depth);
 					if (Temp != NULL) {
 						if (!ilTexImage(context, Temp->Width, Temp->Height, Temp->Depth, Temp->Bpp, Temp->Format, Temp->Type, Temp->Data)) {
-							ilCloseImage(Temp);
+							ilCloseImage(context, Temp);
 							return IL_FALSE;
 						}
 						iluCurImage->Origin = Origin;
-						ilCloseImage(Temp);
+						ilCloseImage(context, Temp);
 					}
 				}
 				else if (iluCurImage->Height > Height) // shrink height first
@@ -97,15 +97,15 @@ ILboolean ILAPIENTRY iluScale(ILcontext* context, ILuint Width, ILuint Height, I
 					Temp = iluScale_(context, iluCurImage, iluCurImage->Width, Height, iluCurImage->Depth);
 					if (Temp != NULL) {
 						if (!ilTexImage(context, Temp->Width, Temp->Height, Temp->Depth, Temp->Bpp, Temp->Format, Temp->Type, Temp->Data)) {
-							ilCloseImage(Temp);
+							ilCloseImage(context, Temp);
 							return IL_FALSE;
 						}
 						iluCurImage->Origin = Origin;
-						ilCloseImage(Temp);
+						ilCloseImage(context, Temp);
 					}
 				}
 
-				return (ILboolean)iluScaleAdvanced(context, Width, Height, iluFilter);
+				return (ILboolean)iluScaleAdvanced(context, Width, Height, iluGetState(context)->iluFilter);
 		}
 	}
 
@@ -116,11 +116,11 @@ ILboolean ILAPIENTRY iluScale(ILcontext* context, ILuint Width, ILuint Height, I
 	Temp = iluScale_(context, iluCurImage, Width, Height, Depth);
 	if (Temp != NULL) {
 		if (!ilTexImage(context, Temp->Width, Temp->Height, Temp->Depth, Temp->Bpp, Temp->Format, Temp->Type, Temp->Data)) {
-			ilCloseImage(Temp);
+			ilCloseImage(context, Temp);
 			return IL_FALSE;
 		}
 		iluCurImage->Origin = Origin;
-		ilCloseImage(Temp);
+		ilCloseImage(context, Temp);
 		if (UsePal) {
 			if (!ilConvertImage(context, IL_COLOUR_INDEX, IL_UNSIGNED_BYTE))
 				return IL_FALSE;
@@ -142,7 +142,7 @@ ILAPI ILimage* ILAPIENTRY iluScale_(ILcontext* context, ILimage *Image, ILuint W
 	if (Format == IL_COLOUR_INDEX) {
 		ilSetCurImage(context, Image);
 		PalType = Image->Pal.PalType;
-		ToScale = iConvertImage(context, iluCurImage, ilGetPalBaseType(Image->Pal.PalType), iluCurImage->Type);
+		ToScale = iConvertImage(context, Image, ilGetPalBaseType(Image->Pal.PalType), Image->Type);
 	}
 	else {
 		ToScale = Image;
@@ -151,16 +151,16 @@ ILAPI ILimage* ILAPIENTRY iluScale_(ILcontext* context, ILimage *Image, ILuint W
 	// So we don't replicate this 3 times (one in each iluScalexD_() function.
 	Scaled = (ILimage*)icalloc(context, 1, sizeof(ILimage));
 	if (ilCopyImageAttr(context, Scaled, ToScale) == IL_FALSE) {
-		ilCloseImage(Scaled);
+		ilCloseImage(context, Scaled);
 		if (ToScale != Image)
-			ilCloseImage(ToScale);
+			ilCloseImage(context, ToScale);
 		ilSetCurImage(context, CurImage);
 		return NULL;
 	}
 	if (ilResizeImage(context, Scaled, Width, Height, Depth, ToScale->Bpp, ToScale->Bpc) == IL_FALSE) {
-		ilCloseImage(Scaled);
+		ilCloseImage(context, Scaled);
 		if (ToScale != Image)
-			ilCloseImage(ToScale);
+			ilCloseImage(context, ToScale);
 		ilSetCurImage(context, CurImage);
 		return NULL;
 	}
@@ -168,6 +168,7 @@ ILAPI ILimage* ILAPIENTRY iluScale_(ILcontext* context, ILimage *Image, ILuint W
 	ILUcontext* iluContext = new ILUcontext();
 
 	iluContext->ilContext = context;
+	iluContext->Filter = iluGetState(context)->iluFilter;
 	
 	if (Height <= 1 && Image->Height <= 1) {
 		iluScale1D_(iluContext, ToScale, Scaled, Width);
@@ -185,7 +186,7 @@ ILAPI ILimage* ILAPIENTRY iluScale_(ILcontext* context, ILimage *Image, ILuint W
 		//ilSetCurImage(Scaled);
 		//ilConvertImage(IL_COLOUR_INDEX);
 		ilSetCurImage(context, CurImage);
-		ilCloseImage(ToScale);
+		ilCloseImage(context, ToScale);
 	}
 
 	return Scaled;
@@ -211,7 +212,7 @@ ILimage *iluScale1D_(ILUcontext* context, ILimage *Image, ILimage *Scaled, ILuin
 	IntPtr = (ILuint*)Image->Data;
 	SIntPtr = (ILuint*)Scaled->Data;
 
-	if (iluFilter == ILU_NEAREST) {
+	if (context->Filter == ILU_NEAREST) {
 		switch (Image->Bpc)
 		{
 			case 1:
@@ -30,9 +30,9 @@ ILimage *iluScale2D_(ILUcontext* context, ILimage *Image, ILimage *Scaled, ILuin
 	context->ScaleX = (ILfloat)Width / Image->Width;
 	context->ScaleY = (ILfloat)Height / Image->Height;
 
-	if (iluFilter == ILU_NEAREST)
+	if (context->Filter == ILU_NEAREST)
 		return iluScale2DNear_(context, Image, Scaled, Width, Height);
-	else if (iluFilter == ILU_LINEAR)
+	else if (context->Filter == ILU_LINEAR)
 		return iluScale2DLinear_(context, Image, Scaled, Width, Height);
 	// iluFilter == ILU_BILINEAR
 	return iluScale2DBilinear_(context, Image, Scaled, Width, Height);
@@ -299,13 +299,13 @@ double fwidth;				/* filter width (support) */
 				(Pixel)CLAMP(weight, BLACK_PIXEL, WHITE_PIXEL));
 		}
 	}
-	ifree(raster);
+	ifree(context, raster);
 
 	/* free the memory allocated for horizontal filter weights */
 	for(i = 0; i < tmp->xsize; ++i) {
-		ifree(contrib[i].p);
+		ifree(context, contrib[i].p);
 	}
-	ifree(contrib);
+	ifree(context, contrib);
 
 	/* pre-calculate filter contributions for a column */
 	contrib = (CLIST*)icalloc(dst->ysize, sizeof(CLIST));
@@ -372,13 +372,13 @@ double fwidth;				/* filter width (support) */
 				(Pixel)CLAMP(weight, BLACK_PIXEL, WHITE_PIXEL));
 		}
 	}
-	ifree(raster);
+	ifree(context, raster);
 
 	/* free the memory allocated for vertical filter weights */
 	for(i = 0; i < dst->ysize; ++i) {
-		ifree(contrib[i].p);
+		ifree(context, contrib[i].p);
 	}
-	ifree(contrib);
+	ifree(context, contrib);
 
 	free_image(tmp);
 }
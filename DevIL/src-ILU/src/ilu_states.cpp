@@ -45,7 +45,7 @@ void ILAPIENTRY iluGetIntegerv(ILcontext* context, ILenum Mode, ILint *Param)
 			break;
 
 		case ILU_FILTER:
-			*Param = iluFilter;
+			*Param = iluGetState(context)->iluFilter;
 			break;
 
 		default:
@@ -64,8 +64,28 @@ ILint ILAPIENTRY iluGetInteger(ILcontext* context, ILenum Mode)
 }
 
 
-ILenum iluFilter = ILU_NEAREST;
-ILenum iluPlacement = ILU_CENTER;
+static void iluFreeState(ILcontext* context)
+{
+	ILcontext::IluImpl *State = context->iluImpl;
+
+	ifree(context, State->RegionPointsi);
+	ifree(context, State->RegionPointsf);
+	delete State;
+	context->iluImpl = NULL;
+	context->iluFree = NULL;
+	return;
+}
+
+
+ILcontext::IluImpl *iluGetState(ILcontext* context)
+{
+	if (context->iluImpl == NULL) {
+		context->iluImpl = new ILcontext::IluImpl();
+		context->iluFree = iluFreeState;
+	}
+	return context->iluImpl;
+}
+
 
 void ILAPIENTRY iluImageParameter(ILcontext* context, ILenum PName, ILenum Param)
 {
@@ -83,7 +103,7 @@ void ILAPIENTRY iluImageParameter(ILcontext* context, ILenum PName, ILenum Param
 				case ILU_SCALE_BSPLINE:
 				case ILU_SCALE_LANCZOS3:
 				case ILU_SCALE_MITCHELL:
-					iluFilter = Param;
+					iluGetState(context)->iluFilter = Param;
 					break;
 				default:
 					ilSetError(context, ILU_INVALID_ENUM);
@@ -99,7 +119,7 @@ void ILAPIENTRY iluImageParameter(ILcontext* context, ILenum PName, ILenum Param
 				case ILU_UPPER_LEFT:
 				case ILU_UPPER_RIGHT:
 				case ILU_CENTER:
-					iluPlacement = Param;
+					iluGetState(context)->iluPlacement = Param;
 					break;
 				default:
 					ilSetError(context, ILU_INVALID_ENUM);
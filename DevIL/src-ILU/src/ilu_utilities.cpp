@@ -33,7 +33,7 @@ ILuint ILAPIENTRY iluGenImage(ILcontext* context)
 //! Retrieves information about the current bound image.
 void ILAPIENTRY iluGetImageInfo(ILcontext* context, ILinfo *Info)
 {
-	iluCurImage = ilGetCurImage(context);
+	ILimage *iluCurImage = ilGetCurImage(context);
 	if (iluCurImage == NULL || Info == NULL) {
 		ilSetError(context, ILU_ILLEGAL_OPERATION);
 		return;
@@ -45,9 +45,7 @@
 
 #include <stdlib.h>
 
-extern ILimage *ilutCurImage;
-
-void	ilutDefaultStates(void);
+void	ilutDefaultStates(ILcontext* context);
 
 
 #ifdef _UNICODE
@@ -21,8 +21,6 @@ ILboolean ilutAble(ILcontext* context, ILenum Mode, ILboolean Flag);
 
 #define ILUT_ATTRIB_STACK_MAX 32
 
-ILuint ilutCurrentPos = 0;  // Which position on the stack
-
 //
 // Various states
 //
@@ -51,7 +49,20 @@ typedef struct ILUT_STATES
 
 } ILUT_STATES;
 
-ILUT_STATES ilutStates[ILUT_ATTRIB_STACK_MAX];
+// ILUT state of a single context, created the first time it is needed
+//  and freed together with the context.
+class ILcontext::IlutImpl
+{
+public:
+	ILuint		ilutCurrentPos = 0;  // Which position on the stack
+	ILUT_STATES	ilutStates[ILUT_ATTRIB_STACK_MAX];
+
+	// What the OpenGL implementation supports, found by ilutGLInit
+	ILboolean	HasCubemapHardware = IL_FALSE;
+	ILboolean	HasNonPowerOfTwoHardware = IL_FALSE;
+};
+
+ILcontext::IlutImpl *ilutGetState(ILcontext* context);
 
 
 #endif//STATES_H
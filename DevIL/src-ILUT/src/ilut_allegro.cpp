@@ -27,7 +27,7 @@ BITMAP* ILAPIENTRY ilutConvertToAlleg(PALETTE Pal)
 	ILimage *TempImage;
 	ILuint i = 0, j = 0;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
@@ -73,7 +73,7 @@ BITMAP* ILAPIENTRY ilutConvertToAlleg(PALETTE Pal)
 			Pal[j].filler = 255;
 		}
 
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 		ilSetCurImage(ilutCurImage);
 	}
 
@@ -104,7 +104,7 @@ BITMAP* ILAPIENTRY ilutAllegLoadImage(ILstring FileName)
 // Unfinished
 ILboolean ILAPIENTRY ilutAllegFromBitmap(BITMAP *Bitmap)
 {
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -197,8 +197,9 @@ IDirect3DTexture8* ILAPIENTRY ilutD3D8Texture(IDirect3DDevice8 *Device)
 	ILenum	DXTCFormat;
 	ILuint	Size;
 	ILubyte	*Buffer;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
-	Image = ilutCurImage = ilGetCurImage(context);
+	Image = ilutCurImage;
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return NULL;
@@ -231,7 +232,7 @@ IDirect3DTexture8* ILAPIENTRY ilutD3D8Texture(IDirect3DDevice8 *Device)
 					return NULL;
 				Size = ilGetDXTCData(context, Buffer, Size, DXTCFormat);
 				if (Size == 0) {
-					ifree(Buffer);
+					ifree(context, Buffer);
 					return NULL;
 				}
 
@@ -239,15 +240,15 @@ IDirect3DTexture8* ILAPIENTRY ilutD3D8Texture(IDirect3DDevice8 *Device)
 				if (FAILED(IDirect3DDevice8_CreateTexture(Device, ilutCurImage->Width,
 					ilutCurImage->Height, ilutGetInteger(ILUT_D3D_MIPLEVELS), 0, Format,
 					(D3DPOOL)ilutGetInteger(ILUT_D3D_POOL), &Texture))) {
-						ifree(Buffer);
+						ifree(context, Buffer);
 						return NULL;
 				}
 				if (FAILED(IDirect3DTexture8_LockRect(Texture, 0, &Rect, NULL, 0))) {
-					ifree(Buffer);
+					ifree(context, Buffer);
 					return NULL;
 				}
 				memcpy(Rect.pBits, Buffer, Size);
-				ifree(Buffer);
+				ifree(context, Buffer);
 				goto success;
 			}
 		}
@@ -256,13 +257,13 @@ IDirect3DTexture8* ILAPIENTRY ilutD3D8Texture(IDirect3DDevice8 *Device)
 	Image = MakeD3D8Compliant(Device, &Format);
 	if (Image == NULL) {
 		if (Image != ilutCurImage)
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 		return NULL;
 	}
 	if (FAILED(IDirect3DDevice8_CreateTexture(Device, Image->Width, Image->Height,
 		ilutGetInteger(ILUT_D3D_MIPLEVELS), 0, Format, (D3DPOOL)ilutGetInteger(ILUT_D3D_POOL), &Texture))) {
 		if (Image != ilutCurImage)
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 		return NULL;
 	}
 	if (FAILED(IDirect3DTexture8_LockRect(Texture, 0, &Rect, NULL, 0)))
@@ -276,7 +277,7 @@ success:
 	iD3D8CreateMipmaps(Texture, Image);
 
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 
 	return Texture;
 }
@@ -289,7 +290,7 @@ IDirect3DVolumeTexture8* ILAPIENTRY ilutD3D8VolumeTexture(IDirect3DDevice8 *Devi
 	D3DFORMAT		Format;
 	ILimage			*Image;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return NULL;
@@ -314,7 +315,7 @@ IDirect3DVolumeTexture8* ILAPIENTRY ilutD3D8VolumeTexture(IDirect3DDevice8 *Devi
 	// We don't want to have mipmaps for such a large image.
 
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 
 	return Texture;
 }
@@ -323,6 +324,7 @@ IDirect3DVolumeTexture8* ILAPIENTRY ilutD3D8VolumeTexture(IDirect3DDevice8 *Devi
 ILimage *MakeD3D8Compliant(IDirect3DDevice8 *Device, D3DFORMAT *DestFormat)
 {
 	ILimage	*Converted, *Scaled, *CurImage;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 	*DestFormat = D3DFMT_A8R8G8B8;
 
@@ -351,7 +353,7 @@ ILimage *MakeD3D8Compliant(IDirect3DDevice8 *Device, D3DFORMAT *DestFormat)
 			Scaled = iluScale_(context, Converted, ilNextPower2(ilutCurImage->Width),
 						ilNextPower2(ilutCurImage->Height), ilNextPower2(ilutCurImage->Depth));
 			if (Converted != ilutCurImage) {
-				ilCloseImage(Converted);
+				ilCloseImage(context, Converted);
 			}
 			if (Scaled == NULL) {
 				return NULL;
@@ -378,7 +380,7 @@ ILboolean iD3D8CreateMipmaps(ILcontext* context, IDirect3DTexture8 *Texture, ILi
 	MipImage = ilCopyImage_(contextm CurImage);
 	ilSetCurImage(MipImage);
 	if (!iluBuildMipmaps()) {
-		ilCloseImage(MipImage);
+		ilCloseImage(context, MipImage);
 		ilSetCurImage(CurImage);
 		return IL_FALSE;
 	}
@@ -405,7 +407,7 @@ ILboolean iD3D8CreateMipmaps(ILcontext* context, IDirect3DTexture8 *Texture, ILi
 		Temp = Temp->Next;
 	}
 
-	ilCloseImage(MipImage);
+	ilCloseImage(context, MipImage);
 
 	return IL_TRUE;
 }
@@ -436,6 +438,7 @@ ILAPI ILboolean ILAPIENTRY ilutD3D8LoadSurface(IDirect3DDevice8 *Device, IDirect
 	ILubyte				*Image, *ImageAux, *Data;
 	ILuint				y, x;
 	ILushort			dwColor;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 	IDirect3DSurface8_GetDesc(Surface, &d3dsd);
 
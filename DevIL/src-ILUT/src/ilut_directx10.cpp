@@ -184,8 +184,9 @@ ID3D10Texture2D* ILAPIENTRY ilutD3D10Texture(ID3D10Device *Device)
 	ID3D10Texture2D *Texture;
 	DXGI_FORMAT Format;
 	ILimage	*Image;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
-	Image = ilutCurImage = ilGetCurImage(context);
+	Image = ilutCurImage;
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return NULL;
@@ -197,7 +198,7 @@ ID3D10Texture2D* ILAPIENTRY ilutD3D10Texture(ID3D10Device *Device)
 	Image = MakeD3D10Compliant(Device, &Format);
 	if (Image == NULL) {
 		if (Image != ilutCurImage)
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 		return NULL;
 	}
 
@@ -209,7 +210,7 @@ ID3D10Texture2D* ILAPIENTRY ilutD3D10Texture(ID3D10Device *Device)
 //success:
 
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 
 	return Texture;
 }
@@ -220,6 +221,7 @@ ILimage *MakeD3D10Compliant(ID3D10Device *Device, DXGI_FORMAT *DestFormat)
 	ILimage	*Converted, *Scaled, *CurImage;
 	ILuint nConversionType, ilutFormat;
 	ILboolean bForceIntegerFormat = ilutGetBoolean(ILUT_FORCE_INTEGER_FORMAT);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 	Device;
 	ilutFormat = ilutCurImage->Format;
@@ -287,7 +289,7 @@ ILimage *MakeD3D10Compliant(ID3D10Device *Device, DXGI_FORMAT *DestFormat)
 			Scaled = iluScale_(context, Converted, ilNextPower2(ilutCurImage->Width),
 						ilNextPower2(ilutCurImage->Height), 1);  //@TODO: 1 should be ilNextPower2(ilutCurImage->Depth)
 			if (Converted != ilutCurImage) {
-				ilCloseImage(Converted);
+				ilCloseImage(context, Converted);
 			}
 			if (Scaled == NULL) {
 				return NULL;
@@ -170,7 +170,7 @@ D3DCUBEMAP_FACES iToD3D9Cube(ILuint cube)
     int i;
     Texture=NULL;
     Image=NULL;
-    ilutCurImage = ilGetCurImage(context);
+    ILimage *ilutCurImage = ilGetCurImage(context);
     if (ilutCurImage == NULL) {
     	ilSetError(context, ILUT_ILLEGAL_OPERATION);
         return NULL;
@@ -182,7 +182,7 @@ D3DCUBEMAP_FACES iToD3D9Cube(ILuint cube)
 	Image = MakeD3D9Compliant(Device, &Format);
 	if (Image == NULL) {
 		if (Image != ilutCurImage)
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 		return NULL;
 	}
 
@@ -218,7 +218,7 @@ D3DCUBEMAP_FACES iToD3D9Cube(ILuint cube)
 
        	// We don't want to have mipmaps for such a large image.
 		//if (Image != ilutCurImage)
-	 //      	ilCloseImage(Image);
+	 //      	ilCloseImage(context, Image);
 
        	return Texture;
 }
@@ -377,8 +377,9 @@ IDirect3DTexture9* ILAPIENTRY ilutD3D9Texture(IDirect3DDevice9 *Device)
 	ILenum	DXTCFormat;
 	ILuint	Size;
 	ILubyte	*Buffer;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
-	Image = ilutCurImage = ilGetCurImage(context);
+	Image = ilutCurImage;
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return NULL;
@@ -426,7 +427,7 @@ IDirect3DTexture9* ILAPIENTRY ilutD3D9Texture(IDirect3DDevice9 *Device)
 Image = MakeD3D9Compliant(Device, &Format);
 			if (Image == NULL) {
 				if (Image != ilutCurImage)
-					ilCloseImage(Image);
+					ilCloseImage(context, Image);
 				return NULL;
 			}
 */
@@ -438,7 +439,7 @@ Image = MakeD3D9Compliant(Device, &Format);
 					return NULL;
 				Size = ilGetDXTCData(context, Buffer, Size, DXTCFormat);
 				if (Size == 0) {
-					ifree(Buffer);
+					ifree(context, Buffer);
 					return NULL;
 				}
 
@@ -473,7 +474,7 @@ Image = MakeD3D9Compliant(Device, &Format);
 	Image = MakeD3D9Compliant(Device, &Format);
 	if (Image == NULL) {
 		if (Image != ilutCurImage)
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 		return NULL;
 	}
 
@@ -499,12 +500,12 @@ Image = MakeD3D9Compliant(Device, &Format);
 		IDirect3DTexture9_Release(SysTex);
 	}
 //	if (Image != ilutCurImage)
-//		ilCloseImage(Image);
+//		ilCloseImage(context, Image);
 
 success:
 
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 
 	return Texture;
 }
@@ -517,7 +518,7 @@ IDirect3DVolumeTexture9* ILAPIENTRY ilutD3D9VolumeTexture(IDirect3DDevice9 *Devi
 	D3DFORMAT		Format;
 	ILimage			*Image;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return NULL;
@@ -542,7 +543,7 @@ IDirect3DVolumeTexture9* ILAPIENTRY ilutD3D9VolumeTexture(IDirect3DDevice9 *Devi
 	// We don't want to have mipmaps for such a large image.
 
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 
 	return Texture;
 }
@@ -555,6 +556,7 @@ ILimage *MakeD3D9Compliant(IDirect3DDevice9 *Device, D3DFORMAT *DestFormat)
 	ILimage	*Converted, *Scaled, *CurImage;
 	ILuint nConversionType, ilutFormat;
 	ILboolean bForceIntegerFormat = ilutGetBoolean(ILUT_FORCE_INTEGER_FORMAT);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 	Device;
 	ilutFormat = ilutCurImage->Format;
@@ -649,7 +651,7 @@ ILimage *MakeD3D9Compliant(IDirect3DDevice9 *Device, D3DFORMAT *DestFormat)
 			Scaled = iluScale_(context, Converted, ilNextPower2(ilutCurImage->Width),
 						ilNextPower2(ilutCurImage->Height), ilNextPower2(ilutCurImage->Depth));
 			if (Converted != ilutCurImage) {
-				ilCloseImage(Converted);
+				ilCloseImage(context, Converted);
 			}
 			if (Scaled == NULL) {
 				return NULL;
@@ -686,7 +688,7 @@ ILboolean iD3D9CreateMipmaps(ILcontext* context, IDirect3DTexture9 *Texture, ILi
 		MipImage = ilCopyImage_(context, Image);
 		ilSetCurImage(MipImage);
 		if (!iluBuildMipmaps()) {
-			ilCloseImage(MipImage);
+			ilCloseImage(context, MipImage);
 			ilSetCurImage(CurImage);
 			return IL_FALSE;
 		}
@@ -727,7 +729,7 @@ ILboolean iD3D9CreateMipmaps(ILcontext* context, IDirect3DTexture9 *Texture, ILi
 					}
 					Size = ilGetDXTCData(context, Buffer, Size, DXTCFormat);
 					if (Size == 0) {
-						ifree(Buffer);
+						ifree(context, Buffer);
 						IDirect3DTexture9_UnlockRect(Texture, i);
 						return IL_FALSE;
 					}
@@ -748,7 +750,7 @@ ILboolean iD3D9CreateMipmaps(ILcontext* context, IDirect3DTexture9 *Texture, ILi
 	}
 
 	if (MipImage != Image)
-		ilCloseImage(MipImage);
+		ilCloseImage(context, MipImage);
 	ilSetCurImage(CurImage);
 
 	return IL_TRUE;
@@ -780,6 +782,7 @@ ILAPI ILboolean ILAPIENTRY ilutD3D9LoadSurface(IDirect3DDevice9 *Device, IDirect
 	ILubyte				*Image, *ImageAux, *Data;
 	ILuint				y, x;
 	ILushort			dwColor;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 	IDirect3DSurface9_GetDesc(Surface, &d3dsd);
 
@@ -208,8 +208,9 @@ IDirect3DMobileTexture* ILAPIENTRY ilutD3DmTexture(IDirect3DMobileDevice *Device
 	ILenum	DXTCFormat;
 	ILuint	Size;
 	ILubyte	*Buffer;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
-	Image = ilutCurImage = ilGetCurImage(context);
+	Image = ilutCurImage;
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return NULL;
@@ -242,7 +243,7 @@ IDirect3DMobileTexture* ILAPIENTRY ilutD3DmTexture(IDirect3DMobileDevice *Device
 					return NULL;
 				Size = ilGetDXTCData(context, Buffer, Size, DXTCFormat);
 				if (Size == 0) {
-					ifree(Buffer);
+					ifree(context, Buffer);
 					return NULL;
 				}
 
@@ -250,15 +251,15 @@ IDirect3DMobileTexture* ILAPIENTRY ilutD3DmTexture(IDirect3DMobileDevice *Device
 				if (FAILED(IDirect3DMobileDevice_CreateTexture(Device, ilutCurImage->Width,
 					ilutCurImage->Height, ilutGetInteger(ILUT_D3D_MIPLEVELS), 0, Format,
 					ilutGetInteger(ILUT_D3D_POOL), &Texture))) {
-						ifree(Buffer);
+						ifree(context, Buffer);
 						return NULL;
 				}
 				if (FAILED(IDirect3DMobileTexture_LockRect(Texture, 0, &Rect, NULL, 0))) {
-					ifree(Buffer);
+					ifree(context, Buffer);
 					return NULL;
 				}
 				memcpy(Rect.pBits, Buffer, Size);
-				ifree(Buffer);
+				ifree(context, Buffer);
 				goto success;
 			}
 		}
@@ -267,13 +268,13 @@ IDirect3DMobileTexture* ILAPIENTRY ilutD3DmTexture(IDirect3DMobileDevice *Device
 	Image = MakeD3DmCompliant(Device, &Format);
 	if (Image == NULL) {
 		if (Image != ilutCurImage)
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 		return NULL;
 	}
 	if (FAILED(IDirect3DMobileDevice_CreateTexture(Device, Image->Width, Image->Height,
 		ilutGetInteger(ILUT_D3D_MIPLEVELS), 0, Format, ilutGetInteger(ILUT_D3D_POOL), &Texture))) {
 		if (Image != ilutCurImage)
-			ilCloseImage(Image);
+			ilCloseImage(context, Image);
 		return NULL;
 	}
 	if (FAILED(IDirect3DMobileTexture_LockRect(Texture, 0, &Rect, NULL, 0)))
@@ -287,7 +288,7 @@ success:
 	iD3DmCreateMipmaps(Texture, Image);
 
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 
 	return Texture;
 }
@@ -325,7 +326,7 @@ success:
 //	// We don't want to have mipmaps for such a large image.
 //
 //	if (Image != ilutCurImage)
-//		ilCloseImage(Image);
+//		ilCloseImage(context, Image);
 //
 //	return Texture;
 //}
@@ -334,6 +335,7 @@ success:
 ILimage *MakeD3DmCompliant(IDirect3DMobileDevice *Device, D3DMFORMAT *DestFormat)
 {
 	ILimage	*Converted, *Scaled, *CurImage;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 	*DestFormat = D3DMFMT_A8R8G8B8;
 
@@ -362,7 +364,7 @@ ILimage *MakeD3DmCompliant(IDirect3DMobileDevice *Device, D3DMFORMAT *DestFormat
 			Scaled = iluScale_(context, Converted, ilNextPower2(ilutCurImage->Width),
 						ilNextPower2(ilutCurImage->Height), ilNextPower2(ilutCurImage->Depth));
 			if (Converted != ilutCurImage) {
-				ilCloseImage(Converted);
+				ilCloseImage(context, Converted);
 			}
 			if (Scaled == NULL) {
 				return NULL;
@@ -389,7 +391,7 @@ ILboolean iD3DmCreateMipmaps(ILcontext* context, IDirect3DMobileTexture *Texture
 	MipImage = ilCopyImage_(context, CurImage);
 	ilSetCurImage(MipImage);
 	if (!iluBuildMipmaps()) {
-		ilCloseImage(MipImage);
+		ilCloseImage(context, MipImage);
 		ilSetCurImage(CurImage);
 		return IL_FALSE;
 	}
@@ -416,7 +418,7 @@ ILboolean iD3DmCreateMipmaps(ILcontext* context, IDirect3DMobileTexture *Texture
 		Temp = Temp->Next;
 	}
 
-	ilCloseImage(MipImage);
+	ilCloseImage(context, MipImage);
 
 	return IL_TRUE;
 }
@@ -447,6 +449,7 @@ ILAPI ILboolean ILAPIENTRY ilutD3DmLoadSurface(IDirect3DMobileDevice *Device, ID
 	ILubyte					*Image, *ImageAux, *Data;
 	ILuint					y, x;
 	ILushort				dwColor;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 	IDirect3DMobileSurface_GetDesc(Surface, &d3dsd);
 
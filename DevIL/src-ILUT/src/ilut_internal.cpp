@@ -12,7 +12,3 @@
 
 
 #include "ilut_internal.h"
-
-//#if !defined(__APPLE__)
-	ILimage *ilutCurImage = NULL;
-//#endif
@@ -57,7 +57,7 @@ static void GccMain()
 
 void ILAPIENTRY ilutInit(ILcontext* context)
 {
-	ilutDefaultStates();  // Set states to their defaults
+	ilutDefaultStates(context);  // Set states to their defaults
 	// Can cause crashes if DevIL is not initialized yet
 
 #ifdef ILUT_USE_OPENGL
@@ -12,6 +12,7 @@
 
 
 #include "ilut_opengl.h"
+#include "ilut_states.h"
 
 #ifdef ILUT_USE_OPENGL
 
@@ -82,8 +83,6 @@ void *aglGetProcAddress( const GLubyte *name ) {
 #define ILGL_MAX_3D_TEXTURE_SIZE			0x8073
 
 
-static ILboolean HasCubemapHardware = IL_FALSE;
-static ILboolean HasNonPowerOfTwoHardware = IL_FALSE;
 #if defined(_WIN32) || defined(_WIN64) || defined(linux) || defined(__APPLE__)
 	ILGLTEXIMAGE3DARBPROC			ilGLTexImage3D = NULL;
 	ILGLTEXSUBIMAGE3DARBPROC		ilGLTexSubImage3D = NULL;
@@ -167,9 +166,9 @@ ILboolean ilutGLInit(ILcontext* context)
 	ilutSetInteger(context, ILUT_MAXTEX_DEPTH, MaxTexD);
 
 	if (IsExtensionSupported("GL_ARB_texture_cube_map"))
-		HasCubemapHardware = IL_TRUE;
+		ilutGetState(context)->HasCubemapHardware = IL_TRUE;
 	if (IsExtensionSupported("GL_ARB_texture_non_power_of_two"))
-		HasNonPowerOfTwoHardware = IL_TRUE;
+		ilutGetState(context)->HasNonPowerOfTwoHardware = IL_TRUE;
 	
 	return IL_TRUE;
 }
@@ -187,7 +186,7 @@ GLuint ILAPIENTRY ilutGLBindTexImage(ILcontext* context)
 		return 0;
 
 	if (ilutGetBoolean(context, ILUT_GL_AUTODETECT_TEXTURE_TARGET)) {
-		if (HasCubemapHardware && Image->CubeFlags != 0)
+		if (ilutGetState(context)->HasCubemapHardware && Image->CubeFlags != 0)
 			Target = ILGL_TEXTURE_CUBE_MAP;
 		
 	}
@@ -283,14 +282,14 @@ ILboolean ILAPIENTRY ilutGLTexImage_(ILcontext* context, GLuint Level, GLuint Ta
 				Size = ilGetDXTCData(context, Buffer, Size, DXTCFormat);
 				if (Size == 0) {
 					ilSetCurImage(context, OldImage);
-					ifree(Buffer);
+					ifree(context, Buffer);
 					return IL_FALSE;
 				}
 
 				DXTCFormat = GLGetDXTCNum(DXTCFormat);
 				ilGLCompressed2D(Target, Level, DXTCFormat, Image->Width,
 					Image->Height, 0, Size, Buffer);
-				ifree(Buffer);
+				ifree(context, Buffer);
 				ilSetCurImage(context, OldImage);
 				return IL_TRUE;
 			}
@@ -315,7 +314,7 @@ ILboolean ILAPIENTRY ilutGLTexImage_(ILcontext* context, GLuint Level, GLuint Ta
 			ImageCopy->Data);	
 
 	if (Image != ImageCopy)
-		ilCloseImage(ImageCopy);
+		ilCloseImage(context, ImageCopy);
 
 	return IL_TRUE;
 }
@@ -345,7 +344,7 @@ ILboolean ILAPIENTRY ilutGLTexImage(ILcontext* context, GLuint Level)
 {
 	ILimage *Temp;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 	if (!ilutGetBoolean(context, ILUT_GL_AUTODETECT_TEXTURE_TARGET))
 		return ilutGLTexImage_(context, Level, GL_TEXTURE_2D, ilGetCurImage(context));
@@ -353,7 +352,7 @@ ILboolean ILAPIENTRY ilutGLTexImage(ILcontext* context, GLuint Level)
 		// Autodetect texture target
 
 		// Cubemap
-		if (ilutCurImage->CubeFlags != 0 && HasCubemapHardware) { //bind to cubemap
+		if (ilutCurImage->CubeFlags != 0 && ilutGetState(context)->HasCubemapHardware) { //bind to cubemap
 			Temp = ilutCurImage;
 			while (Temp != NULL && Temp->CubeFlags != 0) {
 				ilutGLTexImage_(context, Level, iToGLCube(Temp->CubeFlags), Temp);
@@ -395,7 +394,7 @@ ILboolean ILAPIENTRY ilutGLBuildMipmaps(ILcontext* context)
 {
 	ILimage	*Image;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -409,7 +408,7 @@ ILboolean ILAPIENTRY ilutGLBuildMipmaps(ILcontext* context)
 						Image->Height, Image->Format, Image->Type, Image->Data);
 
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 	
 	return IL_TRUE;
 }
@@ -426,7 +425,7 @@ ILboolean ILAPIENTRY ilutGLSubTex2D(ILcontext* context, GLuint TexID, ILuint XOf
 	ILimage	*Image;
 	ILint Width, Height;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -455,7 +454,7 @@ ILboolean ILAPIENTRY ilutGLSubTex2D(ILcontext* context, GLuint TexID, ILuint XOf
 			Image->Type, Image->Data);
 
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 
 	return IL_TRUE;
 }
@@ -471,7 +470,7 @@ ILboolean ILAPIENTRY ilutGLSubTex3D(ILcontext* context, GLuint TexID, ILuint XOf
 		return IL_FALSE;
 	}
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -502,7 +501,7 @@ ILboolean ILAPIENTRY ilutGLSubTex3D(ILcontext* context, GLuint TexID, ILuint XOf
 			Image->Format, Image->Type, Image->Data);
 
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);
+		ilCloseImage(context, Image);
 
 	return IL_TRUE;
 }
@@ -515,6 +514,7 @@ ILimage* MakeGLCompliant2D(ILcontext* context, ILimage *Src)
 	ILenum		Filter;
 	ILubyte		*Flipped;
 	ILboolean   need_resize = IL_FALSE;
+	ILboolean	NonPowerOfTwo = ilutGetState(context)->HasNonPowerOfTwoHardware;
 	ILint		MaxTexW, MaxTexH;
 
 	MaxTexW = ilutGetInteger(context, ILUT_MAXTEX_WIDTH);
@@ -537,7 +537,7 @@ ILimage* MakeGLCompliant2D(ILcontext* context, ILimage *Src)
 		Dest->Pal.PalType = IL_PAL_NONE;
 	}
 
-	if (HasNonPowerOfTwoHardware == IL_FALSE && 
+	if (NonPowerOfTwo == IL_FALSE && 
 		  (Src->Width  != ilNextPower2(Src->Width)  ||
 		   Src->Height != ilNextPower2(Src->Height)  )) {
 				need_resize = IL_TRUE;
@@ -558,21 +558,21 @@ ILimage* MakeGLCompliant2D(ILcontext* context, ILimage *Src)
 		Filter = iluGetInteger(context, ILU_FILTER);
 		if (Src->Format == IL_COLOUR_INDEX) {
 			iluImageParameter(context, ILU_FILTER, ILU_NEAREST);
-			Temp = HasNonPowerOfTwoHardware == IL_TRUE ? 
+			Temp = NonPowerOfTwo == IL_TRUE ? 
 				iluScale_(context, Dest, min((ILuint)MaxTexW, Dest->Width), min((ILuint)MaxTexH, Dest->Height), 1)
 			  : iluScale_(context, Dest, min((ILuint)MaxTexW, ilNextPower2(Dest->Width)),
 			  		min((ILuint)MaxTexH, ilNextPower2(Dest->Height)), 1);
 			iluImageParameter(context, ILU_FILTER, Filter);
 		} else {
 			iluImageParameter(context, ILU_FILTER, ILU_BILINEAR);
-			Temp = HasNonPowerOfTwoHardware == IL_TRUE ?
+			Temp = NonPowerOfTwo == IL_TRUE ?
 				iluScale_(context, Dest, min((ILuint)MaxTexW, Dest->Width), min((ILuint)MaxTexH, Dest->Height), 1)
 			 :	iluScale_(context, Dest, min((ILuint)MaxTexW, (ILint)ilNextPower2(Dest->Width)),
 			 		min(MaxTexH, (ILint)ilNextPower2(Dest->Height)), 1);
 			iluImageParameter(context, ILU_FILTER, Filter);
 		}
 
-		ilCloseImage(Dest);
+		ilCloseImage(context, Dest);
 		if (!Temp) {
 			return NULL;
 		}
@@ -581,7 +581,7 @@ ILimage* MakeGLCompliant2D(ILcontext* context, ILimage *Src)
 
 	if (Dest->Origin != IL_ORIGIN_LOWER_LEFT) {
 		Flipped = iGetFlipped(context, Dest);
-		ifree(Dest->Data);
+		ifree(context, Dest->Data);
 		Dest->Data = Flipped;
 		Dest->Origin = IL_ORIGIN_LOWER_LEFT;
 	}
@@ -597,6 +597,7 @@ ILimage* MakeGLCompliant3D(ILcontext* context, ILimage *Src)
 	ILenum		Filter;
 	ILubyte		*Flipped;
 	ILboolean   need_resize = IL_FALSE;
+	ILboolean	NonPowerOfTwo = ilutGetState(context)->HasNonPowerOfTwoHardware;
 	ILint		MaxTexW, MaxTexH, MaxTexD;
 
 	MaxTexW = ilutGetInteger(context, ILUT_MAXTEX_WIDTH);
@@ -620,7 +621,7 @@ ILimage* MakeGLCompliant3D(ILcontext* context, ILimage *Src)
 		Dest->Pal.PalType = IL_PAL_NONE;
 	}
 
-	if (HasNonPowerOfTwoHardware == IL_FALSE && 
+	if (NonPowerOfTwo == IL_FALSE && 
 		  (Src->Width  != ilNextPower2(Src->Width)  ||
 		   Src->Height != ilNextPower2(Src->Height) ||
 		   Src->Depth  != ilNextPower2(Src->Depth) )) {
@@ -642,7 +643,7 @@ ILimage* MakeGLCompliant3D(ILcontext* context, ILimage *Src)
 		Filter = iluGetInteger(context, ILU_FILTER);
 		if (Src->Format == IL_COLOUR_INDEX) {
 			iluImageParameter(context, ILU_FILTER, ILU_NEAREST);
-			Temp = HasNonPowerOfTwoHardware == IL_TRUE ? 
+			Temp = NonPowerOfTwo == IL_TRUE ? 
 				iluScale_(context, Dest, min((ILuint)MaxTexW, Dest->Width), min((ILuint)MaxTexH, Dest->Height), min((ILuint)MaxTexD, Dest->Depth))
 			  : iluScale_(context, Dest, min((ILuint)MaxTexW, ilNextPower2(Dest->Width)),
 			  		min((ILuint)MaxTexH, ilNextPower2(Dest->Height)),
@@ -650,7 +651,7 @@ ILimage* MakeGLCompliant3D(ILcontext* context, ILimage *Src)
 			iluImageParameter(context, ILU_FILTER, Filter);
 		} else {
 			iluImageParameter(context, ILU_FILTER, ILU_BILINEAR);
-			Temp = HasNonPowerOfTwoHardware == IL_TRUE ?
+			Temp = NonPowerOfTwo == IL_TRUE ?
 				iluScale_(context, Dest, min((ILuint)MaxTexW, Dest->Width), min((ILuint)MaxTexH, Dest->Height), min((ILuint)MaxTexD, Dest->Depth))
 			 :	iluScale_(context, Dest, min((ILuint)MaxTexW, (ILint)ilNextPower2(Dest->Width)),
 			 		min(MaxTexH, (ILint)ilNextPower2(Dest->Height)),
@@ -658,7 +659,7 @@ ILimage* MakeGLCompliant3D(ILcontext* context, ILimage *Src)
 			iluImageParameter(context, ILU_FILTER, Filter);
 		}
 
-		ilCloseImage(Dest);
+		ilCloseImage(context, Dest);
 		if (!Temp) {
 			return NULL;
 		}
@@ -667,7 +668,7 @@ ILimage* MakeGLCompliant3D(ILcontext* context, ILimage *Src)
 
 	if (Dest->Origin != IL_ORIGIN_LOWER_LEFT) {
 		Flipped = iGetFlipped(context, Dest);
-		ifree(Dest->Data);
+		ifree(context, Dest->Data);
 		Dest->Data = Flipped;
 		Dest->Origin = IL_ORIGIN_LOWER_LEFT;
 	}
@@ -727,7 +728,7 @@ ILboolean ILAPIENTRY ilutGLScreen(ILcontext* context)
 {
 	ILuint	ViewPort[4];
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -737,7 +738,7 @@ ILboolean ILAPIENTRY ilutGLScreen(ILcontext* context)
 
 	if (!ilTexImage(context, ViewPort[2], ViewPort[3], 1, 3, IL_RGB, IL_UNSIGNED_BYTE, NULL))
 		return IL_FALSE;  // Error already set.
-	ilutCurImage->Origin = IL_ORIGIN_LOWER_LEFT;
+	ilGetCurImage(context)->Origin = IL_ORIGIN_LOWER_LEFT;
 
 	glPixelStorei(GL_PACK_ALIGNMENT, 1);
 	glReadPixels(0, 0, ViewPort[2], ViewPort[3], GL_RGB, GL_UNSIGNED_BYTE, ilutCurImage->Data);
@@ -821,12 +822,12 @@ ILboolean ILAPIENTRY ilutGLSetTex2D(ILcontext* context, GLuint TexID)
 	glGetTexImage(GL_TEXTURE_2D, 0, IL_BGRA, GL_UNSIGNED_BYTE, Data);
 
 	if (!ilTexImage(context, Width, Height, 1, 4, IL_BGRA, IL_UNSIGNED_BYTE, Data)) {
-		ifree(Data);
+		ifree(context, Data);
 		return IL_FALSE;
 	}
-	ilutCurImage->Origin = IL_ORIGIN_LOWER_LEFT;
+	ilGetCurImage(context)->Origin = IL_ORIGIN_LOWER_LEFT;
 
-	ifree(Data);
+	ifree(context, Data);
 	return IL_TRUE;
 }
 
@@ -855,12 +856,12 @@ ILboolean ILAPIENTRY ilutGLSetTex3D(ILcontext* context, GLuint TexID)
 	glGetTexImage(ILGL_TEXTURE_3D, 0, IL_BGRA, GL_UNSIGNED_BYTE, Data);
 
 	if (!ilTexImage(context, Width, Height, Depth, 4, IL_BGRA, IL_UNSIGNED_BYTE, Data)) {
-		ifree(Data);
+		ifree(context, Data);
 		return IL_FALSE;
 	}
-	ilutCurImage->Origin = IL_ORIGIN_LOWER_LEFT;
+	ilGetCurImage(context)->Origin = IL_ORIGIN_LOWER_LEFT;
 
-	ifree(Data);
+	ifree(context, Data);
 	return IL_TRUE;
 }
 
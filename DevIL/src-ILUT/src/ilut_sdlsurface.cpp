@@ -54,8 +54,9 @@ SDL_Surface *ILAPIENTRY ilutConvertToSDLSurface(unsigned int flags)
 	ILuint		i = 0, Pad, BppPal;
 	ILubyte		*Dest, *Data;
 	ILimage		*Image;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
-	Image = ilutCurImage = ilGetCurImage(context);
+	Image = ilutCurImage;
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return NULL;
@@ -159,9 +160,9 @@ SDL_Surface *ILAPIENTRY ilutConvertToSDLSurface(unsigned int flags)
 
 done:
 	if (Data != Image->Data)
-		ifree(Data);  // This is flipped data.
+		ifree(context, Data);  // This is flipped data.
 	if (Image != ilutCurImage)
-		ilCloseImage(Image);  // This is a converted image.
+		ilCloseImage(context, Image);  // This is a converted image.
 	return Bitmap;  // This is NULL if there was an error.
 }
 
@@ -186,7 +187,7 @@ SDL_Surface* ILAPIENTRY ilutSDLSurfaceLoadImage(ILstring FileName)
 // Unfinished
 ILboolean ILAPIENTRY ilutSDLSurfaceFromBitmap(SDL_Surface *Bitmap)
 {
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -23,28 +23,51 @@ ILconst_string _ilutVendor	= IL_TEXT("Abysmal Software");
 ILconst_string _ilutVersion	= IL_TEXT("Developer's Image Library Utility Toolkit (ILUT) 1.8.0");
 
 
+static void ilutFreeState(ILcontext* context)
+{
+	delete context->ilutImpl;
+	context->ilutImpl = NULL;
+	context->ilutFree = NULL;
+	return;
+}
+
+
+ILcontext::IlutImpl *ilutGetState(ILcontext* context)
+{
+	if (context->ilutImpl == NULL) {
+		context->ilutImpl = new ILcontext::IlutImpl();
+		context->ilutFree = ilutFreeState;
+	}
+	return context->ilutImpl;
+}
+
+
 // Set all states to their defaults
-void ilutDefaultStates()
+void ilutDefaultStates(ILcontext* context)
 {
-	ilutStates[ilutCurrentPos].ilutUsePalettes = IL_FALSE;
-	ilutStates[ilutCurrentPos].ilutForceIntegerFormat = IL_FALSE;
-	ilutStates[ilutCurrentPos].ilutOglConv = IL_FALSE;  // IL_TRUE ?
-	ilutStates[ilutCurrentPos].ilutDXTCFormat = 0;
-	ilutStates[ilutCurrentPos].ilutUseS3TC = IL_FALSE;
-	ilutStates[ilutCurrentPos].ilutGenS3TC = IL_FALSE;
-	ilutStates[ilutCurrentPos].ilutAutodetectTextureTarget = IL_FALSE;
-	ilutStates[ilutCurrentPos].MaxTexW = 256;
-	ilutStates[ilutCurrentPos].MaxTexH = 256;
-	ilutStates[ilutCurrentPos].MaxTexD = 1;
-	ilutStates[ilutCurrentPos].D3DMipLevels = 0;
-	ilutStates[ilutCurrentPos].D3DPool = 0;
-	ilutStates[ilutCurrentPos].D3DAlphaKeyColor = -1;
+	ILcontext::IlutImpl *State = ilutGetState(context);
+
+	State->ilutStates[State->ilutCurrentPos].ilutUsePalettes = IL_FALSE;
+	State->ilutStates[State->ilutCurrentPos].ilutForceIntegerFormat = IL_FALSE;
+	State->ilutStates[State->ilutCurrentPos].ilutOglConv = IL_FALSE;  // IL_TRUE ?
+	State->ilutStates[State->ilutCurrentPos].ilutDXTCFormat = 0;
+	State->ilutStates[State->ilutCurrentPos].ilutUseS3TC = IL_FALSE;
+	State->ilutStates[State->ilutCurrentPos].ilutGenS3TC = IL_FALSE;
+	State->ilutStates[State->ilutCurrentPos].ilutAutodetectTextureTarget = IL_FALSE;
+	State->ilutStates[State->ilutCurrentPos].MaxTexW = 256;
+	State->ilutStates[State->ilutCurrentPos].MaxTexH = 256;
+	State->ilutStates[State->ilutCurrentPos].MaxTexD = 1;
+	State->ilutStates[State->ilutCurrentPos].D3DMipLevels = 0;
+	State->ilutStates[State->ilutCurrentPos].D3DPool = 0;
+	State->ilutStates[State->ilutCurrentPos].D3DAlphaKeyColor = -1;
 }
 
 
-void ILAPIENTRY ilutD3D8MipFunc(ILuint NumLevels)
+void ILAPIENTRY ilutD3D8MipFunc(ILcontext* context, ILuint NumLevels)
 {
-	ilutStates[ilutCurrentPos].D3DMipLevels = NumLevels;
+	ILcontext::IlutImpl *State = ilutGetState(context);
+
+	State->ilutStates[State->ilutCurrentPos].D3DMipLevels = NumLevels;
 	return;
 }
 
@@ -80,30 +103,32 @@ ILboolean ILAPIENTRY ilutDisable(ILcontext* context, ILenum Mode)
 
 ILboolean ilutAble(ILcontext* context, ILenum Mode, ILboolean Flag)
 {
+	ILcontext::IlutImpl *State = ilutGetState(context);
+
 	switch (Mode)
 	{
 		case ILUT_PALETTE_MODE:
-			ilutStates[ilutCurrentPos].ilutUsePalettes = Flag;
+			State->ilutStates[State->ilutCurrentPos].ilutUsePalettes = Flag;
 			break;
 
 		case ILUT_FORCE_INTEGER_FORMAT:
-			ilutStates[ilutCurrentPos].ilutForceIntegerFormat = Flag;
+			State->ilutStates[State->ilutCurrentPos].ilutForceIntegerFormat = Flag;
 			break;
 
 		case ILUT_OPENGL_CONV:
-			ilutStates[ilutCurrentPos].ilutOglConv = Flag;
+			State->ilutStates[State->ilutCurrentPos].ilutOglConv = Flag;
 			break;
 
 		case ILUT_GL_USE_S3TC:
-			ilutStates[ilutCurrentPos].ilutUseS3TC = Flag;
+			State->ilutStates[State->ilutCurrentPos].ilutUseS3TC = Flag;
 			break;
 
 		case ILUT_GL_GEN_S3TC:
-			ilutStates[ilutCurrentPos].ilutGenS3TC = Flag;
+			State->ilutStates[State->ilutCurrentPos].ilutGenS3TC = Flag;
 			break;
 
 		case ILUT_GL_AUTODETECT_TEXTURE_TARGET:
-			ilutStates[ilutCurrentPos].ilutAutodetectTextureTarget = Flag;
+			State->ilutStates[State->ilutCurrentPos].ilutAutodetectTextureTarget = Flag;
 			break;
 
 
@@ -118,25 +143,27 @@ ILboolean ilutAble(ILcontext* context, ILenum Mode, ILboolean Flag)
 
 ILboolean ILAPIENTRY ilutIsEnabled(ILcontext* context, ILenum Mode)
 {
+	ILcontext::IlutImpl *State = ilutGetState(context);
+
 	switch (Mode)
 	{
 		case ILUT_PALETTE_MODE:
-			return ilutStates[ilutCurrentPos].ilutUsePalettes;
+			return State->ilutStates[State->ilutCurrentPos].ilutUsePalettes;
 
 		case ILUT_FORCE_INTEGER_FORMAT:
-			return ilutStates[ilutCurrentPos].ilutForceIntegerFormat;
+			return State->ilutStates[State->ilutCurrentPos].ilutForceIntegerFormat;
 
 		case ILUT_OPENGL_CONV:
-			return ilutStates[ilutCurrentPos].ilutOglConv;
+			return State->ilutStates[State->ilutCurrentPos].ilutOglConv;
 
 		case ILUT_GL_USE_S3TC:
-			return ilutStates[ilutCurrentPos].ilutUseS3TC;
+			return State->ilutStates[State->ilutCurrentPos].ilutUseS3TC;
 
 		case ILUT_GL_GEN_S3TC:
-			return ilutStates[ilutCurrentPos].ilutGenS3TC;
+			return State->ilutStates[State->ilutCurrentPos].ilutGenS3TC;
 
 		case ILUT_GL_AUTODETECT_TEXTURE_TARGET:
-			return ilutStates[ilutCurrentPos].ilutAutodetectTextureTarget;
+			return State->ilutStates[State->ilutCurrentPos].ilutAutodetectTextureTarget;
 
 
 		default:
@@ -155,30 +182,32 @@ ILboolean ILAPIENTRY ilutIsDisabled(ILcontext* context, ILenum Mode)
 
 void ILAPIENTRY ilutGetBooleanv(ILcontext* context, ILenum Mode, ILboolean *Param)
 {
+	ILcontext::IlutImpl *State = ilutGetState(context);
+
 	switch (Mode)
 	{
 		case ILUT_PALETTE_MODE:
-			*Param = ilutStates[ilutCurrentPos].ilutUsePalettes;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutUsePalettes;
 			break;
 
 		case ILUT_FORCE_INTEGER_FORMAT:
-			*Param = ilutStates[ilutCurrentPos].ilutForceIntegerFormat;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutForceIntegerFormat;
 			break;
 
 		case ILUT_OPENGL_CONV:
-			*Param = ilutStates[ilutCurrentPos].ilutOglConv;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutOglConv;
 			break;
 
 		case ILUT_GL_USE_S3TC:
-			*Param = ilutStates[ilutCurrentPos].ilutUseS3TC;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutUseS3TC;
 			break;
 
 		case ILUT_GL_GEN_S3TC:
-			*Param = ilutStates[ilutCurrentPos].ilutGenS3TC;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutGenS3TC;
 			break;
 
 		case ILUT_GL_AUTODETECT_TEXTURE_TARGET:
-			*Param = ilutStates[ilutCurrentPos].ilutAutodetectTextureTarget;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutAutodetectTextureTarget;
 			break;
 
 		default:
@@ -198,52 +227,54 @@ ILboolean ILAPIENTRY ilutGetBoolean(ILcontext* context, ILenum Mode)
 
 void ILAPIENTRY ilutGetIntegerv(ILcontext* context, ILenum Mode, ILint *Param)
 {
+	ILcontext::IlutImpl *State = ilutGetState(context);
+
 	switch (Mode)
 	{
 		/*case IL_ORIGIN_MODE:
-			*Param = ilutStates[ilutCurrentPos].ilutOriginMode;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutOriginMode;
 			break;*/
 		case ILUT_MAXTEX_WIDTH:
-			*Param = ilutStates[ilutCurrentPos].MaxTexW;
+			*Param = State->ilutStates[State->ilutCurrentPos].MaxTexW;
 			break;
 		case ILUT_MAXTEX_HEIGHT:
-			*Param = ilutStates[ilutCurrentPos].MaxTexH;
+			*Param = State->ilutStates[State->ilutCurrentPos].MaxTexH;
 			break;
 		case ILUT_MAXTEX_DEPTH:
-			*Param = ilutStates[ilutCurrentPos].MaxTexD;
+			*Param = State->ilutStates[State->ilutCurrentPos].MaxTexD;
 			break;
 		case ILUT_VERSION_NUM:
 			*Param = ILUT_VERSION;
 			break;
 		case ILUT_PALETTE_MODE:
-			*Param = ilutStates[ilutCurrentPos].ilutUsePalettes;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutUsePalettes;
 			break;
 		case ILUT_FORCE_INTEGER_FORMAT:
-			*Param = ilutStates[ilutCurrentPos].ilutForceIntegerFormat;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutForceIntegerFormat;
 			break;
 		case ILUT_OPENGL_CONV:
-			*Param = ilutStates[ilutCurrentPos].ilutOglConv;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutOglConv;
 			break;
 		case ILUT_GL_USE_S3TC:
-			*Param = ilutStates[ilutCurrentPos].ilutUseS3TC;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutUseS3TC;
 			break;
 		case ILUT_GL_GEN_S3TC:
-			*Param = ilutStates[ilutCurrentPos].ilutUseS3TC;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutUseS3TC;
 			break;
 		case ILUT_S3TC_FORMAT:
-			*Param = ilutStates[ilutCurrentPos].ilutDXTCFormat;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutDXTCFormat;
 			break;
 		case ILUT_GL_AUTODETECT_TEXTURE_TARGET:
-			*Param = ilutStates[ilutCurrentPos].ilutAutodetectTextureTarget;
+			*Param = State->ilutStates[State->ilutCurrentPos].ilutAutodetectTextureTarget;
 			break;
 		case ILUT_D3D_MIPLEVELS:
-			*Param = ilutStates[ilutCurrentPos].D3DMipLevels;
+			*Param = State->ilutStates[State->ilutCurrentPos].D3DMipLevels;
 			break;
 		case ILUT_D3D_ALPHA_KEY_COLOR:
-			*Param = ilutStates[ilutCurrentPos].D3DAlphaKeyColor;
+			*Param = State->ilutStates[State->ilutCurrentPos].D3DAlphaKeyColor;
 			break;
 		case ILUT_D3D_POOL:
-			*Param = ilutStates[ilutCurrentPos].D3DPool;
+			*Param = State->ilutStates[State->ilutCurrentPos].D3DPool;
 			break;
 
 		default:
@@ -263,48 +294,50 @@ ILint ILAPIENTRY ilutGetInteger(ILcontext* context, ILenum Mode)
 
 void ILAPIENTRY ilutSetInteger(ILcontext* context, ILenum Mode, ILint Param)
 {
+	ILcontext::IlutImpl *State = ilutGetState(context);
+
 	switch (Mode)
 	{
 		case ILUT_S3TC_FORMAT:
 			if (Param >= IL_DXT1 && Param <= IL_DXT5) {
-				ilutStates[ilutCurrentPos].ilutDXTCFormat = Param;
+				State->ilutStates[State->ilutCurrentPos].ilutDXTCFormat = Param;
 				return;
 			}
 
 //#ifdef ILUT_USE_OPENGL
 		case ILUT_MAXTEX_WIDTH:
 			if (Param >= 1) {
-				ilutStates[ilutCurrentPos].MaxTexW = Param;
+				State->ilutStates[State->ilutCurrentPos].MaxTexW = Param;
 				return;
 			}
 			break;
 		case ILUT_MAXTEX_HEIGHT:
 			if (Param >= 1) {
-				ilutStates[ilutCurrentPos].MaxTexH = Param;
+				State->ilutStates[State->ilutCurrentPos].MaxTexH = Param;
 				return;
 			}
 			break;
 		case ILUT_MAXTEX_DEPTH:
 			if (Param >= 1) {
-				ilutStates[ilutCurrentPos].MaxTexD = Param;
+				State->ilutStates[State->ilutCurrentPos].MaxTexD = Param;
 				return;
 			}
 			break;
 		case ILUT_GL_USE_S3TC:
 			if (Param == IL_TRUE || Param == IL_FALSE) {
-				ilutStates[ilutCurrentPos].ilutUseS3TC = (ILboolean)Param;
+				State->ilutStates[State->ilutCurrentPos].ilutUseS3TC = (ILboolean)Param;
 				return;
 			}
 			break;
 		case ILUT_GL_GEN_S3TC:
 			if (Param == IL_TRUE || Param == IL_FALSE) {
-				ilutStates[ilutCurrentPos].ilutGenS3TC = (ILboolean)Param;
+				State->ilutStates[State->ilutCurrentPos].ilutGenS3TC = (ILboolean)Param;
 				return;
 			}
 			break;
 		case ILUT_GL_AUTODETECT_TEXTURE_TARGET:
 			if (Param == IL_TRUE || Param == IL_FALSE) {
-				ilutStates[ilutCurrentPos].ilutAutodetectTextureTarget = (ILboolean)Param;
+				State->ilutStates[State->ilutCurrentPos].ilutAutodetectTextureTarget = (ILboolean)Param;
 				return;
 			}
 			break;
@@ -313,19 +346,19 @@ void ILAPIENTRY ilutSetInteger(ILcontext* context, ILenum Mode, ILint Param)
 //#ifdef ILUT_USE_DIRECTX8
 		case ILUT_D3D_MIPLEVELS:
 			if (Param >= 0) {
-				ilutStates[ilutCurrentPos].D3DMipLevels = Param;
+				State->ilutStates[State->ilutCurrentPos].D3DMipLevels = Param;
 				return;
 			}
 			break;
 
 		case ILUT_D3D_ALPHA_KEY_COLOR:
-				ilutStates[ilutCurrentPos].D3DAlphaKeyColor = Param;
+				State->ilutStates[State->ilutCurrentPos].D3DAlphaKeyColor = Param;
 				return;
 			break;
 
 		case ILUT_D3D_POOL:
 			if (Param >= 0 && Param <= 2) {
-				ilutStates[ilutCurrentPos].D3DPool = Param;
+				State->ilutStates[State->ilutCurrentPos].D3DPool = Param;
 				return;
 			}
 			break;
@@ -342,25 +375,27 @@ void ILAPIENTRY ilutSetInteger(ILcontext* context, ILenum Mode, ILint Param)
 
 void ILAPIENTRY ilutPushAttrib(ILcontext* context, ILuint Bits)
 {
+	ILcontext::IlutImpl *State = ilutGetState(context);
+
 	// Should we check here to see if ilCurrentPos is negative?
 
-	if (ilutCurrentPos >= ILUT_ATTRIB_STACK_MAX - 1) {
-		ilutCurrentPos = ILUT_ATTRIB_STACK_MAX - 1;
+	if (State->ilutCurrentPos >= ILUT_ATTRIB_STACK_MAX - 1) {
+		State->ilutCurrentPos = ILUT_ATTRIB_STACK_MAX - 1;
 		ilSetError(context, ILUT_STACK_OVERFLOW);
 		return;
 	}
 
-	ilutCurrentPos++;
+	State->ilutCurrentPos++;
 
 	//memcpy(&ilutStates[ilutCurrentPos], &ilutStates[ilutCurrentPos - 1], sizeof(ILUT_STATES));
 
 	if (Bits & ILUT_OPENGL_BIT) {
-		ilutStates[ilutCurrentPos].ilutUsePalettes = ilutStates[ilutCurrentPos-1].ilutUsePalettes;
-		ilutStates[ilutCurrentPos].ilutOglConv = ilutStates[ilutCurrentPos-1].ilutOglConv;
+		State->ilutStates[State->ilutCurrentPos].ilutUsePalettes = State->ilutStates[State->ilutCurrentPos-1].ilutUsePalettes;
+		State->ilutStates[State->ilutCurrentPos].ilutOglConv = State->ilutStates[State->ilutCurrentPos-1].ilutOglConv;
 	}
 	if (Bits & ILUT_D3D_BIT) {
-		ilutStates[ilutCurrentPos].D3DMipLevels = ilutStates[ilutCurrentPos-1].D3DMipLevels;
-		ilutStates[ilutCurrentPos].D3DAlphaKeyColor = ilutStates[ilutCurrentPos-1].D3DAlphaKeyColor;
+		State->ilutStates[State->ilutCurrentPos].D3DMipLevels = State->ilutStates[State->ilutCurrentPos-1].D3DMipLevels;
+		State->ilutStates[State->ilutCurrentPos].D3DAlphaKeyColor = State->ilutStates[State->ilutCurrentPos-1].D3DAlphaKeyColor;
 	}
 
 	return;
@@ -369,14 +404,16 @@ void ILAPIENTRY ilutPushAttrib(ILcontext* context, ILuint Bits)
 
 void ILAPIENTRY ilutPopAttrib(ILcontext* context)
 {
-	if (ilutCurrentPos <= 0) {
-		ilutCurrentPos = 0;
+	ILcontext::IlutImpl *State = ilutGetState(context);
+
+	if (State->ilutCurrentPos <= 0) {
+		State->ilutCurrentPos = 0;
 		ilSetError(context, ILUT_STACK_UNDERFLOW);
 		return;
 	}
 
 	// Should we check here to see if ilutCurrentPos is too large?
-	ilutCurrentPos--;
+	State->ilutCurrentPos--;
 
 	return;
 }
@@ -48,7 +48,7 @@ ILAPI HBITMAP ILAPIENTRY ilutConvertSliceToHBitmap(ILcontext* context, HDC hDC,
 	BITMAPINFO	*info = (BITMAPINFO*)buff;
 	RGBQUAD		*pal = info->bmiColors;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return NULL;
@@ -173,7 +173,7 @@ ILAPI HBITMAP ILAPIENTRY ilutConvertSliceToHBitmap(ILcontext* context, HDC hDC,
 				palImg = iConvertPal(context, &TempImage->Pal, IL_PAL_BGR32);
 				if (palImg != NULL) {
 					memcpy(pal, palImg->Palette, palImg->PalSize);
-					ilClosePal(palImg);
+					ilClosePal(context, palImg);
 				}
 				else {
 					//ilSetError(context, IL_INVALID_PARAM);
@@ -207,11 +207,11 @@ ILAPI HBITMAP ILAPIENTRY ilutConvertSliceToHBitmap(ILcontext* context, HDC hDC,
 	SetDIBits(hDC, hBitmap, 0, ilutCurImage->Height, Data, info, DIB_RGB_COLORS);
 
 	if (alloc_buffer)
-		ifree(Data);
+		ifree(context, Data);
 
 	if (ilutCurImage != TempImage) {
 		ilSetCurImage(context, ilutCurImage);
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 	}
 
 	return hBitmap;
@@ -222,7 +222,7 @@ error:
 	ilutCurImage->Depth = DepthBackup;
 	if (ilutCurImage != TempImage) {
 		ilSetCurImage(context, ilutCurImage);
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 	}
 	ilSetCurImage(context, ilutCurImage);
 	if (hBitmap)
@@ -288,9 +288,9 @@ ILubyte* ILAPIENTRY iGetPaddedData(ILcontext* context, ILimage *Image)
 	}
 
 	if (TempData != TempBuff && TempData != Image->Data)
-		ifree(TempData);
+		ifree(context, TempData);
 	if (TempBuff != Image->Data)
-		ifree(TempBuff);
+		ifree(context, TempBuff);
 
 	return NewData;
 }
@@ -299,7 +299,7 @@ ILubyte* ILAPIENTRY iGetPaddedData(ILcontext* context, ILimage *Image)
 
 void ILAPIENTRY ilutFreePaddedData(ILubyte *Data)
 {
-	ifree(Data);
+	ifree(context, Data);
 	return;
 }
 
@@ -316,7 +316,7 @@ void ILAPIENTRY ilutGetBmpInfo(ILcontext* context, BITMAPINFO *Info)
 {
 	ILuint NewBps, Padding;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return;
@@ -391,7 +391,7 @@ HPALETTE ILAPIENTRY ilutGetHPal(ILcontext* context)
 	ILuint		NumEntries, i;
 	ILenum		CurPalType;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return NULL;
@@ -424,7 +424,7 @@ HPALETTE ILAPIENTRY ilutGetHPal(ILcontext* context)
 	}
 
 	Palette = CreatePalette(LogPal);
-	ifree(LogPal);
+	ifree(context, LogPal);
 
 	ilConvertPal(context, CurPalType);  // Should we check the return value?
 
@@ -441,7 +441,7 @@ ILboolean ILAPIENTRY ilutSetHBitmap(ILcontext* context, HBITMAP Bitmap)
 	ILubyte		*Buffer1 = NULL, *Buffer2 = NULL;
 	ILuint		i, j, PadSize, Bps;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -465,8 +465,8 @@ ILboolean ILAPIENTRY ilutSetHBitmap(ILcontext* context, HBITMAP Bitmap)
 	Buffer2 = (ILubyte*)ialloc(context, Info[0].bmiHeader.biSizeImage);
 	if (Buffer1 == NULL || Buffer2 == NULL) {
 		ReleaseDC(hWnd, hDC); //added 20040527
-		ifree(Buffer1);
-		ifree(Buffer2);
+		ifree(context, Buffer1);
+		ifree(context, Buffer2);
 		return IL_FALSE;
 	}
 
@@ -492,8 +492,8 @@ ILboolean ILAPIENTRY ilutSetHBitmap(ILcontext* context, HBITMAP Bitmap)
 	ilutCurImage->Origin = IL_ORIGIN_LOWER_LEFT;
 
 	ReleaseDC(hWnd, hDC); //added 20040527
-	ifree(Buffer1);
-	ifree(Buffer2);
+	ifree(context, Buffer1);
+	ifree(context, Buffer2);
 
 #endif//_WIN32_WCE
 
@@ -507,7 +507,7 @@ ILboolean ILAPIENTRY ilutSetHPal(ILcontext* context, HPALETTE Pal)
 	ILuint			NumEntries, i;
 	ILubyte			*TempPal;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -526,11 +526,11 @@ ILboolean ILAPIENTRY ilutSetHPal(ILcontext* context, HPALETTE Pal)
 
 	TempPal = (ILubyte*)ialloc(context, NumEntries * 3);
 	if (TempPal == NULL) {
-		ifree(PalEntries);
+		ifree(context, PalEntries);
 		return IL_FALSE;
 	}
 	if (ilutCurImage->Pal.Palette)
-		ifree(ilutCurImage->Pal.Palette);
+		ifree(context, ilutCurImage->Pal.Palette);
 	ilutCurImage->Pal.Palette = TempPal;
 	ilutCurImage->Pal.PalSize = NumEntries * 3;
 	ilutCurImage->Pal.PalType = IL_PAL_RGB24;
@@ -541,7 +541,7 @@ ILboolean ILAPIENTRY ilutSetHPal(ILcontext* context, HPALETTE Pal)
 		*TempPal++ = PalEntries[i].peBlue;
 	}
 
-	ifree(PalEntries);
+	ifree(context, PalEntries);
 
 	return IL_TRUE;
 }
@@ -555,7 +555,7 @@ ILboolean ILAPIENTRY ilutSetWinClipboard(ILcontext* context)
 	HDC		hDC;
 	ILimage	*TempImage, *CurImage;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -577,12 +577,12 @@ ILboolean ILAPIENTRY ilutSetWinClipboard(ILcontext* context)
 
 	if (!OpenClipboard(NULL)) {
 		if (TempImage != ilutCurImage)
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 		ilSetCurImage(context, CurImage);
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);  // Dunno if this is the correct error.
 		ReleaseDC(hWnd, hDC); //added 20040604
 		if (TempImage != ilutCurImage)
-			ilCloseImage(TempImage);
+			ilCloseImage(context, TempImage);
 		ilSetCurImage(context, CurImage);
 		return IL_FALSE;
 	}
@@ -601,7 +601,7 @@ ILboolean ILAPIENTRY ilutSetWinClipboard(ILcontext* context)
 	//DeleteObject(Bitmap);  // Needed? No! Clipboard takes care of image.
 
 	if (TempImage != ilutCurImage)
-		ilCloseImage(TempImage);
+		ilCloseImage(context, TempImage);
 	ilSetCurImage(context, CurImage);
 
 	return IL_TRUE;
@@ -618,7 +618,7 @@ ILboolean ILAPIENTRY ilutGetWinClipboard(ILcontext* context)
 	BITMAPINFOHEADER	*InfoHeader;
 	SIZE_T		Size;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -645,7 +645,7 @@ ILboolean ILAPIENTRY ilutGetWinClipboard(ILcontext* context)
 		data = (PTSTR)ialloc(context, (ILuint)Size + sizeof(BITMAPFILEHEADER));
 		pGlobal = (PTSTR)GlobalLock(hGlobal);
 		if (!pGlobal || !data) {
-			ifree(data);
+			ifree(context, data);
 			CloseClipboard();
 			return IL_FALSE;  // No error?
 		}
@@ -705,7 +705,7 @@ ILboolean ILAPIENTRY ilutWinPrint(ILcontext* context, ILuint XPos, ILuint YPos,
 	HBITMAP		Bitmap, hReplaced;
 	HDC			hMemDC;
 
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (ilutCurImage == NULL) {
 		ilSetError(context, ILUT_ILLEGAL_OPERATION);
 		return IL_FALSE;
@@ -779,7 +779,7 @@ ILboolean ILAPIENTRY ilutWinLoadUrl(ILcontext* context, ILstring Url)
 
 	Handle = InternetOpen(IL_TEXT("Developer's Image Library"), INTERNET_OPEN_TYPE_DIRECT, NULL, NULL, 0);
 	if (Handle == NULL) {
-		ifree(Buffer);
+		ifree(context, Buffer);
 		ilSetError(context, ILUT_COULD_NOT_OPEN_FILE);
 		return IL_FALSE;
 	}
@@ -790,13 +790,13 @@ ILboolean ILAPIENTRY ilutWinLoadUrl(ILcontext* context, ILstring Url)
 		InternetCloseHandle(Handle);
 		Handle = InternetOpen(IL_TEXT("Developer's Image Library"), INTERNET_OPEN_TYPE_DIRECT, NULL, NULL, INTERNET_FLAG_FROM_CACHE);
 		if (Handle == NULL) {
-			ifree(Buffer);
+			ifree(context, Buffer);
 			ilSetError(context, ILUT_COULD_NOT_OPEN_FILE);
 			return IL_FALSE;
 		}
 		UrlHandle = InternetOpenUrl(Handle, Url, NULL, 0, 0, Context);
 		if (UrlHandle == NULL) {
-			ifree(Buffer);
+			ifree(context, Buffer);
 			InternetCloseHandle(Handle);
 			ilSetError(context, ILUT_COULD_NOT_OPEN_FILE);
 			return IL_FALSE;
@@ -807,20 +807,20 @@ ILboolean ILAPIENTRY ilutWinLoadUrl(ILcontext* context, ILstring Url)
 		if (!InternetReadFile(UrlHandle, Buff, BUFFSIZE, &BytesRead)) {
 			InternetCloseHandle(UrlHandle);
 			InternetCloseHandle(Handle);
-			ifree(Buffer);
+			ifree(context, Buffer);
 			ilSetError(context, ILUT_COULD_NOT_OPEN_FILE);
 			return IL_FALSE;
 		}
 
 		TempBuff = (ILubyte*)ialloc(context, BufferSize + BytesRead);
 		if (TempBuff == NULL) {
-			ifree(Buffer);
+			ifree(context, Buffer);
 			return IL_FALSE;
 		}
 
 		memcpy(TempBuff, Buffer, BufferSize);
 		memcpy(TempBuff + BufferSize, Buff, BytesRead);
-		ifree(Buffer);
+		ifree(context, Buffer);
 		Buffer = TempBuff;
 
 		BufferSize += BytesRead;
@@ -840,13 +840,13 @@ ILboolean ILAPIENTRY ilutWinLoadUrl(ILcontext* context, ILstring Url)
 	if (!Is404) {
 		if (!ilLoadL(context, ilTypeFromExt(context, Url), Buffer, BufferSize)) {
 			if (!ilLoadL(context, IL_TYPE_UNKNOWN, Buffer, BufferSize)) {
-				ifree(Buffer);
+				ifree(context, Buffer);
 				return IL_FALSE;
 			}
 		}
 	}
 
-	ifree(Buffer);
+	ifree(context, Buffer);
 #endif
 
 	return IL_TRUE;
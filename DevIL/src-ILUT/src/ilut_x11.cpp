@@ -70,7 +70,7 @@ void iXGrabImage( ILimage * img )
 
 Bool iXGrabCurrentImage(void)
 {
-	ilutCurImage = ilGetCurImage(context);
+	ILimage *ilutCurImage = ilGetCurImage(context);
 	if (!ilutCurImage) {
 		return False;
 	}
@@ -86,6 +86,7 @@ void iXConvertImage( Display * dpy, XImage * img )
 	int sY,dY;
  	int sZ,dZ;
 	int plane;
+	ILimage *ilutCurImage = ilGetCurImage(context);
 
 
 	ILimage * tmp;
@@ -165,7 +166,7 @@ void iXConvertImage( Display * dpy, XImage * img )
 		ilSetError( ILUT_NOT_SUPPORTED );
 	}
 
-	ilCloseImage( tmp );
+	ilCloseImage(context,  tmp );
 }
 
 ILboolean ilutXInit(void) {
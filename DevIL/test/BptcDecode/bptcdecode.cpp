@@ -0,0 +1,360 @@
+// Loads DDS files holding single BC7 and BC6H blocks built bit by bit here,
+//  and checks the pixels against values worked out from the Direct3D 11
+//  rules for each mode: endpoint expansion, p-bits, interpolation weights,
+//  anchor indices, rotation, partitions and, for BC6H, unquantising and the
+//  conversion to half floats.
+
+#include <IL/il.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#define DXGI_FORMAT_BC6H_UF16 95
+#define DXGI_FORMAT_BC6H_SF16 96
+#define DXGI_FORMAT_BC7_UNORM 98
+
+static const int Weights2[4] = { 0, 21, 43, 64 };
+static const int Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const int Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+
+// Writes the fields of a block from its least significant bit up.
+struct BlockWriter
+{
+	ILubyte	Block[16];
+	ILuint	Pos;
+
+	BlockWriter() : Pos(0) { memset(Block, 0, sizeof(Block)); }
+
+	void Put(ILuint Value, ILuint Bits)
+	{
+		for (ILuint i = 0; i < Bits; i++, Pos++) {
+			if (Value & (1u << i))
+				Block[Pos / 8] |= (ILubyte)(1 << (Pos % 8));
+		}
+	}
+};
+
+
+static void Put32(std::vector<ILubyte> &File, ILuint Value)
+{
+	for (ILuint i = 0; i < 4; i++)
+		File.push_back((ILubyte)(Value >> (i * 8)));
+}
+
+// A 4x4 DDS file with a DX10 header holding Block.
+static std::vector<ILubyte> MakeDds(ILuint DxgiFormat, const ILubyte *Block)
+{
+	std::vector<ILubyte> File;
+	ILuint i;
+
+	File.push_back('D'); File.push_back('D'); File.push_back('S'); File.push_back(' ');
+	Put32(File, 124);
+	Put32(File, 0x1 | 0x2 | 0x4 | 0x1000 | 0x80000);  // Caps, height, width, pixel format, linear size
+	Put32(File, 4);   // Height
+	Put32(File, 4);   // Width
+	Put32(File, 16);  // Linear size
+	for (i = 0; i < 13; i++)  // Depth, mipmap count, alpha depth and reserved
+		Put32(File, 0);
+	Put32(File, 32);
+	Put32(File, 0x4);  // FourCC
+	File.push_back('D'); File.push_back('X'); File.push_back('1'); File.push_back('0');
+	for (i = 0; i < 5; i++)  // Bit count and masks
+		Put32(File, 0);
+	Put32(File, 0x1000);  // Texture
+	for (i = 0; i < 4; i++)
+		Put32(File, 0);
+	Put32(File, DxgiFormat);
+	Put32(File, 3);  // 2D texture
+	Put32(File, 0);
+	Put32(File, 1);  // Array size
+	Put32(File, 0);
+	File.insert(File.end(), Block, Block + 16);
+
+	return File;
+}
+
+
+// Loads File and returns its pixels in Format and Type, or an empty buffer.
+static std::vector<ILubyte> Load(ILcontext *context, const std::vector<ILubyte> &File, ILenum Format, ILenum Type)
+{
+	std::vector<ILubyte> Pixels;
+	ILuint Image;
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (ilLoadL(context, IL_DDS, &File[0], (ILuint)File.size()) && ilGetInteger(context, IL_IMAGE_WIDTH) == 4 &&
+		ilGetInteger(context, IL_IMAGE_HEIGHT) == 4 && ilConvertImage(context, Format, Type))
+		Pixels.assign(ilGetData(context), ilGetData(context) + ilGetInteger(context, IL_IMAGE_SIZE_OF_DATA));
+	ilDeleteImages(context, 1, &Image);
+	return Pixels;
+}
+
+
+static int Compare(const char *Name, const std::vector<ILubyte> &Got, const ILubyte *Expected)
+{
+	if (Got.size() != 64) {
+		fprintf(stderr, "%s: could not load the block\n", Name);
+		return 1;
+	}
+	for (ILuint i = 0; i < 64; i++) {
+		if (Got[i] != Expected[i]) {
+			fprintf(stderr, "%s: pixel %u channel %u is %u, expected %u\n", Name, i / 4, i % 4, Got[i], Expected[i]);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+static ILubyte Interp(int e0, int e1, int w)
+{
+	return (ILubyte)(((64 - w) * e0 + w * e1 + 32) >> 6);
+}
+
+
+// Mode 6: one subset, 7-bit RGBA endpoints with a p-bit each, 4-bit indices.
+static int CheckBc7Mode6(ILcontext *context)
+{
+	static const ILuint E0[4] = { 10, 0, 64, 127 }, E1[4] = { 120, 127, 64, 0 };
+	BlockWriter	W;
+	ILubyte		Expected[64];
+	ILuint		c, i;
+
+	W.Put(1 << 6, 7);
+	for (c = 0; c < 4; c++) {
+		W.Put(E0[c], 7);
+		W.Put(E1[c], 7);
+	}
+	W.Put(0, 1);  // p-bits
+	W.Put(1, 1);
+	W.Put(0, 3);  // The anchor index has one bit less
+	for (i = 1; i < 16; i++)
+		W.Put(i, 4);
+
+	for (i = 0; i < 16; i++) {
+		for (c = 0; c < 4; c++)
+			Expected[i * 4 + c] = Interp(E0[c] << 1, (E1[c] << 1) | 1, Weights4[i]);
+	}
+	return Compare("BC7 mode 6", Load(context, MakeDds(DXGI_FORMAT_BC7_UNORM, W.Block), IL_RGBA, IL_UNSIGNED_BYTE), Expected);
+}
+
+
+// Mode 5: one subset, 7-bit colour and 8-bit alpha with their own 2-bit
+//  indices, and alpha swapped with red afterwards.
+static int CheckBc7Mode5(ILcontext *context)
+{
+	static const ILuint E0[3] = { 3, 100, 127 }, E1[3] = { 90, 5, 64 }, A0 = 200, A1 = 17;
+	static const ILuint ColourIndex[16] = { 1, 3, 2, 0, 3, 1, 0, 2, 2, 2, 1, 3, 0, 1, 3, 3 };
+	static const ILuint AlphaIndex[16] = { 0, 1, 2, 3, 3, 2, 1, 0, 1, 1, 3, 3, 2, 0, 2, 1 };
+	BlockWriter	W;
+	ILubyte		Expected[64], Temp;
+	ILuint		c, i;
+	int			e0, e1;
+
+	W.Put(1 << 5, 6);
+	W.Put(1, 2);  // Rotation: swap alpha and red
+	for (c = 0; c < 3; c++) {
+		W.Put(E0[c], 7);
+		W.Put(E1[c], 7);
+	}
+	W.Put(A0, 8);
+	W.Put(A1, 8);
+	for (i = 0; i < 16; i++)
+		W.Put(ColourIndex[i], i == 0 ? 1 : 2);
+	for (i = 0; i < 16; i++)
+		W.Put(AlphaIndex[i], i == 0 ? 1 : 2);
+
+	for (i = 0; i < 16; i++) {
+		for (c = 0; c < 3; c++) {
+			e0 = (E0[c] << 1) | (E0[c] >> 6);
+			e1 = (E1[c] << 1) | (E1[c] >> 6);
+			Expected[i * 4 + c] = Interp(e0, e1, Weights2[ColourIndex[i]]);
+		}
+		Expected[i * 4 + 3] = Interp(A0, A1, Weights2[AlphaIndex[i]]);
+		Temp = Expected[i * 4];
+		Expected[i * 4] = Expected[i * 4 + 3];
+		Expected[i * 4 + 3] = Temp;
+	}
+	return Compare("BC7 mode 5", Load(context, MakeDds(DXGI_FORMAT_BC7_UNORM, W.Block), IL_RGBA, IL_UNSIGNED_BYTE), Expected);
+}
+
+
+// Mode 1: two subsets split by partition 0 (the right half of each row is the
+//  second subset, whose anchor is pixel 15), 6-bit colour endpoints with a
+//  p-bit shared by each subset, 3-bit indices.
+static int CheckBc7Mode1(ILcontext *context)
+{
+	static const ILuint E[4][3] = { { 0, 63, 20 }, { 63, 0, 40 }, { 31, 32, 5 }, { 12, 50, 60 } };
+	static const ILuint P[2] = { 1, 0 };
+	BlockWriter	W;
+	ILubyte		Expected[64];
+	ILuint		c, e, i, Subset;
+	int			e0, e1, v;
+
+	W.Put(1 << 1, 2);
+	W.Put(0, 6);  // Partition
+	for (c = 0; c < 3; c++) {
+		for (e = 0; e < 4; e++)
+			W.Put(E[e][c], 6);
+	}
+	W.Put(P[0], 1);
+	W.Put(P[1], 1);
+	for (i = 0; i < 16; i++)
+		W.Put((i * 3) % 8 & (i == 0 || i == 15 ? 3 : 7), i == 0 || i == 15 ? 2 : 3);
+
+	for (i = 0; i < 16; i++) {
+		Subset = (i % 4) >= 2;
+		for (c = 0; c < 3; c++) {
+			v = (E[Subset * 2][c] << 1) | P[Subset];
+			e0 = (v << 1) | (v >> 6);
+			v = (E[Subset * 2 + 1][c] << 1) | P[Subset];
+			e1 = (v << 1) | (v >> 6);
+			Expected[i * 4 + c] = Interp(e0, e1, Weights3[(i * 3) % 8 & (i == 0 || i == 15 ? 3 : 7)]);
+		}
+		Expected[i * 4 + 3] = 0xFF;
+	}
+	return Compare("BC7 mode 1", Load(context, MakeDds(DXGI_FORMAT_BC7_UNORM, W.Block), IL_RGBA, IL_UNSIGNED_BYTE), Expected);
+}
+
+
+// A block with no mode bit set decodes to transparent black.
+static int CheckBc7Reserved(ILcontext *context)
+{
+	ILubyte Block[16], Expected[64];
+
+	memset(Block, 0, sizeof(Block));
+	Block[5] = 0xA5;
+	memset(Expected, 0, sizeof(Expected));
+	return Compare("BC7 reserved", Load(context, MakeDds(DXGI_FORMAT_BC7_UNORM, Block), IL_RGBA, IL_UNSIGNED_BYTE), Expected);
+}
+
+
+static ILfloat HalfToFloat(ILushort Half)
+{
+	int			Exp = (Half >> 10) & 0x1F, Mant = Half & 0x3FF;
+	ILfloat		Value;
+
+	if (Exp == 0)
+		Value = ldexpf((ILfloat)Mant, -24);
+	else
+		Value = ldexpf((ILfloat)(Mant | 0x400), Exp - 25);
+	return (Half & 0x8000) ? -Value : Value;
+}
+
+static int Unquantize(int Comp, bool Signed)
+{
+	bool Negative = Comp < 0;
+
+	if (!Signed) {
+		if (Comp == 0)
+			return 0;
+		if (Comp == 1023)
+			return 0xFFFF;
+		return ((Comp << 16) + 0x8000) >> 10;
+	}
+	if (Negative)
+		Comp = -Comp;
+	if (Comp == 0)
+		Comp = 0;
+	else if (Comp >= 511)
+		Comp = 0x7FFF;
+	else
+		Comp = ((Comp << 15) + 0x4000) >> 9;
+	return Negative ? -Comp : Comp;
+}
+
+static ILushort FinishHalf(int Value, bool Signed)
+{
+	if (!Signed)
+		return (ILushort)((Value * 31) >> 6);
+	if (Value < 0)
+		return (ILushort)(0x8000 | ((-Value * 31) >> 5));
+	return (ILushort)((Value * 31) >> 5);
+}
+
+
+// Mode 11 (code 00011): one region, 10-bit endpoints stored as they are,
+//  4-bit indices.
+static int CheckBc6Mode11(ILcontext *context, bool Signed)
+{
+	static const int UE0[3] = { 0, 1023, 300 }, UE1[3] = { 1023, 5, 700 };
+	static const int SE0[3] = { -511, 200, -3 }, SE1[3] = { 511, -200, 0 };
+	const int	*E0 = Signed ? SE0 : UE0, *E1 = Signed ? SE1 : UE1;
+	BlockWriter	W;
+	ILuint		c, i, Index;
+	int			Failed = 0;
+	ILfloat		Expected;
+	char		Name[32];
+
+	W.Put(0x03, 5);
+	for (c = 0; c < 3; c++)
+		W.Put((ILuint)E0[c] & 0x3FF, 10);
+	for (c = 0; c < 3; c++)
+		W.Put((ILuint)E1[c] & 0x3FF, 10);
+	for (i = 0; i < 16; i++)
+		W.Put(15 - i, i == 0 ? 3 : 4);
+
+	snprintf(Name, sizeof(Name), "BC6H mode 11 %s", Signed ? "signed" : "unsigned");
+	std::vector<ILubyte> Got = Load(context, MakeDds(Signed ? DXGI_FORMAT_BC6H_SF16 : DXGI_FORMAT_BC6H_UF16, W.Block), IL_RGB, IL_FLOAT);
+	if (Got.size() != 48 * sizeof(ILfloat)) {
+		fprintf(stderr, "%s: could not load the block\n", Name);
+		return 1;
+	}
+
+	for (i = 0; i < 16 && !Failed; i++) {
+		Index = i == 0 ? 7 : 15 - i;
+		for (c = 0; c < 3; c++) {
+			int a = Unquantize(E0[c], Signed), b = Unquantize(E1[c], Signed);
+			int w = Weights4[Index];
+			Expected = HalfToFloat(FinishHalf(((64 - w) * a + w * b + 32) >> 6, Signed));
+			if (((ILfloat*)&Got[0])[i * 3 + c] != Expected) {
+				fprintf(stderr, "%s: pixel %u channel %u is %g, expected %g\n", Name, i, c, ((ILfloat*)&Got[0])[i * 3 + c], Expected);
+				Failed = 1;
+				break;
+			}
+		}
+	}
+	return Failed;
+}
+
+
+// The reserved mode codes decode to black.
+static int CheckBc6Reserved(ILcontext *context)
+{
+	BlockWriter W;
+
+	W.Put(0x13, 5);
+	W.Put(0xFFFFFFFF, 32);
+	std::vector<ILubyte> Got = Load(context, MakeDds(DXGI_FORMAT_BC6H_UF16, W.Block), IL_RGB, IL_FLOAT);
+	for (ILuint i = 0; i < 48 && Got.size() == 48 * sizeof(ILfloat); i++) {
+		if (((ILfloat*)&Got[0])[i] != 0.0f)
+			break;
+		if (i == 47)
+			return 0;
+	}
+	fprintf(stderr, "BC6H reserved: block is not black\n");
+	return 1;
+}
+
+
+int main()
+{
+	ILcontext	*context = ilInit();
+	int			Failures = 0;
+
+	ilEnable(context, IL_ORIGIN_SET);
+	ilOriginFunc(context, IL_ORIGIN_UPPER_LEFT);
+
+	Failures += CheckBc7Mode6(context);
+	Failures += CheckBc7Mode5(context);
+	Failures += CheckBc7Mode1(context);
+	Failures += CheckBc7Reserved(context);
+	Failures += CheckBc6Mode11(context, false);
+	Failures += CheckBc6Mode11(context, true);
+	Failures += CheckBc6Reserved(context);
+
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
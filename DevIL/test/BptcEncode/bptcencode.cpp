@@ -0,0 +1,182 @@
+// Saves images as BC7 and BC6H DDS files, loads them back and checks the
+//  pixels stay close to the source.  The images are not a multiple of 4 wide
+//  or high, so the edge blocks are padded, and their left columns are solid,
+//  which the encoder must keep to within a step of the endpoint precision.
+//  A higher IL_BPTC_EFFORT must not do worse than a lower one.
+
+#include <IL/il.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#define WIDTH  37
+#define HEIGHT 21
+#define SOLID  8  // Columns of solid blocks on the left
+
+
+static ILuint Next(ILuint &Seed)
+{
+	Seed = Seed * 1664525 + 1013904223;
+	return Seed >> 8;
+}
+
+
+// Saves the bound image as a DDS file of DXTCFormat in memory and loads it
+//  back into Pixels as Format and Type.
+static bool RoundTrip(ILcontext *context, ILenum DXTCFormat, ILuint Effort, ILenum Format, ILenum Type, std::vector<ILubyte> &Pixels)
+{
+	ILuint	Image, Saved = ilGetInteger(context, IL_CUR_IMAGE);
+	ILsizei	Size;
+	void	*Lump;
+	bool	Ok;
+
+	ilSetInteger(context, IL_DXTC_FORMAT, DXTCFormat);
+	ilSetInteger(context, IL_BPTC_EFFORT, Effort);
+	Lump = ilSaveToMemory(context, IL_DDS, &Size);
+	if (Lump == NULL)
+		return false;
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	Ok = ilLoadL(context, IL_DDS, Lump, (ILuint)Size) && ilGetInteger(context, IL_IMAGE_WIDTH) == WIDTH &&
+		ilGetInteger(context, IL_IMAGE_HEIGHT) == HEIGHT && ilConvertImage(context, Format, Type);
+	if (Ok)
+		Pixels.assign(ilGetData(context), ilGetData(context) + ilGetInteger(context, IL_IMAGE_SIZE_OF_DATA));
+	ilDeleteImages(context, 1, &Image);
+	ilBindImage(context, Saved);
+	ifree(context, Lump);
+	return Ok;
+}
+
+
+static int CheckBc7(ILcontext *context)
+{
+	std::vector<ILubyte> Src(WIDTH * HEIGHT * 4), Low, High;
+	ILuint	Seed = 1, Image, x, y, c, i, MaxErr = 0;
+	double	SqErr[2] = { 0, 0 };
+	int		Failed = 0;
+
+	for (y = 0; y < HEIGHT; y++) {
+		for (x = 0; x < WIDTH; x++) {
+			for (c = 0; c < 4; c++) {
+				ILubyte *p = &Src[(y * WIDTH + x) * 4 + c];
+				if (x < SOLID)
+					*p = (ILubyte)(((x / 4) * 4 + (y / 4)) * 23 + c * 61);
+				else
+					*p = (ILubyte)(x * 5 + y * 3 * (c + 1) + c * 40 + Next(Seed) % 9);
+			}
+		}
+	}
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	ilTexImage(context, WIDTH, HEIGHT, 1, 4, IL_RGBA, IL_UNSIGNED_BYTE, &Src[0]);
+	ilGetCurImage(context)->Origin = IL_ORIGIN_UPPER_LEFT;
+	if (!RoundTrip(context, IL_BC7, 0, IL_RGBA, IL_UNSIGNED_BYTE, Low) ||
+		!RoundTrip(context, IL_BC7, 64, IL_RGBA, IL_UNSIGNED_BYTE, High)) {
+		fprintf(stderr, "BC7: could not save and load the image (%x)\n", ilGetError(context));
+		ilDeleteImages(context, 1, &Image);
+		return 1;
+	}
+	ilDeleteImages(context, 1, &Image);
+
+	for (i = 0; i < Src.size(); i++) {
+		int Err = (int)High[i] - Src[i];
+		if ((i / 4) % WIDTH < SOLID && (Err < -1 || Err > 1) && !Failed) {
+			fprintf(stderr, "BC7: solid pixel %u channel %u is %u, expected %u\n", i / 4, i % 4, High[i], Src[i]);
+			Failed = 1;
+		}
+		MaxErr = Err < 0 ? IL_MAX(MaxErr, (ILuint)-Err) : IL_MAX(MaxErr, (ILuint)Err);
+		SqErr[1] += Err * Err;
+		Err = (int)Low[i] - Src[i];
+		SqErr[0] += Err * Err;
+	}
+
+	if (MaxErr > 24 || SqErr[1] / Src.size() > 16.0) {
+		fprintf(stderr, "BC7: error too large (max %u, mean square %g)\n", MaxErr, SqErr[1] / Src.size());
+		Failed = 1;
+	}
+	if (SqErr[1] > SqErr[0]) {
+		fprintf(stderr, "BC7: effort 64 is worse than effort 0 (%g > %g)\n", SqErr[1], SqErr[0]);
+		Failed = 1;
+	}
+	return Failed;
+}
+
+
+static int CheckBc6h(ILcontext *context, bool Signed)
+{
+	std::vector<ILfloat> Src(WIDTH * HEIGHT * 3);
+	std::vector<ILubyte> Low, High;
+	const char *Name = Signed ? "BC6H signed" : "BC6H";
+	ILuint	Seed = 2, Image, x, y, c, i;
+	double	RelErr[2] = { 0, 0 }, MaxRel = 0, Rel;
+	int		Failed = 0;
+
+	for (y = 0; y < HEIGHT; y++) {
+		for (x = 0; x < WIDTH; x++) {
+			for (c = 0; c < 3; c++) {
+				ILfloat *p = &Src[(y * WIDTH + x) * 3 + c];
+				if (x < SOLID)
+					*p = ((x / 4) * 6 + (y / 4) + 1) * (c + 1) * 0.25f;
+				else
+					*p = powf(2.0f, (x + y * c) / 6.0f - 3.0f) * (1.0f + (Next(Seed) % 64) / 1024.0f);
+				if (Signed && ((x / 4 + y / 4) & 1))
+					*p = -*p;
+			}
+		}
+	}
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	ilTexImage(context, WIDTH, HEIGHT, 1, 3, IL_RGB, IL_FLOAT, &Src[0]);
+	ilGetCurImage(context)->Origin = IL_ORIGIN_UPPER_LEFT;
+	if (!RoundTrip(context, Signed ? IL_BC6H_SF : IL_BC6H, 0, IL_RGB, IL_FLOAT, Low) ||
+		!RoundTrip(context, Signed ? IL_BC6H_SF : IL_BC6H, 64, IL_RGB, IL_FLOAT, High)) {
+		fprintf(stderr, "%s: could not save and load the image (%x)\n", Name, ilGetError(context));
+		ilDeleteImages(context, 1, &Image);
+		return 1;
+	}
+	ilDeleteImages(context, 1, &Image);
+
+	for (i = 0; i < Src.size(); i++) {
+		ILfloat Got = ((ILfloat*)&High[0])[i];
+		Rel = fabs(Got - Src[i]) / IL_MAX(fabs(Src[i]), 1.0 / 64);
+		if ((i / 3) % WIDTH < SOLID && Rel > 1.0 / 512 && !Failed) {
+			fprintf(stderr, "%s: solid pixel %u channel %u is %g, expected %g\n", Name, i / 3, i % 3, Got, Src[i]);
+			Failed = 1;
+		}
+		MaxRel = IL_MAX(MaxRel, Rel);
+		RelErr[1] += Rel;
+		RelErr[0] += fabs(((ILfloat*)&Low[0])[i] - Src[i]) / IL_MAX(fabs(Src[i]), 1.0 / 64);
+	}
+
+	if (MaxRel > 0.25 || RelErr[1] / Src.size() > 0.05) {
+		fprintf(stderr, "%s: error too large (max %g, mean %g)\n", Name, MaxRel, RelErr[1] / Src.size());
+		Failed = 1;
+	}
+	if (RelErr[1] > RelErr[0]) {
+		fprintf(stderr, "%s: effort 64 is worse than effort 0 (%g > %g)\n", Name, RelErr[1], RelErr[0]);
+		Failed = 1;
+	}
+	return Failed;
+}
+
+
+int main()
+{
+	ILcontext	*context = ilInit();
+	int			Failures = 0;
+
+	ilEnable(context, IL_ORIGIN_SET);
+	ilOriginFunc(context, IL_ORIGIN_UPPER_LEFT);
+
+	Failures += CheckBc7(context);
+	Failures += CheckBc6h(context, false);
+	Failures += CheckBc6h(context, true);
+
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+// Converts small images between every pair of direct-colour formats and the
+//  byte, short, int, half and float types, and checks ilConvertImage, which
+//  works in place when the pixels do not grow, gives exactly what
+//  ilConvertBuffer does.  The images include white, whose luminance lands on
+//  the largest value of the integer types.
+
+#include <IL/il.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define NUM_PIX 67
+
+static const ILenum Formats[] = { IL_RGB, IL_RGBA, IL_BGR, IL_BGRA, IL_LUMINANCE, IL_LUMINANCE_ALPHA };
+static const ILenum Types[] = { IL_UNSIGNED_BYTE, IL_UNSIGNED_SHORT, IL_UNSIGNED_INT, IL_HALF, IL_FLOAT };
+#define NUM_FORMATS (sizeof(Formats) / sizeof(Formats[0]))
+#define NUM_TYPES   (sizeof(Types) / sizeof(Types[0]))
+
+
+static ILuint Next(ILuint &Seed)
+{
+	Seed = Seed * 1664525 + 1013904223;
+	return Seed >> 8;
+}
+
+
+// Fills Data with NumPix pixels of Bpp channels.  Every fifth pixel is white.
+static void MakePixels(ILenum Type, ILuint Bpp, std::vector<ILubyte> &Data)
+{
+	ILuint Seed = 12345, i, Num = NUM_PIX * Bpp;
+	bool White;
+
+	Data.resize(Num * ilGetBpcType(Type));
+	for (i = 0; i < Num; i++) {
+		White = (i / Bpp) % 5 == 0;
+		switch (Type)
+		{
+			case IL_UNSIGNED_BYTE:
+				Data[i] = White ? 0xFF : (ILubyte)Next(Seed);
+				break;
+			case IL_UNSIGNED_SHORT:
+				((ILushort*)&Data[0])[i] = White ? 0xFFFF : (ILushort)Next(Seed);
+				break;
+			case IL_UNSIGNED_INT:
+				((ILuint*)&Data[0])[i] = White ? 0xFFFFFFFF : Next(Seed) * 257u;
+				break;
+			case IL_HALF:  // Finite values below 2, and 1.0 for white
+				((ILushort*)&Data[0])[i] = White ? 0x3C00 : (ILushort)(Next(Seed) % 0x4000);
+				break;
+			case IL_FLOAT:  // Some fall outside [0, 1]
+				((ILfloat*)&Data[0])[i] = White ? 1.0f : (ILint)(Next(Seed) % 1200) / 1000.0f - 0.1f;
+				break;
+		}
+	}
+}
+
+
+// White must come out at the top of an integer type's range, not wrapped around
+//  past it.  Luminance weights add up to a hair under 1.0, hence the slack.
+static bool WhiteOk(ILenum DestType, const ILubyte *Data, ILuint Bpp)
+{
+	ILuint i, c;
+	ILdouble Val = 0, Max;
+
+	for (i = 0; i < NUM_PIX; i += 5) {
+		for (c = 0; c < Bpp; c++) {
+			switch (DestType)
+			{
+				case IL_UNSIGNED_BYTE:
+					Val = Data[i * Bpp + c], Max = 0xFF;
+					break;
+				case IL_UNSIGNED_SHORT:
+					Val = ((const ILushort*)Data)[i * Bpp + c], Max = 0xFFFF;
+					break;
+				case IL_UNSIGNED_INT:
+					Val = ((const ILuint*)Data)[i * Bpp + c], Max = 0xFFFFFFFF;
+					break;
+				default:
+					return true;
+			}
+			if (Val < Max - Max / 256)
+				return false;
+		}
+	}
+	return true;
+}
+
+
+static int CheckConversion(ILcontext *context, ILenum SrcFormat, ILenum SrcType, ILenum DestFormat, ILenum DestType)
+{
+	std::vector<ILubyte> Data;
+	ILuint SrcBpp = ilGetBppFormat(SrcFormat), Image, Size;
+	ILubyte *Expected;
+	int Failed = 0;
+
+	MakePixels(SrcType, SrcBpp, Data);
+
+	Expected = (ILubyte*)ilConvertBuffer(context, (ILsizei)Data.size(), SrcFormat, DestFormat, SrcType, DestType, NULL, &Data[0]);
+	if (Expected == NULL) {
+		fprintf(stderr, "ilConvertBuffer %x/%x -> %x/%x failed\n", SrcFormat, SrcType, DestFormat, DestType);
+		return 1;
+	}
+	if (!WhiteOk(DestType, Expected, ilGetBppFormat(DestFormat))) {
+		fprintf(stderr, "%x/%x -> %x/%x: white is not at the top of the range\n", SrcFormat, SrcType, DestFormat, DestType);
+		Failed = 1;
+	}
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilTexImage(context, NUM_PIX, 1, 1, (ILubyte)SrcBpp, SrcFormat, SrcType, &Data[0]) ||
+		!ilConvertImage(context, DestFormat, DestType)) {
+		fprintf(stderr, "ilConvertImage %x/%x -> %x/%x failed\n", SrcFormat, SrcType, DestFormat, DestType);
+		Failed = 1;
+	}
+	else {
+		Size = NUM_PIX * ilGetBppFormat(DestFormat) * ilGetBpcType(DestType);
+		if ((ILuint)ilGetInteger(context, IL_IMAGE_SIZE_OF_DATA) != Size || memcmp(ilGetData(context), Expected, Size) != 0) {
+			fprintf(stderr, "%x/%x -> %x/%x: ilConvertImage and ilConvertBuffer differ\n",
+				SrcFormat, SrcType, DestFormat, DestType);
+			Failed = 1;
+		}
+	}
+
+	ilDeleteImages(context, 1, &Image);
+	if (Expected != &Data[0])
+		ifree(context, Expected);
+	return Failed;
+}
+
+
+int main()
+{
+	ILcontext *context = ilInit();
+	int Failures = 0;
+	ILuint sf, st, df, dt;
+
+	for (st = 0; st < NUM_TYPES; st++)
+		for (dt = 0; dt < NUM_TYPES; dt++)
+			for (sf = 0; sf < NUM_FORMATS; sf++)
+				for (df = 0; df < NUM_FORMATS; df++)
+					Failures += CheckConversion(context, Formats[sf], Types[st], Formats[df], Types[dt]);
+
+	ilShutDown(context);
+	if (Failures)
+		fprintf(stderr, "%d conversions failed\n", Failures);
+	return Failures ? 1 : 0;
+}
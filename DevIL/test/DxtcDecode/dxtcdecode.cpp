@@ -0,0 +1,205 @@
+// Loads DXT1, DXT3 and DXT5 DDS files of random blocks at sizes that are not
+//  a multiple of 4, so the blocks on the right and bottom edges hang over the
+//  image, and checks every pixel against a plain decode written out here.
+//  Rows of different numbers of blocks cover the vector loops and their
+//  tails, a volume texture covers the slices, and a large image is split
+//  over threads.
+
+#include <IL/il.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+struct Size
+{
+	ILuint Width, Height, Depth;
+};
+
+static const Size Sizes[] = {
+	{ 1, 1, 1 }, { 2, 3, 1 }, { 5, 5, 1 }, { 13, 7, 1 }, { 37, 9, 1 }, { 64, 4, 1 },
+	{ 71, 30, 1 }, { 10, 6, 3 }, { 518, 259, 1 }
+};
+#define NUM_SIZES (sizeof(Sizes) / sizeof(Sizes[0]))
+
+
+static ILuint Next(ILuint &Seed)
+{
+	Seed = Seed * 1664525 + 1013904223;
+	return Seed >> 8;
+}
+
+
+static void Put32(std::vector<ILubyte> &File, ILuint Value)
+{
+	for (ILuint i = 0; i < 4; i++)
+		File.push_back((ILubyte)(Value >> (i * 8)));
+}
+
+// A DDS file of the blocks in Data, with a FourCC of DXTn.
+static std::vector<ILubyte> MakeDds(char n, const Size &S, const std::vector<ILubyte> &Data)
+{
+	std::vector<ILubyte> File;
+	ILuint i;
+
+	File.push_back('D'); File.push_back('D'); File.push_back('S'); File.push_back(' ');
+	Put32(File, 124);
+	Put32(File, 0x1 | 0x2 | 0x4 | 0x1000 | 0x80000 | (S.Depth > 1 ? 0x800000 : 0));
+	Put32(File, S.Height);
+	Put32(File, S.Width);
+	Put32(File, (ILuint)Data.size() / S.Depth);
+	Put32(File, S.Depth > 1 ? S.Depth : 0);
+	for (i = 0; i < 12; i++)  // Mipmap count, alpha depth and reserved
+		Put32(File, 0);
+	Put32(File, 32);
+	Put32(File, 0x4);  // FourCC
+	File.push_back('D'); File.push_back('X'); File.push_back('T'); File.push_back(n);
+	for (i = 0; i < 5; i++)  // Bit count and masks
+		Put32(File, 0);
+	Put32(File, 0x1000 | (S.Depth > 1 ? 0x8 : 0));  // Texture, complex
+	Put32(File, S.Depth > 1 ? 0x200000 : 0);  // Volume
+	for (i = 0; i < 3; i++)
+		Put32(File, 0);
+	File.insert(File.end(), Data.begin(), Data.end());
+
+	return File;
+}
+
+
+// Expands a 565 colour to 8 bits a channel by repeating the top bits.
+static void Colour565(ILuint c, ILuint *Rgb)
+{
+	ILuint r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+
+	Rgb[0] = (r << 3) | (r >> 2);
+	Rgb[1] = (g << 2) | (g >> 4);
+	Rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Decodes the colour half of a block (8 bytes) to 16 RGBA pixels.  As DevIL
+//  always has, the transparent fourth colour of a three-colour DXT1 block
+//  keeps the colour a third of the way from the second, rather than black.
+static void DecodeColours(const ILubyte *Block, bool Dxt1, ILubyte *Out)
+{
+	ILuint	c0 = Block[0] | (Block[1] << 8), c1 = Block[2] | (Block[3] << 8);
+	ILuint	Pal[4][4], i, c, Index;
+
+	Colour565(c0, Pal[0]);
+	Colour565(c1, Pal[1]);
+	for (c = 0; c < 3; c++) {
+		if (!Dxt1 || c0 > c1)
+			Pal[2][c] = (2 * Pal[0][c] + Pal[1][c] + 1) / 3;
+		else
+			Pal[2][c] = (Pal[0][c] + Pal[1][c]) / 2;
+		Pal[3][c] = (Pal[0][c] + 2 * Pal[1][c] + 1) / 3;
+	}
+	Pal[0][3] = Pal[1][3] = Pal[2][3] = 0xFF;
+	Pal[3][3] = (Dxt1 && c0 <= c1) ? 0 : 0xFF;
+
+	for (i = 0; i < 16; i++) {
+		Index = (Block[4 + i / 4] >> ((i % 4) * 2)) & 3;
+		for (c = 0; c < 4; c++)
+			Out[i * 4 + c] = (ILubyte)Pal[Index][c];
+	}
+}
+
+// Decodes one block of DXTn to 16 RGBA pixels.
+static void DecodeBlock(char n, const ILubyte *Block, ILubyte *Out)
+{
+	ILuint i, a0, a1, Alpha[8], Bits;
+
+	if (n == '1') {
+		DecodeColours(Block, true, Out);
+		return;
+	}
+
+	DecodeColours(Block + 8, false, Out);
+	if (n == '3') {
+		for (i = 0; i < 16; i++)
+			Out[i * 4 + 3] = (ILubyte)(((Block[i / 2] >> ((i % 2) * 4)) & 0xF) * 17);
+		return;
+	}
+
+	a0 = Alpha[0] = Block[0];
+	a1 = Alpha[1] = Block[1];
+	for (i = 1; i < 7; i++) {
+		if (a0 > a1)
+			Alpha[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+		else if (i < 5)
+			Alpha[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+	}
+	if (a0 <= a1) {
+		Alpha[6] = 0;
+		Alpha[7] = 255;
+	}
+	for (i = 0; i < 16; i++) {
+		Bits = Block[2 + i / 8 * 3] | (Block[3 + i / 8 * 3] << 8) | (Block[4 + i / 8 * 3] << 16);
+		Out[i * 4 + 3] = (ILubyte)Alpha[(Bits >> ((i % 8) * 3)) & 7];
+	}
+}
+
+
+static int CheckDxtc(ILcontext *context, char n, const Size &S)
+{
+	ILuint	BlocksX = (S.Width + 3) / 4, BlocksY = (S.Height + 3) / 4, BlockSize = n == '1' ? 8 : 16;
+	ILuint	Seed = S.Width * 131 + S.Height + n, Image, i, x, y, z;
+	ILubyte	Pixels[64];
+	const ILubyte *Got;
+	int		Failed = 0;
+
+	std::vector<ILubyte> Data(BlocksX * BlocksY * S.Depth * BlockSize);
+	for (i = 0; i < Data.size(); i++)
+		Data[i] = (ILubyte)Next(Seed);
+	std::vector<ILubyte> File = MakeDds(n, S, Data);
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilLoadL(context, IL_DDS, &File[0], (ILuint)File.size()) || !ilConvertImage(context, IL_RGBA, IL_UNSIGNED_BYTE) ||
+		(ILuint)ilGetInteger(context, IL_IMAGE_WIDTH) != S.Width || (ILuint)ilGetInteger(context, IL_IMAGE_HEIGHT) != S.Height ||
+		(ILuint)ilGetInteger(context, IL_IMAGE_DEPTH) != S.Depth) {
+		fprintf(stderr, "DXT%c %ux%ux%u: could not load the file\n", n, S.Width, S.Height, S.Depth);
+		ilDeleteImages(context, 1, &Image);
+		return 1;
+	}
+	Got = ilGetData(context);
+
+	for (z = 0; z < S.Depth && !Failed; z++) {
+		for (y = 0; y < BlocksY * 4 && !Failed; y += 4) {
+			for (x = 0; x < BlocksX * 4 && !Failed; x += 4) {
+				DecodeBlock(n, &Data[((z * BlocksY + y / 4) * BlocksX + x / 4) * BlockSize], Pixels);
+				for (i = 0; i < 16; i++) {
+					ILuint px = x + i % 4, py = y + i / 4;
+					if (px >= S.Width || py >= S.Height)
+						continue;
+					if (memcmp(Got + ((z * S.Height + py) * S.Width + px) * 4, Pixels + i * 4, 4) != 0) {
+						fprintf(stderr, "DXT%c %ux%ux%u: pixel %u,%u,%u differs\n", n, S.Width, S.Height, S.Depth, px, py, z);
+						Failed = 1;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	ilDeleteImages(context, 1, &Image);
+	return Failed;
+}
+
+
+int main()
+{
+	ILcontext	*context = ilInit();
+	int			Failures = 0;
+	ILuint		i;
+
+	ilEnable(context, IL_ORIGIN_SET);
+	ilOriginFunc(context, IL_ORIGIN_UPPER_LEFT);
+
+	for (i = 0; i < NUM_SIZES; i++) {
+		Failures += CheckDxtc(context, '1', Sizes[i]);
+		Failures += CheckDxtc(context, '3', Sizes[i]);
+		Failures += CheckDxtc(context, '5', Sizes[i]);
+	}
+
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,229 @@
+// Loads a KTX file holding hand-built ETC1 and EAC blocks and checks the
+//  pixels against values worked out from the Khronos rules, then saves an
+//  image as ETC1, ETC2 and ETC2 + EAC KTX files, loads them back and checks
+//  the pixels stay close to the source.  The image is not a multiple of 4
+//  wide or high, and a higher IL_ETC_QUALITY must not do worse than a lower one.
+
+#include <IL/il.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define WIDTH  37
+#define HEIGHT 21
+
+#define GL_RGBA                       0x1908
+#define GL_COMPRESSED_RGBA8_ETC2_EAC  0x9278
+
+static const int EtcModifiers[8][2] = {
+	{ 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+static const int EacModifiers1[8] = { -3, -7, -10, -13, 2, 6, 9, 12 };  // Table 1
+
+
+static ILuint Next(ILuint &Seed)
+{
+	Seed = Seed * 1664525 + 1013904223;
+	return Seed >> 8;
+}
+
+static int Clamp(int Value)
+{
+	return Value < 0 ? 0 : (Value > 255 ? 255 : Value);
+}
+
+static void Put32(std::vector<ILubyte> &File, ILuint Value)
+{
+	for (ILuint i = 0; i < 4; i++)
+		File.push_back((ILubyte)(Value >> (i * 8)));
+}
+
+
+// An ETC1 block in individual mode, flipped so the subblocks are the top and
+//  bottom halves, and an EAC alpha block with table 1.  Both store pixel
+//  indices a column at a time.
+static int CheckKnownBlocks(ILcontext *context)
+{
+	static const ILuint Base[2][3] = { { 0x3, 0xC, 0x8 }, { 0xF, 0x1, 0x6 } };  // 4 bits a channel
+	static const ILuint Table[2] = { 2, 6 };
+	static const int Base8 = 120, Mult = 3;
+	ILubyte	Etc[8], Eac[8], Expected[64];
+	ILuint	Index[16], AlphaIndex[16], Image, x, y, i, c, Msb = 0, Lsb = 0, Sub;
+	ILuint64 AlphaBits = 0;
+	int		Mod, Failed = 0;
+
+	for (i = 0; i < 16; i++) {
+		Index[i] = (i * 7 + 1) % 4;
+		AlphaIndex[i] = (i * 5 + 3) % 8;
+	}
+
+	Etc[0] = (ILubyte)((Base[0][0] << 4) | Base[1][0]);
+	Etc[1] = (ILubyte)((Base[0][1] << 4) | Base[1][1]);
+	Etc[2] = (ILubyte)((Base[0][2] << 4) | Base[1][2]);
+	Etc[3] = (ILubyte)((Table[0] << 5) | (Table[1] << 2) | 0x01);  // Individual, flipped
+	for (i = 0; i < 16; i++) {  // i is x * 4 + y
+		Msb |= (Index[i] >> 1) << i;
+		Lsb |= (Index[i] & 1) << i;
+	}
+	Etc[4] = (ILubyte)(Msb >> 8); Etc[5] = (ILubyte)Msb;
+	Etc[6] = (ILubyte)(Lsb >> 8); Etc[7] = (ILubyte)Lsb;
+
+	Eac[0] = Base8;
+	Eac[1] = (ILubyte)((Mult << 4) | 1);
+	for (i = 0; i < 16; i++)
+		AlphaBits |= (ILuint64)AlphaIndex[i] << (45 - i * 3);
+	for (i = 0; i < 6; i++)
+		Eac[2 + i] = (ILubyte)(AlphaBits >> (40 - i * 8));
+
+	for (y = 0; y < 4; y++) {
+		for (x = 0; x < 4; x++) {
+			i = x * 4 + y;
+			Sub = y >= 2;
+			Mod = EtcModifiers[Table[Sub]][Index[i] & 1];
+			if (Index[i] & 2)
+				Mod = -Mod;
+			for (c = 0; c < 3; c++)
+				Expected[(y * 4 + x) * 4 + c] = (ILubyte)Clamp((int)(Base[Sub][c] * 17) + Mod);
+			Expected[(y * 4 + x) * 4 + 3] = (ILubyte)Clamp(Base8 + EacModifiers1[AlphaIndex[i]] * Mult);
+		}
+	}
+
+	std::vector<ILubyte> File;
+	const char Identifier[12] = { '\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n' };
+	File.insert(File.end(), Identifier, Identifier + 12);
+	Put32(File, 0x04030201);
+	Put32(File, 0);  // glType
+	Put32(File, 1);  // glTypeSize
+	Put32(File, 0);  // glFormat
+	Put32(File, GL_COMPRESSED_RGBA8_ETC2_EAC);
+	Put32(File, GL_RGBA);
+	Put32(File, 4);
+	Put32(File, 4);
+	Put32(File, 0);
+	Put32(File, 0);
+	Put32(File, 1);  // Faces
+	Put32(File, 1);  // Mipmap levels
+	Put32(File, 0);  // Key/value data
+	Put32(File, 16);
+	File.insert(File.end(), Eac, Eac + 8);
+	File.insert(File.end(), Etc, Etc + 8);
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilLoadL(context, IL_KTX, &File[0], (ILuint)File.size()) || !ilConvertImage(context, IL_RGBA, IL_UNSIGNED_BYTE) ||
+		ilGetInteger(context, IL_IMAGE_WIDTH) != 4 || ilGetInteger(context, IL_IMAGE_HEIGHT) != 4) {
+		fprintf(stderr, "ETC2 + EAC block: could not load the file\n");
+		Failed = 1;
+	}
+	else {
+		for (i = 0; i < 64; i++) {
+			if (ilGetData(context)[i] != Expected[i]) {
+				fprintf(stderr, "ETC2 + EAC block: pixel %u channel %u is %u, expected %u\n", i / 4, i % 4,
+					ilGetData(context)[i], Expected[i]);
+				Failed = 1;
+				break;
+			}
+		}
+	}
+	ilDeleteImages(context, 1, &Image);
+	return Failed;
+}
+
+
+// Saves the bound image as a KTX file compressed to Comp and loads it back.
+static bool RoundTrip(ILcontext *context, ILenum Comp, ILuint Quality, std::vector<ILubyte> &Pixels)
+{
+	ILuint	Image, Saved = ilGetInteger(context, IL_CUR_IMAGE);
+	ILsizei	Size;
+	void	*Lump;
+	bool	Ok;
+
+	ilSetInteger(context, IL_KTX_COMP, Comp);
+	ilSetInteger(context, IL_ETC_QUALITY, Quality);
+	Lump = ilSaveToMemory(context, IL_KTX, &Size);
+	ilSetInteger(context, IL_KTX_COMP, IL_DXT_NO_COMP);
+	if (Lump == NULL)
+		return false;
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	Ok = ilLoadL(context, IL_KTX, Lump, (ILuint)Size) && ilGetInteger(context, IL_IMAGE_WIDTH) == WIDTH &&
+		ilGetInteger(context, IL_IMAGE_HEIGHT) == HEIGHT && ilConvertImage(context, IL_RGBA, IL_UNSIGNED_BYTE);
+	if (Ok)
+		Pixels.assign(ilGetData(context), ilGetData(context) + WIDTH * HEIGHT * 4);
+	ilDeleteImages(context, 1, &Image);
+	ilBindImage(context, Saved);
+	ifree(context, Lump);
+	return Ok;
+}
+
+
+static int CheckRoundTrip(ILcontext *context, ILenum Comp, const char *Name, const std::vector<ILubyte> &Src)
+{
+	std::vector<ILubyte> Low, High;
+	ILuint	i, MaxErr = 0;
+	double	SqErr[2] = { 0, 0 };
+	int		Err, Failed = 0;
+
+	if (!RoundTrip(context, Comp, 0, Low) || !RoundTrip(context, Comp, 2, High)) {
+		fprintf(stderr, "%s: could not save and load the image (%x)\n", Name, ilGetError(context));
+		return 1;
+	}
+
+	for (i = 0; i < Src.size(); i++) {
+		// Without EAC the alpha is opaque.
+		int Expected = (i % 4 == 3 && Comp != IL_ETC2_RGBA) ? 255 : Src[i];
+		Err = (int)High[i] - Expected;
+		MaxErr = IL_MAX(MaxErr, (ILuint)(Err < 0 ? -Err : Err));
+		SqErr[1] += Err * Err;
+		Err = (int)Low[i] - Expected;
+		SqErr[0] += Err * Err;
+	}
+
+	if (MaxErr > 24 || SqErr[1] / Src.size() > 20.0) {
+		fprintf(stderr, "%s: error too large (max %u, mean square %g)\n", Name, MaxErr, SqErr[1] / Src.size());
+		Failed = 1;
+	}
+	if (SqErr[1] > SqErr[0]) {
+		fprintf(stderr, "%s: quality 2 is worse than quality 0 (%g > %g)\n", Name, SqErr[1], SqErr[0]);
+		Failed = 1;
+	}
+	return Failed;
+}
+
+
+int main()
+{
+	ILcontext	*context = ilInit();
+	int			Failures = 0;
+	ILuint		Seed = 3, Image, x, y;
+
+	ilEnable(context, IL_ORIGIN_SET);
+	ilOriginFunc(context, IL_ORIGIN_UPPER_LEFT);
+
+	Failures += CheckKnownBlocks(context);
+
+	std::vector<ILubyte> Src(WIDTH * HEIGHT * 4);
+	for (y = 0; y < HEIGHT; y++) {
+		for (x = 0; x < WIDTH; x++) {
+			ILubyte *p = &Src[(y * WIDTH + x) * 4];
+			p[0] = (ILubyte)(x * 4 + y + Next(Seed) % 7);
+			p[1] = (ILubyte)(x * 2 + y * 4 + Next(Seed) % 7);
+			p[2] = (ILubyte)(220 - x * 3 - y + Next(Seed) % 7);
+			p[3] = (ILubyte)(60 + x * 2 + y * 3 + Next(Seed) % 7);
+		}
+	}
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	ilTexImage(context, WIDTH, HEIGHT, 1, 4, IL_RGBA, IL_UNSIGNED_BYTE, &Src[0]);
+	ilGetCurImage(context)->Origin = IL_ORIGIN_UPPER_LEFT;
+
+	Failures += CheckRoundTrip(context, IL_ETC1, "ETC1", Src);
+	Failures += CheckRoundTrip(context, IL_ETC2_RGB, "ETC2", Src);
+	Failures += CheckRoundTrip(context, IL_ETC2_RGBA, "ETC2 + EAC", Src);
+
+	ilDeleteImages(context, 1, &Image);
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
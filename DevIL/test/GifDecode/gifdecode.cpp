@@ -0,0 +1,258 @@
+// Builds GIFs in memory with a small LZW encoder and checks what the loader
+//  makes of them: interlaced frames (whole and as part of an animation) and
+//  files that end in the middle of a frame's data.
+
+#include <IL/il.h>
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <vector>
+
+#define WIDTH  61
+#define HEIGHT 37
+
+typedef std::vector<ILubyte> Bytes;
+
+struct Frame
+{
+	ILuint OffX, OffY, Width, Height;
+	ILboolean Interlaced;
+	ILuint Seed;
+};
+
+
+static ILubyte Pixel(ILuint Seed, ILuint x, ILuint y)
+{
+	// Repeats often enough for the encoder to build long strings.
+	return (ILubyte)(((x / 3) * 5 + (y / 2) * 11 + Seed * 17 + ((x * y) % 7)) & 0x3F);
+}
+
+
+// Packs LSB-first codes of a varying size into data sub-blocks.
+class CodeWriter
+{
+public:
+	CodeWriter() : Bits(0), Count(0) {}
+
+	void Put(ILuint Code, ILuint Size)
+	{
+		Bits |= Code << Count;
+		Count += Size;
+		while (Count >= 8) {
+			Data.push_back((ILubyte)Bits);
+			Bits >>= 8;
+			Count -= 8;
+		}
+	}
+
+	void Finish(Bytes &Out)
+	{
+		size_t i, n;
+
+		if (Count > 0)
+			Data.push_back((ILubyte)Bits);
+		for (i = 0; i < Data.size(); i += n) {
+			n = Data.size() - i < 255 ? Data.size() - i : 255;
+			Out.push_back((ILubyte)n);
+			Out.insert(Out.end(), Data.begin() + i, Data.begin() + i + n);
+		}
+		Out.push_back(0);  // Block terminator
+	}
+
+private:
+	Bytes  Data;
+	ILuint Bits, Count;
+};
+
+
+// Appends the LZW data (minimum code size 8) for Pixels.
+static void Encode(const Bytes &Pixels, Bytes &Out)
+{
+	std::map<ILuint, ILuint> Table;
+	CodeWriter Writer;
+	ILuint Clear = 256, End = 257, Next = 258, Size = 9, w, i;
+
+	Out.push_back(8);
+	Writer.Put(Clear, Size);
+	w = Pixels[0];
+	for (i = 1; i < Pixels.size(); i++) {
+		ILuint Key = (w << 8) | Pixels[i];
+		std::map<ILuint, ILuint>::iterator Found = Table.find(Key);
+		if (Found != Table.end()) {
+			w = Found->second;
+			continue;
+		}
+		Writer.Put(w, Size);
+		Table[Key] = Next++;
+		if (Next > (1U << Size) && Size < 12)
+			Size++;
+		if (Next == 4096) {
+			Writer.Put(Clear, Size);
+			Table.clear();
+			Next = 258;
+			Size = 9;
+		}
+		w = Pixels[i];
+	}
+	Writer.Put(w, Size);
+	if (++Next > (1U << Size) && Size < 12)
+		Size++;
+	Writer.Put(End, Size);
+	Writer.Finish(Out);
+}
+
+
+static void PutShort(Bytes &Out, ILuint Value)
+{
+	Out.push_back((ILubyte)(Value & 0xFF));
+	Out.push_back((ILubyte)(Value >> 8));
+}
+
+
+// A GIF89a with a grey 256-colour global palette.  Every frame after the
+//  first keeps the previous one underneath it.
+static Bytes MakeGif(const Frame *Frames, ILuint NumFrames)
+{
+	static const ILuint Start[4] = { 0, 4, 2, 1 }, Step[4] = { 8, 8, 4, 2 };
+	Bytes Out, Pixels;
+	ILuint f, i, p, y;
+
+	Out.insert(Out.end(), (const ILubyte*)"GIF89a", (const ILubyte*)"GIF89a" + 6);
+	PutShort(Out, WIDTH);
+	PutShort(Out, HEIGHT);
+	Out.push_back(0xF7);
+	Out.push_back(0);
+	Out.push_back(0);
+	for (i = 0; i < 256; i++) {
+		Out.push_back((ILubyte)i);
+		Out.push_back((ILubyte)i);
+		Out.push_back((ILubyte)i);
+	}
+
+	for (f = 0; f < NumFrames; f++) {
+		const Frame &F = Frames[f];
+
+		// Graphics control extension: keep the old image, 10 ms.
+		const ILubyte Gce[] = { 0x21, 0xF9, 4, 1 << 2, 1, 0, 0, 0 };
+		Out.insert(Out.end(), Gce, Gce + sizeof(Gce));
+
+		Out.push_back(0x2C);
+		PutShort(Out, F.OffX);
+		PutShort(Out, F.OffY);
+		PutShort(Out, F.Width);
+		PutShort(Out, F.Height);
+		Out.push_back(F.Interlaced ? 0x40 : 0);
+
+		Pixels.clear();
+		for (p = 0; p < (F.Interlaced ? 4U : 1U); p++) {
+			for (y = F.Interlaced ? Start[p] : 0; y < F.Height; y += F.Interlaced ? Step[p] : 1) {
+				for (i = 0; i < F.Width; i++)
+					Pixels.push_back(Pixel(F.Seed, i, y));
+			}
+		}
+		Encode(Pixels, Out);
+	}
+
+	Out.push_back(0x3B);
+	return Out;
+}
+
+
+// What frame Num of Frames should look like, the first NumRows rows of it
+//  in file order at most.
+static Bytes Expected(const Frame *Frames, ILuint Num, ILuint NumRows)
+{
+	Bytes Image(WIDTH * HEIGHT, 0);
+	ILuint f, x, y;
+
+	for (f = 0; f <= Num; f++) {
+		const Frame &F = Frames[f];
+		for (y = 0; y < F.Height; y++) {
+			if (f == Num && !F.Interlaced && y >= NumRows)
+				break;
+			for (x = 0; x < F.Width; x++)
+				Image[(F.OffY + y) * WIDTH + F.OffX + x] = Pixel(F.Seed, x, y);
+		}
+	}
+
+	return Image;
+}
+
+
+// Loads Gif and compares the first NumImages images with Frames.  The last
+//  one is only compared up to LastRows rows.
+static int Check(ILcontext *context, const char *Name, const Bytes &Gif, const Frame *Frames,
+	ILuint NumImages, ILuint LastRows)
+{
+	ILuint Image, i;
+	int Failures = 0;
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilLoadL(context, IL_GIF, &Gif[0], (ILuint)Gif.size())) {
+		fprintf(stderr, "%s: load failed (error %04x)\n", Name, ilGetError(context));
+		ilDeleteImages(context, 1, &Image);
+		return 1;
+	}
+	if ((ILuint)ilGetInteger(context, IL_NUM_IMAGES) + 1 != NumImages) {
+		fprintf(stderr, "%s: %d images, expected %u\n", Name, ilGetInteger(context, IL_NUM_IMAGES) + 1, NumImages);
+		Failures++;
+	}
+
+	for (i = 0; i < NumImages && !Failures; i++) {
+		Bytes Want = Expected(Frames, i, i + 1 == NumImages ? LastRows : HEIGHT);
+		ILuint Rows = i + 1 == NumImages && !Frames[i].Interlaced ? Frames[i].OffY + LastRows : HEIGHT;
+
+		if (Rows > HEIGHT)
+			Rows = HEIGHT;
+
+		ilBindImage(context, Image);
+		ilActiveImage(context, i);
+		if (ilGetInteger(context, IL_IMAGE_WIDTH) != WIDTH || ilGetInteger(context, IL_IMAGE_HEIGHT) != HEIGHT
+			|| ilGetInteger(context, IL_IMAGE_FORMAT) != IL_COLOUR_INDEX) {
+			fprintf(stderr, "%s: image %u has the wrong size or format\n", Name, i);
+			Failures++;
+		}
+		else if (memcmp(ilGetData(context), &Want[0], Rows * WIDTH) != 0) {
+			fprintf(stderr, "%s: image %u differs\n", Name, i);
+			Failures++;
+		}
+	}
+
+	ilDeleteImages(context, 1, &Image);
+	return Failures;
+}
+
+
+int main()
+{
+	static const Frame Whole[] = {
+		{ 0, 0, WIDTH, HEIGHT, IL_TRUE, 0 },
+	};
+	static const Frame Anim[] = {
+		{ 0, 0, WIDTH, HEIGHT, IL_FALSE, 1 },
+		{ 7, 5, 40, 23, IL_TRUE, 2 },
+		{ 3, 11, 50, 21, IL_FALSE, 3 },
+	};
+	ILcontext *context = ilInit();
+	int Failures = 0;
+	Bytes Gif;
+
+	Gif = MakeGif(Whole, 1);
+	Failures += Check(context, "interlaced", Gif, Whole, 1, HEIGHT);
+
+	Gif = MakeGif(Anim, 3);
+	Failures += Check(context, "interlaced frame", Gif, Anim, 3, HEIGHT);
+
+	// Cut inside the last frame's data: the frames before it are whole, and
+	//  the last one has at least its first rows.
+	Bytes Cut(Gif.begin(), Gif.end() - 300);
+	Failures += Check(context, "truncated animation", Cut, Anim, 3, 2);
+
+	Gif = MakeGif(Anim, 1);
+	Bytes CutOne(Gif.begin(), Gif.end() - Gif.size() / 4);
+	Failures += Check(context, "truncated image", CutOne, Anim, 1, 2);
+
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
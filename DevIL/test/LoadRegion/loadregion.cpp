@@ -0,0 +1,229 @@
+// Saves images as TIFF, PNG, BMP, TGA and SGI files and raw data, loads
+//  rectangles of them with ilLoadRegionL and ilLoadDataRegion and checks each
+//  one against the same rectangle cut from a full load.  The rectangles take
+//  in the corners and edges, single pixels and the whole image, and ones that
+//  do not fit must fail with IL_INVALID_PARAM.
+
+#include <IL/il.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define WIDTH  203
+#define HEIGHT 150
+
+struct Case
+{
+	ILenum		Type, Format, DataType;
+	ILboolean	Interlaced;
+	const char	*Name;
+};
+
+static const Case Cases[] = {
+	{ IL_TIF, IL_RGB,       IL_UNSIGNED_BYTE,  IL_FALSE, "TIFF RGB"        },
+	{ IL_TIF, IL_RGBA,      IL_UNSIGNED_SHORT, IL_FALSE, "TIFF RGBA16"     },
+	{ IL_PNG, IL_RGB,       IL_UNSIGNED_BYTE,  IL_FALSE, "PNG RGB"         },
+	{ IL_PNG, IL_LUMINANCE, IL_UNSIGNED_SHORT, IL_FALSE, "PNG L16"         },
+	{ IL_PNG, IL_RGBA,      IL_UNSIGNED_BYTE,  IL_TRUE,  "PNG interlaced"  },  // Loaded whole and cropped
+	{ IL_BMP, IL_BGR,       IL_UNSIGNED_BYTE,  IL_FALSE, "BMP"             },
+	{ IL_BMP, IL_BGRA,      IL_UNSIGNED_BYTE,  IL_FALSE, "BMP BGRA"        },
+	{ IL_TGA, IL_BGRA,      IL_UNSIGNED_BYTE,  IL_FALSE, "TGA"             },
+	{ IL_SGI, IL_RGB,       IL_UNSIGNED_BYTE,  IL_FALSE, "SGI"             },
+};
+#define NUM_CASES (sizeof(Cases) / sizeof(Cases[0]))
+
+struct Rect
+{
+	ILuint	X, Y, Width, Height;
+};
+
+static const Rect Rects[] = {
+	{ 0, 0, WIDTH, HEIGHT }, { 0, 0, 1, 1 }, { WIDTH - 1, HEIGHT - 1, 1, 1 }, { 17, 23, 50, 40 },
+	{ 0, HEIGHT - 13, WIDTH, 13 }, { WIDTH - 31, 0, 31, HEIGHT }, { 101, 0, 1, HEIGHT }, { 3, 75, 199, 1 },
+};
+#define NUM_RECTS (sizeof(Rects) / sizeof(Rects[0]))
+
+static const Rect BadRects[] = {
+	{ 0, 0, 0, 10 }, { 0, 0, 10, 0 }, { 0, 0, WIDTH + 1, 1 }, { 0, 1, 1, HEIGHT }, { WIDTH, 0, 1, 1 },
+};
+#define NUM_BAD_RECTS (sizeof(BadRects) / sizeof(BadRects[0]))
+
+
+static ILuint Next(ILuint &Seed)
+{
+	Seed = Seed * 1664525 + 1013904223;
+	return Seed >> 8;
+}
+
+
+struct Loaded
+{
+	ILint	Width, Height, Format, Type, PixSize;
+	std::vector<ILubyte> Rows;  // Top row first, whatever the image's origin
+};
+
+static void Grab(ILcontext *context, Loaded &L)
+{
+	ILint	y, Bps;
+
+	L.Width = ilGetInteger(context, IL_IMAGE_WIDTH);
+	L.Height = ilGetInteger(context, IL_IMAGE_HEIGHT);
+	L.Format = ilGetInteger(context, IL_IMAGE_FORMAT);
+	L.Type = ilGetInteger(context, IL_IMAGE_TYPE);
+	L.PixSize = ilGetInteger(context, IL_IMAGE_BYTES_PER_PIXEL);
+	Bps = L.Width * L.PixSize;
+	L.Rows.resize(Bps * L.Height);
+	for (y = 0; y < L.Height; y++) {
+		ILint Row = ilGetInteger(context, IL_IMAGE_ORIGIN) == IL_ORIGIN_LOWER_LEFT ? L.Height - 1 - y : y;
+		memcpy(&L.Rows[y * Bps], ilGetData(context) + Row * Bps, Bps);
+	}
+}
+
+
+// Checks that Part is the rectangle R of Whole.
+static bool SameAsCrop(const Loaded &Whole, const Loaded &Part, const Rect &R)
+{
+	ILuint y, Bps = R.Width * Whole.PixSize;
+
+	if ((ILuint)Part.Width != R.Width || (ILuint)Part.Height != R.Height || Part.Format != Whole.Format ||
+		Part.Type != Whole.Type || Part.PixSize != Whole.PixSize)
+		return false;
+	for (y = 0; y < R.Height; y++) {
+		if (memcmp(&Part.Rows[y * Bps], &Whole.Rows[((R.Y + y) * Whole.Width + R.X) * Whole.PixSize], Bps) != 0)
+			return false;
+	}
+	return true;
+}
+
+
+static int RunCase(ILcontext *context, const Case &C)
+{
+	ILuint	Seed = C.Type + C.Format, Image, Bpp = ilGetBppFormat(C.Format), i;
+	ILuint	Bpc = C.DataType == IL_UNSIGNED_SHORT ? 2 : 1;
+	ILsizei	Size;
+	void	*Lump;
+	Loaded	Whole, Part;
+	int		Failed = 0;
+
+	std::vector<ILubyte> Src(WIDTH * HEIGHT * Bpp * Bpc);
+	for (i = 0; i < Src.size(); i++)
+		Src[i] = (ILubyte)(i / (Bpp * Bpc) % WIDTH * 3 + i / (Bpp * Bpc * WIDTH) * 5 + Next(Seed) % 16);
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	ilTexImage(context, WIDTH, HEIGHT, 1, (ILubyte)Bpp, C.Format, C.DataType, &Src[0]);
+	ilSetInteger(context, IL_PNG_INTERLACE, C.Interlaced);
+	Lump = ilSaveToMemory(context, C.Type, &Size);
+	ilSetInteger(context, IL_PNG_INTERLACE, IL_FALSE);
+	ilDeleteImages(context, 1, &Image);
+	if (Lump == NULL) {
+		if (ilGetError(context) == IL_INVALID_ENUM) {  // Built without this format
+			fprintf(stderr, "%s: not supported, skipped\n", C.Name);
+			return 0;
+		}
+		fprintf(stderr, "%s: could not save the image\n", C.Name);
+		return 1;
+	}
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilLoadL(context, C.Type, Lump, (ILuint)Size) || ilGetInteger(context, IL_IMAGE_WIDTH) != WIDTH ||
+		ilGetInteger(context, IL_IMAGE_HEIGHT) != HEIGHT) {
+		fprintf(stderr, "%s: ilLoadL failed\n", C.Name);
+		Failed = 1;
+	}
+	Grab(context, Whole);
+
+	for (i = 0; !Failed && i < NUM_RECTS; i++) {
+		const Rect &R = Rects[i];
+		if (!ilLoadRegionL(context, C.Type, Lump, (ILuint)Size, R.X, R.Y, R.Width, R.Height)) {
+			fprintf(stderr, "%s: could not load %ux%u at %u,%u\n", C.Name, R.Width, R.Height, R.X, R.Y);
+			Failed = 1;
+			break;
+		}
+		Grab(context, Part);
+		if (!SameAsCrop(Whole, Part, R)) {
+			fprintf(stderr, "%s: %ux%u at %u,%u differs from the full image\n", C.Name, R.Width, R.Height, R.X, R.Y);
+			Failed = 1;
+		}
+	}
+
+	for (i = 0; !Failed && i < NUM_BAD_RECTS; i++) {
+		const Rect &R = BadRects[i];
+		ilGetError(context);
+		if (ilLoadRegionL(context, C.Type, Lump, (ILuint)Size, R.X, R.Y, R.Width, R.Height) ||
+			ilGetError(context) != IL_INVALID_PARAM) {
+			fprintf(stderr, "%s: %ux%u at %u,%u did not fail with IL_INVALID_PARAM\n", C.Name, R.Width, R.Height, R.X, R.Y);
+			Failed = 1;
+		}
+	}
+
+	ilDeleteImages(context, 1, &Image);
+	ifree(context, Lump);
+	return Failed;
+}
+
+
+// Raw data has no header, so ilLoadDataRegion works out where each row is.
+static int RunRawData(ILcontext *context)
+{
+	const char	*FileName = "loadregion.raw";
+	const ILuint Bpp = 3;
+	ILuint	Seed = 9, Image, i;
+	Loaded	Whole, Part;
+	FILE	*File;
+	int		Failed = 0;
+
+	std::vector<ILubyte> Src(WIDTH * HEIGHT * Bpp);
+	for (i = 0; i < Src.size(); i++)
+		Src[i] = (ILubyte)Next(Seed);
+	File = fopen(FileName, "wb");
+	if (File == NULL || fwrite(&Src[0], 1, Src.size(), File) != Src.size()) {
+		fprintf(stderr, "Raw data: could not write %s\n", FileName);
+		if (File)
+			fclose(File);
+		return 1;
+	}
+	fclose(File);
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilLoadData(context, FileName, WIDTH, HEIGHT, 1, (ILubyte)Bpp)) {
+		fprintf(stderr, "Raw data: ilLoadData failed\n");
+		Failed = 1;
+	}
+	Grab(context, Whole);
+
+	for (i = 0; !Failed && i < NUM_RECTS; i++) {
+		const Rect &R = Rects[i];
+		if (!ilLoadDataRegion(context, FileName, WIDTH, HEIGHT, (ILubyte)Bpp, R.X, R.Y, R.Width, R.Height)) {
+			fprintf(stderr, "Raw data: could not load %ux%u at %u,%u\n", R.Width, R.Height, R.X, R.Y);
+			Failed = 1;
+			break;
+		}
+		Grab(context, Part);
+		if (!SameAsCrop(Whole, Part, R)) {
+			fprintf(stderr, "Raw data: %ux%u at %u,%u differs from the full image\n", R.Width, R.Height, R.X, R.Y);
+			Failed = 1;
+		}
+	}
+
+	ilDeleteImages(context, 1, &Image);
+	remove(FileName);
+	return Failed;
+}
+
+
+int main()
+{
+	ILcontext	*context = ilInit();
+	int			Failures = 0;
+	ILuint		i;
+
+	for (i = 0; i < NUM_CASES; i++)
+		Failures += RunCase(context, Cases[i]);
+	Failures += RunRawData(context);
+
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,243 @@
+// Saves images as BMP, HDR, JPEG, PNG, TIFF and TGA files and gives them to
+//  ilLoadRowsL and ilLoadRows, checking that the rows come top row first, a
+//  band at a time and in order, and put together match ilLoadL of the same
+//  file, as loaded and converted to other formats and types.  Interlaced PNG
+//  and TGA files are loaded whole first, and a Proc that gives up must stop
+//  the load with IL_INTERNAL_ERROR.  The bound image must not change.
+
+#include <IL/il.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define WIDTH  800
+#define HEIGHT 1400  // More than one band of rows for each format
+
+struct Case
+{
+	ILenum		Type, Format, DataType;
+	ILboolean	Interlaced;
+	const char	*FileName;
+};
+
+static const Case Cases[] = {
+	{ IL_BMP, IL_BGR,       IL_UNSIGNED_BYTE,  IL_FALSE, "loadrows.bmp"   },
+	{ IL_BMP, IL_BGRA,      IL_UNSIGNED_BYTE,  IL_FALSE, "loadrows.bmp"   },
+	{ IL_HDR, IL_RGB,       IL_FLOAT,          IL_FALSE, "loadrows.hdr"   },
+	{ IL_JPG, IL_RGB,       IL_UNSIGNED_BYTE,  IL_FALSE, "loadrows.jpg"   },
+	{ IL_JPG, IL_LUMINANCE, IL_UNSIGNED_BYTE,  IL_FALSE, "loadrows.jpg"   },
+	{ IL_PNG, IL_RGBA,      IL_UNSIGNED_BYTE,  IL_FALSE, "loadrows.png"   },
+	{ IL_PNG, IL_LUMINANCE, IL_UNSIGNED_SHORT, IL_FALSE, "loadrows.png"   },
+	{ IL_PNG, IL_RGB,       IL_UNSIGNED_BYTE,  IL_TRUE,  "loadrows.png"   },  // Loaded whole
+	{ IL_TIF, IL_RGB,       IL_UNSIGNED_BYTE,  IL_FALSE, "loadrows.tif"   },
+	{ IL_TIF, IL_RGBA,      IL_UNSIGNED_SHORT, IL_FALSE, "loadrows.tif"   },
+	{ IL_TGA, IL_BGRA,      IL_UNSIGNED_BYTE,  IL_FALSE, "loadrows.tga"   },  // Loaded whole
+};
+#define NUM_CASES (sizeof(Cases) / sizeof(Cases[0]))
+
+struct Conversion
+{
+	ILenum	Format, Type;  // 0 for what ilLoad gives
+};
+
+static const Conversion Conversions[] = {
+	{ 0, 0 }, { IL_RGBA, IL_UNSIGNED_BYTE }, { IL_LUMINANCE, IL_FLOAT }, { IL_BGR, IL_UNSIGNED_SHORT },
+};
+#define NUM_CONVERSIONS (sizeof(Conversions) / sizeof(Conversions[0]))
+
+
+static ILuint Next(ILuint &Seed)
+{
+	Seed = Seed * 1664525 + 1013904223;
+	return Seed >> 8;
+}
+
+
+// What Proc has been given so far
+struct Collected
+{
+	ILimageinfo	Info;
+	ILuint		Calls, Rows, Bps, StopAfter;  // StopAfter 0 takes every band
+	bool		Bad;
+	std::vector<ILubyte> Data;
+};
+
+static ILboolean ILAPIENTRY Proc(void *UserData, const ILimageinfo *Info, ILuint FirstRow, ILuint NumRows, const void *Data)
+{
+	Collected *C = (Collected*)UserData;
+
+	if (C->Calls == 0) {
+		C->Info = *Info;
+		C->Bps = Info->Width * ilGetBppFormat(Info->Format) * ilGetBpcType(Info->Type);
+	}
+	else if (memcmp(&C->Info, Info, sizeof(ILimageinfo)) != 0)
+		C->Bad = true;
+	if (FirstRow != C->Rows || NumRows == 0 || FirstRow + NumRows > Info->Height)
+		C->Bad = true;
+	else {
+		C->Data.insert(C->Data.end(), (const ILubyte*)Data, (const ILubyte*)Data + (ILsizei)NumRows * C->Bps);
+		C->Rows += NumRows;
+	}
+	C->Calls++;
+	return C->StopAfter == 0 || C->Calls < C->StopAfter;
+}
+
+
+// The bound image's pixels, top row first
+static std::vector<ILubyte> TopDown(ILcontext *context)
+{
+	ILint	y, Height = ilGetInteger(context, IL_IMAGE_HEIGHT);
+	ILint	Bps = ilGetInteger(context, IL_IMAGE_WIDTH) * ilGetInteger(context, IL_IMAGE_BYTES_PER_PIXEL);
+	std::vector<ILubyte> Rows((ILsizei)Bps * Height);
+
+	for (y = 0; y < Height; y++) {
+		ILint Row = ilGetInteger(context, IL_IMAGE_ORIGIN) == IL_ORIGIN_LOWER_LEFT ? Height - 1 - y : y;
+		memcpy(&Rows[(ILsizei)y * Bps], ilGetData(context) + (ILsizei)Row * Bps, Bps);
+	}
+	return Rows;
+}
+
+
+static bool CheckRows(const Collected &C, ILenum Format, ILenum Type, const std::vector<ILubyte> &Expected, const char *Name)
+{
+	if (C.Bad || C.Info.Width != WIDTH || C.Info.Height != HEIGHT || C.Info.Depth != 1 ||
+		C.Info.Format != Format || C.Info.Type != Type) {
+		fprintf(stderr, "%s: rows given out of order or with the wrong size or format\n", Name);
+		return false;
+	}
+	if (C.Rows != HEIGHT || C.Calls < 2 || C.Data != Expected) {
+		fprintf(stderr, "%s: %u rows in %u calls differ from ilLoadL\n", Name, C.Rows, C.Calls);
+		return false;
+	}
+	return true;
+}
+
+
+static int RunCase(ILcontext *context, const Case &C, ILuint Bound)
+{
+	ILuint	Seed = C.Type + C.Format, Image, Bpp = ilGetBppFormat(C.Format), Bpc = ilGetBpcType(C.DataType), i;
+	ILsizei	Size;
+	void	*Lump;
+	char	Name[64];
+	FILE	*File;
+	int		Failed = 0;
+
+	std::vector<ILubyte> Src((ILsizei)WIDTH * HEIGHT * Bpp * Bpc);
+	if (C.DataType == IL_FLOAT) {
+		ILfloat *f = (ILfloat*)&Src[0];
+		for (i = 0; i < WIDTH * HEIGHT * Bpp; i++)
+			f[i] = (i / Bpp % WIDTH + i / (Bpp * WIDTH) * 2 + (i % Bpp) * 100) / 256.0f + (Next(Seed) % 16) / 1024.0f;
+	}
+	else {
+		for (i = 0; i < Src.size(); i++)
+			Src[i] = (ILubyte)(i / (Bpp * Bpc) % WIDTH + i / (Bpp * Bpc * WIDTH) * 3 + (i % Bpp) * 50 + Next(Seed) % 8);
+	}
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	ilTexImage(context, WIDTH, HEIGHT, 1, (ILubyte)Bpp, C.Format, C.DataType, &Src[0]);
+	ilSetInteger(context, IL_PNG_INTERLACE, C.Interlaced);
+	Lump = ilSaveToMemory(context, C.Type, &Size);
+	ilSetInteger(context, IL_PNG_INTERLACE, IL_FALSE);
+	ilDeleteImages(context, 1, &Image);
+	ilBindImage(context, Bound);
+	snprintf(Name, sizeof(Name), "%s %x/%x%s", C.FileName, C.Format, C.DataType, C.Interlaced ? " interlaced" : "");
+	if (Lump == NULL) {
+		if (ilGetError(context) == IL_INVALID_ENUM) {  // Built without this format
+			fprintf(stderr, "%s: not supported, skipped\n", Name);
+			return 0;
+		}
+		fprintf(stderr, "%s: could not save the image\n", Name);
+		return 1;
+	}
+
+	for (i = 0; !Failed && i < NUM_CONVERSIONS; i++) {
+		const Conversion &Conv = Conversions[i];
+		std::vector<ILubyte> Expected;
+		ILenum	Format, Type;
+		Collected Got = Collected();
+
+		ilGenImages(context, 1, &Image);
+		ilBindImage(context, Image);
+		if (!ilLoadL(context, C.Type, Lump, (ILuint)Size) ||
+			(Conv.Format != 0 && !ilConvertImage(context, Conv.Format, Conv.Type))) {
+			fprintf(stderr, "%s: ilLoadL failed\n", Name);
+			Failed = 1;
+		}
+		Format = ilGetInteger(context, IL_IMAGE_FORMAT);
+		Type = ilGetInteger(context, IL_IMAGE_TYPE);
+		Expected = TopDown(context);
+		ilDeleteImages(context, 1, &Image);
+		ilBindImage(context, Bound);
+		if (Failed)
+			break;
+
+		if (!ilLoadRowsL(context, C.Type, Lump, (ILuint)Size, Conv.Format, Conv.Type, Proc, &Got)) {
+			fprintf(stderr, "%s: ilLoadRowsL to %x/%x failed (%x)\n", Name, Conv.Format, Conv.Type, ilGetError(context));
+			Failed = 1;
+		}
+		else if (!CheckRows(Got, Format, Type, Expected, Name))
+			Failed = 1;
+
+		// From a file, working out the type as ilLoad does
+		if (!Failed && i == 0) {
+			Got = Collected();
+			File = fopen(C.FileName, "wb");
+			if (File == NULL || fwrite(Lump, 1, Size, File) != (size_t)Size) {
+				fprintf(stderr, "%s: could not write the file\n", Name);
+				Failed = 1;
+			}
+			if (File)
+				fclose(File);
+			if (!Failed && !ilLoadRows(context, IL_TYPE_UNKNOWN, C.FileName, 0, 0, Proc, &Got)) {
+				fprintf(stderr, "%s: ilLoadRows failed (%x)\n", Name, ilGetError(context));
+				Failed = 1;
+			}
+			else if (!Failed && !CheckRows(Got, Format, Type, Expected, Name))
+				Failed = 1;
+			remove(C.FileName);
+		}
+	}
+
+	// Giving up after the first band
+	if (!Failed) {
+		Collected Got = Collected();
+
+		Got.StopAfter = 1;
+		ilGetError(context);
+		if (ilLoadRowsL(context, C.Type, Lump, (ILuint)Size, 0, 0, Proc, &Got) ||
+			ilGetError(context) != IL_INTERNAL_ERROR || Got.Calls != 1) {
+			fprintf(stderr, "%s: stopping after %u calls did not fail with IL_INTERNAL_ERROR\n", Name, Got.Calls);
+			Failed = 1;
+		}
+	}
+
+	if (ilGetInteger(context, IL_CUR_IMAGE) != (ILint)Bound || ilGetInteger(context, IL_IMAGE_WIDTH) != 3) {
+		fprintf(stderr, "%s: the bound image changed\n", Name);
+		Failed = 1;
+	}
+
+	ifree(context, Lump);
+	return Failed;
+}
+
+
+int main()
+{
+	ILcontext	*context = ilInit();
+	ILubyte		Pixels[3 * 2 * 3] = { 0 };
+	int			Failures = 0;
+	ILuint		Bound, i;
+
+	// Rows must be loaded without touching this.
+	ilGenImages(context, 1, &Bound);
+	ilBindImage(context, Bound);
+	ilTexImage(context, 3, 2, 1, 3, IL_RGB, IL_UNSIGNED_BYTE, Pixels);
+
+	for (i = 0; i < NUM_CASES; i++)
+		Failures += RunCase(context, Cases[i], Bound);
+
+	ilDeleteImages(context, 1, &Bound);
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
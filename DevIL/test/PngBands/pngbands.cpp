@@ -0,0 +1,127 @@
+// Saves PNGs large enough to be filtered and compressed in bands on several
+//  threads, with every filter, a range of zlib levels and strategies and
+//  IL_PNG_FAST, loads them back and checks the pixels are unchanged.  A small
+//  image, written in one go, checks the same settings there.
+
+#include <IL/il.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+struct Picture
+{
+	ILuint	Width, Height;
+	ILenum	Format, Type;
+};
+
+static const Picture Pictures[] = {
+	{ 1000, 400, IL_RGBA, IL_UNSIGNED_BYTE  },  // 1.6 MB
+	{ 700,  401, IL_RGB,  IL_UNSIGNED_SHORT },  // 16-bit values are swapped to big-endian
+	{ 999,  300, IL_BGRA, IL_UNSIGNED_BYTE  },  // Converted to RGBA first
+	{ 61,   37,  IL_RGB,  IL_UNSIGNED_BYTE  },  // Below the band size
+};
+#define NUM_PICTURES (sizeof(Pictures) / sizeof(Pictures[0]))
+
+struct Setting
+{
+	ILenum	Filter, Strategy;
+	ILint	Level;
+	bool	Fast;
+};
+
+static const Setting Settings[] = {
+	{ IL_PNG_FILTER_NONE,     IL_PNG_STRATEGY_DEFAULT,  6, false },
+	{ IL_PNG_FILTER_SUB,      IL_PNG_STRATEGY_DEFAULT,  6, false },
+	{ IL_PNG_FILTER_UP,       IL_PNG_STRATEGY_DEFAULT,  6, false },
+	{ IL_PNG_FILTER_AVG,      IL_PNG_STRATEGY_DEFAULT,  6, false },
+	{ IL_PNG_FILTER_PAETH,    IL_PNG_STRATEGY_DEFAULT,  6, false },
+	{ IL_PNG_FILTER_ADAPTIVE, IL_PNG_STRATEGY_DEFAULT,  0, false },
+	{ IL_PNG_FILTER_ADAPTIVE, IL_PNG_STRATEGY_DEFAULT,  1, false },
+	{ IL_PNG_FILTER_ADAPTIVE, IL_PNG_STRATEGY_DEFAULT,  9, false },
+	{ IL_PNG_FILTER_ADAPTIVE, IL_PNG_STRATEGY_FILTERED, 6, false },
+	{ IL_PNG_FILTER_ADAPTIVE, IL_PNG_STRATEGY_HUFFMAN,  6, false },
+	{ IL_PNG_FILTER_ADAPTIVE, IL_PNG_STRATEGY_RLE,      6, false },
+	{ IL_PNG_FILTER_ADAPTIVE, IL_PNG_STRATEGY_DEFAULT,  6, true  },
+};
+#define NUM_SETTINGS (sizeof(Settings) / sizeof(Settings[0]))
+
+
+static ILuint Next(ILuint &Seed)
+{
+	Seed = Seed * 1664525 + 1013904223;
+	return Seed >> 8;
+}
+
+
+static int RunCase(ILcontext *context, const Picture &P, const Setting &S, const std::vector<ILubyte> &Src)
+{
+	ILuint	Image;
+	ILsizei	Size;
+	void	*Lump;
+	int		Failed = 0;
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	ilTexImage(context, P.Width, P.Height, 1, (ILubyte)ilGetBppFormat(P.Format), P.Format, P.Type, (void*)&Src[0]);
+	ilGetCurImage(context)->Origin = IL_ORIGIN_UPPER_LEFT;
+
+	ilSetInteger(context, IL_PNG_FILTER, S.Filter);
+	ilSetInteger(context, IL_PNG_STRATEGY, S.Strategy);
+	ilSetInteger(context, IL_PNG_COMPRESSION, S.Level);
+	if (S.Fast)
+		ilEnable(context, IL_PNG_FAST);
+	Lump = ilSaveToMemory(context, IL_PNG, &Size);
+	ilDisable(context, IL_PNG_FAST);
+	ilDeleteImages(context, 1, &Image);
+	if (Lump == NULL) {
+		fprintf(stderr, "%ux%u %x/%x, filter %x level %d: could not save\n", P.Width, P.Height, P.Format, P.Type, S.Filter, S.Level);
+		return 1;
+	}
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilLoadL(context, IL_PNG, Lump, (ILuint)Size) || !ilConvertImage(context, P.Format, P.Type) ||
+		(ILuint)ilGetInteger(context, IL_IMAGE_WIDTH) != P.Width || (ILuint)ilGetInteger(context, IL_IMAGE_HEIGHT) != P.Height ||
+		memcmp(ilGetData(context), &Src[0], Src.size()) != 0) {
+		fprintf(stderr, "%ux%u %x/%x, filter %x strategy %x level %d%s: pixels differ after loading\n", P.Width, P.Height,
+			P.Format, P.Type, S.Filter, S.Strategy, S.Level, S.Fast ? " fast" : "");
+		Failed = 1;
+	}
+	ilDeleteImages(context, 1, &Image);
+	ifree(context, Lump);
+	return Failed;
+}
+
+
+int main()
+{
+	ILcontext	*context = ilInit();
+	int			Failures = 0;
+	ILuint		p, s, i, Seed = 5, Bpp, Bpc;
+
+	ilEnable(context, IL_ORIGIN_SET);
+	ilOriginFunc(context, IL_ORIGIN_UPPER_LEFT);
+
+	for (p = 0; p < NUM_PICTURES; p++) {
+		const Picture &P = Pictures[p];
+		Bpp = ilGetBppFormat(P.Format);
+		Bpc = P.Type == IL_UNSIGNED_SHORT ? 2 : 1;
+
+		// Gradients with noise and some flat runs, so each filter wins somewhere
+		std::vector<ILubyte> Src(P.Width * P.Height * Bpp * Bpc);
+		for (i = 0; i < Src.size(); i++) {
+			ILuint x = (i / (Bpp * Bpc)) % P.Width, y = i / (Bpp * Bpc) / P.Width;
+			if ((x / 64 + y / 32) % 3 == 0)
+				Src[i] = (ILubyte)(y * 7);
+			else
+				Src[i] = (ILubyte)(x * (i % Bpp + 1) + y * 2 + Next(Seed) % 6);
+		}
+
+		for (s = 0; s < NUM_SETTINGS; s++)
+			Failures += RunCase(context, P, Settings[s], Src);
+	}
+
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
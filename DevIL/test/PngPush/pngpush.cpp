@@ -0,0 +1,181 @@
+// Saves PNGs of several formats, plain and interlaced, and pushes each one to
+//  ilPushData in chunks from a byte at a time up to the whole file.  The
+//  result must match ilLoadL of the same file, IL_PUSH_PASSES must count up
+//  to the number of passes, and a file cut short must fail in ilPushEnd
+//  while keeping the rows decoded so far.
+
+#include <IL/il.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define WIDTH  67
+#define HEIGHT 45
+
+struct Case
+{
+	ILenum		Format, Type;
+	ILboolean	Interlaced;
+};
+
+static const Case Cases[] = {
+	{ IL_RGBA,      IL_UNSIGNED_BYTE,  IL_FALSE },
+	{ IL_RGBA,      IL_UNSIGNED_BYTE,  IL_TRUE  },
+	{ IL_RGB,       IL_UNSIGNED_SHORT, IL_FALSE },
+	{ IL_RGB,       IL_UNSIGNED_SHORT, IL_TRUE  },
+	{ IL_LUMINANCE, IL_UNSIGNED_BYTE,  IL_FALSE },
+	{ IL_LUMINANCE, IL_UNSIGNED_BYTE,  IL_TRUE  },
+};
+#define NUM_CASES (sizeof(Cases) / sizeof(Cases[0]))
+
+static const ILuint Chunks[] = { 1, 13, 256, 0 };  // 0 is the whole file at once
+
+
+static ILuint Next(ILuint &Seed)
+{
+	Seed = Seed * 1664525 + 1013904223;
+	return Seed >> 8;
+}
+
+
+struct Loaded
+{
+	ILint	Width, Height, Format, Type, Origin;
+	std::vector<ILubyte> Data;
+};
+
+static void Grab(ILcontext *context, Loaded &L)
+{
+	L.Width = ilGetInteger(context, IL_IMAGE_WIDTH);
+	L.Height = ilGetInteger(context, IL_IMAGE_HEIGHT);
+	L.Format = ilGetInteger(context, IL_IMAGE_FORMAT);
+	L.Type = ilGetInteger(context, IL_IMAGE_TYPE);
+	L.Origin = ilGetInteger(context, IL_IMAGE_ORIGIN);
+	L.Data.assign(ilGetData(context), ilGetData(context) + ilGetInteger(context, IL_IMAGE_SIZE_OF_DATA));
+}
+
+
+// Pushes Size bytes of Lump Chunk bytes at a time into a new image.
+static bool Push(ILcontext *context, const ILubyte *Lump, ILuint Size, ILuint Chunk, bool Interlaced, Loaded &L, const char *Name)
+{
+	ILuint	Image, Pos, Num;
+	ILint	Passes, LastPasses = 0;
+	bool	Ok;
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	Ok = ilPushBegin(context, IL_PNG) != IL_FALSE;
+	for (Pos = 0; Ok && Pos < Size; Pos += Num) {
+		Num = Chunk == 0 ? Size : IL_MIN(Chunk, Size - Pos);
+		Ok = ilPushData(context, Lump + Pos, Num) != IL_FALSE;
+		Passes = ilGetInteger(context, IL_PUSH_PASSES);
+		if (Passes < LastPasses || Passes > (Interlaced ? 7 : 1)) {
+			fprintf(stderr, "%s: IL_PUSH_PASSES went from %d to %d\n", Name, LastPasses, Passes);
+			Ok = false;
+		}
+		LastPasses = Passes;
+	}
+	Grab(context, L);
+	if (!ilPushEnd(context))
+		Ok = false;
+	if (Ok && LastPasses != (Interlaced ? 7 : 1)) {
+		fprintf(stderr, "%s: finished after %d passes\n", Name, LastPasses);
+		Ok = false;
+	}
+	ilDeleteImages(context, 1, &Image);
+	return Ok;
+}
+
+
+static int RunCase(ILcontext *context, const Case &C)
+{
+	char	Name[64];
+	ILuint	Seed = C.Format + C.Type, Image, Bpp = ilGetBppFormat(C.Format), i, c;
+	ILuint	Bpc = C.Type == IL_UNSIGNED_SHORT ? 2 : 1;
+	ILsizei	Size;
+	ILubyte	*Lump;
+	Loaded	Whole, Pushed;
+	int		Failed = 0;
+
+	snprintf(Name, sizeof(Name), "%x/%x%s", C.Format, C.Type, C.Interlaced ? " interlaced" : "");
+
+	// Smooth enough for the filters to matter, noisy enough to need several
+	//  zlib blocks
+	std::vector<ILubyte> Src(WIDTH * HEIGHT * Bpp * Bpc);
+	for (i = 0; i < WIDTH * HEIGHT; i++) {
+		for (c = 0; c < Bpp * Bpc; c++)
+			Src[i * Bpp * Bpc + c] = (ILubyte)((i % WIDTH) * (c + 1) + (i / WIDTH) * 3 + Next(Seed) % 5);
+	}
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	ilTexImage(context, WIDTH, HEIGHT, 1, (ILubyte)Bpp, C.Format, C.Type, &Src[0]);
+	ilSetInteger(context, IL_PNG_INTERLACE, C.Interlaced);
+	Lump = (ILubyte*)ilSaveToMemory(context, IL_PNG, &Size);
+	ilSetInteger(context, IL_PNG_INTERLACE, IL_FALSE);
+	ilDeleteImages(context, 1, &Image);
+	if (Lump == NULL) {
+		fprintf(stderr, "%s: could not save the PNG\n", Name);
+		return 1;
+	}
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilLoadL(context, IL_PNG, Lump, (ILuint)Size)) {
+		fprintf(stderr, "%s: ilLoadL failed\n", Name);
+		Failed = 1;
+	}
+	Grab(context, Whole);
+	ilDeleteImages(context, 1, &Image);
+
+	for (i = 0; !Failed && i < sizeof(Chunks) / sizeof(Chunks[0]); i++) {
+		if (!Push(context, Lump, (ILuint)Size, Chunks[i], C.Interlaced != IL_FALSE, Pushed, Name)) {
+			fprintf(stderr, "%s: pushing %u bytes at a time failed\n", Name, Chunks[i]);
+			Failed = 1;
+		}
+		else if (Pushed.Width != Whole.Width || Pushed.Height != Whole.Height || Pushed.Format != Whole.Format ||
+			Pushed.Type != Whole.Type || Pushed.Origin != Whole.Origin || Pushed.Data != Whole.Data) {
+			fprintf(stderr, "%s: pushing %u bytes at a time differs from ilLoadL\n", Name, Chunks[i]);
+			Failed = 1;
+		}
+	}
+
+	// Cut short: the rows reached must already be there.
+	if (!Failed && !C.Interlaced) {
+		ILint Rows, Bps = (ILint)Whole.Data.size() / Whole.Height;
+
+		ilGenImages(context, 1, &Image);
+		ilBindImage(context, Image);
+		ilPushBegin(context, IL_PNG);
+		ilPushData(context, Lump, (ILuint)Size * 2 / 3);
+		Rows = ilGetInteger(context, IL_PUSH_ROWS);
+		Grab(context, Pushed);
+		if (ilPushEnd(context) || ilGetInteger(context, IL_IMAGE_WIDTH) != WIDTH) {
+			fprintf(stderr, "%s: a file cut short did not fail\n", Name);
+			Failed = 1;
+		}
+		else if (Rows <= 0 || Rows >= HEIGHT || Whole.Origin != IL_ORIGIN_UPPER_LEFT ||
+			memcmp(&Pushed.Data[0], &Whole.Data[0], Rows * Bps) != 0) {
+			fprintf(stderr, "%s: the %d rows pushed so far are wrong\n", Name, Rows);
+			Failed = 1;
+		}
+		ilDeleteImages(context, 1, &Image);
+	}
+
+	ifree(context, Lump);
+	return Failed;
+}
+
+
+int main()
+{
+	ILcontext	*context = ilInit();
+	int			Failures = 0;
+	ILuint		i;
+
+	for (i = 0; i < NUM_CASES; i++)
+		Failures += RunCase(context, Cases[i]);
+
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,187 @@
+// Saves the same picture with ilSaveRows and with ilSaveImage, loads both
+//  files back and checks they hold the same pixels, and the source pixels for
+//  the lossless formats.  The picture mixes runs with noise so that the RLE
+//  savers write run and raw packets, and it is tall enough to be handed to
+//  ilSaveRows in more than one band.
+
+#include <IL/il.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define WIDTH  301
+#define HEIGHT 900
+
+struct Case
+{
+	ILenum		Type;
+	const char	*Ext;
+	ILenum		Format;     // Format and type of the rows
+	ILenum		DataType;
+	ILenum		Mode;       // Integer state set to IL_TRUE for the save, or 0
+	ILboolean	Lossless;   // Compare with the source as well
+	ILboolean	HasAlpha;   // The file keeps the alpha channel
+};
+
+static const Case Cases[] = {
+	{ IL_TGA, "tga", IL_RGBA, IL_UNSIGNED_BYTE, 0,          IL_TRUE,  IL_TRUE  },
+	{ IL_TGA, "tga", IL_RGBA, IL_UNSIGNED_BYTE, IL_TGA_RLE, IL_TRUE,  IL_TRUE  },
+	{ IL_TGA, "tga", IL_RGB,  IL_UNSIGNED_BYTE, IL_TGA_RLE, IL_TRUE,  IL_FALSE },
+	{ IL_BMP, "bmp", IL_RGB,  IL_UNSIGNED_BYTE, 0,          IL_TRUE,  IL_FALSE },
+	{ IL_PNM, "ppm", IL_RGB,  IL_UNSIGNED_BYTE, 0,          IL_TRUE,  IL_FALSE },
+	{ IL_PNG, "png", IL_RGBA, IL_UNSIGNED_BYTE, 0,          IL_TRUE,  IL_TRUE  },
+	{ IL_JPG, "jpg", IL_RGB,  IL_UNSIGNED_BYTE, 0,          IL_FALSE, IL_FALSE },
+	{ IL_HDR, "hdr", IL_RGB,  IL_FLOAT,         0,          IL_FALSE, IL_FALSE },
+};
+#define NUM_CASES (sizeof(Cases) / sizeof(Cases[0]))
+
+
+static ILubyte Channel(ILuint x, ILuint y, ILuint c)
+{
+	if ((x / 9) % 3 == 0)  // Noise
+		return (ILubyte)((x * 131 + y * 71 + c * 29 + ((x * y) >> 3)) * 2654435761u >> 24);
+	return (ILubyte)((x / 9) * 37 + (y / 4) * 13 + c * 80);  // Runs of up to 9 pixels
+}
+
+
+struct Source
+{
+	ILenum	Format, DataType;
+	ILuint	Calls;
+	ILuint	AbortAt;  // Row at which Fill gives up, or HEIGHT
+};
+
+static ILboolean ILAPIENTRY Fill(void *UserData, ILuint FirstRow, ILuint NumRows, void *Data)
+{
+	Source	*Src = (Source*)UserData;
+	ILuint	Bpp = Src->Format == IL_RGBA ? 4 : 3, x, y, c;
+
+	Src->Calls++;
+	if (FirstRow + NumRows > Src->AbortAt)
+		return IL_FALSE;
+
+	for (y = 0; y < NumRows; y++) {
+		for (x = 0; x < WIDTH; x++) {
+			for (c = 0; c < Bpp; c++) {
+				ILubyte v = Channel(x, FirstRow + y, c);
+				if (Src->DataType == IL_FLOAT)
+					((ILfloat*)Data)[(y * WIDTH + x) * Bpp + c] = v / 255.0f;
+				else
+					((ILubyte*)Data)[(y * WIDTH + x) * Bpp + c] = v;
+			}
+		}
+	}
+
+	return IL_TRUE;
+}
+
+
+// Loads FileName and returns its pixels as RGBA bytes, top row first.
+static bool LoadPixels(ILcontext *context, const char *FileName, std::vector<ILubyte> &Pixels)
+{
+	ILuint Image;
+	bool Ok;
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	Ok = ilLoadImage(context, FileName) && ilConvertImage(context, IL_RGBA, IL_UNSIGNED_BYTE) &&
+		ilGetInteger(context, IL_IMAGE_WIDTH) == WIDTH && ilGetInteger(context, IL_IMAGE_HEIGHT) == HEIGHT;
+	if (Ok)
+		Pixels.assign(ilGetData(context), ilGetData(context) + WIDTH * HEIGHT * 4);
+	ilDeleteImages(context, 1, &Image);
+	return Ok;
+}
+
+
+static int RunCase(ILcontext *context, const Case &C)
+{
+	char RowsName[64], ImageName[64];
+	std::vector<ILubyte> FromRows, FromImage;
+	Source Src = { C.Format, C.DataType, 0, HEIGHT };
+	ILuint Image, x, y, c;
+
+	snprintf(RowsName, sizeof(RowsName), "saverows_rows.%s", C.Ext);
+	snprintf(ImageName, sizeof(ImageName), "saverows_image.%s", C.Ext);
+	if (C.Mode != 0)
+		ilSetInteger(context, C.Mode, IL_TRUE);
+
+	if (!ilSaveRows(context, C.Type, RowsName, WIDTH, HEIGHT, C.Format, C.DataType, Fill, &Src)) {
+		fprintf(stderr, "%s: ilSaveRows failed with %x\n", RowsName, ilGetError(context));
+		return 1;
+	}
+
+	// The same pixels as a whole image
+	std::vector<ILubyte> Data(WIDTH * HEIGHT * 4 * sizeof(ILfloat));
+	Fill(&Src, 0, HEIGHT, &Data[0]);
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	ilTexImage(context, WIDTH, HEIGHT, 1, C.Format == IL_RGBA ? 4 : 3, C.Format, C.DataType, &Data[0]);
+	ilGetCurImage(context)->Origin = IL_ORIGIN_UPPER_LEFT;
+	if (!ilSaveImage(context, ImageName)) {
+		fprintf(stderr, "%s: ilSaveImage failed with %x\n", ImageName, ilGetError(context));
+		return 1;
+	}
+	ilDeleteImages(context, 1, &Image);
+	if (C.Mode != 0)
+		ilSetInteger(context, C.Mode, IL_FALSE);
+
+	if (!LoadPixels(context, RowsName, FromRows) || !LoadPixels(context, ImageName, FromImage)) {
+		fprintf(stderr, "%s: could not load the saved files\n", C.Ext);
+		return 1;
+	}
+	if (FromRows != FromImage) {
+		fprintf(stderr, "%s (mode %x): ilSaveRows and ilSaveImage files differ\n", C.Ext, C.Mode);
+		return 1;
+	}
+
+	if (!C.Lossless)
+		return 0;
+	for (y = 0; y < HEIGHT; y++) {
+		for (x = 0; x < WIDTH; x++) {
+			for (c = 0; c < 4; c++) {
+				ILubyte Expected = c < 3 || C.HasAlpha ? Channel(x, y, c) : 255;
+				if (FromRows[(y * WIDTH + x) * 4 + c] != Expected) {
+					fprintf(stderr, "%s (mode %x): pixel %u,%u channel %u is %u, expected %u\n",
+						C.Ext, C.Mode, x, y, c, FromRows[(y * WIDTH + x) * 4 + c], Expected);
+					return 1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+// A Proc that gives up must fail the save with IL_INTERNAL_ERROR.
+static int CheckAbort(ILcontext *context)
+{
+	Source Src = { IL_RGB, IL_UNSIGNED_BYTE, 0, HEIGHT / 2 };
+
+	if (ilSaveRows(context, IL_TGA, "saverows_abort.tga", WIDTH, HEIGHT, IL_RGB, IL_UNSIGNED_BYTE, Fill, &Src) ||
+		ilGetError(context) != IL_INTERNAL_ERROR) {
+		fprintf(stderr, "abandoned save did not fail with IL_INTERNAL_ERROR\n");
+		return 1;
+	}
+	return 0;
+}
+
+
+int main()
+{
+	ILcontext *context = ilInit();
+	int Failures = 0;
+	ILuint i;
+
+	ilEnable(context, IL_FILE_OVERWRITE);
+	ilEnable(context, IL_ORIGIN_SET);
+	ilOriginFunc(context, IL_ORIGIN_UPPER_LEFT);
+
+	for (i = 0; i < NUM_CASES; i++)
+		Failures += RunCase(context, Cases[i]);
+	Failures += CheckAbort(context);
+
+	ilShutDown(context);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+// Checks the byte conversions that ilConvertBuffer and ilConvertImage hand to
+//  the vectorised kernels against the scalar versions written out here.  The
+//  buffers run from 1 to 100 pixels and one longer, so both the vector loops
+//  and their tails are covered on whatever kernels the CPU picks.
+
+#include <IL/il.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define MAX_PIX 100
+#define LONG_PIX 4099
+
+static const ILfloat LumFactor[3] = { 0.212671f, 0.715160f, 0.072169f };
+
+
+static ILuint Next(ILuint &Seed)
+{
+	Seed = Seed * 1664525 + 1013904223;
+	return Seed >> 8;
+}
+
+
+static bool IsBgr(ILenum Format)
+{
+	return Format == IL_BGR || Format == IL_BGRA;
+}
+
+
+// What the scalar kernels give for a byte format change
+static void Reference(ILenum SrcFormat, ILenum DestFormat, const ILubyte *Src, ILubyte *Dest, ILuint NumPix)
+{
+	ILuint	SrcBpp = ilGetBppFormat(SrcFormat), DestBpp = ilGetBppFormat(DestFormat), i;
+	ILuint	R = IsBgr(SrcFormat) ? 2 : 0;
+	ILfloat	Resultf;
+
+	for (i = 0; i < NumPix; i++, Src += SrcBpp, Dest += DestBpp) {
+		if (DestFormat == IL_LUMINANCE) {
+			Resultf = Src[0] * LumFactor[R];
+			Resultf += Src[1] * LumFactor[1];
+			Resultf += Src[2] * LumFactor[2 - R];
+			Dest[0] = (ILubyte)Resultf;
+			continue;
+		}
+		if (IsBgr(SrcFormat) == IsBgr(DestFormat)) {
+			Dest[0] = Src[0];
+			Dest[2] = Src[2];
+		}
+		else {
+			Dest[0] = Src[2];
+			Dest[2] = Src[0];
+		}
+		Dest[1] = Src[1];
+		if (DestBpp == 4)
+			Dest[3] = SrcBpp == 4 ? Src[3] : 0xFF;
+	}
+}
+
+
+static int CheckFormats(ILcontext *context, ILenum SrcFormat, ILenum DestFormat, ILuint NumPix)
+{
+	ILuint	SrcBpp = ilGetBppFormat(SrcFormat), DestBpp = ilGetBppFormat(DestFormat);
+	ILuint	Seed = NumPix, Image, i;
+	ILubyte	*Conv;
+	int		Failed = 0;
+
+	std::vector<ILubyte> Src(NumPix * SrcBpp), Expected(NumPix * DestBpp);
+	for (i = 0; i < Src.size(); i++)
+		Src[i] = (ILubyte)Next(Seed);
+	Src[0] = 0xFF;  // White and black land on the ends of the range
+	Src[Src.size() - 1] = 0;
+	Reference(SrcFormat, DestFormat, &Src[0], &Expected[0], NumPix);
+
+	Conv = (ILubyte*)ilConvertBuffer(context, (ILuint)Src.size(), SrcFormat, DestFormat, IL_UNSIGNED_BYTE, IL_UNSIGNED_BYTE, NULL, &Src[0]);
+	if (Conv == NULL || memcmp(Conv, &Expected[0], Expected.size()) != 0) {
+		fprintf(stderr, "ilConvertBuffer %x -> %x, %u pixels: differs from the scalar version\n", SrcFormat, DestFormat, NumPix);
+		Failed = 1;
+	}
+	ifree(context, Conv);
+
+	// ilConvertImage goes through the kernels in place where the pixels do not grow
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilTexImage(context, NumPix, 1, 1, (ILubyte)SrcBpp, SrcFormat, IL_UNSIGNED_BYTE, &Src[0]) ||
+		!ilConvertImage(context, DestFormat, IL_UNSIGNED_BYTE) ||
+		memcmp(ilGetData(context), &Expected[0], Expected.size()) != 0) {
+		fprintf(stderr, "ilConvertImage %x -> %x, %u pixels: differs from the scalar version\n", SrcFormat, DestFormat, NumPix);
+		Failed = 1;
+	}
+	ilDeleteImages(context, 1, &Image);
+
+	return Failed;
+}
+
+
+// Byte <-> short and byte <-> float, as the scalar kernels do them
+static int CheckTypes(ILcontext *context, ILuint Num)
+{
+	ILuint	Seed = Num * 7, i;
+	int		Failed = 0;
+	void	*Conv;
+
+	std::vector<ILubyte> Bytes(Num), FromShorts(Num), FromFloats(Num);
+	std::vector<ILushort> Shorts(Num), ExpShorts(Num);
+	std::vector<ILfloat> Floats(Num), ExpFloats(Num);
+	for (i = 0; i < Num; i++) {
+		Bytes[i] = (ILubyte)Next(Seed);
+		Shorts[i] = (ILushort)Next(Seed);
+		Floats[i] = (ILint)(Next(Seed) % 1400) / 1000.0f - 0.2f;  // Some outside [0, 1]
+		ExpShorts[i] = (ILushort)((Bytes[i] << 8) | Bytes[i]);
+		FromShorts[i] = (ILubyte)(Shorts[i] >> 8);
+		ExpFloats[i] = Bytes[i] / 255.0f;
+		FromFloats[i] = (ILubyte)((Floats[i] < 0 ? 0 : Floats[i] > 1 ? 1 : Floats[i]) * 255);
+	}
+
+	Conv = ilConvertBuffer(context, Num, IL_LUMINANCE, IL_LUMINANCE, IL_UNSIGNED_BYTE, IL_UNSIGNED_SHORT, NULL, &Bytes[0]);
+	if (Conv == NULL || memcmp(Conv, &ExpShorts[0], Num * sizeof(ILushort)) != 0) {
+		fprintf(stderr, "byte -> short, %u values: differs from the scalar version\n", Num);
+		Failed = 1;
+	}
+	ifree(context, Conv);
+
+	Conv = ilConvertBuffer(context, Num * sizeof(ILushort), IL_LUMINANCE, IL_LUMINANCE, IL_UNSIGNED_SHORT, IL_UNSIGNED_BYTE, NULL, &Shorts[0]);
+	if (Conv == NULL || memcmp(Conv, &FromShorts[0], Num) != 0) {
+		fprintf(stderr, "short -> byte, %u values: differs from the scalar version\n", Num);
+		Failed = 1;
+	}
+	ifree(context, Conv);
+
+	Conv = ilConvertBuffer(context, Num, IL_LUMINANCE, IL_LUMINANCE, IL_UNSIGNED_BYTE, IL_FLOAT, NULL, &Bytes[0]);
+	if (Conv == NULL || memcmp(Conv, &ExpFloats[0], Num * sizeof(ILfloat)) != 0) {
+		fprintf(stderr, "byte -> float, %u values: differs from the scalar version\n", Num);
+		Failed = 1;
+	}
+	ifree(context, Conv);
+
+	Conv = ilConvertBuffer(context, Num * sizeof(ILfloat), IL_LUMINANCE, IL_LUMINANCE, IL_FLOAT, IL_UNSIGNED_BYTE, NULL, &Floats[0]);
+	if (Conv == NULL || memcmp(Conv, &FromFloats[0], Num) != 0) {
+		fprintf(stderr, "float -> byte, %u values: differs from the scalar version\n", Num);
+		Failed = 1;
+	}
+	ifree(context, Conv);
+
+	return Failed;
+}
+
+
+int main()
+{
+	static const ILenum Formats[] = { IL_RGB, IL_RGBA, IL_BGR, IL_BGRA };
+	ILcontext	*context = ilInit();
+	int			Failures = 0;
+	ILuint		s, d, n;
+
+	for (n = 1; n <= MAX_PIX + 1; n++) {
+		ILuint NumPix = n <= MAX_PIX ? n : LONG_PIX;
+
+		for (s = 0; s < 4; s++) {
+			for (d = 0; d < 4; d++) {
+				if (s != d)
+					Failures += CheckFormats(context, Formats[s], Formats[d], NumPix);
+			}
+			Failures += CheckFormats(context, Formats[s], IL_LUMINANCE, NumPix);
+		}
+		Failures += CheckTypes(context, NumPix);
+	}
+
+	ilShutDown(context);
+	if (Failures)
+		fprintf(stderr, "%d checks failed\n", Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+// Runs the same load, save, quantize and ILU work on one context per thread
+//  and checks every thread gets the result a single context gets on its own.
+//  Half of the contexts use an allocator of their own, which must see every
+//  block it hands out come back to it.
+
+#include <IL/il.h>
+#include <IL/ilu.h>
+#include <IL/devil_internal_exports.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define NUM_THREADS 8
+#define ITERATIONS  4
+
+struct Job
+{
+	ILenum Filter;       // Given to ILU_FILTER before scaling
+	ILboolean UseRegion; // Restrict the blur to a region
+	ILenum Format;       // Round-trip file format
+};
+
+static const Job Jobs[] = {
+	{ ILU_NEAREST,     IL_FALSE, IL_TGA },
+	{ ILU_BILINEAR,    IL_TRUE,  IL_PNG },
+	{ ILU_SCALE_BOX,   IL_FALSE, IL_BMP },
+	{ ILU_SCALE_BELL,  IL_TRUE,  IL_TGA },
+};
+#define NUM_JOBS (sizeof(Jobs) / sizeof(Jobs[0]))
+
+#define HEADER_SIZE  16
+#define HEADER_MAGIC 0x4445564cu
+
+static std::atomic<int> LiveBlocks(0), BadFrees(0);
+
+
+// Allocator with a header in front of each block, as pool allocators have, so
+//  that a block freed with the wrong function is noticed.
+static void* ILAPIENTRY HeaderAlloc(const ILsizei Size)
+{
+	unsigned char *Block = (unsigned char*)malloc(Size + HEADER_SIZE);
+
+	if (Block == NULL)
+		return NULL;
+	*(unsigned int*)Block = HEADER_MAGIC;
+	LiveBlocks++;
+	return Block + HEADER_SIZE;
+}
+
+static void ILAPIENTRY HeaderFree(const void *Ptr)
+{
+	unsigned char *Block;
+
+	if (Ptr == NULL)
+		return;
+	Block = (unsigned char*)Ptr - HEADER_SIZE;
+	if (*(unsigned int*)Block != HEADER_MAGIC) {
+		BadFrees++;
+		return;
+	}
+	*(unsigned int*)Block = 0;
+	LiveBlocks--;
+	free(Block);
+}
+
+
+// Returns a checksum of the final image, or 0 on failure.
+static ILuint RunJob(ILcontext *context, const Job &J)
+{
+	ILubyte Pixels[64 * 48 * 3];
+	ILuint  Image, Sum = 1, i;
+	ILsizei Size;
+	void    *Saved;
+
+	for (i = 0; i < sizeof(Pixels); i++)
+		Pixels[i] = (ILubyte)((i * 7) ^ (i >> 5));
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	if (!ilTexImage(context, 64, 48, 1, 3, IL_RGB, IL_UNSIGNED_BYTE, Pixels))
+		return 0;
+
+	iluImageParameter(context, ILU_FILTER, J.Filter);
+	if (!iluScale(context, 100, 70, 1))
+		return 0;
+
+	if (J.UseRegion) {
+		ILpointi Points[3] = { { 5, 5 }, { 90, 10 }, { 40, 60 } };
+		iluRegioniv(context, Points, 3);
+	}
+	if (!iluBlurGaussian(context, 2))
+		return 0;
+
+	Saved = ilSaveToMemory(context, J.Format, &Size);
+	if (Saved == NULL)
+		return 0;
+	if (!ilLoadL(context, J.Format, Saved, (ILuint)Size)) {
+		ifree(context, Saved);
+		return 0;
+	}
+	ifree(context, Saved);
+
+	ilSetInteger(context, IL_QUANTIZATION_MODE, J.Filter == ILU_BILINEAR ? IL_NEU_QUANT : IL_WU_QUANT);
+	if (!ilConvertImage(context, IL_COLOUR_INDEX, IL_UNSIGNED_BYTE))
+		return 0;
+	if (!ilConvertImage(context, IL_RGB, IL_UNSIGNED_BYTE))
+		return 0;
+
+	ILubyte *Data = ilGetData(context);
+	ILuint  Len = ilGetInteger(context, IL_IMAGE_SIZE_OF_DATA);
+	for (i = 0; i < Len; i++)
+		Sum = Sum * 31 + Data[i];
+
+	ilDeleteImages(context, 1, &Image);
+	return Sum == 0 ? 1 : Sum;
+}
+
+
+static ILuint RunContext(const Job &J, bool OwnAllocator)
+{
+	ILcontext *context = ilInit();
+	if (OwnAllocator)
+		ilSetMemory(context, HeaderAlloc, HeaderFree);
+	iluInit(context);
+	ILuint Sum = RunJob(context, J);
+	ilShutDown(context);
+	return Sum;
+}
+
+
+// Changing the allocator of a context that holds the caller's images would
+//  free them with the wrong function, so it must be refused.
+static int CheckSetMemory()
+{
+	ILcontext *context = ilInit();
+	ILuint Image;
+	int Failures = 0;
+
+	ilSetMemory(context, HeaderAlloc, HeaderFree);
+	if (ilGetError(context) != IL_NO_ERROR) {
+		fprintf(stderr, "ilSetMemory failed on a new context\n");
+		Failures++;
+	}
+
+	ilGenImages(context, 1, &Image);
+	ilBindImage(context, Image);
+	ilSetMemory(context, NULL, NULL);
+	if (ilGetError(context) != IL_ILLEGAL_OPERATION || !ilIsImage(context, Image)) {
+		fprintf(stderr, "ilSetMemory was not refused with an image generated\n");
+		Failures++;
+	}
+	ilSetString(context, IL_TGA_ID_STRING, "id");
+	ilDeleteImages(context, 1, &Image);
+	ilSetMemory(context, NULL, NULL);
+	if (ilGetError(context) != IL_ILLEGAL_OPERATION) {
+		fprintf(stderr, "ilSetMemory was not refused with a string set\n");
+		Failures++;
+	}
+
+	ilShutDown(context);
+	return Failures;
+}
+
+
+int main()
+{
+	ILuint Expected[NUM_JOBS];
+	std::vector<ILuint> Results(NUM_THREADS * ITERATIONS);
+	std::vector<std::thread> Threads;
+	int Failures = 0;
+
+	for (ILuint j = 0; j < NUM_JOBS; j++) {
+		Expected[j] = RunContext(Jobs[j], false);
+		if (Expected[j] == 0) {
+			fprintf(stderr, "job %u failed on a single thread\n", j);
+			return 1;
+		}
+	}
+
+	for (int t = 0; t < NUM_THREADS; t++) {
+		Threads.push_back(std::thread([t, &Results]() {
+			for (int n = 0; n < ITERATIONS; n++)
+				Results[t * ITERATIONS + n] = RunContext(Jobs[(t + n) % NUM_JOBS], t % 2 == 1);
+		}));
+	}
+	for (size_t t = 0; t < Threads.size(); t++)
+		Threads[t].join();
+
+	for (int t = 0; t < NUM_THREADS; t++) {
+		for (int n = 0; n < ITERATIONS; n++) {
+			ILuint j = (t + n) % NUM_JOBS;
+			if (Results[t * ITERATIONS + n] != Expected[j]) {
+				fprintf(stderr, "thread %d, iteration %d: job %u gave %08x, expected %08x\n",
+					t, n, j, Results[t * ITERATIONS + n], Expected[j]);
+				Failures++;
+			}
+		}
+	}
+
+	Failures += CheckSetMemory();
+	if (LiveBlocks != 0 || BadFrees != 0) {
+		fprintf(stderr, "own allocator: %d blocks not freed, %d freed with the wrong function\n",
+			(int)LiveBlocks, (int)BadFrees);
+		Failures++;
+	}
+
+	return Failures ? 1 : 0;
+}